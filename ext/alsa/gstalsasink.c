@@ -69,6 +69,7 @@ enum
   PROP_DEVICE,
   PROP_DEVICE_NAME,
   PROP_CARD_NAME,
+  PROP_STATS,
   PROP_LAST
 };
 
@@ -198,6 +199,20 @@ gst_alsasink_class_init (GstAlsaSinkClass * klass)
           "Human-readable name of the sound card", DEFAULT_CARD_NAME,
           G_PARAM_READABLE | G_PARAM_STATIC_STRINGS |
           GST_PARAM_DOC_SHOW_DEFAULT));
+
+  /**
+   * GstAlsaSink:alsa-stats:
+   *
+   * Statistics about the device since it was opened: the number of
+   * underruns ("xruns") and suspends ("suspends") that were recovered from,
+   * and the last delay reported by the device in nanoseconds ("delay").
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("alsa-stats", "ALSA statistics",
+          "Underrun and latency statistics of the device", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
@@ -245,6 +260,16 @@ gst_alsasink_get_property (GObject * object, guint prop_id,
           gst_alsa_find_card_name (GST_OBJECT_CAST (sink),
               sink->device, SND_PCM_STREAM_PLAYBACK));
       break;
+    case PROP_STATS:
+      GST_OBJECT_LOCK (sink);
+      g_value_take_boxed (value, gst_structure_new ("application/x-alsa-stats",
+              "xruns", G_TYPE_UINT64, sink->xruns,
+              "suspends", G_TYPE_UINT64, sink->suspends,
+              "delay", G_TYPE_UINT64, sink->rate ?
+              gst_util_uint64_scale_int (g_atomic_int_get (&sink->last_delay),
+                  GST_SECOND, sink->rate) : G_GUINT64_CONSTANT (0), NULL));
+      GST_OBJECT_UNLOCK (sink);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -848,6 +873,12 @@ gst_alsasink_open (GstAudioSink * asink)
           SND_PCM_NONBLOCK), open_error);
   GST_LOG_OBJECT (alsa, "Opened device %s", alsa->device);
 
+  GST_OBJECT_LOCK (alsa);
+  alsa->xruns = 0;
+  alsa->suspends = 0;
+  GST_OBJECT_UNLOCK (alsa);
+  g_atomic_int_set (&alsa->last_delay, 0);
+
   return TRUE;
 
   /* ERRORS */
@@ -983,6 +1014,9 @@ xrun_recovery (GstAlsaSink * alsa, snd_pcm_t * handle, gint err)
   GST_WARNING_OBJECT (alsa, "xrun recovery %d: %s", err, g_strerror (-err));
 
   if (err == -EPIPE) {          /* under-run */
+    GST_OBJECT_LOCK (alsa);
+    alsa->xruns++;
+    GST_OBJECT_UNLOCK (alsa);
     err = snd_pcm_prepare (handle);
     if (err < 0)
       GST_WARNING_OBJECT (alsa,
@@ -991,6 +1025,9 @@ xrun_recovery (GstAlsaSink * alsa, snd_pcm_t * handle, gint err)
     gst_audio_base_sink_report_device_failure (GST_AUDIO_BASE_SINK (alsa));
     return 0;
   } else if (err == -ESTRPIPE) {
+    GST_OBJECT_LOCK (alsa);
+    alsa->suspends++;
+    GST_OBJECT_UNLOCK (alsa);
     while ((err = snd_pcm_resume (handle)) == -EAGAIN)
       g_usleep (100);           /* wait until the suspend flag is released */
 
@@ -1102,6 +1139,8 @@ gst_alsasink_delay (GstAudioSink * asink)
     delay = 0;
   }
 
+  g_atomic_int_set (&alsa->last_delay, delay);
+
   return delay;
 }
 
@@ -72,6 +72,12 @@ struct _GstAlsaSink {
   snd_pcm_uframes_t buffer_size;
   snd_pcm_uframes_t period_size;
 
+  /* statistics, protected by the object lock, except for the atomic
+   * last_delay which is updated while the clock is being read */
+  guint64 xruns;
+  guint64 suspends;
+  gint last_delay;
+
   GstCaps *cached_caps;
 
   GMutex alsa_lock;
@@ -65,6 +65,7 @@ enum
   PROP_DEVICE_NAME,
   PROP_CARD_NAME,
   PROP_USE_DRIVER_TIMESTAMP,
+  PROP_STATS,
   PROP_LAST
 };
 
@@ -179,6 +180,20 @@ gst_alsasrc_class_init (GstAlsaSrcClass * klass)
           "Use driver timestamps or the pipeline clock timestamps",
           DEFAULT_PROP_USE_DRIVER_TIMESTAMP,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAlsaSrc:alsa-stats:
+   *
+   * Statistics about the device since it was opened: the number of overruns
+   * ("xruns") and suspends ("suspends") that were recovered from, and the
+   * last delay reported by the device in nanoseconds ("delay").
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("alsa-stats", "ALSA statistics",
+          "Overrun and latency statistics of the device", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
@@ -235,6 +250,16 @@ gst_alsasrc_get_property (GObject * object, guint prop_id,
       g_value_set_boolean (value, src->use_driver_timestamps);
       GST_OBJECT_UNLOCK (src);
       break;
+    case PROP_STATS:
+      GST_OBJECT_LOCK (src);
+      g_value_take_boxed (value, gst_structure_new ("application/x-alsa-stats",
+              "xruns", G_TYPE_UINT64, src->xruns,
+              "suspends", G_TYPE_UINT64, src->suspends,
+              "delay", G_TYPE_UINT64, src->rate ?
+              gst_util_uint64_scale_int (g_atomic_int_get (&src->last_delay),
+                  GST_SECOND, src->rate) : G_GUINT64_CONSTANT (0), NULL));
+      GST_OBJECT_UNLOCK (src);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -754,6 +779,12 @@ gst_alsasrc_open (GstAudioSrc * asrc)
   CHECK (snd_pcm_open (&alsa->handle, alsa->device, SND_PCM_STREAM_CAPTURE,
           (alsa->driver_timestamps) ? 0 : SND_PCM_NONBLOCK), open_error);
 
+  GST_OBJECT_LOCK (alsa);
+  alsa->xruns = 0;
+  alsa->suspends = 0;
+  GST_OBJECT_UNLOCK (alsa);
+  g_atomic_int_set (&alsa->last_delay, 0);
+
   return TRUE;
 
   /* ERRORS */
@@ -887,6 +918,9 @@ xrun_recovery (GstAlsaSrc * alsa, snd_pcm_t * handle, gint err)
   GST_WARNING_OBJECT (alsa, "xrun recovery %d: %s", err, g_strerror (-err));
 
   if (err == -EPIPE) {          /* under-run */
+    GST_OBJECT_LOCK (alsa);
+    alsa->xruns++;
+    GST_OBJECT_UNLOCK (alsa);
     err = snd_pcm_prepare (handle);
     if (err < 0)
       GST_WARNING_OBJECT (alsa,
@@ -894,6 +928,9 @@ xrun_recovery (GstAlsaSrc * alsa, snd_pcm_t * handle, gint err)
           snd_strerror (err));
     return 0;
   } else if (err == -ESTRPIPE) {
+    GST_OBJECT_LOCK (alsa);
+    alsa->suspends++;
+    GST_OBJECT_UNLOCK (alsa);
     while ((err = snd_pcm_resume (handle)) == -EAGAIN)
       g_usleep (100);           /* wait until the suspend flag is released */
 
@@ -1038,7 +1075,10 @@ gst_alsasrc_delay (GstAudioSrc * asrc)
     delay = 0;
   }
 
-  return CLAMP (delay, 0, alsa->buffer_size);
+  delay = CLAMP (delay, 0, alsa->buffer_size);
+  g_atomic_int_set (&alsa->last_delay, delay);
+
+  return delay;
 }
 
 static void
@@ -71,6 +71,12 @@ struct _GstAlsaSrc {
   snd_pcm_uframes_t     buffer_size;
   snd_pcm_uframes_t     period_size;
 
+  /* statistics, protected by the object lock, except for the atomic
+   * last_delay which is updated while the clock is being read */
+  guint64               xruns;
+  guint64               suspends;
+  gint                  last_delay;
+
   GMutex                alsa_lock;
 };
 
@@ -33,6 +33,15 @@
 GST_DEBUG_CATEGORY_STATIC (gst_gl_download_element_debug);
 #define GST_CAT_DEFAULT gst_gl_download_element_debug
 
+#define DEFAULT_PBO_RING_SIZE 1
+
+enum
+{
+  PROP_0,
+  PROP_PBO_RING_SIZE,
+  PROP_PBO_STATS,
+};
+
 #define gst_gl_download_element_parent_class parent_class
 G_DEFINE_TYPE_WITH_CODE (GstGLDownloadElement, gst_gl_download_element,
     GST_TYPE_GL_BASE_FILTER,
@@ -50,8 +59,22 @@ gst_gl_download_element_prepare_output_buffer (GstBaseTransform * bt,
     GstBuffer * buffer, GstBuffer ** outbuf);
 static GstFlowReturn gst_gl_download_element_transform (GstBaseTransform * bt,
     GstBuffer * buffer, GstBuffer * outbuf);
+static gboolean gst_gl_download_element_propose_allocation (GstBaseTransform *
+    trans, GstQuery * decide_query, GstQuery * query);
 static gboolean gst_gl_download_element_decide_allocation (GstBaseTransform *
     trans, GstQuery * query);
+static GstFlowReturn gst_gl_download_element_generate_output (GstBaseTransform *
+    bt, GstBuffer ** outbuf);
+static gboolean gst_gl_download_element_sink_event (GstBaseTransform * bt,
+    GstEvent * event);
+static gboolean gst_gl_download_element_query (GstBaseTransform * bt,
+    GstPadDirection direction, GstQuery * query);
+static gboolean gst_gl_download_element_start (GstBaseTransform * bt);
+static gboolean gst_gl_download_element_stop (GstBaseTransform * bt);
+static void gst_gl_download_element_set_property (GObject * object,
+    guint prop_id, const GValue * value, GParamSpec * pspec);
+static void gst_gl_download_element_get_property (GObject * object,
+    guint prop_id, GValue * value, GParamSpec * pspec);
 static void gst_gl_download_element_finalize (GObject * object);
 
 #if GST_GL_HAVE_PLATFORM_EGL && GST_GL_HAVE_DMABUF
@@ -86,10 +109,55 @@ gst_gl_download_element_class_init (GstGLDownloadElementClass * klass)
   bt_class->prepare_output_buffer =
       gst_gl_download_element_prepare_output_buffer;
   bt_class->transform = gst_gl_download_element_transform;
+  bt_class->propose_allocation = gst_gl_download_element_propose_allocation;
   bt_class->decide_allocation = gst_gl_download_element_decide_allocation;
+  bt_class->generate_output = gst_gl_download_element_generate_output;
+  bt_class->sink_event = gst_gl_download_element_sink_event;
+  bt_class->query = gst_gl_download_element_query;
+  bt_class->start = gst_gl_download_element_start;
+  bt_class->stop = gst_gl_download_element_stop;
 
   bt_class->passthrough_on_same_caps = TRUE;
 
+  object_class->set_property = gst_gl_download_element_set_property;
+  object_class->get_property = gst_gl_download_element_get_property;
+
+  /**
+   * GstGLDownloadElement:pbo-ring-size:
+   *
+   * Number of frames that can have a download in flight at the same time
+   * when downloading into system memory. With a value of N, the readback of a
+   * frame is started when it arrives but the frame is only pushed once N - 1
+   * newer frames have been received, so that the transfer overlaps with the
+   * rendering of the following frames instead of stalling the GL thread.
+   * This adds N - 1 frames of latency. 1 downloads synchronously.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (object_class, PROP_PBO_RING_SIZE,
+      g_param_spec_uint ("pbo-ring-size", "PBO ring size",
+          "Number of frames with an asynchronous download in flight "
+          "(1 = synchronous download)", 1, 16, DEFAULT_PBO_RING_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstGLDownloadElement:pbo-stats:
+   *
+   * Statistics about the frames that went through the download ring since
+   * the element was started: the number of downloads started
+   * ("downloads"), the largest number of frames that were in flight at the
+   * same time ("max-pending"), how many of them were pushed by draining the
+   * ring instead of being replaced by a newer frame ("drained") and how
+   * many waits for a download took longer than the duration of the frame
+   * ("stalls").
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (object_class, PROP_PBO_STATS,
+      g_param_spec_boxed ("pbo-stats", "PBO statistics",
+          "Statistics of the asynchronous download ring", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template (element_class,
       &gst_gl_download_element_src_pad_template);
   gst_element_class_add_static_pad_template (element_class,
@@ -107,6 +175,57 @@ gst_gl_download_element_init (GstGLDownloadElement * download)
 {
   gst_base_transform_set_prefer_passthrough (GST_BASE_TRANSFORM (download),
       TRUE);
+
+  download->pbo_ring_size = DEFAULT_PBO_RING_SIZE;
+  g_queue_init (&download->pending_downloads);
+}
+
+static void
+gst_gl_download_element_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstGLDownloadElement *download = GST_GL_DOWNLOAD_ELEMENT (object);
+
+  switch (prop_id) {
+    case PROP_PBO_RING_SIZE:
+      GST_OBJECT_LOCK (download);
+      download->pbo_ring_size = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (download);
+      gst_element_post_message (GST_ELEMENT (download),
+          gst_message_new_latency (GST_OBJECT (download)));
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_gl_download_element_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstGLDownloadElement *download = GST_GL_DOWNLOAD_ELEMENT (object);
+
+  switch (prop_id) {
+    case PROP_PBO_RING_SIZE:
+      GST_OBJECT_LOCK (download);
+      g_value_set_uint (value, download->pbo_ring_size);
+      GST_OBJECT_UNLOCK (download);
+      break;
+    case PROP_PBO_STATS:
+      GST_OBJECT_LOCK (download);
+      g_value_take_boxed (value,
+          gst_structure_new ("application/x-gl-download-stats",
+              "downloads", G_TYPE_UINT64, download->ring_downloads,
+              "max-pending", G_TYPE_UINT, download->ring_max_pending,
+              "drained", G_TYPE_UINT64, download->ring_drained,
+              "stalls", G_TYPE_UINT64, download->ring_stalls, NULL));
+      GST_OBJECT_UNLOCK (download);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
 }
 
 static gboolean
@@ -447,6 +566,278 @@ gst_gl_download_element_transform (GstBaseTransform * bt,
   return GST_FLOW_OK;
 }
 
+/* Makes sure the download started in prepare_output_buffer() for @buffer has
+ * completed, so that mapping it afterwards does not stall. A wait that takes
+ * longer than the frame lasts is counted as a stall of the ring. */
+static void
+_wait_pending_download (GstGLDownloadElement * dl, GstBuffer * buffer)
+{
+  GstGLSyncMeta *sync_meta = gst_buffer_get_gl_sync_meta (buffer);
+  gint64 start;
+  GstClockTime waited;
+
+  if (!sync_meta)
+    return;
+
+  start = g_get_monotonic_time ();
+  gst_gl_sync_meta_wait_cpu (sync_meta, GST_GL_BASE_FILTER (dl)->context);
+  waited = (g_get_monotonic_time () - start) * GST_USECOND;
+
+  if (GST_BUFFER_DURATION_IS_VALID (buffer)
+      && waited > GST_BUFFER_DURATION (buffer)) {
+    GST_DEBUG_OBJECT (dl, "waited %" GST_TIME_FORMAT " for the download of %"
+        GST_PTR_FORMAT, GST_TIME_ARGS (waited), buffer);
+    GST_OBJECT_LOCK (dl);
+    dl->ring_stalls++;
+    GST_OBJECT_UNLOCK (dl);
+  }
+}
+
+static GstFlowReturn
+_drain_pending_downloads (GstGLDownloadElement * dl)
+{
+  GstFlowReturn ret = GST_FLOW_OK;
+  GstBuffer *buffer;
+
+  while ((buffer = g_queue_pop_head (&dl->pending_downloads))) {
+    if (ret != GST_FLOW_OK) {
+      gst_buffer_unref (buffer);
+      continue;
+    }
+
+    _wait_pending_download (dl, buffer);
+    GST_LOG_OBJECT (dl, "draining %" GST_PTR_FORMAT, buffer);
+    GST_OBJECT_LOCK (dl);
+    dl->ring_drained++;
+    GST_OBJECT_UNLOCK (dl);
+    ret = gst_pad_push (GST_BASE_TRANSFORM_SRC_PAD (dl), buffer);
+  }
+
+  return ret;
+}
+
+static void
+_clear_pending_downloads (GstGLDownloadElement * dl)
+{
+  GstBuffer *buffer;
+
+  while ((buffer = g_queue_pop_head (&dl->pending_downloads)))
+    gst_buffer_unref (buffer);
+}
+
+static GstFlowReturn
+gst_gl_download_element_generate_output (GstBaseTransform * bt,
+    GstBuffer ** outbuf)
+{
+  GstGLDownloadElement *dl = GST_GL_DOWNLOAD_ELEMENT (bt);
+  GstGLContext *context = GST_GL_BASE_FILTER (bt)->context;
+  GstGLSyncMeta *sync_meta;
+  GstFlowReturn ret;
+  guint ring_size;
+
+  ret = GST_BASE_TRANSFORM_CLASS (parent_class)->generate_output (bt, outbuf);
+  if (ret != GST_FLOW_OK || !dl->do_pbo_transfers)
+    return ret;
+
+  if (dl->drain_flow != GST_FLOW_OK) {
+    GST_DEBUG_OBJECT (dl, "draining failed before, returning %s",
+        gst_flow_get_name (dl->drain_flow));
+    gst_buffer_replace (outbuf, NULL);
+    return dl->drain_flow;
+  }
+
+  GST_OBJECT_LOCK (dl);
+  ring_size = dl->pbo_ring_size;
+  GST_OBJECT_UNLOCK (dl);
+
+  if (*outbuf) {
+    if (ring_size <= 1 && g_queue_is_empty (&dl->pending_downloads))
+      return ret;
+
+    /* the download into the PBO was issued in prepare_output_buffer(), fence
+     * it so that we know when the data can be mapped without stalling */
+    *outbuf = gst_buffer_make_writable (*outbuf);
+    sync_meta = gst_buffer_get_gl_sync_meta (*outbuf);
+    if (!sync_meta)
+      sync_meta = gst_buffer_add_gl_sync_meta (context, *outbuf);
+    gst_gl_sync_meta_set_sync_point (sync_meta, context);
+
+    g_queue_push_tail (&dl->pending_downloads, *outbuf);
+    *outbuf = NULL;
+
+    GST_OBJECT_LOCK (dl);
+    dl->ring_downloads++;
+    dl->ring_max_pending = MAX (dl->ring_max_pending,
+        g_queue_get_length (&dl->pending_downloads));
+    GST_OBJECT_UNLOCK (dl);
+  }
+
+  /* GstBaseTransform calls us until we return no buffer, which also takes
+   * care of outputting the excess frames when the ring was shrunk */
+  if (g_queue_get_length (&dl->pending_downloads) >= ring_size) {
+    *outbuf = g_queue_pop_head (&dl->pending_downloads);
+    _wait_pending_download (dl, *outbuf);
+  }
+
+  return ret;
+}
+
+static gboolean
+gst_gl_download_element_sink_event (GstBaseTransform * bt, GstEvent * event)
+{
+  GstGLDownloadElement *dl = GST_GL_DOWNLOAD_ELEMENT (bt);
+
+  switch (GST_EVENT_TYPE (event)) {
+    case GST_EVENT_EOS:
+    case GST_EVENT_CAPS:
+    case GST_EVENT_SEGMENT:
+    case GST_EVENT_GAP:{
+      GstFlowReturn ret;
+
+      /* the pending frames belong before these */
+      ret = _drain_pending_downloads (dl);
+      if (ret != GST_FLOW_OK) {
+        GST_DEBUG_OBJECT (dl, "failed to drain pending downloads: %s",
+            gst_flow_get_name (ret));
+        dl->drain_flow = ret;
+        gst_event_unref (event);
+        return FALSE;
+      }
+      break;
+    }
+    case GST_EVENT_FLUSH_STOP:
+      _clear_pending_downloads (dl);
+      dl->drain_flow = GST_FLOW_OK;
+      break;
+    default:
+      break;
+  }
+
+  return GST_BASE_TRANSFORM_CLASS (parent_class)->sink_event (bt, event);
+}
+
+static gboolean
+gst_gl_download_element_query (GstBaseTransform * bt, GstPadDirection direction,
+    GstQuery * query)
+{
+  GstGLDownloadElement *dl = GST_GL_DOWNLOAD_ELEMENT (bt);
+  gboolean ret;
+
+  ret = GST_BASE_TRANSFORM_CLASS (parent_class)->query (bt, direction, query);
+
+  if (ret && direction == GST_PAD_SRC
+      && GST_QUERY_TYPE (query) == GST_QUERY_LATENCY && dl->do_pbo_transfers) {
+    GstClockTime min, max, extra = 0;
+    gboolean live;
+    GstCaps *caps;
+    GstVideoInfo info;
+    guint ring_size;
+
+    GST_OBJECT_LOCK (dl);
+    ring_size = dl->pbo_ring_size;
+    GST_OBJECT_UNLOCK (dl);
+
+    if (ring_size <= 1)
+      return ret;
+
+    caps = gst_pad_get_current_caps (bt->srcpad);
+    if (caps && gst_video_info_from_caps (&info, caps)
+        && GST_VIDEO_INFO_FPS_N (&info) > 0) {
+      extra = gst_util_uint64_scale_int ((ring_size - 1) * GST_SECOND,
+          GST_VIDEO_INFO_FPS_D (&info), GST_VIDEO_INFO_FPS_N (&info));
+    } else {
+      GST_WARNING_OBJECT (dl, "unknown framerate, can't report the latency "
+          "of %u pending downloads", ring_size - 1);
+    }
+    if (caps)
+      gst_caps_unref (caps);
+
+    gst_query_parse_latency (query, &live, &min, &max);
+    min += extra;
+    if (max != GST_CLOCK_TIME_NONE)
+      max += extra;
+
+    GST_DEBUG_OBJECT (dl, "reporting latency min %" GST_TIME_FORMAT " max %"
+        GST_TIME_FORMAT, GST_TIME_ARGS (min), GST_TIME_ARGS (max));
+    gst_query_set_latency (query, live, min, max);
+  }
+
+  return ret;
+}
+
+static gboolean
+gst_gl_download_element_start (GstBaseTransform * bt)
+{
+  GstGLDownloadElement *dl = GST_GL_DOWNLOAD_ELEMENT (bt);
+
+  GST_OBJECT_LOCK (dl);
+  dl->ring_downloads = 0;
+  dl->ring_drained = 0;
+  dl->ring_stalls = 0;
+  dl->ring_max_pending = 0;
+  GST_OBJECT_UNLOCK (dl);
+  dl->drain_flow = GST_FLOW_OK;
+
+  return GST_BASE_TRANSFORM_CLASS (parent_class)->start (bt);
+}
+
+static gboolean
+gst_gl_download_element_stop (GstBaseTransform * bt)
+{
+  _clear_pending_downloads (GST_GL_DOWNLOAD_ELEMENT (bt));
+
+  if (GST_BASE_TRANSFORM_CLASS (parent_class)->stop)
+    return GST_BASE_TRANSFORM_CLASS (parent_class)->stop (bt);
+
+  return TRUE;
+}
+
+/* The ring keeps up to pbo-ring-size - 1 of the upstream buffers, ask
+ * upstream for that many buffers on top of what it needs itself */
+static gboolean
+gst_gl_download_element_propose_allocation (GstBaseTransform * trans,
+    GstQuery * decide_query, GstQuery * query)
+{
+  GstGLDownloadElement *dl = GST_GL_DOWNLOAD_ELEMENT (trans);
+  GstBufferPool *pool;
+  GstCaps *caps;
+  GstVideoInfo info;
+  guint ring_size, extra, size, min, max, i, n;
+
+  if (!GST_BASE_TRANSFORM_CLASS (parent_class)->propose_allocation (trans,
+          decide_query, query))
+    return FALSE;
+
+  GST_OBJECT_LOCK (dl);
+  ring_size = dl->pbo_ring_size;
+  GST_OBJECT_UNLOCK (dl);
+
+  if (!dl->do_pbo_transfers || ring_size <= 1)
+    return TRUE;
+
+  extra = ring_size - 1;
+  n = gst_query_get_n_allocation_pools (query);
+  for (i = 0; i < n; i++) {
+    gst_query_parse_nth_allocation_pool (query, i, &pool, &size, &min, &max);
+    min += extra;
+    if (max != 0)
+      max += extra;
+    gst_query_set_nth_allocation_pool (query, i, pool, size, min, max);
+    if (pool)
+      gst_object_unref (pool);
+  }
+
+  if (n == 0) {
+    gst_query_parse_allocation (query, &caps, NULL);
+    if (caps && gst_video_info_from_caps (&info, caps))
+      gst_query_add_allocation_pool (query, NULL, info.size, extra, 0);
+  }
+
+  GST_DEBUG_OBJECT (dl, "asking upstream for %u more buffers", extra);
+
+  return TRUE;
+}
+
 static gboolean
 gst_gl_download_element_decide_allocation (GstBaseTransform * trans,
     GstQuery * query)
@@ -468,6 +859,8 @@ gst_gl_download_element_finalize (GObject * object)
 {
   GstGLDownloadElement *download = GST_GL_DOWNLOAD_ELEMENT_CAST (object);
 
+  _clear_pending_downloads (download);
+
   if (download->dmabuf_allocator) {
     gst_object_unref (GST_OBJECT (download->dmabuf_allocator));
     download->dmabuf_allocator = NULL;
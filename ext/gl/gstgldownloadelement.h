@@ -46,6 +46,19 @@ struct _GstGLDownloadElement
   gboolean do_pbo_transfers;
   GstAllocator * dmabuf_allocator;
   gboolean add_videometa;
+
+  /* buffers whose PBO download was started but not yet pushed */
+  guint pbo_ring_size;
+  GQueue pending_downloads;
+  /* result of pushing the pending buffers from an event, returned for the
+   * next buffer */
+  GstFlowReturn drain_flow;
+
+  /* ring statistics, protected by the object lock */
+  guint64 ring_downloads;
+  guint64 ring_drained;
+  guint64 ring_stalls;
+  guint ring_max_pending;
 };
 
 struct _GstGLDownloadElementClass
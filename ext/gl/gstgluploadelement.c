@@ -59,6 +59,19 @@ gst_gl_upload_element_change_state (GstElement * element,
     GstStateChange transition);
 
 
+enum
+{
+  PROP_0,
+  PROP_REUSE_TEXTURES,
+};
+
+#define DEFAULT_REUSE_TEXTURES FALSE
+
+static void gst_gl_upload_element_set_property (GObject * object,
+    guint prop_id, const GValue * value, GParamSpec * pspec);
+static void gst_gl_upload_element_get_property (GObject * object,
+    guint prop_id, GValue * value, GParamSpec * pspec);
+
 static GstStaticPadTemplate gst_gl_upload_element_src_pad_template =
 GST_STATIC_PAD_TEMPLATE ("src",
     GST_PAD_SRC,
@@ -112,12 +125,70 @@ gst_gl_upload_element_class_init (GstGLUploadElementClass * klass)
       "Uploads data into OpenGL", "Matthew Waters <matthew@centricular.com>");
 
   gobject_class->finalize = gst_gl_upload_element_finalize;
+  gobject_class->set_property = gst_gl_upload_element_set_property;
+  gobject_class->get_property = gst_gl_upload_element_get_property;
+
+  /**
+   * GstGLUploadElement:reuse-textures:
+   *
+   * Output the textures of the previous frame again, without uploading,
+   * when upstream repeats a frame by pushing new buffers that share its
+   * memories (e.g. a frozen or still image feed).
+   * See gst_gl_upload_set_reuse_textures().
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_REUSE_TEXTURES,
+      g_param_spec_boolean ("reuse-textures", "Reuse textures",
+          "Reuse the uploaded textures of repeated frames",
+          DEFAULT_REUSE_TEXTURES, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
 gst_gl_upload_element_init (GstGLUploadElement * upload)
 {
   gst_base_transform_set_prefer_passthrough (GST_BASE_TRANSFORM (upload), TRUE);
+
+  upload->reuse_textures = DEFAULT_REUSE_TEXTURES;
+}
+
+static void
+gst_gl_upload_element_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstGLUploadElement *upload = GST_GL_UPLOAD_ELEMENT (object);
+
+  switch (prop_id) {
+    case PROP_REUSE_TEXTURES:
+      GST_OBJECT_LOCK (upload);
+      upload->reuse_textures = g_value_get_boolean (value);
+      if (upload->upload)
+        gst_gl_upload_set_reuse_textures (upload->upload,
+            upload->reuse_textures);
+      GST_OBJECT_UNLOCK (upload);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_gl_upload_element_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstGLUploadElement *upload = GST_GL_UPLOAD_ELEMENT (object);
+
+  switch (prop_id) {
+    case PROP_REUSE_TEXTURES:
+      GST_OBJECT_LOCK (upload);
+      g_value_set_boolean (value, upload->reuse_textures);
+      GST_OBJECT_UNLOCK (upload);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
 }
 
 static gboolean
@@ -159,8 +230,14 @@ _gst_gl_upload_element_transform_caps (GstBaseTransform * bt,
     return NULL;
 
   context = GST_GL_BASE_FILTER (bt)->context;
-  if (upload->upload == NULL)
-    upload->upload = gst_gl_upload_new (context);
+  if (upload->upload == NULL) {
+    GstGLUpload *new_upload = gst_gl_upload_new (context);
+
+    GST_OBJECT_LOCK (upload);
+    gst_gl_upload_set_reuse_textures (new_upload, upload->reuse_textures);
+    upload->upload = new_upload;
+    GST_OBJECT_UNLOCK (upload);
+  }
 
   return gst_gl_upload_transform_caps (upload->upload, context, direction, caps,
       filter);
@@ -49,6 +49,8 @@ struct _GstGLUploadElement
   GstGLBaseFilter     parent;
 
   GstGLUpload *upload;
+
+  gboolean reuse_textures;
 };
 
 /**
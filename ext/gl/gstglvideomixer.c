@@ -186,6 +186,8 @@ enum
   PROP_INPUT_BLEND_FUNCTION_CONSTANT_COLOR_ALPHA,
   PROP_INPUT_ZORDER,
   PROP_INPUT_REPEAT_AFTER_EOS,
+  PROP_INPUT_RENDER_TIME,
+  PROP_INPUT_REUSE_TEXTURES,
 };
 
 static void gst_gl_video_mixer_input_get_property (GObject * object,
@@ -316,6 +318,42 @@ gst_gl_video_mixer_input_class_init (GstGLVideoMixerInputClass * klass)
           "Blend Constant Color Alpha", "Blend Constant Color Alpha", 0.0, 1.0,
           0.0,
           G_PARAM_READWRITE | GST_PARAM_CONTROLLABLE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_INPUT_RENDER_TIME,
+      g_param_spec_uint64 ("render-time", "Render Time",
+          "GPU time in nanoseconds spent drawing the last frame of this pad "
+          "(0 if unknown, requires render-timing on the mixer)", 0, G_MAXUINT64,
+          0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstGLVideoMixerInput:reuse-textures:
+   *
+   * Reuse the uploaded textures when upstream repeats a frame with buffers
+   * sharing the same memories, e.g. a still image or frozen camera feed.
+   * Sets #GstGLUploadElement:reuse-textures on the upload element of this
+   * input.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_INPUT_REUSE_TEXTURES,
+      g_param_spec_boolean ("reuse-textures", "Reuse textures",
+          "Reuse the uploaded textures of repeated frames", FALSE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+}
+
+/* the upload element is the parent of our target, it holds the state of
+ * the properties that are not proxied to the mixer pad */
+static GstElement *
+gst_gl_video_mixer_input_get_upload (GstGLVideoMixerInput * self)
+{
+  GstElement *upload = NULL;
+  GstPad *target;
+
+  target = gst_ghost_pad_get_target (GST_GHOST_PAD (self));
+  if (target) {
+    upload = gst_pad_get_parent_element (target);
+    gst_object_unref (target);
+  }
+
+  return upload;
 }
 
 static void
@@ -324,6 +362,16 @@ gst_gl_video_mixer_input_get_property (GObject * object, guint prop_id,
 {
   GstGLVideoMixerInput *self = (GstGLVideoMixerInput *) object;
 
+  if (prop_id == PROP_INPUT_REUSE_TEXTURES) {
+    GstElement *upload = gst_gl_video_mixer_input_get_upload (self);
+
+    if (upload) {
+      g_object_get_property (G_OBJECT (upload), pspec->name, value);
+      gst_object_unref (upload);
+    }
+    return;
+  }
+
   if (self->mixer_pad)
     g_object_get_property (G_OBJECT (self->mixer_pad), pspec->name, value);
 }
@@ -334,6 +382,16 @@ gst_gl_video_mixer_input_set_property (GObject * object, guint prop_id,
 {
   GstGLVideoMixerInput *self = (GstGLVideoMixerInput *) object;
 
+  if (prop_id == PROP_INPUT_REUSE_TEXTURES) {
+    GstElement *upload = gst_gl_video_mixer_input_get_upload (self);
+
+    if (upload) {
+      g_object_set_property (G_OBJECT (upload), pspec->name, value);
+      gst_object_unref (upload);
+    }
+    return;
+  }
+
   if (self->mixer_pad)
     g_object_set_property (G_OBJECT (self->mixer_pad), pspec->name, value);
 }
@@ -381,8 +439,10 @@ enum
 {
   PROP_BIN_0,
   PROP_BIN_BACKGROUND,
+  PROP_BIN_RENDER_TIMING,
 };
 #define DEFAULT_BACKGROUND GST_GL_VIDEO_MIXER_BACKGROUND_CHECKER
+#define DEFAULT_RENDER_TIMING FALSE
 
 static void gst_gl_video_mixer_bin_get_property (GObject * object,
     guint prop_id, GValue * value, GParamSpec * pspec);
@@ -421,6 +481,11 @@ gst_gl_video_mixer_bin_class_init (GstGLVideoMixerBinClass * klass)
           GST_TYPE_GL_VIDEO_MIXER_BACKGROUND,
           DEFAULT_BACKGROUND, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  g_object_class_install_property (gobject_class, PROP_BIN_RENDER_TIMING,
+      g_param_spec_boolean ("render-timing", "Render Timing",
+          "Measure the GPU time spent drawing each pad", DEFAULT_RENDER_TIMING,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_set_metadata (element_class, "OpenGL video_mixer bin",
       "Bin/Filter/Effect/Video/Compositor", "OpenGL video_mixer bin",
       "Matthew Waters <matthew@centricular.com>");
@@ -450,6 +515,7 @@ enum
 {
   PROP_0,
   PROP_BACKGROUND,
+  PROP_RENDER_TIMING,
 };
 
 static void gst_gl_video_mixer_child_proxy_init (gpointer g_iface,
@@ -562,8 +628,12 @@ struct _GstGLVideoMixerPad
   gdouble blend_constant_color_alpha;
 
   gboolean geometry_change;
-  GLuint vertex_buffer;
   gfloat m_matrix[16];
+
+  /* GPU timing of the draw, protected by the object lock */
+  GstGLQuery *query;
+  gboolean query_pending;
+  guint64 render_time;
 };
 
 struct _GstGLVideoMixerPadClass
@@ -598,6 +668,7 @@ enum
   PROP_PAD_BLEND_FUNCTION_CONSTANT_COLOR_GREEN,
   PROP_PAD_BLEND_FUNCTION_CONSTANT_COLOR_BLUE,
   PROP_PAD_BLEND_FUNCTION_CONSTANT_COLOR_ALPHA,
+  PROP_PAD_RENDER_TIME,
 };
 
 static void
@@ -710,6 +781,11 @@ gst_gl_video_mixer_pad_class_init (GstGLVideoMixerPadClass * klass)
           "Blend Constant Color Alpha", "Blend Constant Color Alpha", 0.0, 1.0,
           0.0,
           G_PARAM_READWRITE | GST_PARAM_CONTROLLABLE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_PAD_RENDER_TIME,
+      g_param_spec_uint64 ("render-time", "Render Time",
+          "GPU time in nanoseconds spent drawing the last frame of this pad "
+          "(0 if unknown, requires render-timing on the mixer)", 0, G_MAXUINT64,
+          0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
@@ -764,6 +840,11 @@ gst_gl_video_mixer_pad_get_property (GObject * object, guint prop_id,
     case PROP_PAD_BLEND_FUNCTION_CONSTANT_COLOR_ALPHA:
       g_value_set_double (value, pad->blend_constant_color_alpha);
       break;
+    case PROP_PAD_RENDER_TIME:
+      GST_OBJECT_LOCK (pad);
+      g_value_set_uint64 (value, pad->render_time);
+      GST_OBJECT_UNLOCK (pad);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -836,9 +917,9 @@ gst_gl_video_mixer_pad_set_property (GObject * object, guint prop_id,
 }
 
 static void
-_del_buffer (GstGLContext * context, GLuint * pBuffer)
+_free_query (GstGLContext * context, GstGLQuery * query)
 {
-  context->gl_vtable->DeleteBuffers (1, pBuffer);
+  gst_gl_query_free (query);
 }
 
 static GstPad *
@@ -876,16 +957,17 @@ gst_gl_video_mixer_release_pad (GstElement * element, GstPad * p)
 
   /* we call the base class first as this will remove the pad from
    * the aggregator, thus stopping misc callbacks from being called,
-   * one of which (process_textures) will recreate the vertex_buffer
+   * one of which (process_textures) will recreate the query
    * if it is destroyed */
   GST_ELEMENT_CLASS (g_type_class_peek_parent (G_OBJECT_GET_CLASS (element)))
       ->release_pad (element, p);
 
-  if (pad->vertex_buffer) {
+  if (pad->query) {
     GstGLBaseMixer *mix = GST_GL_BASE_MIXER (element);
     gst_gl_context_thread_add (mix->context, (GstGLContextThreadFunc)
-        _del_buffer, &pad->vertex_buffer);
-    pad->vertex_buffer = 0;
+        _free_query, pad->query);
+    pad->query = NULL;
+    pad->query_pending = FALSE;
   }
 }
 
@@ -917,6 +999,20 @@ gst_gl_video_mixer_class_init (GstGLVideoMixerClass * klass)
           GST_TYPE_GL_VIDEO_MIXER_BACKGROUND,
           DEFAULT_BACKGROUND, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstGLVideoMixer:render-timing:
+   *
+   * Measure the GPU time spent drawing each pad with timer queries. The
+   * result of the previous frame is available from the "render-time" pad
+   * property.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_RENDER_TIMING,
+      g_param_spec_boolean ("render-timing", "Render Timing",
+          "Measure the GPU time spent drawing each pad", DEFAULT_RENDER_TIMING,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   GST_GL_MIXER_CLASS (klass)->set_caps = gst_gl_video_mixer_set_caps;
   GST_GL_MIXER_CLASS (klass)->reset = gst_gl_video_mixer_reset;
   GST_GL_MIXER_CLASS (klass)->process_textures =
@@ -936,6 +1032,7 @@ static void
 gst_gl_video_mixer_init (GstGLVideoMixer * video_mixer)
 {
   video_mixer->background = DEFAULT_BACKGROUND;
+  video_mixer->render_timing = DEFAULT_RENDER_TIMING;
   video_mixer->shader = NULL;
 }
 
@@ -949,6 +1046,11 @@ gst_gl_video_mixer_set_property (GObject * object, guint prop_id,
     case PROP_BACKGROUND:
       mixer->background = g_value_get_enum (value);
       break;
+    case PROP_RENDER_TIMING:
+      GST_OBJECT_LOCK (mixer);
+      mixer->render_timing = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (mixer);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -965,6 +1067,11 @@ gst_gl_video_mixer_get_property (GObject * object, guint prop_id,
     case PROP_BACKGROUND:
       g_value_set_enum (value, mixer->background);
       break;
+    case PROP_RENDER_TIMING:
+      GST_OBJECT_LOCK (mixer);
+      g_value_set_boolean (value, mixer->render_timing);
+      GST_OBJECT_UNLOCK (mixer);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1146,13 +1253,13 @@ _fixate_caps (GstAggregator * agg, GstCaps * caps)
 static gboolean
 _reset_pad_gl (GstElement * agg, GstPad * aggpad, gpointer udata)
 {
-  const GstGLFuncs *gl = GST_GL_BASE_MIXER (agg)->context->gl_vtable;
   GstGLVideoMixerPad *pad = GST_GL_VIDEO_MIXER_PAD (aggpad);
 
-  if (pad->vertex_buffer) {
-    gl->DeleteBuffers (1, &pad->vertex_buffer);
-    pad->vertex_buffer = 0;
+  if (pad->query) {
+    gst_gl_query_free (pad->query);
+    pad->query = NULL;
   }
+  pad->query_pending = FALSE;
 
   return TRUE;
 }
@@ -1177,6 +1284,17 @@ _reset_gl (GstGLContext * context, GstGLVideoMixer * video_mixer)
     video_mixer->checker_vbo = 0;
   }
 
+  if (video_mixer->vbo) {
+    gl->DeleteBuffers (1, &video_mixer->vbo);
+    video_mixer->vbo = 0;
+  }
+
+  if (video_mixer->vbo_pad_indices) {
+    gl->DeleteBuffers (1, &video_mixer->vbo_pad_indices);
+    video_mixer->vbo_pad_indices = 0;
+  }
+  video_mixer->n_pad_indices = 0;
+
   gst_element_foreach_sink_pad (GST_ELEMENT (video_mixer), _reset_pad_gl, NULL);
 }
 
@@ -1265,6 +1383,37 @@ _init_vbo_indices (GstGLVideoMixer * mixer)
   }
 }
 
+/* indices for @n_quads consecutive quads in the shared vertex buffer */
+static void
+_init_pad_indices (GstGLVideoMixer * mixer, guint n_quads)
+{
+  const GstGLFuncs *gl = GST_GL_BASE_MIXER (mixer)->context->gl_vtable;
+  GLushort *pad_indices;
+  guint i;
+
+  if (!mixer->vbo_pad_indices)
+    gl->GenBuffers (1, &mixer->vbo_pad_indices);
+  gl->BindBuffer (GL_ELEMENT_ARRAY_BUFFER, mixer->vbo_pad_indices);
+
+  if (n_quads <= mixer->n_pad_indices)
+    return;
+
+  pad_indices = g_new (GLushort, n_quads * 6);
+  for (i = 0; i < n_quads; i++) {
+    pad_indices[i * 6 + 0] = i * 4 + 0;
+    pad_indices[i * 6 + 1] = i * 4 + 1;
+    pad_indices[i * 6 + 2] = i * 4 + 2;
+    pad_indices[i * 6 + 3] = i * 4 + 0;
+    pad_indices[i * 6 + 4] = i * 4 + 2;
+    pad_indices[i * 6 + 5] = i * 4 + 3;
+  }
+  gl->BufferData (GL_ELEMENT_ARRAY_BUFFER, n_quads * 6 * sizeof (GLushort),
+      pad_indices, GL_STATIC_DRAW);
+  g_free (pad_indices);
+
+  mixer->n_pad_indices = n_quads;
+}
+
 static gboolean
 _draw_checker_background (GstGLVideoMixer * video_mixer)
 {
@@ -1475,6 +1624,36 @@ _set_blend_state (GstGLVideoMixer * video_mixer, GstGLVideoMixerPad * mix_pad)
   return TRUE;
 }
 
+/* transform the pad quad by @matrix and append it to @v as position + texture
+ * coordinates */
+static gfloat *
+_append_pad_quad (gfloat * v, const gfloat * matrix)
+{
+  /* *INDENT-OFF* */
+  static const gfloat quad[] = {
+    -1.0,-1.0, 0.0f, 0.0f,
+     1.0,-1.0, 1.0f, 0.0f,
+     1.0, 1.0, 1.0f, 1.0f,
+    -1.0, 1.0, 0.0f, 1.0f,
+  };
+  /* *INDENT-ON* */
+  guint i, j;
+
+  for (i = 0; i < 4; i++) {
+    gfloat x = quad[i * 4 + 0];
+    gfloat y = quad[i * 4 + 1];
+
+    /* column major, z = 0, w = 1 */
+    for (j = 0; j < 4; j++)
+      v[j] = matrix[j] * x + matrix[4 + j] * y + matrix[12 + j];
+    v[4] = quad[i * 4 + 2];
+    v[5] = quad[i * 4 + 3];
+    v += 6;
+  }
+
+  return v;
+}
+
 /* opengl scene, params: input texture (not the output mixer->texture) */
 static gboolean
 gst_gl_video_mixer_callback (gpointer stuff)
@@ -1482,16 +1661,29 @@ gst_gl_video_mixer_callback (gpointer stuff)
   GstGLVideoMixer *video_mixer = GST_GL_VIDEO_MIXER (stuff);
   GstVideoAggregator *vagg = GST_VIDEO_AGGREGATOR (stuff);
   GstGLMixer *mixer = GST_GL_MIXER (video_mixer);
-  GstGLFuncs *gl = GST_GL_BASE_MIXER (mixer)->context->gl_vtable;
+  GstGLContext *context = GST_GL_BASE_MIXER (mixer)->context;
+  GstGLFuncs *gl = context->gl_vtable;
   GLint attr_position_loc = 0;
   GLint attr_texture_loc = 0;
   guint out_width, out_height;
+  GstGLVideoMixerPad **draw_pads;
+  gfloat *vertices, *v;
+  guint n_pads, n_quads = 0, i;
   GList *walk;
 
+  /* *INDENT-OFF* */
+  static const gfloat identity[] = {
+    1.0f, 0.0f, 0.0f, 0.0f,
+    0.0f, 1.0f, 0.0f, 0.0f,
+    0.0f, 0.0f, 1.0f, 0.0f,
+    0.0f, 0.0f, 0.0f, 1.0f,
+  };
+  /* *INDENT-ON* */
+
   out_width = GST_VIDEO_INFO_WIDTH (&vagg->info);
   out_height = GST_VIDEO_INFO_HEIGHT (&vagg->info);
 
-  gst_gl_context_clear_shader (GST_GL_BASE_MIXER (mixer)->context);
+  gst_gl_context_clear_shader (context);
   gl->BindTexture (GL_TEXTURE_2D, 0);
 
   gl->Disable (GL_DEPTH_TEST);
@@ -1513,27 +1705,31 @@ gst_gl_video_mixer_callback (gpointer stuff)
   attr_texture_loc =
       gst_gl_shader_get_attribute_location (video_mixer->shader, "a_texcoord");
 
+  /* all the quads are transformed on the CPU and live in a single vertex
+   * buffer, only the texture, alpha and blend state change between pads */
+  gst_gl_shader_set_uniform_matrix_4fv (video_mixer->shader,
+      "u_transformation", 1, FALSE, identity);
+  gst_gl_shader_set_uniform_1i (video_mixer->shader, "texture", 0);
+  gl->ActiveTexture (GL_TEXTURE0);
+
   gl->Enable (GL_BLEND);
 
   GST_OBJECT_LOCK (video_mixer);
+  n_pads = GST_ELEMENT (video_mixer)->numsinkpads;
+  draw_pads = g_newa (GstGLVideoMixerPad *, n_pads);
+  v = vertices = g_new (gfloat, MAX (n_pads, 1) * 4 * 6);
+
   walk = GST_ELEMENT (video_mixer)->sinkpads;
   while (walk) {
     GstGLMixerPad *mix_pad = walk->data;
     GstGLVideoMixerPad *pad = walk->data;
     GstVideoAggregatorPad *vagg_pad = walk->data;
+    GstVideoAffineTransformationMeta *af_meta;
     GstVideoInfo *v_info;
-    guint in_tex;
+    gfloat af_matrix[16];
+    gfloat matrix[16];
     guint in_width, in_height;
 
-    /* *INDENT-OFF* */
-    gfloat v_vertices[] = {
-      -1.0,-1.0, 0.0f, 0.0f, 0.0f,
-       1.0,-1.0, 0.0f, 1.0f, 0.0f,
-       1.0, 1.0, 0.0f, 1.0f, 1.0f,
-      -1.0, 1.0, 0.0f, 0.0f, 1.0f,
-    };
-    /* *INDENT-ON* */
-
     v_info = &GST_VIDEO_AGGREGATOR_PAD (pad)->info;
     in_width = GST_VIDEO_INFO_WIDTH (v_info);
     in_height = GST_VIDEO_INFO_HEIGHT (v_info);
@@ -1546,18 +1742,7 @@ gst_gl_video_mixer_callback (gpointer stuff)
       continue;
     }
 
-    if (!_set_blend_state (video_mixer, pad)) {
-      GST_FIXME_OBJECT (pad, "skipping due to incorrect blend parameters");
-      walk = g_list_next (walk);
-      continue;
-    }
-
-    in_tex = mix_pad->current_texture;
-
-    _init_vbo_indices (video_mixer);
-
-    if (video_mixer->output_geo_change
-        || pad->geometry_change || !pad->vertex_buffer) {
+    if (video_mixer->output_geo_change || pad->geometry_change) {
       gint pad_width, pad_height;
       gfloat w, h;
 
@@ -1576,58 +1761,86 @@ gst_gl_video_mixer_callback (gpointer stuff)
           2. * (gfloat) pad->ypos / (gfloat) out_height - (1. - h);
 
       GST_TRACE ("processing texture:%u dimensions:%ux%u, at %f,%f %fx%f with "
-          "alpha:%f", in_tex, in_width, in_height, pad->m_matrix[12],
-          pad->m_matrix[13], pad->m_matrix[0], pad->m_matrix[5], pad->alpha);
-
-      if (!pad->vertex_buffer)
-        gl->GenBuffers (1, &pad->vertex_buffer);
-
-      gl->BindBuffer (GL_ARRAY_BUFFER, pad->vertex_buffer);
-      gl->BufferData (GL_ARRAY_BUFFER, 4 * 5 * sizeof (GLfloat), v_vertices,
-          GL_STATIC_DRAW);
+          "alpha:%f", mix_pad->current_texture, in_width, in_height,
+          pad->m_matrix[12], pad->m_matrix[13], pad->m_matrix[0],
+          pad->m_matrix[5], pad->alpha);
 
       pad->geometry_change = FALSE;
-    } else {
-      gl->BindBuffer (GL_ARRAY_BUFFER, pad->vertex_buffer);
     }
-    gl->BindBuffer (GL_ELEMENT_ARRAY_BUFFER, video_mixer->vbo_indices);
 
-    gl->ActiveTexture (GL_TEXTURE0);
-    gl->BindTexture (GL_TEXTURE_2D, in_tex);
-    gst_gl_shader_set_uniform_1i (video_mixer->shader, "texture", 0);
-    gst_gl_shader_set_uniform_1f (video_mixer->shader, "alpha", pad->alpha);
+    af_meta =
+        gst_buffer_get_video_affine_transformation_meta
+        (gst_video_aggregator_pad_get_current_buffer (vagg_pad));
+    gst_gl_get_affine_transformation_meta_as_ndc_ext (af_meta, af_matrix);
+    gst_gl_multiply_matrix4 (af_matrix, pad->m_matrix, matrix);
 
-    {
-      GstVideoAffineTransformationMeta *af_meta;
-      gfloat matrix[16];
-      gfloat af_matrix[16];
-      GstBuffer *buffer =
-          gst_video_aggregator_pad_get_current_buffer (vagg_pad);
-
-      af_meta = gst_buffer_get_video_affine_transformation_meta (buffer);
-      gst_gl_get_affine_transformation_meta_as_ndc_ext (af_meta, af_matrix);
-      gst_gl_multiply_matrix4 (af_matrix, pad->m_matrix, matrix);
-      gst_gl_shader_set_uniform_matrix_4fv (video_mixer->shader,
-          "u_transformation", 1, FALSE, matrix);
-    }
+    v = _append_pad_quad (v, matrix);
+    draw_pads[n_quads++] = pad;
+
+    walk = g_list_next (walk);
+  }
+
+  video_mixer->output_geo_change = FALSE;
+
+  if (n_quads > 0) {
+    if (!video_mixer->vbo)
+      gl->GenBuffers (1, &video_mixer->vbo);
+    gl->BindBuffer (GL_ARRAY_BUFFER, video_mixer->vbo);
+    gl->BufferData (GL_ARRAY_BUFFER, n_quads * 4 * 6 * sizeof (GLfloat),
+        vertices, GL_STREAM_DRAW);
+
+    _init_pad_indices (video_mixer, n_quads);
 
     gl->EnableVertexAttribArray (attr_position_loc);
     gl->EnableVertexAttribArray (attr_texture_loc);
 
-    gl->VertexAttribPointer (attr_position_loc, 3, GL_FLOAT,
-        GL_FALSE, 5 * sizeof (GLfloat), (void *) 0);
+    gl->VertexAttribPointer (attr_position_loc, 4, GL_FLOAT,
+        GL_FALSE, 6 * sizeof (GLfloat), (void *) 0);
 
     gl->VertexAttribPointer (attr_texture_loc, 2, GL_FLOAT,
-        GL_FALSE, 5 * sizeof (GLfloat), (void *) (3 * sizeof (GLfloat)));
+        GL_FALSE, 6 * sizeof (GLfloat), (void *) (4 * sizeof (GLfloat)));
+  }
 
-    gl->DrawElements (GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, 0);
+  for (i = 0; i < n_quads; i++) {
+    GstGLVideoMixerPad *pad = draw_pads[i];
+    GstGLMixerPad *mix_pad = GST_GL_MIXER_PAD (pad);
 
-    walk = g_list_next (walk);
-  }
+    if (!_set_blend_state (video_mixer, pad)) {
+      GST_FIXME_OBJECT (pad, "skipping due to incorrect blend parameters");
+      continue;
+    }
 
-  video_mixer->output_geo_change = FALSE;
+    gl->BindTexture (GL_TEXTURE_2D, mix_pad->current_texture);
+    gst_gl_shader_set_uniform_1f (video_mixer->shader, "alpha", pad->alpha);
+
+    if (video_mixer->render_timing) {
+      if (!pad->query)
+        pad->query = gst_gl_query_new (context, GST_GL_QUERY_TIME_ELAPSED);
+
+      /* the previous frame's result is ready by now and does not stall */
+      if (pad->query_pending) {
+        guint64 render_time = gst_gl_query_result (pad->query);
+
+        GST_OBJECT_LOCK (pad);
+        pad->render_time = render_time;
+        GST_OBJECT_UNLOCK (pad);
+      }
+
+      gst_gl_query_start (pad->query);
+    }
+
+    gl->DrawElements (GL_TRIANGLES, 6, GL_UNSIGNED_SHORT,
+        (void *) (i * 6 * sizeof (GLushort)));
+
+    if (video_mixer->render_timing) {
+      gst_gl_query_end (pad->query);
+      pad->query_pending = TRUE;
+    }
+  }
   GST_OBJECT_UNLOCK (video_mixer);
 
+  g_free (vertices);
+
   if (gl->GenVertexArrays) {
     gl->BindVertexArray (0);
   } else {
@@ -1641,7 +1854,7 @@ gst_gl_video_mixer_callback (gpointer stuff)
 
   gl->Disable (GL_BLEND);
 
-  gst_gl_context_clear_shader (GST_GL_BASE_MIXER (mixer)->context);
+  gst_gl_context_clear_shader (context);
 
   return TRUE;
 }
@@ -125,9 +125,13 @@ struct _GstGLVideoMixer
     GLuint vao;
     GLuint vbo_indices;
     GLuint checker_vbo;
+    GLuint vbo;
+    GLuint vbo_pad_indices;
+    guint n_pad_indices;
     GstGLMemory *out_tex;
 
     gboolean output_geo_change;
+    gboolean render_timing;
 };
 
 struct _GstGLVideoMixerClass
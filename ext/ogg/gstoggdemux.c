@@ -32,6 +32,18 @@
  * ]|
  *  Decodes a vorbis audio stream stored inside an ogg container and plays it.
  *
+ * ## Seek index
+ *
+ * oggdemux remembers the time and byte offset of the pages it reads while
+ * seeking and uses them to narrow the search of later seeks, so that
+ * repeatedly seeking around the same area of a file only needs a few reads.
+ * The index collected so far can be retrieved with a custom query carrying a
+ * structure named "GstOggDemuxSeekIndex" sent to any source pad. On success
+ * the structure contains the "times" (guint64), "offsets" (gint64) and
+ * "serialnos" (guint) arrays, sorted by time, as well as the number of
+ * bisections the index narrowed ("narrowed-seeks", guint64) and of pages
+ * read while bisecting in pull mode ("bisection-reads", guint64).
+ *
  */
 
 
@@ -60,6 +72,11 @@
 
 #define SEEK_GIVE_UP_THRESHOLD (3*GST_SECOND)
 
+/* an hour of a typical audio+video stream has a few ten thousand pages */
+#define MAX_SEEK_INDEX_ENTRIES (1 << 17)
+
+#define SEEK_INDEX_QUERY_NAME "GstOggDemuxSeekIndex"
+
 #define GST_CHAIN_LOCK(ogg)     g_mutex_lock(&(ogg)->chain_lock)
 #define GST_CHAIN_UNLOCK(ogg)   g_mutex_unlock(&(ogg)->chain_lock)
 
@@ -112,6 +129,172 @@ gst_ogg_page_copy (ogg_page * page)
   return p;
 }
 
+typedef struct
+{
+  GstClockTime time;            /* end time of the page in the chain timeline */
+  gint64 offset;                /* offset of the page */
+  gint64 next_offset;           /* offset right after the page */
+  guint32 serialno;
+} GstOggSeekIndexEntry;
+
+static gint
+gst_ogg_seek_index_entry_compare (const GstOggSeekIndexEntry * a,
+    GstClockTime time, gint64 offset)
+{
+  if (a->time != time)
+    return a->time < time ? -1 : 1;
+  if (a->offset != offset)
+    return a->offset < offset ? -1 : 1;
+  return 0;
+}
+
+/* index of the first entry at or after @time/@offset */
+static guint
+gst_ogg_demux_index_find (GstOggDemux * ogg, GstClockTime time, gint64 offset)
+{
+  guint lo = 0, hi = ogg->seek_index->len;
+
+  while (lo < hi) {
+    guint mid = lo + (hi - lo) / 2;
+    GstOggSeekIndexEntry *e =
+        &g_array_index (ogg->seek_index, GstOggSeekIndexEntry, mid);
+
+    if (gst_ogg_seek_index_entry_compare (e, time, offset) < 0)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  return lo;
+}
+
+static void
+gst_ogg_demux_index_add (GstOggDemux * ogg, GstClockTime time, gint64 offset,
+    gint64 next_offset, guint32 serialno)
+{
+  GstOggSeekIndexEntry entry;
+  guint idx;
+
+  if (!GST_CLOCK_TIME_IS_VALID (time) || offset < 0)
+    return;
+
+  GST_OBJECT_LOCK (ogg);
+  idx = gst_ogg_demux_index_find (ogg, time, offset);
+  if (idx < ogg->seek_index->len
+      && gst_ogg_seek_index_entry_compare (&g_array_index (ogg->seek_index,
+              GstOggSeekIndexEntry, idx), time, offset) == 0)
+    goto done;
+
+  if (ogg->seek_index->len >= MAX_SEEK_INDEX_ENTRIES)
+    goto done;
+
+  entry.time = time;
+  entry.offset = offset;
+  entry.next_offset = next_offset;
+  entry.serialno = serialno;
+  g_array_insert_val (ogg->seek_index, idx, entry);
+
+  GST_LOG_OBJECT (ogg, "indexed page at %" G_GINT64_FORMAT " with time %"
+      GST_TIME_FORMAT ", %u entries", offset, GST_TIME_ARGS (time),
+      ogg->seek_index->len);
+
+done:
+  GST_OBJECT_UNLOCK (ogg);
+}
+
+/* find the last indexed page before @target and the first one at or after
+ * it, optionally only looking at pages of stream @serialno. Missing entries
+ * have an offset of -1 */
+static gboolean
+gst_ogg_demux_index_lookup (GstOggDemux * ogg, GstClockTime target,
+    gboolean only_serialno, guint32 serialno, GstOggSeekIndexEntry * lower,
+    GstOggSeekIndexEntry * upper)
+{
+  guint idx, i;
+
+  lower->offset = upper->offset = -1;
+
+  GST_OBJECT_LOCK (ogg);
+  idx = gst_ogg_demux_index_find (ogg, target, 0);
+
+  for (i = idx; i < ogg->seek_index->len; i++) {
+    GstOggSeekIndexEntry *e =
+        &g_array_index (ogg->seek_index, GstOggSeekIndexEntry, i);
+
+    if (!only_serialno || e->serialno == serialno) {
+      *upper = *e;
+      break;
+    }
+  }
+  for (i = idx; i > 0; i--) {
+    GstOggSeekIndexEntry *e =
+        &g_array_index (ogg->seek_index, GstOggSeekIndexEntry, i - 1);
+
+    if (!only_serialno || e->serialno == serialno) {
+      *lower = *e;
+      break;
+    }
+  }
+  GST_OBJECT_UNLOCK (ogg);
+
+  /* pages of different streams are not strictly ordered by time, ignore
+   * an upper bound that would end the search before it begins */
+  if (lower->offset != -1 && upper->offset != -1
+      && upper->offset <= lower->offset)
+    upper->offset = -1;
+
+  return lower->offset != -1 || upper->offset != -1;
+}
+
+static void
+gst_ogg_demux_index_clear (GstOggDemux * ogg)
+{
+  GST_OBJECT_LOCK (ogg);
+  g_array_set_size (ogg->seek_index, 0);
+  ogg->stats_index_hits = 0;
+  ogg->stats_bisection_reads = 0;
+  GST_OBJECT_UNLOCK (ogg);
+}
+
+static void
+gst_ogg_demux_index_fill_query (GstOggDemux * ogg, GstStructure * s)
+{
+  GValue times = G_VALUE_INIT, offsets = G_VALUE_INIT;
+  GValue serialnos = G_VALUE_INIT;
+  guint i;
+
+  g_value_init (&times, GST_TYPE_ARRAY);
+  g_value_init (&offsets, GST_TYPE_ARRAY);
+  g_value_init (&serialnos, GST_TYPE_ARRAY);
+
+  GST_OBJECT_LOCK (ogg);
+  for (i = 0; i < ogg->seek_index->len; i++) {
+    GstOggSeekIndexEntry *e =
+        &g_array_index (ogg->seek_index, GstOggSeekIndexEntry, i);
+    GValue v = G_VALUE_INIT;
+
+    g_value_init (&v, G_TYPE_UINT64);
+    g_value_set_uint64 (&v, e->time);
+    gst_value_array_append_and_take_value (&times, &v);
+
+    g_value_init (&v, G_TYPE_INT64);
+    g_value_set_int64 (&v, e->offset);
+    gst_value_array_append_and_take_value (&offsets, &v);
+
+    g_value_init (&v, G_TYPE_UINT);
+    g_value_set_uint (&v, e->serialno);
+    gst_value_array_append_and_take_value (&serialnos, &v);
+  }
+  gst_structure_set (s, "narrowed-seeks", G_TYPE_UINT64,
+      ogg->stats_index_hits, "bisection-reads", G_TYPE_UINT64,
+      ogg->stats_bisection_reads, NULL);
+  GST_OBJECT_UNLOCK (ogg);
+
+  gst_structure_take_value (s, "times", &times);
+  gst_structure_take_value (s, "offsets", &offsets);
+  gst_structure_take_value (s, "serialnos", &serialnos);
+}
+
 static void
 gst_ogg_page_free (ogg_page * page)
 {
@@ -387,6 +570,17 @@ gst_ogg_pad_src_query (GstPad * pad, GstObject * parent, GstQuery * query)
       res = TRUE;
       break;
     }
+    case GST_QUERY_CUSTOM:{
+      GstStructure *s = gst_query_writable_structure (query);
+
+      if (gst_structure_has_name (s, SEEK_INDEX_QUERY_NAME)) {
+        gst_ogg_demux_index_fill_query (ogg, s);
+        res = TRUE;
+      } else {
+        res = gst_pad_query_default (pad, parent, query);
+      }
+      break;
+    }
     default:
       res = gst_pad_query_default (pad, parent, query);
       break;
@@ -1437,6 +1631,44 @@ gst_ogg_demux_setup_bisection_bounds (GstOggDemux * ogg)
   }
 }
 
+/* narrow the push mode bisection bounds with the pages we already know
+ * about, returns TRUE if any bound changed */
+static gboolean
+gst_ogg_demux_index_narrow_push_bounds (GstOggDemux * ogg)
+{
+  GstOggSeekIndexEntry lower, upper;
+  gboolean narrowed = FALSE;
+
+  if (!gst_ogg_demux_index_lookup (ogg, ogg->push_seek_time_target, FALSE, 0,
+          &lower, &upper))
+    return FALSE;
+
+  if (lower.offset != -1 && lower.offset > ogg->push_offset0
+      && lower.offset < ogg->push_offset1) {
+    ogg->push_offset0 = lower.offset;
+    ogg->push_time0 = lower.time;
+    narrowed = TRUE;
+  }
+  if (upper.offset != -1 && upper.offset > ogg->push_offset0
+      && upper.offset < ogg->push_offset1) {
+    ogg->push_offset1 = upper.offset;
+    ogg->push_time1 = upper.time;
+    narrowed = TRUE;
+  }
+
+  if (narrowed) {
+    GST_OBJECT_LOCK (ogg);
+    ogg->stats_index_hits++;
+    GST_OBJECT_UNLOCK (ogg);
+    GST_DEBUG_OBJECT (ogg, "index narrowed bisection to %" G_GINT64_FORMAT
+        " - %" G_GINT64_FORMAT " (time %" GST_TIME_FORMAT " - %"
+        GST_TIME_FORMAT ")", ogg->push_offset0, ogg->push_offset1,
+        GST_TIME_ARGS (ogg->push_time0), GST_TIME_ARGS (ogg->push_time1));
+  }
+
+  return narrowed;
+}
+
 static gint64
 gst_ogg_demux_estimate_bisection_target (GstOggDemux * ogg, float seek_quality)
 {
@@ -1668,6 +1900,11 @@ gst_ogg_demux_update_bisection_stats (GstOggDemux * ogg)
   }
   ogg->stats_nbisections++;
 
+  GST_OBJECT_LOCK (ogg);
+  GST_INFO_OBJECT (ogg, "Seek index: %u entries, narrowed %" G_GUINT64_FORMAT
+      " seeks", ogg->seek_index->len, ogg->stats_index_hits);
+  GST_OBJECT_UNLOCK (ogg);
+
   GST_INFO_OBJECT (ogg,
       "So far, %.2f + %.2f bisections needed per seek (max %d + %d)",
       ogg->stats_bisection_steps[0] / (float) ogg->stats_nbisections,
@@ -1786,6 +2023,10 @@ gst_ogg_pad_handle_push_mode_state (GstOggPad * pad, ogg_page * page)
       }
       ogg->push_last_seek_time = sync_time;
 
+      /* data following the seek offset starts at sync_time */
+      gst_ogg_demux_index_add (ogg, sync_time, ogg->push_last_seek_offset,
+          ogg->push_last_seek_offset, pad->map.serialno);
+
       GST_DEBUG_OBJECT (ogg,
           "Bisection just seeked at %" G_GINT64_FORMAT ", time %"
           GST_TIME_FORMAT ", target was %" GST_TIME_FORMAT,
@@ -1917,6 +2158,7 @@ gst_ogg_pad_handle_push_mode_state (GstOggPad * pad, ogg_page * page)
             ogg->seek_undershot = FALSE;
 
             ogg->push_state = PUSH_BISECT2;
+            gst_ogg_demux_index_narrow_push_bounds (ogg);
             best = gst_ogg_demux_estimate_bisection_target (ogg, 1.0f);
           }
         }
@@ -2346,6 +2588,10 @@ gst_ogg_demux_init (GstOggDemux * ogg)
   ogg->stats_bisection_max_steps[0] = 0;
   ogg->stats_bisection_max_steps[1] = 0;
 
+  ogg->seek_index = g_array_new (FALSE, FALSE, sizeof (GstOggSeekIndexEntry));
+  ogg->stats_index_hits = 0;
+  ogg->stats_bisection_reads = 0;
+
   ogg->newsegment = NULL;
   ogg->seqnum = GST_SEQNUM_INVALID;
 
@@ -2361,6 +2607,7 @@ gst_ogg_demux_finalize (GObject * object)
   ogg = GST_OGG_DEMUX (object);
 
   g_array_free (ogg->chains, TRUE);
+  g_array_free (ogg->seek_index, TRUE);
   g_mutex_clear (&ogg->chain_lock);
   g_mutex_clear (&ogg->push_lock);
   g_cond_clear (&ogg->seek_event_cond);
@@ -3098,9 +3345,34 @@ do_binary_search (GstOggDemux * ogg, GstOggChain * chain, gint64 begin,
   gint64 best;
   GstFlowReturn ret;
   gint64 result = 0;
+  GstOggSeekIndexEntry lower, upper;
 
   best = begin;
 
+  /* start from the closest pages around the target we already know about,
+   * if they are adjacent there is nothing left to search */
+  if (gst_ogg_demux_index_lookup (ogg, target, only_serial_no, serialno,
+          &lower, &upper)) {
+    gboolean narrowed = FALSE;
+
+    if (lower.offset >= begin && lower.next_offset <= end) {
+      best = lower.offset;
+      begin = lower.next_offset;
+      begintime = lower.time;
+      narrowed = TRUE;
+    }
+    if (upper.offset != -1 && upper.offset >= begin && upper.offset <= end) {
+      end = upper.offset;
+      endtime = upper.time;
+      narrowed = TRUE;
+    }
+    if (narrowed) {
+      GST_OBJECT_LOCK (ogg);
+      ogg->stats_index_hits++;
+      GST_OBJECT_UNLOCK (ogg);
+    }
+  }
+
   GST_DEBUG_OBJECT (ogg,
       "chain offset %" G_GINT64_FORMAT ", end offset %" G_GINT64_FORMAT,
       begin, end);
@@ -3139,6 +3411,10 @@ do_binary_search (GstOggDemux * ogg, GstOggChain * chain, gint64 begin,
       GST_LOG_OBJECT (ogg, "looking for next page returned %" G_GINT64_FORMAT,
           result);
 
+      GST_OBJECT_LOCK (ogg);
+      ogg->stats_bisection_reads++;
+      GST_OBJECT_UNLOCK (ogg);
+
       if (ret == GST_FLOW_LIMIT) {
         /* we hit the upper limit, go back a bit */
         if (bisect <= begin + 1) {
@@ -3194,6 +3470,9 @@ do_binary_search (GstOggDemux * ogg, GstOggChain * chain, gint64 begin,
             "found page with granule %" G_GINT64_FORMAT " and time %"
             GST_TIME_FORMAT, granulepos, GST_TIME_ARGS (granuletime));
 
+        gst_ogg_demux_index_add (ogg, granuletime, result, ogg->offset,
+            ogg_page_serialno (&og));
+
         if (granuletime < target) {
           best = result;        /* raw offset of packet with granulepos */
           begin = ogg->offset;  /* raw offset of next page */
@@ -3394,6 +3673,10 @@ gst_ogg_demux_do_seek (GstOggDemux * ogg, GstSegment * segment,
        to fill up a queue for streams still active). */
     ts = gst_ogg_stream_get_end_time_for_granulepos (&pad->map, granulepos);
     if (GST_CLOCK_TIME_IS_VALID (ts)) {
+      if (ts >= pad->start_time)
+        gst_ogg_demux_index_add (ogg, ts - pad->start_time + chain->begin_time,
+            result, ogg->offset, pad->map.serialno);
+
       if (first_ts == GST_CLOCK_TIME_NONE) {
         GST_WARNING_OBJECT (pad, "Locking on pts %" GST_TIME_FORMAT,
             GST_TIME_ARGS (ts));
@@ -3944,6 +4227,18 @@ gst_ogg_demux_perform_seek_push (GstOggDemux * ogg, GstEvent * event)
   ogg->seek_secant = FALSE;
   ogg->seek_undershot = FALSE;
 
+  /* start from the closest pages we have already seen, interpolating
+   * between them when the target is bracketed */
+  if (gst_ogg_demux_index_narrow_push_bounds (ogg)) {
+    if (ogg->push_time1 != GST_CLOCK_TIME_NONE
+        && ogg->push_time1 > ogg->push_time0 && start >= ogg->push_time0) {
+      best = ogg->push_offset0 + gst_util_uint64_scale (start -
+          ogg->push_time0, ogg->push_offset1 - ogg->push_offset0,
+          ogg->push_time1 - ogg->push_time0);
+    }
+    best = CLAMP (best, ogg->push_offset0, ogg->push_offset1);
+  }
+
   if (flags & GST_SEEK_FLAG_FLUSH) {
     /* reset pad push mode seeking state */
     for (i = 0; i < chain->streams->len; i++) {
@@ -5072,6 +5367,8 @@ gst_ogg_demux_clear_chains (GstOggDemux * ogg)
     ogg->building_chain = NULL;
   }
   GST_CHAIN_UNLOCK (ogg);
+
+  gst_ogg_demux_index_clear (ogg);
 }
 
 /* this function is called when the pad is activated and should start
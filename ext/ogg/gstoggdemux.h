@@ -199,6 +199,14 @@ struct _GstOggDemux
   gint stats_bisection_max_steps[2];
   gint stats_nbisections;
 
+  /* time -> byte offset of the pages seen so far, sorted by time, used to
+   * narrow the bisection of later seeks, and the number of bisections it
+   * narrowed and of pages read while bisecting in pull mode. Protected by
+   * the object lock */
+  GArray *seek_index;
+  guint64 stats_index_hits;
+  guint64 stats_bisection_reads;
+
   /* ogg stuff */
   ogg_sync_state sync;
   long chunk_size;
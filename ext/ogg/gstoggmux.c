@@ -25,6 +25,17 @@
  *
  * This element merges streams (audio and video) into ogg files.
  *
+ * In live pipelines pages are pushed out at the latest
+ * #GstOggMux:max-page-delay after their first packet was received, even if
+ * other streams did not produce data in the meantime.
+ *
+ * Subtitle streams only hold back the other streams while they have data
+ * queued. Once their headers are known, either from the streamheader field
+ * of their caps or from their first packet, an idle subtitle stream does not
+ * keep pages of the other streams from being pushed. In non-live pipelines
+ * every stream still has to provide either data or GAP events for the muxer
+ * to make progress, so idle sparse streams should send GAP events.
+ *
  * ## Example pipelines
  * |[
  * gst-launch-1.0 v4l2src num-buffers=500 ! video/x-raw,width=320,height=240 ! videoconvert ! videorate ! theoraenc ! oggmux ! filesink location=video.ogg
@@ -71,6 +82,9 @@ GST_DEBUG_CATEGORY_STATIC (gst_ogg_mux_debug);
 #define DEFAULT_MAX_TOLERANCE   G_GINT64_CONSTANT(40000000)
 #define DEFAULT_SKELETON        FALSE
 
+/* lower bound for the interval between two live timeouts */
+#define MIN_TIMEOUT_INTERVAL    (20 * GST_MSECOND)
+
 enum
 {
   ARG_0,
@@ -112,30 +126,66 @@ static GstStaticPadTemplate subtitle_sink_factory =
         "subtitle/x-kate; application/x-kate")
     );
 
-static void gst_ogg_mux_finalize (GObject * object);
-
-static GstFlowReturn gst_ogg_mux_collected (GstCollectPads * pads,
-    GstOggMux * ogg_mux);
-static gboolean gst_ogg_mux_sink_event (GstCollectPads * pads,
-    GstCollectData * pad, GstEvent * event, gpointer user_data);
-static gboolean gst_ogg_mux_handle_src_event (GstPad * pad, GstObject * parent,
-    GstEvent * event);
-static GstPad *gst_ogg_mux_request_new_pad (GstElement * element,
-    GstPadTemplate * templ, const gchar * name, const GstCaps * caps);
-static void gst_ogg_mux_release_pad (GstElement * element, GstPad * pad);
+static GstFlowReturn gst_ogg_mux_aggregate (GstAggregator * agg,
+    gboolean timeout);
+static gboolean gst_ogg_mux_sink_event (GstAggregator * agg,
+    GstAggregatorPad * aggpad, GstEvent * event);
+static gboolean gst_ogg_mux_src_event (GstAggregator * agg, GstEvent * event);
+static GstAggregatorPad *gst_ogg_mux_create_new_pad (GstAggregator * agg,
+    GstPadTemplate * templ, const gchar * req_name, const GstCaps * caps);
+static GstFlowReturn gst_ogg_mux_flush (GstAggregator * agg);
+static gboolean gst_ogg_mux_start (GstAggregator * agg);
+static gboolean gst_ogg_mux_stop (GstAggregator * agg);
+static GstClockTime gst_ogg_mux_get_next_time (GstAggregator * agg);
 static void gst_ogg_pad_data_reset (GstOggMux * ogg_mux,
-    GstOggPadData * pad_data);
+    GstOggMuxPad * pad_data);
 
 static void gst_ogg_mux_set_property (GObject * object,
     guint prop_id, const GValue * value, GParamSpec * pspec);
 static void gst_ogg_mux_get_property (GObject * object,
     guint prop_id, GValue * value, GParamSpec * pspec);
-static GstStateChangeReturn gst_ogg_mux_change_state (GstElement * element,
-    GstStateChange transition);
+
+G_DEFINE_TYPE (GstOggMuxPad, gst_ogg_mux_pad, GST_TYPE_AGGREGATOR_PAD);
+
+static void
+gst_ogg_mux_pad_finalize (GObject * object)
+{
+  GstOggMuxPad *oggpad = GST_OGG_MUX_PAD (object);
+  GstBuffer *buf;
+
+  ogg_stream_clear (&oggpad->map.stream);
+  gst_caps_replace (&oggpad->map.caps, NULL);
+
+  while ((buf = g_queue_pop_head (oggpad->pagebuffers)) != NULL) {
+    gst_buffer_unref (buf);
+  }
+  g_queue_free (oggpad->pagebuffers);
+
+  gst_buffer_replace (&oggpad->buffer, NULL);
+  if (oggpad->tags)
+    gst_tag_list_unref (oggpad->tags);
+
+  G_OBJECT_CLASS (gst_ogg_mux_pad_parent_class)->finalize (object);
+}
+
+static void
+gst_ogg_mux_pad_class_init (GstOggMuxPadClass * klass)
+{
+  GObjectClass *gobject_class = (GObjectClass *) klass;
+
+  gobject_class->finalize = gst_ogg_mux_pad_finalize;
+}
+
+static void
+gst_ogg_mux_pad_init (GstOggMuxPad * oggpad)
+{
+  oggpad->pagebuffers = g_queue_new ();
+  gst_segment_init (&oggpad->segment, GST_FORMAT_TIME);
+}
 
 /*static guint gst_ogg_mux_signals[LAST_SIGNAL] = { 0 }; */
 #define gst_ogg_mux_parent_class parent_class
-G_DEFINE_TYPE_WITH_CODE (GstOggMux, gst_ogg_mux, GST_TYPE_ELEMENT,
+G_DEFINE_TYPE_WITH_CODE (GstOggMux, gst_ogg_mux, GST_TYPE_AGGREGATOR,
     G_IMPLEMENT_INTERFACE (GST_TYPE_PRESET, NULL));
 
 static void
@@ -143,35 +193,54 @@ gst_ogg_mux_class_init (GstOggMuxClass * klass)
 {
   GObjectClass *gobject_class;
   GstElementClass *gstelement_class;
+  GstAggregatorClass *gstaggregator_class;
 
   gobject_class = (GObjectClass *) klass;
   gstelement_class = (GstElementClass *) klass;
+  gstaggregator_class = (GstAggregatorClass *) klass;
 
-  gobject_class->finalize = gst_ogg_mux_finalize;
   gobject_class->get_property = gst_ogg_mux_get_property;
   gobject_class->set_property = gst_ogg_mux_set_property;
 
-  gst_element_class_add_static_pad_template (gstelement_class, &src_factory);
-  gst_element_class_add_static_pad_template (gstelement_class,
-      &video_sink_factory);
-  gst_element_class_add_static_pad_template (gstelement_class,
-      &audio_sink_factory);
-  gst_element_class_add_static_pad_template (gstelement_class,
-      &subtitle_sink_factory);
+  gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
+      &src_factory, GST_TYPE_AGGREGATOR_PAD);
+  gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
+      &video_sink_factory, GST_TYPE_OGG_MUX_PAD);
+  gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
+      &audio_sink_factory, GST_TYPE_OGG_MUX_PAD);
+  gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
+      &subtitle_sink_factory, GST_TYPE_OGG_MUX_PAD);
 
   gst_element_class_set_static_metadata (gstelement_class,
       "Ogg muxer", "Codec/Muxer",
       "mux ogg streams (info about ogg: http://xiph.org)",
       "Wim Taymans <wim@fluendo.com>");
 
-  gstelement_class->request_new_pad = gst_ogg_mux_request_new_pad;
-  gstelement_class->release_pad = gst_ogg_mux_release_pad;
+  gstaggregator_class->aggregate = GST_DEBUG_FUNCPTR (gst_ogg_mux_aggregate);
+  gstaggregator_class->create_new_pad =
+      GST_DEBUG_FUNCPTR (gst_ogg_mux_create_new_pad);
+  gstaggregator_class->sink_event = GST_DEBUG_FUNCPTR (gst_ogg_mux_sink_event);
+  gstaggregator_class->src_event = GST_DEBUG_FUNCPTR (gst_ogg_mux_src_event);
+  gstaggregator_class->flush = GST_DEBUG_FUNCPTR (gst_ogg_mux_flush);
+  gstaggregator_class->start = GST_DEBUG_FUNCPTR (gst_ogg_mux_start);
+  gstaggregator_class->stop = GST_DEBUG_FUNCPTR (gst_ogg_mux_stop);
+  gstaggregator_class->get_next_time =
+      GST_DEBUG_FUNCPTR (gst_ogg_mux_get_next_time);
 
   g_object_class_install_property (gobject_class, ARG_MAX_DELAY,
       g_param_spec_uint64 ("max-delay", "Max delay",
           "Maximum delay in multiplexing streams", 0, G_MAXUINT64,
           DEFAULT_MAX_DELAY,
           (GParamFlags) G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstOggMux:max-page-delay:
+   *
+   * Maximum time a packet is held back in a page that is being filled.
+   *
+   * This is also the latency the muxer reports. In live pipelines pages
+   * that are still being filled are flushed out when this deadline expires,
+   * even if other streams have not delivered data yet.
+   */
   g_object_class_install_property (gobject_class, ARG_MAX_PAGE_DELAY,
       g_param_spec_uint64 ("max-page-delay", "Max page delay",
           "Maximum delay for sending out a page", 0, G_MAXUINT64,
@@ -187,9 +256,6 @@ gst_ogg_mux_class_init (GstOggMuxClass * klass)
           "Whether to include a Skeleton track",
           DEFAULT_SKELETON,
           (GParamFlags) G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
-
-  gstelement_class->change_state = gst_ogg_mux_change_state;
-
 }
 
 static void
@@ -197,111 +263,65 @@ gst_ogg_mux_clear (GstOggMux * ogg_mux)
 {
   ogg_mux->pulling = NULL;
   ogg_mux->need_headers = TRUE;
-  ogg_mux->need_start_events = TRUE;
   ogg_mux->delta_pad = NULL;
   ogg_mux->offset = 0;
   ogg_mux->next_ts = 0;
   ogg_mux->last_ts = GST_CLOCK_TIME_NONE;
+  ogg_mux->timeout = FALSE;
+  ogg_mux->next_time = 0;
 }
 
 static void
-gst_ogg_mux_init (GstOggMux * ogg_mux)
+gst_ogg_mux_update_latency (GstOggMux * ogg_mux)
 {
-  GstElementClass *klass = GST_ELEMENT_GET_CLASS (ogg_mux);
-
-  ogg_mux->srcpad =
-      gst_pad_new_from_template (gst_element_class_get_pad_template (klass,
-          "src"), "src");
-  gst_pad_set_event_function (ogg_mux->srcpad, gst_ogg_mux_handle_src_event);
-  gst_element_add_pad (GST_ELEMENT (ogg_mux), ogg_mux->srcpad);
+  /* a packet can sit in an unfinished page for up to max-page-delay */
+  gst_aggregator_set_latency (GST_AGGREGATOR (ogg_mux),
+      ogg_mux->max_page_delay, ogg_mux->max_page_delay);
+}
 
+static void
+gst_ogg_mux_init (GstOggMux * ogg_mux)
+{
   /* seed random number generator for creation of serial numbers */
   srand (time (NULL));
 
-  ogg_mux->collect = gst_collect_pads_new ();
-  gst_collect_pads_set_function (ogg_mux->collect,
-      (GstCollectPadsFunction) GST_DEBUG_FUNCPTR (gst_ogg_mux_collected),
-      ogg_mux);
-  gst_collect_pads_set_event_function (ogg_mux->collect,
-      (GstCollectPadsEventFunction) GST_DEBUG_FUNCPTR (gst_ogg_mux_sink_event),
-      ogg_mux);
-
   ogg_mux->max_delay = DEFAULT_MAX_DELAY;
   ogg_mux->max_page_delay = DEFAULT_MAX_PAGE_DELAY;
   ogg_mux->max_tolerance = DEFAULT_MAX_TOLERANCE;
 
   gst_ogg_mux_clear (ogg_mux);
+  gst_ogg_mux_update_latency (ogg_mux);
 }
 
-static void
-gst_ogg_mux_finalize (GObject * object)
-{
-  GstOggMux *ogg_mux;
-
-  ogg_mux = GST_OGG_MUX (object);
-
-  if (ogg_mux->collect) {
-    gst_object_unref (ogg_mux->collect);
-    ogg_mux->collect = NULL;
-  }
-
-  G_OBJECT_CLASS (parent_class)->finalize (object);
-}
-
-static void
-gst_ogg_mux_ogg_pad_destroy_notify (GstCollectData * data)
-{
-  GstOggPadData *oggpad = (GstOggPadData *) data;
-  GstBuffer *buf;
-
-  ogg_stream_clear (&oggpad->map.stream);
-  gst_caps_replace (&oggpad->map.caps, NULL);
-
-  if (oggpad->pagebuffers) {
-    while ((buf = g_queue_pop_head (oggpad->pagebuffers)) != NULL) {
-      gst_buffer_unref (buf);
-    }
-    g_queue_free (oggpad->pagebuffers);
-    oggpad->pagebuffers = NULL;
-  }
-}
-
-static GstPadLinkReturn
-gst_ogg_mux_sinkconnect (GstPad * pad, GstObject * parent, GstPad * peer)
-{
-  GstOggMux *ogg_mux;
-
-  ogg_mux = GST_OGG_MUX (parent);
-
-  GST_DEBUG_OBJECT (ogg_mux, "sinkconnect triggered on %s", GST_PAD_NAME (pad));
-
-  return GST_PAD_LINK_OK;
-}
-
-static void
-gst_ogg_mux_flush (GstOggMux * ogg_mux)
+static GstFlowReturn
+gst_ogg_mux_flush (GstAggregator * agg)
 {
-  GSList *walk;
+  GstOggMux *ogg_mux = GST_OGG_MUX (agg);
+  GList *walk;
 
-  for (walk = ogg_mux->collect->data; walk; walk = g_slist_next (walk)) {
-    GstOggPadData *pad;
+  GST_OBJECT_LOCK (ogg_mux);
+  for (walk = GST_ELEMENT_CAST (ogg_mux)->sinkpads; walk; walk = walk->next) {
+    GstOggMuxPad *pad;
 
-    pad = (GstOggPadData *) walk->data;
+    pad = GST_OGG_MUX_PAD (walk->data);
 
     gst_ogg_pad_data_reset (ogg_mux, pad);
   }
+  GST_OBJECT_UNLOCK (ogg_mux);
 
   gst_ogg_mux_clear (ogg_mux);
+
+  return GST_FLOW_OK;
 }
 
 static gboolean
-gst_ogg_mux_sink_event (GstCollectPads * pads, GstCollectData * pad,
-    GstEvent * event, gpointer user_data)
+gst_ogg_mux_sink_event (GstAggregator * agg, GstAggregatorPad * aggpad,
+    GstEvent * event)
 {
-  GstOggMux *ogg_mux = GST_OGG_MUX (user_data);
-  GstOggPadData *ogg_pad = (GstOggPadData *) pad;
+  GstOggMux *ogg_mux = GST_OGG_MUX (agg);
+  GstOggMuxPad *ogg_pad = GST_OGG_MUX_PAD (aggpad);
 
-  GST_DEBUG_OBJECT (pad->pad, "Got %s event", GST_EVENT_TYPE_NAME (event));
+  GST_DEBUG_OBJECT (aggpad, "Got %s event", GST_EVENT_TYPE_NAME (event));
 
   switch (GST_EVENT_TYPE (event)) {
     case GST_EVENT_SEGMENT:
@@ -313,16 +333,25 @@ gst_ogg_mux_sink_event (GstCollectPads * pads, GstCollectData * pad,
       /* We don't support non time NEWSEGMENT events */
       if (segment->format != GST_FORMAT_TIME) {
         gst_event_unref (event);
-        event = NULL;
-        break;
+        return TRUE;
       }
 
       gst_segment_copy_into (segment, &ogg_pad->segment);
       break;
     }
-    case GST_EVENT_FLUSH_STOP:{
-      /* only a single flush-stop is forwarded from collect pads */
-      gst_ogg_mux_flush (ogg_mux);
+    case GST_EVENT_CAPS:
+    {
+      GstCaps *caps;
+
+      /* a sparse stream with the headers in its caps does not need to send
+       * data before the other streams can be muxed */
+      if (ogg_pad->sparse && !ogg_pad->have_type) {
+        gst_event_parse_caps (event, &caps);
+        ogg_pad->have_type =
+            gst_ogg_stream_setup_map_from_caps_headers (&ogg_pad->map, caps);
+        if (ogg_pad->have_type && ogg_pad->map.is_sparse)
+          GST_DEBUG_OBJECT (aggpad, "sparse stream with headers in caps");
+      }
       break;
     }
     case GST_EVENT_TAG:{
@@ -341,35 +370,39 @@ gst_ogg_mux_sink_event (GstCollectPads * pads, GstCollectData * pad,
       break;
   }
 
-  /* now GstCollectPads can take care of the rest, e.g. EOS */
-  if (event != NULL)
-    return gst_collect_pads_event_default (pads, pad, event, FALSE);
-
-  return TRUE;
+  /* now GstAggregator can take care of the rest, e.g. EOS and flushing */
+  return GST_AGGREGATOR_CLASS (parent_class)->sink_event (agg, aggpad, event);
 }
 
 static gboolean
 gst_ogg_mux_is_serialno_present (GstOggMux * ogg_mux, guint32 serialno)
 {
-  GSList *walk;
+  GList *walk;
+  gboolean present = FALSE;
 
-  walk = ogg_mux->collect->data;
-  while (walk) {
-    GstOggPadData *pad = (GstOggPadData *) walk->data;
-    if (pad->map.serialno == serialno)
-      return TRUE;
-    walk = walk->next;
+  GST_OBJECT_LOCK (ogg_mux);
+  for (walk = GST_ELEMENT_CAST (ogg_mux)->sinkpads; walk; walk = walk->next) {
+    GstOggMuxPad *pad = GST_OGG_MUX_PAD (walk->data);
+
+    if (pad->map.serialno == serialno) {
+      present = TRUE;
+      break;
+    }
   }
+  GST_OBJECT_UNLOCK (ogg_mux);
 
-  return FALSE;
+  return present;
 }
 
 static void
-gst_ogg_pad_data_reset (GstOggMux * ogg_mux, GstOggPadData * oggpad)
+gst_ogg_pad_data_reset (GstOggMux * ogg_mux, GstOggMuxPad * oggpad)
 {
+  GstBuffer *buf;
+
   oggpad->packetno = 0;
   oggpad->pageno = 0;
   oggpad->eos = FALSE;
+  oggpad->eos_submitted = FALSE;
 
   /* we assume there will be some control data first for this pad */
   oggpad->state = GST_OGG_PAD_STATE_CONTROL;
@@ -384,17 +417,10 @@ gst_ogg_pad_data_reset (GstOggMux * ogg_mux, GstOggPadData * oggpad)
   ogg_stream_clear (&oggpad->map.stream);
   ogg_stream_init (&oggpad->map.stream, oggpad->map.serialno);
 
-  if (oggpad->pagebuffers) {
-    GstBuffer *buf;
-
-    while ((buf = g_queue_pop_head (oggpad->pagebuffers)) != NULL) {
-      gst_buffer_unref (buf);
-    }
-  } else if (GST_STATE (ogg_mux) > GST_STATE_READY) {
-    /* This will be initialized in init_collectpads when going from ready
-     * paused state */
-    oggpad->pagebuffers = g_queue_new ();
+  while ((buf = g_queue_pop_head (oggpad->pagebuffers)) != NULL) {
+    gst_buffer_unref (buf);
   }
+  gst_buffer_replace (&oggpad->buffer, NULL);
 
   gst_segment_init (&oggpad->segment, GST_FORMAT_TIME);
 }
@@ -411,12 +437,12 @@ gst_ogg_mux_generate_serialno (GstOggMux * ogg_mux)
   return serialno;
 }
 
-static GstPad *
-gst_ogg_mux_request_new_pad (GstElement * element,
+static GstAggregatorPad *
+gst_ogg_mux_create_new_pad (GstAggregator * agg,
     GstPadTemplate * templ, const gchar * req_name, const GstCaps * caps)
 {
   GstOggMux *ogg_mux;
-  GstPad *newpad;
+  GstOggMuxPad *oggpad;
   GstElementClass *klass;
 
   g_return_val_if_fail (templ != NULL, NULL);
@@ -424,10 +450,10 @@ gst_ogg_mux_request_new_pad (GstElement * element,
   if (templ->direction != GST_PAD_SINK)
     goto wrong_direction;
 
-  g_return_val_if_fail (GST_IS_OGG_MUX (element), NULL);
-  ogg_mux = GST_OGG_MUX (element);
+  g_return_val_if_fail (GST_IS_OGG_MUX (agg), NULL);
+  ogg_mux = GST_OGG_MUX (agg);
 
-  klass = GST_ELEMENT_GET_CLASS (element);
+  klass = GST_ELEMENT_GET_CLASS (agg);
 
   if (templ != gst_element_class_get_pad_template (klass, "video_%u") &&
       templ != gst_element_class_get_pad_template (klass, "audio_%u") &&
@@ -465,31 +491,19 @@ gst_ogg_mux_request_new_pad (GstElement * element,
             "subtitle_%u")) {
       name = g_strdup_printf ("subtitle_%u", serial);
     }
-    newpad = gst_pad_new_from_template (templ, name);
+    oggpad = g_object_new (GST_TYPE_OGG_MUX_PAD, "name", name, "direction",
+        templ->direction, "template", templ, NULL);
     g_free (name);
 
-    /* construct our own wrapper data structure for the pad to
-     * keep track of its status */
-    {
-      GstOggPadData *oggpad;
-
-      oggpad = (GstOggPadData *)
-          gst_collect_pads_add_pad (ogg_mux->collect, newpad,
-          sizeof (GstOggPadData), gst_ogg_mux_ogg_pad_destroy_notify, FALSE);
-      ogg_mux->active_pads++;
+    oggpad->map.serialno = serial;
+    gst_ogg_pad_data_reset (ogg_mux, oggpad);
 
-      oggpad->map.serialno = serial;
-      gst_ogg_pad_data_reset (ogg_mux, oggpad);
-    }
+    if (templ == gst_element_class_get_pad_template (klass, "subtitle_%u"))
+      oggpad->sparse = TRUE;
   }
 
-  /* setup some pad functions */
-  gst_pad_set_link_function (newpad, gst_ogg_mux_sinkconnect);
-
-  /* dd the pad to the element */
-  gst_element_add_pad (element, newpad);
-
-  return newpad;
+  /* the base class adds the pad to the element */
+  return GST_AGGREGATOR_PAD (oggpad);
 
   /* ERRORS */
 wrong_direction:
@@ -504,26 +518,11 @@ wrong_template:
   }
 }
 
-static void
-gst_ogg_mux_release_pad (GstElement * element, GstPad * pad)
-{
-  GstOggMux *ogg_mux;
-
-  ogg_mux = GST_OGG_MUX (gst_pad_get_parent (pad));
-
-  gst_collect_pads_remove_pad (ogg_mux->collect, pad);
-  gst_element_remove_pad (element, pad);
-
-  gst_object_unref (ogg_mux);
-}
-
 /* handle events */
 static gboolean
-gst_ogg_mux_handle_src_event (GstPad * pad, GstObject * parent,
-    GstEvent * event)
+gst_ogg_mux_src_event (GstAggregator * agg, GstEvent * event)
 {
-  gboolean res = FALSE;
-  GstOggMux *ogg_mux = GST_OGG_MUX (parent);
+  GstOggMux *ogg_mux = GST_OGG_MUX (agg);
 
   switch (GST_EVENT_TYPE (event)) {
     case GST_EVENT_SEEK:{
@@ -533,7 +532,7 @@ gst_ogg_mux_handle_src_event (GstPad * pad, GstObject * parent,
       if (!ogg_mux->need_headers && (flags & GST_SEEK_FLAG_FLUSH) != 0) {
         /* don't allow flushing seeks once we started */
         gst_event_unref (event);
-        event = NULL;
+        return FALSE;
       }
       break;
     }
@@ -541,10 +540,7 @@ gst_ogg_mux_handle_src_event (GstPad * pad, GstObject * parent,
       break;
   }
 
-  if (event != NULL)
-    res = gst_pad_event_default (pad, parent, event);
-
-  return res;
+  return GST_AGGREGATOR_CLASS (parent_class)->src_event (agg, event);
 }
 
 static GstBuffer *
@@ -573,7 +569,7 @@ gst_ogg_mux_buffer_from_page (GstOggMux * mux, ogg_page * page, gboolean delta)
 
 static GstFlowReturn
 gst_ogg_mux_push_buffer (GstOggMux * mux, GstBuffer * buffer,
-    GstOggPadData * oggpad)
+    GstOggMuxPad * oggpad)
 {
   /* fix up OFFSET and OFFSET_END again */
   GST_BUFFER_OFFSET (buffer) = mux->offset;
@@ -589,10 +585,19 @@ gst_ogg_mux_push_buffer (GstOggMux * mux, GstBuffer * buffer,
       mux->last_ts = run_time;
   }
 
-  GST_LOG_OBJECT (mux->srcpad, "pushing %p, last_ts=%" GST_TIME_FORMAT,
+  if (GST_CLOCK_TIME_IS_VALID (mux->last_ts)) {
+    GstAggregatorPad *srcpad =
+        GST_AGGREGATOR_PAD (GST_AGGREGATOR_SRC_PAD (mux));
+
+    GST_OBJECT_LOCK (mux);
+    srcpad->segment.position = mux->last_ts;
+    GST_OBJECT_UNLOCK (mux);
+  }
+
+  GST_LOG_OBJECT (mux, "pushing %p, last_ts=%" GST_TIME_FORMAT,
       buffer, GST_TIME_ARGS (mux->last_ts));
 
-  return gst_pad_push (mux->srcpad, buffer);
+  return gst_aggregator_finish_buffer (GST_AGGREGATOR (mux), buffer);
 }
 
 /* if all queues have at least one page, dequeue the page with the lowest
@@ -600,17 +605,22 @@ gst_ogg_mux_push_buffer (GstOggMux * mux, GstBuffer * buffer,
 static gboolean
 gst_ogg_mux_dequeue_page (GstOggMux * mux, GstFlowReturn * flowret)
 {
-  GSList *walk;
-  GstOggPadData *opad = NULL;   /* "oldest" pad */
+  GList *walk;
+  GstOggMuxPad *opad = NULL;    /* "oldest" pad */
   GstClockTime oldest = GST_CLOCK_TIME_NONE;
   GstBuffer *buf = NULL;
   gboolean ret = FALSE;
 
   *flowret = GST_FLOW_OK;
 
-  walk = mux->collect->data;
+  walk = mux->pads;
   while (walk) {
-    GstOggPadData *pad = (GstOggPadData *) walk->data;
+    GstOggMuxPad *pad = (GstOggMuxPad *) walk->data;
+
+    /* After a live timeout we output whatever is queued, streams that did
+     * not deliver data in time can't hold back the others. */
+    if (mux->timeout)
+      break;
 
     /* We need each queue to either be at EOS, or have one or more pages
      * available with a set granulepos (i.e. not -1), otherwise we don't have
@@ -618,11 +628,16 @@ gst_ogg_mux_dequeue_page (GstOggMux * mux, GstFlowReturn * flowret)
      * time ordering. */
     if (pad->pagebuffers->length == 0) {
       if (pad->eos) {
-        GST_LOG_OBJECT (pad->collect.pad,
-            "pad is EOS, skipping for dequeue decision");
+        GST_LOG_OBJECT (pad, "pad is EOS, skipping for dequeue decision");
+      } else if (pad->have_type && pad->map.is_sparse &&
+          pad->buffer == NULL &&
+          !gst_aggregator_pad_has_buffer (GST_AGGREGATOR_PAD (pad))) {
+        /* a sparse stream without any pending data has nothing that would
+         * have to go before the pages queued on the other streams */
+        GST_LOG_OBJECT (pad, "sparse pad is idle, skipping for dequeue "
+            "decision");
       } else {
-        GST_LOG_OBJECT (pad->collect.pad,
-            "no pages in this queue, can't dequeue");
+        GST_LOG_OBJECT (pad, "no pages in this queue, can't dequeue");
         return FALSE;
       }
     } else {
@@ -640,24 +655,23 @@ gst_ogg_mux_dequeue_page (GstOggMux * mux, GstFlowReturn * flowret)
         }
       }
       if (!valid) {
-        GST_LOG_OBJECT (pad->collect.pad,
-            "No page timestamps in queue, can't dequeue");
+        GST_LOG_OBJECT (pad, "No page timestamps in queue, can't dequeue");
         return FALSE;
       }
     }
 
-    walk = g_slist_next (walk);
+    walk = walk->next;
   }
 
-  walk = mux->collect->data;
+  walk = mux->pads;
   while (walk) {
-    GstOggPadData *pad = (GstOggPadData *) walk->data;
+    GstOggMuxPad *pad = (GstOggMuxPad *) walk->data;
 
     /* any page with a granulepos of -1 can be pushed immediately.
      * TODO: it CAN be, but it seems silly to do so? */
     buf = g_queue_peek_head (pad->pagebuffers);
     while (buf && GST_BUFFER_OFFSET_END (buf) == -1) {
-      GST_LOG_OBJECT (pad->collect.pad, "[gp        -1] pushing page");
+      GST_LOG_OBJECT (pad, "[gp        -1] pushing page");
       g_queue_pop_head (pad->pagebuffers);
       *flowret = gst_ogg_mux_push_buffer (mux, buf, pad);
       buf = g_queue_peek_head (pad->pagebuffers);
@@ -669,7 +683,7 @@ gst_ogg_mux_dequeue_page (GstOggMux * mux, GstFlowReturn * flowret)
       if (oldest == GST_CLOCK_TIME_NONE) {
         GST_LOG_OBJECT (mux, "no oldest yet, taking buffer %p from pad %"
             GST_PTR_FORMAT " with gp time %" GST_TIME_FORMAT,
-            buf, pad->collect.pad, GST_TIME_ARGS (GST_BUFFER_OFFSET (buf)));
+            buf, pad, GST_TIME_ARGS (GST_BUFFER_OFFSET (buf)));
         oldest = GST_BUFFER_OFFSET (buf);
         opad = pad;
       } else {
@@ -677,19 +691,19 @@ gst_ogg_mux_dequeue_page (GstOggMux * mux, GstFlowReturn * flowret)
         if (GST_BUFFER_OFFSET (buf) < oldest) {
           GST_LOG_OBJECT (mux, "older buffer %p, taking from pad %"
               GST_PTR_FORMAT " with gp time %" GST_TIME_FORMAT,
-              buf, pad->collect.pad, GST_TIME_ARGS (GST_BUFFER_OFFSET (buf)));
+              buf, pad, GST_TIME_ARGS (GST_BUFFER_OFFSET (buf)));
           oldest = GST_BUFFER_OFFSET (buf);
           opad = pad;
         }
       }
     }
-    walk = g_slist_next (walk);
+    walk = walk->next;
   }
 
   if (oldest != GST_CLOCK_TIME_NONE) {
     g_assert (opad);
     buf = g_queue_pop_head (opad->pagebuffers);
-    GST_LOG_OBJECT (opad->collect.pad,
+    GST_LOG_OBJECT (opad,
         GST_GP_FORMAT " pushing oldest page buffer %p (granulepos time %"
         GST_TIME_FORMAT ")", GST_BUFFER_OFFSET_END (buf), buf,
         GST_TIME_ARGS (GST_BUFFER_OFFSET (buf)));
@@ -714,7 +728,7 @@ gst_ogg_mux_dequeue_page (GstOggMux * mux, GstFlowReturn * flowret)
  * counting.
  */
 static GstFlowReturn
-gst_ogg_mux_pad_queue_page (GstOggMux * mux, GstOggPadData * pad,
+gst_ogg_mux_pad_queue_page (GstOggMux * mux, GstOggMuxPad * pad,
     ogg_page * page, gboolean delta)
 {
   GstFlowReturn ret;
@@ -730,7 +744,7 @@ gst_ogg_mux_pad_queue_page (GstOggMux * mux, GstOggPadData * pad,
   pad->timestamp = pad->timestamp_end;
 
   g_queue_push_tail (pad->pagebuffers, buffer);
-  GST_LOG_OBJECT (pad->collect.pad, GST_GP_FORMAT
+  GST_LOG_OBJECT (pad, GST_GP_FORMAT
       " queued buffer page %p (gp time %"
       GST_TIME_FORMAT ", timestamp %" GST_TIME_FORMAT
       "), %d page buffers queued", GST_GP_CAST (ogg_page_granulepos (page)),
@@ -756,8 +770,8 @@ gst_ogg_mux_pad_queue_page (GstOggMux * mux, GstOggPadData * pad,
  * of muxed pages
  */
 static gint
-gst_ogg_mux_compare_pads (GstOggMux * ogg_mux, GstOggPadData * first,
-    GstOggPadData * second)
+gst_ogg_mux_compare_pads (GstOggMux * ogg_mux, GstOggMuxPad * first,
+    GstOggMuxPad * second)
 {
   guint64 firsttime, secondtime;
 
@@ -798,7 +812,7 @@ gst_ogg_mux_compare_pads (GstOggMux * ogg_mux, GstOggPadData * first,
 }
 
 static GstBuffer *
-gst_ogg_mux_decorate_buffer (GstOggMux * ogg_mux, GstOggPadData * pad,
+gst_ogg_mux_decorate_buffer (GstOggMux * ogg_mux, GstOggMuxPad * pad,
     GstBuffer * buf)
 {
   GstClockTime time, end_time;
@@ -849,8 +863,7 @@ gst_ogg_mux_decorate_buffer (GstOggMux * ogg_mux, GstOggPadData * pad,
       diff = 2;
       goto resync;
     }
-    GST_WARNING_OBJECT (pad->collect.pad,
-        "failed to determine packet duration");
+    GST_WARNING_OBJECT (pad, "failed to determine packet duration");
     goto no_granule;
   }
 
@@ -862,7 +875,7 @@ gst_ogg_mux_decorate_buffer (GstOggMux * ogg_mux, GstOggPadData * pad,
 
     g_assert (!cmeta || cmeta->format == GST_FORMAT_DEFAULT);
     if (cmeta && cmeta->end && cmeta->end < duration) {
-      GST_DEBUG_OBJECT (pad->collect.pad,
+      GST_DEBUG_OBJECT (pad,
           "Clipping %" G_GUINT64_FORMAT " samples at the end", cmeta->end);
       duration -= cmeta->end;
       end_clip = FALSE;
@@ -877,15 +890,14 @@ gst_ogg_mux_decorate_buffer (GstOggMux * ogg_mux, GstOggPadData * pad,
     if (meta && meta->end) {
       if (meta->format == GST_FORMAT_DEFAULT) {
         if (meta->end > duration) {
-          GST_WARNING_OBJECT (pad->collect.pad,
+          GST_WARNING_OBJECT (pad,
               "Clip meta tries to clip more sample than exist in the buffer, clipping all");
           duration = 0;
         } else {
           duration -= meta->end;
         }
       } else {
-        GST_WARNING_OBJECT (pad->collect.pad,
-            "Unsupported format in clip meta");
+        GST_WARNING_OBJECT (pad, "Unsupported format in clip meta");
       }
     }
     if (end_time > pad->segment.stop
@@ -903,7 +915,7 @@ gst_ogg_mux_decorate_buffer (GstOggMux * ogg_mux, GstOggPadData * pad,
     }
   }
 
-  GST_LOG_OBJECT (pad->collect.pad, "buffer ts %" GST_TIME_FORMAT
+  GST_LOG_OBJECT (pad, "buffer ts %" GST_TIME_FORMAT
       ", duration %" GST_TIME_FORMAT ", granule duration %" G_GINT64_FORMAT,
       GST_TIME_ARGS (time), GST_TIME_ARGS (GST_BUFFER_DURATION (buf)),
       duration);
@@ -920,7 +932,7 @@ gst_ogg_mux_decorate_buffer (GstOggMux * ogg_mux, GstOggPadData * pad,
   limit = gst_ogg_stream_granule_to_time (&pad->map, 1) / 2;
   limit = MAX (limit, ogg_mux->max_tolerance);
 
-  GST_LOG_OBJECT (pad->collect.pad, "expected granule %" G_GINT64_FORMAT " == "
+  GST_LOG_OBJECT (pad, "expected granule %" G_GINT64_FORMAT " == "
       "time %" GST_TIME_FORMAT " --> ts diff %" GST_STIME_FORMAT
       " < tolerance %" GST_TIME_FORMAT " (?)",
       granule, GST_TIME_ARGS (next_time), GST_STIME_ARGS (diff),
@@ -931,7 +943,7 @@ resync:
   if (diff > limit || diff < -limit) {
     granule = gst_util_uint64_scale_round (time, pad->map.granulerate_n,
         GST_SECOND * pad->map.granulerate_d);
-    GST_DEBUG_OBJECT (pad->collect.pad,
+    GST_DEBUG_OBJECT (pad,
         "resyncing to determined granule %" G_GINT64_FORMAT, granule);
   }
 
@@ -952,7 +964,7 @@ resync:
       gst_ogg_stream_granule_to_granulepos (&pad->map, granule,
       pad->keyframe_granule);
 
-  GST_LOG_OBJECT (pad->collect.pad,
+  GST_LOG_OBJECT (pad,
       GST_GP_FORMAT " decorated buffer %p (granulepos time %" GST_TIME_FORMAT
       ")", GST_BUFFER_OFFSET_END (buf), buf,
       GST_TIME_ARGS (GST_BUFFER_OFFSET (buf)));
@@ -962,7 +974,7 @@ resync:
   /* ERRORS */
 no_granule:
   {
-    GST_DEBUG_OBJECT (pad->collect.pad, "could not determine granulepos, "
+    GST_DEBUG_OBJECT (pad, "could not determine granulepos, "
         "falling back to upstream provided metadata");
     return buf;
   }
@@ -982,35 +994,43 @@ no_granule:
  * NULL when no pad was usable. "best" means the buffer marked
  * with the lowest timestamp. If best->buffer == NULL then either
  * we're at EOS (popped = FALSE), or a buffer got dropped, so retry. */
-static GstOggPadData *
+static GstOggMuxPad *
 gst_ogg_mux_queue_pads (GstOggMux * ogg_mux, gboolean * popped)
 {
-  GstOggPadData *bestpad = NULL;
-  GSList *walk;
+  GstOggMuxPad *bestpad = NULL;
+  GList *walk;
 
   *popped = FALSE;
 
   /* try to make sure we have a buffer from each usable pad first */
-  walk = ogg_mux->collect->data;
+  walk = ogg_mux->pads;
   while (walk) {
-    GstOggPadData *pad;
-    GstCollectData *data;
+    GstOggMuxPad *pad;
 
-    data = (GstCollectData *) walk->data;
-    pad = (GstOggPadData *) data;
+    pad = (GstOggMuxPad *) walk->data;
 
-    walk = g_slist_next (walk);
+    walk = walk->next;
 
-    GST_LOG_OBJECT (data->pad, "looking at pad for buffer");
+    GST_LOG_OBJECT (pad, "looking at pad for buffer");
 
     /* try to get a new buffer for this pad if needed and possible */
     if (pad->buffer == NULL) {
       GstBuffer *buf;
 
-      buf = gst_collect_pads_pop (ogg_mux->collect, data);
-      GST_LOG_OBJECT (data->pad, "popped buffer %" GST_PTR_FORMAT, buf);
+      buf = gst_aggregator_pad_pop_buffer (GST_AGGREGATOR_PAD (pad));
+      GST_LOG_OBJECT (pad, "popped buffer %" GST_PTR_FORMAT, buf);
+
+      /* GAP events show up as empty gap buffers, they only tell us that
+       * this stream has nothing to contribute yet */
+      if (buf != NULL && GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_GAP) &&
+          gst_buffer_get_size (buf) == 0) {
+        GST_LOG_OBJECT (pad, "dropping gap buffer");
+        gst_buffer_unref (buf);
+        buf = NULL;
+        *popped = TRUE;
+      }
 
-      /* On EOS we get a NULL buffer */
+      /* On EOS or when no data is queued we get a NULL buffer */
       if (buf != NULL) {
         *popped = TRUE;
 
@@ -1037,8 +1057,8 @@ gst_ogg_mux_queue_pads (GstOggMux * ogg_mux, gboolean * popped)
              * to starting streams on the fly, and some streams (like VP8
              * at least) do not send headers packets, as other muxers don't
              * expect/need them. */
-            caps = gst_pad_get_current_caps (GST_PAD_CAST (data->pad));
-            GST_DEBUG_OBJECT (data->pad, "checking caps: %" GST_PTR_FORMAT,
+            caps = gst_pad_get_current_caps (GST_PAD_CAST (pad));
+            GST_DEBUG_OBJECT (pad, "checking caps: %" GST_PTR_FORMAT,
                 caps);
 
             pad->have_type =
@@ -1054,22 +1074,19 @@ gst_ogg_mux_queue_pads (GstOggMux * ogg_mux, gboolean * popped)
                   gst_ogg_stream_setup_map_from_caps (&pad->map, caps);
             }
             if (!pad->have_type) {
-              GST_ERROR_OBJECT (data->pad,
+              GST_ERROR_OBJECT (pad,
                   "mapper didn't recognise input stream " "(pad caps: %"
                   GST_PTR_FORMAT ")", caps);
             } else {
-              GST_DEBUG_OBJECT (data->pad, "caps detected: %" GST_PTR_FORMAT,
+              GST_DEBUG_OBJECT (pad, "caps detected: %" GST_PTR_FORMAT,
                   pad->map.caps);
 
-              if (pad->map.is_sparse) {
-                GST_DEBUG_OBJECT (data->pad, "Pad is sparse, marking as such");
-                gst_collect_pads_set_waiting (ogg_mux->collect,
-                    (GstCollectData *) pad, FALSE);
-              }
+              if (pad->map.is_sparse)
+                GST_DEBUG_OBJECT (pad, "Pad is sparse, not waiting for it");
 
               if (pad->map.is_video && ogg_mux->delta_pad == NULL) {
                 ogg_mux->delta_pad = pad;
-                GST_INFO_OBJECT (data->pad, "selected delta pad");
+                GST_INFO_OBJECT (pad, "selected delta pad");
               }
             }
             if (caps)
@@ -1099,7 +1116,7 @@ gst_ogg_mux_queue_pads (GstOggMux * ogg_mux, gboolean * popped)
             /* check if this type of stream allows generating granulepos
              * metadata here, if not, upstream will have to provide */
             if (gst_ogg_stream_granule_to_granulepos (&pad->map, 1, 1) < 0) {
-              GST_WARNING_OBJECT (data->pad, "can not generate metadata; "
+              GST_WARNING_OBJECT (pad, "can not generate metadata; "
                   "relying on upstream");
               /* disable metadata code path, otherwise not used anyway */
               pad->map.granulerate_n = 0;
@@ -1112,7 +1129,7 @@ gst_ogg_mux_queue_pads (GstOggMux * ogg_mux, gboolean * popped)
         if (G_LIKELY (buf)) {
           buf = gst_ogg_mux_decorate_buffer (ogg_mux, pad, buf);
           if (G_UNLIKELY (!buf))
-            GST_DEBUG_OBJECT (data->pad, "buffer clipped");
+            GST_DEBUG_OBJECT (pad, "buffer clipped");
         }
       }
 
@@ -1123,7 +1140,7 @@ gst_ogg_mux_queue_pads (GstOggMux * ogg_mux, gboolean * popped)
      * pull on. Our best pad can't be eos */
     if (pad->buffer && !pad->eos) {
       if (gst_ogg_mux_compare_pads (ogg_mux, bestpad, pad) > 0) {
-        GST_LOG_OBJECT (data->pad,
+        GST_LOG_OBJECT (pad,
             "new best pad, with buffer %" GST_PTR_FORMAT, pad->buffer);
 
         bestpad = pad;
@@ -1135,7 +1152,7 @@ gst_ogg_mux_queue_pads (GstOggMux * ogg_mux, gboolean * popped)
 }
 
 static GList *
-gst_ogg_mux_get_headers (GstOggPadData * pad)
+gst_ogg_mux_get_headers (GstOggMuxPad * pad)
 {
   GList *res = NULL;
   GstStructure *structure;
@@ -1144,7 +1161,7 @@ gst_ogg_mux_get_headers (GstOggPadData * pad)
   GstPad *thepad;
   GstBuffer *header;
 
-  thepad = pad->collect.pad;
+  thepad = GST_PAD (pad);
 
   GST_LOG_OBJECT (thepad, "getting headers");
 
@@ -1242,7 +1259,7 @@ gst_ogg_mux_create_header_packet_with_flags (ogg_packet * packet,
 }
 
 static void
-gst_ogg_mux_create_header_packet (ogg_packet * packet, GstOggPadData * pad)
+gst_ogg_mux_create_header_packet (ogg_packet * packet, GstOggMuxPad * pad)
 {
   gst_ogg_mux_create_header_packet_with_flags (packet, pad->packetno == 0, 0);
   packet->packetno = pad->packetno++;
@@ -1344,7 +1361,7 @@ gst_ogg_mux_add_fisbone_message_header_from_tags (GstOggMux * mux,
    guess based on the category, as role essentially is category.
    For now, leave this as is. */
 static const char *
-gst_ogg_mux_get_default_role (GstOggPadData * pad)
+gst_ogg_mux_get_default_role (GstOggMuxPad * pad)
 {
   const char *type = gst_ogg_stream_get_media_type (&pad->map);
   if (type) {
@@ -1360,7 +1377,7 @@ gst_ogg_mux_get_default_role (GstOggPadData * pad)
 
 static void
 gst_ogg_mux_make_fisbone (GstOggMux * mux, ogg_stream_state * os,
-    GstOggPadData * pad)
+    GstOggMuxPad * pad)
 {
   GstByteWriter bw;
   gboolean handled = TRUE;
@@ -1417,7 +1434,7 @@ gst_ogg_mux_make_fistail (GstOggMux * mux, ogg_stream_state * os)
 static GstFlowReturn
 gst_ogg_mux_send_headers (GstOggMux * mux)
 {
-  GSList *walk;
+  GList *walk;
   GList *hbufs, *hwalk;
   GstCaps *caps;
   GstFlowReturn ret;
@@ -1429,15 +1446,15 @@ gst_ogg_mux_send_headers (GstOggMux * mux)
 
   GST_LOG_OBJECT (mux, "collecting headers");
 
-  walk = mux->collect->data;
+  walk = mux->pads;
   while (walk) {
-    GstOggPadData *pad;
+    GstOggMuxPad *pad;
     GstPad *thepad;
 
-    pad = (GstOggPadData *) walk->data;
-    thepad = pad->collect.pad;
+    pad = (GstOggMuxPad *) walk->data;
+    thepad = GST_PAD (pad);
 
-    walk = g_slist_next (walk);
+    walk = walk->next;
 
     GST_LOG_OBJECT (mux, "looking at pad %s:%s", GST_DEBUG_PAD_NAME (thepad));
 
@@ -1450,9 +1467,9 @@ gst_ogg_mux_send_headers (GstOggMux * mux)
   }
 
   GST_LOG_OBJECT (mux, "creating BOS pages");
-  walk = mux->collect->data;
+  walk = mux->pads;
   while (walk) {
-    GstOggPadData *pad;
+    GstOggMuxPad *pad;
     GstBuffer *buf;
     ogg_packet packet;
     GstPad *thepad;
@@ -1461,8 +1478,8 @@ gst_ogg_mux_send_headers (GstOggMux * mux)
     GstCaps *caps;
     const gchar *mime_type = "";
 
-    pad = (GstOggPadData *) walk->data;
-    thepad = pad->collect.pad;
+    pad = (GstOggMuxPad *) walk->data;
+    thepad = GST_PAD (pad);
     walk = walk->next;
 
     pad->packetno = 0;
@@ -1541,13 +1558,13 @@ gst_ogg_mux_send_headers (GstOggMux * mux)
   }
 
   GST_LOG_OBJECT (mux, "creating next headers");
-  walk = mux->collect->data;
+  walk = mux->pads;
   while (walk) {
-    GstOggPadData *pad;
+    GstOggMuxPad *pad;
     GstPad *thepad;
 
-    pad = (GstOggPadData *) walk->data;
-    thepad = pad->collect.pad;
+    pad = (GstOggMuxPad *) walk->data;
+    thepad = GST_PAD (pad);
 
     walk = walk->next;
 
@@ -1624,7 +1641,7 @@ gst_ogg_mux_send_headers (GstOggMux * mux)
   /* FIXME: should prefer media type audio/ogg, video/ogg, etc. depending on
    * what we create, if acceptable downstream (instead of defaulting to
    * application/ogg because that's the first in the template caps) */
-  caps = gst_pad_get_allowed_caps (mux->srcpad);
+  caps = gst_pad_get_allowed_caps (GST_AGGREGATOR_SRC_PAD (mux));
   if (caps) {
     if (!gst_caps_is_fixed (caps))
       caps = gst_caps_fixate (caps);
@@ -1633,16 +1650,10 @@ gst_ogg_mux_send_headers (GstOggMux * mux)
     caps = gst_caps_new_empty_simple ("application/ogg");
 
   caps = gst_ogg_mux_set_header_on_caps (caps, hbufs);
-  gst_pad_set_caps (mux->srcpad, caps);
+  /* the base class sends stream-start and segment along with the caps */
+  gst_aggregator_set_src_caps (GST_AGGREGATOR (mux), caps);
   gst_caps_unref (caps);
 
-  /* Send segment event */
-  {
-    GstSegment segment;
-    gst_segment_init (&segment, GST_FORMAT_TIME);
-    gst_pad_push_event (mux->srcpad, gst_event_new_segment (&segment));
-  }
-
   /* and send the buffers */
   while (hbufs != NULL) {
     GstBuffer *buf = GST_BUFFER (hbufs->data);
@@ -1679,7 +1690,7 @@ gst_ogg_mux_send_headers (GstOggMux * mux)
  *    pads are at EOS)
  */
 static GstFlowReturn
-gst_ogg_mux_process_best_pad (GstOggMux * ogg_mux, GstOggPadData * best)
+gst_ogg_mux_process_best_pad (GstOggMux * ogg_mux, GstOggMuxPad * best)
 {
   GstFlowReturn ret = GST_FLOW_OK;
   gboolean delta_unit;
@@ -1688,17 +1699,20 @@ gst_ogg_mux_process_best_pad (GstOggMux * ogg_mux, GstOggPadData * best)
   GstBuffer *next_buf;
 
   GST_LOG_OBJECT (ogg_mux, "best pad %" GST_PTR_FORMAT
-      ", currently pulling from %" GST_PTR_FORMAT, best->collect.pad,
-      ogg_mux->pulling ? ogg_mux->pulling->collect.pad : NULL);
+      ", currently pulling from %" GST_PTR_FORMAT, best,
+      ogg_mux->pulling ? ogg_mux->pulling : NULL);
 
+  /* a pad without queued data is only EOS when the base class says so, after
+   * a live timeout the next buffer might simply not have arrived yet */
   if (ogg_mux->pulling) {
-    next_buf = gst_collect_pads_peek (ogg_mux->collect,
-        &ogg_mux->pulling->collect);
+    next_buf =
+        gst_aggregator_pad_peek_buffer (GST_AGGREGATOR_PAD (ogg_mux->pulling));
     if (next_buf) {
       ogg_mux->pulling->eos = FALSE;
       gst_buffer_unref (next_buf);
-    } else if (!ogg_mux->pulling->map.is_sparse) {
-      GST_DEBUG_OBJECT (ogg_mux->pulling->collect.pad, "setting eos to true");
+    } else if (!ogg_mux->pulling->map.is_sparse &&
+        gst_aggregator_pad_is_eos (GST_AGGREGATOR_PAD (ogg_mux->pulling))) {
+      GST_DEBUG_OBJECT (ogg_mux->pulling, "setting eos to true");
       ogg_mux->pulling->eos = TRUE;
     }
   }
@@ -1706,12 +1720,13 @@ gst_ogg_mux_process_best_pad (GstOggMux * ogg_mux, GstOggPadData * best)
   /* We could end up pushing from the best pad instead, so check that
    * as well */
   if (best && best != ogg_mux->pulling) {
-    next_buf = gst_collect_pads_peek (ogg_mux->collect, &best->collect);
+    next_buf = gst_aggregator_pad_peek_buffer (GST_AGGREGATOR_PAD (best));
     if (next_buf) {
       best->eos = FALSE;
       gst_buffer_unref (next_buf);
-    } else if (!best->map.is_sparse) {
-      GST_DEBUG_OBJECT (best->collect.pad, "setting eos to true");
+    } else if (!best->map.is_sparse &&
+        gst_aggregator_pad_is_eos (GST_AGGREGATOR_PAD (best))) {
+      GST_DEBUG_OBJECT (best, "setting eos to true");
       best->eos = TRUE;
     }
   }
@@ -1721,7 +1736,7 @@ gst_ogg_mux_process_best_pad (GstOggMux * ogg_mux, GstOggPadData * best)
    * for the pad we were pulling from before */
   if (ogg_mux->pulling && best &&
       ogg_mux->pulling != best && ogg_mux->pulling->buffer) {
-    GstOggPadData *pad = ogg_mux->pulling;
+    GstOggMuxPad *pad = ogg_mux->pulling;
     GstClockTime last_ts = GST_BUFFER_END_TIME (pad->buffer);
 
     /* if the next packet in the current page is going to make the page
@@ -1729,8 +1744,7 @@ gst_ogg_mux_process_best_pad (GstOggMux * ogg_mux, GstOggPadData * best)
     if (last_ts > ogg_mux->next_ts + ogg_mux->max_delay) {
       ogg_page page;
 
-      GST_LOG_OBJECT (pad->collect.pad,
-          GST_GP_FORMAT " stored packet %" G_GINT64_FORMAT
+      GST_LOG_OBJECT (pad, GST_GP_FORMAT " stored packet %" G_GINT64_FORMAT
           " will make page too long, flushing",
           GST_BUFFER_OFFSET_END (pad->buffer),
           (gint64) pad->map.stream.packetno);
@@ -1754,18 +1768,17 @@ gst_ogg_mux_process_best_pad (GstOggMux * ogg_mux, GstOggPadData * best)
   /* if we don't know which pad to pull on, use the best one */
   if (ogg_mux->pulling == NULL) {
     ogg_mux->pulling = best;
-    GST_LOG_OBJECT (ogg_mux->pulling->collect.pad, "pulling from best pad");
+    GST_LOG_OBJECT (ogg_mux->pulling, "pulling from best pad");
 
     /* remember timestamp and gp time of first buffer for this new pad */
     if (ogg_mux->pulling != NULL) {
       ogg_mux->next_ts = GST_BUFFER_TIMESTAMP (ogg_mux->pulling->buffer);
-      GST_LOG_OBJECT (ogg_mux->pulling->collect.pad, "updated times, next ts %"
+      GST_LOG_OBJECT (ogg_mux->pulling, "updated times, next ts %"
           GST_TIME_FORMAT, GST_TIME_ARGS (ogg_mux->next_ts));
     } else {
-      GST_LOG_OBJECT (ogg_mux->srcpad, "sending EOS");
-      /* no pad to pull on, send EOS */
-      gst_pad_push_event (ogg_mux->srcpad, gst_event_new_eos ());
-      return GST_FLOW_FLUSHING;
+      GST_LOG_OBJECT (ogg_mux, "no pad to pull on, EOS");
+      /* no pad to pull on, the base class sends EOS */
+      return GST_FLOW_EOS;
     }
   }
 
@@ -1780,12 +1793,12 @@ gst_ogg_mux_process_best_pad (GstOggMux * ogg_mux, GstOggPadData * best)
     ogg_packet packet;
     ogg_page page;
     GstBuffer *buf, *tmpbuf;
-    GstOggPadData *pad = ogg_mux->pulling;
+    GstOggMuxPad *pad = ogg_mux->pulling;
     gint64 duration;
     gboolean force_flush;
     GstMapInfo map;
 
-    GST_LOG_OBJECT (ogg_mux->pulling->collect.pad, "pulling from pad");
+    GST_LOG_OBJECT (ogg_mux->pulling, "pulling from pad");
 
     /* now see if we have a buffer */
     buf = pad->buffer;
@@ -1802,7 +1815,7 @@ gst_ogg_mux_process_best_pad (GstOggMux * ogg_mux, GstOggPadData * best)
      * first packet on the new page.  Update our pad's page timestamp */
     if (ogg_mux->pulling->timestamp == GST_CLOCK_TIME_NONE) {
       ogg_mux->pulling->timestamp = GST_BUFFER_TIMESTAMP (buf);
-      GST_LOG_OBJECT (ogg_mux->pulling->collect.pad,
+      GST_LOG_OBJECT (ogg_mux->pulling,
           "updated pad timestamp to %" GST_TIME_FORMAT,
           GST_TIME_ARGS (GST_BUFFER_TIMESTAMP (buf)));
     }
@@ -1816,7 +1829,7 @@ gst_ogg_mux_process_best_pad (GstOggMux * ogg_mux, GstOggPadData * best)
     /* mark BOS and packet number */
     packet.b_o_s = (pad->packetno == 0);
     packet.packetno = pad->packetno++;
-    GST_LOG_OBJECT (pad->collect.pad, GST_GP_FORMAT
+    GST_LOG_OBJECT (pad, GST_GP_FORMAT
         " packet %" G_GINT64_FORMAT " (%ld bytes) created from buffer",
         GST_GP_CAST (packet.granulepos), (gint64) packet.packetno,
         packet.bytes);
@@ -1838,19 +1851,19 @@ gst_ogg_mux_process_best_pad (GstOggMux * ogg_mux, GstOggPadData * best)
 
     if (GST_BUFFER_IS_DISCONT (buf)) {
       if (pad->data_pushed) {
-        GST_LOG_OBJECT (pad->collect.pad, "got discont");
+        GST_LOG_OBJECT (pad, "got discont");
         packet.packetno++;
         /* No public API for this; hack things in */
         pad->map.stream.pageno++;
         force_flush = TRUE;
       } else {
-        GST_LOG_OBJECT (pad->collect.pad, "discont at stream start");
+        GST_LOG_OBJECT (pad, "discont at stream start");
       }
     }
 
     /* flush the currently built page if necessary */
     if (force_flush) {
-      GST_LOG_OBJECT (pad->collect.pad,
+      GST_LOG_OBJECT (pad,
           GST_GP_FORMAT " forced flush of page before this packet",
           GST_BUFFER_OFFSET_END (pad->buffer));
       while (ogg_stream_flush (&pad->map.stream, &page)) {
@@ -1893,10 +1906,12 @@ gst_ogg_mux_process_best_pad (GstOggMux * ogg_mux, GstOggPadData * best)
     pad->prev_delta = delta_unit;
 
     /* swap the packet in */
-    if (packet.e_o_s == 1)
-      GST_DEBUG_OBJECT (pad->collect.pad, "swapping in EOS packet");
+    if (packet.e_o_s == 1) {
+      GST_DEBUG_OBJECT (pad, "swapping in EOS packet");
+      pad->eos_submitted = TRUE;
+    }
     if (packet.b_o_s == 1)
-      GST_DEBUG_OBJECT (pad->collect.pad, "swapping in BOS packet");
+      GST_DEBUG_OBJECT (pad, "swapping in BOS packet");
 
     ogg_stream_packetin (&pad->map.stream, &packet);
     gst_buffer_unmap (buf, &map);
@@ -1906,8 +1921,7 @@ gst_ogg_mux_process_best_pad (GstOggMux * ogg_mux, GstOggPadData * best)
     granulepos = GST_BUFFER_OFFSET_END (pad->buffer);
     timestamp = GST_BUFFER_TIMESTAMP (pad->buffer);
 
-    GST_LOG_OBJECT (pad->collect.pad,
-        GST_GP_FORMAT " packet %" G_GINT64_FORMAT ", gp time %"
+    GST_LOG_OBJECT (pad, GST_GP_FORMAT " packet %" G_GINT64_FORMAT ", gp time %"
         GST_TIME_FORMAT ", timestamp %" GST_TIME_FORMAT " packetin'd",
         granulepos, (gint64) packet.packetno, GST_TIME_ARGS (gp_time),
         GST_TIME_ARGS (timestamp));
@@ -1923,12 +1937,10 @@ gst_ogg_mux_process_best_pad (GstOggMux * ogg_mux, GstOggPadData * best)
        * if this fresh packet ends on this page, then the page's granulepos
        * comes from that packet, and we should set this buffer's timestamp */
 
-      GST_LOG_OBJECT (pad->collect.pad,
-          GST_GP_FORMAT " packet %" G_GINT64_FORMAT ", time %"
+      GST_LOG_OBJECT (pad, GST_GP_FORMAT " packet %" G_GINT64_FORMAT ", time %"
           GST_TIME_FORMAT ") caused new page",
           granulepos, (gint64) packet.packetno, GST_TIME_ARGS (timestamp));
-      GST_LOG_OBJECT (pad->collect.pad,
-          GST_GP_FORMAT " new page %ld",
+      GST_LOG_OBJECT (pad, GST_GP_FORMAT " new page %ld",
           GST_GP_CAST (ogg_page_granulepos (&page)), pad->map.stream.pageno);
 
       if (ogg_page_granulepos (&page) == granulepos) {
@@ -1936,14 +1948,12 @@ gst_ogg_mux_process_best_pad (GstOggMux * ogg_mux, GstOggPadData * best)
          * because the page's granulepos is the granulepos of the last
          * packet completed on that page,
          * so update the timestamp that we will give to the page */
-        GST_LOG_OBJECT (pad->collect.pad,
-            GST_GP_FORMAT
+        GST_LOG_OBJECT (pad, GST_GP_FORMAT
             " packet finishes on current page, updating gp time to %"
             GST_TIME_FORMAT, granulepos, GST_TIME_ARGS (gp_time));
         pad->gp_time = gp_time;
       } else {
-        GST_LOG_OBJECT (pad->collect.pad,
-            GST_GP_FORMAT
+        GST_LOG_OBJECT (pad, GST_GP_FORMAT
             " packet spans beyond current page, keeping old gp time %"
             GST_TIME_FORMAT, granulepos, GST_TIME_ARGS (pad->gp_time));
       }
@@ -1986,9 +1996,8 @@ gst_ogg_mux_process_best_pad (GstOggMux * ogg_mux, GstOggPadData * best)
      */
     if (pad->gp_time < gp_time) {
       pad->gp_time = gp_time;
-      GST_LOG_OBJECT (pad->collect.pad,
-          "Updated running gp time of pad %" GST_PTR_FORMAT
-          " to %" GST_TIME_FORMAT, pad->collect.pad, GST_TIME_ARGS (gp_time));
+      GST_LOG_OBJECT (pad, "Updated running gp time of pad %" GST_PTR_FORMAT
+          " to %" GST_TIME_FORMAT, pad, GST_TIME_ARGS (gp_time));
     }
   }
 
@@ -2002,40 +2011,223 @@ gst_ogg_mux_process_best_pad (GstOggMux * ogg_mux, GstOggPadData * best)
  * Returns TRUE if all pads are EOS.
  */
 static gboolean
-all_pads_eos (GstCollectPads * pads)
+all_pads_eos (GstOggMux * ogg_mux)
 {
-  GSList *walk;
+  GList *walk;
 
-  walk = pads->data;
+  walk = ogg_mux->pads;
   while (walk) {
-    GstOggPadData *oggpad = (GstOggPadData *) walk->data;
+    GstOggMuxPad *oggpad = (GstOggMuxPad *) walk->data;
 
-    GST_DEBUG_OBJECT (oggpad->collect.pad,
-        "oggpad %p eos %d", oggpad, oggpad->eos);
+    GST_DEBUG_OBJECT (oggpad, "oggpad %p eos %d", oggpad, oggpad->eos);
 
     if (!oggpad->eos)
       return FALSE;
 
-    walk = g_slist_next (walk);
+    walk = walk->next;
   }
 
   return TRUE;
 }
 
-static void
-gst_ogg_mux_send_start_events (GstOggMux * ogg_mux, GstCollectPads * pads)
+/* flush the page that is currently being filled on @pad, if any, and queue
+ * it for output */
+static GstFlowReturn
+gst_ogg_mux_pad_flush_page (GstOggMux * ogg_mux, GstOggMuxPad * pad)
+{
+  GstFlowReturn ret = GST_FLOW_OK;
+  ogg_page page;
+
+  while (ret == GST_FLOW_OK && ogg_stream_flush (&pad->map.stream, &page)) {
+    GST_LOG_OBJECT (pad, GST_GP_FORMAT " flushing unfinished page",
+        GST_GP_CAST (ogg_page_granulepos (&page)));
+
+    /* there is no next buffer yet, end the page at the gp time of its last
+     * complete packet */
+    pad->timestamp_end = pad->timestamp;
+    if (GST_CLOCK_TIME_IS_VALID (pad->gp_time) &&
+        pad->gp_time > pad->timestamp_end)
+      pad->timestamp_end = pad->gp_time;
+
+    ret = gst_ogg_mux_pad_queue_page (ogg_mux, pad, &page, pad->first_delta);
+    pad->pageno++;
+    pad->first_delta = TRUE;
+  }
+  pad->new_page = TRUE;
+  pad->duration = 0;
+
+  if (ogg_mux->pulling == pad)
+    ogg_mux->pulling = NULL;
+
+  return ret;
+}
+
+/* set the EOS flag on the serialized ogg page in @buffer */
+static GstBuffer *
+gst_ogg_mux_mark_page_eos (GstBuffer * buffer)
+{
+  GstMapInfo map;
+  ogg_page page;
+
+  buffer = gst_buffer_make_writable (buffer);
+  if (!gst_buffer_map (buffer, &map, GST_MAP_READWRITE))
+    return buffer;
+
+  if (map.size >= 27 && map.size >= 27 + map.data[26]) {
+    page.header = map.data;
+    page.header_len = 27 + map.data[26];
+    page.body = map.data + page.header_len;
+    page.body_len = map.size - page.header_len;
+
+    page.header[5] |= 0x04;
+    ogg_page_checksum_set (&page);
+  }
+  gst_buffer_unmap (buffer, &map);
+
+  return buffer;
+}
+
+/* A live stream can go EOS after its last packet was already written
+ * without the e_o_s flag because the next buffer was not there yet when
+ * the timeout hit. Terminate the logical stream properly by marking its
+ * last page as EOS, or by adding an empty EOS page if that page was pushed
+ * already. */
+static GstFlowReturn
+gst_ogg_mux_pad_finish_stream (GstOggMux * ogg_mux, GstOggMuxPad * pad)
+{
+  GstFlowReturn ret;
+  GstBuffer *last;
+
+  GST_DEBUG_OBJECT (pad, "terminating stream after EOS");
+
+  pad->eos = TRUE;
+  pad->eos_submitted = TRUE;
+
+  ret = gst_ogg_mux_pad_flush_page (ogg_mux, pad);
+  if (ret != GST_FLOW_OK)
+    return ret;
+
+  last = g_queue_pop_tail (pad->pagebuffers);
+  if (last != NULL) {
+    g_queue_push_tail (pad->pagebuffers, gst_ogg_mux_mark_page_eos (last));
+  } else {
+    guint8 header[27] = { 'O', 'g', 'g', 'S', 0, 0x04 };
+    ogg_page page;
+
+    GST_WRITE_UINT64_LE (header + 6, pad->map.stream.granulepos);
+    GST_WRITE_UINT32_LE (header + 14, pad->map.serialno);
+    GST_WRITE_UINT32_LE (header + 18, pad->map.stream.pageno);
+    pad->map.stream.pageno++;
+
+    page.header = header;
+    page.header_len = sizeof (header);
+    page.body = header + sizeof (header);
+    page.body_len = 0;
+    ogg_page_checksum_set (&page);
+
+    pad->timestamp_end = pad->timestamp;
+    ret = gst_ogg_mux_pad_queue_page (ogg_mux, pad, &page, pad->first_delta);
+    pad->pageno++;
+  }
+
+  return ret;
+}
+
+static GstFlowReturn
+gst_ogg_mux_finish_eos_pads (GstOggMux * ogg_mux)
+{
+  GstFlowReturn ret = GST_FLOW_OK;
+  GList *walk;
+
+  for (walk = ogg_mux->pads; walk && ret == GST_FLOW_OK; walk = walk->next) {
+    GstOggMuxPad *pad = (GstOggMuxPad *) walk->data;
+
+    if (pad->eos_submitted || pad->buffer != NULL ||
+        !gst_aggregator_pad_is_eos (GST_AGGREGATOR_PAD (pad)))
+      continue;
+
+    if (pad->data_pushed)
+      ret = gst_ogg_mux_pad_finish_stream (ogg_mux, pad);
+    else
+      pad->eos = TRUE;
+  }
+
+  return ret;
+}
+
+/* push out all pages that can be pushed */
+static GstFlowReturn
+gst_ogg_mux_drain (GstOggMux * ogg_mux)
+{
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  while (gst_ogg_mux_dequeue_page (ogg_mux, &ret)) {
+    if (ret != GST_FLOW_OK)
+      break;
+  }
+
+  return ret;
+}
+
+/* all BOS pages have to come first, so in live mode the headers can only be
+ * written once every stream delivered its first packet */
+static gboolean
+gst_ogg_mux_can_send_headers (GstOggMux * ogg_mux)
+{
+  GList *walk;
+
+  for (walk = ogg_mux->pads; walk; walk = walk->next) {
+    GstOggMuxPad *pad = (GstOggMuxPad *) walk->data;
+
+    if (pad->buffer == NULL && !pad->map.is_sparse &&
+        !gst_aggregator_pad_is_eos (GST_AGGREGATOR_PAD (pad)))
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
+/* Called after a live timeout: mux everything that arrived so far and push
+ * out all pages, including the ones that are not full yet, without waiting
+ * for streams that did not deliver data in time. */
+static GstFlowReturn
+gst_ogg_mux_aggregate_timeout (GstOggMux * ogg_mux)
 {
-  gchar s_id[32];
+  GstFlowReturn ret = GST_FLOW_OK;
+  GstOggMuxPad *best;
+  gboolean popped;
+  GList *walk;
 
-  /* stream-start (FIXME: create id based on input ids) and
-   * also do something with the group id */
-  g_snprintf (s_id, sizeof (s_id), "oggmux-%08x", g_random_int ());
-  gst_pad_push_event (ogg_mux->srcpad, gst_event_new_stream_start (s_id));
+  do {
+    best = gst_ogg_mux_queue_pads (ogg_mux, &popped);
+
+    if (ogg_mux->need_headers && !gst_ogg_mux_can_send_headers (ogg_mux)) {
+      GST_DEBUG_OBJECT (ogg_mux, "waiting for all streams before headers");
+      return GST_FLOW_OK;
+    }
+
+    if (best != NULL)
+      ret = gst_ogg_mux_process_best_pad (ogg_mux, best);
+  } while (ret == GST_FLOW_OK && (best != NULL || popped));
+
+  if (ret != GST_FLOW_OK || ogg_mux->need_headers)
+    return ret;
+
+  for (walk = ogg_mux->pads; walk && ret == GST_FLOW_OK; walk = walk->next) {
+    GstOggMuxPad *pad = (GstOggMuxPad *) walk->data;
+
+    if (pad->data_pushed && !pad->eos_submitted)
+      ret = gst_ogg_mux_pad_flush_page (ogg_mux, pad);
+  }
 
-  /* we'll send caps later, need to collect all headers first */
+  if (ret == GST_FLOW_OK)
+    ret = gst_ogg_mux_drain (ogg_mux);
+
+  return ret;
 }
 
-/* This function is called when there is data on all pads.
+/* This function is called when there is data on all pads, or in live
+ * mode when the deadline for the next output expired.
  *
  * It finds a pad to pull on, this is done by looking at the buffers
  * to decide which one to use, and using the 'oldest' one first. It then calls
@@ -2043,27 +2235,59 @@ gst_ogg_mux_send_start_events (GstOggMux * ogg_mux, GstCollectPads * pads)
  *
  * If all the pads have received EOS, it flushes out all data by continually
  * getting the best pad and calling gst_ogg_mux_process_best_pad() until they
- * are all empty, and then sends EOS.
+ * are all empty, and then returns EOS so the base class sends EOS.
  */
 static GstFlowReturn
-gst_ogg_mux_collected (GstCollectPads * pads, GstOggMux * ogg_mux)
+gst_ogg_mux_aggregate (GstAggregator * agg, gboolean timeout)
 {
-  GstOggPadData *best;
-  GstFlowReturn ret;
+  GstOggMux *ogg_mux = GST_OGG_MUX (agg);
+  GstOggMuxPad *best;
+  GstFlowReturn ret = GST_FLOW_OK;
   gboolean popped;
 
-  GST_LOG_OBJECT (ogg_mux, "collected");
-
-  if (ogg_mux->need_start_events) {
-    gst_ogg_mux_send_start_events (ogg_mux, pads);
-    ogg_mux->need_start_events = FALSE;
+  GST_LOG_OBJECT (ogg_mux, "aggregate, timeout %d", timeout);
+
+  GST_OBJECT_LOCK (ogg_mux);
+  ogg_mux->pads = g_list_copy_deep (GST_ELEMENT_CAST (ogg_mux)->sinkpads,
+      (GCopyFunc) gst_object_ref, NULL);
+  GST_OBJECT_UNLOCK (ogg_mux);
+
+  /* forget about pads that were released in the meantime */
+  if (ogg_mux->pulling && !g_list_find (ogg_mux->pads, ogg_mux->pulling))
+    ogg_mux->pulling = NULL;
+  if (ogg_mux->delta_pad && !g_list_find (ogg_mux->pads, ogg_mux->delta_pad))
+    ogg_mux->delta_pad = NULL;
+
+  ogg_mux->timeout = timeout;
+
+  if (timeout) {
+    ret = gst_ogg_mux_aggregate_timeout (ogg_mux);
+    if (ret == GST_FLOW_OK)
+      ret = gst_ogg_mux_finish_eos_pads (ogg_mux);
+
+    /* schedule the next deadline from what we output so far, at least one
+     * page delay from now to not spin when no data is coming */
+    GST_OBJECT_LOCK (ogg_mux);
+    if (GST_CLOCK_TIME_IS_VALID (ogg_mux->last_ts))
+      ogg_mux->next_time = MAX (ogg_mux->next_time, ogg_mux->last_ts);
+    ogg_mux->next_time += MAX (ogg_mux->max_page_delay, MIN_TIMEOUT_INTERVAL);
+    GST_OBJECT_UNLOCK (ogg_mux);
+
+    ogg_mux->timeout = FALSE;
+    if (ret == GST_FLOW_OK && all_pads_eos (ogg_mux))
+      goto eos;
+    goto done;
   }
 
   /* queue buffers on all pads; find a buffer with the lowest timestamp */
   best = gst_ogg_mux_queue_pads (ogg_mux, &popped);
 
+  /* pads that went EOS without an EOS packet need their stream terminated */
+  if ((ret = gst_ogg_mux_finish_eos_pads (ogg_mux)) != GST_FLOW_OK)
+    goto done;
+
   if (popped)
-    return GST_FLOW_OK;
+    goto done;
 
   if (best == NULL) {
     /* No data, assume EOS */
@@ -2071,31 +2295,53 @@ gst_ogg_mux_collected (GstCollectPads * pads, GstOggMux * ogg_mux)
   }
 
   /* This is not supposed to happen */
-  g_return_val_if_fail (best->buffer != NULL, GST_FLOW_ERROR);
+  if (G_UNLIKELY (best->buffer == NULL)) {
+    g_critical ("best pad %s:%s has no buffer", GST_DEBUG_PAD_NAME (best));
+    ret = GST_FLOW_ERROR;
+    goto done;
+  }
 
   ret = gst_ogg_mux_process_best_pad (ogg_mux, best);
 
-  if (best->eos && all_pads_eos (pads))
+  if (best->eos && all_pads_eos (ogg_mux))
     goto eos;
 
-  /* We might have used up a cached pad->buffer. If all streams
-   * have a buffer ready in collectpads, collectpads will block at
-   * next chain, and will never call collected again. So we make a
-   * last call to _queue_pads now, to ensure that collectpads can
-   * push to at least one pad (mostly for streams with a single
-   * logical stream). */
+  /* We might have used up a cached pad->buffer. If all streams have a
+   * buffer queued on their aggregator pad, upstream will block at the next
+   * chain and aggregate will not be called again. So we make a last call to
+   * _queue_pads now, to ensure that at least one pad can accept data again
+   * (mostly for streams with a single logical stream). */
   gst_ogg_mux_queue_pads (ogg_mux, &popped);
 
+done:
+  g_list_free_full (ogg_mux->pads, gst_object_unref);
+  ogg_mux->pads = NULL;
+
   return ret;
 
 eos:
   {
     GST_DEBUG_OBJECT (ogg_mux, "no data available, must be EOS");
-    gst_pad_push_event (ogg_mux->srcpad, gst_event_new_eos ());
+    gst_ogg_mux_drain (ogg_mux);
+    g_list_free_full (ogg_mux->pads, gst_object_unref);
+    ogg_mux->pads = NULL;
     return GST_FLOW_EOS;
   }
 }
 
+static GstClockTime
+gst_ogg_mux_get_next_time (GstAggregator * agg)
+{
+  GstOggMux *ogg_mux = GST_OGG_MUX (agg);
+  GstClockTime next_time;
+
+  GST_OBJECT_LOCK (ogg_mux);
+  next_time = ogg_mux->next_time;
+  GST_OBJECT_UNLOCK (ogg_mux);
+
+  return next_time;
+}
+
 static void
 gst_ogg_mux_get_property (GObject * object,
     guint prop_id, GValue * value, GParamSpec * pspec)
@@ -2137,6 +2383,7 @@ gst_ogg_mux_set_property (GObject * object,
       break;
     case ARG_MAX_PAGE_DELAY:
       ogg_mux->max_page_delay = g_value_get_uint64 (value);
+      gst_ogg_mux_update_latency (ogg_mux);
       break;
     case ARG_MAX_TOLERANCE:
       ogg_mux->max_tolerance = g_value_get_uint64 (value);
@@ -2151,42 +2398,35 @@ gst_ogg_mux_set_property (GObject * object,
 }
 
 /* reset all variables in the ogg pads. */
-static void
-gst_ogg_mux_init_collectpads (GstCollectPads * collect)
+static gboolean
+gst_ogg_mux_start (GstAggregator * agg)
 {
-  GSList *walk;
+  GstOggMux *ogg_mux = GST_OGG_MUX (agg);
+  GList *walk;
 
-  walk = collect->data;
-  while (walk) {
-    GstOggPadData *oggpad = (GstOggPadData *) walk->data;
-
-    ogg_stream_clear (&oggpad->map.stream);
-    ogg_stream_init (&oggpad->map.stream, oggpad->map.serialno);
-    oggpad->packetno = 0;
-    oggpad->pageno = 0;
-    oggpad->eos = FALSE;
-    /* we assume there will be some control data first for this pad */
-    oggpad->state = GST_OGG_PAD_STATE_CONTROL;
-    oggpad->new_page = TRUE;
-    oggpad->first_delta = FALSE;
-    oggpad->prev_delta = FALSE;
-    oggpad->data_pushed = FALSE;
-    oggpad->pagebuffers = g_queue_new ();
+  gst_ogg_mux_clear (ogg_mux);
 
-    gst_segment_init (&oggpad->segment, GST_FORMAT_TIME);
+  GST_OBJECT_LOCK (ogg_mux);
+  for (walk = GST_ELEMENT_CAST (ogg_mux)->sinkpads; walk; walk = walk->next) {
+    GstOggMuxPad *oggpad = GST_OGG_MUX_PAD (walk->data);
 
-    walk = g_slist_next (walk);
+    gst_ogg_pad_data_reset (ogg_mux, oggpad);
   }
+  GST_OBJECT_UNLOCK (ogg_mux);
+
+  return TRUE;
 }
 
-/* Clear all buffers from the collectpads object */
-static void
-gst_ogg_mux_clear_collectpads (GstCollectPads * collect)
+/* Clear all buffers from the sink pads */
+static gboolean
+gst_ogg_mux_stop (GstAggregator * agg)
 {
-  GSList *walk;
+  GstOggMux *ogg_mux = GST_OGG_MUX (agg);
+  GList *walk;
 
-  for (walk = collect->data; walk; walk = g_slist_next (walk)) {
-    GstOggPadData *oggpad = (GstOggPadData *) walk->data;
+  GST_OBJECT_LOCK (ogg_mux);
+  for (walk = GST_ELEMENT_CAST (ogg_mux)->sinkpads; walk; walk = walk->next) {
+    GstOggMuxPad *oggpad = GST_OGG_MUX_PAD (walk->data);
     GstBuffer *buf;
 
     ogg_stream_clear (&oggpad->map.stream);
@@ -2195,8 +2435,6 @@ gst_ogg_mux_clear_collectpads (GstCollectPads * collect)
       GST_LOG ("flushing buffer : %p", buf);
       gst_buffer_unref (buf);
     }
-    g_queue_free (oggpad->pagebuffers);
-    oggpad->pagebuffers = NULL;
 
     if (oggpad->buffer) {
       gst_buffer_unref (oggpad->buffer);
@@ -2210,48 +2448,11 @@ gst_ogg_mux_clear_collectpads (GstCollectPads * collect)
 
     gst_segment_init (&oggpad->segment, GST_FORMAT_TIME);
   }
-}
-
-static GstStateChangeReturn
-gst_ogg_mux_change_state (GstElement * element, GstStateChange transition)
-{
-  GstOggMux *ogg_mux;
-  GstStateChangeReturn ret;
-
-  ogg_mux = GST_OGG_MUX (element);
-
-  switch (transition) {
-    case GST_STATE_CHANGE_NULL_TO_READY:
-      break;
-    case GST_STATE_CHANGE_READY_TO_PAUSED:
-      gst_ogg_mux_clear (ogg_mux);
-      gst_ogg_mux_init_collectpads (ogg_mux->collect);
-      gst_collect_pads_start (ogg_mux->collect);
-      break;
-    case GST_STATE_CHANGE_PAUSED_TO_PLAYING:
-      break;
-    case GST_STATE_CHANGE_PAUSED_TO_READY:
-      gst_collect_pads_stop (ogg_mux->collect);
-      break;
-    default:
-      break;
-  }
+  GST_OBJECT_UNLOCK (ogg_mux);
 
-  ret = GST_ELEMENT_CLASS (parent_class)->change_state (element, transition);
-
-  switch (transition) {
-    case GST_STATE_CHANGE_PLAYING_TO_PAUSED:
-      break;
-    case GST_STATE_CHANGE_PAUSED_TO_READY:
-      gst_ogg_mux_clear_collectpads (ogg_mux->collect);
-      break;
-    case GST_STATE_CHANGE_READY_TO_NULL:
-      break;
-    default:
-      break;
-  }
+  gst_ogg_mux_clear (ogg_mux);
 
-  return ret;
+  return TRUE;
 }
 
 gboolean
@@ -24,7 +24,7 @@
 #include <ogg/ogg.h>
 
 #include <gst/gst.h>
-#include <gst/base/gstcollectpads.h>
+#include <gst/base/gstaggregator.h>
 #include "gstoggstream.h"
 
 G_BEGIN_DECLS
@@ -35,8 +35,14 @@ G_BEGIN_DECLS
 #define GST_IS_OGG_MUX(obj) (G_TYPE_CHECK_INSTANCE_TYPE((obj),GST_TYPE_OGG_MUX))
 #define GST_IS_OGG_MUX_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_OGG_MUX))
 
+#define GST_TYPE_OGG_MUX_PAD (gst_ogg_mux_pad_get_type())
+#define GST_OGG_MUX_PAD(obj) (G_TYPE_CHECK_INSTANCE_CAST((obj),GST_TYPE_OGG_MUX_PAD, GstOggMuxPad))
+#define GST_IS_OGG_MUX_PAD(obj) (G_TYPE_CHECK_INSTANCE_TYPE((obj),GST_TYPE_OGG_MUX_PAD))
+
 typedef struct _GstOggMux GstOggMux;
 typedef struct _GstOggMuxClass GstOggMuxClass;
+typedef struct _GstOggMuxPad GstOggMuxPad;
+typedef struct _GstOggMuxPadClass GstOggMuxPadClass;
 
 typedef enum
 {
@@ -46,9 +52,9 @@ typedef enum
 GstOggPadState;
 
 /* all information needed for one ogg stream */
-typedef struct
+struct _GstOggMuxPad
 {
-  GstCollectData collect;       /* we extend the CollectData */
+  GstAggregatorPad parent;
 
   GstOggStream map;
   gboolean have_type;
@@ -83,8 +89,17 @@ typedef struct
   gint64  keyframe_granule;     /* granule of last preceding keyframe */
 
   GstTagList *tags;
-}
-GstOggPadData;
+
+  gboolean eos_submitted;       /* whether a packet with e_o_s set went into
+                                   the stream */
+
+  gboolean sparse;              /* requested from the subtitle template */
+};
+
+struct _GstOggMuxPadClass
+{
+  GstAggregatorPadClass parent_class;
+};
 
 /**
  * GstOggMux:
@@ -93,19 +108,13 @@ GstOggPadData;
  */
 struct _GstOggMux
 {
-  GstElement element;
-
-  /* source pad */
-  GstPad *srcpad;
+  GstAggregator aggregator;
 
-  /* sinkpads */
-  GstCollectPads *collect;
-
-  /* number of pads which have not received EOS */
-  gint active_pads;
+  /* sinkpads, reffed snapshot taken for each aggregate call */
+  GList *pads;
 
   /* the pad we are currently using to fill a page */
-  GstOggPadData *pulling;
+  GstOggMuxPad *pulling;
 
   /* next timestamp for the page */
   GstClockTime next_ts;
@@ -118,13 +127,18 @@ struct _GstOggMux
 
   /* need_headers */
   gboolean need_headers;
-  gboolean need_start_events;
+
+  /* aggregating after a live timeout, pages are output without waiting for
+   * the other streams */
+  gboolean timeout;
+  /* running time of the next timeout deadline */
+  GstClockTime next_time;
 
   guint64 max_delay;
   guint64 max_page_delay;
   guint64 max_tolerance;
 
-  GstOggPadData *delta_pad;     /* when a delta frame is detected on a stream, we mark
+  GstOggMuxPad *delta_pad;     /* when a delta frame is detected on a stream, we mark
                                    pages as delta frames up to the page that has the
                                    keyframe */
 
@@ -135,10 +149,11 @@ struct _GstOggMux
 
 struct _GstOggMuxClass
 {
-  GstElementClass parent_class;
+  GstAggregatorClass parent_class;
 };
 
 GType gst_ogg_mux_get_type (void);
+GType gst_ogg_mux_pad_get_type (void);
 
 gboolean gst_ogg_mux_plugin_init (GstPlugin * plugin);
 
@@ -107,6 +107,10 @@ static void gst_opus_dec_get_property (GObject * object, guint prop_id,
 static void gst_opus_dec_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec);
 static GstCaps *gst_opus_dec_getcaps (GstAudioDecoder * dec, GstCaps * filter);
+static GstFlowReturn gst_opus_dec_pre_push (GstAudioDecoder * dec,
+    GstBuffer ** buffer);
+static GstFlowReturn gst_opus_dec_chain_list (GstPad * pad, GstObject * parent,
+    GstBufferList * list);
 
 
 static void
@@ -128,6 +132,7 @@ gst_opus_dec_class_init (GstOpusDecClass * klass)
   adclass->handle_frame = GST_DEBUG_FUNCPTR (gst_opus_dec_handle_frame);
   adclass->set_format = GST_DEBUG_FUNCPTR (gst_opus_dec_set_format);
   adclass->getcaps = GST_DEBUG_FUNCPTR (gst_opus_dec_getcaps);
+  adclass->pre_push = GST_DEBUG_FUNCPTR (gst_opus_dec_pre_push);
 
   gst_element_class_add_static_pad_template (element_class,
       &opus_dec_src_factory);
@@ -194,6 +199,11 @@ gst_opus_dec_init (GstOpusDec * dec)
       (dec), TRUE);
   GST_PAD_SET_ACCEPT_TEMPLATE (GST_AUDIO_DECODER_SINK_PAD (dec));
 
+  /* packets received together are decoded in one go and the decoded audio
+   * is pushed downstream as one list as well */
+  gst_pad_set_chain_list_function (GST_AUDIO_DECODER_SINK_PAD (dec),
+      GST_DEBUG_FUNCPTR (gst_opus_dec_chain_list));
+
   gst_opus_dec_reset (dec);
 }
 
@@ -878,6 +888,21 @@ memcmp_buffers (GstBuffer * buf1, GstBuffer * buf2)
   return res;
 }
 
+static GstFlowReturn
+gst_opus_dec_push_output_list (GstOpusDec * dec)
+{
+  GstBufferList *list = dec->output_list;
+
+  if (!list || gst_buffer_list_length (list) == 0)
+    return GST_FLOW_OK;
+
+  GST_LOG_OBJECT (dec, "pushing list of %u buffers",
+      gst_buffer_list_length (list));
+  dec->output_list = gst_buffer_list_new ();
+
+  return gst_pad_push_list (GST_AUDIO_DECODER_SRC_PAD (dec), list);
+}
+
 static GstFlowReturn
 gst_opus_dec_handle_frame (GstAudioDecoder * adec, GstBuffer * buf)
 {
@@ -915,7 +940,11 @@ gst_opus_dec_handle_frame (GstAudioDecoder * adec, GstBuffer * buf)
       case 0:
         if (gst_opus_header_is_header (buf, "OpusHead", 8)) {
           GST_DEBUG_OBJECT (dec, "found streamheader");
-          res = gst_opus_dec_parse_header (dec, buf);
+          /* the caps resulting from the header must not overtake the audio
+           * decoded so far */
+          res = gst_opus_dec_push_output_list (dec);
+          if (res == GST_FLOW_OK)
+            res = gst_opus_dec_parse_header (dec, buf);
           gst_audio_decoder_finish_frame (adec, NULL, 1);
         } else {
           res = opus_dec_chain_parse_data (dec, buf);
@@ -924,7 +953,9 @@ gst_opus_dec_handle_frame (GstAudioDecoder * adec, GstBuffer * buf)
       case 1:
         if (gst_opus_header_is_header (buf, "OpusTags", 8)) {
           GST_DEBUG_OBJECT (dec, "counted vorbiscomments");
-          res = gst_opus_dec_parse_comments (dec, buf);
+          res = gst_opus_dec_push_output_list (dec);
+          if (res == GST_FLOW_OK)
+            res = gst_opus_dec_parse_comments (dec, buf);
           gst_audio_decoder_finish_frame (adec, NULL, 1);
         } else {
           res = opus_dec_chain_parse_data (dec, buf);
@@ -943,6 +974,48 @@ gst_opus_dec_handle_frame (GstAudioDecoder * adec, GstBuffer * buf)
   return res;
 }
 
+static GstFlowReturn
+gst_opus_dec_pre_push (GstAudioDecoder * adec, GstBuffer ** buffer)
+{
+  GstOpusDec *dec = GST_OPUS_DEC (adec);
+
+  if (dec->output_list) {
+    gst_buffer_list_add (dec->output_list, *buffer);
+    *buffer = NULL;
+  }
+
+  return GST_FLOW_OK;
+}
+
+static GstFlowReturn
+gst_opus_dec_chain_list (GstPad * pad, GstObject * parent,
+    GstBufferList * list)
+{
+  GstOpusDec *dec = GST_OPUS_DEC (parent);
+  GstPadChainFunction chain = GST_PAD_CHAINFUNC (pad);
+  GstFlowReturn ret = GST_FLOW_OK, push_ret;
+  guint i, len;
+
+  len = gst_buffer_list_length (list);
+  GST_LOG_OBJECT (dec, "decoding list of %u buffers", len);
+
+  /* decode everything through the base class as usual, the decoded buffers
+   * are collected in pre_push instead of being pushed one by one */
+  dec->output_list = gst_buffer_list_new_sized (len);
+  for (i = 0; i < len && ret == GST_FLOW_OK; i++)
+    ret = chain (pad, parent, gst_buffer_ref (gst_buffer_list_get (list, i)));
+
+  GST_AUDIO_DECODER_STREAM_LOCK (dec);
+  push_ret = gst_opus_dec_push_output_list (dec);
+  gst_buffer_list_unref (dec->output_list);
+  dec->output_list = NULL;
+  GST_AUDIO_DECODER_STREAM_UNLOCK (dec);
+
+  gst_buffer_list_unref (list);
+
+  return ret == GST_FLOW_OK ? push_ret : ret;
+}
+
 static void
 gst_opus_dec_get_property (GObject * object, guint prop_id, GValue * value,
     GParamSpec * pspec)
@@ -77,6 +77,9 @@ struct _GstOpusDec {
   GstClockTime last_known_buffer_duration;
 
   gboolean phase_inversion;
+
+  /* output of the buffer list being decoded, pushed as one list */
+  GstBufferList *output_list;
 };
 
 struct _GstOpusDecClass {
@@ -197,6 +197,7 @@ static GstStaticPadTemplate src_factory = GST_STATIC_PAD_TEMPLATE ("src",
 #define DEFAULT_DTX             FALSE
 #define DEFAULT_PACKET_LOSS_PERCENT 0
 #define DEFAULT_MAX_PAYLOAD_SIZE 4000
+#define DEFAULT_BATCH_FRAMES    1
 
 enum
 {
@@ -210,7 +211,8 @@ enum
   PROP_INBAND_FEC,
   PROP_DTX,
   PROP_PACKET_LOSS_PERCENT,
-  PROP_MAX_PAYLOAD_SIZE
+  PROP_MAX_PAYLOAD_SIZE,
+  PROP_BATCH_FRAMES
 };
 
 static void gst_opus_enc_finalize (GObject * object);
@@ -233,6 +235,8 @@ static gboolean gst_opus_enc_set_format (GstAudioEncoder * benc,
     GstAudioInfo * info);
 static GstFlowReturn gst_opus_enc_handle_frame (GstAudioEncoder * benc,
     GstBuffer * buf);
+static GstFlowReturn gst_opus_enc_pre_push (GstAudioEncoder * benc,
+    GstBuffer ** buffer);
 static gint64 gst_opus_enc_get_latency (GstOpusEnc * enc);
 
 static GstFlowReturn gst_opus_enc_encode (GstOpusEnc * enc, GstBuffer * buffer);
@@ -283,6 +287,7 @@ gst_opus_enc_class_init (GstOpusEncClass * klass)
   base_class->stop = GST_DEBUG_FUNCPTR (gst_opus_enc_stop);
   base_class->set_format = GST_DEBUG_FUNCPTR (gst_opus_enc_set_format);
   base_class->handle_frame = GST_DEBUG_FUNCPTR (gst_opus_enc_handle_frame);
+  base_class->pre_push = GST_DEBUG_FUNCPTR (gst_opus_enc_pre_push);
   base_class->sink_event = GST_DEBUG_FUNCPTR (gst_opus_enc_sink_event);
   base_class->getcaps = GST_DEBUG_FUNCPTR (gst_opus_enc_sink_getcaps);
 
@@ -339,6 +344,24 @@ gst_opus_enc_class_init (GstOpusEncClass * klass)
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
           GST_PARAM_MUTABLE_PLAYING));
 
+  /**
+   * GstOpusEnc:batch-frames:
+   *
+   * Maximum number of frames to encode from the input at once. When more
+   * than one frame worth of audio is available, the resulting packets are
+   * pushed downstream together as a single #GstBufferList. This does not
+   * add any latency, as the encoder never waits for more input to fill a
+   * batch.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_BATCH_FRAMES,
+      g_param_spec_uint ("batch-frames", "Batch frames",
+          "Maximum number of frames encoded at once and pushed as a buffer "
+          "list", 1, G_MAXINT, DEFAULT_BATCH_FRAMES,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_PLAYING));
+
   gobject_class->finalize = GST_DEBUG_FUNCPTR (gst_opus_enc_finalize);
 
   GST_DEBUG_CATEGORY_INIT (opusenc_debug, "opusenc", 0, "Opus encoder");
@@ -379,6 +402,7 @@ gst_opus_enc_init (GstOpusEnc * enc)
   enc->dtx = DEFAULT_DTX;
   enc->packet_loss_percentage = DEFAULT_PACKET_LOSS_PERCENT;
   enc->max_payload_size = DEFAULT_MAX_PAYLOAD_SIZE;
+  enc->batch_frames = DEFAULT_BATCH_FRAMES;
   enc->audio_type = DEFAULT_AUDIO_TYPE;
 }
 
@@ -425,7 +449,7 @@ gst_opus_enc_setup_base_class (GstOpusEnc * enc, GstAudioEncoder * benc)
       gst_opus_enc_get_latency (enc), gst_opus_enc_get_latency (enc));
   gst_audio_encoder_set_frame_samples_min (benc, enc->frame_samples);
   gst_audio_encoder_set_frame_samples_max (benc, enc->frame_samples);
-  gst_audio_encoder_set_frame_max (benc, 1);
+  gst_audio_encoder_set_frame_max (benc, enc->batch_frames);
 }
 
 static gint
@@ -1082,17 +1106,66 @@ gst_opus_enc_handle_frame (GstAudioEncoder * benc, GstBuffer * buf)
 {
   GstOpusEnc *enc;
   GstFlowReturn ret = GST_FLOW_OK;
+  GstBufferList *list;
+  gsize bytes = 0, size = 0, offset;
 
   enc = GST_OPUS_ENC (benc);
   GST_DEBUG_OBJECT (enc, "handle_frame");
   GST_DEBUG_OBJECT (enc, "received buffer %p of %" G_GSIZE_FORMAT " bytes", buf,
       buf ? gst_buffer_get_size (buf) : 0);
 
-  ret = gst_opus_enc_encode (enc, buf);
+  if (buf) {
+    g_mutex_lock (&enc->property_lock);
+    bytes = enc->frame_samples * enc->n_channels * 2;
+    g_mutex_unlock (&enc->property_lock);
+
+    size = gst_buffer_get_size (buf);
+  }
+
+  /* a single frame, or draining */
+  if (size <= bytes)
+    return gst_opus_enc_encode (enc, buf);
+
+  /* several frames, encode them one by one and collect the resulting
+   * packets in pre_push, to push them together once all are done */
+  GST_LOG_OBJECT (enc, "encoding %" G_GSIZE_FORMAT " frames at once",
+      (size + bytes - 1) / bytes);
+  enc->output_list = gst_buffer_list_new_sized ((size + bytes - 1) / bytes);
+
+  for (offset = 0; offset < size && ret == GST_FLOW_OK; offset += bytes) {
+    GstBuffer *frame;
+
+    frame = gst_buffer_copy_region (buf, GST_BUFFER_COPY_MEMORY, offset,
+        MIN (bytes, size - offset));
+    ret = gst_opus_enc_encode (enc, frame);
+    gst_buffer_unref (frame);
+  }
+
+  list = enc->output_list;
+  enc->output_list = NULL;
+
+  if (ret == GST_FLOW_OK && gst_buffer_list_length (list) > 0) {
+    ret = gst_pad_push_list (GST_AUDIO_ENCODER_SRC_PAD (enc), list);
+  } else {
+    gst_buffer_list_unref (list);
+  }
 
   return ret;
 }
 
+static GstFlowReturn
+gst_opus_enc_pre_push (GstAudioEncoder * benc, GstBuffer ** buffer)
+{
+  GstOpusEnc *enc = GST_OPUS_ENC (benc);
+
+  if (enc->output_list) {
+    gst_buffer_list_add (enc->output_list, *buffer);
+    *buffer = NULL;
+  }
+
+  return GST_FLOW_OK;
+}
+
 static void
 gst_opus_enc_get_property (GObject * object, guint prop_id, GValue * value,
     GParamSpec * pspec)
@@ -1134,6 +1207,9 @@ gst_opus_enc_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_MAX_PAYLOAD_SIZE:
       g_value_set_uint (value, enc->max_payload_size);
       break;
+    case PROP_BATCH_FRAMES:
+      g_value_set_uint (value, enc->batch_frames);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1206,6 +1282,13 @@ gst_opus_enc_set_property (GObject * object, guint prop_id,
       enc->max_payload_size = g_value_get_uint (value);
       g_mutex_unlock (&enc->property_lock);
       break;
+    case PROP_BATCH_FRAMES:
+      g_mutex_lock (&enc->property_lock);
+      enc->batch_frames = g_value_get_uint (value);
+      gst_audio_encoder_set_frame_max (GST_AUDIO_ENCODER (enc),
+          enc->batch_frames);
+      g_mutex_unlock (&enc->property_lock);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -74,6 +74,7 @@ struct _GstOpusEnc {
   gboolean              dtx;
   gint                  packet_loss_percentage;
   guint                 max_payload_size;
+  guint                 batch_frames;
 
   gint                  frame_samples;
   gint                  n_channels;
@@ -87,6 +88,9 @@ struct _GstOpusEnc {
   guint8                encoding_channel_mapping[256];
   guint8                decoding_channel_mapping[256];
   guint8                n_stereo_streams;
+
+  /* packets encoded from the current input chunk, pushed as one list */
+  GstBufferList        *output_list;
 };
 
 struct _GstOpusEncClass {
@@ -516,3 +516,254 @@ gst_audio_format_fill_silence (const GstAudioFormatInfo * info,
     }
   }
 }
+
+/* Interleaving is a transpose of a channels x frames matrix. Doing one
+ * strided pass over the whole interleaved buffer per channel touches every
+ * cache line of it once per channel, so instead the frames are processed in
+ * blocks that keep the interleaved side in the cache and 4 channels are
+ * moved together. */
+#define INTERLEAVE_BLOCK_FRAMES 64
+
+#define MAKE_INTERLEAVE_FUNC(type)                                      \
+static void                                                             \
+interleave_##type (type * dest, const gpointer src[], gint channels,    \
+    gsize frames)                                                       \
+{                                                                       \
+  gsize f, b, n;                                                        \
+  gint c;                                                               \
+                                                                        \
+  for (b = 0; b < frames; b += INTERLEAVE_BLOCK_FRAMES) {               \
+    n = MIN (INTERLEAVE_BLOCK_FRAMES, frames - b);                      \
+    c = 0;                                                              \
+    while (c < channels) {                                              \
+      type *d = dest + b * channels + c;                                \
+                                                                        \
+      if (c + 4 <= channels && src[c] && src[c + 1] && src[c + 2]       \
+          && src[c + 3]) {                                              \
+        const type *s0 = (const type *) src[c] + b;                     \
+        const type *s1 = (const type *) src[c + 1] + b;                 \
+        const type *s2 = (const type *) src[c + 2] + b;                 \
+        const type *s3 = (const type *) src[c + 3] + b;                 \
+                                                                        \
+        for (f = 0; f < n; f++) {                                       \
+          d[0] = s0[f];                                                 \
+          d[1] = s1[f];                                                 \
+          d[2] = s2[f];                                                 \
+          d[3] = s3[f];                                                 \
+          d += channels;                                                \
+        }                                                               \
+        c += 4;                                                         \
+      } else {                                                          \
+        if (src[c]) {                                                   \
+          const type *s0 = (const type *) src[c] + b;                   \
+                                                                        \
+          for (f = 0; f < n; f++) {                                     \
+            *d = s0[f];                                                 \
+            d += channels;                                              \
+          }                                                             \
+        }                                                               \
+        c++;                                                            \
+      }                                                                 \
+    }                                                                   \
+  }                                                                     \
+}
+
+#define MAKE_DEINTERLEAVE_FUNC(type)                                    \
+static void                                                             \
+deinterleave_##type (gpointer dest[], const type * src, gint channels,  \
+    gsize frames)                                                       \
+{                                                                       \
+  gsize f, b, n;                                                        \
+  gint c;                                                               \
+                                                                        \
+  for (b = 0; b < frames; b += INTERLEAVE_BLOCK_FRAMES) {               \
+    n = MIN (INTERLEAVE_BLOCK_FRAMES, frames - b);                      \
+    c = 0;                                                              \
+    while (c < channels) {                                              \
+      const type *s = src + b * channels + c;                           \
+                                                                        \
+      if (c + 4 <= channels && dest[c] && dest[c + 1] && dest[c + 2]    \
+          && dest[c + 3]) {                                             \
+        type *d0 = (type *) dest[c] + b;                                \
+        type *d1 = (type *) dest[c + 1] + b;                            \
+        type *d2 = (type *) dest[c + 2] + b;                            \
+        type *d3 = (type *) dest[c + 3] + b;                            \
+                                                                        \
+        for (f = 0; f < n; f++) {                                       \
+          d0[f] = s[0];                                                 \
+          d1[f] = s[1];                                                 \
+          d2[f] = s[2];                                                 \
+          d3[f] = s[3];                                                 \
+          s += channels;                                                \
+        }                                                               \
+        c += 4;                                                         \
+      } else {                                                          \
+        if (dest[c]) {                                                  \
+          type *d0 = (type *) dest[c] + b;                              \
+                                                                        \
+          for (f = 0; f < n; f++) {                                     \
+            d0[f] = *s;                                                 \
+            s += channels;                                              \
+          }                                                             \
+        }                                                               \
+        c++;                                                            \
+      }                                                                 \
+    }                                                                   \
+  }                                                                     \
+}
+
+MAKE_INTERLEAVE_FUNC (guint8);
+MAKE_INTERLEAVE_FUNC (guint16);
+MAKE_INTERLEAVE_FUNC (guint32);
+MAKE_INTERLEAVE_FUNC (guint64);
+MAKE_DEINTERLEAVE_FUNC (guint8);
+MAKE_DEINTERLEAVE_FUNC (guint16);
+MAKE_DEINTERLEAVE_FUNC (guint32);
+MAKE_DEINTERLEAVE_FUNC (guint64);
+
+static void
+interleave_24 (guint8 * dest, const gpointer src[], gint channels,
+    gsize frames)
+{
+  gsize f, b, n;
+  gint c;
+
+  for (b = 0; b < frames; b += INTERLEAVE_BLOCK_FRAMES) {
+    n = MIN (INTERLEAVE_BLOCK_FRAMES, frames - b);
+    for (c = 0; c < channels; c++) {
+      const guint8 *s;
+      guint8 *d;
+
+      if (src[c] == NULL)
+        continue;
+
+      s = (const guint8 *) src[c] + b * 3;
+      d = dest + (b * channels + c) * 3;
+      for (f = 0; f < n; f++) {
+        d[0] = s[0];
+        d[1] = s[1];
+        d[2] = s[2];
+        s += 3;
+        d += channels * 3;
+      }
+    }
+  }
+}
+
+static void
+deinterleave_24 (gpointer dest[], const guint8 * src, gint channels,
+    gsize frames)
+{
+  gsize f, b, n;
+  gint c;
+
+  for (b = 0; b < frames; b += INTERLEAVE_BLOCK_FRAMES) {
+    n = MIN (INTERLEAVE_BLOCK_FRAMES, frames - b);
+    for (c = 0; c < channels; c++) {
+      const guint8 *s;
+      guint8 *d;
+
+      if (dest[c] == NULL)
+        continue;
+
+      s = src + (b * channels + c) * 3;
+      d = (guint8 *) dest[c] + b * 3;
+      for (f = 0; f < n; f++) {
+        d[0] = s[0];
+        d[1] = s[1];
+        d[2] = s[2];
+        s += channels * 3;
+        d += 3;
+      }
+    }
+  }
+}
+
+/**
+ * gst_audio_format_interleave:
+ * @info: a #GstAudioFormatInfo
+ * @dest: (element-type guint8): destination for @frames interleaved frames
+ *   of @channels channels
+ * @src: (array length=channels) (element-type gpointer): for each channel,
+ *   @frames samples of that channel or %NULL
+ * @channels: the number of channels
+ * @frames: the number of frames
+ *
+ * Interleave the samples of @channels separate channels into @dest. The
+ * samples in @dest of channels for which @src contains %NULL are left
+ * untouched.
+ *
+ * Since: 1.18
+ */
+void
+gst_audio_format_interleave (const GstAudioFormatInfo * info, gpointer dest,
+    const gpointer src[], gint channels, gsize frames)
+{
+  g_return_if_fail (info != NULL);
+  g_return_if_fail (dest != NULL);
+  g_return_if_fail (src != NULL);
+
+  switch (info->width) {
+    case 8:
+      interleave_guint8 (dest, src, channels, frames);
+      break;
+    case 16:
+      interleave_guint16 (dest, src, channels, frames);
+      break;
+    case 24:
+      interleave_24 (dest, src, channels, frames);
+      break;
+    case 32:
+      interleave_guint32 (dest, src, channels, frames);
+      break;
+    case 64:
+      interleave_guint64 (dest, src, channels, frames);
+      break;
+    default:
+      g_return_if_reached ();
+  }
+}
+
+/**
+ * gst_audio_format_deinterleave:
+ * @info: a #GstAudioFormatInfo
+ * @dest: (array length=channels) (element-type gpointer): for each
+ *   channel, a destination for @frames samples of that channel or %NULL to
+ *   skip the channel
+ * @src: (element-type guint8): @frames interleaved frames of @channels
+ *   channels
+ * @channels: the number of channels
+ * @frames: the number of frames
+ *
+ * Deinterleave @frames frames from @src into separate channels.
+ *
+ * Since: 1.18
+ */
+void
+gst_audio_format_deinterleave (const GstAudioFormatInfo * info,
+    gpointer dest[], gconstpointer src, gint channels, gsize frames)
+{
+  g_return_if_fail (info != NULL);
+  g_return_if_fail (dest != NULL);
+  g_return_if_fail (src != NULL);
+
+  switch (info->width) {
+    case 8:
+      deinterleave_guint8 (dest, src, channels, frames);
+      break;
+    case 16:
+      deinterleave_guint16 (dest, src, channels, frames);
+      break;
+    case 24:
+      deinterleave_24 (dest, src, channels, frames);
+      break;
+    case 32:
+      deinterleave_guint32 (dest, src, channels, frames);
+      break;
+    case 64:
+      deinterleave_guint64 (dest, src, channels, frames);
+      break;
+    default:
+      g_return_if_reached ();
+  }
+}
@@ -289,6 +289,18 @@ GST_AUDIO_API
 void           gst_audio_format_fill_silence     (const GstAudioFormatInfo *info,
                                                   gpointer dest, gsize length);
 
+GST_AUDIO_API
+void           gst_audio_format_interleave       (const GstAudioFormatInfo *info,
+                                                  gpointer dest,
+                                                  const gpointer src[],
+                                                  gint channels, gsize frames);
+
+GST_AUDIO_API
+void           gst_audio_format_deinterleave     (const GstAudioFormatInfo *info,
+                                                  gpointer dest[],
+                                                  gconstpointer src,
+                                                  gint channels, gsize frames);
+
 /**
  * GST_AUDIO_RATE_RANGE:
  *
@@ -2104,6 +2104,9 @@ gst_audio_aggregator_aggregate (GstAggregator * agg, gboolean timeout)
 
   GST_AUDIO_AGGREGATOR_UNLOCK (aagg);
 
+  if (GST_AUDIO_AGGREGATOR_GET_CLASS (aagg)->finish_output_buffer)
+    GST_AUDIO_AGGREGATOR_GET_CLASS (aagg)->finish_output_buffer (aagg, outbuf);
+
   ret = gst_aggregator_finish_buffer (agg, outbuf);
   aagg->priv->current_buffer = NULL;
 
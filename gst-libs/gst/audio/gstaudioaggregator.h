@@ -194,6 +194,9 @@ struct _GstAudioAggregator
  *  buffer.  The in_offset and out_offset are in "frames", which is
  *  the size of a sample times the number of channels. Returns TRUE if
  *  any non-silence was added to the buffer
+ * @finish_output_buffer: Optional. Called after all input buffers were
+ *  aggregated into the output buffer and its timestamps were set, right
+ *  before it is pushed downstream. Since: 1.18
  *
  * Since: 1.14
  */
@@ -206,9 +209,11 @@ struct _GstAudioAggregatorClass {
   gboolean (* aggregate_one_buffer) (GstAudioAggregator * aagg,
       GstAudioAggregatorPad * pad, GstBuffer * inbuf, guint in_offset,
       GstBuffer * outbuf, guint out_offset, guint num_frames);
+  void (* finish_output_buffer) (GstAudioAggregator * aagg,
+      GstBuffer * outbuf);
 
   /*< private >*/
-  gpointer          _gst_reserved[GST_PADDING_LARGE];
+  gpointer          _gst_reserved[GST_PADDING_LARGE - 1];
 };
 
 /*************************
@@ -45,16 +45,43 @@
 GST_DEBUG_CATEGORY_STATIC (gst_audio_ring_buffer_debug);
 #define GST_CAT_DEFAULT gst_audio_ring_buffer_debug
 
+/* only spin for a free segment when segments are this short, in µs */
+#define SPIN_MAX_SEGMENT_TIME 5000
+/* number of log2 µs buckets in the wait histogram */
+#define WAIT_HISTOGRAM_BUCKETS 16
+
+enum
+{
+  PROP_0,
+  PROP_WAIT_STATS
+};
+
+struct _GstAudioRingBufferPrivate
+{
+  /* time to poll segdone before sleeping on the cond, in µs */
+  gint64 spin_time;
+
+  /* statistics about the writer waiting for free segments, ATOMIC */
+  gint waits;
+  gint spun_waits;
+  gint histogram[WAIT_HISTOGRAM_BUCKETS];
+};
+
+typedef struct _GstAudioRingBufferPrivate GstAudioRingBufferPrivate;
+
 static void gst_audio_ring_buffer_dispose (GObject * object);
 static void gst_audio_ring_buffer_finalize (GObject * object);
+static void gst_audio_ring_buffer_get_property (GObject * object,
+    guint prop_id, GValue * value, GParamSpec * pspec);
 
 static gboolean gst_audio_ring_buffer_pause_unlocked (GstAudioRingBuffer * buf);
+static void reset_wait_stats (GstAudioRingBuffer * buf);
 static void default_clear_all (GstAudioRingBuffer * buf);
 static guint default_commit (GstAudioRingBuffer * buf, guint64 * sample,
     guint8 * data, gint in_samples, gint out_samples, gint * accum);
 
 /* ringbuffer abstract base class */
-G_DEFINE_ABSTRACT_TYPE (GstAudioRingBuffer, gst_audio_ring_buffer,
+G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (GstAudioRingBuffer, gst_audio_ring_buffer,
     GST_TYPE_OBJECT);
 
 static void
@@ -71,6 +98,25 @@ gst_audio_ring_buffer_class_init (GstAudioRingBufferClass * klass)
 
   gobject_class->dispose = gst_audio_ring_buffer_dispose;
   gobject_class->finalize = gst_audio_ring_buffer_finalize;
+  gobject_class->get_property = gst_audio_ring_buffer_get_property;
+
+  /**
+   * GstAudioRingBuffer:wait-stats:
+   *
+   * Statistics about the writer waiting for a free segment, as a
+   * #GstStructure with the total number of "waits", the number of
+   * "spun-waits" that were satisfied without sleeping and a "histogram"
+   * array of the wait times. Entry i of the histogram counts the waits
+   * that took between 2^i and 2^(i+1) microseconds, the last entry also
+   * counts all longer waits. The statistics are reset when the ringbuffer
+   * is acquired.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_WAIT_STATS,
+      g_param_spec_boxed ("wait-stats", "Wait Statistics",
+          "Statistics about waiting for free segments", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 
   gstaudioringbuffer_class->clear_all = GST_DEBUG_FUNCPTR (default_clear_all);
   gstaudioringbuffer_class->commit = GST_DEBUG_FUNCPTR (default_commit);
@@ -116,6 +162,50 @@ gst_audio_ring_buffer_finalize (GObject * object)
       (ringbuffer));
 }
 
+static GstStructure *
+gst_audio_ring_buffer_get_wait_stats (GstAudioRingBuffer * buf)
+{
+  GstAudioRingBufferPrivate *priv =
+      gst_audio_ring_buffer_get_instance_private (buf);
+  GValue histogram = G_VALUE_INIT;
+  GValue count = G_VALUE_INIT;
+  GstStructure *s;
+  gint i;
+
+  s = gst_structure_new ("GstAudioRingBufferWaitStats",
+      "waits", G_TYPE_UINT, (guint) g_atomic_int_get (&priv->waits),
+      "spun-waits", G_TYPE_UINT, (guint) g_atomic_int_get (&priv->spun_waits),
+      NULL);
+
+  g_value_init (&histogram, GST_TYPE_ARRAY);
+  g_value_init (&count, G_TYPE_UINT);
+  for (i = 0; i < WAIT_HISTOGRAM_BUCKETS; i++) {
+    g_value_set_uint (&count, g_atomic_int_get (&priv->histogram[i]));
+    gst_value_array_append_value (&histogram, &count);
+  }
+  g_value_unset (&count);
+  gst_structure_take_value (s, "histogram", &histogram);
+
+  return s;
+}
+
+static void
+gst_audio_ring_buffer_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstAudioRingBuffer *ringbuffer = GST_AUDIO_RING_BUFFER (object);
+
+  switch (prop_id) {
+    case PROP_WAIT_STATS:
+      g_value_take_boxed (value,
+          gst_audio_ring_buffer_get_wait_stats (ringbuffer));
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
 #ifndef GST_DISABLE_GST_DEBUG
 static const gchar *format_type_names[] = {
   "raw",
@@ -651,6 +741,8 @@ gst_audio_ring_buffer_acquire (GstAudioRingBuffer * buf,
 
   buf->samples_per_seg = segsize / bpf;
 
+  reset_wait_stats (buf);
+
   /* create an empty segment */
   g_free (buf->empty_seg);
   buf->empty_seg = g_malloc (segsize);
@@ -1329,11 +1421,60 @@ gst_audio_ring_buffer_clear_all (GstAudioRingBuffer * buf)
 }
 
 
+static void
+reset_wait_stats (GstAudioRingBuffer * buf)
+{
+  GstAudioRingBufferPrivate *priv =
+      gst_audio_ring_buffer_get_instance_private (buf);
+  gint64 segment_time;
+  gint i;
+
+  /* with short segments the reader frees the next segment soon after we
+   * find the ring full, poll for a fraction of a segment before sleeping so
+   * that we don't pay the wakeup latency of the cond */
+  segment_time = 0;
+  if (buf->spec.info.rate > 0)
+    segment_time = gst_util_uint64_scale_int (buf->samples_per_seg,
+        G_USEC_PER_SEC, buf->spec.info.rate);
+  if (segment_time > 0 && segment_time <= SPIN_MAX_SEGMENT_TIME)
+    priv->spin_time = segment_time / 4;
+  else
+    priv->spin_time = 0;
+
+  GST_DEBUG_OBJECT (buf, "segment time %" G_GINT64_FORMAT "us, spin time %"
+      G_GINT64_FORMAT "us", segment_time, priv->spin_time);
+
+  g_atomic_int_set (&priv->waits, 0);
+  g_atomic_int_set (&priv->spun_waits, 0);
+  for (i = 0; i < WAIT_HISTOGRAM_BUCKETS; i++)
+    g_atomic_int_set (&priv->histogram[i], 0);
+}
+
+static void
+record_wait (GstAudioRingBuffer * buf, gint64 elapsed, gboolean spun)
+{
+  GstAudioRingBufferPrivate *priv =
+      gst_audio_ring_buffer_get_instance_private (buf);
+  gint bucket = 0;
+
+  while (elapsed > 1 && bucket < WAIT_HISTOGRAM_BUCKETS - 1) {
+    elapsed >>= 1;
+    bucket++;
+  }
+  g_atomic_int_inc (&priv->histogram[bucket]);
+  g_atomic_int_inc (&priv->waits);
+  if (spun)
+    g_atomic_int_inc (&priv->spun_waits);
+}
+
 static gboolean
 wait_segment (GstAudioRingBuffer * buf)
 {
+  GstAudioRingBufferPrivate *priv =
+      gst_audio_ring_buffer_get_instance_private (buf);
   gint segments;
   gboolean wait = TRUE;
+  gint64 start, spin_end;
 
   /* buffer must be started now or we deadlock since nobody is reading */
   if (G_UNLIKELY (g_atomic_int_get (&buf->state) !=
@@ -1350,6 +1491,27 @@ wait_segment (GstAudioRingBuffer * buf)
      * don't need to wait anymore */
     if (G_LIKELY (g_atomic_int_get (&buf->segdone) != segments))
       wait = FALSE;
+  } else {
+    segments = g_atomic_int_get (&buf->segdone);
+  }
+
+  start = g_get_monotonic_time ();
+
+  /* poll for the reader to release a segment before taking the lock, the
+   * flushing and state checks below are still done after this */
+  if (G_LIKELY (wait) && priv->spin_time > 0) {
+    spin_end = start + priv->spin_time;
+    do {
+      if (g_atomic_int_get (&buf->segdone) != segments) {
+        record_wait (buf, g_get_monotonic_time () - start, TRUE);
+        wait = FALSE;
+        break;
+      }
+      if (G_UNLIKELY (g_atomic_int_get (&buf->state) !=
+              GST_AUDIO_RING_BUFFER_STATE_STARTED))
+        break;
+      g_thread_yield ();
+    } while (g_get_monotonic_time () < spin_end);
   }
 
   /* take lock first, then update our waiting flag */
@@ -1373,6 +1535,7 @@ wait_segment (GstAudioRingBuffer * buf)
               GST_AUDIO_RING_BUFFER_STATE_STARTED))
         goto not_started;
     }
+    record_wait (buf, g_get_monotonic_time () - start, FALSE);
   }
   GST_OBJECT_UNLOCK (buf);
 
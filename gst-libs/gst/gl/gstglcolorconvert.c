@@ -1967,6 +1967,8 @@ _create_shader (GstGLColorConvert * convert)
   int i;
 
   ret = gst_gl_shader_new (convert->context);
+  /* the same conversions are set up over and over again */
+  gst_gl_shader_set_use_program_cache (ret, TRUE);
 
   tmp =
       _gst_glsl_mangle_shader (text_vertex_shader, GL_VERTEX_SHADER,
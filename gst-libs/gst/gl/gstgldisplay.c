@@ -39,6 +39,12 @@
  *   'egl', 'glx', 'wgl' or 'cgl'.
  * - GST_GL_API influences the OpenGL API requested by the OpenGL platform.
  *   Common values are 'opengl', 'opengl3' and 'gles2'.
+ * - GST_GL_PROGRAM_CACHE_DIR is a directory where the binaries of linked
+ *   shader programs are stored so that they can be reused by later processes
+ *   instead of linking the same shaders again.  It only applies to shaders
+ *   that enabled the cache with gst_gl_shader_set_use_program_cache().  The
+ *   directory is read and written from a separate thread, never from the GL
+ *   thread.
  *
  * > Certain window systems require a special function to be called to
  * > initialize threading support.  As this GStreamer GL library does not preclude
@@ -53,8 +59,12 @@
 #include "config.h"
 #endif
 
+#include <errno.h>
+#include <string.h>
+
 #include "gl.h"
 #include "gstgldisplay.h"
+#include "gstgldisplay_private.h"
 
 #if GST_GL_HAVE_WINDOW_COCOA
 #include <gst/gl/cocoa/gstgldisplay_cocoa.h>
@@ -99,6 +109,17 @@ static gboolean gst_gl_display_default_get_foreign_display (GstGLDisplay *
 static GstGLWindow *gst_gl_display_default_create_window (GstGLDisplay *
     display);
 
+/* a job of the program cache IO thread, loads the cache directory when
+ * @key is NULL and writes @binary to it otherwise */
+struct ProgramCacheIO
+{
+  gchar *key;
+  GBytes *binary;
+};
+
+static void _program_cache_io_func (struct ProgramCacheIO *io,
+    GstGLDisplay * display);
+
 struct _GstGLDisplayPrivate
 {
   GstGLAPI gl_api;
@@ -109,6 +130,16 @@ struct _GstGLDisplayPrivate
 
   GMutex thread_lock;
   GCond thread_cond;
+
+  /* program binary cache, protected by program_cache_lock and not by the
+   * object lock as it is used from GL threads */
+  GMutex program_cache_lock;
+  GHashTable *program_cache;
+  gchar *program_cache_dir;
+  /* loads and writes the files of program_cache_dir */
+  GThreadPool *program_cache_io;
+  guint64 program_cache_hits;
+  guint64 program_cache_misses;
 };
 
 #define DEBUG_INIT \
@@ -193,6 +224,20 @@ gst_gl_display_init (GstGLDisplay * display)
   g_mutex_init (&display->priv->thread_lock);
   g_cond_init (&display->priv->thread_cond);
 
+  g_mutex_init (&display->priv->program_cache_lock);
+  display->priv->program_cache = g_hash_table_new_full (g_str_hash,
+      g_str_equal, g_free, (GDestroyNotify) g_bytes_unref);
+  display->priv->program_cache_dir =
+      g_strdup (g_getenv ("GST_GL_PROGRAM_CACHE_DIR"));
+  if (display->priv->program_cache_dir) {
+    /* a single thread keeps the writes ordered after the initial load */
+    display->priv->program_cache_io =
+        g_thread_pool_new ((GFunc) _program_cache_io_func, display, 1, FALSE,
+        NULL);
+    g_thread_pool_push (display->priv->program_cache_io,
+        g_new0 (struct ProgramCacheIO, 1), NULL);
+  }
+
   display->priv->event_thread = g_thread_new ("gldisplay-event",
       (GThreadFunc) _event_thread_main, display);
 
@@ -259,6 +304,13 @@ gst_gl_display_finalize (GObject * object)
   g_cond_clear (&display->priv->thread_cond);
   g_mutex_clear (&display->priv->thread_lock);
 
+  /* finish pending writes before the cache goes away */
+  if (display->priv->program_cache_io)
+    g_thread_pool_free (display->priv->program_cache_io, FALSE, TRUE);
+  g_hash_table_unref (display->priv->program_cache);
+  g_free (display->priv->program_cache_dir);
+  g_mutex_clear (&display->priv->program_cache_lock);
+
   G_OBJECT_CLASS (gst_gl_display_parent_class)->finalize (object);
 }
 
@@ -823,3 +875,194 @@ out:
 
   return ret;
 }
+
+static gchar *
+_program_cache_filename (GstGLDisplay * display, const gchar * key)
+{
+  gchar *basename, *ret;
+
+  basename = g_strconcat (key, ".bin", NULL);
+  ret = g_build_filename (display->priv->program_cache_dir, basename, NULL);
+  g_free (basename);
+
+  return ret;
+}
+
+/* loads the binaries already on disk, not replacing the ones that were
+ * stored in the meantime */
+static void
+_program_cache_load_dir (GstGLDisplay * display)
+{
+  GstGLDisplayPrivate *priv = display->priv;
+  const gchar *name;
+  GDir *dir;
+
+  dir = g_dir_open (priv->program_cache_dir, 0, NULL);
+  if (!dir)
+    return;
+
+  while ((name = g_dir_read_name (dir))) {
+    gchar *filename, *contents, *key;
+    gsize length;
+
+    if (!g_str_has_suffix (name, ".bin"))
+      continue;
+
+    filename = g_build_filename (priv->program_cache_dir, name, NULL);
+    if (g_file_get_contents (filename, &contents, &length, NULL)) {
+      key = g_strndup (name, strlen (name) - strlen (".bin"));
+
+      g_mutex_lock (&priv->program_cache_lock);
+      if (!g_hash_table_contains (priv->program_cache, key)) {
+        GST_DEBUG_OBJECT (display, "loaded program binary from %s", filename);
+        g_hash_table_insert (priv->program_cache, key,
+            g_bytes_new_take (contents, length));
+      } else {
+        g_free (key);
+        g_free (contents);
+      }
+      g_mutex_unlock (&priv->program_cache_lock);
+    }
+    g_free (filename);
+  }
+
+  g_dir_close (dir);
+}
+
+static void
+_program_cache_write (GstGLDisplay * display, const gchar * key,
+    GBytes * binary)
+{
+  GstGLDisplayPrivate *priv = display->priv;
+  gchar *filename = _program_cache_filename (display, key);
+  GError *error = NULL;
+  gconstpointer data;
+  gsize size;
+
+  data = g_bytes_get_data (binary, &size);
+  if (g_mkdir_with_parents (priv->program_cache_dir, 0755) != 0
+      || !g_file_set_contents (filename, data, size, &error)) {
+    GST_WARNING_OBJECT (display, "failed to write program binary to %s: %s",
+        filename, error ? error->message : g_strerror (errno));
+    g_clear_error (&error);
+  }
+  g_free (filename);
+}
+
+static void
+_program_cache_io_func (struct ProgramCacheIO *io, GstGLDisplay * display)
+{
+  if (io->key) {
+    _program_cache_write (display, io->key, io->binary);
+    g_free (io->key);
+    g_bytes_unref (io->binary);
+  } else {
+    _program_cache_load_dir (display);
+  }
+
+  g_free (io);
+}
+
+/**
+ * _gst_gl_display_lookup_program_binary:
+ * @display: a #GstGLDisplay
+ * @key: the cache key of the program
+ *
+ * Looks up the program binary stored under @key.  Only the in-memory cache
+ * is looked at, the binaries of GST_GL_PROGRAM_CACHE_DIR are loaded into it
+ * from another thread when @display is created.
+ *
+ * Returns: (transfer full) (nullable): the program binary as stored by
+ * _gst_gl_display_store_program_binary()
+ */
+GBytes *
+_gst_gl_display_lookup_program_binary (GstGLDisplay * display,
+    const gchar * key)
+{
+  GstGLDisplayPrivate *priv = display->priv;
+  GBytes *ret;
+
+  g_mutex_lock (&priv->program_cache_lock);
+  ret = g_hash_table_lookup (priv->program_cache, key);
+  if (ret)
+    g_bytes_ref (ret);
+  g_mutex_unlock (&priv->program_cache_lock);
+
+  return ret;
+}
+
+/**
+ * _gst_gl_display_store_program_binary:
+ * @display: a #GstGLDisplay
+ * @key: the cache key of the program
+ * @binary: (transfer full): the program binary
+ *
+ * Stores @binary under @key, replacing any previous binary.  If
+ * GST_GL_PROGRAM_CACHE_DIR is set, the binary is written to it from another
+ * thread.
+ */
+void
+_gst_gl_display_store_program_binary (GstGLDisplay * display,
+    const gchar * key, GBytes * binary)
+{
+  GstGLDisplayPrivate *priv = display->priv;
+
+  if (priv->program_cache_io) {
+    struct ProgramCacheIO *io = g_new0 (struct ProgramCacheIO, 1);
+
+    io->key = g_strdup (key);
+    io->binary = g_bytes_ref (binary);
+    g_thread_pool_push (priv->program_cache_io, io, NULL);
+  }
+
+  g_mutex_lock (&priv->program_cache_lock);
+  g_hash_table_insert (priv->program_cache, g_strdup (key), binary);
+  g_mutex_unlock (&priv->program_cache_lock);
+}
+
+/**
+ * _gst_gl_display_record_program_cache_result:
+ * @display: a #GstGLDisplay
+ * @hit: whether a program could be created from a cached binary
+ */
+void
+_gst_gl_display_record_program_cache_result (GstGLDisplay * display,
+    gboolean hit)
+{
+  g_mutex_lock (&display->priv->program_cache_lock);
+  if (hit)
+    display->priv->program_cache_hits++;
+  else
+    display->priv->program_cache_misses++;
+  g_mutex_unlock (&display->priv->program_cache_lock);
+}
+
+/**
+ * gst_gl_display_get_program_cache_stats:
+ * @display: a #GstGLDisplay
+ * @hits: (out) (optional): the number of shader programs that were created
+ *     from a cached program binary
+ * @misses: (out) (optional): the number of shader programs that had to be
+ *     compiled and linked
+ *
+ * Retrieves the statistics of the cache of linked shader programs that is
+ * shared by all the #GstGLShader's created with contexts of @display.  Only
+ * programs of shaders that enabled the cache with
+ * gst_gl_shader_set_use_program_cache(), linked while program binaries are
+ * supported by the OpenGL implementation, are accounted for.
+ *
+ * Since: 1.18
+ */
+void
+gst_gl_display_get_program_cache_stats (GstGLDisplay * display,
+    guint64 * hits, guint64 * misses)
+{
+  g_return_if_fail (GST_IS_GL_DISPLAY (display));
+
+  g_mutex_lock (&display->priv->program_cache_lock);
+  if (hits)
+    *hits = display->priv->program_cache_hits;
+  if (misses)
+    *misses = display->priv->program_cache_misses;
+  g_mutex_unlock (&display->priv->program_cache_lock);
+}
@@ -142,6 +142,11 @@ GST_GL_API
 gboolean gst_gl_display_add_context (GstGLDisplay * display,
     GstGLContext * context);
 
+GST_GL_API
+void            gst_gl_display_get_program_cache_stats (GstGLDisplay * display,
+                                                        guint64 * hits,
+                                                        guint64 * misses);
+
 GST_GL_API
 GstGLWindow *   gst_gl_display_create_window    (GstGLDisplay * display);
 GST_GL_API
@@ -0,0 +1,40 @@
+/*
+ * GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_GL_DISPLAY_PRIVATE_H__
+#define __GST_GL_DISPLAY_PRIVATE_H__
+
+#include <gst/gl/gstgl_fwd.h>
+
+G_BEGIN_DECLS
+
+G_GNUC_INTERNAL
+GBytes *            _gst_gl_display_lookup_program_binary       (GstGLDisplay * display,
+                                                                 const gchar * key);
+G_GNUC_INTERNAL
+void                _gst_gl_display_store_program_binary        (GstGLDisplay * display,
+                                                                 const gchar * key,
+                                                                 GBytes * binary);
+G_GNUC_INTERNAL
+void                _gst_gl_display_record_program_cache_result (GstGLDisplay * display,
+                                                                 gboolean hit);
+
+G_END_DECLS
+
+#endif /* __GST_GL_DISPLAY_PRIVATE_H__ */
@@ -30,6 +30,7 @@
 #endif
 
 #include <stdio.h>
+#include <string.h>
 
 #include "gstgloverlaycompositor.h"
 
@@ -81,10 +82,18 @@ struct _GstGLCompositionOverlay
   GLint texcoord_attrib;
 
   GLfloat positions[16];
+  GLfloat texcoords[8];
 
   GLuint texture_id;
   GstGLMemory *gl_memory;
   GstVideoOverlayRectangle *rectangle;
+  guint seqnum;
+
+  /* placement inside the compositor's atlas texture, only valid when
+   * @in_atlas is set.  Otherwise the overlay has its own texture */
+  gboolean needs_upload;
+  gboolean in_atlas;
+  guint batch_index;
 
   gboolean yinvert;
 };
@@ -214,6 +223,9 @@ gst_gl_composition_overlay_finalize (GObject * object)
   if (overlay->gl_memory)
     gst_memory_unref ((GstMemory *) overlay->gl_memory);
 
+  if (overlay->rectangle)
+    gst_video_overlay_rectangle_unref (overlay->rectangle);
+
   if (overlay->context) {
     gst_gl_context_thread_add (overlay->context,
         gst_gl_composition_overlay_free_vertex_buffer, overlay);
@@ -293,12 +305,6 @@ gst_gl_composition_overlay_add_transformation (GstGLCompositionOverlay *
   overlay->positions[14] = 0.0;
   overlay->positions[15] = 1.0;
 
-  gst_gl_context_thread_add (overlay->context,
-      gst_gl_composition_overlay_free_vertex_buffer, overlay);
-
-  gst_gl_context_thread_add (overlay->context,
-      gst_gl_composition_overlay_init_vertex_buffer, overlay);
-
   GST_DEBUG
       ("overlay position: (%d,%d) size: %dx%d video size: %dx%d",
       comp_x, comp_y, comp_width, comp_height, meta->width, meta->height);
@@ -316,7 +322,9 @@ gst_gl_composition_overlay_new (GstGLContext * context,
 
   overlay->gl_memory = NULL;
   overlay->texture_id = -1;
-  overlay->rectangle = rectangle;
+  overlay->rectangle = gst_video_overlay_rectangle_ref (rectangle);
+  overlay->seqnum = gst_video_overlay_rectangle_get_seqnum (rectangle);
+  overlay->needs_upload = TRUE;
   overlay->context = gst_object_ref (context);
   overlay->vao = 0;
   overlay->position_attrib = position_attrib;
@@ -336,17 +344,9 @@ _video_frame_unmap_and_free (gpointer user_data)
   g_slice_free (GstVideoFrame, frame);
 }
 
-static void
-gst_gl_composition_overlay_upload (GstGLCompositionOverlay * overlay,
-    GstBuffer * buf)
+static GstBuffer *
+gst_gl_composition_overlay_get_pixels (GstGLCompositionOverlay * overlay)
 {
-  GstGLMemory *comp_gl_memory = NULL;
-  GstBuffer *comp_buffer = NULL;
-  GstBuffer *overlay_buffer = NULL;
-  GstVideoInfo vinfo;
-  GstVideoMeta *vmeta;
-  GstVideoFrame *comp_frame;
-  GstVideoFrame gl_frame;
   GstVideoOverlayFormatFlags flags;
   GstVideoOverlayFormatFlags alpha_flags;
 
@@ -363,9 +363,20 @@ gst_gl_composition_overlay_upload (GstGLCompositionOverlay * overlay,
     alpha_flags = 0;
   }
 
-  comp_buffer =
-      gst_video_overlay_rectangle_get_pixels_unscaled_argb (overlay->rectangle,
-      alpha_flags);
+  return gst_video_overlay_rectangle_get_pixels_unscaled_argb
+      (overlay->rectangle, alpha_flags);
+}
+
+static void
+gst_gl_composition_overlay_upload (GstGLCompositionOverlay * overlay,
+    GstBuffer * comp_buffer)
+{
+  GstGLMemory *comp_gl_memory = NULL;
+  GstBuffer *overlay_buffer = NULL;
+  GstVideoInfo vinfo;
+  GstVideoMeta *vmeta;
+  GstVideoFrame *comp_frame;
+  GstVideoFrame gl_frame;
 
   comp_frame = g_slice_new (GstVideoFrame);
 
@@ -383,7 +394,10 @@ gst_gl_composition_overlay_upload (GstGLCompositionOverlay * overlay,
         GST_ALLOCATOR (gst_gl_memory_allocator_get_default (overlay->context));
     mem_allocator = GST_GL_BASE_MEMORY_ALLOCATOR (allocator);
 
-    gst_gl_composition_overlay_add_transformation (overlay, buf);
+    gst_gl_context_thread_add (overlay->context,
+        gst_gl_composition_overlay_free_vertex_buffer, overlay);
+    gst_gl_context_thread_add (overlay->context,
+        gst_gl_composition_overlay_init_vertex_buffer, overlay);
 
     params = gst_gl_video_allocation_params_new_wrapped_data (overlay->context,
         NULL, &comp_frame->info, 0, NULL, GST_GL_TEXTURE_TARGET_2D,
@@ -421,6 +435,81 @@ gst_gl_composition_overlay_upload (GstGLCompositionOverlay * overlay,
   }
 }
 
+/* called in the GL thread */
+static gboolean
+gst_gl_composition_overlay_upload_to_atlas (GstGLCompositionOverlay * overlay,
+    GstBuffer * comp_buffer, GLuint atlas_tex, guint atlas_size, guint x,
+    guint y)
+{
+  const GstGLFuncs *gl = overlay->context->gl_vtable;
+  GstVideoMeta *vmeta;
+  GstVideoInfo vinfo;
+  GstVideoFrame frame;
+  const guint8 *data;
+  guint width, height, stride, i;
+  GLfloat u0, u1, v0, v1;
+
+  vmeta = gst_buffer_get_video_meta (comp_buffer);
+  width = vmeta->width;
+  height = vmeta->height;
+  gst_video_info_set_format (&vinfo, vmeta->format, width, height);
+  vinfo.stride[0] = vmeta->stride[0];
+
+  if (!gst_video_frame_map (&frame, &vinfo, comp_buffer, GST_MAP_READ))
+    return FALSE;
+
+  data = GST_VIDEO_FRAME_PLANE_DATA (&frame, 0);
+  stride = GST_VIDEO_FRAME_PLANE_STRIDE (&frame, 0);
+
+  gl->BindTexture (GL_TEXTURE_2D, atlas_tex);
+  if (stride == width * 4) {
+    gl->TexSubImage2D (GL_TEXTURE_2D, 0, x, y, width, height, GL_RGBA,
+        GL_UNSIGNED_BYTE, data);
+  } else {
+    /* GL_UNPACK_ROW_LENGTH is not available everywhere */
+    for (i = 0; i < height; i++)
+      gl->TexSubImage2D (GL_TEXTURE_2D, 0, x, y + i, width, 1, GL_RGBA,
+          GL_UNSIGNED_BYTE, data + i * stride);
+  }
+  gl->BindTexture (GL_TEXTURE_2D, 0);
+
+  gst_video_frame_unmap (&frame);
+
+  u0 = (GLfloat) x / (GLfloat) atlas_size;
+  u1 = (GLfloat) (x + width) / (GLfloat) atlas_size;
+  v0 = (GLfloat) y / (GLfloat) atlas_size;
+  v1 = (GLfloat) (y + height) / (GLfloat) atlas_size;
+
+  /* same vertex order as the positions */
+  overlay->texcoords[0] = u1;
+  overlay->texcoords[1] = v0;
+  overlay->texcoords[2] = u0;
+  overlay->texcoords[3] = v0;
+  overlay->texcoords[4] = u0;
+  overlay->texcoords[5] = v1;
+  overlay->texcoords[6] = u1;
+  overlay->texcoords[7] = v1;
+
+  overlay->in_atlas = TRUE;
+
+  GST_TRACE_OBJECT (overlay, "uploaded %ux%u overlay to atlas at %u,%u",
+      width, height, x, y);
+
+  return TRUE;
+}
+
+static gboolean
+gst_gl_composition_overlay_is_premultiplied (GstGLCompositionOverlay *
+    overlay)
+{
+  GstVideoOverlayFormatFlags flags;
+
+  flags = gst_video_overlay_rectangle_get_flags (overlay->rectangle);
+
+  return (flags & GST_VIDEO_OVERLAY_FORMAT_FLAG_PREMULTIPLIED_ALPHA)
+      || !overlay->context->gl_vtable->BlendFuncSeparate;
+}
+
 static void
 gst_gl_composition_overlay_draw (GstGLCompositionOverlay * overlay,
     GstGLShader * shader)
@@ -436,9 +525,36 @@ gst_gl_composition_overlay_draw (GstGLCompositionOverlay * overlay,
   gl->DrawElements (GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, 0);
 }
 
+/* overlays up to this size are packed into a texture shared by all of them
+ * so that they can be drawn with a single draw call */
+#define ATLAS_SIZE 1024
+/* transparent border around each packed overlay so that linear filtering
+ * does not bleed neighbouring overlays in */
+#define ATLAS_PADDING 1
+/* the batch is indexed with GLushort */
+#define MAX_BATCH_QUADS (G_MAXUINT16 / 4)
+
+typedef struct
+{
+  guint y;
+  guint height;
+  guint used_width;
+} GstGLOverlayAtlasShelf;
+
 typedef struct
 {
   gboolean yinvert;
+
+  /* shelf packed atlas */
+  GLuint atlas_tex;
+  guint atlas_size;
+  GArray *atlas_shelves;
+
+  /* interleaved position + texcoord quads of all overlays in the atlas */
+  GLuint batch_vao;
+  GLuint batch_vertex_buffer;
+  GLuint batch_index_buffer;
+  guint batch_index_capacity;
 } GstGLOverlayCompositorPrivate;
 
 enum
@@ -498,6 +614,8 @@ gst_gl_overlay_compositor_init (GstGLOverlayCompositor * compositor)
       gst_gl_overlay_compositor_get_instance_private (compositor);
 
   priv->yinvert = DEFAULT_YINVERT;
+  priv->atlas_shelves =
+      g_array_new (FALSE, FALSE, sizeof (GstGLOverlayAtlasShelf));
 }
 
 static void
@@ -588,17 +706,55 @@ gst_gl_overlay_compositor_new (GstGLContext * context)
   return compositor;
 }
 
+static void
+gst_gl_overlay_compositor_deinit_gl (GstGLContext * context,
+    gpointer compositor_pointer)
+{
+  GstGLOverlayCompositor *compositor =
+      (GstGLOverlayCompositor *) compositor_pointer;
+  GstGLOverlayCompositorPrivate *priv =
+      gst_gl_overlay_compositor_get_instance_private (compositor);
+  const GstGLFuncs *gl = context->gl_vtable;
+
+  if (priv->atlas_tex) {
+    gl->DeleteTextures (1, &priv->atlas_tex);
+    priv->atlas_tex = 0;
+  }
+
+  if (priv->batch_vao) {
+    gl->DeleteVertexArrays (1, &priv->batch_vao);
+    priv->batch_vao = 0;
+  }
+
+  if (priv->batch_vertex_buffer) {
+    gl->DeleteBuffers (1, &priv->batch_vertex_buffer);
+    priv->batch_vertex_buffer = 0;
+  }
+
+  if (priv->batch_index_buffer) {
+    gl->DeleteBuffers (1, &priv->batch_index_buffer);
+    priv->batch_index_buffer = 0;
+  }
+  priv->batch_index_capacity = 0;
+}
+
 static void
 gst_gl_overlay_compositor_finalize (GObject * object)
 {
   GstGLOverlayCompositor *compositor;
+  GstGLOverlayCompositorPrivate *priv;
 
   compositor = GST_GL_OVERLAY_COMPOSITOR (object);
+  priv = gst_gl_overlay_compositor_get_instance_private (compositor);
 
   gst_gl_overlay_compositor_free_overlays (compositor);
+  g_array_free (priv->atlas_shelves, TRUE);
 
-  if (compositor->context)
+  if (compositor->context) {
+    gst_gl_context_thread_add (compositor->context,
+        gst_gl_overlay_compositor_deinit_gl, compositor);
     gst_object_unref (compositor->context);
+  }
 
   if (compositor->shader) {
     gst_object_unref (compositor->shader);
@@ -612,11 +768,12 @@ static gboolean
 _is_rectangle_in_overlays (GList * overlays,
     GstVideoOverlayRectangle * rectangle)
 {
+  guint seqnum = gst_video_overlay_rectangle_get_seqnum (rectangle);
   GList *l;
 
   for (l = overlays; l != NULL; l = l->next) {
     GstGLCompositionOverlay *overlay = (GstGLCompositionOverlay *) l->data;
-    if (overlay->rectangle == rectangle)
+    if (overlay->seqnum == seqnum)
       return TRUE;
   }
   return FALSE;
@@ -631,12 +788,334 @@ _is_overlay_in_rectangles (GstVideoOverlayComposition * composition,
   for (i = 0; i < gst_video_overlay_composition_n_rectangles (composition); i++) {
     GstVideoOverlayRectangle *rectangle =
         gst_video_overlay_composition_get_rectangle (composition, i);
-    if (overlay->rectangle == rectangle)
+    if (overlay->seqnum == gst_video_overlay_rectangle_get_seqnum (rectangle))
       return TRUE;
   }
   return FALSE;
 }
 
+/* Find space for a @width x @height overlay in the atlas using a simple
+ * shelf packer.  Space is only reclaimed by repacking everything. */
+static gboolean
+_atlas_allocate (GstGLOverlayCompositorPrivate * priv, guint width,
+    guint height, guint * x, guint * y)
+{
+  GstGLOverlayAtlasShelf *best = NULL;
+  guint i, next_y = 0;
+
+  width += ATLAS_PADDING;
+  height += ATLAS_PADDING;
+
+  for (i = 0; i < priv->atlas_shelves->len; i++) {
+    GstGLOverlayAtlasShelf *shelf =
+        &g_array_index (priv->atlas_shelves, GstGLOverlayAtlasShelf, i);
+
+    next_y = shelf->y + shelf->height;
+
+    if (shelf->height < height || priv->atlas_size - shelf->used_width < width)
+      continue;
+
+    if (!best || shelf->height < best->height)
+      best = shelf;
+  }
+
+  if (!best) {
+    GstGLOverlayAtlasShelf shelf;
+
+    if (width > priv->atlas_size || next_y + height > priv->atlas_size)
+      return FALSE;
+
+    shelf.y = next_y;
+    shelf.height = height;
+    shelf.used_width = 0;
+    g_array_append_val (priv->atlas_shelves, shelf);
+
+    best = &g_array_index (priv->atlas_shelves, GstGLOverlayAtlasShelf,
+        priv->atlas_shelves->len - 1);
+  }
+
+  *x = best->used_width + ATLAS_PADDING;
+  *y = best->y + ATLAS_PADDING;
+  best->used_width += width;
+
+  return TRUE;
+}
+
+/* forget all placements. The used part of the texture is cleared as the
+ * padding between overlays has to stay transparent */
+static void
+_atlas_reset (GstGLOverlayCompositor * compositor)
+{
+  GstGLOverlayCompositorPrivate *priv =
+      gst_gl_overlay_compositor_get_instance_private (compositor);
+  const GstGLFuncs *gl = compositor->context->gl_vtable;
+  GstGLOverlayAtlasShelf *last;
+  guint used_height;
+  guint8 *zeros;
+
+  if (priv->atlas_shelves->len == 0)
+    return;
+
+  last = &g_array_index (priv->atlas_shelves, GstGLOverlayAtlasShelf,
+      priv->atlas_shelves->len - 1);
+  used_height = MIN (last->y + last->height + ATLAS_PADDING, priv->atlas_size);
+
+  zeros = g_malloc0 (priv->atlas_size * used_height * 4);
+  gl->BindTexture (GL_TEXTURE_2D, priv->atlas_tex);
+  gl->TexSubImage2D (GL_TEXTURE_2D, 0, 0, 0, priv->atlas_size, used_height,
+      GL_RGBA, GL_UNSIGNED_BYTE, zeros);
+  gl->BindTexture (GL_TEXTURE_2D, 0);
+  g_free (zeros);
+
+  g_array_set_size (priv->atlas_shelves, 0);
+}
+
+static void
+_atlas_init (GstGLOverlayCompositor * compositor)
+{
+  GstGLOverlayCompositorPrivate *priv =
+      gst_gl_overlay_compositor_get_instance_private (compositor);
+  const GstGLFuncs *gl = compositor->context->gl_vtable;
+  GLint max_size = 0;
+  guint8 *zeros;
+
+  gl->GetIntegerv (GL_MAX_TEXTURE_SIZE, &max_size);
+  priv->atlas_size = MIN (ATLAS_SIZE, max_size);
+
+  gl->GenTextures (1, &priv->atlas_tex);
+  gl->BindTexture (GL_TEXTURE_2D, priv->atlas_tex);
+  gl->TexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  gl->TexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  gl->TexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  gl->TexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+  zeros = g_malloc0 (priv->atlas_size * priv->atlas_size * 4);
+  gl->TexImage2D (GL_TEXTURE_2D, 0, GL_RGBA, priv->atlas_size,
+      priv->atlas_size, 0, GL_RGBA, GL_UNSIGNED_BYTE, zeros);
+  gl->BindTexture (GL_TEXTURE_2D, 0);
+  g_free (zeros);
+
+  GST_DEBUG_OBJECT (compositor, "created %ux%u overlay atlas %u",
+      priv->atlas_size, priv->atlas_size, priv->atlas_tex);
+}
+
+static void
+_batch_bind_attributes (GstGLOverlayCompositor * compositor)
+{
+  GstGLOverlayCompositorPrivate *priv =
+      gst_gl_overlay_compositor_get_instance_private (compositor);
+  const GstGLFuncs *gl = compositor->context->gl_vtable;
+
+  gl->BindBuffer (GL_ARRAY_BUFFER, priv->batch_vertex_buffer);
+  gl->VertexAttribPointer (compositor->position_attrib, 4, GL_FLOAT, GL_FALSE,
+      6 * sizeof (GLfloat), NULL);
+  gl->VertexAttribPointer (compositor->texcoord_attrib, 2, GL_FLOAT, GL_FALSE,
+      6 * sizeof (GLfloat), (gpointer) (4 * sizeof (GLfloat)));
+
+  gl->BindBuffer (GL_ELEMENT_ARRAY_BUFFER, priv->batch_index_buffer);
+
+  gl->EnableVertexAttribArray (compositor->position_attrib);
+  gl->EnableVertexAttribArray (compositor->texcoord_attrib);
+}
+
+/* rebuild the vertices of all the overlays living in the atlas */
+static void
+_batch_update (GstGLOverlayCompositor * compositor)
+{
+  GstGLOverlayCompositorPrivate *priv =
+      gst_gl_overlay_compositor_get_instance_private (compositor);
+  const GstGLFuncs *gl = compositor->context->gl_vtable;
+  GLfloat *vertices, *v;
+  guint n_quads = 0;
+  GList *l;
+
+  for (l = compositor->overlays; l != NULL; l = l->next) {
+    GstGLCompositionOverlay *overlay = (GstGLCompositionOverlay *) l->data;
+    if (overlay->in_atlas)
+      n_quads++;
+  }
+
+  if (n_quads == 0)
+    return;
+
+  v = vertices = g_new (GLfloat, n_quads * 4 * 6);
+  n_quads = 0;
+  for (l = compositor->overlays; l != NULL; l = l->next) {
+    GstGLCompositionOverlay *overlay = (GstGLCompositionOverlay *) l->data;
+    guint i;
+
+    if (!overlay->in_atlas)
+      continue;
+
+    overlay->batch_index = n_quads++;
+    for (i = 0; i < 4; i++) {
+      memcpy (v, &overlay->positions[i * 4], 4 * sizeof (GLfloat));
+      memcpy (v + 4, &overlay->texcoords[i * 2], 2 * sizeof (GLfloat));
+      v += 6;
+    }
+  }
+
+  if (gl->GenVertexArrays) {
+    if (!priv->batch_vao)
+      gl->GenVertexArrays (1, &priv->batch_vao);
+    gl->BindVertexArray (priv->batch_vao);
+  }
+
+  if (!priv->batch_vertex_buffer)
+    gl->GenBuffers (1, &priv->batch_vertex_buffer);
+  gl->BindBuffer (GL_ARRAY_BUFFER, priv->batch_vertex_buffer);
+  gl->BufferData (GL_ARRAY_BUFFER, n_quads * 4 * 6 * sizeof (GLfloat),
+      vertices, GL_DYNAMIC_DRAW);
+  g_free (vertices);
+
+  if (!priv->batch_index_buffer)
+    gl->GenBuffers (1, &priv->batch_index_buffer);
+
+  if (n_quads > priv->batch_index_capacity) {
+    GLushort *indices;
+    guint i;
+
+    indices = g_new (GLushort, n_quads * 6);
+    for (i = 0; i < n_quads; i++) {
+      indices[i * 6 + 0] = i * 4 + 0;
+      indices[i * 6 + 1] = i * 4 + 1;
+      indices[i * 6 + 2] = i * 4 + 2;
+      indices[i * 6 + 3] = i * 4 + 0;
+      indices[i * 6 + 4] = i * 4 + 2;
+      indices[i * 6 + 5] = i * 4 + 3;
+    }
+
+    gl->BindBuffer (GL_ELEMENT_ARRAY_BUFFER, priv->batch_index_buffer);
+    gl->BufferData (GL_ELEMENT_ARRAY_BUFFER, n_quads * 6 * sizeof (GLushort),
+        indices, GL_STATIC_DRAW);
+    g_free (indices);
+
+    priv->batch_index_capacity = n_quads;
+  }
+
+  if (gl->GenVertexArrays) {
+    _batch_bind_attributes (compositor);
+    gl->BindVertexArray (0);
+  }
+
+  gl->BindBuffer (GL_ELEMENT_ARRAY_BUFFER, 0);
+  gl->BindBuffer (GL_ARRAY_BUFFER, 0);
+}
+
+static void
+_batch_draw (GstGLOverlayCompositor * compositor, guint first, guint count,
+    gboolean premultiplied)
+{
+  GstGLOverlayCompositorPrivate *priv =
+      gst_gl_overlay_compositor_get_instance_private (compositor);
+  const GstGLFuncs *gl = compositor->context->gl_vtable;
+
+  if (premultiplied) {
+    gl->BlendFunc (GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+  } else {
+    gl->BlendFuncSeparate (GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE,
+        GL_ONE_MINUS_SRC_ALPHA);
+  }
+
+  if (gl->GenVertexArrays)
+    gl->BindVertexArray (priv->batch_vao);
+  else
+    _batch_bind_attributes (compositor);
+
+  gl->BindTexture (GL_TEXTURE_2D, priv->atlas_tex);
+  gl->DrawElements (GL_TRIANGLES, count * 6, GL_UNSIGNED_SHORT,
+      (gpointer) (gsize) (first * 6 * sizeof (GLushort)));
+}
+
+/* Called in the GL thread whenever the set of overlays changed. Uploads new
+ * overlays into the atlas, falling back to a texture per overlay for the ones
+ * that do not fit, and rebuilds the batched vertices. */
+static void
+gst_gl_overlay_compositor_update_gl (GstGLContext * context,
+    gpointer compositor_pointer)
+{
+  GstGLOverlayCompositor *compositor =
+      (GstGLOverlayCompositor *) compositor_pointer;
+  GstGLOverlayCompositorPrivate *priv =
+      gst_gl_overlay_compositor_get_instance_private (compositor);
+  gboolean repacked = FALSE;
+  guint n_uploaded = 0, n_atlas = 0;
+  GList *l;
+
+  if (!priv->atlas_tex)
+    _atlas_init (compositor);
+
+  for (l = compositor->overlays; l != NULL; l = l->next) {
+    GstGLCompositionOverlay *overlay = (GstGLCompositionOverlay *) l->data;
+    if (overlay->in_atlas)
+      n_atlas++;
+  }
+
+  /* everything that was in the atlas has gone away */
+  if (n_atlas == 0)
+    _atlas_reset (compositor);
+
+  l = compositor->overlays;
+  while (l != NULL) {
+    GstGLCompositionOverlay *overlay = (GstGLCompositionOverlay *) l->data;
+    GstBuffer *comp_buffer;
+    GstVideoMeta *vmeta;
+    guint x, y;
+
+    l = l->next;
+
+    if (!overlay->needs_upload)
+      continue;
+
+    comp_buffer = gst_gl_composition_overlay_get_pixels (overlay);
+    vmeta = gst_buffer_get_video_meta (comp_buffer);
+
+    if (n_atlas < MAX_BATCH_QUADS && _atlas_allocate (priv, vmeta->width,
+            vmeta->height, &x, &y)) {
+      if (gst_gl_composition_overlay_upload_to_atlas (overlay, comp_buffer,
+              priv->atlas_tex, priv->atlas_size, x, y)) {
+        overlay->needs_upload = FALSE;
+        n_uploaded++;
+        n_atlas++;
+        continue;
+      }
+    } else if (!repacked && priv->atlas_shelves->len > 0
+        && vmeta->width + ATLAS_PADDING <= priv->atlas_size
+        && vmeta->height + ATLAS_PADDING <= priv->atlas_size) {
+      GList *k;
+
+      /* the atlas is fragmented by overlays that have gone away, start
+       * over with only the current ones */
+      GST_DEBUG_OBJECT (compositor, "repacking overlay atlas");
+
+      _atlas_reset (compositor);
+      for (k = compositor->overlays; k != NULL; k = k->next) {
+        GstGLCompositionOverlay *o = (GstGLCompositionOverlay *) k->data;
+        if (o->in_atlas) {
+          o->in_atlas = FALSE;
+          o->needs_upload = TRUE;
+        }
+      }
+
+      repacked = TRUE;
+      n_atlas = 0;
+      l = compositor->overlays;
+      continue;
+    }
+
+    GST_DEBUG_OBJECT (compositor, "%ux%u overlay does not fit into the atlas",
+        vmeta->width, vmeta->height);
+    gst_gl_composition_overlay_upload (overlay, comp_buffer);
+    overlay->needs_upload = FALSE;
+    n_uploaded++;
+  }
+
+  _batch_update (compositor);
+
+  GST_LOG_OBJECT (compositor, "uploaded %u overlays, %u in atlas",
+      n_uploaded, n_atlas);
+}
+
 void
 gst_gl_overlay_compositor_free_overlays (GstGLOverlayCompositor * compositor)
 {
@@ -659,6 +1138,7 @@ gst_gl_overlay_compositor_upload_overlays (GstGLOverlayCompositor * compositor,
   GstVideoOverlayCompositionMeta *composition_meta;
   GstGLOverlayCompositorPrivate *priv =
       gst_gl_overlay_compositor_get_instance_private (compositor);
+  gboolean changed = FALSE;
 
   composition_meta = gst_buffer_get_video_overlay_composition_meta (buf);
   if (composition_meta) {
@@ -671,7 +1151,8 @@ gst_gl_overlay_compositor_upload_overlays (GstGLOverlayCompositor * compositor,
     composition = composition_meta->overlay;
     num_overlays = gst_video_overlay_composition_n_rectangles (composition);
 
-    /* add new overlays to list */
+    /* add new overlays to list, rectangles that were seen before (by seqnum)
+     * keep their texture */
     for (i = 0; i < num_overlays; i++) {
       GstVideoOverlayRectangle *rectangle =
           gst_video_overlay_composition_get_rectangle (composition, i);
@@ -683,9 +1164,10 @@ gst_gl_overlay_compositor_upload_overlays (GstGLOverlayCompositor * compositor,
         gst_object_ref_sink (overlay);
         overlay->yinvert = priv->yinvert;
 
-        gst_gl_composition_overlay_upload (overlay, buf);
+        gst_gl_composition_overlay_add_transformation (overlay, buf);
 
         compositor->overlays = g_list_append (compositor->overlays, overlay);
+        changed = TRUE;
       }
     }
 
@@ -696,12 +1178,18 @@ gst_gl_overlay_compositor_upload_overlays (GstGLOverlayCompositor * compositor,
       if (!_is_overlay_in_rectangles (composition, overlay)) {
         compositor->overlays = g_list_delete_link (compositor->overlays, l);
         gst_object_unref (overlay);
+        changed = TRUE;
       }
       l = next;
     }
   } else {
     gst_gl_overlay_compositor_free_overlays (compositor);
   }
+
+  /* only the changed overlays are uploaded */
+  if (changed)
+    gst_gl_context_thread_add (compositor->context,
+        gst_gl_overlay_compositor_update_gl, compositor);
 }
 
 void
@@ -709,6 +1197,8 @@ gst_gl_overlay_compositor_draw_overlays (GstGLOverlayCompositor * compositor)
 {
   const GstGLFuncs *gl = compositor->context->gl_vtable;
   if (compositor->overlays != NULL) {
+    gboolean run_premultiplied = FALSE;
+    guint run_start = 0, run_length = 0;
     GList *l;
 
     gl->Enable (GL_BLEND);
@@ -717,14 +1207,35 @@ gst_gl_overlay_compositor_draw_overlays (GstGLOverlayCompositor * compositor)
     gl->ActiveTexture (GL_TEXTURE0);
     gst_gl_shader_set_uniform_1i (compositor->shader, "tex", 0);
 
+    /* consecutive overlays in the atlas sharing a blend mode are drawn with
+     * a single call */
     for (l = compositor->overlays; l != NULL; l = l->next) {
       GstGLCompositionOverlay *overlay = (GstGLCompositionOverlay *) l->data;
-      GstVideoOverlayFormatFlags flags;
+      gboolean premultiplied;
+
+      premultiplied = gst_gl_composition_overlay_is_premultiplied (overlay);
+
+      if (overlay->in_atlas) {
+        if (run_length > 0 && premultiplied == run_premultiplied) {
+          run_length++;
+          continue;
+        }
 
-      flags = gst_video_overlay_rectangle_get_flags (overlay->rectangle);
+        if (run_length > 0)
+          _batch_draw (compositor, run_start, run_length, run_premultiplied);
 
-      if (flags & GST_VIDEO_OVERLAY_FORMAT_FLAG_PREMULTIPLIED_ALPHA
-          || !gl->BlendFuncSeparate) {
+        run_start = overlay->batch_index;
+        run_length = 1;
+        run_premultiplied = premultiplied;
+        continue;
+      }
+
+      if (run_length > 0) {
+        _batch_draw (compositor, run_start, run_length, run_premultiplied);
+        run_length = 0;
+      }
+
+      if (premultiplied) {
         gl->BlendFunc (GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
       } else {
         gl->BlendFuncSeparate (GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE,
@@ -733,6 +1244,12 @@ gst_gl_overlay_compositor_draw_overlays (GstGLOverlayCompositor * compositor)
       gst_gl_composition_overlay_draw (overlay, compositor->shader);
     }
 
+    if (run_length > 0)
+      _batch_draw (compositor, run_start, run_length, run_premultiplied);
+
+    if (gl->GenVertexArrays)
+      gl->BindVertexArray (0);
+
     gl->BindTexture (GL_TEXTURE_2D, 0);
     gl->Disable (GL_BLEND);
   }
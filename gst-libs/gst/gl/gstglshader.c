@@ -23,9 +23,12 @@
 #include "config.h"
 #endif
 
+#include <string.h>
+
 #include "gl.h"
 #include "gstglshader.h"
 #include "gstglsl_private.h"
+#include "gstgldisplay_private.h"
 
 /**
  * SECTION:gstglshader
@@ -38,6 +41,16 @@
 #define GLhandleARB GLuint
 #endif
 
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
 #define USING_OPENGL(context) (gst_gl_context_check_gl_version (context, GST_GL_API_OPENGL, 1, 0))
 #define USING_OPENGL3(context) (gst_gl_context_check_gl_version (context, GST_GL_API_OPENGL3, 3, 1))
 #define USING_GLES(context) (gst_gl_context_check_gl_version (context, GST_GL_API_GLES, 1, 0))
@@ -75,6 +88,10 @@ struct _GstGLShaderPrivate
 {
   GLhandleARB program_handle;
   GList *stages;
+  /* whether gst_gl_shader_link() goes through the program binary cache */
+  gboolean use_program_cache;
+  /* attribute and frag data bindings, part of the program cache key */
+  GString *link_state;
 
   gboolean linked;
   GHashTable *uniform_locations;
@@ -128,6 +145,7 @@ gst_gl_shader_finalize (GObject * object)
 
   priv->program_handle = 0;
   g_hash_table_destroy (priv->uniform_locations);
+  g_string_free (priv->link_state, TRUE);
 
   if (shader->context) {
     gst_object_unref (shader->context);
@@ -195,6 +213,7 @@ gst_gl_shader_init (GstGLShader * self)
   priv->linked = FALSE;
   priv->uniform_locations =
       g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  priv->link_state = g_string_new (NULL);
 }
 
 static int
@@ -384,6 +403,121 @@ gst_gl_shader_is_linked (GstGLShader * shader)
   return ret;
 }
 
+/* Program binaries are cached by the GstGLDisplay, keyed on everything that
+ * influences the result of linking the program */
+static gboolean
+_program_cache_supported (GstGLContext * context)
+{
+  const GstGLFuncs *gl = context->gl_vtable;
+  GLint n_formats = 0;
+
+  if (!gl->GetProgramBinary || !gl->ProgramBinary)
+    return FALSE;
+
+  gl->GetIntegerv (GL_NUM_PROGRAM_BINARY_FORMATS, &n_formats);
+
+  return n_formats > 0;
+}
+
+static gchar *
+_program_cache_key (GstGLShader * shader)
+{
+  GstGLShaderPrivate *priv = shader->priv;
+  const GstGLFuncs *gl = shader->context->gl_vtable;
+  GString *key = g_string_new (NULL);
+  gchar *api_str, *ret;
+  GList *l;
+
+  api_str =
+      gst_gl_api_to_string (gst_gl_context_get_gl_api (shader->context));
+  g_string_append_printf (key, "%s\n%s\n%s\n%s\n", api_str,
+      (const gchar *) gl->GetString (GL_VENDOR),
+      (const gchar *) gl->GetString (GL_RENDERER),
+      (const gchar *) gl->GetString (GL_VERSION));
+  g_free (api_str);
+
+  g_string_append (key, priv->link_state->str);
+  for (l = priv->stages; l; l = l->next)
+    _gst_glsl_stage_append_cache_key (l->data, key);
+
+  ret = g_compute_checksum_for_data (G_CHECKSUM_SHA1,
+      (const guchar *) key->str, key->len);
+  g_string_free (key, TRUE);
+
+  return ret;
+}
+
+/* cached binaries are stored as the 32-bit binary format followed by the
+ * binary itself */
+static gboolean
+_load_program_binary (GstGLShader * shader, const gchar * key)
+{
+  GstGLShaderPrivate *priv = shader->priv;
+  const GstGLFuncs *gl = shader->context->gl_vtable;
+  GLint status = GL_FALSE;
+  const guint8 *data;
+  guint32 format;
+  GBytes *binary;
+  gsize size;
+
+  binary = _gst_gl_display_lookup_program_binary (shader->context->display,
+      key);
+  if (!binary)
+    return FALSE;
+
+  data = g_bytes_get_data (binary, &size);
+  if (size > sizeof (format)) {
+    memcpy (&format, data, sizeof (format));
+    gl->ProgramBinary (priv->program_handle, format, data + sizeof (format),
+        size - sizeof (format));
+    priv->vtable.GetProgramiv (priv->program_handle, GL_LINK_STATUS, &status);
+  }
+  g_bytes_unref (binary);
+
+  if (status != GL_TRUE) {
+    GST_INFO_OBJECT (shader, "cached program binary %s was rejected", key);
+    return FALSE;
+  }
+
+  GST_DEBUG_OBJECT (shader, "created program %u from cached binary %s",
+      priv->program_handle, key);
+
+  return TRUE;
+}
+
+static void
+_store_program_binary (GstGLShader * shader, const gchar * key)
+{
+  GstGLShaderPrivate *priv = shader->priv;
+  const GstGLFuncs *gl = shader->context->gl_vtable;
+  GLsizei written = 0;
+  GLint length = 0;
+  GLenum format = 0;
+  guint32 format32;
+  guint8 *data;
+
+  priv->vtable.GetProgramiv (priv->program_handle, GL_PROGRAM_BINARY_LENGTH,
+      &length);
+  if (length <= 0)
+    return;
+
+  data = g_malloc (sizeof (format32) + length);
+  gl->GetProgramBinary (priv->program_handle, length, &written, &format,
+      data + sizeof (format32));
+  if (written <= 0) {
+    g_free (data);
+    return;
+  }
+
+  format32 = format;
+  memcpy (data, &format32, sizeof (format32));
+
+  GST_DEBUG_OBJECT (shader, "caching binary of program %u as %s",
+      priv->program_handle, key);
+  _gst_gl_display_store_program_binary (shader->context->display, key,
+      g_bytes_new_take (data, sizeof (format32) + written));
+}
+
 static gboolean
 _ensure_program (GstGLShader * shader)
 {
@@ -623,6 +757,32 @@ gst_gl_shader_compile_attach_stage (GstGLShader * shader, GstGLSLStage * stage,
   return TRUE;
 }
 
+/**
+ * gst_gl_shader_set_use_program_cache:
+ * @shader: a #GstGLShader
+ * @use_cache: whether to use the program binary cache
+ *
+ * Sets whether gst_gl_shader_link() first tries to create the program from
+ * a binary cached by the #GstGLDisplay of @shader, and stores the binary of
+ * the linked program there otherwise.  The stages are still compiled and
+ * attached as usual, only linking is skipped on a cache hit.  This has no
+ * effect if the OpenGL implementation does not support program binaries.
+ *
+ * Only use this for programs whose binary may be shared with other users of
+ * the display, e.g. programs built from fixed sources.  Disabled by default.
+ *
+ * Since: 1.18
+ */
+void
+gst_gl_shader_set_use_program_cache (GstGLShader * shader, gboolean use_cache)
+{
+  g_return_if_fail (GST_IS_GL_SHADER (shader));
+
+  GST_OBJECT_LOCK (shader);
+  shader->priv->use_program_cache = use_cache;
+  GST_OBJECT_UNLOCK (shader);
+}
+
 /**
  * gst_gl_shader_link:
  * @shader: a #GstGLShader
@@ -630,6 +790,13 @@ gst_gl_shader_compile_attach_stage (GstGLShader * shader, GstGLSLStage * stage,
  *
  * Links the current list of #GstGLSLStage's in @shader.
  *
+ * If the program binary cache was enabled with
+ * gst_gl_shader_set_use_program_cache(), the OpenGL implementation supports
+ * program binaries and a program with the same stages was linked before with
+ * a context of the same #GstGLDisplay (or, if GST_GL_PROGRAM_CACHE_DIR is set,
+ * by a previous process), the program is created from the cached binary
+ * instead of being linked again.
+ *
  * Note: must be called in the GL thread
  *
  * Returns: whether @shader could be linked together.
@@ -646,6 +813,7 @@ gst_gl_shader_link (GstGLShader * shader, GError ** error)
   gint len = 0;
   gboolean ret;
   GList *elem;
+  gchar *cache_key = NULL;
 
   g_return_val_if_fail (GST_IS_GL_SHADER (shader), FALSE);
 
@@ -675,10 +843,30 @@ gst_gl_shader_link (GstGLShader * shader, GError ** error)
 
   GST_TRACE ("shader created %u", shader->priv->program_handle);
 
+  if (priv->use_program_cache && _program_cache_supported (shader->context)) {
+    cache_key = _program_cache_key (shader);
+
+    if (_load_program_binary (shader, cache_key)) {
+      _gst_gl_display_record_program_cache_result (shader->context->display,
+          TRUE);
+      g_free (cache_key);
+      ret = priv->linked = TRUE;
+      GST_OBJECT_UNLOCK (shader);
+
+      g_object_notify (G_OBJECT (shader), "linked");
+
+      return ret;
+    }
+
+    _gst_gl_display_record_program_cache_result (shader->context->display,
+        FALSE);
+  }
+
   for (elem = shader->priv->stages; elem; elem = elem->next) {
     GstGLSLStage *stage = elem->data;
 
     if (!gst_glsl_stage_compile (stage, error)) {
+      g_free (cache_key);
       GST_OBJECT_UNLOCK (shader);
       return FALSE;
     }
@@ -687,11 +875,16 @@ gst_gl_shader_link (GstGLShader * shader, GError ** error)
       g_set_error (error, GST_GLSL_ERROR, GST_GLSL_ERROR_COMPILE,
           "Failed to attach shader %" GST_PTR_FORMAT "to program %"
           GST_PTR_FORMAT, stage, shader);
+      g_free (cache_key);
       GST_OBJECT_UNLOCK (shader);
       return FALSE;
     }
   }
 
+  if (cache_key && gl->ProgramParameteri)
+    gl->ProgramParameteri (priv->program_handle,
+        GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
   /* if nothing failed link shaders */
   gl->LinkProgram (priv->program_handle);
   status = GL_FALSE;
@@ -707,12 +900,18 @@ gst_gl_shader_link (GstGLShader * shader, GError ** error)
     g_set_error (error, GST_GLSL_ERROR, GST_GLSL_ERROR_LINK,
         "Shader Linking failed:\n%s", info_buffer);
     ret = priv->linked = FALSE;
+    g_free (cache_key);
     GST_OBJECT_UNLOCK (shader);
     return ret;
   } else if (len > 1) {
     GST_FIXME ("shader link log:\n%s\n", info_buffer);
   }
 
+  if (cache_key) {
+    _store_program_binary (shader, cache_key);
+    g_free (cache_key);
+  }
+
   ret = priv->linked = TRUE;
   GST_OBJECT_UNLOCK (shader);
 
@@ -1306,6 +1505,8 @@ gst_gl_shader_bind_attribute_location (GstGLShader * shader, GLuint index,
 
   shader->context->gl_vtable->BindAttribLocation (shader->priv->program_handle,
       index, name);
+  g_string_append_printf (shader->priv->link_state, "attrib %u %s\n", index,
+      name);
 }
 
 /**
@@ -1331,4 +1532,6 @@ gst_gl_shader_bind_frag_data_location (GstGLShader * shader,
 
   shader->context->gl_vtable->BindFragDataLocation (shader->priv->
       program_handle, index, name);
+  g_string_append_printf (shader->priv->link_state, "frag data %u %s\n",
+      index, name);
 }
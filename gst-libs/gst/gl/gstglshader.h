@@ -77,6 +77,9 @@ gboolean gst_gl_shader_compile_attach_stage         (GstGLShader * shader,
                                                      GstGLSLStage *stage,
                                                      GError ** error);
 GST_GL_API
+void     gst_gl_shader_set_use_program_cache        (GstGLShader * shader,
+                                                     gboolean use_cache);
+GST_GL_API
 gboolean gst_gl_shader_link                         (GstGLShader * shader, GError ** error);
 GST_GL_API
 gboolean gst_gl_shader_is_linked                    (GstGLShader *shader);
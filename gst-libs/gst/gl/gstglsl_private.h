@@ -63,6 +63,9 @@ G_GNUC_INTERNAL gchar *
 _gst_glsl_mangle_shader (const gchar * str, guint shader_type, GstGLTextureTarget from,
     GstGLTextureTarget to, GstGLContext * context, GstGLSLVersion * version, GstGLSLProfile * profile);
 
+G_GNUC_INTERNAL void
+_gst_glsl_stage_append_cache_key (GstGLSLStage * stage, GString * key);
+
 G_END_DECLS
 
 #endif /* __GST_GLSL_PRIVATE_H__ */
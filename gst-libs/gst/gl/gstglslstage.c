@@ -447,6 +447,21 @@ _maybe_prepend_version (GstGLSLStage * stage, gchar ** shader_str,
   *n_vertex_sources = n;
 }
 
+/* Appends everything that the result of compiling @stage depends on */
+void
+_gst_glsl_stage_append_cache_key (GstGLSLStage * stage, GString * key)
+{
+  GstGLSLStagePrivate *priv = stage->priv;
+  gint i;
+
+  g_string_append_printf (key, "stage %u %u %u %i\n", priv->type,
+      priv->version, priv->profile, priv->n_strings);
+  for (i = 0; i < priv->n_strings; i++) {
+    g_string_append (key, priv->strings[i]);
+    g_string_append_c (key, '\0');
+  }
+}
+
 struct compile
 {
   GstGLSLStage *stage;
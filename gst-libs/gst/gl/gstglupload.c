@@ -106,6 +106,8 @@ struct _GstGLUploadPrivate
 
   /* saved method for reconfigure */
   int saved_method_i;
+
+  gboolean reuse_textures;
 };
 
 #define DEBUG_INIT \
@@ -1143,8 +1145,163 @@ struct RawUpload
   GstGLUpload *upload;
   struct RawUploadFrame *in_frame;
   GstGLVideoAllocationParams *params;
+
+  /* with reuse-textures, copies of the textures of the last upload, reused
+   * when the same input memories are pushed again (e.g. a frozen frame).
+   * Only the input memories are referenced, not the input buffer. */
+  GstCaps *cached_caps;
+  GstMemory *cached_in_mems[GST_VIDEO_MAX_PLANES];
+  guint n_cached_in_mems;
+  gboolean cached_has_meta;
+  gsize cached_offset[GST_VIDEO_MAX_PLANES];
+  gint cached_stride[GST_VIDEO_MAX_PLANES];
+  GstMemory *cached_mems[GST_VIDEO_MAX_PLANES];
+  guint n_cached_mems;
+  gboolean cache_hit;
 };
 
+static void
+_raw_upload_cache_clear (struct RawUpload *raw)
+{
+  guint i;
+
+  for (i = 0; i < raw->n_cached_mems; i++) {
+    gst_memory_unlock (raw->cached_mems[i], GST_LOCK_FLAG_EXCLUSIVE);
+    gst_memory_unref (raw->cached_mems[i]);
+    raw->cached_mems[i] = NULL;
+  }
+  raw->n_cached_mems = 0;
+
+  for (i = 0; i < raw->n_cached_in_mems; i++) {
+    gst_memory_unlock (raw->cached_in_mems[i], GST_LOCK_FLAG_EXCLUSIVE);
+    gst_memory_unref (raw->cached_in_mems[i]);
+    raw->cached_in_mems[i] = NULL;
+  }
+  raw->n_cached_in_mems = 0;
+
+  gst_caps_replace (&raw->cached_caps, NULL);
+}
+
+/* A frozen frame is pushed as new buffers sharing the memories of the
+ * original one, a memory that only the input buffer holds is about to be
+ * recycled and rewritten by upstream and is not worth caching */
+static gboolean
+_raw_upload_memories_shared (GstBuffer * buffer)
+{
+  guint i, n_mem = gst_buffer_n_memory (buffer);
+
+  for (i = 0; i < n_mem; i++) {
+    if (gst_memory_is_writable (gst_buffer_peek_memory (buffer, i)))
+      return FALSE;
+  }
+
+  return n_mem > 0 && n_mem <= GST_VIDEO_MAX_PLANES;
+}
+
+static void
+_raw_upload_cache_store (struct RawUpload *raw, GstBuffer * inbuf,
+    GstBuffer * outbuf)
+{
+  guint i, n_mem = gst_buffer_n_memory (outbuf);
+  GstVideoMeta *meta;
+
+  _raw_upload_cache_clear (raw);
+
+  if (!raw->upload->priv->reuse_textures || !raw->upload->priv->in_caps
+      || n_mem > GST_VIDEO_MAX_PLANES || !_raw_upload_memories_shared (inbuf))
+    return;
+
+  /* The wrapped textures keep the input frame mapped, cache copies of them
+   * so that the input buffer goes back upstream as soon as downstream is
+   * done with it.  Uploading first makes the copy happen on the GPU.  The
+   * exclusive lock makes any downstream write map copy instead of modifying
+   * the cached content. */
+  for (i = 0; i < n_mem; i++) {
+    GstMemory *tex = gst_buffer_peek_memory (outbuf, i);
+    GstMemory *copy;
+    GstMapInfo map;
+
+    if (gst_memory_map (tex, &map, GST_MAP_READ | GST_MAP_GL))
+      gst_memory_unmap (tex, &map);
+
+    copy = gst_memory_copy (tex, 0, -1);
+    if (!copy) {
+      GST_DEBUG_OBJECT (raw->upload, "could not copy texture %u for reuse", i);
+      _raw_upload_cache_clear (raw);
+      return;
+    }
+
+    gst_memory_lock (copy, GST_LOCK_FLAG_EXCLUSIVE);
+    raw->cached_mems[i] = copy;
+    raw->n_cached_mems = i + 1;
+  }
+
+  /* A ref alone does not stop upstream from writing a new frame into the
+   * input memories once its buffer is recycled.  The exclusive lock keeps
+   * them read-only for as long as they are cached: write maps through a
+   * buffer copy the memory instead, and buffer pools drop buffers with
+   * memories that are not writable, so a match is always the same content. */
+  raw->n_cached_in_mems = gst_buffer_n_memory (inbuf);
+  for (i = 0; i < raw->n_cached_in_mems; i++) {
+    GstMemory *mem = gst_buffer_peek_memory (inbuf, i);
+
+    gst_memory_lock (mem, GST_LOCK_FLAG_EXCLUSIVE);
+    raw->cached_in_mems[i] = gst_memory_ref (mem);
+  }
+
+  meta = gst_buffer_get_video_meta (inbuf);
+  raw->cached_has_meta = meta != NULL;
+  if (meta) {
+    for (i = 0; i < meta->n_planes; i++) {
+      raw->cached_offset[i] = meta->offset[i];
+      raw->cached_stride[i] = meta->stride[i];
+    }
+  }
+
+  raw->cached_caps = gst_caps_ref (raw->upload->priv->in_caps);
+}
+
+static gboolean
+_raw_upload_cache_matches (struct RawUpload *raw, GstBuffer * buffer)
+{
+  GstVideoMeta *meta;
+  guint i, n_mem;
+
+  if (!raw->upload->priv->reuse_textures) {
+    _raw_upload_cache_clear (raw);
+    return FALSE;
+  }
+
+  if (!raw->n_cached_mems || !buffer)
+    return FALSE;
+
+  if (raw->cached_caps != raw->upload->priv->in_caps)
+    return FALSE;
+
+  n_mem = gst_buffer_n_memory (buffer);
+  if (n_mem != raw->n_cached_in_mems)
+    return FALSE;
+
+  for (i = 0; i < n_mem; i++) {
+    if (gst_buffer_peek_memory (buffer, i) != raw->cached_in_mems[i])
+      return FALSE;
+  }
+
+  meta = gst_buffer_get_video_meta (buffer);
+  if (!meta != !raw->cached_has_meta)
+    return FALSE;
+
+  if (meta) {
+    for (i = 0; i < meta->n_planes; i++) {
+      if (meta->offset[i] != raw->cached_offset[i]
+          || meta->stride[i] != raw->cached_stride[i])
+        return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
 static struct RawUploadFrame *
 _raw_upload_frame_new (struct RawUpload *raw, GstBuffer * buffer)
 {
@@ -1257,6 +1414,12 @@ _raw_data_upload_accept (gpointer impl, GstBuffer * buffer, GstCaps * in_caps,
 
   if (raw->in_frame)
     _raw_upload_frame_unref (raw->in_frame);
+  raw->in_frame = NULL;
+
+  raw->cache_hit = _raw_upload_cache_matches (raw, buffer);
+  if (raw->cache_hit)
+    return TRUE;
+
   raw->in_frame = _raw_upload_frame_new (raw, buffer);
 
   if (raw->params)
@@ -1288,6 +1451,18 @@ _raw_data_upload_perform (gpointer impl, GstBuffer * buffer,
   GstVideoInfo *in_info = &raw->upload->priv->in_info;
   guint n_mem = GST_VIDEO_INFO_N_PLANES (in_info);
 
+  if (raw->cache_hit) {
+    GST_TRACE_OBJECT (raw->upload, "reusing the textures of the previous "
+        "upload for buffer %" GST_PTR_FORMAT, buffer);
+
+    *outbuf = gst_buffer_new ();
+    for (i = 0; i < raw->n_cached_mems; i++)
+      gst_buffer_append_memory (*outbuf, gst_memory_ref (raw->cached_mems[i]));
+    raw->cache_hit = FALSE;
+
+    return GST_GL_UPLOAD_DONE;
+  }
+
   allocator =
       GST_GL_BASE_MEMORY_ALLOCATOR (gst_gl_memory_allocator_get_default
       (raw->upload->context));
@@ -1318,6 +1493,8 @@ _raw_data_upload_perform (gpointer impl, GstBuffer * buffer,
   }
   gst_object_unref (allocator);
 
+  _raw_upload_cache_store (raw, buffer, *outbuf);
+
   _raw_upload_frame_unref (raw->in_frame);
   raw->in_frame = NULL;
   return GST_GL_UPLOAD_DONE;
@@ -1331,6 +1508,10 @@ _raw_data_upload_free (gpointer impl)
   if (raw->params)
     gst_gl_allocation_params_free ((GstGLAllocationParams *) raw->params);
 
+  if (raw->in_frame)
+    _raw_upload_frame_unref (raw->in_frame);
+  _raw_upload_cache_clear (raw);
+
   g_free (raw);
 }
 
@@ -1754,6 +1935,30 @@ gst_gl_upload_set_context (GstGLUpload * upload, GstGLContext * context)
   gst_object_replace ((GstObject **) & upload->context, (GstObject *) context);
 }
 
+/**
+ * gst_gl_upload_set_reuse_textures:
+ * @upload: a #GstGLUpload
+ * @reuse: whether to reuse the textures of repeated frames
+ *
+ * When @reuse is %TRUE, uploading raw data keeps a copy of the textures of
+ * the last input buffer whose memories are shared with another buffer, as
+ * when a frozen frame is pushed repeatedly.  When the next input buffer
+ * carries the same memories, the copy is output again instead of uploading
+ * the data.  The input memories are referenced while cached, which keeps
+ * them read-only, but the input buffer itself is released as usual.
+ *
+ * The default is %FALSE.
+ *
+ * Since: 1.18
+ */
+void
+gst_gl_upload_set_reuse_textures (GstGLUpload * upload, gboolean reuse)
+{
+  g_return_if_fail (GST_IS_GL_UPLOAD (upload));
+
+  upload->priv->reuse_textures = reuse;
+}
+
 static void
 gst_gl_upload_finalize (GObject * object)
 {
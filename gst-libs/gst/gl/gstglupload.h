@@ -94,6 +94,10 @@ GST_GL_API
 void          gst_gl_upload_set_context            (GstGLUpload * upload,
                                                     GstGLContext * context);
 
+GST_GL_API
+void          gst_gl_upload_set_reuse_textures     (GstGLUpload * upload,
+                                                    gboolean reuse);
+
 GST_GL_API
 GstCaps *     gst_gl_upload_transform_caps         (GstGLUpload * upload,
                                                     GstGLContext * context,
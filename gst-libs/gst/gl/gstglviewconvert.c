@@ -1723,6 +1723,7 @@ _init_view_convert (GstGLViewConvert * viewconvert)
       offsets[0][0], offsets[0][1], offsets[1][0], offsets[1][1]);
 
   viewconvert->shader = gst_gl_shader_new (viewconvert->context);
+  gst_gl_shader_set_use_program_cache (viewconvert->shader, TRUE);
   {
     GstGLSLVersion version;
     GstGLSLProfile profile;
@@ -28,12 +28,685 @@
 
 #include <gst/audio/audio.h>
 
+#include <stdlib.h>
 #include <string.h>
 #include <math.h>
 
 GST_DEBUG_CATEGORY_EXTERN (riff_debug);
 #define GST_CAT_DEFAULT riff_debug
 
+/* Codecs whose caps and codec name only depend on the fourcc or format tag.
+ * Everything that needs the stream headers is handled in the switch
+ * statements of gst_riff_create_video_caps() and gst_riff_create_audio_caps()
+ * below, which fall back to these tables.
+ *
+ * The tables are sorted by the numerical value of the fourcc/format tag for
+ * binary search. The caps are parsed once on first use and copied for every
+ * caller from then on. */
+typedef struct
+{
+  guint32 fourcc;
+  const gchar *caps;
+  const gchar *codec_name;
+} RiffVideoCodec;
+
+typedef struct
+{
+  guint16 codec_id;
+  const gchar *caps;
+  const gchar *codec_name;
+  gboolean rate_chan;
+} RiffAudioCodec;
+
+static const RiffVideoCodec riff_video_codecs[] = {
+  {GST_MAKE_FOURCC (0x01, 0x00, 0x00, 0x10),
+      "video/mpeg, systemstream = (boolean) false, mpegversion = (int) 1",
+      "MPEG-1 video"},
+  {GST_MAKE_FOURCC (0x02, 0x00, 0x00, 0x10),
+      "video/mpeg, systemstream = (boolean) false, mpegversion = (int) 2",
+      "MPEG-2 video"},
+  {GST_MAKE_FOURCC ('Y', '8', ' ', ' '),
+      "video/x-raw, format = (string) GRAY8", "Uncompressed 8-bit monochrome"},
+  {GST_MAKE_FOURCC ('V', 'P', '3', ' '),
+      "video/x-vp3", "VP3"},
+  {GST_MAKE_FOURCC ('P', 'N', 'G', ' '),
+      "image/png", "PNG image"},
+  {GST_MAKE_FOURCC ('D', 'V', 'R', ' '),
+      "video/mpeg, systemstream = (boolean) false, mpegversion = (int) 2",
+      "MPEG-2 video"},
+  {GST_MAKE_FOURCC ('d', 'v', 'c', ' '),
+      "video/x-dv, systemstream = (boolean) false, dvversion = (int) 25",
+      "Generic DV"},
+  {GST_MAKE_FOURCC ('p', 'n', 'g', ' '),
+      "image/png", "PNG image"},
+  {GST_MAKE_FOURCC ('Y', '8', '0', '0'),
+      "video/x-raw, format = (string) GRAY8", "Uncompressed 8-bit monochrome"},
+  {GST_MAKE_FOURCC ('r', '2', '1', '0'),
+      "video/x-raw, format = (string) r210",
+      "Uncompressed packed RGB 10-bit 4:4:4"},
+  {GST_MAKE_FOURCC ('v', '2', '1', '0'),
+      "video/x-raw, format = (string) v210",
+      "Uncompressed packed 10-bit YUV 4:2:2"},
+  {GST_RIFF_I420,
+      "video/x-raw, format = (string) I420", "Uncompressed planar YUV 4:2:0"},
+  {GST_RIFF_i420,
+      "video/x-raw, format = (string) I420", "Uncompressed planar YUV 4:2:0"},
+  {GST_MAKE_FOURCC ('L', 'M', '2', '0'),
+      "video/x-mimic", "Mimic webcam"},
+  {GST_MAKE_FOURCC ('T', 'M', '2', '0'),
+      "video/x-truemotion, trueversion = (int) 2", "TrueMotion 2.0"},
+  {GST_MAKE_FOURCC ('V', 'P', '3', '0'),
+      "video/x-vp3", "VP3"},
+  {GST_MAKE_FOURCC ('v', 'p', '3', '0'),
+      "video/x-vp3", "VP3"},
+  {GST_MAKE_FOURCC ('V', 'P', '5', '0'),
+      "video/x-vp5", "On2 VP5"},
+  {GST_MAKE_FOURCC ('D', 'V', '5', '0'),
+      "video/x-dv, systemstream = (boolean) false, dvversion = (int) 50",
+      "DVCPro50 Video"},
+  {GST_RIFF_IV50,
+      "video/x-indeo, indeoversion = (int) 5", "Intel Video 5"},
+  {GST_MAKE_FOURCC ('D', 'X', '5', '0'),
+      "video/x-divx, divxversion = (int) 5", "DivX MPEG-4 Version 5"},
+  {GST_MAKE_FOURCC ('v', 'p', '5', '0'),
+      "video/x-vp5", "On2 VP5"},
+  {GST_MAKE_FOURCC ('d', 'v', '5', '0'),
+      "video/x-dv, systemstream = (boolean) false, dvversion = (int) 50",
+      "DVCPro50 Video"},
+  {GST_MAKE_FOURCC ('V', 'P', '6', '0'),
+      "video/x-vp6", "On2 VP6"},
+  {GST_MAKE_FOURCC ('v', 'p', '6', '0'),
+      "video/x-vp6", "On2 VP6"},
+  {GST_MAKE_FOURCC ('V', 'P', '7', '0'),
+      "video/x-vp7", "On2 VP7"},
+  {GST_MAKE_FOURCC ('v', 'p', '7', '0'),
+      "video/x-vp7", "On2 VP7"},
+  {GST_MAKE_FOURCC ('V', 'P', '8', '0'),
+      "video/x-vp8", "On2 VP8"},
+  {GST_MAKE_FOURCC ('C', 'O', 'L', '0'),
+      "video/x-divx, divxversion = (int) 3", "DivX MS-MPEG-4 Version 3"},
+  {GST_MAKE_FOURCC ('B', 'L', 'Z', '0'),
+      "video/x-divx, divxversion = (int) 4", "Blizzard DivX"},
+  {GST_MAKE_FOURCC ('c', 'o', 'l', '0'),
+      "video/x-divx, divxversion = (int) 3", "DivX MS-MPEG-4 Version 3"},
+  {GST_RIFF_RT21,
+      "video/x-indeo, indeoversion = (int) 2", "Intel Video 2"},
+  {GST_RIFF_rt21,
+      "video/x-indeo, indeoversion = (int) 2", "Intel Video 2"},
+  {GST_MAKE_FOURCC ('V', 'P', '3', '1'),
+      "video/x-vp3", "VP3"},
+  {GST_RIFF_IV31,
+      "video/x-indeo, indeoversion = (int) 3", "Intel Video 3"},
+  {GST_MAKE_FOURCC ('v', 'p', '3', '1'),
+      "video/x-vp3", "VP3"},
+  {GST_RIFF_iv31,
+      "video/x-indeo, indeoversion = (int) 3", "Intel Video 3"},
+  {GST_MAKE_FOURCC ('A', 'P', '4', '1'),
+      "video/x-divx, divxversion = (int) 3", "DivX MS-MPEG-4 Version 3"},
+  {GST_MAKE_FOURCC ('M', 'P', '4', '1'),
+      "video/x-msmpeg, msmpegversion = (int) 41", "Microsoft MPEG-4 4.1"},
+  {GST_RIFF_IV41,
+      "video/x-indeo, indeoversion = (int) 4", "Intel Video 4"},
+  {GST_MAKE_FOURCC ('m', 'p', '4', '1'),
+      "video/x-msmpeg, msmpegversion = (int) 41", "Microsoft MPEG-4 4.1"},
+  {GST_RIFF_iv41,
+      "video/x-indeo, indeoversion = (int) 4", "Intel Video 4"},
+  {GST_MAKE_FOURCC ('V', 'P', '6', '1'),
+      "video/x-vp6", "On2 VP6"},
+  {GST_MAKE_FOURCC ('v', 'p', '6', '1'),
+      "video/x-vp6", "On2 VP6"},
+  {GST_RIFF_DMB1,
+      "image/jpeg", "Motion JPEG"},
+  {GST_MAKE_FOURCC ('A', 'V', 'C', '1'),
+      "video/x-h264, variant = (string) itu", "ITU H.264"},
+  {GST_MAKE_FOURCC ('W', 'V', 'C', '1'),
+      "video/x-wmv, wmvversion = (int) 3, format = (string) WVC1",
+      "Microsoft Windows Media VC-1"},
+  {GST_MAKE_FOURCC ('M', 'P', 'G', '1'),
+      "video/mpeg, systemstream = (boolean) false, mpegversion = (int) 1",
+      "MPEG-1 video"},
+  {GST_MAKE_FOURCC ('C', 'O', 'L', '1'),
+      "video/x-divx, divxversion = (int) 3", "DivX MS-MPEG-4 Version 3"},
+  {GST_MAKE_FOURCC ('P', 'I', 'M', '1'),
+      "video/mpeg, systemstream = (boolean) false, mpegversion = (int) 1",
+      "MPEG-1 video"},
+  {GST_MAKE_FOURCC ('V', 'C', 'R', '1'),
+      "video/x-ati-vcr, vcrversion = (int) 1", "ATI VCR 1"},
+  {GST_MAKE_FOURCC ('F', 'P', 'S', '1'),
+      "video/x-fraps", "Fraps video"},
+  {GST_MAKE_FOURCC ('M', 'S', 'S', '1'),
+      "video/x-wmv, wmvversion = (int) 1, format = (string) MSS1",
+      "Microsoft Windows Media 7 Screen"},
+  {GST_MAKE_FOURCC ('F', 'F', 'V', '1'),
+      "video/x-ffv, ffvversion = (int) 1", "FFmpeg lossless video codec"},
+  {GST_MAKE_FOURCC ('3', 'I', 'V', '1'),
+      "video/mpeg, mpegversion = (int) 4, systemstream = (boolean) false",
+      "MPEG-4"},
+  {GST_MAKE_FOURCC ('F', 'L', 'V', '1'),
+      "video/x-flash-video, flvversion = (int) 1", "Flash Video 1"},
+  {GST_MAKE_FOURCC ('W', 'M', 'V', '1'),
+      "video/x-wmv, wmvversion = (int) 1", "Microsoft Windows Media 7"},
+  {GST_MAKE_FOURCC ('A', 'S', 'V', '1'),
+      "video/x-asus, asusversion = (int) 1", "Asus Video 1"},
+  {GST_RIFF_dmb1,
+      "image/jpeg", "Motion JPEG"},
+  {GST_MAKE_FOURCC ('a', 'v', 'c', '1'),
+      "video/x-h264, variant = (string) itu", "ITU H.264"},
+  {GST_MAKE_FOURCC ('m', 'p', 'g', '1'),
+      "video/mpeg, systemstream = (boolean) false, mpegversion = (int) 1",
+      "MPEG-1 video"},
+  {GST_MAKE_FOURCC ('c', 'o', 'l', '1'),
+      "video/x-divx, divxversion = (int) 3", "DivX MS-MPEG-4 Version 3"},
+  {GST_MAKE_FOURCC ('v', 'i', 'v', '1'),
+      "video/x-h263, variant = (string) itu", "ITU H.26n"},
+  {GST_RIFF_YV12,
+      "video/x-raw, format = (string) YV12", "Uncompressed packed YVU 4:2:2"},
+  {GST_RIFF_yv12,
+      "video/x-raw, format = (string) YV12", "Uncompressed packed YVU 4:2:2"},
+  {GST_RIFF_IV32,
+      "video/x-indeo, indeoversion = (int) 3", "Intel Video 3"},
+  {GST_RIFF_iv32,
+      "video/x-indeo, indeoversion = (int) 3", "Intel Video 3"},
+  {GST_MAKE_FOURCC ('M', 'P', '4', '2'),
+      "video/x-msmpeg, msmpegversion = (int) 42", "Microsoft MPEG-4 4.2"},
+  {GST_MAKE_FOURCC ('m', 'p', '4', '2'),
+      "video/x-msmpeg, msmpegversion = (int) 42", "Microsoft MPEG-4 4.2"},
+  {GST_MAKE_FOURCC ('V', 'P', '6', '2'),
+      "video/x-vp6", "On2 VP6"},
+  {GST_MAKE_FOURCC ('V', 'p', '6', '2'),
+      "video/x-vp6", "On2 VP6"},
+  {GST_MAKE_FOURCC ('T', 'S', 'C', '2'),
+      "video/x-tscc, tsccversion = (int) 2", "TechSmith Screen Capture 2"},
+  {GST_MAKE_FOURCC ('M', 'P', 'G', '2'),
+      "video/mpeg, systemstream = (boolean) false, mpegversion = (int) 2",
+      "MPEG-2 video"},
+  {GST_MAKE_FOURCC ('P', 'I', 'M', '2'),
+      "video/mpeg, systemstream = (boolean) false, mpegversion = (int) 2",
+      "MPEG-2 video"},
+  {GST_MAKE_FOURCC ('L', 'M', 'P', '2'),
+      "video/mpeg, systemstream = (boolean) false, mpegversion = (int) 2",
+      "Lead MPEG-2 video"},
+  {GST_MAKE_FOURCC ('V', 'C', 'R', '2'),
+      "video/x-ati-vcr, vcrversion = (int) 2", "ATI VCR 2"},
+  {GST_MAKE_FOURCC ('M', '4', 'S', '2'),
+      "video/mpeg, mpegversion = (int) 4, systemstream = (boolean) false",
+      "Microsoft ISO MPEG-4 1.1"},
+  {GST_MAKE_FOURCC ('M', 'S', 'S', '2'),
+      "video/x-wmv, wmvversion = (int) 3, format = (string) MSS2",
+      "Microsoft Windows Media 9 Screen"},
+  {GST_MAKE_FOURCC ('3', 'I', 'V', '2'),
+      "video/mpeg, mpegversion = (int) 4, systemstream = (boolean) false",
+      "MPEG-4"},
+  {GST_MAKE_FOURCC ('W', 'M', 'V', '2'),
+      "video/x-wmv, wmvversion = (int) 2", "Microsoft Windows Media 8"},
+  {GST_MAKE_FOURCC ('A', 'S', 'V', '2'),
+      "video/x-asus, asusversion = (int) 2", "Asus Video 2"},
+  {GST_RIFF_YUY2,
+      "video/x-raw, format = (string) YUY2", "Uncompressed packed YUV 4:2:2"},
+  {GST_MAKE_FOURCC ('t', 's', 'c', '2'),
+      "video/x-tscc, tsccversion = (int) 2", "TechSmith Screen Capture 2"},
+  {GST_MAKE_FOURCC ('m', 'p', 'g', '2'),
+      "video/mpeg, systemstream = (boolean) false, mpegversion = (int) 2",
+      "MPEG-2 video"},
+  {GST_RIFF_yuy2,
+      "video/x-raw, format = (string) YUY2", "Uncompressed packed YUV 4:2:2"},
+  {GST_MAKE_FOURCC ('M', 'P', '4', '3'),
+      "video/x-msmpeg, msmpegversion = (int) 43", "Microsoft MPEG-4 4.3"},
+  {GST_MAKE_FOURCC ('m', 'p', '4', '3'),
+      "video/x-msmpeg, msmpegversion = (int) 43", "Microsoft MPEG-4 4.3"},
+  {GST_MAKE_FOURCC ('S', 'P', '5', '3'),
+      "video/sp5x", "Sp5x-like JPEG"},
+  {GST_RIFF_H263,
+      "video/x-h263, variant = (string) itu", "ITU H.26n"},
+  /* apparently not standard H.263...? */
+  {GST_MAKE_FOURCC ('I', '2', '6', '3'),
+      "video/x-intel-h263, variant = (string) intel", "Intel H.263"},
+  {GST_RIFF_M263,
+      "video/x-h263, variant = (string) microsoft", "Microsoft H.263"},
+  {GST_MAKE_FOURCC ('T', '2', '6', '3'),
+      "video/x-h263, variant = (string) itu", "ITU H.26n"},
+  {GST_MAKE_FOURCC ('U', '2', '6', '3'),
+      "video/x-h263, variant = (string) itu", "ITU H.26n"},
+  {GST_RIFF_h263,
+      "video/x-h263, variant = (string) itu", "ITU H.26n"},
+  {GST_RIFF_i263,
+      "video/x-h263, variant = (string) itu", "ITU H.26n"},
+  {GST_RIFF_m263,
+      "video/x-h263, variant = (string) microsoft", "Microsoft H.263"},
+  {GST_RIFF_x263,
+      "video/x-h263, variant = (string) xirlink", "Xirlink H.263"},
+  {GST_MAKE_FOURCC ('M', 'P', 'G', '3'),
+      "video/x-divx, divxversion = (int) 3", "DivX MS-MPEG-4 Version 3"},
+  {GST_MAKE_FOURCC ('M', '4', 'T', '3'),
+      "video/mpeg, mpegversion = (int) 4, systemstream = (boolean) false",
+      "MPEG-4"},
+  {GST_RIFF_DIV3,
+      "video/x-divx, divxversion = (int) 3", "DivX MS-MPEG-4 Version 3"},
+  {GST_MAKE_FOURCC ('W', 'M', 'V', '3'),
+      "video/x-wmv, wmvversion = (int) 3, format = (string) WMV3",
+      "Microsoft Windows Media 9"},
+  {GST_MAKE_FOURCC ('D', 'V', 'X', '3'),
+      "video/x-divx, divxversion = (int) 3", "DivX MS-MPEG-4 Version 3"},
+  {GST_MAKE_FOURCC ('m', 'p', 'g', '3'),
+      "video/x-divx, divxversion = (int) 3", "DivX MS-MPEG-4 Version 3"},
+  {GST_MAKE_FOURCC ('d', 'i', 'v', '3'),
+      "video/x-divx, divxversion = (int) 3", "DivX MS-MPEG-4 Version 3"},
+  {GST_MAKE_FOURCC ('d', 'v', 'x', '3'),
+      "video/x-divx, divxversion = (int) 3", "DivX MS-MPEG-4 Version 3"},
+  {GST_MAKE_FOURCC ('S', 'P', '5', '4'),
+      "video/sp5x", "Sp5x-like JPEG"},
+  {GST_MAKE_FOURCC ('H', '2', '6', '4'),
+      "video/x-h264, variant = (string) itu", "ITU H.264"},
+  {GST_MAKE_FOURCC ('X', '2', '6', '4'),
+      "video/x-h264, variant = (string) itu", "ITU H.264"},
+  {GST_MAKE_FOURCC ('h', '2', '6', '4'),
+      "video/x-h264, variant = (string) itu", "ITU H.264"},
+  {GST_MAKE_FOURCC ('x', '2', '6', '4'),
+      "video/x-h264, variant = (string) itu", "ITU H.264"},
+  {GST_MAKE_FOURCC ('M', 'P', 'G', '4'),
+      "video/x-msmpeg, msmpegversion = (int) 41", "Microsoft MPEG-4 4.1"},
+  {GST_MAKE_FOURCC ('F', 'M', 'P', '4'),
+      "video/mpeg, mpegversion = (int) 4, systemstream = (boolean) false",
+      "FFmpeg MPEG-4"},
+  {GST_MAKE_FOURCC ('R', 'M', 'P', '4'),
+      "video/mpeg, mpegversion = (int) 4, systemstream = (boolean) false",
+      "MPEG-4"},
+  {GST_MAKE_FOURCC ('S', 'M', 'P', '4'),
+      "video/mpeg, mpegversion = (int) 4, systemstream = (boolean) false",
+      "MPEG-4"},
+  {GST_MAKE_FOURCC ('U', 'M', 'P', '4'),
+      "video/mpeg, mpegversion = (int) 4, systemstream = (boolean) false",
+      "FFmpeg MPEG-4"},
+  {GST_MAKE_FOURCC ('D', 'I', 'V', '4'),
+      "video/x-divx, divxversion = (int) 3", "DivX MS-MPEG-4 Version 3"},
+  {GST_MAKE_FOURCC ('F', 'L', 'V', '4'),
+      "video/x-vp6-flash", "On2 VP6"},
+  {GST_MAKE_FOURCC ('d', 'i', 'v', '4'),
+      "video/x-divx, divxversion = (int) 3", "DivX MS-MPEG-4 Version 3"},
+  {GST_MAKE_FOURCC ('d', 'v', '2', '5'),
+      "video/x-dv, systemstream = (boolean) false, dvversion = (int) 25",
+      "Generic DV"},
+  {GST_MAKE_FOURCC ('S', 'P', '5', '5'),
+      "video/sp5x", "Sp5x-like JPEG"},
+  {GST_MAKE_FOURCC ('D', 'I', 'V', '5'),
+      "video/x-divx, divxversion = (int) 3", "DivX MS-MPEG-4 Version 3"},
+  {GST_MAKE_FOURCC ('d', 'i', 'v', '5'),
+      "video/x-divx, divxversion = (int) 3", "DivX MS-MPEG-4 Version 3"},
+  {GST_MAKE_FOURCC ('S', 'P', '5', '6'),
+      "video/sp5x", "Sp5x-like JPEG"},
+  {GST_MAKE_FOURCC ('D', 'I', 'V', '6'),
+      "video/x-divx, divxversion = (int) 3", "DivX MS-MPEG-4 Version 3"},
+  {GST_MAKE_FOURCC ('d', 'i', 'v', '6'),
+      "video/x-divx, divxversion = (int) 3", "DivX MS-MPEG-4 Version 3"},
+  {GST_MAKE_FOURCC ('S', 'P', '5', '7'),
+      "video/sp5x", "Sp5x-like JPEG"},
+  {GST_MAKE_FOURCC ('S', 'P', '5', '8'),
+      "video/sp5x", "Sp5x-like JPEG"},
+  {GST_RIFF_YVU9,
+      "video/x-raw, format = (string) YVU9", "Uncompressed packed YVU 4:1:0"},
+  {GST_MAKE_FOURCC ('E', 'M', '4', 'A'),
+      "video/mpeg, mpegversion = (int) 4, systemstream = (boolean) false",
+      "MPEG-4"},
+  {GST_MAKE_FOURCC ('D', 'X', 'S', 'A'),
+      "subpicture/x-xsub", "XSUB subpicture stream"},
+  {GST_MAKE_FOURCC ('W', 'M', 'V', 'A'),
+      "video/x-wmv, wmvversion = (int) 3, format = (string) WMVA",
+      "Microsoft Windows Media Advanced Profile"},
+  {GST_MAKE_FOURCC ('R', 'P', 'Z', 'A'),
+      "video/x-apple-video", "Apple Video (RPZA)"},
+  {GST_MAKE_FOURCC ('Z', 'L', 'I', 'B'),
+      "video/x-zlib", "Lossless zlib video"},
+  {GST_MAKE_FOURCC ('D', 'X', 'S', 'B'),
+      "subpicture/x-xsub", "XSUB subpicture stream"},
+  {GST_MAKE_FOURCC ('M', '4', 'C', 'C'),
+      "video/mpeg, mpegversion = (int) 4, systemstream = (boolean) false",
+      "Divio MPEG-4"},
+  {GST_MAKE_FOURCC ('I', 'N', 'M', 'C'),
+      "video/mpeg, mpegversion = (int) 4, systemstream = (boolean) false",
+      "MPEG-4"},
+  {GST_MAKE_FOURCC ('A', 'A', 'S', 'C'),
+      "video/x-aasc", "Autodesk Animator"},
+  {GST_MAKE_FOURCC ('C', 'D', 'V', 'C'),
+      "video/x-dv, systemstream = (boolean) false, dvversion = (int) 25",
+      "Canopus DV"},
+  {GST_MAKE_FOURCC ('K', 'M', 'V', 'C'),
+      "video/x-kmvc", "Karl Morton's video codec"},
+  {GST_MAKE_FOURCC ('H', 'D', 'Y', 'C'),
+      "video/x-raw, format = (string) UYVY", "Uncompressed packed YUV 4:2:2"},
+  {GST_RIFF_CVID,
+      "video/x-cinepak", "Cinepak video"},
+  {GST_MAKE_FOURCC ('X', 'V', 'I', 'D'),
+      "video/mpeg, mpegversion = (int) 4, systemstream = (boolean) false",
+      "MPEG-4"},
+  {GST_MAKE_FOURCC ('D', 'C', 'O', 'D'),
+      "video/mpeg, mpegversion = (int) 4, systemstream = (boolean) false",
+      "MPEG-4"},
+  {GST_MAKE_FOURCC ('D', 'V', 'S', 'D'),
+      "video/x-dv, systemstream = (boolean) false, dvversion = (int) 25",
+      "Generic DV"},
+  {GST_MAKE_FOURCC ('3', 'I', 'V', 'D'),
+      "video/x-msmpeg, msmpegversion = (int) 43", "Microsoft MPEG-4 4.3"},
+  {GST_MAKE_FOURCC ('V', 'P', '6', 'F'),
+      "video/x-vp6-flash", "On2 VP6"},
+  {GST_MAKE_FOURCC ('S', 'E', 'D', 'G'),
+      "video/mpeg, mpegversion = (int) 4, systemstream = (boolean) false",
+      "Samsung MPEG-4"},
+  {GST_RIFF_JPEG,
+      "image/jpeg", "JPEG Still Image"},
+  {GST_MAKE_FOURCC ('M', 'P', 'E', 'G'),
+      "video/mpeg, systemstream = (boolean) false, mpegversion = (int) 1",
+      "MPEG-1 video"},
+  {GST_MAKE_FOURCC ('M', 'P', 'N', 'G'),
+      "image/png", "PNG image"},
+  {GST_MAKE_FOURCC ('C', 'J', 'P', 'G'),
+      "image/jpeg", "Creative Webcam JPEG"},
+  {GST_RIFF_IJPG,
+      "image/jpeg", "Motion JPEG"},
+  {GST_RIFF_MJPG,
+      "image/jpeg", "Motion JPEG"},
+  {GST_RIFF_mJPG,
+      "image/jpeg", "Motion JPEG"},
+  {GST_MAKE_FOURCC ('Q', 'I', 'V', 'G'),
+      "image/jpeg", "Motion JPEG"},
+  {GST_RIFF_VSSH,
+      "video/x-h264, variant = (string) videosoft", "VideoSoft H.264"},
+  {GST_MAKE_FOURCC ('E', 'P', 'V', 'H'),
+      "video/mpeg, mpegversion = (int) 4, systemstream = (boolean) false",
+      "MPEG-4"},
+  {GST_MAKE_FOURCC ('M', 'S', 'Z', 'H'),
+      "video/x-mszh", "Lossless MSZH Video"},
+  {GST_MAKE_FOURCC ('D', 'I', 'G', 'I'),
+      "video/mpeg, mpegversion = (int) 4, systemstream = (boolean) false",
+      "MPEG-4"},
+  {GST_MAKE_FOURCC ('M', 'P', 'G', 'I'),
+      "video/mpeg, systemstream = (boolean) false, mpegversion = (int) 1",
+      "MPEG-1 video"},
+  {GST_RIFF_ULTI,
+      "video/x-ultimotion", "IBM UltiMotion"},
+  {GST_MAKE_FOURCC ('S', 'L', 'M', 'J'),
+      "image/jpeg", "SL Motion JPEG"},
+  {GST_MAKE_FOURCC ('V', 'X', '1', 'K'),
+      "video/x-h263, variant = (string) lucent", "Lucent VX1000S H.263"},
+  {GST_MAKE_FOURCC ('D', 'M', '2', 'K'),
+      "video/mpeg, mpegversion = (int) 4, systemstream = (boolean) false",
+      "MPEG-4"},
+  {GST_MAKE_FOURCC ('D', 'U', 'C', 'K'),
+      "video/x-truemotion, trueversion = (int) 1", "Duck Truemotion1"},
+  {GST_MAKE_FOURCC ('J', 'P', 'G', 'L'),
+      "image/jpeg", "Pegasus Lossless JPEG"},
+  {GST_MAKE_FOURCC ('P', 'I', 'X', 'L'),
+      "image/jpeg", "Miro/Pinnacle Motion JPEG"},
+  {GST_RIFF_VIXL,
+      "image/jpeg", "Miro/Pinnacle Motion JPEG"},
+  {GST_MAKE_FOURCC ('V', 'I', 'D', 'M'),
+      "video/mpeg, mpegversion = (int) 4, systemstream = (boolean) false",
+      "MPEG-4"},
+  {GST_MAKE_FOURCC ('D', 'X', 'G', 'M'),
+      "video/mpeg, mpegversion = (int) 4, systemstream = (boolean) false",
+      "MPEG-4"},
+  {GST_MAKE_FOURCC ('M', 'V', 'X', 'M'),
+      "video/mpeg, mpegversion = (int) 4, systemstream = (boolean) false",
+      "MPEG-4"},
+  {GST_MAKE_FOURCC ('L', 'O', 'C', 'O'),
+      "video/x-loco", "LOCO Lossless"},
+  {GST_MAKE_FOURCC ('T', 'H', 'E', 'O'),
+      "video/x-theora", "Theora video codec"},
+  {GST_MAKE_FOURCC ('V', 'I', 'V', 'O'),
+      "video/x-h263, variant = (string) vivo", "Vivo H.263"},
+  {GST_MAKE_FOURCC ('C', 'L', 'J', 'R'),
+      "video/x-cirrus-logic-accupak", "Cirrus Logipak AccuPak"},
+  {GST_MAKE_FOURCC ('M', 'P', '4', 'S'),
+      "video/mpeg, mpegversion = (int) 4, systemstream = (boolean) false",
+      "Microsoft ISO MPEG-4 1.1"},
+  {GST_MAKE_FOURCC ('F', 'F', 'D', 'S'),
+      "video/mpeg, mpegversion = (int) 4, systemstream = (boolean) false",
+      "FFmpeg MPEG-4"},
+  {GST_MAKE_FOURCC ('P', 'M', '4', 'V'),
+      "video/mpeg, mpegversion = (int) 4, systemstream = (boolean) false",
+      "MPEG-4"},
+  {GST_MAKE_FOURCC ('M', 'P', '4', 'V'),
+      "video/mpeg, mpegversion = (int) 4, systemstream = (boolean) false",
+      "MPEG-4"},
+  {GST_MAKE_FOURCC ('Z', 'M', 'B', 'V'),
+      "video/x-zmbv", "Zip Motion Block video"},
+  {GST_MAKE_FOURCC ('A', 'C', 'D', 'V'),
+      "image/jpeg", "Motion JPEG"},
+  {GST_MAKE_FOURCC ('Y', 'U', 'N', 'V'),
+      "video/x-raw, format = (string) YUY2", "Uncompressed packed YUV 4:2:2"},
+  {GST_RIFF_CYUV,
+      "video/x-compressed-yuv", "CYUV Lossless"},
+  {GST_RIFF_IYUV,
+      "video/x-raw, format = (string) I420", "Uncompressed planar YUV 4:2:0"},
+  {GST_MAKE_FOURCC ('Y', 'U', 'Y', 'V'),
+      "video/x-raw, format = (string) YUY2", "Uncompressed packed YUV 4:2:2"},
+  {GST_MAKE_FOURCC ('F', 'V', 'F', 'W'),
+      "video/mpeg, mpegversion = (int) 4, systemstream = (boolean) false",
+      "MPEG-4"},
+  {GST_RIFF_VDOW,
+      "video/x-h263, variant = (string) vdolive", "VDOLive"},
+  {GST_MAKE_FOURCC ('G', 'E', 'O', 'X'),
+      "video/mpeg, mpegversion = (int) 4, systemstream = (boolean) false",
+      "MPEG-4"},
+  {GST_MAKE_FOURCC ('D', 'I', 'V', 'X'),
+      "video/x-divx, divxversion = (int) 4", "DivX MPEG-4 Version 4"},
+  {GST_MAKE_FOURCC ('G', 'R', 'E', 'Y'),
+      "video/x-raw, format = (string) GRAY8", "Uncompressed 8-bit monochrome"},
+  {GST_MAKE_FOURCC ('U', 'Y', 'V', 'Y'),
+      "video/x-raw, format = (string) UYVY", "Uncompressed packed YUV 4:2:2"},
+  {GST_MAKE_FOURCC ('P', 'V', 'E', 'Z'),
+      "video/x-truemotion, trueversion = (int) 1", "Duck Truemotion1"},
+  {GST_RIFF_rpza,
+      "video/x-apple-video", "Apple Video (RPZA)"},
+  {GST_MAKE_FOURCC ('d', 'r', 'a', 'c'),
+      "video/x-dirac", "Dirac"},
+  {GST_MAKE_FOURCC ('c', 'd', 'v', 'c'),
+      "video/x-dv, systemstream = (boolean) false, dvversion = (int) 25",
+      "Canopus DV"},
+  {GST_RIFF_cvid,
+      "video/x-cinepak", "Cinepak video"},
+  {GST_MAKE_FOURCC ('x', 'v', 'i', 'd'),
+      "video/mpeg, mpegversion = (int) 4, systemstream = (boolean) false",
+      "MPEG-4"},
+  {GST_MAKE_FOURCC ('d', 'v', 's', 'd'),
+      "video/x-dv, systemstream = (boolean) false, dvversion = (int) 25",
+      "Generic DV"},
+  {GST_MAKE_FOURCC ('3', 'i', 'v', 'd'),
+      "video/x-msmpeg, msmpegversion = (int) 43", "Microsoft MPEG-4 4.3"},
+  {GST_MAKE_FOURCC ('v', 'p', '6', 'f'),
+      "video/x-vp6-flash", "On2 VP6"},
+  {GST_MAKE_FOURCC ('j', 'p', 'e', 'g'),
+      "image/jpeg", "JPEG Still Image"},
+  {GST_MAKE_FOURCC ('m', 'p', 'n', 'g'),
+      "image/png", "PNG image"},
+  {GST_MAKE_FOURCC ('i', 'j', 'p', 'g'),
+      "image/jpeg", "Motion JPEG"},
+  {GST_RIFF_ulti,
+      "video/x-ultimotion", "IBM UltiMotion"},
+  {GST_RIFF_vixl,
+      "image/jpeg", "Miro/Pinnacle Motion JPEG"},
+  {GST_MAKE_FOURCC ('A', 'V', 'R', 'n'),
+      "image/jpeg", "Motion JPEG"},
+  {GST_MAKE_FOURCC ('X', 'x', 'a', 'n'),
+      "video/x-xan, wcversion = (int) 4", "Xan Wing Commander 4"},
+  {GST_MAKE_FOURCC ('t', 'h', 'e', 'o'),
+      "video/x-theora", "Theora video codec"},
+  {GST_MAKE_FOURCC ('c', 'l', 'j', 'r'),
+      "video/x-cirrus-logic-accupak", "Cirrus Logipak AccuPak"},
+  {GST_RIFF_azpr,
+      "video/x-apple-video", "Apple Video (RPZA)"},
+  {GST_MAKE_FOURCC ('m', 'p', '4', 'v'),
+      "video/mpeg, mpegversion = (int) 4, systemstream = (boolean) false",
+      "MPEG-4"},
+  {GST_RIFF_cyuv,
+      "video/x-compressed-yuv", "CYUV Lossless"},
+  {GST_MAKE_FOURCC ('d', 'i', 'v', 'x'),
+      "video/x-divx, divxversion = (int) 4", "DivX MPEG-4 Version 4"},
+  {GST_MAKE_FOURCC ('2', 'v', 'u', 'y'),
+      "video/x-raw, format = (string) UYVY", "Uncompressed packed YUV 4:2:2"},
+  {GST_RIFF_jpeg,
+      "image/jpeg", "JPEG Still Image"},
+};
+
+static const RiffAudioCodec riff_audio_codecs[] = {
+  {GST_RIFF_WAVE_FORMAT_DSP_TRUESPEECH,
+      "audio/x-truespeech", "DSP Group TrueSpeech", TRUE},
+  {GST_RIFF_WAVE_FORMAT_GSM610,
+      "audio/ms-gsm", "MS GSM audio", TRUE},
+  {GST_RIFF_WAVE_FORMAT_MSN,
+      "audio/ms-gsm", "MS GSM audio", TRUE},
+  {GST_RIFF_WAVE_FORMAT_MPEGL12,
+      "audio/mpeg, mpegversion = (int) 1, layer = (int) 2",
+      "MPEG-1 layer 2", TRUE},
+  {GST_RIFF_WAVE_FORMAT_MPEGL3,
+      "audio/mpeg, mpegversion = (int) 1, layer = (int) 3",
+      "MPEG-1 layer 3", TRUE},
+  {GST_RIFF_WAVE_FORMAT_AMR_NB,
+      "audio/AMR", "AMR Narrow Band (NB)", TRUE},
+  {GST_RIFF_WAVE_FORMAT_AMR_WB,
+      "audio/AMR-WB", "AMR Wide Band (WB)", TRUE},
+  {GST_RIFF_WAVE_FORMAT_ADPCM_IMA_DK4,
+      "audio/x-adpcm, layout = (string) dk4", "IMA/DK4 ADPCM", TRUE},
+  {GST_RIFF_WAVE_FORMAT_ADPCM_IMA_DK3,
+      "audio/x-adpcm, layout = (string) dk3", "IMA/DK3 ADPCM", TRUE},
+  {GST_RIFF_WAVE_FORMAT_ADPCM_IMA_WAV,
+      "audio/x-adpcm, layout = (string) dvi", "IMA/WAV ADPCM", TRUE},
+  {GST_RIFF_WAVE_FORMAT_AAC,
+      "audio/mpeg, mpegversion = (int) 4", "MPEG-4 AAC audio", TRUE},
+  {GST_RIFF_WAVE_FORMAT_SONY_ATRAC3,
+      "audio/x-vnd.sony.atrac3", "Sony ATRAC3", TRUE},
+  {GST_RIFF_WAVE_FORMAT_SIREN,
+      "audio/x-siren", "Siren7", FALSE},
+  {GST_RIFF_WAVE_FORMAT_ADPCM_G722,
+      "audio/G722", "G722 audio", TRUE},
+  {GST_RIFF_WAVE_FORMAT_A52,
+      "audio/x-ac3", "AC-3 audio", TRUE},
+  {GST_RIFF_WAVE_FORMAT_DTS,
+      "audio/x-dts", "DTS audio", FALSE},
+  {GST_RIFF_WAVE_FORMAT_AAC_AC,
+      "audio/mpeg, mpegversion = (int) 4", "MPEG-4 AAC audio", TRUE},
+  {GST_RIFF_WAVE_FORMAT_VORBIS1,
+      "audio/x-vorbis", "Vorbis", TRUE},
+  {GST_RIFF_WAVE_FORMAT_VORBIS2,
+      "audio/x-vorbis", "Vorbis", TRUE},
+  {GST_RIFF_WAVE_FORMAT_VORBIS3,
+      "audio/x-vorbis", "Vorbis", TRUE},
+  {GST_RIFF_WAVE_FORMAT_VORBIS1PLUS,
+      "audio/x-vorbis", "Vorbis", TRUE},
+  {GST_RIFF_WAVE_FORMAT_VORBIS2PLUS,
+      "audio/x-vorbis", "Vorbis", TRUE},
+  {GST_RIFF_WAVE_FORMAT_VORBIS3PLUS,
+      "audio/x-vorbis", "Vorbis", TRUE},
+  {GST_RIFF_WAVE_FORMAT_AAC_pm,
+      "audio/mpeg, mpegversion = (int) 4", "MPEG-4 AAC audio", TRUE},
+};
+
+static GstCaps *riff_video_codec_caps[G_N_ELEMENTS (riff_video_codecs)];
+static GstCaps *riff_audio_codec_caps[G_N_ELEMENTS (riff_audio_codecs)];
+
+static GstCaps *
+gst_riff_codec_caps_new (const gchar * caps_str)
+{
+  GstCaps *caps;
+
+  caps = gst_caps_from_string (caps_str);
+  g_assert (caps != NULL);
+  GST_MINI_OBJECT_FLAG_SET (caps, GST_MINI_OBJECT_FLAG_MAY_BE_LEAKED);
+
+  return caps;
+}
+
+static gpointer
+gst_riff_init_codec_caps (gpointer data)
+{
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (riff_video_codecs); i++) {
+    g_assert (i == 0
+        || riff_video_codecs[i - 1].fourcc < riff_video_codecs[i].fourcc);
+    riff_video_codec_caps[i] =
+        gst_riff_codec_caps_new (riff_video_codecs[i].caps);
+  }
+
+  for (i = 0; i < G_N_ELEMENTS (riff_audio_codecs); i++) {
+    g_assert (i == 0
+        || riff_audio_codecs[i - 1].codec_id < riff_audio_codecs[i].codec_id);
+    riff_audio_codec_caps[i] =
+        gst_riff_codec_caps_new (riff_audio_codecs[i].caps);
+  }
+
+  return NULL;
+}
+
+static void
+gst_riff_ensure_codec_caps (void)
+{
+  static GOnce once = G_ONCE_INIT;
+
+  g_once (&once, gst_riff_init_codec_caps, NULL);
+}
+
+static gint
+riff_video_codec_compare (gconstpointer key, gconstpointer elem)
+{
+  guint32 fourcc = *(const guint32 *) key;
+  const RiffVideoCodec *codec = elem;
+
+  if (fourcc < codec->fourcc)
+    return -1;
+  return fourcc > codec->fourcc;
+}
+
+static gint
+riff_audio_codec_compare (gconstpointer key, gconstpointer elem)
+{
+  guint16 codec_id = *(const guint16 *) key;
+  const RiffAudioCodec *codec = elem;
+
+  if (codec_id < codec->codec_id)
+    return -1;
+  return codec_id > codec->codec_id;
+}
+
+/* Returns a copy of the cached caps of a codec from the tables above, or
+ * %NULL if the fourcc is not in there */
+static GstCaps *
+gst_riff_lookup_video_caps (guint32 codec_fcc, char **codec_name)
+{
+  const RiffVideoCodec *codec;
+
+  codec = bsearch (&codec_fcc, riff_video_codecs,
+      G_N_ELEMENTS (riff_video_codecs), sizeof (RiffVideoCodec),
+      riff_video_codec_compare);
+  if (codec == NULL)
+    return NULL;
+
+  if (codec_name)
+    *codec_name = g_strdup (codec->codec_name);
+
+  gst_riff_ensure_codec_caps ();
+  return gst_caps_copy (riff_video_codec_caps[codec - riff_video_codecs]);
+}
+
+static GstCaps *
+gst_riff_lookup_audio_caps (guint16 codec_id, char **codec_name,
+    gboolean * rate_chan)
+{
+  const RiffAudioCodec *codec;
+
+  codec = bsearch (&codec_id, riff_audio_codecs,
+      G_N_ELEMENTS (riff_audio_codecs), sizeof (RiffAudioCodec),
+      riff_audio_codec_compare);
+  if (codec == NULL)
+    return NULL;
+
+  if (codec_name)
+    *codec_name = g_strdup (codec->codec_name);
+  *rate_chan = codec->rate_chan;
+
+  gst_riff_ensure_codec_caps ();
+  return gst_caps_copy (riff_audio_codec_caps[codec - riff_audio_codecs]);
+}
+
 /**
  * gst_riff_create_video_caps:
  * @codec_fcc: fourCC codec for this codec.
@@ -98,142 +771,6 @@ gst_riff_create_video_caps (guint32 codec_fcc,
       break;
     }
 
-    case GST_MAKE_FOURCC ('G', 'R', 'E', 'Y'):
-    case GST_MAKE_FOURCC ('Y', '8', '0', '0'):
-    case GST_MAKE_FOURCC ('Y', '8', ' ', ' '):
-      caps = gst_caps_new_simple ("video/x-raw",
-          "format", G_TYPE_STRING, "GRAY8", NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Uncompressed 8-bit monochrome");
-      break;
-
-    case GST_MAKE_FOURCC ('r', '2', '1', '0'):
-      caps = gst_caps_new_simple ("video/x-raw",
-          "format", G_TYPE_STRING, "r210", NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Uncompressed packed RGB 10-bit 4:4:4");
-      break;
-
-    case GST_RIFF_I420:
-    case GST_RIFF_i420:
-    case GST_RIFF_IYUV:
-      caps = gst_caps_new_simple ("video/x-raw",
-          "format", G_TYPE_STRING, "I420", NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Uncompressed planar YUV 4:2:0");
-      break;
-
-    case GST_RIFF_YUY2:
-    case GST_RIFF_yuy2:
-    case GST_MAKE_FOURCC ('Y', 'U', 'N', 'V'):
-    case GST_MAKE_FOURCC ('Y', 'U', 'Y', 'V'):
-      caps = gst_caps_new_simple ("video/x-raw",
-          "format", G_TYPE_STRING, "YUY2", NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Uncompressed packed YUV 4:2:2");
-      break;
-
-    case GST_RIFF_YVU9:
-      caps = gst_caps_new_simple ("video/x-raw",
-          "format", G_TYPE_STRING, "YVU9", NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Uncompressed packed YVU 4:1:0");
-      break;
-
-    case GST_MAKE_FOURCC ('U', 'Y', 'V', 'Y'):
-    case GST_MAKE_FOURCC ('2', 'v', 'u', 'y'):
-    case GST_MAKE_FOURCC ('H', 'D', 'Y', 'C'):
-      caps = gst_caps_new_simple ("video/x-raw",
-          "format", G_TYPE_STRING, "UYVY", NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Uncompressed packed YUV 4:2:2");
-      break;
-
-    case GST_RIFF_YV12:
-    case GST_RIFF_yv12:
-      caps = gst_caps_new_simple ("video/x-raw",
-          "format", G_TYPE_STRING, "YV12", NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Uncompressed packed YVU 4:2:2");
-      break;
-    case GST_MAKE_FOURCC ('v', '2', '1', '0'):
-      caps = gst_caps_new_simple ("video/x-raw",
-          "format", G_TYPE_STRING, "v210", NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Uncompressed packed 10-bit YUV 4:2:2");
-      break;
-
-    case GST_RIFF_MJPG:        /* YUY2 MJPEG */
-    case GST_RIFF_mJPG:
-    case GST_MAKE_FOURCC ('A', 'V', 'R', 'n'):
-    case GST_RIFF_IJPG:
-    case GST_MAKE_FOURCC ('i', 'j', 'p', 'g'):
-    case GST_RIFF_DMB1:
-    case GST_RIFF_dmb1:
-    case GST_MAKE_FOURCC ('A', 'C', 'D', 'V'):
-    case GST_MAKE_FOURCC ('Q', 'I', 'V', 'G'):
-      caps = gst_caps_new_empty_simple ("image/jpeg");
-      if (codec_name)
-        *codec_name = g_strdup ("Motion JPEG");
-      break;
-
-    case GST_RIFF_JPEG:        /* generic (mostly RGB) MJPEG */
-    case GST_RIFF_jpeg:
-    case GST_MAKE_FOURCC ('j', 'p', 'e', 'g'): /* generic (mostly RGB) MJPEG */
-      caps = gst_caps_new_empty_simple ("image/jpeg");
-      if (codec_name)
-        *codec_name = g_strdup ("JPEG Still Image");
-      break;
-
-    case GST_MAKE_FOURCC ('P', 'I', 'X', 'L'): /* Miro/Pinnacle fourccs */
-    case GST_RIFF_VIXL:        /* Miro/Pinnacle fourccs */
-    case GST_RIFF_vixl:
-      caps = gst_caps_new_empty_simple ("image/jpeg");
-      if (codec_name)
-        *codec_name = g_strdup ("Miro/Pinnacle Motion JPEG");
-      break;
-
-    case GST_MAKE_FOURCC ('C', 'J', 'P', 'G'):
-      caps = gst_caps_new_empty_simple ("image/jpeg");
-      if (codec_name)
-        *codec_name = g_strdup ("Creative Webcam JPEG");
-      break;
-
-    case GST_MAKE_FOURCC ('S', 'L', 'M', 'J'):
-      caps = gst_caps_new_empty_simple ("image/jpeg");
-      if (codec_name)
-        *codec_name = g_strdup ("SL Motion JPEG");
-      break;
-
-    case GST_MAKE_FOURCC ('J', 'P', 'G', 'L'):
-      caps = gst_caps_new_empty_simple ("image/jpeg");
-      if (codec_name)
-        *codec_name = g_strdup ("Pegasus Lossless JPEG");
-      break;
-
-    case GST_MAKE_FOURCC ('L', 'O', 'C', 'O'):
-      caps = gst_caps_new_empty_simple ("video/x-loco");
-      if (codec_name)
-        *codec_name = g_strdup ("LOCO Lossless");
-      break;
-
-    case GST_MAKE_FOURCC ('S', 'P', '5', '3'):
-    case GST_MAKE_FOURCC ('S', 'P', '5', '4'):
-    case GST_MAKE_FOURCC ('S', 'P', '5', '5'):
-    case GST_MAKE_FOURCC ('S', 'P', '5', '6'):
-    case GST_MAKE_FOURCC ('S', 'P', '5', '7'):
-    case GST_MAKE_FOURCC ('S', 'P', '5', '8'):
-      caps = gst_caps_new_empty_simple ("video/sp5x");
-      if (codec_name)
-        *codec_name = g_strdup ("Sp5x-like JPEG");
-      break;
-
-    case GST_MAKE_FOURCC ('Z', 'M', 'B', 'V'):
-      caps = gst_caps_new_empty_simple ("video/x-zmbv");
-      if (codec_name)
-        *codec_name = g_strdup ("Zip Motion Block video");
-      break;
-
     case GST_MAKE_FOURCC ('H', 'F', 'Y', 'U'):
       caps = gst_caps_new_empty_simple ("video/x-huffyuv");
       if (strf) {
@@ -244,51 +781,6 @@ gst_riff_create_video_caps (guint32 codec_fcc,
         *codec_name = g_strdup ("Huffman Lossless Codec");
       break;
 
-    case GST_MAKE_FOURCC ('M', 'P', 'E', 'G'):
-    case GST_MAKE_FOURCC ('M', 'P', 'G', 'I'):
-    case GST_MAKE_FOURCC ('m', 'p', 'g', '1'):
-    case GST_MAKE_FOURCC ('M', 'P', 'G', '1'):
-    case GST_MAKE_FOURCC ('P', 'I', 'M', '1'):
-    case GST_MAKE_FOURCC (0x01, 0x00, 0x00, 0x10):
-      caps = gst_caps_new_simple ("video/mpeg",
-          "systemstream", G_TYPE_BOOLEAN, FALSE,
-          "mpegversion", G_TYPE_INT, 1, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("MPEG-1 video");
-      break;
-
-    case GST_MAKE_FOURCC ('M', 'P', 'G', '2'):
-    case GST_MAKE_FOURCC ('m', 'p', 'g', '2'):
-    case GST_MAKE_FOURCC ('P', 'I', 'M', '2'):
-    case GST_MAKE_FOURCC ('D', 'V', 'R', ' '):
-    case GST_MAKE_FOURCC (0x02, 0x00, 0x00, 0x10):
-      caps = gst_caps_new_simple ("video/mpeg",
-          "systemstream", G_TYPE_BOOLEAN, FALSE,
-          "mpegversion", G_TYPE_INT, 2, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("MPEG-2 video");
-      break;
-
-    case GST_MAKE_FOURCC ('L', 'M', 'P', '2'):
-      caps = gst_caps_new_simple ("video/mpeg",
-          "systemstream", G_TYPE_BOOLEAN, FALSE,
-          "mpegversion", G_TYPE_INT, 2, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Lead MPEG-2 video");
-      break;
-
-    case GST_RIFF_H263:
-    case GST_RIFF_h263:
-    case GST_RIFF_i263:
-    case GST_MAKE_FOURCC ('U', '2', '6', '3'):
-    case GST_MAKE_FOURCC ('v', 'i', 'v', '1'):
-    case GST_MAKE_FOURCC ('T', '2', '6', '3'):
-      caps = gst_caps_new_simple ("video/x-h263",
-          "variant", G_TYPE_STRING, "itu", NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("ITU H.26n");
-      break;
-
     case GST_RIFF_L263:
       /* http://www.leadcodecs.com/Codecs/LEAD-H263.htm */
       caps = gst_caps_new_simple ("video/x-h263",
@@ -297,69 +789,6 @@ gst_riff_create_video_caps (guint32 codec_fcc,
         *codec_name = g_strdup ("Lead H.263");
       break;
 
-    case GST_RIFF_M263:
-    case GST_RIFF_m263:
-      caps = gst_caps_new_simple ("video/x-h263",
-          "variant", G_TYPE_STRING, "microsoft", NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Microsoft H.263");
-      break;
-
-    case GST_RIFF_VDOW:
-      caps = gst_caps_new_simple ("video/x-h263",
-          "variant", G_TYPE_STRING, "vdolive", NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("VDOLive");
-      break;
-
-    case GST_MAKE_FOURCC ('V', 'I', 'V', 'O'):
-      caps = gst_caps_new_simple ("video/x-h263",
-          "variant", G_TYPE_STRING, "vivo", NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Vivo H.263");
-      break;
-
-    case GST_RIFF_x263:
-      caps = gst_caps_new_simple ("video/x-h263",
-          "variant", G_TYPE_STRING, "xirlink", NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Xirlink H.263");
-      break;
-
-      /* apparently not standard H.263...? */
-    case GST_MAKE_FOURCC ('I', '2', '6', '3'):
-      caps = gst_caps_new_simple ("video/x-intel-h263",
-          "variant", G_TYPE_STRING, "intel", NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Intel H.263");
-      break;
-
-    case GST_MAKE_FOURCC ('V', 'X', '1', 'K'):
-      caps = gst_caps_new_simple ("video/x-h263",
-          "variant", G_TYPE_STRING, "lucent", NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Lucent VX1000S H.263");
-      break;
-
-    case GST_MAKE_FOURCC ('X', '2', '6', '4'):
-    case GST_MAKE_FOURCC ('x', '2', '6', '4'):
-    case GST_MAKE_FOURCC ('H', '2', '6', '4'):
-    case GST_MAKE_FOURCC ('h', '2', '6', '4'):
-    case GST_MAKE_FOURCC ('a', 'v', 'c', '1'):
-    case GST_MAKE_FOURCC ('A', 'V', 'C', '1'):
-      caps = gst_caps_new_simple ("video/x-h264",
-          "variant", G_TYPE_STRING, "itu", NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("ITU H.264");
-      break;
-
-    case GST_RIFF_VSSH:
-      caps = gst_caps_new_simple ("video/x-h264",
-          "variant", G_TYPE_STRING, "videosoft", NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("VideoSoft H.264");
-      break;
-
     case GST_MAKE_FOURCC ('L', '2', '6', '4'):
       /* http://www.leadcodecs.com/Codecs/LEAD-H264.htm */
       caps = gst_caps_new_simple ("video/x-h264",
@@ -368,232 +797,6 @@ gst_riff_create_video_caps (guint32 codec_fcc,
         *codec_name = g_strdup ("Lead H.264");
       break;
 
-    case GST_MAKE_FOURCC ('S', 'E', 'D', 'G'):
-      caps = gst_caps_new_simple ("video/mpeg",
-          "mpegversion", G_TYPE_INT, 4,
-          "systemstream", G_TYPE_BOOLEAN, FALSE, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Samsung MPEG-4");
-      break;
-
-    case GST_MAKE_FOURCC ('M', '4', 'C', 'C'):
-      caps = gst_caps_new_simple ("video/mpeg",
-          "mpegversion", G_TYPE_INT, 4,
-          "systemstream", G_TYPE_BOOLEAN, FALSE, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Divio MPEG-4");
-      break;
-
-    case GST_RIFF_DIV3:
-    case GST_MAKE_FOURCC ('d', 'i', 'v', '3'):
-    case GST_MAKE_FOURCC ('D', 'V', 'X', '3'):
-    case GST_MAKE_FOURCC ('d', 'v', 'x', '3'):
-    case GST_MAKE_FOURCC ('D', 'I', 'V', '4'):
-    case GST_MAKE_FOURCC ('d', 'i', 'v', '4'):
-    case GST_MAKE_FOURCC ('D', 'I', 'V', '5'):
-    case GST_MAKE_FOURCC ('d', 'i', 'v', '5'):
-    case GST_MAKE_FOURCC ('D', 'I', 'V', '6'):
-    case GST_MAKE_FOURCC ('d', 'i', 'v', '6'):
-    case GST_MAKE_FOURCC ('M', 'P', 'G', '3'):
-    case GST_MAKE_FOURCC ('m', 'p', 'g', '3'):
-    case GST_MAKE_FOURCC ('c', 'o', 'l', '0'):
-    case GST_MAKE_FOURCC ('C', 'O', 'L', '0'):
-    case GST_MAKE_FOURCC ('c', 'o', 'l', '1'):
-    case GST_MAKE_FOURCC ('C', 'O', 'L', '1'):
-    case GST_MAKE_FOURCC ('A', 'P', '4', '1'):
-      caps = gst_caps_new_simple ("video/x-divx",
-          "divxversion", G_TYPE_INT, 3, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("DivX MS-MPEG-4 Version 3");
-      break;
-
-    case GST_MAKE_FOURCC ('d', 'i', 'v', 'x'):
-    case GST_MAKE_FOURCC ('D', 'I', 'V', 'X'):
-      caps = gst_caps_new_simple ("video/x-divx",
-          "divxversion", G_TYPE_INT, 4, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("DivX MPEG-4 Version 4");
-      break;
-
-    case GST_MAKE_FOURCC ('B', 'L', 'Z', '0'):
-      caps = gst_caps_new_simple ("video/x-divx",
-          "divxversion", G_TYPE_INT, 4, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Blizzard DivX");
-      break;
-
-    case GST_MAKE_FOURCC ('D', 'X', '5', '0'):
-      caps = gst_caps_new_simple ("video/x-divx",
-          "divxversion", G_TYPE_INT, 5, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("DivX MPEG-4 Version 5");
-      break;
-
-    case GST_MAKE_FOURCC ('M', 'P', 'G', '4'):
-    case GST_MAKE_FOURCC ('M', 'P', '4', '1'):
-    case GST_MAKE_FOURCC ('m', 'p', '4', '1'):
-      caps = gst_caps_new_simple ("video/x-msmpeg",
-          "msmpegversion", G_TYPE_INT, 41, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Microsoft MPEG-4 4.1");
-      break;
-
-    case GST_MAKE_FOURCC ('m', 'p', '4', '2'):
-    case GST_MAKE_FOURCC ('M', 'P', '4', '2'):
-      caps = gst_caps_new_simple ("video/x-msmpeg",
-          "msmpegversion", G_TYPE_INT, 42, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Microsoft MPEG-4 4.2");
-      break;
-
-    case GST_MAKE_FOURCC ('m', 'p', '4', '3'):
-    case GST_MAKE_FOURCC ('M', 'P', '4', '3'):
-      caps = gst_caps_new_simple ("video/x-msmpeg",
-          "msmpegversion", G_TYPE_INT, 43, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Microsoft MPEG-4 4.3");
-      break;
-
-    case GST_MAKE_FOURCC ('M', 'P', '4', 'S'):
-    case GST_MAKE_FOURCC ('M', '4', 'S', '2'):
-      caps = gst_caps_new_simple ("video/mpeg",
-          "mpegversion", G_TYPE_INT, 4,
-          "systemstream", G_TYPE_BOOLEAN, FALSE, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Microsoft ISO MPEG-4 1.1");
-      break;
-
-    case GST_MAKE_FOURCC ('F', 'M', 'P', '4'):
-    case GST_MAKE_FOURCC ('U', 'M', 'P', '4'):
-    case GST_MAKE_FOURCC ('F', 'F', 'D', 'S'):
-      caps = gst_caps_new_simple ("video/mpeg",
-          "mpegversion", G_TYPE_INT, 4,
-          "systemstream", G_TYPE_BOOLEAN, FALSE, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("FFmpeg MPEG-4");
-      break;
-
-    case GST_MAKE_FOURCC ('3', 'I', 'V', '1'):
-    case GST_MAKE_FOURCC ('3', 'I', 'V', '2'):
-    case GST_MAKE_FOURCC ('X', 'V', 'I', 'D'):
-    case GST_MAKE_FOURCC ('x', 'v', 'i', 'd'):
-    case GST_MAKE_FOURCC ('E', 'M', '4', 'A'):
-    case GST_MAKE_FOURCC ('E', 'P', 'V', 'H'):
-    case GST_MAKE_FOURCC ('F', 'V', 'F', 'W'):
-    case GST_MAKE_FOURCC ('I', 'N', 'M', 'C'):
-    case GST_MAKE_FOURCC ('D', 'I', 'G', 'I'):
-    case GST_MAKE_FOURCC ('D', 'M', '2', 'K'):
-    case GST_MAKE_FOURCC ('D', 'C', 'O', 'D'):
-    case GST_MAKE_FOURCC ('M', 'V', 'X', 'M'):
-    case GST_MAKE_FOURCC ('P', 'M', '4', 'V'):
-    case GST_MAKE_FOURCC ('S', 'M', 'P', '4'):
-    case GST_MAKE_FOURCC ('D', 'X', 'G', 'M'):
-    case GST_MAKE_FOURCC ('V', 'I', 'D', 'M'):
-    case GST_MAKE_FOURCC ('M', '4', 'T', '3'):
-    case GST_MAKE_FOURCC ('G', 'E', 'O', 'X'):
-    case GST_MAKE_FOURCC ('M', 'P', '4', 'V'):
-    case GST_MAKE_FOURCC ('m', 'p', '4', 'v'):
-    case GST_MAKE_FOURCC ('R', 'M', 'P', '4'):
-      caps = gst_caps_new_simple ("video/mpeg",
-          "mpegversion", G_TYPE_INT, 4,
-          "systemstream", G_TYPE_BOOLEAN, FALSE, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("MPEG-4");
-      break;
-
-    case GST_MAKE_FOURCC ('3', 'i', 'v', 'd'):
-    case GST_MAKE_FOURCC ('3', 'I', 'V', 'D'):
-      caps = gst_caps_new_simple ("video/x-msmpeg",
-          "msmpegversion", G_TYPE_INT, 43, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Microsoft MPEG-4 4.3");        /* FIXME? */
-      break;
-
-    case GST_MAKE_FOURCC ('D', 'V', 'S', 'D'):
-    case GST_MAKE_FOURCC ('d', 'v', 's', 'd'):
-    case GST_MAKE_FOURCC ('d', 'v', 'c', ' '):
-    case GST_MAKE_FOURCC ('d', 'v', '2', '5'):
-      caps = gst_caps_new_simple ("video/x-dv",
-          "systemstream", G_TYPE_BOOLEAN, FALSE,
-          "dvversion", G_TYPE_INT, 25, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Generic DV");
-      break;
-
-    case GST_MAKE_FOURCC ('C', 'D', 'V', 'C'):
-    case GST_MAKE_FOURCC ('c', 'd', 'v', 'c'):
-      caps = gst_caps_new_simple ("video/x-dv",
-          "systemstream", G_TYPE_BOOLEAN, FALSE,
-          "dvversion", G_TYPE_INT, 25, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Canopus DV");
-      break;
-
-    case GST_MAKE_FOURCC ('D', 'V', '5', '0'):
-    case GST_MAKE_FOURCC ('d', 'v', '5', '0'):
-      caps = gst_caps_new_simple ("video/x-dv",
-          "systemstream", G_TYPE_BOOLEAN, FALSE,
-          "dvversion", G_TYPE_INT, 50, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("DVCPro50 Video");
-      break;
-
-    case GST_MAKE_FOURCC ('M', 'S', 'S', '1'):
-      caps = gst_caps_new_simple ("video/x-wmv",
-          "wmvversion", G_TYPE_INT, 1, "format", G_TYPE_STRING, "MSS1", NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Microsoft Windows Media 7 Screen");
-      break;
-
-    case GST_MAKE_FOURCC ('M', 'S', 'S', '2'):
-      caps = gst_caps_new_simple ("video/x-wmv",
-          "wmvversion", G_TYPE_INT, 3, "format", G_TYPE_STRING, "MSS2", NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Microsoft Windows Media 9 Screen");
-      break;
-
-    case GST_MAKE_FOURCC ('W', 'M', 'V', '1'):
-      caps = gst_caps_new_simple ("video/x-wmv",
-          "wmvversion", G_TYPE_INT, 1, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Microsoft Windows Media 7");
-      break;
-
-    case GST_MAKE_FOURCC ('W', 'M', 'V', '2'):
-      caps = gst_caps_new_simple ("video/x-wmv",
-          "wmvversion", G_TYPE_INT, 2, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Microsoft Windows Media 8");
-      break;
-
-    case GST_MAKE_FOURCC ('W', 'M', 'V', '3'):
-      caps = gst_caps_new_simple ("video/x-wmv",
-          "wmvversion", G_TYPE_INT, 3, "format", G_TYPE_STRING, "WMV3", NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Microsoft Windows Media 9");
-      break;
-
-    case GST_MAKE_FOURCC ('W', 'M', 'V', 'A'):
-      caps = gst_caps_new_simple ("video/x-wmv",
-          "wmvversion", G_TYPE_INT, 3, "format", G_TYPE_STRING, "WMVA", NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Microsoft Windows Media Advanced Profile");
-      break;
-
-    case GST_MAKE_FOURCC ('W', 'V', 'C', '1'):
-      caps = gst_caps_new_simple ("video/x-wmv",
-          "wmvversion", G_TYPE_INT, 3, "format", G_TYPE_STRING, "WVC1", NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Microsoft Windows Media VC-1");
-      break;
-
-    case GST_RIFF_cvid:
-    case GST_RIFF_CVID:
-      caps = gst_caps_new_empty_simple ("video/x-cinepak");
-      if (codec_name)
-        *codec_name = g_strdup ("Cinepak video");
-      break;
-
     case GST_RIFF_FCCH_MSVC:
     case GST_RIFF_FCCH_msvc:
     case GST_RIFF_CRAM:
@@ -630,110 +833,6 @@ gst_riff_create_video_caps (guint32 codec_fcc,
         *codec_name = g_strdup ("Microsoft RLE");
       break;
 
-    case GST_MAKE_FOURCC ('A', 'A', 'S', 'C'):
-      caps = gst_caps_new_empty_simple ("video/x-aasc");
-      if (codec_name)
-        *codec_name = g_strdup ("Autodesk Animator");
-      break;
-
-    case GST_MAKE_FOURCC ('X', 'x', 'a', 'n'):
-      caps = gst_caps_new_simple ("video/x-xan",
-          "wcversion", G_TYPE_INT, 4, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Xan Wing Commander 4");
-      break;
-
-    case GST_RIFF_RT21:
-    case GST_RIFF_rt21:
-      caps = gst_caps_new_simple ("video/x-indeo",
-          "indeoversion", G_TYPE_INT, 2, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Intel Video 2");
-      break;
-
-    case GST_RIFF_IV31:
-    case GST_RIFF_IV32:
-    case GST_RIFF_iv31:
-    case GST_RIFF_iv32:
-      caps = gst_caps_new_simple ("video/x-indeo",
-          "indeoversion", G_TYPE_INT, 3, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Intel Video 3");
-      break;
-
-    case GST_RIFF_IV41:
-    case GST_RIFF_iv41:
-      caps = gst_caps_new_simple ("video/x-indeo",
-          "indeoversion", G_TYPE_INT, 4, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Intel Video 4");
-      break;
-
-    case GST_RIFF_IV50:
-      caps = gst_caps_new_simple ("video/x-indeo",
-          "indeoversion", G_TYPE_INT, 5, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Intel Video 5");
-      break;
-
-    case GST_MAKE_FOURCC ('M', 'S', 'Z', 'H'):
-      caps = gst_caps_new_empty_simple ("video/x-mszh");
-      if (codec_name)
-        *codec_name = g_strdup ("Lossless MSZH Video");
-      break;
-
-    case GST_MAKE_FOURCC ('Z', 'L', 'I', 'B'):
-      caps = gst_caps_new_empty_simple ("video/x-zlib");
-      if (codec_name)
-        *codec_name = g_strdup ("Lossless zlib video");
-      break;
-
-    case GST_MAKE_FOURCC ('C', 'L', 'J', 'R'):
-    case GST_MAKE_FOURCC ('c', 'l', 'j', 'r'):
-      caps = gst_caps_new_empty_simple ("video/x-cirrus-logic-accupak");
-      if (codec_name)
-        *codec_name = g_strdup ("Cirrus Logipak AccuPak");
-      break;
-
-    case GST_RIFF_CYUV:
-    case GST_RIFF_cyuv:
-      caps = gst_caps_new_empty_simple ("video/x-compressed-yuv");
-      if (codec_name)
-        *codec_name = g_strdup ("CYUV Lossless");
-      break;
-
-    case GST_MAKE_FOURCC ('D', 'U', 'C', 'K'):
-    case GST_MAKE_FOURCC ('P', 'V', 'E', 'Z'):
-      caps = gst_caps_new_simple ("video/x-truemotion",
-          "trueversion", G_TYPE_INT, 1, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Duck Truemotion1");
-      break;
-
-    case GST_MAKE_FOURCC ('T', 'M', '2', '0'):
-      caps = gst_caps_new_simple ("video/x-truemotion",
-          "trueversion", G_TYPE_INT, 2, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("TrueMotion 2.0");
-      break;
-
-    case GST_MAKE_FOURCC ('V', 'P', '3', '0'):
-    case GST_MAKE_FOURCC ('v', 'p', '3', '0'):
-    case GST_MAKE_FOURCC ('V', 'P', '3', '1'):
-    case GST_MAKE_FOURCC ('v', 'p', '3', '1'):
-    case GST_MAKE_FOURCC ('V', 'P', '3', ' '):
-      caps = gst_caps_new_empty_simple ("video/x-vp3");
-      if (codec_name)
-        *codec_name = g_strdup ("VP3");
-      break;
-
-    case GST_RIFF_ULTI:
-    case GST_RIFF_ulti:
-      caps = gst_caps_new_empty_simple ("video/x-ultimotion");
-      if (codec_name)
-        *codec_name = g_strdup ("IBM UltiMotion");
-      break;
-
       /* FIXME 2.0: Rename video/x-camtasia to video/x-tscc,version=1 */
     case GST_MAKE_FOURCC ('T', 'S', 'C', 'C'):
     case GST_MAKE_FOURCC ('t', 's', 'c', 'c'):{
@@ -751,16 +850,6 @@ gst_riff_create_video_caps (guint32 codec_fcc,
       break;
     }
 
-    case GST_MAKE_FOURCC ('T', 'S', 'C', '2'):
-    case GST_MAKE_FOURCC ('t', 's', 'c', '2'):{
-      caps =
-          gst_caps_new_simple ("video/x-tscc", "tsccversion", G_TYPE_INT, 2,
-          NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("TechSmith Screen Capture 2");
-      break;
-    }
-
     case GST_MAKE_FOURCC ('C', 'S', 'C', 'D'):
     {
       if (strf) {
@@ -777,50 +866,6 @@ gst_riff_create_video_caps (guint32 codec_fcc,
       break;
     }
 
-    case GST_MAKE_FOURCC ('V', 'C', 'R', '1'):
-      caps = gst_caps_new_simple ("video/x-ati-vcr",
-          "vcrversion", G_TYPE_INT, 1, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("ATI VCR 1");
-      break;
-
-    case GST_MAKE_FOURCC ('V', 'C', 'R', '2'):
-      caps = gst_caps_new_simple ("video/x-ati-vcr",
-          "vcrversion", G_TYPE_INT, 2, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("ATI VCR 2");
-      break;
-
-    case GST_MAKE_FOURCC ('A', 'S', 'V', '1'):
-      caps = gst_caps_new_simple ("video/x-asus",
-          "asusversion", G_TYPE_INT, 1, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Asus Video 1");
-      break;
-
-    case GST_MAKE_FOURCC ('A', 'S', 'V', '2'):
-      caps = gst_caps_new_simple ("video/x-asus",
-          "asusversion", G_TYPE_INT, 2, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Asus Video 2");
-      break;
-
-    case GST_MAKE_FOURCC ('M', 'P', 'N', 'G'):
-    case GST_MAKE_FOURCC ('m', 'p', 'n', 'g'):
-    case GST_MAKE_FOURCC ('P', 'N', 'G', ' '):
-    case GST_MAKE_FOURCC ('p', 'n', 'g', ' '):
-      caps = gst_caps_new_empty_simple ("image/png");
-      if (codec_name)
-        *codec_name = g_strdup ("PNG image");
-      break;
-
-    case GST_MAKE_FOURCC ('F', 'L', 'V', '1'):
-      caps = gst_caps_new_simple ("video/x-flash-video",
-          "flvversion", G_TYPE_INT, 1, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("Flash Video 1");
-      break;
-
     case GST_MAKE_FOURCC ('V', 'M', 'n', 'c'):
       caps = gst_caps_new_simple ("video/x-vmnc",
           "version", G_TYPE_INT, 1, NULL);
@@ -830,106 +875,14 @@ gst_riff_create_video_caps (guint32 codec_fcc,
         *codec_name = g_strdup ("VMWare NC Video");
       break;
 
-    case GST_MAKE_FOURCC ('d', 'r', 'a', 'c'):
-      caps = gst_caps_new_empty_simple ("video/x-dirac");
-      if (codec_name)
-        *codec_name = g_strdup ("Dirac");
-      break;
-
-    case GST_RIFF_rpza:
-    case GST_RIFF_azpr:
-    case GST_MAKE_FOURCC ('R', 'P', 'Z', 'A'):
-      caps = gst_caps_new_empty_simple ("video/x-apple-video");
-      if (codec_name)
-        *codec_name = g_strdup ("Apple Video (RPZA)");
-      break;
-
-
-    case GST_MAKE_FOURCC ('F', 'F', 'V', '1'):
-      caps = gst_caps_new_simple ("video/x-ffv",
-          "ffvversion", G_TYPE_INT, 1, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("FFmpeg lossless video codec");
-      break;
-
-    case GST_MAKE_FOURCC ('K', 'M', 'V', 'C'):
-      caps = gst_caps_new_empty_simple ("video/x-kmvc");
-      if (codec_name)
-        *codec_name = g_strdup ("Karl Morton's video codec");
-      break;
-
-    case GST_MAKE_FOURCC ('v', 'p', '5', '0'):
-    case GST_MAKE_FOURCC ('V', 'P', '5', '0'):
-      caps = gst_caps_new_empty_simple ("video/x-vp5");
-      if (codec_name)
-        *codec_name = g_strdup ("On2 VP5");
-      break;
-
-    case GST_MAKE_FOURCC ('v', 'p', '6', '0'):
-    case GST_MAKE_FOURCC ('V', 'P', '6', '0'):
-    case GST_MAKE_FOURCC ('v', 'p', '6', '1'):
-    case GST_MAKE_FOURCC ('V', 'P', '6', '1'):
-    case GST_MAKE_FOURCC ('V', 'p', '6', '2'):
-    case GST_MAKE_FOURCC ('V', 'P', '6', '2'):
-      caps = gst_caps_new_empty_simple ("video/x-vp6");
-      if (codec_name)
-        *codec_name = g_strdup ("On2 VP6");
-      break;
-
-    case GST_MAKE_FOURCC ('V', 'P', '6', 'F'):
-    case GST_MAKE_FOURCC ('v', 'p', '6', 'f'):
-    case GST_MAKE_FOURCC ('F', 'L', 'V', '4'):
-      caps = gst_caps_new_empty_simple ("video/x-vp6-flash");
-      if (codec_name)
-        *codec_name = g_strdup ("On2 VP6");
-      break;
-
-    case GST_MAKE_FOURCC ('v', 'p', '7', '0'):
-    case GST_MAKE_FOURCC ('V', 'P', '7', '0'):
-      caps = gst_caps_new_empty_simple ("video/x-vp7");
-      if (codec_name)
-        *codec_name = g_strdup ("On2 VP7");
-      break;
-
-    case GST_MAKE_FOURCC ('V', 'P', '8', '0'):
-      caps = gst_caps_new_empty_simple ("video/x-vp8");
-      if (codec_name)
-        *codec_name = g_strdup ("On2 VP8");
-      break;
-
-    case GST_MAKE_FOURCC ('L', 'M', '2', '0'):
-      caps = gst_caps_new_empty_simple ("video/x-mimic");
-      if (codec_name)
-        *codec_name = g_strdup ("Mimic webcam");
-      break;
-
-    case GST_MAKE_FOURCC ('T', 'H', 'E', 'O'):
-    case GST_MAKE_FOURCC ('t', 'h', 'e', 'o'):
-      caps = gst_caps_new_empty_simple ("video/x-theora");
-      if (codec_name)
-        *codec_name = g_strdup ("Theora video codec");
-
-      break;
-
-    case GST_MAKE_FOURCC ('F', 'P', 'S', '1'):
-      caps = gst_caps_new_empty_simple ("video/x-fraps");
-      if (codec_name)
-        *codec_name = g_strdup ("Fraps video");
-
-      break;
-
-    case GST_MAKE_FOURCC ('D', 'X', 'S', 'B'):
-    case GST_MAKE_FOURCC ('D', 'X', 'S', 'A'):
-      caps = gst_caps_new_empty_simple ("subpicture/x-xsub");
-      if (codec_name)
-        *codec_name = g_strdup ("XSUB subpicture stream");
-
-      break;
-
     default:
-      GST_WARNING ("Unknown video fourcc %" GST_FOURCC_FORMAT,
-          GST_FOURCC_ARGS (codec_fcc));
-      return NULL;
+      caps = gst_riff_lookup_video_caps (codec_fcc, codec_name);
+      if (caps == NULL) {
+        GST_WARNING ("Unknown video fourcc %" GST_FOURCC_FORMAT,
+            GST_FOURCC_ARGS (codec_fcc));
+        return NULL;
+      }
+      break;
   }
 
   if (strh != NULL) {
@@ -1417,12 +1370,6 @@ gst_riff_create_audio_caps (guint16 codec_id,
       block_align = TRUE;
       break;
 
-    case GST_RIFF_WAVE_FORMAT_ADPCM_G722:
-      caps = gst_caps_new_empty_simple ("audio/G722");
-      if (codec_name)
-        *codec_name = g_strdup ("G722 audio");
-      break;
-
     case GST_RIFF_WAVE_FORMAT_ITU_G726_ADPCM:
       if (strf != NULL) {
         gint bitrate;
@@ -1450,79 +1397,6 @@ gst_riff_create_audio_caps (guint16 codec_id,
         *codec_name = g_strdup ("G726 ADPCM audio");
       block_align = TRUE;
       break;
-
-    case GST_RIFF_WAVE_FORMAT_DSP_TRUESPEECH:
-      caps = gst_caps_new_empty_simple ("audio/x-truespeech");
-      if (codec_name)
-        *codec_name = g_strdup ("DSP Group TrueSpeech");
-      break;
-
-    case GST_RIFF_WAVE_FORMAT_GSM610:
-    case GST_RIFF_WAVE_FORMAT_MSN:
-      caps = gst_caps_new_empty_simple ("audio/ms-gsm");
-      if (codec_name)
-        *codec_name = g_strdup ("MS GSM audio");
-      break;
-
-    case GST_RIFF_WAVE_FORMAT_MPEGL12: /* mp1 or mp2 */
-      caps = gst_caps_new_simple ("audio/mpeg",
-          "mpegversion", G_TYPE_INT, 1, "layer", G_TYPE_INT, 2, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("MPEG-1 layer 2");
-      break;
-
-    case GST_RIFF_WAVE_FORMAT_MPEGL3:  /* mp3 */
-      caps = gst_caps_new_simple ("audio/mpeg",
-          "mpegversion", G_TYPE_INT, 1, "layer", G_TYPE_INT, 3, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("MPEG-1 layer 3");
-      break;
-
-    case GST_RIFF_WAVE_FORMAT_AMR_NB:  /* amr-nb */
-      caps = gst_caps_new_empty_simple ("audio/AMR");
-      if (codec_name)
-        *codec_name = g_strdup ("AMR Narrow Band (NB)");
-      break;
-
-    case GST_RIFF_WAVE_FORMAT_AMR_WB:  /* amr-wb */
-      caps = gst_caps_new_empty_simple ("audio/AMR-WB");
-      if (codec_name)
-        *codec_name = g_strdup ("AMR Wide Band (WB)");
-      break;
-
-    case GST_RIFF_WAVE_FORMAT_VORBIS1: /* ogg/vorbis mode 1 */
-    case GST_RIFF_WAVE_FORMAT_VORBIS2: /* ogg/vorbis mode 2 */
-    case GST_RIFF_WAVE_FORMAT_VORBIS3: /* ogg/vorbis mode 3 */
-    case GST_RIFF_WAVE_FORMAT_VORBIS1PLUS:     /* ogg/vorbis mode 1+ */
-    case GST_RIFF_WAVE_FORMAT_VORBIS2PLUS:     /* ogg/vorbis mode 2+ */
-    case GST_RIFF_WAVE_FORMAT_VORBIS3PLUS:     /* ogg/vorbis mode 3+ */
-      caps = gst_caps_new_empty_simple ("audio/x-vorbis");
-      if (codec_name)
-        *codec_name = g_strdup ("Vorbis");
-      break;
-
-    case GST_RIFF_WAVE_FORMAT_A52:
-      caps = gst_caps_new_empty_simple ("audio/x-ac3");
-      if (codec_name)
-        *codec_name = g_strdup ("AC-3 audio");
-      break;
-    case GST_RIFF_WAVE_FORMAT_DTS:
-      caps = gst_caps_new_empty_simple ("audio/x-dts");
-      if (codec_name)
-        *codec_name = g_strdup ("DTS audio");
-      /* wavparse is not always able to specify rate/channels for DTS-in-wav */
-      rate_chan = FALSE;
-      break;
-    case GST_RIFF_WAVE_FORMAT_AAC:
-    case GST_RIFF_WAVE_FORMAT_AAC_AC:
-    case GST_RIFF_WAVE_FORMAT_AAC_pm:
-    {
-      caps = gst_caps_new_simple ("audio/mpeg",
-          "mpegversion", G_TYPE_INT, 4, NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("MPEG-4 AAC audio");
-      break;
-    }
     case GST_RIFF_WAVE_FORMAT_WMAV1:
     case GST_RIFF_WAVE_FORMAT_WMAV2:
     case GST_RIFF_WAVE_FORMAT_WMAV3:
@@ -1552,41 +1426,6 @@ gst_riff_create_audio_caps (guint16 codec_id,
       }
       break;
     }
-    case GST_RIFF_WAVE_FORMAT_SONY_ATRAC3:
-      caps = gst_caps_new_empty_simple ("audio/x-vnd.sony.atrac3");
-      if (codec_name)
-        *codec_name = g_strdup ("Sony ATRAC3");
-      break;
-
-    case GST_RIFF_WAVE_FORMAT_SIREN:
-      caps = gst_caps_new_empty_simple ("audio/x-siren");
-      if (codec_name)
-        *codec_name = g_strdup ("Siren7");
-      rate_chan = FALSE;
-      break;
-
-    case GST_RIFF_WAVE_FORMAT_ADPCM_IMA_DK4:
-      caps =
-          gst_caps_new_simple ("audio/x-adpcm", "layout", G_TYPE_STRING, "dk4",
-          NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("IMA/DK4 ADPCM");
-      break;
-    case GST_RIFF_WAVE_FORMAT_ADPCM_IMA_DK3:
-      caps =
-          gst_caps_new_simple ("audio/x-adpcm", "layout", G_TYPE_STRING, "dk3",
-          NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("IMA/DK3 ADPCM");
-      break;
-
-    case GST_RIFF_WAVE_FORMAT_ADPCM_IMA_WAV:
-      caps =
-          gst_caps_new_simple ("audio/x-adpcm", "layout", G_TYPE_STRING, "dvi",
-          NULL);
-      if (codec_name)
-        *codec_name = g_strdup ("IMA/WAV ADPCM");
-      break;
     case GST_RIFF_WAVE_FORMAT_EXTENSIBLE:{
       guint16 valid_bits_per_sample;
       guint32 channel_mask;
@@ -1796,6 +1635,10 @@ gst_riff_create_audio_caps (guint16 codec_id,
       break;
     }
     default:
+      caps = gst_riff_lookup_audio_caps (codec_id, codec_name, &rate_chan);
+      if (caps != NULL)
+        break;
+      /* fall through */
     unknown:
       GST_WARNING ("Unknown audio tag 0x%04x", codec_id);
       return NULL;
@@ -1854,11 +1697,12 @@ gst_riff_create_iavs_caps (guint32 codec_fcc,
 }
 
 /*
- * Functions below are for template caps. All is variable.
+ * Functions below are for template caps. All is variable. The caps are only
+ * built once and copied for every caller, as iterating all codecs is costly.
  */
 
-GstCaps *
-gst_riff_create_video_template_caps (void)
+static gpointer
+gst_riff_build_video_template_caps (gpointer data)
 {
   static const guint32 tags[] = {
     GST_MAKE_FOURCC ('3', 'I', 'V', '1'),
@@ -1954,11 +1798,23 @@ gst_riff_create_video_template_caps (void)
       gst_caps_append (caps, one);
   }
 
+  GST_MINI_OBJECT_FLAG_SET (caps, GST_MINI_OBJECT_FLAG_MAY_BE_LEAKED);
+
   return caps;
 }
 
 GstCaps *
-gst_riff_create_audio_template_caps (void)
+gst_riff_create_video_template_caps (void)
+{
+  static GOnce once = G_ONCE_INIT;
+
+  g_once (&once, gst_riff_build_video_template_caps, NULL);
+
+  return gst_caps_copy (once.retval);
+}
+
+static gpointer
+gst_riff_build_audio_template_caps (gpointer data)
 {
   static const guint16 tags[] = {
     GST_RIFF_WAVE_FORMAT_GSM610,
@@ -2003,11 +1859,23 @@ gst_riff_create_audio_template_caps (void)
   one = gst_caps_new_empty_simple ("application/x-ogg-avi");
   gst_caps_append (caps, one);
 
+  GST_MINI_OBJECT_FLAG_SET (caps, GST_MINI_OBJECT_FLAG_MAY_BE_LEAKED);
+
   return caps;
 }
 
 GstCaps *
-gst_riff_create_iavs_template_caps (void)
+gst_riff_create_audio_template_caps (void)
+{
+  static GOnce once = G_ONCE_INIT;
+
+  g_once (&once, gst_riff_build_audio_template_caps, NULL);
+
+  return gst_caps_copy (once.retval);
+}
+
+static gpointer
+gst_riff_build_iavs_template_caps (gpointer data)
 {
   static const guint32 tags[] = {
     GST_MAKE_FOURCC ('D', 'V', 'S', 'D')
@@ -2023,5 +1891,17 @@ gst_riff_create_iavs_template_caps (void)
       gst_caps_append (caps, one);
   }
 
+  GST_MINI_OBJECT_FLAG_SET (caps, GST_MINI_OBJECT_FLAG_MAY_BE_LEAKED);
+
   return caps;
 }
+
+GstCaps *
+gst_riff_create_iavs_template_caps (void)
+{
+  static GOnce once = G_ONCE_INIT;
+
+  g_once (&once, gst_riff_build_iavs_template_caps, NULL);
+
+  return gst_caps_copy (once.retval);
+}
@@ -271,6 +271,10 @@ gst_sdp_message_new_from_text (const gchar * text, GstSDPMessage ** msg)
  * When this function is invoked on newly allocated data (with malloc or on the
  * stack), its contents should be set to 0 before calling this function.
  *
+ * Calling this function on a message that was used before resets it while
+ * keeping the storage of its arrays around, so a single #GstSDPMessage can be
+ * reused to parse many SDP descriptions with gst_sdp_message_parse_buffer().
+ *
  * Returns: a #GstSDPResult.
  */
 GstSDPResult
@@ -482,6 +486,109 @@ gst_sdp_address_is_multicast (const gchar * nettype, const gchar * addrtype,
   return ret;
 }
 
+/* Serialization helpers. The SDP text is built up with plain appends instead
+ * of g_string_append_printf() since formatting every field through printf
+ * dominates the cost of serializing large messages. */
+static inline void
+append_uint (GString * lines, guint val)
+{
+  gchar buf[16];
+  gchar *p = buf + sizeof (buf);
+
+  do {
+    *--p = '0' + (val % 10);
+    val /= 10;
+  } while (val != 0);
+
+  g_string_append_len (lines, p, buf + sizeof (buf) - p);
+}
+
+static inline void
+append_field (GString * lines, gchar sep, const gchar * val)
+{
+  g_string_append_c (lines, sep);
+  g_string_append (lines, val);
+}
+
+static inline void
+append_type (GString * lines, gchar type)
+{
+  g_string_append_c (lines, type);
+  g_string_append_c (lines, '=');
+}
+
+static inline void
+append_line (GString * lines, gchar type, const gchar * val)
+{
+  append_type (lines, type);
+  g_string_append (lines, val);
+  g_string_append_len (lines, "\r\n", 2);
+}
+
+static void
+append_connection (GString * lines, const GstSDPConnection * conn)
+{
+  if (!conn->nettype || !conn->addrtype || !conn->address)
+    return;
+
+  append_type (lines, 'c');
+  g_string_append (lines, conn->nettype);
+  append_field (lines, ' ', conn->addrtype);
+  append_field (lines, ' ', conn->address);
+  if (gst_sdp_address_is_multicast (conn->nettype, conn->addrtype,
+          conn->address)) {
+    /* only add TTL for IP4 multicast */
+    if (strcmp (conn->addrtype, "IP4") == 0) {
+      g_string_append_c (lines, '/');
+      append_uint (lines, conn->ttl);
+    }
+    if (conn->addr_number > 1) {
+      g_string_append_c (lines, '/');
+      append_uint (lines, conn->addr_number);
+    }
+  }
+  g_string_append_len (lines, "\r\n", 2);
+}
+
+static void
+append_bandwidth (GString * lines, const GstSDPBandwidth * bandwidth)
+{
+  append_type (lines, 'b');
+  g_string_append (lines, bandwidth->bwtype);
+  g_string_append_c (lines, ':');
+  append_uint (lines, bandwidth->bandwidth);
+  g_string_append_len (lines, "\r\n", 2);
+}
+
+static void
+append_key (GString * lines, const GstSDPKey * key)
+{
+  if (!key->type)
+    return;
+
+  append_type (lines, 'k');
+  g_string_append (lines, key->type);
+  if (key->data)
+    append_field (lines, ':', key->data);
+  g_string_append_len (lines, "\r\n", 2);
+}
+
+static void
+append_attribute (GString * lines, const GstSDPAttribute * attr)
+{
+  if (!attr->key)
+    return;
+
+  append_type (lines, 'a');
+  g_string_append (lines, attr->key);
+  if (attr->value && attr->value[0] != '\0')
+    append_field (lines, ':', attr->value);
+  g_string_append_len (lines, "\r\n", 2);
+}
+
+static void gst_sdp_media_append_text (const GstSDPMedia * media,
+    GString * lines);
+
 /**
  * gst_sdp_message_as_text:
  * @msg: a #GstSDPMessage
@@ -499,74 +606,63 @@ gst_sdp_message_as_text (const GstSDPMessage * msg)
 
   g_return_val_if_fail (msg != NULL, NULL);
 
-  lines = g_string_new ("");
+  lines = g_string_sized_new (1024);
 
   if (msg->version)
-    g_string_append_printf (lines, "v=%s\r\n", msg->version);
+    append_line (lines, 'v', msg->version);
 
   if (msg->origin.sess_id && msg->origin.sess_version && msg->origin.nettype &&
-      msg->origin.addrtype && msg->origin.addr)
-    g_string_append_printf (lines, "o=%s %s %s %s %s %s\r\n",
-        msg->origin.username ? msg->origin.username : "-", msg->origin.sess_id,
-        msg->origin.sess_version, msg->origin.nettype, msg->origin.addrtype,
-        msg->origin.addr);
+      msg->origin.addrtype && msg->origin.addr) {
+    append_type (lines, 'o');
+    g_string_append (lines,
+        msg->origin.username ? msg->origin.username : "-");
+    append_field (lines, ' ', msg->origin.sess_id);
+    append_field (lines, ' ', msg->origin.sess_version);
+    append_field (lines, ' ', msg->origin.nettype);
+    append_field (lines, ' ', msg->origin.addrtype);
+    append_field (lines, ' ', msg->origin.addr);
+    g_string_append_len (lines, "\r\n", 2);
+  }
 
   if (msg->session_name)
-    g_string_append_printf (lines, "s=%s\r\n", msg->session_name);
+    append_line (lines, 's', msg->session_name);
 
   if (msg->information)
-    g_string_append_printf (lines, "i=%s\r\n", msg->information);
+    append_line (lines, 'i', msg->information);
 
   if (msg->uri)
-    g_string_append_printf (lines, "u=%s\r\n", msg->uri);
+    append_line (lines, 'u', msg->uri);
 
   for (i = 0; i < gst_sdp_message_emails_len (msg); i++)
-    g_string_append_printf (lines, "e=%s\r\n",
-        gst_sdp_message_get_email (msg, i));
+    append_line (lines, 'e', gst_sdp_message_get_email (msg, i));
 
   for (i = 0; i < gst_sdp_message_phones_len (msg); i++)
-    g_string_append_printf (lines, "p=%s\r\n",
-        gst_sdp_message_get_phone (msg, i));
-
-  if (msg->connection.nettype && msg->connection.addrtype &&
-      msg->connection.address) {
-    g_string_append_printf (lines, "c=%s %s %s", msg->connection.nettype,
-        msg->connection.addrtype, msg->connection.address);
-    if (gst_sdp_address_is_multicast (msg->connection.nettype,
-            msg->connection.addrtype, msg->connection.address)) {
-      /* only add ttl for IP4 */
-      if (strcmp (msg->connection.addrtype, "IP4") == 0)
-        g_string_append_printf (lines, "/%u", msg->connection.ttl);
-      if (msg->connection.addr_number > 1)
-        g_string_append_printf (lines, "/%u", msg->connection.addr_number);
-    }
-    g_string_append_printf (lines, "\r\n");
-  }
+    append_line (lines, 'p', gst_sdp_message_get_phone (msg, i));
 
-  for (i = 0; i < gst_sdp_message_bandwidths_len (msg); i++) {
-    const GstSDPBandwidth *bandwidth = gst_sdp_message_get_bandwidth (msg, i);
+  append_connection (lines, &msg->connection);
 
-    g_string_append_printf (lines, "b=%s:%u\r\n", bandwidth->bwtype,
-        bandwidth->bandwidth);
-  }
+  for (i = 0; i < gst_sdp_message_bandwidths_len (msg); i++)
+    append_bandwidth (lines, gst_sdp_message_get_bandwidth (msg, i));
 
   if (gst_sdp_message_times_len (msg) == 0) {
-    g_string_append_printf (lines, "t=0 0\r\n");
+    g_string_append_len (lines, "t=0 0\r\n", 7);
   } else {
     for (i = 0; i < gst_sdp_message_times_len (msg); i++) {
       const GstSDPTime *times = gst_sdp_message_get_time (msg, i);
 
-      g_string_append_printf (lines, "t=%s %s\r\n", times->start, times->stop);
+      append_type (lines, 't');
+      g_string_append (lines, times->start);
+      append_field (lines, ' ', times->stop);
+      g_string_append_len (lines, "\r\n", 2);
 
       if (times->repeat != NULL) {
         guint j;
 
-        g_string_append_printf (lines, "r=%s",
-            g_array_index (times->repeat, gchar *, 0));
+        append_type (lines, 'r');
+        g_string_append (lines, g_array_index (times->repeat, gchar *, 0));
         for (j = 1; j < times->repeat->len; j++)
-          g_string_append_printf (lines, " %s",
-              g_array_index (times->repeat, gchar *, j));
-        g_string_append_printf (lines, "\r\n");
+          append_field (lines, ' ', g_array_index (times->repeat, gchar *, j));
+        g_string_append_len (lines, "\r\n", 2);
       }
     }
   }
@@ -574,40 +670,24 @@ gst_sdp_message_as_text (const GstSDPMessage * msg)
   if (gst_sdp_message_zones_len (msg) > 0) {
     const GstSDPZone *zone = gst_sdp_message_get_zone (msg, 0);
 
-    g_string_append_printf (lines, "z=%s %s", zone->time, zone->typed_time);
+    append_type (lines, 'z');
+    g_string_append (lines, zone->time);
+    append_field (lines, ' ', zone->typed_time);
     for (i = 1; i < gst_sdp_message_zones_len (msg); i++) {
       zone = gst_sdp_message_get_zone (msg, i);
-      g_string_append_printf (lines, " %s %s", zone->time, zone->typed_time);
+      append_field (lines, ' ', zone->time);
+      append_field (lines, ' ', zone->typed_time);
     }
-    g_string_append_printf (lines, "\r\n");
+    g_string_append_len (lines, "\r\n", 2);
   }
 
-  if (msg->key.type) {
-    g_string_append_printf (lines, "k=%s", msg->key.type);
-    if (msg->key.data)
-      g_string_append_printf (lines, ":%s", msg->key.data);
-    g_string_append_printf (lines, "\r\n");
-  }
+  append_key (lines, &msg->key);
 
-  for (i = 0; i < gst_sdp_message_attributes_len (msg); i++) {
-    const GstSDPAttribute *attr = gst_sdp_message_get_attribute (msg, i);
+  for (i = 0; i < gst_sdp_message_attributes_len (msg); i++)
+    append_attribute (lines, gst_sdp_message_get_attribute (msg, i));
 
-    if (attr->key) {
-      g_string_append_printf (lines, "a=%s", attr->key);
-      if (attr->value && attr->value[0] != '\0')
-        g_string_append_printf (lines, ":%s", attr->value);
-      g_string_append_printf (lines, "\r\n");
-    }
-  }
-
-  for (i = 0; i < gst_sdp_message_medias_len (msg); i++) {
-    const GstSDPMedia *media = gst_sdp_message_get_media (msg, i);
-    gchar *sdp_media_str;
-
-    sdp_media_str = gst_sdp_media_as_text (media);
-    g_string_append_printf (lines, "%s", sdp_media_str);
-    g_free (sdp_media_str);
-  }
+  for (i = 0; i < gst_sdp_message_medias_len (msg); i++)
+    gst_sdp_media_append_text (gst_sdp_message_get_media (msg, i), lines);
 
   return g_string_free (lines, FALSE);
 }
@@ -1959,6 +2039,47 @@ gst_sdp_media_copy (const GstSDPMedia * media, GstSDPMedia ** copy)
   return GST_SDP_OK;
 }
 
+static void
+gst_sdp_media_append_text (const GstSDPMedia * media, GString * lines)
+{
+  guint i;
+
+  if (media->media) {
+    append_type (lines, 'm');
+    g_string_append (lines, media->media);
+  }
+
+  g_string_append_c (lines, ' ');
+  append_uint (lines, media->port);
+
+  if (media->num_ports > 1) {
+    g_string_append_c (lines, '/');
+    append_uint (lines, media->num_ports);
+  }
+
+  append_field (lines, ' ', GST_STR_NULL (media->proto));
+
+  for (i = 0; i < gst_sdp_media_formats_len (media); i++)
+    append_field (lines, ' ', gst_sdp_media_get_format (media, i));
+  g_string_append_len (lines, "\r\n", 2);
+
+  if (media->information) {
+    append_type (lines, 'i');
+    g_string_append (lines, media->information);
+  }
+
+  for (i = 0; i < gst_sdp_media_connections_len (media); i++)
+    append_connection (lines, gst_sdp_media_get_connection (media, i));
+
+  for (i = 0; i < gst_sdp_media_bandwidths_len (media); i++)
+    append_bandwidth (lines, gst_sdp_media_get_bandwidth (media, i));
+
+  append_key (lines, &media->key);
+
+  for (i = 0; i < gst_sdp_media_attributes_len (media); i++)
+    append_attribute (lines, gst_sdp_media_get_attribute (media, i));
+}
+
 /**
  * gst_sdp_media_as_text:
  * @media: a #GstSDPMedia
@@ -1971,71 +2092,11 @@ gchar *
 gst_sdp_media_as_text (const GstSDPMedia * media)
 {
   GString *lines;
-  guint i;
 
   g_return_val_if_fail (media != NULL, NULL);
 
-  lines = g_string_new ("");
-
-  if (media->media)
-    g_string_append_printf (lines, "m=%s", media->media);
-
-  g_string_append_printf (lines, " %u", media->port);
-
-  if (media->num_ports > 1)
-    g_string_append_printf (lines, "/%u", media->num_ports);
-
-  g_string_append_printf (lines, " %s", media->proto);
-
-  for (i = 0; i < gst_sdp_media_formats_len (media); i++)
-    g_string_append_printf (lines, " %s", gst_sdp_media_get_format (media, i));
-  g_string_append_printf (lines, "\r\n");
-
-  if (media->information)
-    g_string_append_printf (lines, "i=%s", media->information);
-
-  for (i = 0; i < gst_sdp_media_connections_len (media); i++) {
-    const GstSDPConnection *conn = gst_sdp_media_get_connection (media, i);
-
-    if (conn->nettype && conn->addrtype && conn->address) {
-      g_string_append_printf (lines, "c=%s %s %s", conn->nettype,
-          conn->addrtype, conn->address);
-      if (gst_sdp_address_is_multicast (conn->nettype, conn->addrtype,
-              conn->address)) {
-        /* only add TTL for IP4 multicast */
-        if (strcmp (conn->addrtype, "IP4") == 0)
-          g_string_append_printf (lines, "/%u", conn->ttl);
-        if (conn->addr_number > 1)
-          g_string_append_printf (lines, "/%u", conn->addr_number);
-      }
-      g_string_append_printf (lines, "\r\n");
-    }
-  }
-
-  for (i = 0; i < gst_sdp_media_bandwidths_len (media); i++) {
-    const GstSDPBandwidth *bandwidth = gst_sdp_media_get_bandwidth (media, i);
-
-    g_string_append_printf (lines, "b=%s:%u\r\n", bandwidth->bwtype,
-        bandwidth->bandwidth);
-  }
-
-  if (media->key.type) {
-    g_string_append_printf (lines, "k=%s", media->key.type);
-    if (media->key.data)
-      g_string_append_printf (lines, ":%s", media->key.data);
-    g_string_append_printf (lines, "\r\n");
-  }
-
-  for (i = 0; i < gst_sdp_media_attributes_len (media); i++) {
-    const GstSDPAttribute *attr = gst_sdp_media_get_attribute (media, i);
-
-    if (attr->key) {
-      g_string_append_printf (lines, "a=%s", attr->key);
-      if (attr->value && attr->value[0] != '\0')
-        g_string_append_printf (lines, ":%s", attr->value);
-      g_string_append_printf (lines, "\r\n");
-    }
-  }
+  lines = g_string_sized_new (256);
+  gst_sdp_media_append_text (media, lines);
 
   return g_string_free (lines, FALSE);
 }
@@ -2929,42 +2990,49 @@ gst_sdp_media_remove_attribute (GstSDPMedia * media, guint idx)
   return GST_SDP_OK;
 }
 
-static void
-read_string (gchar * dest, guint size, gchar ** src)
+/* Skips leading spaces and NUL-terminates the next space-delimited token in
+ * place, so that the caller can use it without copying it first. Afterwards
+ * @src points past the terminator, and @delimited (if not %NULL) tells whether
+ * the token was followed by a delimiter rather than by the end of the line. */
+static gchar *
+read_string (gchar ** src, gboolean * delimited)
 {
-  guint idx;
+  gchar *start;
 
-  idx = 0;
   /* skip spaces */
   while (g_ascii_isspace (**src))
     (*src)++;
 
-  while (!g_ascii_isspace (**src) && **src != '\0') {
-    if (idx < size - 1)
-      dest[idx++] = **src;
+  start = *src;
+  while (!g_ascii_isspace (**src) && **src != '\0')
     (*src)++;
-  }
-  if (size > 0)
-    dest[idx] = '\0';
+
+  if (delimited)
+    *delimited = (**src != '\0');
+  if (**src != '\0')
+    *(*src)++ = '\0';
+
+  return start;
 }
 
-static void
-read_string_del (gchar * dest, guint size, gchar del, gchar ** src)
+/* Like read_string() but the token ends at @del, which is consumed */
+static gchar *
+read_string_del (gchar del, gchar ** src)
 {
-  guint idx;
+  gchar *start;
 
-  idx = 0;
   /* skip spaces */
   while (g_ascii_isspace (**src))
     (*src)++;
 
-  while (**src != del && **src != '\0') {
-    if (idx < size - 1)
-      dest[idx++] = **src;
+  start = *src;
+  while (**src != del && **src != '\0')
     (*src)++;
-  }
-  if (size > 0)
-    dest[idx] = '\0';
+
+  if (**src != '\0')
+    *(*src)++ = '\0';
+
+  return start;
 }
 
 enum
@@ -2980,16 +3048,17 @@ typedef struct
   GstSDPMedia *media;
 } SDPContext;
 
+/* @buffer is a scratch copy of the line owned by the caller, it is tokenized
+ * in place */
 static gboolean
 gst_sdp_parse_line (SDPContext * c, gchar type, gchar * buffer)
 {
-  gchar str[8192];
   gchar *p = buffer;
 
 #define READ_STRING(field) \
-  do { read_string (str, sizeof (str), &p); REPLACE_STRING (field, str); } while (0)
+  do { REPLACE_STRING (field, read_string (&p, NULL)); } while (0)
 #define READ_UINT(field) \
-  do { read_string (str, sizeof (str), &p); field = strtoul (str, NULL, 10); } while (0)
+  do { field = strtoul (read_string (&p, NULL), NULL, 10); } while (0)
 
   switch (type) {
     case 'v':
@@ -3026,69 +3095,71 @@ gst_sdp_parse_line (SDPContext * c, gchar type, gchar * buffer)
       break;
     case 'c':
     {
-      GstSDPConnection conn;
+      const gchar *nettype, *addrtype, *address;
+      guint ttl = 0, addr_number = 0;
       gchar *str2;
 
-      memset (&conn, 0, sizeof (conn));
-
       str2 = p;
       while ((str2 = strchr (str2, '/')))
         *str2++ = ' ';
-      READ_STRING (conn.nettype);
-      READ_STRING (conn.addrtype);
-      READ_STRING (conn.address);
+      nettype = read_string (&p, NULL);
+      addrtype = read_string (&p, NULL);
+      address = read_string (&p, NULL);
       /* only read TTL for IP4 */
-      if (strcmp (conn.addrtype, "IP4") == 0)
-        READ_UINT (conn.ttl);
-      READ_UINT (conn.addr_number);
+      if (strcmp (addrtype, "IP4") == 0)
+        READ_UINT (ttl);
+      READ_UINT (addr_number);
 
       if (c->state == SDP_SESSION) {
-        gst_sdp_message_set_connection (c->msg, conn.nettype, conn.addrtype,
-            conn.address, conn.ttl, conn.addr_number);
+        gst_sdp_message_set_connection (c->msg, nettype, addrtype, address,
+            ttl, addr_number);
       } else {
-        gst_sdp_media_add_connection (c->media, conn.nettype, conn.addrtype,
-            conn.address, conn.ttl, conn.addr_number);
+        gst_sdp_media_add_connection (c->media, nettype, addrtype, address,
+            ttl, addr_number);
       }
-      gst_sdp_connection_clear (&conn);
       break;
     }
     case 'b':
     {
-      gchar str2[32];
+      const gchar *bwtype;
+      guint bandwidth;
 
-      read_string_del (str, sizeof (str), ':', &p);
-      if (*p != '\0')
-        p++;
-      read_string (str2, sizeof (str2), &p);
+      bwtype = read_string_del (':', &p);
+      bandwidth = atoi (read_string (&p, NULL));
       if (c->state == SDP_SESSION)
-        gst_sdp_message_add_bandwidth (c->msg, str, atoi (str2));
+        gst_sdp_message_add_bandwidth (c->msg, bwtype, bandwidth);
       else
-        gst_sdp_media_add_bandwidth (c->media, str, atoi (str2));
+        gst_sdp_media_add_bandwidth (c->media, bwtype, bandwidth);
       break;
     }
     case 't':
       break;
     case 'k':
-      read_string_del (str, sizeof (str), ':', &p);
-      if (*p != '\0')
-        p++;
+    {
+      const gchar *ktype;
+
+      ktype = read_string_del (':', &p);
       if (c->state == SDP_SESSION)
-        gst_sdp_message_set_key (c->msg, str, p);
+        gst_sdp_message_set_key (c->msg, ktype, p);
       else
-        gst_sdp_media_set_key (c->media, str, p);
+        gst_sdp_media_set_key (c->media, ktype, p);
       break;
+    }
     case 'a':
-      read_string_del (str, sizeof (str), ':', &p);
-      if (*p != '\0')
-        p++;
+    {
+      const gchar *key;
+
+      key = read_string_del (':', &p);
       if (c->state == SDP_SESSION)
-        gst_sdp_message_add_attribute (c->msg, str, p);
+        gst_sdp_message_add_attribute (c->msg, key, p);
       else
-        gst_sdp_media_add_attribute (c->media, str, p);
+        gst_sdp_media_add_attribute (c->media, key, p);
       break;
+    }
     case 'm':
     {
-      gchar *slash;
+      gchar *str, *slash;
+      gboolean more;
       GstSDPMedia nmedia;
 
       c->state = SDP_MEDIA;
@@ -3097,7 +3168,7 @@ gst_sdp_parse_line (SDPContext * c, gchar type, gchar * buffer)
 
       /* m=<media> <port>/<number of ports> <proto> <fmt> ... */
       READ_STRING (nmedia.media);
-      read_string (str, sizeof (str), &p);
+      str = read_string (&p, NULL);
       slash = g_strrstr (str, "/");
       if (slash) {
         *slash = '\0';
@@ -3109,9 +3180,9 @@ gst_sdp_parse_line (SDPContext * c, gchar type, gchar * buffer)
       }
       READ_STRING (nmedia.proto);
       do {
-        read_string (str, sizeof (str), &p);
+        str = read_string (&p, &more);
         gst_sdp_media_add_format (&nmedia, str);
-      } while (*p != '\0');
+      } while (more);
 
       gst_sdp_message_add_media (c->msg, &nmedia);
       c->media =
@@ -3121,6 +3192,10 @@ gst_sdp_parse_line (SDPContext * c, gchar type, gchar * buffer)
     default:
       break;
   }
+
+#undef READ_STRING
+#undef READ_UINT
+
   return TRUE;
 }
 
@@ -236,6 +236,12 @@ struct _GstExifReader
   guint32 base_offset;
   gint byte_order;
 
+  /* the buffer stays mapped while parsing, all tag data is read in place */
+  GstMapInfo info;
+  gboolean mapped;
+  const guint8 *data;
+  gsize size;
+
   /* tags waiting for their complementary tags */
   GSList *pending_tags;
 };
@@ -473,6 +479,16 @@ gst_exif_reader_init (GstExifReader * reader, gint byte_order,
         reader->byte_order, G_BYTE_ORDER);
     reader->byte_order = G_BYTE_ORDER;
   }
+
+  reader->mapped = gst_buffer_map (buf, &reader->info, GST_MAP_READ);
+  if (reader->mapped) {
+    reader->data = reader->info.data;
+    reader->size = reader->info.size;
+  } else {
+    GST_WARNING ("Failed to map buffer for reading");
+    reader->data = NULL;
+    reader->size = 0;
+  }
 }
 
 static void
@@ -513,6 +529,12 @@ gst_exif_reader_reset (GstExifReader * reader, gboolean return_taglist)
   }
   g_slist_free (reader->pending_tags);
 
+  if (reader->mapped)
+    gst_buffer_unmap (reader->buffer, &reader->info);
+  reader->mapped = FALSE;
+  reader->data = NULL;
+  reader->size = 0;
+
   if (return_taglist) {
     ret = reader->taglist;
     reader->taglist = NULL;
@@ -1248,8 +1270,6 @@ parse_exif_ascii_tag (GstExifReader * reader, const GstExifTagMatch * tag,
   GError *error = NULL;
 
   if (count > 4) {
-    GstMapInfo info;
-
     if (offset < reader->base_offset) {
       GST_WARNING ("Offset is smaller (%u) than base offset (%u)", offset,
           reader->base_offset);
@@ -1258,19 +1278,14 @@ parse_exif_ascii_tag (GstExifReader * reader, const GstExifTagMatch * tag,
 
     real_offset = offset - reader->base_offset;
 
-    if (!gst_buffer_map (reader->buffer, &info, GST_MAP_READ)) {
-      GST_WARNING ("Failed to map buffer for reading");
-      return;
-    }
-    if (real_offset >= info.size) {
+    if (real_offset >= reader->size) {
       GST_WARNING ("Invalid offset %u for buffer of size %" G_GSIZE_FORMAT
-          ", not adding tag %s", real_offset, info.size, tag->gst_tag);
-      gst_buffer_unmap (reader->buffer, &info);
+          ", not adding tag %s", real_offset, reader->size, tag->gst_tag);
       return;
     }
 
-    str = g_strndup ((gchar *) (info.data + real_offset), count);
-    gst_buffer_unmap (reader->buffer, &info);
+    count = MIN (count, reader->size - real_offset);
+    str = g_strndup ((gchar *) (reader->data + real_offset), count);
   } else {
     str = g_strndup ((gchar *) offset_as_data, count);
   }
@@ -1378,12 +1393,10 @@ parse_exif_undefined_tag (GstExifReader * reader, const GstExifTagMatch * tag,
     guint32 count, guint32 offset, const guint8 * offset_as_data)
 {
   GType tagtype;
-  guint8 *data;
-  guint32 real_offset;
+  const guint8 *data;
+  guint32 real_offset = 0;
 
   if (count > 4) {
-    GstMapInfo info;
-
     if (offset < reader->base_offset) {
       GST_WARNING ("Offset is smaller (%u) than base offset (%u)", offset,
           reader->base_offset);
@@ -1392,28 +1405,16 @@ parse_exif_undefined_tag (GstExifReader * reader, const GstExifTagMatch * tag,
 
     real_offset = offset - reader->base_offset;
 
-    if (!gst_buffer_map (reader->buffer, &info, GST_MAP_READ)) {
-      GST_WARNING ("Failed to map buffer for reading");
-      return;
-    }
-
-    if (real_offset >= info.size) {
+    if (real_offset >= reader->size) {
       GST_WARNING ("Invalid offset %u for buffer of size %" G_GSIZE_FORMAT
-          ", not adding tag %s", real_offset, info.size, tag->gst_tag);
-      gst_buffer_unmap (reader->buffer, &info);
+          ", not adding tag %s", real_offset, reader->size, tag->gst_tag);
       return;
     }
 
-    /* +1 because it could be a string without the \0 */
-    data = malloc (sizeof (guint8) * count + 1);
-    memcpy (data, info.data + real_offset, count);
-    data[count] = 0;
-
-    gst_buffer_unmap (reader->buffer, &info);
+    count = MIN (count, reader->size - real_offset);
+    data = reader->data + real_offset;
   } else {
-    data = malloc (sizeof (guint8) * count + 1);
-    memcpy (data, (guint8 *) offset_as_data, count);
-    data[count] = 0;
+    data = offset_as_data;
   }
 
   tagtype = gst_tag_get_type (tag->gst_tag);
@@ -1421,8 +1422,14 @@ parse_exif_undefined_tag (GstExifReader * reader, const GstExifTagMatch * tag,
     GstSample *sample;
     GstBuffer *buf;
 
-    buf = gst_buffer_new_wrapped (data, count);
-    data = NULL;
+    /* share the memory of the exif buffer if the data is in there */
+    if (count > 4) {
+      buf = gst_buffer_copy_region (reader->buffer, GST_BUFFER_COPY_MEMORY,
+          real_offset, count);
+    } else {
+      buf = gst_buffer_new_allocate (NULL, count, NULL);
+      gst_buffer_fill (buf, 0, data, count);
+    }
 
     sample = gst_sample_new (buf, NULL, NULL, NULL);
     gst_tag_list_add (reader->taglist, GST_TAG_MERGE_APPEND, tag->gst_tag,
@@ -1430,14 +1437,17 @@ parse_exif_undefined_tag (GstExifReader * reader, const GstExifTagMatch * tag,
     gst_sample_unref (sample);
     gst_buffer_unref (buf);
   } else if (tagtype == G_TYPE_STRING) {
-    if (data[0] != '\0')
+    /* it could be a string without the \0 */
+    gchar *str = g_strndup ((const gchar *) data, count);
+
+    if (str[0] != '\0')
       gst_tag_list_add (reader->taglist, GST_TAG_MERGE_REPLACE, tag->gst_tag,
-          data, NULL);
+          str, NULL);
+    g_free (str);
   } else {
     GST_WARNING ("No parsing function associated to %x(%s)", tag->exif_tag,
         tag->gst_tag);
   }
-  g_free (data);
 }
 
 static gboolean
@@ -1449,7 +1459,6 @@ exif_reader_read_rational_tag (GstExifReader * exif_reader,
   guint32 real_offset;
   gint32 frac_n = 0;
   gint32 frac_d = 0;
-  GstMapInfo info;
 
   if (count > 1) {
     GST_WARNING ("Rationals with multiple entries are not supported");
@@ -1462,18 +1471,13 @@ exif_reader_read_rational_tag (GstExifReader * exif_reader,
 
   real_offset = offset - exif_reader->base_offset;
 
-  if (!gst_buffer_map (exif_reader->buffer, &info, GST_MAP_READ)) {
-    GST_WARNING ("Failed to map buffer for reading");
-    return FALSE;
-  }
-
-  if (real_offset >= info.size) {
+  if (real_offset >= exif_reader->size) {
     GST_WARNING ("Invalid offset %u for buffer of size %" G_GSIZE_FORMAT,
-        real_offset, info.size);
+        real_offset, exif_reader->size);
     goto reader_fail;
   }
 
-  gst_byte_reader_init (&data_reader, info.data, info.size);
+  gst_byte_reader_init (&data_reader, exif_reader->data, exif_reader->size);
   if (!gst_byte_reader_set_pos (&data_reader, real_offset))
     goto reader_fail;
 
@@ -1507,13 +1511,10 @@ exif_reader_read_rational_tag (GstExifReader * exif_reader,
   if (_frac_d)
     *_frac_d = frac_d;
 
-  gst_buffer_unmap (exif_reader->buffer, &info);
-
   return TRUE;
 
 reader_fail:
   GST_WARNING ("Failed to read from byte reader. (Buffer too short?)");
-  gst_buffer_unmap (exif_reader->buffer, &info);
   return FALSE;
 }
 
@@ -1707,17 +1708,14 @@ parse_exif_ifd (GstExifReader * exif_reader, gint buf_offset,
   GstByteReader reader;
   guint16 entries = 0;
   guint16 i;
-  GstMapInfo info;
 
   g_return_val_if_fail (exif_reader->byte_order == G_LITTLE_ENDIAN
       || exif_reader->byte_order == G_BIG_ENDIAN, FALSE);
 
-  if (!gst_buffer_map (exif_reader->buffer, &info, GST_MAP_READ)) {
-    GST_WARNING ("Failed to map buffer for reading");
+  if (!exif_reader->mapped)
     return FALSE;
-  }
 
-  gst_byte_reader_init (&reader, info.data, info.size);
+  gst_byte_reader_init (&reader, exif_reader->data, exif_reader->size);
   if (!gst_byte_reader_set_pos (&reader, buf_offset))
     goto invalid_offset;
 
@@ -1834,20 +1832,17 @@ parse_exif_ifd (GstExifReader * exif_reader, gint buf_offset,
       }
     }
   }
-  gst_buffer_unmap (exif_reader->buffer, &info);
 
   return TRUE;
 
 invalid_offset:
   {
     GST_WARNING ("Buffer offset invalid when parsing exif ifd");
-    gst_buffer_unmap (exif_reader->buffer, &info);
     return FALSE;
   }
 read_error:
   {
     GST_WARNING ("Failed to parse the exif ifd");
-    gst_buffer_unmap (exif_reader->buffer, &info);
     return FALSE;
   }
 }
@@ -1988,7 +1983,7 @@ gst_tag_list_from_exif_buffer_with_tiff_header (GstBuffer * buffer)
   guint32 offset;
   GstTagList *taglist = NULL;
   GstBuffer *subbuffer;
-  GstMapInfo info, sinfo;
+  GstMapInfo info;
 
   if (!gst_buffer_map (buffer, &info, GST_MAP_READ)) {
     GST_WARNING ("Failed to map buffer for reading");
@@ -2019,14 +2014,9 @@ gst_tag_list_from_exif_buffer_with_tiff_header (GstBuffer * buffer)
   if (fortytwo != 42)
     goto invalid_magic;
 
-  subbuffer = gst_buffer_new_and_alloc (info.size - (TIFF_HEADER_SIZE - 2));
-
-  if (!gst_buffer_map (subbuffer, &sinfo, GST_MAP_WRITE))
-    goto map_failed;
-
-  memcpy (sinfo.data, info.data + TIFF_HEADER_SIZE,
-      info.size - TIFF_HEADER_SIZE);
-  gst_buffer_unmap (subbuffer, &sinfo);
+  /* share the memory instead of copying everything after the header */
+  subbuffer = gst_buffer_copy_region (buffer, GST_BUFFER_COPY_MEMORY,
+      TIFF_HEADER_SIZE, info.size - TIFF_HEADER_SIZE);
 
   taglist = gst_tag_list_from_exif_buffer (subbuffer,
       endianness == TIFF_LITTLE_ENDIAN ? G_LITTLE_ENDIAN : G_BIG_ENDIAN, 8);
@@ -2038,12 +2028,6 @@ done:
 
   return taglist;
 
-map_failed:
-  {
-    GST_WARNING ("Failed to map buffer for writing");
-    gst_buffer_unref (subbuffer);
-    goto done;
-  }
 byte_reader_fail:
   {
     GST_WARNING ("Failed to read values from buffer");
@@ -2160,7 +2144,6 @@ deserialize_geo_coordinate (GstExifReader * exif_reader,
   gdouble degrees;
   gdouble minutes;
   gdouble seconds;
-  GstMapInfo info = { NULL };
 
   GST_LOG ("Starting to parse %s tag in exif 0x%x", exiftag->gst_tag,
       exiftag->exif_tag);
@@ -2217,13 +2200,9 @@ deserialize_geo_coordinate (GstExifReader * exif_reader,
     return ret;
   }
 
-  if (!gst_buffer_map (exif_reader->buffer, &info, GST_MAP_READ)) {
-    GST_WARNING ("Failed to map buffer for reading");
-    return ret;
-  }
-
   /* now parse the fractions */
-  gst_byte_reader_init (&fractions_reader, info.data, info.size);
+  gst_byte_reader_init (&fractions_reader, exif_reader->data,
+      exif_reader->size);
 
   if (!gst_byte_reader_set_pos (&fractions_reader,
           next_tagdata.offset - exif_reader->base_offset))
@@ -2246,7 +2225,6 @@ deserialize_geo_coordinate (GstExifReader * exif_reader,
         !gst_byte_reader_get_uint32_be (&fractions_reader, &seconds_d))
       goto reader_fail;
   }
-  gst_buffer_unmap (exif_reader->buffer, &info);
 
   GST_DEBUG ("Read degrees fraction for tag %s: %u/%u %u/%u %u/%u",
       exiftag->gst_tag, degrees_n, degrees_d, minutes_n, minutes_d,
@@ -2267,8 +2245,6 @@ deserialize_geo_coordinate (GstExifReader * exif_reader,
 
 reader_fail:
   GST_WARNING ("Failed to read fields from buffer (too short?)");
-  if (info.data)
-    gst_buffer_unmap (exif_reader->buffer, &info);
   return ret;
 }
 
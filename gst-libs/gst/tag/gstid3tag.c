@@ -342,6 +342,27 @@ gst_tag_id3_genre_get (const guint id)
   return &genres[idx];
 }
 
+static const gchar *
+id3_picture_type_to_tag (guint id3_picture_type,
+    GstTagImageType * tag_image_type)
+{
+  if (id3_picture_type == 0x01 || id3_picture_type == 0x02) {
+    /* file icon for preview. Don't add image-type to caps, since there
+     * is only supposed to be one of these, and the type is already indicated
+     * via the special tag */
+    *tag_image_type = GST_TAG_IMAGE_TYPE_NONE;
+    return GST_TAG_PREVIEW_IMAGE;
+  }
+
+  /* Remap the ID3v2 APIC type our ImageType enum */
+  if (id3_picture_type >= 0x3 && id3_picture_type <= 0x14)
+    *tag_image_type = (GstTagImageType) (id3_picture_type - 2);
+  else
+    *tag_image_type = GST_TAG_IMAGE_TYPE_UNDEFINED;
+
+  return GST_TAG_IMAGE;
+}
+
 /**
  * gst_tag_list_add_id3_image:
  * @tag_list: a tag list
@@ -368,21 +389,7 @@ gst_tag_list_add_id3_image (GstTagList * tag_list, const guint8 * image_data,
   g_return_val_if_fail (image_data != NULL, FALSE);
   g_return_val_if_fail (image_data_len > 0, FALSE);
 
-  if (id3_picture_type == 0x01 || id3_picture_type == 0x02) {
-    /* file icon for preview. Don't add image-type to caps, since there
-     * is only supposed to be one of these, and the type is already indicated
-     * via the special tag */
-    tag_name = GST_TAG_PREVIEW_IMAGE;
-    tag_image_type = GST_TAG_IMAGE_TYPE_NONE;
-  } else {
-    tag_name = GST_TAG_IMAGE;
-
-    /* Remap the ID3v2 APIC type our ImageType enum */
-    if (id3_picture_type >= 0x3 && id3_picture_type <= 0x14)
-      tag_image_type = (GstTagImageType) (id3_picture_type - 2);
-    else
-      tag_image_type = GST_TAG_IMAGE_TYPE_UNDEFINED;
-  }
+  tag_name = id3_picture_type_to_tag (id3_picture_type, &tag_image_type);
 
   image = gst_tag_image_data_to_image_sample (image_data, image_data_len,
       tag_image_type);
@@ -394,3 +401,25 @@ gst_tag_list_add_id3_image (GstTagList * tag_list, const guint8 * image_data,
   gst_sample_unref (image);
   return TRUE;
 }
+
+/* Like gst_tag_list_add_id3_image(), but with the image data in a buffer
+ * that ends up in the tag list without being copied */
+gboolean
+id3v2_tag_list_add_image_buffer (GstTagList * tag_list, GstBuffer * image,
+    guint id3_picture_type)
+{
+  GstTagImageType tag_image_type;
+  const gchar *tag_name;
+  GstSample *sample;
+
+  tag_name = id3_picture_type_to_tag (id3_picture_type, &tag_image_type);
+
+  sample = id3v2_image_buffer_to_image_sample (image, tag_image_type);
+
+  if (sample == NULL)
+    return FALSE;
+
+  gst_tag_list_add (tag_list, GST_TAG_MERGE_APPEND, tag_name, sample, NULL);
+  gst_sample_unref (sample);
+  return TRUE;
+}
@@ -201,7 +201,7 @@ xmp_tag_type_get_name (GstXmpTagType tagtype)
 struct _PendingXmpTag
 {
   XmpTag *xmp_tag;
-  gchar *str;
+  gchar *str;                   /* owned by the parser string chunk */
 };
 typedef struct _PendingXmpTag PendingXmpTag;
 
@@ -223,6 +223,12 @@ gst_xmp_schema_new ()
  */
 static GHashTable *__xmp_schemas;
 
+/*
+ * Mappings from xmp tag names (including the children of compound tags)
+ * into their XmpTag, used for the reverse lookups while parsing
+ */
+static GHashTable *__xmp_tags_by_name;
+
 static GstXmpSchema *
 _gst_xmp_get_schema (const gchar * name)
 {
@@ -267,6 +273,21 @@ _gst_xmp_schema_add_mapping (GstXmpSchema * schema, XmpTag * tag)
     return;
   }
   gst_xmp_schema_insert (schema, GUINT_TO_POINTER (key), tag);
+
+  if (tag->tag_name) {
+    if (!g_hash_table_contains (__xmp_tags_by_name, tag->tag_name))
+      g_hash_table_insert (__xmp_tags_by_name, (gpointer) tag->tag_name, tag);
+  } else {
+    GSList *iter;
+
+    for (iter = tag->children; iter; iter = g_slist_next (iter)) {
+      XmpTag *child = iter->data;
+
+      if (!g_hash_table_contains (__xmp_tags_by_name, child->tag_name))
+        g_hash_table_insert (__xmp_tags_by_name, (gpointer) child->tag_name,
+            child);
+    }
+  }
 }
 
 static XmpTag *
@@ -351,60 +372,18 @@ _xmp_tag_get_mapping (const gchar * gst_tag, XmpSerializationData * serdata)
 }
 #endif
 
-/* finds the gst tag that maps to this xmp tag in this schema */
-static const gchar *
-_gst_xmp_schema_get_mapping_reverse (GstXmpSchema * schema,
-    const gchar * xmp_tag, XmpTag ** _xmp_tag)
-{
-  GHashTableIter iter;
-  gpointer key, value;
-  const gchar *ret = NULL;
-
-  /* Iterate over the hashtable */
-  g_hash_table_iter_init (&iter, schema);
-  while (!ret && g_hash_table_iter_next (&iter, &key, &value)) {
-    XmpTag *xmpinfo = (XmpTag *) value;
-
-    if (xmpinfo->tag_name) {
-      if (strcmp (xmpinfo->tag_name, xmp_tag) == 0) {
-        *_xmp_tag = xmpinfo;
-        ret = g_quark_to_string (GPOINTER_TO_UINT (key));
-        goto out;
-      }
-    } else if (xmpinfo->children) {
-      GSList *iter;
-      for (iter = xmpinfo->children; iter; iter = g_slist_next (iter)) {
-        XmpTag *child = iter->data;
-        if (strcmp (child->tag_name, xmp_tag) == 0) {
-          *_xmp_tag = child;
-          ret = g_quark_to_string (GPOINTER_TO_UINT (key));
-          goto out;
-        }
-      }
-    } else {
-      g_assert_not_reached ();
-    }
-  }
-
-out:
-  return ret;
-}
-
 /* finds the gst tag that maps to this xmp tag (searches on all schemas) */
 static const gchar *
 _gst_xmp_tag_get_mapping_reverse (const gchar * xmp_tag, XmpTag ** _xmp_tag)
 {
-  GHashTableIter iter;
-  gpointer key, value;
-  const gchar *ret = NULL;
+  XmpTag *xmpinfo;
 
-  /* Iterate over the hashtable */
-  g_hash_table_iter_init (&iter, __xmp_schemas);
-  while (!ret && g_hash_table_iter_next (&iter, &key, &value)) {
-    ret = _gst_xmp_schema_get_mapping_reverse ((GstXmpSchema *) value, xmp_tag,
-        _xmp_tag);
-  }
-  return ret;
+  xmpinfo = g_hash_table_lookup (__xmp_tags_by_name, xmp_tag);
+  if (!xmpinfo)
+    return NULL;
+
+  *_xmp_tag = xmpinfo;
+  return xmpinfo->gst_tag;
 }
 
 /* utility functions/macros */
@@ -652,7 +631,6 @@ deserialize_exif_altitude (XmpTag * xmptag, GstTagList * taglist,
       GST_TAG_GEO_LOCATION_ELEVATION, value, NULL);
 
   /* clean up entry */
-  g_free (ptag->str);
   g_slice_free (PendingXmpTag, ptag);
   *pending_tags = g_slist_delete_link (*pending_tags, entry);
 }
@@ -747,7 +725,6 @@ deserialize_exif_gps_speed (XmpTag * xmptag, GstTagList * taglist,
       GST_TAG_GEO_LOCATION_MOVEMENT_SPEED, value, NULL);
 
   /* clean up entry */
-  g_free (ptag->str);
   g_slice_free (PendingXmpTag, ptag);
   *pending_tags = g_slist_delete_link (*pending_tags, entry);
 }
@@ -841,7 +818,6 @@ deserialize_exif_gps_direction (XmpTag * xmptag, GstTagList * taglist,
       NULL);
 
   /* clean up entry */
-  g_free (ptag->str);
   g_slice_free (PendingXmpTag, ptag);
   *pending_tags = g_slist_delete_link (*pending_tags, entry);
 }
@@ -942,6 +918,7 @@ _init_xmp_tag_map (gpointer user_data)
   GstXmpSchema *schema;
 
   __xmp_schemas = g_hash_table_new (g_direct_hash, g_direct_equal);
+  __xmp_tags_by_name = g_hash_table_new (g_str_hash, g_str_equal);
 
   /* add the maps */
   /* dublic code metadata
@@ -1187,6 +1164,7 @@ gst_tag_list_from_xmp_buffer (GstBuffer * buffer)
   guint i;
   XmpTag *last_xmp_tag = NULL;
   GSList *pending_tags = NULL;
+  GStringChunk *strings = NULL;
 
   /* Used for strucuture xmp tags */
   XmpTag *context_tag = NULL;
@@ -1252,6 +1230,9 @@ gst_tag_list_from_xmp_buffer (GstBuffer * buffer)
 
   /* no tag can be longer than the whole buffer */
   part = g_malloc (xp2 - xp1);
+  /* the values are only needed until the tags are deserialized, keep them
+   * in one arena instead of allocating each of them separately */
+  strings = g_string_chunk_new (xp2 - xp1);
   list = gst_tag_list_new_empty ();
 
   /* parse data into a list of nodes */
@@ -1356,7 +1337,7 @@ gst_tag_list_from_xmp_buffer (GstBuffer * buffer)
 
                   ptag = g_slice_new (PendingXmpTag);
                   ptag->xmp_tag = xmp_tag;
-                  ptag->str = g_strdup (v);
+                  ptag->str = g_string_chunk_insert (strings, v);
 
                   pending_tags = g_slist_prepend (pending_tags, ptag);
                 }
@@ -1449,7 +1430,7 @@ gst_tag_list_from_xmp_buffer (GstBuffer * buffer)
           } else {
             ptag = g_slice_new (PendingXmpTag);
             ptag->xmp_tag = last_xmp_tag;
-            ptag->str = g_strdup (part);
+            ptag->str = g_string_chunk_insert (strings, part);
 
             pending_tags = g_slist_prepend (pending_tags, ptag);
           }
@@ -1473,7 +1454,6 @@ gst_tag_list_from_xmp_buffer (GstBuffer * buffer)
 
     read_one_tag (list, ptag->xmp_tag, ptag->str, &pending_tags);
 
-    g_free (ptag->str);
     g_slice_free (PendingXmpTag, ptag);
   }
 
@@ -1489,6 +1469,8 @@ out:
   }
 
   g_free (part);
+  if (strings)
+    g_string_chunk_free (strings);
 
   gst_buffer_unmap (buffer, &info);
 
@@ -1585,13 +1567,98 @@ gst_value_serialize_xmp (const GValue * value)
   }
 }
 
+/* same output as g_markup_escape_text() but appended to @string directly,
+ * without going through an intermediate allocation for the common case */
+static void
+string_append_escaped (GString * string, const gchar * text)
+{
+  const gchar *p, *run;
+
+  for (p = text; *p; p++) {
+    guchar c = (guchar) * p;
+
+    /* control chars get escaped as character references, 0xc2 is the lead
+     * byte of the C1 control chars */
+    if ((c < 0x20 && c != '\t' && c != '\n' && c != '\r') || c == 0x7f
+        || c == 0xc2) {
+      gchar *escaped = g_markup_escape_text (text, -1);
+
+      g_string_append (string, escaped);
+      g_free (escaped);
+      return;
+    }
+  }
+
+  run = text;
+  for (p = text; *p; p++) {
+    const gchar *entity;
+
+    switch (*p) {
+      case '&':
+        entity = "&amp;";
+        break;
+      case '<':
+        entity = "&lt;";
+        break;
+      case '>':
+        entity = "&gt;";
+        break;
+      case '\'':
+        entity = "&apos;";
+        break;
+      case '"':
+        entity = "&quot;";
+        break;
+      default:
+        continue;
+    }
+    g_string_append_len (string, run, p - run);
+    g_string_append (string, entity);
+    run = p + 1;
+  }
+  g_string_append_len (string, run, p - run);
+}
+
+/* serializes @value into @data, returns FALSE if its type isn't handled */
+static gboolean
+write_one_value (GString * data, XmpTag * xmp_tag, const GValue * value)
+{
+  gchar *s;
+
+  if (!xmp_tag->serialize) {
+    /* common types are written in place */
+    switch (G_VALUE_TYPE (value)) {
+      case G_TYPE_STRING:
+        string_append_escaped (data, g_value_get_string (value));
+        return TRUE;
+      case G_TYPE_INT:
+        g_string_append_printf (data, "%d", g_value_get_int (value));
+        return TRUE;
+      case G_TYPE_UINT:
+        g_string_append_printf (data, "%u", g_value_get_uint (value));
+        return TRUE;
+      default:
+        break;
+    }
+    s = gst_value_serialize_xmp (value);
+  } else {
+    s = xmp_tag->serialize (value);
+  }
+
+  if (!s)
+    return FALSE;
+
+  g_string_append (data, s);
+  g_free (s);
+  return TRUE;
+}
+
 static void
 write_one_tag (const GstTagList * list, XmpTag * xmp_tag, gpointer user_data)
 {
   guint i = 0, ct;
   XmpSerializationData *serialization_data = user_data;
   GString *data = serialization_data->data;
-  char *s;
 
   /* struct type handled differently */
   if (xmp_tag->type == GstXmpTagTypeStruct ||
@@ -1651,17 +1718,8 @@ write_one_tag (const GstTagList * list, XmpTag * xmp_tag, gpointer user_data)
 
   /* fast path for single valued tag */
   if (ct == 1 || xmp_tag->type == GstXmpTagTypeSimple) {
-    if (xmp_tag->serialize) {
-      s = xmp_tag->serialize (gst_tag_list_get_value_index (list,
-              xmp_tag->gst_tag, 0));
-    } else {
-      s = gst_value_serialize_xmp (gst_tag_list_get_value_index (list,
-              xmp_tag->gst_tag, 0));
-    }
-    if (s) {
-      g_string_append (data, s);
-      g_free (s);
-    } else {
+    if (!write_one_value (data, xmp_tag, gst_tag_list_get_value_index (list,
+                xmp_tag->gst_tag, 0))) {
       GST_WARNING ("unhandled type for %s to xmp", xmp_tag->gst_tag);
     }
   } else {
@@ -1671,20 +1729,15 @@ write_one_tag (const GstTagList * list, XmpTag * xmp_tag, gpointer user_data)
 
     string_open_tag (data, typename);
     for (i = 0; i < ct; i++) {
+      gsize len = data->len;
+
       GST_DEBUG ("mapping %s[%u/%u] to xmp", xmp_tag->gst_tag, i, ct);
-      if (xmp_tag->serialize) {
-        s = xmp_tag->serialize (gst_tag_list_get_value_index (list,
-                xmp_tag->gst_tag, i));
-      } else {
-        s = gst_value_serialize_xmp (gst_tag_list_get_value_index (list,
-                xmp_tag->gst_tag, i));
-      }
-      if (s) {
-        string_open_tag (data, "rdf:li");
-        g_string_append (data, s);
+      string_open_tag (data, "rdf:li");
+      if (write_one_value (data, xmp_tag, gst_tag_list_get_value_index (list,
+                  xmp_tag->gst_tag, i))) {
         string_close_tag (data, "rdf:li");
-        g_free (s);
       } else {
+        g_string_truncate (data, len);
         GST_WARNING ("unhandled type for %s to xmp", xmp_tag->gst_tag);
       }
     }
@@ -176,6 +176,30 @@ id3v2_ununsync_data (const guint8 * unsync_data, guint32 * size)
   return out;
 }
 
+/* Returns a buffer holding @size bytes of frame data at @data. Large
+ * payloads that point straight into the tag buffer (i.e. that did not have to
+ * be un-unsynced or decompressed) share the memory of the tag buffer instead
+ * of being copied. */
+GstBuffer *
+id3v2_frame_data_to_buffer (ID3TagsWorking * work, const guint8 * data,
+    guint size)
+{
+  GstBuffer *buf;
+
+  if (size >= ID3V2_SHARE_MIN_SIZE && work->buffer_data != NULL &&
+      data >= work->buffer_data &&
+      data + size <= work->buffer_data + work->buffer_size) {
+    GST_LOG ("sharing %u bytes of frame data with the tag buffer", size);
+    return gst_buffer_copy_region (work->buffer, GST_BUFFER_COPY_MEMORY,
+        data - work->buffer_data, size);
+  }
+
+  buf = gst_buffer_new_and_alloc (size);
+  gst_buffer_fill (buf, 0, data, size);
+
+  return buf;
+}
+
 /**
  * gst_tag_list_from_id3v2_tag:
  * @buffer: buffer to convert
@@ -188,6 +212,30 @@ id3v2_ununsync_data (const guint8 * unsync_data, guint32 * size)
  */
 GstTagList *
 gst_tag_list_from_id3v2_tag (GstBuffer * buffer)
+{
+  return gst_tag_list_from_id3v2_tag_filtered (buffer, NULL);
+}
+
+/**
+ * gst_tag_list_from_id3v2_tag_filtered:
+ * @buffer: buffer to convert
+ * @skip_frames: (array zero-terminated=1) (nullable): %NULL-terminated array
+ *     of ID3v2.4 frame identifiers (e.g. "APIC") of frames to skip, or %NULL
+ *
+ * Like gst_tag_list_from_id3v2_tag(), but frames with an identifier listed
+ * in @skip_frames are skipped without being parsed or copied. This is useful
+ * to avoid the cost of e.g. large attached pictures when they are not needed.
+ * Frame identifiers of older ID3v2 revisions are converted to their ID3v2.4
+ * equivalent before being matched.
+ *
+ * Returns: A new #GstTagList with all tags that could be extracted from the
+ *          given buffer or NULL on error.
+ *
+ * Since: 1.18
+ */
+GstTagList *
+gst_tag_list_from_id3v2_tag_filtered (GstBuffer * buffer,
+    const gchar ** skip_frames)
 {
   GstMapInfo info;
   guint8 *uu_data = NULL;
@@ -233,6 +281,9 @@ gst_tag_list_from_id3v2_tag (GstBuffer * buffer)
 
   memset (&work, 0, sizeof (ID3TagsWorking));
   work.buffer = buffer;
+  work.buffer_data = info.data;
+  work.buffer_size = info.size;
+  work.skip_frames = skip_frames;
   work.hdr.version = version;
   work.hdr.size = read_size;
   work.hdr.flags = flags;
@@ -399,7 +450,7 @@ convert_fid_to_v240 (gchar * frame_id)
 /* add unknown or unhandled ID3v2 frames to the taglist as binary blobs */
 static void
 id3v2_add_id3v2_frame_blob_to_taglist (ID3TagsWorking * work,
-    guint8 * frame_data, guint frame_size)
+    const guint8 * frame_data, guint frame_size)
 {
   GstBuffer *blob;
   GstSample *sample;
@@ -407,20 +458,12 @@ id3v2_add_id3v2_frame_blob_to_taglist (ID3TagsWorking * work,
   GstCaps *caps;
   gchar *media_type;
 #endif
-  guint i;
 
-  blob = gst_buffer_new_and_alloc (frame_size);
-  gst_buffer_fill (blob, 0, frame_data, frame_size);
+  blob = id3v2_frame_data_to_buffer (work, frame_data, frame_size);
 
   sample = gst_sample_new (blob, NULL, NULL, NULL);
   gst_buffer_unref (blob);
 
-  /* Sanitize frame id */
-  for (i = 0; i < 4; i++) {
-    if (!g_ascii_isalnum (frame_data[i]))
-      frame_data[i] = '_';
-  }
-
 #if 0
   media_type = g_strdup_printf ("application/x-gst-id3v2-%c%c%c%c-frame",
       g_ascii_tolower (frame_data[0]), g_ascii_tolower (frame_data[1]),
@@ -588,7 +631,11 @@ id3v2_frames_to_tag_list (ID3TagsWorking * work, guint size)
 #undef flag_str
 #endif
 
-    if (!obsolete_id) {
+    if (!obsolete_id && work->skip_frames != NULL &&
+        g_strv_contains ((const gchar * const *) work->skip_frames,
+            frame_id)) {
+      GST_LOG ("Skipping frame with id %s", frame_id);
+    } else if (!obsolete_id) {
       /* Now, read, decompress etc the contents of the frame
        * into a TagList entry */
       work->cur_frame_size = frame_size;
@@ -27,6 +27,9 @@ G_BEGIN_DECLS
 #define ID3V2_MARK_SIZE 3
 #define ID3V2_HDR_SIZE GST_TAG_ID3V2_HEADER_SIZE
 
+/* Frame payloads at least this large are not copied out of the tag buffer */
+#define ID3V2_SHARE_MIN_SIZE 4096
+
 /* From id3v2.c */
 guint id3v2_read_synch_uint (const guint8 * data, guint size);
 
@@ -54,6 +57,13 @@ typedef struct {
   GstBuffer *buffer;
   GstTagList *tags;
 
+  /* Mapped data of the tag buffer, for sharing large frame payloads */
+  const guint8 *buffer_data;
+  gsize buffer_size;
+
+  /* NULL-terminated list of frame ids not to parse, or NULL */
+  const gchar **skip_frames;
+
   /* Current frame decoding */
   guint cur_frame_size;
   gchar *frame_id;
@@ -109,6 +119,18 @@ enum {
  */
 #define GST_TAG_ID3V2_FRAME                  "private-id3v2-frame"
 
+/* From id3v2.c */
+GstBuffer * id3v2_frame_data_to_buffer (ID3TagsWorking * work,
+    const guint8 * data, guint size);
+
+/* From tags.c */
+GstSample * id3v2_image_buffer_to_image_sample (GstBuffer * image,
+    GstTagImageType image_type);
+
+/* From gstid3tag.c */
+gboolean id3v2_tag_list_add_image_buffer (GstTagList * tag_list,
+    GstBuffer * image, guint id3_picture_type);
+
 /* From id3v2frames.c */
 gboolean id3v2_parse_frame (ID3TagsWorking *work);
 
@@ -571,6 +571,8 @@ parse_picture_frame (ID3TagsWorking * work)
 {
   guint8 txt_encoding, pic_type;
   gchar *mime_str = NULL;
+  GstBuffer *image;
+  gboolean added;
   gint len, datalen;
 
   GST_LOG ("APIC frame (ID3v2.%u)", ID3V2_VER_MAJOR (work->hdr.version));
@@ -634,10 +636,13 @@ parse_picture_frame (ID3TagsWorking * work)
   if (work->parse_size <= 0)
     goto not_enough_data;
 
-  if (!gst_tag_list_add_id3_image (work->tags, (guint8 *) work->parse_data,
-          work->parse_size, pic_type)) {
+  image = id3v2_frame_data_to_buffer (work, work->parse_data,
+      work->parse_size);
+  added = id3v2_tag_list_add_image_buffer (work->tags, image, pic_type);
+  gst_buffer_unref (image);
+
+  if (!added)
     goto error;
-  }
 
   g_free (mime_str);
   return TRUE;
@@ -533,6 +533,10 @@ gboolean                gst_tag_list_add_id3_image (GstTagList   * tag_list,
 GST_TAG_API
 GstTagList *            gst_tag_list_from_id3v2_tag (GstBuffer * buffer);
 
+GST_TAG_API
+GstTagList *            gst_tag_list_from_id3v2_tag_filtered (GstBuffer    * buffer,
+                                                              const gchar ** skip_frames);
+
 GST_TAG_API
 guint                   gst_tag_get_id3v2_tag_size  (GstBuffer * buffer);
 
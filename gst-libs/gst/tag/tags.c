@@ -485,6 +485,66 @@ beach:
   return NULL;
 }
 
+static GstSample *
+image_sample_new (GstBuffer * image, GstCaps * caps,
+    GstTagImageType image_type)
+{
+  GstStructure *image_info = NULL;
+
+  if (image_type != GST_TAG_IMAGE_TYPE_NONE) {
+    GST_LOG ("Setting image type: %d", image_type);
+    image_info = gst_structure_new ("GstTagImageInfo",
+        "image-type", GST_TYPE_TAG_IMAGE_TYPE, image_type, NULL);
+  }
+  return gst_sample_new (image, caps, NULL, image_info);
+}
+
+/* Like gst_tag_image_data_to_image_sample(), but takes a buffer with the
+ * image data, which is used as-is instead of being copied unless it turns
+ * out to be a URI list that needs a NUL terminator. */
+GstSample *
+id3v2_image_buffer_to_image_sample (GstBuffer * image,
+    GstTagImageType image_type)
+{
+  const gchar *name;
+  GstSample *sample;
+  GstCaps *caps;
+
+  caps = gst_type_find_helper_for_buffer (NULL, image, NULL);
+
+  if (caps == NULL) {
+    GST_DEBUG ("Could not determine GStreamer media type, ignoring image");
+    return NULL;
+  }
+
+  GST_DEBUG ("Found GStreamer media type: %" GST_PTR_FORMAT, caps);
+
+  name = gst_structure_get_name (gst_caps_get_structure (caps, 0));
+
+  if (g_str_equal (name, "text/uri-list")) {
+    GstMapInfo info;
+
+    gst_caps_unref (caps);
+    gst_buffer_map (image, &info, GST_MAP_READ);
+    sample = gst_tag_image_data_to_image_sample (info.data, info.size,
+        image_type);
+    gst_buffer_unmap (image, &info);
+    return sample;
+  }
+
+  if (!g_str_has_prefix (name, "image/") &&
+      !g_str_has_prefix (name, "video/")) {
+    GST_DEBUG ("Unexpected image type '%s', ignoring image frame", name);
+    gst_caps_unref (caps);
+    return NULL;
+  }
+
+  sample = image_sample_new (image, caps, image_type);
+  gst_caps_unref (caps);
+
+  return sample;
+}
+
 /**
  * gst_tag_image_data_to_image_sample:
  * @image_data: (array length=image_data_len): the (encoded) image
@@ -527,7 +587,6 @@ gst_tag_image_data_to_image_sample (const guint8 * image_data,
   GstSample *sample;
   GstCaps *caps;
   GstMapInfo info;
-  GstStructure *image_info = NULL;
 
   g_return_val_if_fail (image_data != NULL, NULL);
   g_return_val_if_fail (image_data_len > 0, NULL);
@@ -569,12 +628,7 @@ gst_tag_image_data_to_image_sample (const guint8 * image_data,
   if (!g_str_equal (name, "text/uri-list"))
     gst_buffer_set_size (image, image_data_len);
 
-  if (image_type != GST_TAG_IMAGE_TYPE_NONE) {
-    GST_LOG ("Setting image type: %d", image_type);
-    image_info = gst_structure_new ("GstTagImageInfo",
-        "image-type", GST_TYPE_TAG_IMAGE_TYPE, image_type, NULL);
-  }
-  sample = gst_sample_new (image, caps, NULL, image_info);
+  sample = image_sample_new (image, caps, image_type);
   gst_buffer_unref (image);
   gst_caps_unref (caps);
 
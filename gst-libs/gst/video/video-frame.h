@@ -176,6 +176,9 @@ gboolean    gst_video_frame_copy_plane    (GstVideoFrame *dest, const GstVideoFr
  * @GST_VIDEO_BUFFER_FLAG_BOTTOM_FIELD: The video frame has the bottom field only. This is
  *                                     the same as GST_VIDEO_BUFFER_FLAG_ONEFIELD
  *                                     (GST_VIDEO_BUFFER_FLAG_TFF flag unset) (Since: 1.16).
+ * @GST_VIDEO_BUFFER_FLAG_DUPLICATE:   The #GstBuffer repeats the content of the previous
+ *                                     buffer, e.g. because it was duplicated to fill a gap.
+ *                                     Encoders can encode it as a skipped frame (Since: 1.18).
  * @GST_VIDEO_BUFFER_FLAG_LAST:        Offset to define more flags
  *
  * Additional video buffer flags. These flags can potentially be used on any
@@ -193,6 +196,8 @@ typedef enum {
   GST_VIDEO_BUFFER_FLAG_MULTIPLE_VIEW = (GST_BUFFER_FLAG_LAST << 4),
   GST_VIDEO_BUFFER_FLAG_FIRST_IN_BUNDLE = (GST_BUFFER_FLAG_LAST << 5),
 
+  GST_VIDEO_BUFFER_FLAG_DUPLICATE   = (GST_BUFFER_FLAG_LAST << 6),
+
   GST_VIDEO_BUFFER_FLAG_TOP_FIELD   = GST_VIDEO_BUFFER_FLAG_TFF |
                                       GST_VIDEO_BUFFER_FLAG_ONEFIELD,
   GST_VIDEO_BUFFER_FLAG_BOTTOM_FIELD = GST_VIDEO_BUFFER_FLAG_ONEFIELD,
@@ -157,10 +157,14 @@ static void gst_audio_interleave_release_pad (GstElement * element,
 
 static gboolean gst_audio_interleave_stop (GstAggregator * agg);
 
+static GstBuffer *gst_audio_interleave_create_output_buffer (GstAudioAggregator
+    * aagg, guint num_frames);
 static gboolean
 gst_audio_interleave_aggregate_one_buffer (GstAudioAggregator * aagg,
     GstAudioAggregatorPad * aaggpad, GstBuffer * inbuf, guint in_offset,
     GstBuffer * outbuf, guint out_offset, guint num_samples);
+static void gst_audio_interleave_finish_output_buffer (GstAudioAggregator *
+    aagg, GstBuffer * outbuf);
 
 
 static void
@@ -347,59 +351,30 @@ gst_audio_interleave_get_channel_mask (GstAudioInterleave * self)
 }
 
 
-#define MAKE_FUNC(type) \
-static void interleave_##type (guint##type *out, guint##type *in, \
-    guint stride, guint nframes) \
-{ \
-  gint i; \
-  \
-  for (i = 0; i < nframes; i++) { \
-    *out = in[i]; \
-    out += stride; \
-  } \
-}
-
-MAKE_FUNC (8);
-MAKE_FUNC (16);
-MAKE_FUNC (32);
-MAKE_FUNC (64);
+typedef struct
+{
+  GstBuffer *buffer;
+  GstMapInfo map;
+  const guint8 *data;
+  guint channel;
+  guint out_offset;
+  guint num_frames;
+  gboolean done;
+} GstAudioInterleaveInput;
 
 static void
-interleave_24 (guint8 * out, guint8 * in, guint stride, guint nframes)
+gst_audio_interleave_clear_pending (GstAudioInterleave * self)
 {
-  gint i;
+  guint i;
 
-  for (i = 0; i < nframes; i++) {
-    memcpy (out, in, 3);
-    out += stride * 3;
-    in += 3;
-  }
-}
+  for (i = 0; i < self->pending->len; i++) {
+    GstAudioInterleaveInput *input =
+        &g_array_index (self->pending, GstAudioInterleaveInput, i);
 
-static void
-gst_audio_interleave_set_process_function (GstAudioInterleave * self,
-    GstAudioInfo * info)
-{
-  switch (GST_AUDIO_INFO_WIDTH (info)) {
-    case 8:
-      self->func = (GstInterleaveFunc) interleave_8;
-      break;
-    case 16:
-      self->func = (GstInterleaveFunc) interleave_16;
-      break;
-    case 24:
-      self->func = (GstInterleaveFunc) interleave_24;
-      break;
-    case 32:
-      self->func = (GstInterleaveFunc) interleave_32;
-      break;
-    case 64:
-      self->func = (GstInterleaveFunc) interleave_64;
-      break;
-    default:
-      g_assert_not_reached ();
-      break;
+    gst_buffer_unmap (input->buffer, &input->map);
+    gst_buffer_unref (input->buffer);
   }
+  g_array_set_size (self->pending, 0);
 }
 
 
@@ -531,20 +506,6 @@ gst_audio_interleave_update_src_caps (GstAggregator * agg, GstCaps * caps,
   return GST_FLOW_OK;
 }
 
-static gboolean
-gst_audio_interleave_negotiated_src_caps (GstAggregator * agg, GstCaps * caps)
-{
-  GstAudioInterleave *self = GST_AUDIO_INTERLEAVE (agg);
-  GstAudioAggregatorPad *srcpad = GST_AUDIO_AGGREGATOR_PAD (agg->srcpad);
-
-  if (!GST_AGGREGATOR_CLASS (parent_class)->negotiated_src_caps (agg, caps))
-    return FALSE;
-
-  gst_audio_interleave_set_process_function (self, &srcpad->info);
-
-  return TRUE;
-}
-
 static void
 gst_audio_interleave_class_init (GstAudioInterleaveClass * klass)
 {
@@ -577,9 +538,12 @@ gst_audio_interleave_class_init (GstAudioInterleaveClass * klass)
   agg_class->sink_event = GST_DEBUG_FUNCPTR (gst_audio_interleave_sink_event);
   agg_class->stop = gst_audio_interleave_stop;
   agg_class->update_src_caps = gst_audio_interleave_update_src_caps;
-  agg_class->negotiated_src_caps = gst_audio_interleave_negotiated_src_caps;
 
+  aagg_class->create_output_buffer =
+      gst_audio_interleave_create_output_buffer;
   aagg_class->aggregate_one_buffer = gst_audio_interleave_aggregate_one_buffer;
+  aagg_class->finish_output_buffer =
+      gst_audio_interleave_finish_output_buffer;
 
   /**
    * GstInterleave:channel-positions
@@ -628,6 +592,7 @@ gst_audio_interleave_init (GstAudioInterleave * self)
   self->input_channel_positions = g_value_array_new (0);
   self->channel_positions_from_input = TRUE;
   self->channel_positions = self->input_channel_positions;
+  self->pending = g_array_new (FALSE, FALSE, sizeof (GstAudioInterleaveInput));
 }
 
 static void
@@ -646,6 +611,10 @@ gst_audio_interleave_finalize (GObject * object)
     self->input_channel_positions = NULL;
   }
 
+  gst_audio_interleave_clear_pending (self);
+  g_array_free (self->pending, TRUE);
+  g_free (self->pending_src);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -711,6 +680,7 @@ gst_audio_interleave_stop (GstAggregator * agg)
     return FALSE;
 
   gst_caps_replace (&self->sinkcaps, NULL);
+  gst_audio_interleave_clear_pending (self);
 
   return TRUE;
 }
@@ -807,6 +777,22 @@ gst_audio_interleave_release_pad (GstElement * element, GstPad * pad)
 
 
 /* Called with object lock and pad object lock held */
+static GstBuffer *
+gst_audio_interleave_create_output_buffer (GstAudioAggregator * aagg,
+    guint num_frames)
+{
+  GstAudioInterleave *self = GST_AUDIO_INTERLEAVE (aagg);
+
+  /* inputs of an output buffer that was dropped */
+  gst_audio_interleave_clear_pending (self);
+
+  return GST_AUDIO_AGGREGATOR_CLASS (parent_class)->create_output_buffer
+      (aagg, num_frames);
+}
+
+/* Only collects the input, interleaving each pad on its own would do one
+ * strided pass over the output buffer per channel. All inputs are
+ * interleaved together in finish_output_buffer. */
 static gboolean
 gst_audio_interleave_aggregate_one_buffer (GstAudioAggregator * aagg,
     GstAudioAggregatorPad * aaggpad, GstBuffer * inbuf, guint in_offset,
@@ -814,47 +800,101 @@ gst_audio_interleave_aggregate_one_buffer (GstAudioAggregator * aagg,
 {
   GstAudioInterleave *self = GST_AUDIO_INTERLEAVE (aagg);
   GstAudioInterleavePad *pad = GST_AUDIO_INTERLEAVE_PAD (aaggpad);
-  GstMapInfo inmap;
-  GstMapInfo outmap;
-  gint out_width, in_bpf, out_bpf, out_channels, channel;
-  guint8 *outdata;
-  GstAggregator *agg = GST_AGGREGATOR (aagg);
-  GstAudioAggregatorPad *srcpad = GST_AUDIO_AGGREGATOR_PAD (agg->srcpad);
+  GstAudioInterleaveInput input;
+  gint in_bpf, out_channels;
 
   GST_OBJECT_LOCK (aagg);
   GST_OBJECT_LOCK (aaggpad);
 
-  out_width = GST_AUDIO_INFO_WIDTH (&srcpad->info) / 8;
   in_bpf = GST_AUDIO_INFO_BPF (&aaggpad->info);
-  out_bpf = GST_AUDIO_INFO_BPF (&srcpad->info);
-  out_channels = GST_AUDIO_INFO_CHANNELS (&srcpad->info);
+  out_channels = GST_AUDIO_INFO_CHANNELS (&GST_AUDIO_AGGREGATOR_PAD
+      (GST_AGGREGATOR_SRC_PAD (aagg))->info);
 
-  gst_buffer_map (outbuf, &outmap, GST_MAP_READWRITE);
-  gst_buffer_map (inbuf, &inmap, GST_MAP_READ);
   GST_LOG_OBJECT (pad, "interleaves %u frames on channel %d/%d at offset %u"
       " from offset %u", num_frames, pad->channel, out_channels,
-      out_offset * out_bpf, in_offset * in_bpf);
+      out_offset, in_offset * in_bpf);
 
   if (self->channels > 64) {
-    channel = pad->channel;
+    input.channel = pad->channel;
   } else {
-    channel = self->default_channels_ordering_map[pad->channel];
+    input.channel = self->default_channels_ordering_map[pad->channel];
   }
 
-  outdata = outmap.data + (out_offset * out_bpf) + (out_width * channel);
+  input.buffer = gst_buffer_ref (inbuf);
+  gst_buffer_map (input.buffer, &input.map, GST_MAP_READ);
+  input.data = input.map.data + in_offset * in_bpf;
+  input.out_offset = out_offset;
+  input.num_frames = num_frames;
+  input.done = FALSE;
+  g_array_append_val (self->pending, input);
 
+  GST_OBJECT_UNLOCK (aaggpad);
+  GST_OBJECT_UNLOCK (aagg);
 
-  self->func (outdata, inmap.data + (in_offset * in_bpf), out_channels,
-      num_frames);
+  return TRUE;
+}
 
+static void
+gst_audio_interleave_finish_output_buffer (GstAudioAggregator * aagg,
+    GstBuffer * outbuf)
+{
+  GstAudioInterleave *self = GST_AUDIO_INTERLEAVE (aagg);
+  GstAudioAggregatorPad *srcpad =
+      GST_AUDIO_AGGREGATOR_PAD (GST_AGGREGATOR_SRC_PAD (aagg));
+  const GstAudioFormatInfo *finfo;
+  GstMapInfo outmap;
+  guint i, j, out_channels, out_bpf;
 
-  gst_buffer_unmap (inbuf, &inmap);
-  gst_buffer_unmap (outbuf, &outmap);
+  if (self->pending->len == 0)
+    return;
 
-  GST_OBJECT_UNLOCK (aaggpad);
+  GST_OBJECT_LOCK (aagg);
+  finfo = srcpad->info.finfo;
+  out_channels = GST_AUDIO_INFO_CHANNELS (&srcpad->info);
+  out_bpf = GST_AUDIO_INFO_BPF (&srcpad->info);
   GST_OBJECT_UNLOCK (aagg);
 
-  return TRUE;
+  if (self->pending_src_size < out_channels) {
+    g_free (self->pending_src);
+    self->pending_src = g_new (gpointer, out_channels);
+    self->pending_src_size = out_channels;
+  }
+
+  gst_buffer_map (outbuf, &outmap, GST_MAP_READWRITE);
+
+  /* usually all pads cover the same frames and this is a single pass over
+   * the output, pads that are behind or ahead get their own passes */
+  for (i = 0; i < self->pending->len; i++) {
+    GstAudioInterleaveInput *first =
+        &g_array_index (self->pending, GstAudioInterleaveInput, i);
+
+    if (first->done)
+      continue;
+
+    memset (self->pending_src, 0, out_channels * sizeof (gpointer));
+    for (j = i; j < self->pending->len; j++) {
+      GstAudioInterleaveInput *input =
+          &g_array_index (self->pending, GstAudioInterleaveInput, j);
+
+      if (input->done || input->out_offset != first->out_offset
+          || input->num_frames != first->num_frames)
+        continue;
+
+      if (input->channel < out_channels)
+        self->pending_src[input->channel] = (gpointer) input->data;
+      input->done = TRUE;
+    }
+
+    g_assert ((first->out_offset + first->num_frames) * out_bpf <=
+        outmap.size);
+    gst_audio_format_interleave (finfo,
+        outmap.data + first->out_offset * out_bpf, self->pending_src,
+        out_channels, first->num_frames);
+  }
+
+  gst_buffer_unmap (outbuf, &outmap);
+
+  gst_audio_interleave_clear_pending (self);
 }
 
 
@@ -44,9 +44,6 @@ typedef struct _GstAudioInterleaveClass        GstAudioInterleaveClass;
 typedef struct _GstAudioInterleavePad GstAudioInterleavePad;
 typedef struct _GstAudioInterleavePadClass GstAudioInterleavePadClass;
 
-typedef void (*GstInterleaveFunc) (gpointer out, gpointer in, guint stride,
-    guint nframes);
-
 /**
  * GstAudioInterleave:
  *
@@ -66,7 +63,11 @@ struct _GstAudioInterleave {
 
   gint default_channels_ordering_map[64];
 
-  GstInterleaveFunc func;
+  /* inputs of the current output buffer, interleaved all at once when the
+   * output buffer is finished */
+  GArray *pending;
+  gpointer *pending_src;
+  guint pending_src_size;
 };
 
 struct _GstAudioInterleaveClass {
@@ -49,6 +49,21 @@
  * * "mute": Whether to mute the pad or not (#gboolean)
  * * "volume": The volume of the pad, between 0.0 and 10.0 (#gdouble)
  *
+ * Mix-minus outputs can be requested with the "minus_%u" src pad template.
+ * The "minus_N" pad outputs the mix of all inputs except the one of the
+ * "sink_N" pad, which has to be requested first. This is typically used for
+ * conferencing, where every participant needs to hear everybody but
+ * themselves. As long as there are mix-minus pads, all inputs are first
+ * accumulated at a higher precision and only clamped to the output format
+ * once per output, so the result does not depend on the order of the pads.
+ * Seeks and other upstream events have to be sent to the "src" pad, the
+ * mix-minus pads follow its segment and caps.
+ *
+ * The mix-minus pads push their buffers synchronously from the streaming
+ * thread of the "src" pad. Each "minus_N" branch, like the "src" branch,
+ * needs a queue, otherwise a branch that blocks, e.g. a sink waiting for
+ * preroll, stops all other outputs.
+ *
  * ## Example launch line
  * |[
  * gst-launch-1.0 audiotestsrc freq=100 ! audiomixer name=mix ! audioconvert ! alsasink audiotestsrc freq=500 ! mix.
@@ -62,6 +77,7 @@
 
 #include "gstaudiomixer.h"
 #include <gst/audio/audio.h>
+#include <stdio.h>              /* sscanf */
 #include <string.h>             /* strcmp */
 #include "gstaudiomixerorc.h"
 
@@ -141,6 +157,17 @@ gst_audiomixer_pad_set_property (GObject * object, guint prop_id,
   }
 }
 
+static void
+gst_audiomixer_pad_finalize (GObject * object)
+{
+  GstAudioMixerPad *pad = GST_AUDIO_MIXER_PAD (object);
+
+  gst_clear_object (&pad->minus_pad);
+  g_free (pad->own);
+
+  G_OBJECT_CLASS (gst_audiomixer_pad_parent_class)->finalize (object);
+}
+
 static void
 gst_audiomixer_pad_class_init (GstAudioMixerPadClass * klass)
 {
@@ -148,6 +175,7 @@ gst_audiomixer_pad_class_init (GstAudioMixerPadClass * klass)
 
   gobject_class->set_property = gst_audiomixer_pad_set_property;
   gobject_class->get_property = gst_audiomixer_pad_get_property;
+  gobject_class->finalize = gst_audiomixer_pad_finalize;
 
   g_object_class_install_property (gobject_class, PROP_PAD_VOLUME,
       g_param_spec_double ("volume", "Volume", "Volume of this pad",
@@ -163,7 +191,13 @@ static void
 gst_audiomixer_pad_init (GstAudioMixerPad * pad)
 {
   pad->volume = DEFAULT_PAD_VOLUME;
+  pad->volume_i8 = pad->volume * VOLUME_UNITY_INT8;
+  pad->volume_i16 = pad->volume * VOLUME_UNITY_INT16;
+  pad->volume_i32 = pad->volume * VOLUME_UNITY_INT32;
   pad->mute = DEFAULT_PAD_MUTE;
+
+  gst_audio_info_init (&pad->minus_info);
+  gst_segment_init (&pad->minus_segment, GST_FORMAT_UNDEFINED);
 }
 
 enum
@@ -190,6 +224,13 @@ GST_STATIC_PAD_TEMPLATE ("src",
     GST_STATIC_CAPS (CAPS)
     );
 
+static GstStaticPadTemplate gst_audiomixer_minus_template =
+GST_STATIC_PAD_TEMPLATE ("minus_%u",
+    GST_PAD_SRC,
+    GST_PAD_REQUEST,
+    GST_STATIC_CAPS (CAPS)
+    );
+
 #define SINK_CAPS \
   GST_STATIC_CAPS (GST_AUDIO_CAPS_MAKE (GST_AUDIO_FORMATS_ALL) \
       ", layout=interleaved")
@@ -212,22 +253,38 @@ static GstPad *gst_audiomixer_request_new_pad (GstElement * element,
     GstPadTemplate * temp, const gchar * req_name, const GstCaps * caps);
 static void gst_audiomixer_release_pad (GstElement * element, GstPad * pad);
 
+static void gst_audiomixer_finalize (GObject * object);
+static gboolean gst_audiomixer_stop (GstAggregator * agg);
+static GstFlowReturn gst_audiomixer_flush (GstAggregator * agg);
+static GstFlowReturn gst_audiomixer_aggregate (GstAggregator * agg,
+    gboolean timeout);
+
+static GstBuffer *gst_audiomixer_create_output_buffer (GstAudioAggregator *
+    aagg, guint num_frames);
 static gboolean
 gst_audiomixer_aggregate_one_buffer (GstAudioAggregator * aagg,
     GstAudioAggregatorPad * aaggpad, GstBuffer * inbuf, guint in_offset,
     GstBuffer * outbuf, guint out_offset, guint num_samples);
+static void gst_audiomixer_finish_output_buffer (GstAudioAggregator * aagg,
+    GstBuffer * outbuf);
 
 
 static void
 gst_audiomixer_class_init (GstAudioMixerClass * klass)
 {
+  GObjectClass *gobject_class = (GObjectClass *) klass;
   GstElementClass *gstelement_class = (GstElementClass *) klass;
+  GstAggregatorClass *agg_class = (GstAggregatorClass *) klass;
   GstAudioAggregatorClass *aagg_class = (GstAudioAggregatorClass *) klass;
 
+  gobject_class->finalize = gst_audiomixer_finalize;
+
   gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
       &gst_audiomixer_src_template, GST_TYPE_AUDIO_AGGREGATOR_CONVERT_PAD);
   gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
       &gst_audiomixer_sink_template, GST_TYPE_AUDIO_MIXER_PAD);
+  gst_element_class_add_static_pad_template (gstelement_class,
+      &gst_audiomixer_minus_template);
   gst_element_class_set_static_metadata (gstelement_class, "AudioMixer",
       "Generic/Audio", "Mixes multiple audio streams",
       "Sebastian Dröge <sebastian@centricular.com>");
@@ -237,12 +294,295 @@ gst_audiomixer_class_init (GstAudioMixerClass * klass)
   gstelement_class->release_pad =
       GST_DEBUG_FUNCPTR (gst_audiomixer_release_pad);
 
+  agg_class->stop = GST_DEBUG_FUNCPTR (gst_audiomixer_stop);
+  agg_class->flush = GST_DEBUG_FUNCPTR (gst_audiomixer_flush);
+  agg_class->aggregate = GST_DEBUG_FUNCPTR (gst_audiomixer_aggregate);
+
+  aagg_class->create_output_buffer = gst_audiomixer_create_output_buffer;
   aagg_class->aggregate_one_buffer = gst_audiomixer_aggregate_one_buffer;
+  aagg_class->finish_output_buffer = gst_audiomixer_finish_output_buffer;
 }
 
 static void
 gst_audiomixer_init (GstAudioMixer * audiomixer)
 {
+  gst_audio_info_init (&audiomixer->accumulate_info);
+}
+
+static void
+gst_audiomixer_finalize (GObject * object)
+{
+  GstAudioMixer *audiomixer = GST_AUDIO_MIXER (object);
+
+  g_free (audiomixer->accumulator);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+/* Mix-minus pads */
+
+static gboolean
+gst_audiomixer_minus_event (GstPad * pad, GstObject * parent, GstEvent * event)
+{
+  /* the mix-minus pads follow the src pad, seeks and everything else
+   * upstream have to go there */
+  GST_DEBUG_OBJECT (pad, "dropping %" GST_PTR_FORMAT, event);
+  gst_event_unref (event);
+
+  return FALSE;
+}
+
+static gboolean
+gst_audiomixer_minus_query (GstPad * pad, GstObject * parent, GstQuery * query)
+{
+  switch (GST_QUERY_TYPE (query)) {
+    case GST_QUERY_CAPS:
+    {
+      GstCaps *filter, *caps;
+
+      gst_query_parse_caps (query, &filter);
+
+      caps = gst_pad_get_current_caps (GST_AGGREGATOR_SRC_PAD (parent));
+      if (caps == NULL)
+        caps = gst_pad_get_pad_template_caps (pad);
+
+      if (filter) {
+        GstCaps *tmp =
+            gst_caps_intersect_full (filter, caps, GST_CAPS_INTERSECT_FIRST);
+        gst_caps_unref (caps);
+        caps = tmp;
+      }
+
+      gst_query_set_caps_result (query, caps);
+      gst_caps_unref (caps);
+      return TRUE;
+    }
+    default:
+      return gst_pad_query_default (pad, parent, query);
+  }
+}
+
+static GstPad *
+gst_audiomixer_request_minus_pad (GstElement * element, GstPadTemplate * templ,
+    const gchar * req_name)
+{
+  GstAudioMixer *audiomixer = GST_AUDIO_MIXER (element);
+  GstAudioMixerPad *sinkpad;
+  GstPad *minus_pad;
+  gchar *sink_name;
+  guint serial;
+
+  if (req_name == NULL || sscanf (req_name, "minus_%u", &serial) != 1)
+    goto no_name;
+
+  sink_name = g_strdup_printf ("sink_%u", serial);
+  sinkpad = (GstAudioMixerPad *) gst_element_get_static_pad (element,
+      sink_name);
+  g_free (sink_name);
+  if (sinkpad == NULL)
+    goto no_sinkpad;
+
+  minus_pad = gst_pad_new_from_template (templ, req_name);
+  gst_pad_set_event_function (minus_pad,
+      GST_DEBUG_FUNCPTR (gst_audiomixer_minus_event));
+  gst_pad_set_query_function (minus_pad,
+      GST_DEBUG_FUNCPTR (gst_audiomixer_minus_query));
+
+  GST_OBJECT_LOCK (audiomixer);
+  GST_OBJECT_LOCK (sinkpad);
+  if (sinkpad->minus_pad) {
+    GST_OBJECT_UNLOCK (sinkpad);
+    GST_OBJECT_UNLOCK (audiomixer);
+    gst_object_unref (minus_pad);
+    gst_object_unref (sinkpad);
+    goto already_requested;
+  }
+  sinkpad->minus_pad = gst_object_ref (minus_pad);
+  sinkpad->minus_started = FALSE;
+  sinkpad->minus_eos = FALSE;
+  gst_audio_info_init (&sinkpad->minus_info);
+  gst_segment_init (&sinkpad->minus_segment, GST_FORMAT_UNDEFINED);
+  audiomixer->n_minus_pads++;
+  GST_OBJECT_UNLOCK (sinkpad);
+  GST_OBJECT_UNLOCK (audiomixer);
+
+  GST_DEBUG_OBJECT (audiomixer, "mix-minus pad %s for %s:%s", req_name,
+      GST_DEBUG_PAD_NAME (sinkpad));
+  gst_object_unref (sinkpad);
+
+  gst_element_add_pad (element, minus_pad);
+
+  return minus_pad;
+
+no_name:
+  {
+    GST_WARNING_OBJECT (element, "mix-minus pads need a name like minus_%%u");
+    return NULL;
+  }
+no_sinkpad:
+  {
+    GST_WARNING_OBJECT (element, "no sink pad for mix-minus pad %s", req_name);
+    return NULL;
+  }
+already_requested:
+  {
+    GST_WARNING_OBJECT (element, "mix-minus pad %s already exists", req_name);
+    return NULL;
+  }
+}
+
+/* Called with the OBJECT_LOCK of the mixer and the pad, returns the
+ * mix-minus pad of @pad that the caller has to remove */
+static GstPad *
+gst_audiomixer_take_minus_pad (GstAudioMixer * audiomixer,
+    GstAudioMixerPad * pad)
+{
+  GstPad *minus_pad = pad->minus_pad;
+
+  if (minus_pad) {
+    pad->minus_pad = NULL;
+    audiomixer->n_minus_pads--;
+  }
+
+  return minus_pad;
+}
+
+static void
+gst_audiomixer_remove_minus_pad (GstAudioMixer * audiomixer, GstPad * minus_pad)
+{
+  GST_DEBUG_OBJECT (audiomixer, "removing mix-minus pad %s:%s",
+      GST_DEBUG_PAD_NAME (minus_pad));
+
+  gst_pad_set_active (minus_pad, FALSE);
+  gst_element_remove_pad (GST_ELEMENT_CAST (audiomixer), minus_pad);
+  gst_object_unref (minus_pad);
+}
+
+static void
+gst_audiomixer_release_minus_pad (GstAudioMixer * audiomixer, GstPad * pad)
+{
+  GstPad *minus_pad = NULL;
+  GList *l;
+
+  GST_OBJECT_LOCK (audiomixer);
+  for (l = GST_ELEMENT_CAST (audiomixer)->sinkpads; l; l = l->next) {
+    GstAudioMixerPad *sinkpad = l->data;
+
+    GST_OBJECT_LOCK (sinkpad);
+    if (sinkpad->minus_pad == pad)
+      minus_pad = gst_audiomixer_take_minus_pad (audiomixer, sinkpad);
+    GST_OBJECT_UNLOCK (sinkpad);
+
+    if (minus_pad)
+      break;
+  }
+  GST_OBJECT_UNLOCK (audiomixer);
+
+  if (minus_pad)
+    gst_audiomixer_remove_minus_pad (audiomixer, minus_pad);
+}
+
+/* Pushes @event on all mix-minus pads, unless they are EOS already */
+static void
+gst_audiomixer_push_minus_event (GstAudioMixer * audiomixer, GstEvent * event)
+{
+  GList *minus_pads = NULL, *l;
+
+  GST_OBJECT_LOCK (audiomixer);
+  for (l = GST_ELEMENT_CAST (audiomixer)->sinkpads; l; l = l->next) {
+    GstAudioMixerPad *pad = l->data;
+
+    GST_OBJECT_LOCK (pad);
+    if (pad->minus_pad)
+      minus_pads = g_list_prepend (minus_pads, gst_object_ref (pad));
+    GST_OBJECT_UNLOCK (pad);
+  }
+  GST_OBJECT_UNLOCK (audiomixer);
+
+  for (l = minus_pads; l; l = l->next) {
+    GstAudioMixerPad *pad = l->data;
+    GstPad *minus_pad;
+
+    GST_OBJECT_LOCK (pad);
+    minus_pad = pad->minus_pad ? gst_object_ref (pad->minus_pad) : NULL;
+    GST_OBJECT_UNLOCK (pad);
+
+    if (minus_pad == NULL)
+      continue;
+
+    switch (GST_EVENT_TYPE (event)) {
+      case GST_EVENT_EOS:
+        if (!pad->minus_eos)
+          gst_pad_push_event (minus_pad, gst_event_ref (event));
+        pad->minus_eos = TRUE;
+        break;
+      case GST_EVENT_FLUSH_STOP:
+        gst_pad_push_event (minus_pad, gst_event_ref (event));
+        pad->minus_eos = FALSE;
+        gst_segment_init (&pad->minus_segment, GST_FORMAT_UNDEFINED);
+        break;
+      default:
+        gst_pad_push_event (minus_pad, gst_event_ref (event));
+        break;
+    }
+    gst_object_unref (minus_pad);
+  }
+  g_list_free_full (minus_pads, gst_object_unref);
+  gst_event_unref (event);
+}
+
+static gboolean
+gst_audiomixer_stop (GstAggregator * agg)
+{
+  GstAudioMixer *audiomixer = GST_AUDIO_MIXER (agg);
+  GList *l;
+
+  GST_OBJECT_LOCK (audiomixer);
+  for (l = GST_ELEMENT_CAST (audiomixer)->sinkpads; l; l = l->next) {
+    GstAudioMixerPad *pad = l->data;
+
+    pad->minus_started = FALSE;
+    pad->minus_eos = FALSE;
+    gst_audio_info_init (&pad->minus_info);
+    gst_segment_init (&pad->minus_segment, GST_FORMAT_UNDEFINED);
+  }
+  audiomixer->accumulate = FALSE;
+  GST_OBJECT_UNLOCK (audiomixer);
+
+  return GST_AGGREGATOR_CLASS (parent_class)->stop (agg);
+}
+
+static GstFlowReturn
+gst_audiomixer_flush (GstAggregator * agg)
+{
+  GstAudioMixer *audiomixer = GST_AUDIO_MIXER (agg);
+  gboolean has_minus_pads;
+
+  GST_OBJECT_LOCK (audiomixer);
+  has_minus_pads = audiomixer->n_minus_pads > 0;
+  GST_OBJECT_UNLOCK (audiomixer);
+
+  if (has_minus_pads) {
+    gst_audiomixer_push_minus_event (audiomixer, gst_event_new_flush_start ());
+    gst_audiomixer_push_minus_event (audiomixer,
+        gst_event_new_flush_stop (TRUE));
+  }
+
+  return GST_AGGREGATOR_CLASS (parent_class)->flush (agg);
+}
+
+static GstFlowReturn
+gst_audiomixer_aggregate (GstAggregator * agg, gboolean timeout)
+{
+  GstAudioMixer *audiomixer = GST_AUDIO_MIXER (agg);
+  GstFlowReturn ret;
+
+  ret = GST_AGGREGATOR_CLASS (parent_class)->aggregate (agg, timeout);
+
+  if (ret == GST_FLOW_EOS)
+    gst_audiomixer_push_minus_event (audiomixer, gst_event_new_eos ());
+
+  return ret;
 }
 
 static GstPad *
@@ -251,6 +591,9 @@ gst_audiomixer_request_new_pad (GstElement * element, GstPadTemplate * templ,
 {
   GstAudioMixerPad *newpad;
 
+  if (GST_PAD_TEMPLATE_DIRECTION (templ) == GST_PAD_SRC)
+    return gst_audiomixer_request_minus_pad (element, templ, req_name);
+
   newpad = (GstAudioMixerPad *)
       GST_ELEMENT_CLASS (parent_class)->request_new_pad (element,
       templ, req_name, caps);
@@ -274,11 +617,27 @@ static void
 gst_audiomixer_release_pad (GstElement * element, GstPad * pad)
 {
   GstAudioMixer *audiomixer;
+  GstPad *minus_pad;
 
   audiomixer = GST_AUDIO_MIXER (element);
 
   GST_DEBUG_OBJECT (audiomixer, "release pad %s:%s", GST_DEBUG_PAD_NAME (pad));
 
+  if (GST_PAD_IS_SRC (pad)) {
+    gst_audiomixer_release_minus_pad (audiomixer, pad);
+    return;
+  }
+
+  GST_OBJECT_LOCK (audiomixer);
+  GST_OBJECT_LOCK (pad);
+  minus_pad = gst_audiomixer_take_minus_pad (audiomixer,
+      GST_AUDIO_MIXER_PAD (pad));
+  GST_OBJECT_UNLOCK (pad);
+  GST_OBJECT_UNLOCK (audiomixer);
+
+  if (minus_pad)
+    gst_audiomixer_remove_minus_pad (audiomixer, minus_pad);
+
   gst_child_proxy_child_removed (GST_CHILD_PROXY (audiomixer), G_OBJECT (pad),
       GST_OBJECT_NAME (pad));
 
@@ -286,11 +645,343 @@ gst_audiomixer_release_pad (GstElement * element, GstPad * pad)
 }
 
 
+/* Accumulating mixer, used while there are mix-minus pads.
+ *
+ * All pads are added into a wide accumulator without clamping, with the
+ * volume applied the same way as the orc functions do. Each pad with a
+ * mix-minus pad also keeps its own contribution, so that the sum and all
+ * mix-minus outputs can be produced with one clamping pass each once all
+ * pads were mixed. */
+
+#define MAKE_ACCUMULATE_INT(name, type, bias, shift)                    \
+static void                                                             \
+accumulate_##name (gint32 * acc, gint32 * own, const type * in,         \
+    gint volume, guint num_samples)                                     \
+{                                                                       \
+  guint i;                                                              \
+                                                                        \
+  if (own) {                                                            \
+    for (i = 0; i < num_samples; i++) {                                 \
+      gint32 v = (((gint32) in[i] - (bias)) * volume) >> (shift);       \
+      acc[i] += v;                                                      \
+      own[i] = v;                                                       \
+    }                                                                   \
+  } else {                                                              \
+    for (i = 0; i < num_samples; i++)                                   \
+      acc[i] += (((gint32) in[i] - (bias)) * volume) >> (shift);        \
+  }                                                                     \
+}
+
+#define MAKE_ACCUMULATE_DOUBLE(name, type, bias)                        \
+static void                                                             \
+accumulate_##name (gdouble * acc, gdouble * own, const type * in,       \
+    gdouble volume, guint num_samples)                                  \
+{                                                                       \
+  guint i;                                                              \
+                                                                        \
+  if (own) {                                                            \
+    for (i = 0; i < num_samples; i++) {                                 \
+      gdouble v = ((gdouble) in[i] - (bias)) * volume;                  \
+      acc[i] += v;                                                      \
+      own[i] = v;                                                       \
+    }                                                                   \
+  } else {                                                              \
+    for (i = 0; i < num_samples; i++)                                   \
+      acc[i] += ((gdouble) in[i] - (bias)) * volume;                    \
+  }                                                                     \
+}
+
+#define MAKE_FINISH_INT(name, type, bias, min, max)                     \
+static void                                                             \
+finish_##name (type * out, const gint32 * acc, const gint32 * own,      \
+    guint num_samples)                                                  \
+{                                                                       \
+  guint i;                                                              \
+                                                                        \
+  if (own) {                                                            \
+    for (i = 0; i < num_samples; i++)                                   \
+      out[i] = CLAMP (acc[i] - own[i], (min), (max)) + (bias);          \
+  } else {                                                              \
+    for (i = 0; i < num_samples; i++)                                   \
+      out[i] = CLAMP (acc[i], (min), (max)) + (bias);                   \
+  }                                                                     \
+}
+
+#define MAKE_FINISH_DOUBLE(name, type, bias, min, max)                  \
+static void                                                             \
+finish_##name (type * out, const gdouble * acc, const gdouble * own,    \
+    guint num_samples)                                                  \
+{                                                                       \
+  guint i;                                                              \
+                                                                        \
+  if (own) {                                                            \
+    for (i = 0; i < num_samples; i++)                                   \
+      out[i] = CLAMP (acc[i] - own[i], (min), (max)) + (bias);          \
+  } else {                                                              \
+    for (i = 0; i < num_samples; i++)                                   \
+      out[i] = CLAMP (acc[i], (min), (max)) + (bias);                   \
+  }                                                                     \
+}
+
+MAKE_ACCUMULATE_INT (s8, gint8, 0, VOLUME_UNITY_INT8_BIT_SHIFT);
+MAKE_ACCUMULATE_INT (u8, guint8, 128, VOLUME_UNITY_INT8_BIT_SHIFT);
+MAKE_ACCUMULATE_INT (s16, gint16, 0, VOLUME_UNITY_INT16_BIT_SHIFT);
+MAKE_ACCUMULATE_INT (u16, guint16, 32768, VOLUME_UNITY_INT16_BIT_SHIFT);
+MAKE_ACCUMULATE_DOUBLE (s32, gint32, 0.0);
+MAKE_ACCUMULATE_DOUBLE (u32, guint32, 2147483648.0);
+MAKE_ACCUMULATE_DOUBLE (f32, gfloat, 0.0);
+MAKE_ACCUMULATE_DOUBLE (f64, gdouble, 0.0);
+
+MAKE_FINISH_INT (s8, gint8, 0, G_MININT8, G_MAXINT8);
+MAKE_FINISH_INT (u8, guint8, 128, G_MININT8, G_MAXINT8);
+MAKE_FINISH_INT (s16, gint16, 0, G_MININT16, G_MAXINT16);
+MAKE_FINISH_INT (u16, guint16, 32768, G_MININT16, G_MAXINT16);
+MAKE_FINISH_DOUBLE (s32, gint32, 0.0, (gdouble) G_MININT32,
+    (gdouble) G_MAXINT32);
+MAKE_FINISH_DOUBLE (u32, guint32, 2147483648.0, (gdouble) G_MININT32,
+    (gdouble) G_MAXINT32);
+/* like the orc functions, floats are not clamped to [-1.0, 1.0] */
+MAKE_FINISH_DOUBLE (f32, gfloat, 0.0, -G_MAXFLOAT, G_MAXFLOAT);
+MAKE_FINISH_DOUBLE (f64, gdouble, 0.0, -G_MAXDOUBLE, G_MAXDOUBLE);
+
+static gsize
+accumulator_sample_size (const GstAudioInfo * info)
+{
+  return GST_AUDIO_INFO_WIDTH (info) <= 16 ? sizeof (gint32) : sizeof (gdouble);
+}
+
+/* Called with the OBJECT_LOCK of the mixer */
+static void
+gst_audiomixer_accumulate (GstAudioMixer * audiomixer, GstAudioMixerPad * pad,
+    gconstpointer in, guint out_offset, guint num_frames)
+{
+  const GstAudioInfo *info = &audiomixer->accumulate_info;
+  guint channels = GST_AUDIO_INFO_CHANNELS (info);
+  guint num_samples = num_frames * channels;
+  gsize offset = out_offset * channels * accumulator_sample_size (info);
+  gpointer acc = (guint8 *) audiomixer->accumulator + offset;
+  gpointer own = pad->has_own ? (guint8 *) pad->own + offset : NULL;
+
+  switch (GST_AUDIO_INFO_FORMAT (info)) {
+    case GST_AUDIO_FORMAT_S8:
+      accumulate_s8 (acc, own, in, pad->volume_i8, num_samples);
+      break;
+    case GST_AUDIO_FORMAT_U8:
+      accumulate_u8 (acc, own, in, pad->volume_i8, num_samples);
+      break;
+    case GST_AUDIO_FORMAT_S16:
+      accumulate_s16 (acc, own, in, pad->volume_i16, num_samples);
+      break;
+    case GST_AUDIO_FORMAT_U16:
+      accumulate_u16 (acc, own, in, pad->volume_i16, num_samples);
+      break;
+    case GST_AUDIO_FORMAT_S32:
+      accumulate_s32 (acc, own, in, pad->volume, num_samples);
+      break;
+    case GST_AUDIO_FORMAT_U32:
+      accumulate_u32 (acc, own, in, pad->volume, num_samples);
+      break;
+    case GST_AUDIO_FORMAT_F32:
+      accumulate_f32 (acc, own, in, pad->volume, num_samples);
+      break;
+    case GST_AUDIO_FORMAT_F64:
+      accumulate_f64 (acc, own, in, pad->volume, num_samples);
+      break;
+    default:
+      g_assert_not_reached ();
+      break;
+  }
+}
+
+/* Writes the clamped accumulator minus @own, if not NULL, to @out */
+static void
+gst_audiomixer_finish (GstAudioMixer * audiomixer, gpointer out,
+    gconstpointer own, guint num_samples)
+{
+  gconstpointer acc = audiomixer->accumulator;
+
+  switch (GST_AUDIO_INFO_FORMAT (&audiomixer->accumulate_info)) {
+    case GST_AUDIO_FORMAT_S8:
+      finish_s8 (out, acc, own, num_samples);
+      break;
+    case GST_AUDIO_FORMAT_U8:
+      finish_u8 (out, acc, own, num_samples);
+      break;
+    case GST_AUDIO_FORMAT_S16:
+      finish_s16 (out, acc, own, num_samples);
+      break;
+    case GST_AUDIO_FORMAT_U16:
+      finish_u16 (out, acc, own, num_samples);
+      break;
+    case GST_AUDIO_FORMAT_S32:
+      finish_s32 (out, acc, own, num_samples);
+      break;
+    case GST_AUDIO_FORMAT_U32:
+      finish_u32 (out, acc, own, num_samples);
+      break;
+    case GST_AUDIO_FORMAT_F32:
+      finish_f32 (out, acc, own, num_samples);
+      break;
+    case GST_AUDIO_FORMAT_F64:
+      finish_f64 (out, acc, own, num_samples);
+      break;
+    default:
+      g_assert_not_reached ();
+      break;
+  }
+}
+
+static gpointer
+ensure_scratch (gpointer * mem, gsize * mem_size, gsize size)
+{
+  if (*mem_size < size) {
+    g_free (*mem);
+    *mem = g_malloc (size);
+    *mem_size = size;
+  }
+  memset (*mem, 0, size);
+
+  return *mem;
+}
+
+static GstBuffer *
+gst_audiomixer_create_output_buffer (GstAudioAggregator * aagg,
+    guint num_frames)
+{
+  GstAudioMixer *audiomixer = GST_AUDIO_MIXER (aagg);
+  GstAudioAggregatorPad *srcpad =
+      GST_AUDIO_AGGREGATOR_PAD (GST_AGGREGATOR_SRC_PAD (aagg));
+  GstBuffer *outbuf;
+  gsize size;
+  GList *l;
+
+  outbuf = GST_AUDIO_AGGREGATOR_CLASS (parent_class)->create_output_buffer
+      (aagg, num_frames);
+
+  GST_OBJECT_LOCK (audiomixer);
+  audiomixer->accumulate = audiomixer->n_minus_pads > 0;
+  if (audiomixer->accumulate) {
+    audiomixer->accumulate_info = srcpad->info;
+    size = num_frames * GST_AUDIO_INFO_CHANNELS (&srcpad->info) *
+        accumulator_sample_size (&srcpad->info);
+
+    ensure_scratch (&audiomixer->accumulator, &audiomixer->accumulator_size,
+        size);
+
+    for (l = GST_ELEMENT_CAST (audiomixer)->sinkpads; l; l = l->next) {
+      GstAudioMixerPad *pad = l->data;
+
+      GST_OBJECT_LOCK (pad);
+      pad->has_own = pad->minus_pad != NULL;
+      if (pad->has_own)
+        ensure_scratch (&pad->own, &pad->own_size, size);
+      GST_OBJECT_UNLOCK (pad);
+    }
+  }
+  GST_OBJECT_UNLOCK (audiomixer);
+
+  return outbuf;
+}
+
+static void
+gst_audiomixer_push_minus (GstAudioMixer * audiomixer, GstAudioMixerPad * pad,
+    GstBuffer * outbuf, guint num_samples)
+{
+  GstAggregator *agg = GST_AGGREGATOR (audiomixer);
+  GstPad *minus_pad;
+  GstSegment segment;
+  GstBuffer *buf;
+  GstMapInfo map;
+  GstFlowReturn ret;
+
+  GST_OBJECT_LOCK (pad);
+  minus_pad = pad->minus_pad ? gst_object_ref (pad->minus_pad) : NULL;
+  GST_OBJECT_UNLOCK (pad);
+
+  if (minus_pad == NULL || pad->minus_eos)
+    goto done;
+
+  if (!pad->minus_started) {
+    gchar s_id[32];
+
+    g_snprintf (s_id, sizeof (s_id), "mixminus-%08x", g_random_int ());
+    gst_pad_push_event (minus_pad, gst_event_new_stream_start (s_id));
+    pad->minus_started = TRUE;
+  }
+
+  if (!gst_audio_info_is_equal (&pad->minus_info,
+          &audiomixer->accumulate_info)) {
+    GstCaps *caps = gst_audio_info_to_caps (&audiomixer->accumulate_info);
+
+    gst_pad_push_event (minus_pad, gst_event_new_caps (caps));
+    gst_caps_unref (caps);
+    pad->minus_info = audiomixer->accumulate_info;
+  }
+
+  GST_OBJECT_LOCK (agg);
+  gst_segment_copy_into (&GST_AGGREGATOR_PAD (agg->srcpad)->segment, &segment);
+  GST_OBJECT_UNLOCK (agg);
+
+  /* the position moves with every buffer, only the rest is relevant */
+  segment.position = pad->minus_segment.position;
+  if (!gst_segment_is_equal (&segment, &pad->minus_segment)) {
+    gst_pad_push_event (minus_pad, gst_event_new_segment (&segment));
+    pad->minus_segment = segment;
+  }
+
+  buf = gst_buffer_new_allocate (NULL, gst_buffer_get_size (outbuf), NULL);
+  gst_buffer_copy_into (buf, outbuf,
+      GST_BUFFER_COPY_FLAGS | GST_BUFFER_COPY_TIMESTAMPS, 0, -1);
+  gst_buffer_map (buf, &map, GST_MAP_WRITE);
+  gst_audiomixer_finish (audiomixer, map.data, pad->own, num_samples);
+  gst_buffer_unmap (buf, &map);
+
+  ret = gst_pad_push (minus_pad, buf);
+  GST_LOG_OBJECT (minus_pad, "pushed mix-minus buffer, result = %s",
+      gst_flow_get_name (ret));
+
+done:
+  if (minus_pad)
+    gst_object_unref (minus_pad);
+}
+
+static void
+gst_audiomixer_finish_output_buffer (GstAudioAggregator * aagg,
+    GstBuffer * outbuf)
+{
+  GstAudioMixer *audiomixer = GST_AUDIO_MIXER (aagg);
+  GList *pads = NULL, *l;
+  GstMapInfo outmap;
+  guint num_samples;
+
+  if (!audiomixer->accumulate)
+    return;
+
+  gst_buffer_map (outbuf, &outmap, GST_MAP_READWRITE);
+  num_samples = outmap.size / GST_AUDIO_INFO_BPS (&audiomixer->accumulate_info);
+  gst_audiomixer_finish (audiomixer, outmap.data, NULL, num_samples);
+  gst_buffer_unmap (outbuf, &outmap);
+
+  GST_OBJECT_LOCK (audiomixer);
+  for (l = GST_ELEMENT_CAST (audiomixer)->sinkpads; l; l = l->next) {
+    GstAudioMixerPad *pad = l->data;
+
+    if (pad->has_own)
+      pads = g_list_prepend (pads, gst_object_ref (pad));
+  }
+  GST_OBJECT_UNLOCK (audiomixer);
+
+  for (l = pads; l; l = l->next)
+    gst_audiomixer_push_minus (audiomixer, l->data, outbuf, num_samples);
+  g_list_free_full (pads, gst_object_unref);
+}
+
 static gboolean
 gst_audiomixer_aggregate_one_buffer (GstAudioAggregator * aagg,
     GstAudioAggregatorPad * aaggpad, GstBuffer * inbuf, guint in_offset,
     GstBuffer * outbuf, guint out_offset, guint num_frames)
 {
+  GstAudioMixer *audiomixer = GST_AUDIO_MIXER (aagg);
   GstAudioMixerPad *pad = GST_AUDIO_MIXER_PAD (aaggpad);
   GstMapInfo inmap;
   GstMapInfo outmap;
@@ -310,6 +1001,29 @@ gst_audiomixer_aggregate_one_buffer (GstAudioAggregator * aagg,
 
   bpf = GST_AUDIO_INFO_BPF (&srcpad->info);
 
+  if (audiomixer->accumulate
+      && !gst_audio_info_is_equal (&srcpad->info,
+          &audiomixer->accumulate_info)) {
+    /* the output buffer was converted to the new format, what was
+     * accumulated so far is lost */
+    GST_WARNING_OBJECT (audiomixer, "output format changed, mixing directly");
+    audiomixer->accumulate = FALSE;
+  }
+
+  if (audiomixer->accumulate) {
+    gst_buffer_map (inbuf, &inmap, GST_MAP_READ);
+    GST_LOG_OBJECT (pad, "accumulating %u bytes at offset %u from offset %u",
+        num_frames * bpf, out_offset * bpf, in_offset * bpf);
+    gst_audiomixer_accumulate (audiomixer, pad, inmap.data + in_offset * bpf,
+        out_offset, num_frames);
+    gst_buffer_unmap (inbuf, &inmap);
+
+    GST_OBJECT_UNLOCK (aaggpad);
+    GST_OBJECT_UNLOCK (aagg);
+
+    return TRUE;
+  }
+
   gst_buffer_map (outbuf, &outmap, GST_MAP_READWRITE);
   gst_buffer_map (inbuf, &inmap, GST_MAP_READ);
   GST_LOG_OBJECT (pad, "mixing %u bytes at offset %u from offset %u",
@@ -50,6 +50,17 @@ typedef struct _GstAudioMixerPadClass GstAudioMixerPadClass;
  */
 struct _GstAudioMixer {
   GstAudioAggregator element;
+
+  /* number of mix-minus src pads, with OBJECT_LOCK */
+  guint n_minus_pads;
+
+  /* TRUE when the current output buffer is mixed into the accumulator,
+   * latched when the output buffer is created */
+  gboolean accumulate;
+  GstAudioInfo accumulate_info;
+  /* gint32 samples for 8 and 16 bit formats, gdouble samples otherwise */
+  gpointer accumulator;
+  gsize accumulator_size;
 };
 
 struct _GstAudioMixerClass {
@@ -73,6 +84,21 @@ struct _GstAudioMixerPad {
   gint volume_i16;
   gint volume_i8;
   gboolean mute;
+
+  /* mix-minus src pad carrying the mix without this pad, with OBJECT_LOCK */
+  GstPad *minus_pad;
+
+  /* this pad's contribution to the accumulator for the current output
+   * buffer, only when has_own is set for the current output buffer */
+  gboolean has_own;
+  gpointer own;
+  gsize own_size;
+
+  /* streaming thread state of the mix-minus pad */
+  gboolean minus_started;
+  gboolean minus_eos;
+  GstAudioInfo minus_info;
+  GstSegment minus_segment;
 };
 
 struct _GstAudioMixerPadClass {
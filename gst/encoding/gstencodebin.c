@@ -90,6 +90,13 @@
  * #GstBus, allowing systems that support the missing-plugin system to offer the
  * user a way to install the missing element.
  *
+ * * Multiple renditions. With the video-renditions flag, all the video
+ * profiles of a #GstEncodingContainerProfile are fed from a single sink pad,
+ * for example to produce an adaptive bitrate ladder. The video is converted
+ * once and each rendition is scaled down from the next bigger one according
+ * to the restriction caps of the profiles, every rendition being scaled and
+ * encoded in its own thread.
+ *
  */
 
 
@@ -109,7 +116,8 @@
 typedef enum
 {
   GST_ENCODEBIN_FLAG_NO_AUDIO_CONVERSION = (1 << 0),
-  GST_ENCODEBIN_FLAG_NO_VIDEO_CONVERSION = (1 << 1)
+  GST_ENCODEBIN_FLAG_NO_VIDEO_CONVERSION = (1 << 1),
+  GST_ENCODEBIN_FLAG_VIDEO_RENDITIONS = (1 << 2)
 } GstEncodeBinFlags;
 
 #define GST_TYPE_ENCODEBIN_FLAGS (gst_encodebin_flags_get_type())
@@ -150,6 +158,11 @@ struct _GstEncodeBin
 
   GList *streams;               /* List of StreamGroup, not sorted */
 
+  /* Sink pad feeding all the video streams with the video-renditions flag
+   * and the conversion/scaling elements behind it */
+  GstPad *renditions_pad;
+  GList *renditions_elements;
+
   GstElement *muxer;
   /* Ghostpad with changing target */
   GstPad *srcpad;
@@ -261,6 +274,8 @@ gst_encodebin_flags_get_type (void)
           "conversion elements", "no-audio-conversion"},
     {C_FLAGS (GST_ENCODEBIN_FLAG_NO_VIDEO_CONVERSION), "Do not use video "
           "conversion elements", "no-video-conversion"},
+    {C_FLAGS (GST_ENCODEBIN_FLAG_VIDEO_RENDITIONS), "Feed all video "
+          "profiles from a single input", "video-renditions"},
     {0, NULL, NULL}
   };
   static volatile GType id = 0;
@@ -305,7 +320,7 @@ static gboolean gst_encode_bin_setup_profile (GstEncodeBin * ebin,
 
 static StreamGroup *_create_stream_group (GstEncodeBin * ebin,
     GstEncodingProfile * sprof, const gchar * sinkpadname, GstCaps * sinkcaps,
-    gboolean * encoder_not_found);
+    gboolean * encoder_not_found, gboolean expose);
 static void stream_group_remove (GstEncodeBin * ebin, StreamGroup * sgroup);
 static void stream_group_free (GstEncodeBin * ebin, StreamGroup * sgroup);
 static GstPad *gst_encode_bin_request_pad_signal (GstEncodeBin * encodebin,
@@ -734,7 +749,7 @@ request_pad_for_stream (GstEncodeBin * encodebin, GType ptype,
       goto no_stream_profile;
 
     sgroup = _create_stream_group (encodebin, sprof, name, caps,
-        &encoder_not_found);
+        &encoder_not_found, TRUE);
 
     if (G_UNLIKELY (sgroup))
       break;
@@ -1205,9 +1220,12 @@ _set_up_fake_encoder_pad_probe (GstEncodeBin * ebin, StreamGroup * sgroup)
  * encoder_not_found: If non NULL, set to TRUE if failure happened because
  * the encoder could not be found
  */
+/* If @expose is FALSE the input queue of the group isn't exposed as a sink
+ * pad, it is fed by the renditions cascade */
 static StreamGroup *
 _create_stream_group (GstEncodeBin * ebin, GstEncodingProfile * sprof,
-    const gchar * sinkpadname, GstCaps * sinkcaps, gboolean * encoder_not_found)
+    const gchar * sinkpadname, GstCaps * sinkcaps, gboolean * encoder_not_found,
+    gboolean expose)
 {
   StreamGroup *sgroup = NULL;
   GstPad *sinkpad, *srcpad = NULL, *muxerpad = NULL;
@@ -1344,7 +1362,9 @@ _create_stream_group (GstEncodeBin * ebin, GstEncodingProfile * sprof,
 
   /* Expose input queue sink pad as ghostpad */
   sinkpad = gst_element_get_static_pad (sgroup->inqueue, "sink");
-  if (sinkpadname == NULL) {
+  if (!expose) {
+    /* linked to the renditions cascade */
+  } else if (sinkpadname == NULL) {
     gchar *pname =
         g_strdup_printf ("%s_%u", gst_encoding_profile_get_type_nick (sprof),
         ebin->last_pad_id++);
@@ -1487,8 +1507,8 @@ _create_stream_group (GstEncodeBin * ebin, GstEncodingProfile * sprof,
         missing_element_name = "videoscale";
         goto missing_element;
       }
-      /* 4-tap scaling and black borders */
-      g_object_set (scale, "method", 2, "add-borders", TRUE, NULL);
+      /* 4-tap scaling, keeping the default black borders */
+      gst_util_set_object_arg (G_OBJECT (scale), "method", "4-tap");
       cspace2 = gst_element_factory_make ("videoconvert", NULL);
 
       if (!cspace || !cspace2) {
@@ -1601,9 +1621,11 @@ _create_stream_group (GstEncodeBin * ebin, GstEncodingProfile * sprof,
   g_list_free (tosync);
 
   /* Add ghostpad */
-  GST_DEBUG ("Adding ghostpad %s:%s", GST_DEBUG_PAD_NAME (sgroup->ghostpad));
-  gst_pad_set_active (sgroup->ghostpad, TRUE);
-  gst_element_add_pad ((GstElement *) ebin, sgroup->ghostpad);
+  if (sgroup->ghostpad) {
+    GST_DEBUG ("Adding ghostpad %s:%s", GST_DEBUG_PAD_NAME (sgroup->ghostpad));
+    gst_pad_set_active (sgroup->ghostpad, TRUE);
+    gst_element_add_pad ((GstElement *) ebin, sgroup->ghostpad);
+  }
 
   /* Add StreamGroup to our list of streams */
 
@@ -1905,6 +1927,215 @@ beach:
   return muxer;
 }
 
+static gint
+_rendition_height (GstEncodingProfile * sprof)
+{
+  GstCaps *restriction = gst_encoding_profile_get_restriction (sprof);
+  gint height = G_MAXINT;
+
+  if (restriction && !gst_caps_is_any (restriction)
+      && !gst_caps_is_empty (restriction))
+    gst_structure_get_int (gst_caps_get_structure (restriction, 0), "height",
+        &height);
+  if (restriction)
+    gst_caps_unref (restriction);
+
+  return height;
+}
+
+/* Biggest rendition first, profiles without a restricted size are not
+ * scaled at all */
+static gint
+compare_renditions (gconstpointer a, gconstpointer b)
+{
+  gint ha = _rendition_height ((GstEncodingProfile *) a);
+  gint hb = _rendition_height ((GstEncodingProfile *) b);
+
+  return (hb > ha) - (hb < ha);
+}
+
+/* The size part of the restriction caps of @sprof, the format and framerate
+ * are handled by the stream group */
+static GstCaps *
+_rendition_size_caps (GstEncodingProfile * sprof)
+{
+  static const gchar *fields[] = { "width", "height", "pixel-aspect-ratio" };
+  GstCaps *restriction = gst_encoding_profile_get_restriction (sprof);
+  GstCaps *caps = gst_caps_new_empty_simple ("video/x-raw");
+  guint i;
+
+  if (restriction && !gst_caps_is_any (restriction)
+      && !gst_caps_is_empty (restriction)) {
+    const GstStructure *s = gst_caps_get_structure (restriction, 0);
+
+    for (i = 0; i < G_N_ELEMENTS (fields); i++) {
+      const GValue *v = gst_structure_get_value (s, fields[i]);
+
+      if (v)
+        gst_caps_set_value (caps, fields[i], v);
+    }
+  }
+  if (restriction)
+    gst_caps_unref (restriction);
+
+  return caps;
+}
+
+static GstElement *
+_add_rendition_element (GstEncodeBin * ebin, const gchar * factoryname,
+    GList ** tosync)
+{
+  GstElement *elt = gst_element_factory_make (factoryname, NULL);
+
+  if (G_UNLIKELY (elt == NULL)) {
+    gst_element_post_message (GST_ELEMENT_CAST (ebin),
+        gst_missing_element_message_new (GST_ELEMENT_CAST (ebin),
+            factoryname));
+    GST_ELEMENT_ERROR (ebin, CORE, MISSING_PLUGIN,
+        (_("Missing element '%s' - check your GStreamer installation."),
+            factoryname), (NULL));
+    return NULL;
+  }
+
+  gst_bin_add ((GstBin *) ebin, elt);
+  ebin->renditions_elements = g_list_prepend (ebin->renditions_elements, elt);
+  *tosync = g_list_append (*tosync, elt);
+
+  return elt;
+}
+
+static gboolean
+_link_tee_to (GstElement * tee, GstElement * elt)
+{
+  GstPad *srcpad, *sinkpad;
+  gboolean res;
+
+  srcpad = gst_element_get_request_pad (tee, "src_%u");
+  if (G_UNLIKELY (srcpad == NULL))
+    return FALSE;
+  sinkpad = gst_element_get_static_pad (elt, "sink");
+  res = fast_pad_link (srcpad, sinkpad) == GST_PAD_LINK_OK;
+  gst_object_unref (sinkpad);
+  gst_object_unref (srcpad);
+
+  return res;
+}
+
+/* Creates a stream group for each of the video @profiles, all fed from one
+ * sink pad:
+ *
+ * sink - videoconvert - tee - group (biggest)
+ *                           \ queue - videoscale - capsfilter - tee - group
+ *                                                                  \ ...
+ *
+ * so that conversion happens once and every rendition is scaled from the
+ * next bigger one instead of from the input. */
+static gboolean
+_create_renditions (GstEncodeBin * ebin, const GList * profiles)
+{
+  GstElement *convert, *tee, *last;
+  GList *sorted, *tmp, *tosync = NULL;
+  GstPad *sinkpad;
+  gchar *pname;
+  gboolean res = FALSE;
+
+  sorted = g_list_sort (g_list_copy ((GList *) profiles), compare_renditions);
+
+  GST_DEBUG ("Creating %u video renditions", g_list_length (sorted));
+
+  if (!(convert = _add_rendition_element (ebin, "videoconvert", &tosync)))
+    goto done;
+  last = convert;
+
+  for (tmp = sorted; tmp; tmp = tmp->next) {
+    GstEncodingProfile *sprof = (GstEncodingProfile *) tmp->data;
+    StreamGroup *sgroup;
+
+    if (last != convert) {
+      GstElement *queue, *scale, *filter;
+      GstCaps *caps;
+
+      /* Scale down from the previous rendition in a separate thread */
+      if (!(queue = _add_rendition_element (ebin, "queue", &tosync)) ||
+          !(scale = _add_rendition_element (ebin, "videoscale", &tosync)) ||
+          !(filter = _add_rendition_element (ebin, "capsfilter", &tosync)))
+        goto done;
+
+      g_object_set (queue, "max-size-buffers",
+          (guint) ebin->queue_buffers_max, "max-size-bytes",
+          (guint) ebin->queue_bytes_max, "max-size-time",
+          (guint64) ebin->queue_time_max, "silent", TRUE, NULL);
+      /* same scaling as the stream groups */
+      gst_util_set_object_arg (G_OBJECT (scale), "method", "4-tap");
+      caps = _rendition_size_caps (sprof);
+      g_object_set (filter, "caps", caps, NULL);
+      gst_caps_unref (caps);
+
+      if (!_link_tee_to (last, queue) || !fast_element_link (queue, scale)
+          || !fast_element_link (scale, filter))
+        goto link_failure;
+      last = filter;
+    }
+
+    if (!(tee = _add_rendition_element (ebin, "tee", &tosync)))
+      goto done;
+    if (!fast_element_link (last, tee))
+      goto link_failure;
+    last = tee;
+
+    sgroup = _create_stream_group (ebin, sprof, NULL, NULL, NULL, FALSE);
+    if (G_UNLIKELY (sgroup == NULL))
+      goto done;
+    if (!_link_tee_to (tee, sgroup->inqueue))
+      goto link_failure;
+  }
+
+  for (tmp = tosync; tmp; tmp = tmp->next)
+    gst_element_sync_state_with_parent ((GstElement *) tmp->data);
+
+  sinkpad = gst_element_get_static_pad (convert, "sink");
+  pname = g_strdup_printf ("video_%u", ebin->last_pad_id++);
+  ebin->renditions_pad = gst_ghost_pad_new (pname, sinkpad);
+  g_free (pname);
+  gst_object_unref (sinkpad);
+
+  GST_DEBUG ("Adding ghostpad %s:%s",
+      GST_DEBUG_PAD_NAME (ebin->renditions_pad));
+  gst_pad_set_active (ebin->renditions_pad, TRUE);
+  gst_element_add_pad ((GstElement *) ebin, ebin->renditions_pad);
+
+  res = TRUE;
+
+done:
+  g_list_free (tosync);
+  g_list_free (sorted);
+  return res;
+
+link_failure:
+  GST_ERROR_OBJECT (ebin, "Failure linking the video renditions");
+  goto done;
+}
+
+static void
+_remove_renditions (GstEncodeBin * ebin)
+{
+  GList *tmp;
+
+  if (ebin->renditions_pad) {
+    gst_element_remove_pad (GST_ELEMENT_CAST (ebin), ebin->renditions_pad);
+    ebin->renditions_pad = NULL;
+  }
+
+  for (tmp = ebin->renditions_elements; tmp; tmp = tmp->next) {
+    GstElement *elt = (GstElement *) tmp->data;
+
+    gst_element_set_state (elt, GST_STATE_NULL);
+    gst_bin_remove ((GstBin *) ebin, elt);
+  }
+  g_list_free (ebin->renditions_elements);
+  ebin->renditions_elements = NULL;
+}
+
 static gboolean
 create_elements_and_pads (GstEncodeBin * ebin)
 {
@@ -1912,6 +2143,7 @@ create_elements_and_pads (GstEncodeBin * ebin)
   GstElement *muxer = NULL;
   GstPad *muxerpad;
   const GList *tmp, *profiles;
+  GList *renditions = NULL;
   GstEncodingProfile *sprof;
 
   GST_DEBUG ("Current profile : %s",
@@ -1943,23 +2175,46 @@ create_elements_and_pads (GstEncodeBin * ebin)
     profiles =
         gst_encoding_container_profile_get_profiles
         (GST_ENCODING_CONTAINER_PROFILE (ebin->profile));
+
+    /* Video profiles sharing a single input */
+    if (ebin->flags & GST_ENCODEBIN_FLAG_VIDEO_RENDITIONS) {
+      for (tmp = profiles; tmp; tmp = tmp->next) {
+        sprof = (GstEncodingProfile *) tmp->data;
+
+        if (GST_IS_ENCODING_VIDEO_PROFILE (sprof) &&
+            gst_encoding_profile_is_enabled (sprof))
+          renditions = g_list_append (renditions, sprof);
+      }
+      if (renditions && renditions->next == NULL) {
+        /* just a regular stream */
+        g_list_free (renditions);
+        renditions = NULL;
+      }
+      if (renditions && G_UNLIKELY (!_create_renditions (ebin, renditions)))
+        goto stream_error;
+    }
+
     for (tmp = profiles; tmp; tmp = tmp->next) {
       sprof = (GstEncodingProfile *) tmp->data;
 
+      if (g_list_find (renditions, sprof))
+        continue;
+
       GST_DEBUG ("Trying stream profile with presence %d",
           gst_encoding_profile_get_presence (sprof));
 
       if (gst_encoding_profile_get_presence (sprof) != 0 &&
           gst_encoding_profile_is_enabled (sprof)) {
         if (G_UNLIKELY (_create_stream_group (ebin, sprof, NULL, NULL,
-                    NULL) == NULL))
+                    NULL, TRUE) == NULL))
           goto stream_error;
       }
     }
+    g_list_free (renditions);
     gst_element_sync_state_with_parent (muxer);
   } else {
     if (G_UNLIKELY (_create_stream_group (ebin, ebin->profile, NULL,
-                NULL, NULL) == NULL))
+                NULL, NULL, TRUE) == NULL))
       goto stream_error;
   }
 
@@ -2000,6 +2255,7 @@ no_muxer_ghost_pad:
 stream_error:
   {
     GST_WARNING ("Could not create Streams");
+    g_list_free (renditions);
     if (muxer)
       gst_bin_remove (GST_BIN (ebin), muxer);
     ebin->muxer = NULL;
@@ -2200,6 +2456,8 @@ gst_encode_bin_tear_down_profile (GstEncodeBin * ebin)
   GST_DEBUG ("Tearing down profile %s",
       gst_encoding_profile_get_name (ebin->profile));
 
+  _remove_renditions (ebin);
+
   while (ebin->streams)
     stream_group_remove (ebin, (StreamGroup *) ebin->streams->data);
 
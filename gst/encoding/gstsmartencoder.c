@@ -52,6 +52,34 @@ static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink",
 
 static GQuark INTERNAL_ELEMENT;
 
+/* A decoder ! encoder chain fed through internal pads. Each one recodes a
+ * single GOP at a time, several of them run in parallel on the threads of
+ * the recoder pool */
+typedef struct
+{
+  GstPad *internal_srcpad;
+  GstPad *internal_sinkpad;
+  GstElement *decoder;
+  GstElement *encoder;
+
+  /* output of the GOP being recoded, in reverse order */
+  GList *output;
+} GstSmartEncoderRecoder;
+
+/* An entry of the output queue, either a GOP or a serialized event */
+typedef struct
+{
+  GstEvent *event;
+
+  /* the GOP, replaced by the recoded GOP once done */
+  GList *buffers;
+  GstCaps *caps;
+  GstEvent *segment;
+
+  gboolean done;
+  GstFlowReturn ret;
+} GstSmartEncoderItem;
+
 /* GstSmartEncoder signals and args */
 enum
 {
@@ -59,10 +87,12 @@ enum
   LAST_SIGNAL
 };
 
+#define DEFAULT_N_THREADS 0
+
 enum
 {
-  PROP_0
-      /* FILL ME */
+  PROP_0,
+  PROP_N_THREADS
 };
 
 static void
@@ -75,8 +105,17 @@ G_DEFINE_TYPE_EXTENDED (GstSmartEncoder, gst_smart_encoder, GST_TYPE_ELEMENT, 0,
     _do_init ());
 
 static void gst_smart_encoder_dispose (GObject * object);
-
-static gboolean setup_recoder_pipeline (GstSmartEncoder * smart_encoder);
+static void gst_smart_encoder_finalize (GObject * object);
+static void gst_smart_encoder_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec);
+static void gst_smart_encoder_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
+
+static GstSmartEncoderRecoder *recoder_new (GstSmartEncoder * smart_encoder,
+    GstCaps * caps);
+static void recoder_free (GstSmartEncoderRecoder * recoder);
+static void gst_smart_encoder_recode_gop (GstSmartEncoderItem * item,
+    GstSmartEncoder * smart_encoder);
 
 static GstFlowReturn gst_smart_encoder_chain (GstPad * pad, GstObject * parent,
     GstBuffer * buf);
@@ -109,35 +148,70 @@ gst_smart_encoder_class_init (GstSmartEncoderClass * klass)
       "Edward Hervey <bilboed@gmail.com>");
 
   gobject_class->dispose = (GObjectFinalizeFunc) (gst_smart_encoder_dispose);
+  gobject_class->finalize = gst_smart_encoder_finalize;
+  gobject_class->set_property = gst_smart_encoder_set_property;
+  gobject_class->get_property = gst_smart_encoder_get_property;
   element_class->change_state = gst_smart_encoder_change_state;
 
+  g_object_class_install_property (gobject_class, PROP_N_THREADS,
+      g_param_spec_uint ("n-threads", "Threads",
+          "Maximum number of GOPs recoded in parallel (0 = number of cores)",
+          0, G_MAXUINT, DEFAULT_N_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   GST_DEBUG_CATEGORY_INIT (smart_encoder_debug, "smartencoder", 0,
       "Smart Encoder");
 }
 
+static void
+smart_encoder_item_free (GstSmartEncoderItem * item)
+{
+  if (item->event)
+    gst_event_unref (item->event);
+  g_list_free_full (item->buffers, (GDestroyNotify) gst_buffer_unref);
+  if (item->caps)
+    gst_caps_unref (item->caps);
+  if (item->segment)
+    gst_event_unref (item->segment);
+  g_slice_free (GstSmartEncoderItem, item);
+}
+
+static gboolean
+smart_encoder_recoding (GstSmartEncoder * smart_encoder)
+{
+  GList *tmp;
+
+  for (tmp = smart_encoder->pending.head; tmp; tmp = tmp->next) {
+    if (!((GstSmartEncoderItem *) tmp->data)->done)
+      return TRUE;
+  }
+  return FALSE;
+}
+
 static void
 smart_encoder_reset (GstSmartEncoder * smart_encoder)
 {
+  GstSmartEncoderItem *item;
+  GstSmartEncoderRecoder *recoder;
+
   gst_segment_init (smart_encoder->segment, GST_FORMAT_UNDEFINED);
 
-  if (smart_encoder->encoder) {
-    /* Clean up/remove elements */
-    gst_element_set_state (smart_encoder->encoder, GST_STATE_NULL);
-    gst_element_set_state (smart_encoder->decoder, GST_STATE_NULL);
-    gst_element_set_bus (smart_encoder->encoder, NULL);
-    gst_element_set_bus (smart_encoder->decoder, NULL);
-    gst_pad_set_active (smart_encoder->internal_srcpad, FALSE);
-    gst_pad_set_active (smart_encoder->internal_sinkpad, FALSE);
-    gst_object_unref (smart_encoder->encoder);
-    gst_object_unref (smart_encoder->decoder);
-    gst_object_unref (smart_encoder->internal_srcpad);
-    gst_object_unref (smart_encoder->internal_sinkpad);
-
-    smart_encoder->encoder = NULL;
-    smart_encoder->decoder = NULL;
-    smart_encoder->internal_sinkpad = NULL;
-    smart_encoder->internal_srcpad = NULL;
-  }
+  g_list_free_full (smart_encoder->pending_gop,
+      (GDestroyNotify) gst_buffer_unref);
+  smart_encoder->pending_gop = NULL;
+
+  /* GOPs being recoded can't be interrupted, wait for them and drop
+   * everything that wasn't pushed yet */
+  g_mutex_lock (&smart_encoder->lock);
+  while (smart_encoder_recoding (smart_encoder))
+    g_cond_wait (&smart_encoder->cond, &smart_encoder->lock);
+  while ((item = g_queue_pop_head (&smart_encoder->pending)))
+    smart_encoder_item_free (item);
+
+  /* Clean up/remove elements */
+  while ((recoder = g_queue_pop_head (&smart_encoder->idle_recoders)))
+    recoder_free (recoder);
+  g_mutex_unlock (&smart_encoder->lock);
 
   if (smart_encoder->newsegment) {
     gst_event_unref (smart_encoder->newsegment);
@@ -163,6 +237,12 @@ gst_smart_encoder_init (GstSmartEncoder * smart_encoder)
 
   smart_encoder->segment = gst_segment_new ();
 
+  g_mutex_init (&smart_encoder->lock);
+  g_cond_init (&smart_encoder->cond);
+  g_queue_init (&smart_encoder->pending);
+  g_queue_init (&smart_encoder->idle_recoders);
+  smart_encoder->n_threads = DEFAULT_N_THREADS;
+
   smart_encoder_reset (smart_encoder);
 }
 
@@ -180,72 +260,215 @@ gst_smart_encoder_dispose (GObject * object)
   G_OBJECT_CLASS (gst_smart_encoder_parent_class)->dispose (object);
 }
 
+static void
+gst_smart_encoder_finalize (GObject * object)
+{
+  GstSmartEncoder *smart_encoder = (GstSmartEncoder *) object;
+
+  g_mutex_clear (&smart_encoder->lock);
+  g_cond_clear (&smart_encoder->cond);
+
+  G_OBJECT_CLASS (gst_smart_encoder_parent_class)->finalize (object);
+}
+
+static void
+gst_smart_encoder_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstSmartEncoder *smart_encoder = (GstSmartEncoder *) object;
+
+  switch (prop_id) {
+    case PROP_N_THREADS:
+      smart_encoder->n_threads = g_value_get_uint (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_smart_encoder_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstSmartEncoder *smart_encoder = (GstSmartEncoder *) object;
+
+  switch (prop_id) {
+    case PROP_N_THREADS:
+      g_value_set_uint (value, smart_encoder->n_threads);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+/* Pushes the GOP of @item through @recoder and stores the output in @item.
+ * Called from the recoder pool threads */
 static GstFlowReturn
-gst_smart_encoder_reencode_gop (GstSmartEncoder * smart_encoder)
+recoder_run (GstSmartEncoderRecoder * recoder, GstSmartEncoderItem * item)
 {
   GstFlowReturn res = GST_FLOW_OK;
   GList *tmp;
 
-  if (smart_encoder->encoder == NULL) {
-    if (!setup_recoder_pipeline (smart_encoder))
-      return GST_FLOW_ERROR;
-  }
-
   /* Activate elements */
   /* Set elements to PAUSED */
-  gst_element_set_state (smart_encoder->encoder, GST_STATE_PAUSED);
-  gst_element_set_state (smart_encoder->decoder, GST_STATE_PAUSED);
+  gst_element_set_state (recoder->encoder, GST_STATE_PAUSED);
+  gst_element_set_state (recoder->decoder, GST_STATE_PAUSED);
 
   GST_INFO ("Pushing Flush start/stop to clean decoder/encoder");
-  gst_pad_push_event (smart_encoder->internal_srcpad,
-      gst_event_new_flush_start ());
-  gst_pad_push_event (smart_encoder->internal_srcpad,
+  gst_pad_push_event (recoder->internal_srcpad, gst_event_new_flush_start ());
+  gst_pad_push_event (recoder->internal_srcpad,
       gst_event_new_flush_stop (TRUE));
 
-  /* push newsegment */
-  GST_INFO ("Pushing newsegment %" GST_PTR_FORMAT, smart_encoder->newsegment);
-  gst_pad_push_event (smart_encoder->internal_srcpad,
-      gst_event_ref (smart_encoder->newsegment));
+  /* push caps and newsegment */
+  gst_pad_push_event (recoder->internal_srcpad,
+      gst_event_new_stream_start ("smartencoder"));
+  gst_pad_push_event (recoder->internal_srcpad,
+      gst_event_new_caps (item->caps));
+  GST_INFO ("Pushing newsegment %" GST_PTR_FORMAT, item->segment);
+  gst_pad_push_event (recoder->internal_srcpad, gst_event_ref (item->segment));
 
   /* Push buffers through our pads */
   GST_DEBUG ("Pushing pending buffers");
 
-  for (tmp = smart_encoder->pending_gop; tmp; tmp = tmp->next) {
+  for (tmp = item->buffers; tmp; tmp = tmp->next) {
     GstBuffer *buf = (GstBuffer *) tmp->data;
 
-    res = gst_pad_push (smart_encoder->internal_srcpad, buf);
+    tmp->data = NULL;
+    res = gst_pad_push (recoder->internal_srcpad, buf);
     if (G_UNLIKELY (res != GST_FLOW_OK))
       break;
   }
 
   if (G_UNLIKELY (res != GST_FLOW_OK)) {
     GST_WARNING ("Error pushing pending buffers : %s", gst_flow_get_name (res));
-    /* Remove pending bfufers */
-    for (tmp = smart_encoder->pending_gop; tmp; tmp = tmp->next) {
-      gst_buffer_unref ((GstBuffer *) tmp->data);
+    /* Remove pending buffers */
+    for (; tmp; tmp = tmp->next) {
+      if (tmp->data)
+        gst_buffer_unref ((GstBuffer *) tmp->data);
     }
   } else {
     GST_INFO ("Pushing out EOS to flush out decoder/encoder");
-    gst_pad_push_event (smart_encoder->internal_srcpad, gst_event_new_eos ());
+    gst_pad_push_event (recoder->internal_srcpad, gst_event_new_eos ());
   }
 
-  /* Activate elements */
-  /* Set elements to PAUSED */
-  gst_element_set_state (smart_encoder->encoder, GST_STATE_NULL);
-  gst_element_set_state (smart_encoder->decoder, GST_STATE_NULL);
+  g_list_free (item->buffers);
+  item->buffers = g_list_reverse (recoder->output);
+  recoder->output = NULL;
 
-  g_list_free (smart_encoder->pending_gop);
-  smart_encoder->pending_gop = NULL;
+  return res;
+}
+
+static void
+gst_smart_encoder_recode_gop (GstSmartEncoderItem * item,
+    GstSmartEncoder * smart_encoder)
+{
+  GstSmartEncoderRecoder *recoder;
+  GstFlowReturn res;
+
+  g_mutex_lock (&smart_encoder->lock);
+  recoder = g_queue_pop_head (&smart_encoder->idle_recoders);
+  g_mutex_unlock (&smart_encoder->lock);
+
+  if (recoder == NULL)
+    recoder = recoder_new (smart_encoder, item->caps);
+
+  if (recoder) {
+    res = recoder_run (recoder, item);
+  } else {
+    g_list_free_full (item->buffers, (GDestroyNotify) gst_buffer_unref);
+    item->buffers = NULL;
+    res = GST_FLOW_ERROR;
+  }
+
+  g_mutex_lock (&smart_encoder->lock);
+  if (recoder)
+    g_queue_push_tail (&smart_encoder->idle_recoders, recoder);
+  item->ret = res;
+  item->done = TRUE;
+  g_cond_broadcast (&smart_encoder->cond);
+  g_mutex_unlock (&smart_encoder->lock);
+}
+
+/* Pushes out the GOPs and events at the head of the queue that are ready.
+ * If @drain is TRUE waits until everything is pushed, else only waits when
+ * too many GOPs are being recoded. */
+static GstFlowReturn
+gst_smart_encoder_push_queue (GstSmartEncoder * smart_encoder, gboolean drain)
+{
+  GstSmartEncoderItem *item;
+  GstFlowReturn res = GST_FLOW_OK;
+  guint max_queued;
+
+  max_queued = 2 * g_thread_pool_get_max_threads (smart_encoder->recoder_pool);
+
+  g_mutex_lock (&smart_encoder->lock);
+  while ((item = g_queue_peek_head (&smart_encoder->pending))) {
+    GList *tmp;
+
+    if (!item->done) {
+      if (!drain && smart_encoder->pending.length <= max_queued)
+        break;
+      g_cond_wait (&smart_encoder->cond, &smart_encoder->lock);
+      continue;
+    }
+
+    g_queue_pop_head (&smart_encoder->pending);
+    g_mutex_unlock (&smart_encoder->lock);
+
+    if (item->event) {
+      gst_pad_push_event (smart_encoder->srcpad, item->event);
+      item->event = NULL;
+    } else if (G_UNLIKELY (item->ret != GST_FLOW_OK)) {
+      GST_WARNING_OBJECT (smart_encoder, "Failed to recode GOP : %s",
+          gst_flow_get_name (item->ret));
+      res = item->ret;
+    } else {
+      for (tmp = item->buffers; tmp; tmp = tmp->next) {
+        GstBuffer *buf = (GstBuffer *) tmp->data;
+
+        tmp->data = NULL;
+        res = gst_pad_push (smart_encoder->srcpad, buf);
+        if (G_UNLIKELY (res != GST_FLOW_OK))
+          break;
+      }
+      for (; tmp; tmp = tmp->next) {
+        if (tmp->data)
+          gst_buffer_unref ((GstBuffer *) tmp->data);
+      }
+      g_list_free (item->buffers);
+      item->buffers = NULL;
+    }
+    smart_encoder_item_free (item);
+
+    g_mutex_lock (&smart_encoder->lock);
+    if (G_UNLIKELY (res != GST_FLOW_OK))
+      break;
+  }
+  g_mutex_unlock (&smart_encoder->lock);
 
   return res;
 }
 
+static void
+gst_smart_encoder_queue_item (GstSmartEncoder * smart_encoder,
+    GstSmartEncoderItem * item)
+{
+  g_mutex_lock (&smart_encoder->lock);
+  g_queue_push_tail (&smart_encoder->pending, item);
+  g_mutex_unlock (&smart_encoder->lock);
+
+  if (!item->done)
+    g_thread_pool_push (smart_encoder->recoder_pool, item, NULL);
+}
+
 static GstFlowReturn
 gst_smart_encoder_push_pending_gop (GstSmartEncoder * smart_encoder)
 {
   guint64 cstart, cstop;
   GList *tmp;
-  GstFlowReturn res = GST_FLOW_OK;
+  GstSmartEncoderItem *item;
 
   GST_DEBUG ("Pushing pending GOP (%" GST_TIME_FORMAT " -- %" GST_TIME_FORMAT
       ")", GST_TIME_ARGS (smart_encoder->gop_start),
@@ -258,16 +481,20 @@ gst_smart_encoder_push_pending_gop (GstSmartEncoder * smart_encoder)
         || (cstop != smart_encoder->gop_stop)) {
       GST_DEBUG ("GOP needs to be re-encoded from %" GST_TIME_FORMAT " to %"
           GST_TIME_FORMAT, GST_TIME_ARGS (cstart), GST_TIME_ARGS (cstop));
-      res = gst_smart_encoder_reencode_gop (smart_encoder);
+      /* Recoded on a pool thread, following GOPs wait in the queue so that
+       * everything goes out in order */
+      item = g_slice_new0 (GstSmartEncoderItem);
+      item->buffers = smart_encoder->pending_gop;
+      item->caps = gst_pad_get_current_caps (smart_encoder->sinkpad);
+      item->segment = gst_event_ref (smart_encoder->newsegment);
+      gst_smart_encoder_queue_item (smart_encoder, item);
     } else {
       /* The whole GOP is within the segment, push all pending buffers downstream */
       GST_DEBUG ("GOP doesn't need to be modified, pushing downstream");
-      for (tmp = smart_encoder->pending_gop; tmp; tmp = tmp->next) {
-        GstBuffer *buf = (GstBuffer *) tmp->data;
-        res = gst_pad_push (smart_encoder->srcpad, buf);
-        if (G_UNLIKELY (res != GST_FLOW_OK))
-          break;
-      }
+      item = g_slice_new0 (GstSmartEncoderItem);
+      item->buffers = smart_encoder->pending_gop;
+      item->done = TRUE;
+      gst_smart_encoder_queue_item (smart_encoder, item);
     }
   } else {
     /* The whole GOP is outside the segment, there's most likely
@@ -277,16 +504,14 @@ gst_smart_encoder_push_pending_gop (GstSmartEncoder * smart_encoder)
     for (tmp = smart_encoder->pending_gop; tmp; tmp = tmp->next) {
       gst_buffer_unref ((GstBuffer *) tmp->data);
     }
-  }
-
-  if (smart_encoder->pending_gop) {
     g_list_free (smart_encoder->pending_gop);
-    smart_encoder->pending_gop = NULL;
   }
+
+  smart_encoder->pending_gop = NULL;
   smart_encoder->gop_start = GST_CLOCK_TIME_NONE;
   smart_encoder->gop_stop = GST_CLOCK_TIME_NONE;
 
-  return res;
+  return gst_smart_encoder_push_queue (smart_encoder, FALSE);
 }
 
 static GstFlowReturn
@@ -352,6 +577,11 @@ smart_encoder_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
       break;
     case GST_EVENT_SEGMENT:
     {
+      /* The pending GOP belongs to the previous segment */
+      if (smart_encoder->pending_gop
+          && smart_encoder->segment->format == GST_FORMAT_TIME)
+        gst_smart_encoder_push_pending_gop (smart_encoder);
+
       gst_event_copy_segment (event, smart_encoder->segment);
 
       GST_DEBUG_OBJECT (smart_encoder, "segment: %" GST_SEGMENT_FORMAT,
@@ -373,11 +603,30 @@ smart_encoder_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
       GST_DEBUG ("Eos, flushing remaining data");
       if (smart_encoder->segment->format == GST_FORMAT_TIME)
         gst_smart_encoder_push_pending_gop (smart_encoder);
+      gst_smart_encoder_push_queue (smart_encoder, TRUE);
       break;
     default:
       break;
   }
 
+  /* Serialized events go out after the GOPs still being recoded */
+  if (GST_EVENT_IS_SERIALIZED (event)
+      && GST_EVENT_TYPE (event) != GST_EVENT_FLUSH_STOP) {
+    g_mutex_lock (&smart_encoder->lock);
+    if (!g_queue_is_empty (&smart_encoder->pending)) {
+      GstSmartEncoderItem *item = g_slice_new0 (GstSmartEncoderItem);
+
+      item->event = event;
+      item->done = TRUE;
+      g_queue_push_tail (&smart_encoder->pending, item);
+      event = NULL;
+    }
+    g_mutex_unlock (&smart_encoder->lock);
+
+    if (event == NULL)
+      return TRUE;
+  }
+
   res = gst_pad_push_event (smart_encoder->srcpad, event);
 
   return res;
@@ -514,113 +763,135 @@ get_encoder (GstCaps * caps)
 static GstFlowReturn
 internal_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
 {
-  GstSmartEncoder *smart_encoder =
+  GstSmartEncoderRecoder *recoder =
       g_object_get_qdata ((GObject *) pad, INTERNAL_ELEMENT);
 
-  return gst_pad_push (smart_encoder->srcpad, buf);
+  recoder->output = g_list_prepend (recoder->output, buf);
+
+  return GST_FLOW_OK;
 }
 
-static gboolean
-setup_recoder_pipeline (GstSmartEncoder * smart_encoder)
+static void
+recoder_free (GstSmartEncoderRecoder * recoder)
 {
-  GstPad *tmppad;
-  GstCaps *caps;
+  if (recoder->encoder) {
+    gst_element_set_state (recoder->encoder, GST_STATE_NULL);
+    gst_element_set_bus (recoder->encoder, NULL);
+    gst_object_unref (recoder->encoder);
+  }
+  if (recoder->decoder) {
+    gst_element_set_state (recoder->decoder, GST_STATE_NULL);
+    gst_element_set_bus (recoder->decoder, NULL);
+    gst_object_unref (recoder->decoder);
+  }
+  if (recoder->internal_srcpad) {
+    gst_pad_set_active (recoder->internal_srcpad, FALSE);
+    gst_object_unref (recoder->internal_srcpad);
+  }
+  if (recoder->internal_sinkpad) {
+    gst_pad_set_active (recoder->internal_sinkpad, FALSE);
+    gst_object_unref (recoder->internal_sinkpad);
+  }
+  g_list_free_full (recoder->output, (GDestroyNotify) gst_buffer_unref);
 
-  /* Fast path */
-  if (G_UNLIKELY (smart_encoder->encoder))
-    return TRUE;
+  g_slice_free (GstSmartEncoderRecoder, recoder);
+}
+
+static GstSmartEncoderRecoder *
+recoder_new (GstSmartEncoder * smart_encoder, GstCaps * caps)
+{
+  GstSmartEncoderRecoder *recoder;
+  GstPad *tmppad;
 
   GST_DEBUG ("Creating internal decoder and encoder");
 
+  recoder = g_slice_new0 (GstSmartEncoderRecoder);
+
   /* Create decoder/encoder */
-  caps = gst_pad_get_current_caps (smart_encoder->sinkpad);
-  smart_encoder->decoder = get_decoder (caps);
-  if (G_UNLIKELY (smart_encoder->decoder == NULL))
+  recoder->decoder = get_decoder (caps);
+  if (G_UNLIKELY (recoder->decoder == NULL))
     goto no_decoder;
-  gst_caps_unref (caps);
-  gst_element_set_bus (smart_encoder->decoder, GST_ELEMENT_BUS (smart_encoder));
+  gst_element_set_bus (recoder->decoder, GST_ELEMENT_BUS (smart_encoder));
 
-  caps = gst_pad_get_current_caps (smart_encoder->sinkpad);
-  smart_encoder->encoder = get_encoder (caps);
-  if (G_UNLIKELY (smart_encoder->encoder == NULL))
+  recoder->encoder = get_encoder (caps);
+  if (G_UNLIKELY (recoder->encoder == NULL))
     goto no_encoder;
-  gst_caps_unref (caps);
-  gst_element_set_bus (smart_encoder->encoder, GST_ELEMENT_BUS (smart_encoder));
+  gst_element_set_bus (recoder->encoder, GST_ELEMENT_BUS (smart_encoder));
 
   GST_DEBUG ("Creating internal pads");
 
   /* Create internal pads */
 
   /* Source pad which we'll use to feed data to decoders */
-  smart_encoder->internal_srcpad = gst_pad_new ("internal_src", GST_PAD_SRC);
-  g_object_set_qdata ((GObject *) smart_encoder->internal_srcpad,
-      INTERNAL_ELEMENT, smart_encoder);
-  gst_pad_set_active (smart_encoder->internal_srcpad, TRUE);
+  recoder->internal_srcpad = gst_pad_new ("internal_src", GST_PAD_SRC);
+  g_object_set_qdata ((GObject *) recoder->internal_srcpad,
+      INTERNAL_ELEMENT, recoder);
+  gst_pad_set_active (recoder->internal_srcpad, TRUE);
 
   /* Sink pad which will get the buffers from the encoder.
    * Note: We don't need an event function since we'll be discarding all
    * of them. */
-  smart_encoder->internal_sinkpad = gst_pad_new ("internal_sink", GST_PAD_SINK);
-  g_object_set_qdata ((GObject *) smart_encoder->internal_sinkpad,
-      INTERNAL_ELEMENT, smart_encoder);
-  gst_pad_set_chain_function (smart_encoder->internal_sinkpad, internal_chain);
-  gst_pad_set_active (smart_encoder->internal_sinkpad, TRUE);
+  recoder->internal_sinkpad = gst_pad_new ("internal_sink", GST_PAD_SINK);
+  g_object_set_qdata ((GObject *) recoder->internal_sinkpad,
+      INTERNAL_ELEMENT, recoder);
+  gst_pad_set_chain_function (recoder->internal_sinkpad, internal_chain);
+  gst_pad_set_active (recoder->internal_sinkpad, TRUE);
 
   GST_DEBUG ("Linking pads to elements");
 
   /* Link everything */
-  tmppad = gst_element_get_static_pad (smart_encoder->encoder, "src");
-  if (GST_PAD_LINK_FAILED (gst_pad_link (tmppad,
-              smart_encoder->internal_sinkpad)))
+  tmppad = gst_element_get_static_pad (recoder->encoder, "src");
+  if (GST_PAD_LINK_FAILED (gst_pad_link (tmppad, recoder->internal_sinkpad)))
     goto sinkpad_link_fail;
   gst_object_unref (tmppad);
 
-  if (!gst_element_link (smart_encoder->decoder, smart_encoder->encoder))
+  if (!gst_element_link (recoder->decoder, recoder->encoder))
     goto encoder_decoder_link_fail;
 
-  tmppad = gst_element_get_static_pad (smart_encoder->decoder, "sink");
-  if (GST_PAD_LINK_FAILED (gst_pad_link (smart_encoder->internal_srcpad,
-              tmppad)))
+  tmppad = gst_element_get_static_pad (recoder->decoder, "sink");
+  if (GST_PAD_LINK_FAILED (gst_pad_link (recoder->internal_srcpad, tmppad)))
     goto srcpad_link_fail;
   gst_object_unref (tmppad);
 
   GST_DEBUG ("Done creating internal elements/pads");
 
-  return TRUE;
+  return recoder;
 
 no_decoder:
   {
     GST_WARNING ("Couldn't find a decoder for %" GST_PTR_FORMAT, caps);
-    gst_caps_unref (caps);
-    return FALSE;
+    goto fail;
   }
 
 no_encoder:
   {
     GST_WARNING ("Couldn't find an encoder for %" GST_PTR_FORMAT, caps);
-    gst_caps_unref (caps);
-    return FALSE;
+    goto fail;
   }
 
 srcpad_link_fail:
   {
     gst_object_unref (tmppad);
     GST_WARNING ("Couldn't link internal srcpad to decoder");
-    return FALSE;
+    goto fail;
   }
 
 sinkpad_link_fail:
   {
     gst_object_unref (tmppad);
     GST_WARNING ("Couldn't link encoder to internal sinkpad");
-    return FALSE;
+    goto fail;
   }
 
 encoder_decoder_link_fail:
   {
     GST_WARNING ("Couldn't link decoder to encoder");
-    return FALSE;
+    goto fail;
   }
+
+fail:
+  recoder_free (recoder);
+  return NULL;
 }
 
 static GstStateChangeReturn
@@ -690,12 +961,22 @@ gst_smart_encoder_change_state (GstElement * element, GstStateChange transition)
 
   switch (transition) {
     case GST_STATE_CHANGE_NULL_TO_READY:
+    {
+      guint n_threads = smart_encoder->n_threads;
+
       /* Figure out which elements are available  */
       if ((ret =
               gst_smart_encoder_find_elements (smart_encoder)) ==
           GST_STATE_CHANGE_FAILURE)
         goto beach;
+
+      if (n_threads == 0)
+        n_threads = g_get_num_processors ();
+      smart_encoder->recoder_pool =
+          g_thread_pool_new ((GFunc) gst_smart_encoder_recode_gop,
+          smart_encoder, n_threads, FALSE, NULL);
       break;
+    }
     default:
       break;
   }
@@ -708,6 +989,10 @@ gst_smart_encoder_change_state (GstElement * element, GstStateChange transition)
     case GST_STATE_CHANGE_PAUSED_TO_READY:
       smart_encoder_reset (smart_encoder);
       break;
+    case GST_STATE_CHANGE_READY_TO_NULL:
+      g_thread_pool_free (smart_encoder->recoder_pool, FALSE, TRUE);
+      smart_encoder->recoder_pool = NULL;
+      break;
     default:
       break;
   }
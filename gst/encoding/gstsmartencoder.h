@@ -50,11 +50,16 @@ struct _GstSmartEncoder {
   guint64 gop_start;		/* GOP start in running time */
   guint64 gop_stop;		/* GOP end in running time */
 
-  /* Internal recoding elements */
-  GstPad *internal_sinkpad;
-  GstPad *internal_srcpad;
-  GstElement *decoder;
-  GstElement *encoder;
+  /* GOPs being recoded and serialized events waiting to be pushed
+   * downstream in order, protected by lock */
+  GMutex lock;
+  GCond cond;
+  GQueue pending;
+
+  /* Internal recoding pipelines, GOPs are recoded from the pool threads */
+  GThreadPool *recoder_pool;
+  GQueue idle_recoders;         /* protected by lock */
+  guint n_threads;
 
   /* Available caps at runtime */
   GstCaps *available_caps;
@@ -25,6 +25,12 @@
 
 #include "gstgiobasesink.h"
 
+#ifdef HAVE_GIO_UNIX_2_0
+#include <gio/gfiledescriptorbased.h>
+#include <errno.h>
+#include <unistd.h>
+#endif
+
 GST_DEBUG_CATEGORY_STATIC (gst_gio_base_sink_debug);
 #define GST_CAT_DEFAULT gst_gio_base_sink_debug
 
@@ -33,10 +39,30 @@ static GstStaticPadTemplate sink_factory = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_ALWAYS,
     GST_STATIC_CAPS_ANY);
 
+#define DEFAULT_WRITE_BEHIND FALSE
+#define DEFAULT_MAX_PENDING_BYTES (8 * 1024 * 1024)
+#define DEFAULT_SYNC_INTERVAL 0
+
+/* maximum number of buffers coalesced into one write */
+#define MAX_VECTORS 64
+
+enum
+{
+  PROP_0,
+  PROP_WRITE_BEHIND,
+  PROP_MAX_PENDING_BYTES,
+  PROP_SYNC_INTERVAL,
+  PROP_WRITE_STATS
+};
+
 #define gst_gio_base_sink_parent_class parent_class
 G_DEFINE_TYPE (GstGioBaseSink, gst_gio_base_sink, GST_TYPE_BASE_SINK);
 
 static void gst_gio_base_sink_finalize (GObject * object);
+static void gst_gio_base_sink_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec);
+static void gst_gio_base_sink_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
 static gboolean gst_gio_base_sink_start (GstBaseSink * base_sink);
 static gboolean gst_gio_base_sink_stop (GstBaseSink * base_sink);
 static gboolean gst_gio_base_sink_unlock (GstBaseSink * base_sink);
@@ -58,6 +84,76 @@ gst_gio_base_sink_class_init (GstGioBaseSinkClass * klass)
       "GIO base sink");
 
   gobject_class->finalize = gst_gio_base_sink_finalize;
+  gobject_class->set_property = gst_gio_base_sink_set_property;
+  gobject_class->get_property = gst_gio_base_sink_get_property;
+
+  /**
+   * GstGioBaseSink:write-behind:
+   *
+   * Queue the buffers and write them from a separate thread instead of
+   * blocking the streaming thread on every write. Consecutive queued buffers
+   * are written together with one vectored write.
+   *
+   * Flushing the sink cancels a write that is blocked, the data it did not
+   * write stays queued and is written once the flush is done. Stopping the
+   * sink writes out everything that is still queued, write errors are posted
+   * as error messages.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_WRITE_BEHIND,
+      g_param_spec_boolean ("write-behind", "Write behind",
+          "Write the data from a separate thread", DEFAULT_WRITE_BEHIND,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstGioBaseSink:max-pending-bytes:
+   *
+   * Maximum number of bytes queued for writing in write-behind mode. The
+   * streaming thread blocks when the queue is full.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_PENDING_BYTES,
+      g_param_spec_uint64 ("max-pending-bytes", "Max pending bytes",
+          "Maximum number of bytes queued for writing in write-behind mode",
+          1, G_MAXUINT64, DEFAULT_MAX_PENDING_BYTES,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstGioBaseSink:sync-interval:
+   *
+   * Minimum interval between two flushes of the stream to the storage in
+   * write-behind mode, 0 to not flush before the end of the stream. For
+   * local files the data is synced to disk.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_SYNC_INTERVAL,
+      g_param_spec_uint64 ("sync-interval", "Sync interval",
+          "Minimum interval between syncs to the storage in write-behind "
+          "mode (0 = only at the end of the stream)", 0, G_MAXUINT64,
+          DEFAULT_SYNC_INTERVAL, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstGioBaseSink:write-stats:
+   *
+   * Statistics of the write-behind mode, as a #GstStructure named
+   * "application/x-gio-sink-stats" with the following fields:
+   *
+   * * #guint64 `pending-bytes`: bytes currently queued or being written
+   * * #guint64 `max-pending-bytes`: highest number of bytes queued so far
+   * * #guint64 `writes`: number of (vectored) writes done
+   * * #guint64 `bytes-written`: number of bytes written
+   * * #guint64 `average-write-latency`: average duration of a write, in ns
+   * * #guint64 `max-write-latency`: longest duration of a write, in ns
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_WRITE_STATS,
+      g_param_spec_boxed ("write-stats", "Write statistics",
+          "Statistics of the write-behind mode", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 
   gst_element_class_add_static_pad_template (gstelement_class, &sink_factory);
 
@@ -77,6 +173,14 @@ gst_gio_base_sink_init (GstGioBaseSink * sink)
   gst_base_sink_set_sync (GST_BASE_SINK (sink), FALSE);
 
   sink->cancel = g_cancellable_new ();
+
+  sink->write_behind = DEFAULT_WRITE_BEHIND;
+  sink->max_pending_bytes = DEFAULT_MAX_PENDING_BYTES;
+  sink->sync_interval = DEFAULT_SYNC_INTERVAL;
+
+  g_mutex_init (&sink->lock);
+  g_cond_init (&sink->cond);
+  g_queue_init (&sink->queue);
 }
 
 static void
@@ -94,14 +198,395 @@ gst_gio_base_sink_finalize (GObject * object)
     sink->stream = NULL;
   }
 
+  g_mutex_clear (&sink->lock);
+  g_cond_clear (&sink->cond);
+
   GST_CALL_PARENT (G_OBJECT_CLASS, finalize, (object));
 }
 
+static void
+gst_gio_base_sink_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstGioBaseSink *sink = GST_GIO_BASE_SINK (object);
+
+  switch (prop_id) {
+    case PROP_WRITE_BEHIND:
+      GST_OBJECT_LOCK (sink);
+      sink->write_behind = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (sink);
+      break;
+    case PROP_MAX_PENDING_BYTES:
+      g_mutex_lock (&sink->lock);
+      sink->max_pending_bytes = g_value_get_uint64 (value);
+      g_cond_broadcast (&sink->cond);
+      g_mutex_unlock (&sink->lock);
+      break;
+    case PROP_SYNC_INTERVAL:
+      g_mutex_lock (&sink->lock);
+      sink->sync_interval = g_value_get_uint64 (value);
+      g_mutex_unlock (&sink->lock);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static GstStructure *
+gst_gio_base_sink_get_stats (GstGioBaseSink * sink)
+{
+  GstStructure *s;
+
+  g_mutex_lock (&sink->lock);
+  s = gst_structure_new ("application/x-gio-sink-stats",
+      "pending-bytes", G_TYPE_UINT64, sink->pending_bytes,
+      "max-pending-bytes", G_TYPE_UINT64, sink->max_pending_seen,
+      "writes", G_TYPE_UINT64, sink->n_writes,
+      "bytes-written", G_TYPE_UINT64, sink->bytes_written,
+      "average-write-latency", G_TYPE_UINT64, sink->n_writes ?
+      sink->total_write_time / sink->n_writes : (guint64) 0,
+      "max-write-latency", G_TYPE_UINT64, sink->max_write_time, NULL);
+  g_mutex_unlock (&sink->lock);
+
+  return s;
+}
+
+static void
+gst_gio_base_sink_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstGioBaseSink *sink = GST_GIO_BASE_SINK (object);
+
+  switch (prop_id) {
+    case PROP_WRITE_BEHIND:
+      GST_OBJECT_LOCK (sink);
+      g_value_set_boolean (value, sink->write_behind);
+      GST_OBJECT_UNLOCK (sink);
+      break;
+    case PROP_MAX_PENDING_BYTES:
+      g_mutex_lock (&sink->lock);
+      g_value_set_uint64 (value, sink->max_pending_bytes);
+      g_mutex_unlock (&sink->lock);
+      break;
+    case PROP_SYNC_INTERVAL:
+      g_mutex_lock (&sink->lock);
+      g_value_set_uint64 (value, sink->sync_interval);
+      g_mutex_unlock (&sink->lock);
+      break;
+    case PROP_WRITE_STATS:
+      g_value_take_boxed (value, gst_gio_base_sink_get_stats (sink));
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+/* must be called from the writer, or when it is idle */
+static gboolean
+gst_gio_base_sink_sync (GstGioBaseSink * sink, GCancellable * cancel,
+    GError ** err)
+{
+  if (!g_output_stream_flush (sink->stream, cancel, err))
+    return FALSE;
+
+#ifdef HAVE_GIO_UNIX_2_0
+  if (G_IS_FILE_DESCRIPTOR_BASED (sink->stream)) {
+    gint fd = g_file_descriptor_based_get_fd (G_FILE_DESCRIPTOR_BASED
+        (sink->stream));
+
+    GST_LOG_OBJECT (sink, "syncing fd %d", fd);
+    if (fsync (fd) < 0)
+      GST_WARNING_OBJECT (sink, "fsync failed: %s", g_strerror (errno));
+  }
+#endif
+
+  return TRUE;
+}
+
+static GstFlowReturn
+gst_gio_base_sink_write_error (GstGioBaseSink * sink, const gchar * func_name,
+    GError ** err)
+{
+  GstFlowReturn ret;
+
+  if (!gst_gio_error (sink, func_name, err, &ret)) {
+    if (GST_GIO_ERROR_MATCHES (*err, NO_SPACE)) {
+      GST_ELEMENT_ERROR (sink, RESOURCE, NO_SPACE_LEFT, (NULL),
+          ("Could not write to stream: %s", (*err)->message));
+    } else {
+      GST_ELEMENT_ERROR (sink, RESOURCE, WRITE, (NULL),
+          ("Could not write to stream: %s", (*err)->message));
+    }
+    g_clear_error (err);
+  }
+
+  return ret;
+}
+
+/* writes @buffers in order, @written is set to the number of bytes that
+ * made it to the stream, also when the write failed or was cancelled */
+static GstFlowReturn
+gst_gio_base_sink_write_buffers (GstGioBaseSink * sink, GstBuffer ** buffers,
+    guint n_buffers, GCancellable * cancel, gsize * written)
+{
+  GOutputVector vectors[MAX_VECTORS];
+  GstMapInfo maps[MAX_VECTORS];
+  GstFlowReturn ret = GST_FLOW_OK;
+  GError *err = NULL;
+  gboolean success = TRUE;
+  guint i;
+
+  for (i = 0; i < n_buffers; i++) {
+    gst_buffer_map (buffers[i], &maps[i], GST_MAP_READ);
+    vectors[i].buffer = maps[i].data;
+    vectors[i].size = maps[i].size;
+  }
+
+  *written = 0;
+#if GLIB_CHECK_VERSION(2,60,0)
+  success = g_output_stream_writev_all (sink->stream, vectors, n_buffers,
+      written, cancel, &err);
+#else
+  for (i = 0; i < n_buffers && success; i++) {
+    gsize bytes = 0;
+
+    success = g_output_stream_write_all (sink->stream, vectors[i].buffer,
+        vectors[i].size, &bytes, cancel, &err);
+    *written += bytes;
+  }
+#endif
+
+  for (i = 0; i < n_buffers; i++)
+    gst_buffer_unmap (buffers[i], &maps[i]);
+
+  if (!success)
+    ret = gst_gio_base_sink_write_error (sink, "g_output_stream_writev_all",
+        &err);
+
+  return ret;
+}
+
+/* drops what is queued but not being written yet after a write error, with
+ * the lock */
+static void
+gst_gio_base_sink_discard_queue (GstGioBaseSink * sink)
+{
+  GstBuffer *buffer;
+  guint64 bytes = 0;
+
+  while ((buffer = g_queue_pop_head (&sink->queue))) {
+    bytes += gst_buffer_get_size (buffer);
+    gst_buffer_unref (buffer);
+  }
+
+  if (bytes > 0)
+    GST_DEBUG_OBJECT (sink, "discarding %" G_GUINT64_FORMAT " queued bytes",
+        bytes);
+
+  sink->pending_bytes -= bytes;
+}
+
+/* puts the part of @buffers after the first @written bytes back at the head
+ * of the queue, with the lock */
+static void
+gst_gio_base_sink_requeue (GstGioBaseSink * sink, GstBuffer ** buffers,
+    guint n_buffers, gsize written)
+{
+  gint i;
+
+  /* skip what was written, and keep the rest of a partially written buffer */
+  for (i = 0; i < (gint) n_buffers && written > 0; i++) {
+    gsize size = gst_buffer_get_size (buffers[i]);
+
+    if (written < size) {
+      GstBuffer *rest = gst_buffer_copy_region (buffers[i],
+          GST_BUFFER_COPY_MEMORY, written, size - written);
+
+      gst_buffer_unref (buffers[i]);
+      buffers[i] = rest;
+      break;
+    }
+    gst_buffer_unref (buffers[i]);
+    buffers[i] = NULL;
+    written -= size;
+  }
+
+  for (i = (gint) n_buffers - 1; i >= 0 && buffers[i] != NULL; i--) {
+    g_queue_push_head (&sink->queue, buffers[i]);
+    buffers[i] = NULL;
+  }
+}
+
+static gpointer
+gst_gio_base_sink_writer_loop (GstGioBaseSink * sink)
+{
+  GstBuffer *buffers[MAX_VECTORS];
+  GstFlowReturn ret;
+  GError *err = NULL;
+
+  g_mutex_lock (&sink->lock);
+  while (TRUE) {
+    GCancellable *cancel;
+    GstClockTime sync_interval;
+    gint64 start, now;
+    gsize bytes = 0, written;
+    guint i, n_buffers = 0;
+
+    /* while unlocked the writer cancellable is cancelled, wait for
+     * unlock_stop to replace it before writing again */
+    while ((g_queue_is_empty (&sink->queue) || sink->unlocked)
+        && !sink->stop_writer)
+      g_cond_wait (&sink->cond, &sink->lock);
+
+    if (g_queue_is_empty (&sink->queue))
+      break;
+
+    while (n_buffers < MAX_VECTORS && !g_queue_is_empty (&sink->queue)) {
+      buffers[n_buffers] = g_queue_pop_head (&sink->queue);
+      bytes += gst_buffer_get_size (buffers[n_buffers]);
+      n_buffers++;
+    }
+    sync_interval = sink->sync_interval;
+    cancel = g_object_ref (sink->writer_cancel);
+    sink->writing = TRUE;
+    g_mutex_unlock (&sink->lock);
+
+    GST_LOG_OBJECT (sink, "writing %" G_GSIZE_FORMAT " bytes from %u buffers",
+        bytes, n_buffers);
+
+    start = g_get_monotonic_time ();
+    ret = gst_gio_base_sink_write_buffers (sink, buffers, n_buffers, cancel,
+        &written);
+    now = g_get_monotonic_time ();
+
+    if (ret == GST_FLOW_OK && sync_interval > 0 &&
+        (now - sink->last_sync) * GST_USECOND >= sync_interval) {
+      GST_LOG_OBJECT (sink, "syncing");
+      if (gst_gio_base_sink_sync (sink, cancel, &err)) {
+        sink->last_sync = now;
+      } else {
+        ret = gst_gio_base_sink_write_error (sink, "g_output_stream_flush",
+            &err);
+        /* a cancelled sync is done again after the next write */
+        if (ret == GST_FLOW_FLUSHING)
+          ret = GST_FLOW_OK;
+      }
+    }
+    g_object_unref (cancel);
+
+    g_mutex_lock (&sink->lock);
+    sink->writing = FALSE;
+    sink->pending_bytes -= written;
+    sink->n_writes++;
+    sink->bytes_written += written;
+    sink->total_write_time += (now - start) * GST_USECOND;
+    sink->max_write_time = MAX (sink->max_write_time,
+        (now - start) * GST_USECOND);
+
+    /* a cancelled write was unlocked, that is not an error of the stream
+     * and the data it did not get to is written after the unlock */
+    if (ret == GST_FLOW_FLUSHING) {
+      GST_DEBUG_OBJECT (sink, "write cancelled after %" G_GSIZE_FORMAT
+          " of %" G_GSIZE_FORMAT " bytes", written, bytes);
+      gst_gio_base_sink_requeue (sink, buffers, n_buffers, written);
+    } else {
+      sink->pending_bytes -= bytes - written;
+    }
+
+    for (i = 0; i < n_buffers; i++) {
+      if (buffers[i])
+        gst_buffer_unref (buffers[i]);
+    }
+
+    if (ret != GST_FLOW_OK && ret != GST_FLOW_FLUSHING) {
+      GST_DEBUG_OBJECT (sink, "write failed: %s, dropping queued data",
+          gst_flow_get_name (ret));
+      if (sink->writer_ret == GST_FLOW_OK)
+        sink->writer_ret = ret;
+      gst_gio_base_sink_discard_queue (sink);
+    }
+    g_cond_broadcast (&sink->cond);
+  }
+  g_mutex_unlock (&sink->lock);
+
+  GST_DEBUG_OBJECT (sink, "writer stopped");
+
+  return NULL;
+}
+
+/* wait until everything queued is written, returns the writer's error if
+ * any, or FLUSHING when unlocked */
+static GstFlowReturn
+gst_gio_base_sink_drain (GstGioBaseSink * sink)
+{
+  GstFlowReturn ret;
+
+  if (sink->writer == NULL)
+    return GST_FLOW_OK;
+
+  g_mutex_lock (&sink->lock);
+  while (!sink->unlocked && (!g_queue_is_empty (&sink->queue)
+          || sink->writing))
+    g_cond_wait (&sink->cond, &sink->lock);
+  ret = sink->writer_ret;
+  if (ret == GST_FLOW_OK && sink->unlocked)
+    ret = GST_FLOW_FLUSHING;
+  g_mutex_unlock (&sink->lock);
+
+  return ret;
+}
+
+static void
+gst_gio_base_sink_start_writer (GstGioBaseSink * sink)
+{
+  sink->pending_bytes = 0;
+  sink->writing = FALSE;
+  sink->stop_writer = FALSE;
+  sink->writer_ret = GST_FLOW_OK;
+  sink->last_sync = g_get_monotonic_time ();
+  sink->max_pending_seen = 0;
+  sink->n_writes = 0;
+  sink->bytes_written = 0;
+  sink->total_write_time = 0;
+  sink->max_write_time = 0;
+  sink->writer_cancel = g_cancellable_new ();
+
+  sink->writer = g_thread_new ("giosink-writer",
+      (GThreadFunc) gst_gio_base_sink_writer_loop, sink);
+}
+
+static void
+gst_gio_base_sink_stop_writer (GstGioBaseSink * sink)
+{
+  if (sink->writer == NULL)
+    return;
+
+  /* the writer writes out what render accepted before it stops, write
+   * errors were posted already */
+  g_mutex_lock (&sink->lock);
+  sink->stop_writer = TRUE;
+  if (g_cancellable_is_cancelled (sink->writer_cancel)) {
+    g_object_unref (sink->writer_cancel);
+    sink->writer_cancel = g_cancellable_new ();
+  }
+  g_cond_broadcast (&sink->cond);
+  g_mutex_unlock (&sink->lock);
+
+  g_thread_join (sink->writer);
+  sink->writer = NULL;
+
+  g_object_unref (sink->writer_cancel);
+  sink->writer_cancel = NULL;
+}
+
 static gboolean
 gst_gio_base_sink_start (GstBaseSink * base_sink)
 {
   GstGioBaseSink *sink = GST_GIO_BASE_SINK (base_sink);
   GstGioBaseSinkClass *gbsink_class = GST_GIO_BASE_SINK_GET_CLASS (sink);
+  gboolean write_behind;
 
   sink->position = 0;
 
@@ -117,6 +602,13 @@ gst_gio_base_sink_start (GstBaseSink * base_sink)
     return FALSE;
   }
 
+  GST_OBJECT_LOCK (sink);
+  write_behind = sink->write_behind;
+  GST_OBJECT_UNLOCK (sink);
+
+  if (write_behind)
+    gst_gio_base_sink_start_writer (sink);
+
   GST_DEBUG_OBJECT (sink, "started sink");
 
   return TRUE;
@@ -130,6 +622,8 @@ gst_gio_base_sink_stop (GstBaseSink * base_sink)
   gboolean success;
   GError *err = NULL;
 
+  gst_gio_base_sink_stop_writer (sink);
+
   if (klass->close_on_stop && G_IS_OUTPUT_STREAM (sink->stream)) {
     GST_DEBUG_OBJECT (sink, "closing stream");
 
@@ -180,6 +674,14 @@ gst_gio_base_sink_unlock (GstBaseSink * base_sink)
 
   g_cancellable_cancel (sink->cancel);
 
+  /* only the write in progress is cancelled, the queued data is kept */
+  g_mutex_lock (&sink->lock);
+  sink->unlocked = TRUE;
+  if (sink->writer)
+    g_cancellable_cancel (sink->writer_cancel);
+  g_cond_broadcast (&sink->cond);
+  g_mutex_unlock (&sink->lock);
+
   return TRUE;
 }
 
@@ -193,6 +695,16 @@ gst_gio_base_sink_unlock_stop (GstBaseSink * base_sink)
   g_object_unref (sink->cancel);
   sink->cancel = g_cancellable_new ();
 
+  g_mutex_lock (&sink->lock);
+  sink->unlocked = FALSE;
+  if (sink->writer_cancel &&
+      g_cancellable_is_cancelled (sink->writer_cancel)) {
+    g_object_unref (sink->writer_cancel);
+    sink->writer_cancel = g_cancellable_new ();
+  }
+  g_cond_broadcast (&sink->cond);
+  g_mutex_unlock (&sink->lock);
+
   return TRUE;
 }
 
@@ -218,11 +730,19 @@ gst_gio_base_sink_event (GstBaseSink * base_sink, GstEvent * event)
           break;
         }
 
+        /* the queued data goes before the new position */
+        ret = gst_gio_base_sink_drain (sink);
+        if (ret != GST_FLOW_OK)
+          break;
+
         if (GST_GIO_STREAM_IS_SEEKABLE (sink->stream)) {
           ret = gst_gio_seek (sink, G_SEEKABLE (sink->stream), segment->start,
               sink->cancel);
-          if (ret == GST_FLOW_OK)
+          if (ret == GST_FLOW_OK) {
+            g_mutex_lock (&sink->lock);
             sink->position = segment->start;
+            g_mutex_unlock (&sink->lock);
+          }
         } else {
           ret = GST_FLOW_NOT_SUPPORTED;
         }
@@ -235,7 +755,21 @@ gst_gio_base_sink_event (GstBaseSink * base_sink, GstEvent * event)
         gboolean success;
         GError *err = NULL;
 
-        success = g_output_stream_flush (sink->stream, sink->cancel, &err);
+        if (sink->writer) {
+          /* the stream belongs to the writer until it is done, which
+           * flush-start does not wait for */
+          if (GST_EVENT_TYPE (event) == GST_EVENT_FLUSH_START)
+            break;
+
+          ret = gst_gio_base_sink_drain (sink);
+          if (ret != GST_FLOW_OK)
+            break;
+
+          GST_DEBUG_OBJECT (sink, "syncing at EOS");
+          success = gst_gio_base_sink_sync (sink, sink->cancel, &err);
+        } else {
+          success = g_output_stream_flush (sink->stream, sink->cancel, &err);
+        }
 
         if (!success && !gst_gio_error (sink, "g_output_stream_flush", &err,
                 &ret)) {
@@ -257,6 +791,43 @@ gst_gio_base_sink_event (GstBaseSink * base_sink, GstEvent * event)
   }
 }
 
+static GstFlowReturn
+gst_gio_base_sink_queue_buffer (GstGioBaseSink * sink, GstBuffer * buffer)
+{
+  GstFlowReturn ret = GST_FLOW_OK;
+  gsize size = gst_buffer_get_size (buffer);
+
+  if (size == 0)
+    return GST_FLOW_OK;
+
+  g_mutex_lock (&sink->lock);
+  /* a buffer larger than the queue is only queued once the queue is empty */
+  while (sink->writer_ret == GST_FLOW_OK && !sink->unlocked &&
+      sink->pending_bytes > 0 &&
+      sink->pending_bytes + size > sink->max_pending_bytes) {
+    GST_LOG_OBJECT (sink, "queue full, waiting");
+    g_cond_wait (&sink->cond, &sink->lock);
+  }
+
+  if (sink->writer_ret != GST_FLOW_OK) {
+    ret = sink->writer_ret;
+  } else if (sink->unlocked) {
+    ret = GST_FLOW_FLUSHING;
+  } else {
+    GST_LOG_OBJECT (sink,
+        "queueing %" G_GSIZE_FORMAT " bytes for offset %" G_GUINT64_FORMAT,
+        size, sink->position);
+    g_queue_push_tail (&sink->queue, gst_buffer_ref (buffer));
+    sink->pending_bytes += size;
+    sink->max_pending_seen = MAX (sink->max_pending_seen, sink->pending_bytes);
+    sink->position += size;
+    g_cond_broadcast (&sink->cond);
+  }
+  g_mutex_unlock (&sink->lock);
+
+  return ret;
+}
+
 static GstFlowReturn
 gst_gio_base_sink_render (GstBaseSink * base_sink, GstBuffer * buffer)
 {
@@ -268,6 +839,9 @@ gst_gio_base_sink_render (GstBaseSink * base_sink, GstBuffer * buffer)
 
   g_return_val_if_fail (G_IS_OUTPUT_STREAM (sink->stream), GST_FLOW_ERROR);
 
+  if (sink->writer)
+    return gst_gio_base_sink_queue_buffer (sink, buffer);
+
   gst_buffer_map (buffer, &map, GST_MAP_READ);
 
   GST_LOG_OBJECT (sink,
@@ -325,7 +899,9 @@ gst_gio_base_sink_query (GstBaseSink * bsink, GstQuery * query)
       switch (format) {
         case GST_FORMAT_BYTES:
         case GST_FORMAT_DEFAULT:
+          g_mutex_lock (&sink->lock);
           gst_query_set_position (query, format, sink->position);
+          g_mutex_unlock (&sink->lock);
           return TRUE;
         default:
           return FALSE;
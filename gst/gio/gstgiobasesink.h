@@ -54,6 +54,30 @@ struct _GstGioBaseSink
 
   /* < private > */
   GOutputStream *stream;
+
+  /* write-behind */
+  gboolean write_behind;
+  guint64 max_pending_bytes;
+  GstClockTime sync_interval;
+
+  GThread *writer;
+  GCancellable *writer_cancel;  /* cancelled by unlock */
+  GMutex lock;
+  GCond cond;
+  GQueue queue;                 /* buffers waiting to be written */
+  guint64 pending_bytes;        /* bytes queued or being written */
+  gboolean writing;             /* the writer has buffers in flight */
+  gboolean stop_writer;
+  gboolean unlocked;
+  GstFlowReturn writer_ret;     /* first error of the writer */
+  gint64 last_sync;
+
+  /* statistics */
+  guint64 max_pending_seen;
+  guint64 n_writes;
+  guint64 bytes_written;
+  GstClockTime total_write_time;
+  GstClockTime max_write_time;
 };
 
 struct _GstGioBaseSinkClass 
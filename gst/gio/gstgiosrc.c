@@ -58,6 +58,11 @@
  * ]|
  *  The above pipeline will read and decode and play an mp3 file from a
  * SAMBA server.
+ * |[
+ * gst-launch-1.0 -v giosrc location=file:///home/joe/foo.mp4 use-mmap=true ! qtdemux ! fakesink
+ * ]|
+ *  The above pipeline maps the local file into memory and hands out parts of
+ * the mapping to the demuxer without copying them.
  *
  */
 
@@ -76,14 +81,30 @@
 #include "gstgiosrc.h"
 #include <string.h>
 
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 GST_DEBUG_CATEGORY_STATIC (gst_gio_src_debug);
 #define GST_CAT_DEFAULT gst_gio_src_debug
 
+#define DEFAULT_USE_MMAP FALSE
+
+/* readahead window advised for sequential reads of a mapped file, doubled
+ * on every advice up to the maximum */
+#define MIN_READAHEAD (256 * 1024)
+#define MAX_READAHEAD (16 * 1024 * 1024)
+/* number of non-sequential reads in a row after which the kernel readahead
+ * is disabled for the mapping */
+#define RANDOM_ACCESS_THRESHOLD 3
+
 enum
 {
   PROP_0,
   PROP_LOCATION,
-  PROP_FILE
+  PROP_FILE,
+  PROP_USE_MMAP
 };
 
 #define gst_gio_src_parent_class parent_class
@@ -100,6 +121,10 @@ static void gst_gio_src_get_property (GObject * object, guint prop_id,
 static GInputStream *gst_gio_src_get_stream (GstGioBaseSrc * bsrc);
 
 static gboolean gst_gio_src_query (GstBaseSrc * base_src, GstQuery * query);
+static gboolean gst_gio_src_start (GstBaseSrc * base_src);
+static gboolean gst_gio_src_stop (GstBaseSrc * base_src);
+static GstFlowReturn gst_gio_src_create (GstBaseSrc * base_src,
+    guint64 offset, guint size, GstBuffer ** buf_return);
 
 static void
 gst_gio_src_class_init (GstGioSrcClass * klass)
@@ -128,6 +153,26 @@ gst_gio_src_class_init (GstGioSrcClass * klass)
       g_param_spec_object ("file", "File", "GFile to read from",
           G_TYPE_FILE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstGioSrc:use-mmap:
+   *
+   * Map local files into memory and output parts of the mapping instead of
+   * reading the data into newly allocated buffers. Only file:// locations
+   * are mapped, everything else is read as usual.
+   *
+   * The kernel is given readahead hints depending on whether the file is
+   * read sequentially or randomly.
+   *
+   * Note that the file must not be truncated while it is mapped, as
+   * accessing the data past the new end of the file crashes the process.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_USE_MMAP,
+      g_param_spec_boolean ("use-mmap", "Use mmap",
+          "Map local files into memory instead of reading them",
+          DEFAULT_USE_MMAP, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_set_static_metadata (gstelement_class, "GIO source",
       "Source/File",
       "Read from any GIO-supported location",
@@ -135,6 +180,9 @@ gst_gio_src_class_init (GstGioSrcClass * klass)
       "Sebastian Dröge <sebastian.droege@collabora.co.uk>");
 
   gstbasesrc_class->query = GST_DEBUG_FUNCPTR (gst_gio_src_query);
+  gstbasesrc_class->start = GST_DEBUG_FUNCPTR (gst_gio_src_start);
+  gstbasesrc_class->stop = GST_DEBUG_FUNCPTR (gst_gio_src_stop);
+  gstbasesrc_class->create = GST_DEBUG_FUNCPTR (gst_gio_src_create);
 
   gstgiobasesrc_class->get_stream = GST_DEBUG_FUNCPTR (gst_gio_src_get_stream);
   gstgiobasesrc_class->close_on_stop = TRUE;
@@ -143,6 +191,7 @@ gst_gio_src_class_init (GstGioSrcClass * klass)
 static void
 gst_gio_src_init (GstGioSrc * src)
 {
+  src->use_mmap = DEFAULT_USE_MMAP;
 }
 
 static void
@@ -207,6 +256,11 @@ gst_gio_src_set_property (GObject * object, guint prop_id,
 
       src->file = g_value_dup_object (value);
 
+      GST_OBJECT_UNLOCK (GST_OBJECT (src));
+      break;
+    case PROP_USE_MMAP:
+      GST_OBJECT_LOCK (GST_OBJECT (src));
+      src->use_mmap = g_value_get_boolean (value);
       GST_OBJECT_UNLOCK (GST_OBJECT (src));
       break;
     default:
@@ -241,6 +295,11 @@ gst_gio_src_get_property (GObject * object, guint prop_id,
       g_value_set_object (value, src->file);
       GST_OBJECT_UNLOCK (GST_OBJECT (src));
       break;
+    case PROP_USE_MMAP:
+      GST_OBJECT_LOCK (GST_OBJECT (src));
+      g_value_set_boolean (value, src->use_mmap);
+      GST_OBJECT_UNLOCK (GST_OBJECT (src));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -348,3 +407,169 @@ gst_gio_src_get_stream (GstGioBaseSrc * bsrc)
 
   return stream;
 }
+
+static void
+gst_gio_src_map_file (GstGioSrc * src)
+{
+  GError *err = NULL;
+  gchar *path;
+
+  GST_OBJECT_LOCK (src);
+  if (!src->use_mmap || !g_file_has_uri_scheme (src->file, "file")) {
+    GST_OBJECT_UNLOCK (src);
+    return;
+  }
+  path = g_file_get_path (src->file);
+  GST_OBJECT_UNLOCK (src);
+
+  if (path == NULL)
+    return;
+
+  src->mapped = g_mapped_file_new (path, FALSE, &err);
+  if (src->mapped == NULL) {
+    GST_WARNING_OBJECT (src, "Could not map %s, reading it instead: %s", path,
+        err->message);
+    g_clear_error (&err);
+  } else if (g_mapped_file_get_length (src->mapped) == 0) {
+    /* empty files have no mapping */
+    g_mapped_file_unref (src->mapped);
+    src->mapped = NULL;
+  } else {
+    GST_DEBUG_OBJECT (src, "mapped %" G_GSIZE_FORMAT " bytes of %s",
+        g_mapped_file_get_length (src->mapped), path);
+  }
+  g_free (path);
+
+  src->read_end = 0;
+  src->advised_end = 0;
+  src->readahead = MIN_READAHEAD;
+  src->n_jumps = 0;
+  src->random = FALSE;
+#ifdef HAVE_MMAP
+  src->page_size = sysconf (_SC_PAGESIZE);
+#endif
+}
+
+static gboolean
+gst_gio_src_start (GstBaseSrc * base_src)
+{
+  GstGioSrc *src = GST_GIO_SRC (base_src);
+
+  if (!GST_BASE_SRC_CLASS (parent_class)->start (base_src))
+    return FALSE;
+
+  gst_gio_src_map_file (src);
+
+  return TRUE;
+}
+
+static gboolean
+gst_gio_src_stop (GstBaseSrc * base_src)
+{
+  GstGioSrc *src = GST_GIO_SRC (base_src);
+
+  /* buffers still holding on to parts of the mapping keep it alive */
+  if (src->mapped) {
+    g_mapped_file_unref (src->mapped);
+    src->mapped = NULL;
+  }
+
+  return GST_BASE_SRC_CLASS (parent_class)->stop (base_src);
+}
+
+/* Tell the kernel which parts of the mapping are going to be needed next.
+ * Sequential reads get a growing readahead window ahead of the reader,
+ * random reads only get the requested range and, once they are frequent,
+ * the kernel's own readahead is disabled so that it does not read data
+ * nobody asked for. */
+static void
+gst_gio_src_advise (GstGioSrc * src, guint64 offset, guint size)
+{
+#if defined (HAVE_MMAP) && defined (MADV_WILLNEED)
+  guint8 *data = (guint8 *) g_mapped_file_get_contents (src->mapped);
+  gsize length = g_mapped_file_get_length (src->mapped);
+  guint64 start, end;
+
+  if (offset == src->read_end) {
+    src->n_jumps = 0;
+    if (src->random) {
+      GST_DEBUG_OBJECT (src, "sequential access at %" G_GUINT64_FORMAT,
+          offset);
+      madvise (data, length, MADV_NORMAL);
+      src->random = FALSE;
+    }
+
+    /* still far enough ahead of the reader */
+    if (src->advised_end > offset + size + src->readahead / 2)
+      goto done;
+
+    start = MAX (offset + size, src->advised_end);
+    end = MIN (offset + size + src->readahead, length);
+    src->readahead = MIN (src->readahead * 2, MAX_READAHEAD);
+  } else {
+    src->readahead = MIN_READAHEAD;
+    if (++src->n_jumps >= RANDOM_ACCESS_THRESHOLD && !src->random) {
+      GST_DEBUG_OBJECT (src, "random access at %" G_GUINT64_FORMAT, offset);
+      madvise (data, length, MADV_RANDOM);
+      src->random = TRUE;
+    }
+
+    start = offset;
+    end = MIN (offset + size, length);
+  }
+
+  src->advised_end = end;
+
+  /* madvise() wants page aligned addresses */
+  start &= ~((guint64) src->page_size - 1);
+  if (end > start) {
+    GST_LOG_OBJECT (src, "advising %" G_GUINT64_FORMAT "-%" G_GUINT64_FORMAT,
+        start, end);
+    madvise (data + start, end - start, MADV_WILLNEED);
+  }
+
+done:
+  src->read_end = offset + size;
+#endif
+}
+
+static GstFlowReturn
+gst_gio_src_create (GstBaseSrc * base_src, guint64 offset, guint size,
+    GstBuffer ** buf_return)
+{
+  GstGioSrc *src = GST_GIO_SRC (base_src);
+  GstBuffer *buf;
+  gsize length;
+
+  if (src->mapped == NULL)
+    goto read_stream;
+
+  /* data appended to the file after it was mapped is read from the stream */
+  length = g_mapped_file_get_length (src->mapped);
+  if (offset >= length)
+    goto read_stream;
+
+  size = MIN (size, length - offset);
+  gst_gio_src_advise (src, offset, size);
+
+  GST_LOG_OBJECT (src, "Creating buffer from mapping: offset %"
+      G_GUINT64_FORMAT " length %u", offset, size);
+
+  buf = gst_buffer_new ();
+  gst_buffer_append_memory (buf,
+      gst_memory_new_wrapped (GST_MEMORY_FLAG_READONLY,
+          g_mapped_file_get_contents (src->mapped), length, offset, size,
+          g_mapped_file_ref (src->mapped),
+          (GDestroyNotify) g_mapped_file_unref));
+
+  GST_BUFFER_OFFSET (buf) = offset;
+  GST_BUFFER_OFFSET_END (buf) = offset + size;
+
+  *buf_return = buf;
+
+  return GST_FLOW_OK;
+
+read_stream:
+  return GST_BASE_SRC_CLASS (parent_class)->create (base_src, offset, size,
+      buf_return);
+}
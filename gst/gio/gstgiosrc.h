@@ -54,6 +54,17 @@ struct _GstGioSrc
   
   /*< private >*/
   GFile *file;
+
+  gboolean use_mmap;
+  GMappedFile *mapped;
+
+  /* readahead hints for the mapping */
+  gsize page_size;
+  guint64 read_end;             /* end of the previous read */
+  guint64 advised_end;          /* end of the range last advised */
+  gsize readahead;              /* current readahead window */
+  guint n_jumps;                /* non-sequential reads in a row */
+  gboolean random;              /* the mapping is advised as random access */
 };
 
 struct _GstGioSrcClass 
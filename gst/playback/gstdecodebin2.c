@@ -163,10 +163,6 @@ struct _GstDecodeBin
   GstDecodeChain *decode_chain; /* Top level decode chain */
   guint nbpads;                 /* unique identifier for source pads */
 
-  GMutex factories_lock;
-  guint32 factories_cookie;     /* Cookie from last time when factories was updated */
-  GList *factories;             /* factories we can use for selecting elements */
-
   GMutex subtitle_lock;         /* Protects changes to subtitles and encoding */
   GList *subtitles;             /* List of elements with subtitle-encoding,
                                  * protected by above mutex! */
@@ -278,7 +274,8 @@ enum
   PROP_MAX_SIZE_TIME,
   PROP_POST_STREAM_TOPOLOGY,
   PROP_EXPOSE_ALL_STREAMS,
-  PROP_CONNECTION_SPEED
+  PROP_CONNECTION_SPEED,
+  PROP_FACTORY_CACHE_STATS
 };
 
 static GstBinClass *parent_class;
@@ -1000,6 +997,21 @@ gst_decode_bin_class_init (GstDecodeBinClass * klass)
           0, G_MAXUINT64 / 1000, DEFAULT_CONNECTION_SPEED,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstDecodeBin:factory-cache-stats:
+   *
+   * Counters of the autoplug factory cache shared by all autoplugging
+   * elements of the process: the number of filter results
+   * that were found in the cache ("hits") or had to be computed ("misses"),
+   * the number of times the factory lists were rebuilt from the registry
+   * ("rebuilds") and the number of cached filter results ("entries").
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_klass, PROP_FACTORY_CACHE_STATS,
+      g_param_spec_boxed ("factory-cache-stats", "Factory cache statistics",
+          "Statistics of the autoplug factory cache shared by all instances",
+          GST_TYPE_STRUCTURE, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 
 
   klass->autoplug_continue =
@@ -1033,32 +1045,9 @@ gst_decode_bin_class_init (GstDecodeBinClass * klass)
   g_type_class_ref (GST_TYPE_DECODE_PAD);
 }
 
-/* Must be called with factories lock! */
-static void
-gst_decode_bin_update_factories_list (GstDecodeBin * dbin)
-{
-  guint cookie;
-
-  cookie = gst_registry_get_feature_list_cookie (gst_registry_get ());
-  if (!dbin->factories || dbin->factories_cookie != cookie) {
-    if (dbin->factories)
-      gst_plugin_feature_list_free (dbin->factories);
-    dbin->factories =
-        gst_element_factory_list_get_elements
-        (GST_ELEMENT_FACTORY_TYPE_DECODABLE, GST_RANK_MARGINAL);
-    dbin->factories =
-        g_list_sort (dbin->factories,
-        gst_playback_utils_compare_factories_func);
-    dbin->factories_cookie = cookie;
-  }
-}
-
 static void
 gst_decode_bin_init (GstDecodeBin * decode_bin)
 {
-  /* first filter out the interesting element factories */
-  g_mutex_init (&decode_bin->factories_lock);
-
   /* we create the typefind element only once */
   decode_bin->typefind = gst_element_factory_make ("typefind", "typefind");
   if (!decode_bin->typefind) {
@@ -1125,10 +1114,6 @@ gst_decode_bin_dispose (GObject * object)
 
   decode_bin = GST_DECODE_BIN (object);
 
-  if (decode_bin->factories)
-    gst_plugin_feature_list_free (decode_bin->factories);
-  decode_bin->factories = NULL;
-
   if (decode_bin->decode_chain)
     gst_decode_chain_free (decode_bin->decode_chain);
   decode_bin->decode_chain = NULL;
@@ -1160,7 +1145,6 @@ gst_decode_bin_finalize (GObject * object)
   g_mutex_clear (&decode_bin->subtitle_lock);
   g_mutex_clear (&decode_bin->buffering_lock);
   g_mutex_clear (&decode_bin->buffering_post_lock);
-  g_mutex_clear (&decode_bin->factories_lock);
   g_mutex_clear (&decode_bin->cleanup_lock);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
@@ -1358,6 +1342,9 @@ gst_decode_bin_get_property (GObject * object, guint prop_id,
       g_value_set_uint64 (value, dbin->connection_speed / 1000);
       GST_OBJECT_UNLOCK (dbin);
       break;
+    case PROP_FACTORY_CACHE_STATS:
+      g_value_take_boxed (value, gst_playback_utils_get_factory_cache_stats ());
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1384,17 +1371,14 @@ gst_decode_bin_autoplug_factories (GstElement * element, GstPad * pad,
 {
   GList *list, *tmp;
   GValueArray *result;
-  GstDecodeBin *dbin = GST_DECODE_BIN_CAST (element);
 
   GST_DEBUG_OBJECT (element, "finding factories");
 
-  /* return all compatible factories for caps */
-  g_mutex_lock (&dbin->factories_lock);
-  gst_decode_bin_update_factories_list (dbin);
+  /* return all compatible factories for caps, the lists and the filter
+   * results are shared with all other autoplugging bins */
   list =
-      gst_element_factory_list_filter (dbin->factories, caps, GST_PAD_SINK,
-      gst_caps_is_fixed (caps));
-  g_mutex_unlock (&dbin->factories_lock);
+      gst_playback_utils_filter_factories (GST_PLAYBACK_FACTORIES_AUTOPLUG,
+      caps, gst_caps_is_fixed (caps));
 
   result = g_value_array_new (g_list_length (list));
   for (tmp = list; tmp; tmp = tmp->next) {
@@ -32,6 +32,7 @@
 
 #include "gstplayback.h"
 #include "gstplay-enum.h"
+#include "gstplaybackutils.h"
 #include "gstrawcaps.h"
 
 /**
@@ -250,11 +251,9 @@ struct _GstDecodebin3
    * FIXME : Is this really needed ? */
   GList *pending_collection;
 
-  /* Factories */
+  /* Factories, copies of the lists shared by all autoplugging bins */
   GMutex factories_lock;
   guint32 factories_cookie;
-  /* All DECODABLE factories */
-  GList *factories;
   /* Only DECODER factories */
   GList *decoder_factories;
   /* DECODABLE but not DECODER factories */
@@ -638,12 +637,10 @@ gst_decodebin3_dispose (GObject * object)
   GstDecodebin3 *dbin = (GstDecodebin3 *) object;
   GList *walk, *next;
 
-  if (dbin->factories)
-    gst_plugin_feature_list_free (dbin->factories);
-  if (dbin->decoder_factories)
-    g_list_free (dbin->decoder_factories);
-  if (dbin->decodable_factories)
-    g_list_free (dbin->decodable_factories);
+  gst_plugin_feature_list_free (dbin->decoder_factories);
+  dbin->decoder_factories = NULL;
+  gst_plugin_feature_list_free (dbin->decodable_factories);
+  dbin->decodable_factories = NULL;
   g_list_free_full (dbin->requested_selection, g_free);
   g_list_free (dbin->active_selection);
   g_list_free (dbin->to_activate);
@@ -1018,33 +1015,18 @@ gst_decode_bin_update_factories_list (GstDecodebin3 * dbin)
   guint cookie;
 
   cookie = gst_registry_get_feature_list_cookie (gst_registry_get ());
-  if (!dbin->factories || dbin->factories_cookie != cookie) {
-    GList *tmp;
-    if (dbin->factories)
-      gst_plugin_feature_list_free (dbin->factories);
-    if (dbin->decoder_factories)
-      g_list_free (dbin->decoder_factories);
-    if (dbin->decodable_factories)
-      g_list_free (dbin->decodable_factories);
-    dbin->factories =
-        gst_element_factory_list_get_elements
-        (GST_ELEMENT_FACTORY_TYPE_DECODABLE, GST_RANK_MARGINAL);
-    dbin->factories =
-        g_list_sort (dbin->factories, gst_plugin_feature_rank_compare_func);
-    dbin->factories_cookie = cookie;
-
-    /* Filter decoder and other decodables */
-    dbin->decoder_factories = NULL;
-    dbin->decodable_factories = NULL;
-    for (tmp = dbin->factories; tmp; tmp = tmp->next) {
-      GstElementFactory *fact = (GstElementFactory *) tmp->data;
-      if (gst_element_factory_list_is_type (fact,
-              GST_ELEMENT_FACTORY_TYPE_DECODER))
-        dbin->decoder_factories = g_list_append (dbin->decoder_factories, fact);
-      else
-        dbin->decodable_factories =
-            g_list_append (dbin->decodable_factories, fact);
-    }
+  if ((!dbin->decoder_factories && !dbin->decodable_factories)
+      || dbin->factories_cookie != cookie) {
+    gst_plugin_feature_list_free (dbin->decoder_factories);
+    gst_plugin_feature_list_free (dbin->decodable_factories);
+
+    /* Decoders and other decodables, both sorted by rank */
+    dbin->decoder_factories =
+        gst_playback_utils_get_factories (GST_PLAYBACK_FACTORIES_DECODERS,
+        &dbin->factories_cookie);
+    dbin->decodable_factories =
+        gst_playback_utils_get_factories (GST_PLAYBACK_FACTORIES_DECODABLES,
+        NULL);
   }
 }
 
@@ -2043,17 +2025,14 @@ have_factory (GstDecodebin3 * dbin, GstCaps * caps,
   gboolean ret = FALSE;
   GList *res;
 
-  g_mutex_lock (&dbin->factories_lock);
-  gst_decode_bin_update_factories_list (dbin);
   if (ftype == GST_ELEMENT_FACTORY_TYPE_DECODER)
     res =
-        gst_element_factory_list_filter (dbin->decoder_factories,
-        caps, GST_PAD_SINK, TRUE);
+        gst_playback_utils_filter_factories (GST_PLAYBACK_FACTORIES_DECODERS,
+        caps, TRUE);
   else
     res =
-        gst_element_factory_list_filter (dbin->decodable_factories,
-        caps, GST_PAD_SINK, TRUE);
-  g_mutex_unlock (&dbin->factories_lock);
+        gst_playback_utils_filter_factories
+        (GST_PLAYBACK_FACTORIES_DECODABLES, caps, TRUE);
 
   if (res) {
     ret = TRUE;
@@ -2072,18 +2051,16 @@ create_element (GstDecodebin3 * dbin, GstStream * stream,
   GstElement *element = NULL;
   GstCaps *caps;
 
-  g_mutex_lock (&dbin->factories_lock);
-  gst_decode_bin_update_factories_list (dbin);
+  /* the filter results are shared with all other autoplugging bins */
   caps = gst_stream_get_caps (stream);
   if (ftype == GST_ELEMENT_FACTORY_TYPE_DECODER)
     res =
-        gst_element_factory_list_filter (dbin->decoder_factories,
-        caps, GST_PAD_SINK, TRUE);
+        gst_playback_utils_filter_factories (GST_PLAYBACK_FACTORIES_DECODERS,
+        caps, TRUE);
   else
     res =
-        gst_element_factory_list_filter (dbin->decodable_factories,
-        caps, GST_PAD_SINK, TRUE);
-  g_mutex_unlock (&dbin->factories_lock);
+        gst_playback_utils_filter_factories
+        (GST_PLAYBACK_FACTORIES_DECODABLES, caps, TRUE);
 
   if (res) {
     element =
@@ -159,10 +159,6 @@ struct _GstParseBin
   GstParseChain *parse_chain;   /* Top level parse chain */
   guint nbpads;                 /* unique identifier for source pads */
 
-  GMutex factories_lock;
-  guint32 factories_cookie;     /* Cookie from last time when factories was updated */
-  GList *factories;             /* factories we can use for selecting elements */
-
   GMutex subtitle_lock;         /* Protects changes to subtitles and encoding */
   GList *subtitles;             /* List of elements with subtitle-encoding,
                                  * protected by above mutex! */
@@ -867,31 +863,9 @@ gst_parse_bin_class_init (GstParseBinClass * klass)
   g_type_class_ref (GST_TYPE_PARSE_PAD);
 }
 
-static void
-gst_parse_bin_update_factories_list (GstParseBin * parsebin)
-{
-  guint cookie;
-
-  cookie = gst_registry_get_feature_list_cookie (gst_registry_get ());
-  if (!parsebin->factories || parsebin->factories_cookie != cookie) {
-    if (parsebin->factories)
-      gst_plugin_feature_list_free (parsebin->factories);
-    parsebin->factories =
-        gst_element_factory_list_get_elements
-        (GST_ELEMENT_FACTORY_TYPE_DECODABLE, GST_RANK_MARGINAL);
-    parsebin->factories =
-        g_list_sort (parsebin->factories,
-        gst_playback_utils_compare_factories_func);
-    parsebin->factories_cookie = cookie;
-  }
-}
-
 static void
 gst_parse_bin_init (GstParseBin * parse_bin)
 {
-  /* first filter out the interesting element factories */
-  g_mutex_init (&parse_bin->factories_lock);
-
   /* we create the typefind element only once */
   parse_bin->typefind = gst_element_factory_make ("typefind", "typefind");
   if (!parse_bin->typefind) {
@@ -950,10 +924,6 @@ gst_parse_bin_dispose (GObject * object)
 
   parse_bin = GST_PARSE_BIN (object);
 
-  if (parse_bin->factories)
-    gst_plugin_feature_list_free (parse_bin->factories);
-  parse_bin->factories = NULL;
-
   if (parse_bin->parse_chain)
     gst_parse_chain_free (parse_bin->parse_chain);
   parse_bin->parse_chain = NULL;
@@ -977,7 +947,6 @@ gst_parse_bin_finalize (GObject * object)
   g_mutex_clear (&parse_bin->expose_lock);
   g_mutex_clear (&parse_bin->dyn_lock);
   g_mutex_clear (&parse_bin->subtitle_lock);
-  g_mutex_clear (&parse_bin->factories_lock);
   g_mutex_clear (&parse_bin->cleanup_lock);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
@@ -1123,17 +1092,14 @@ gst_parse_bin_autoplug_factories (GstElement * element, GstPad * pad,
 {
   GList *list, *tmp;
   GValueArray *result;
-  GstParseBin *parsebin = GST_PARSE_BIN_CAST (element);
 
   GST_DEBUG_OBJECT (element, "finding factories");
 
-  /* return all compatible factories for caps */
-  g_mutex_lock (&parsebin->factories_lock);
-  gst_parse_bin_update_factories_list (parsebin);
+  /* return all compatible factories for caps, the lists and the filter
+   * results are shared with all other autoplugging bins */
   list =
-      gst_element_factory_list_filter (parsebin->factories, caps, GST_PAD_SINK,
-      gst_caps_is_fixed (caps));
-  g_mutex_unlock (&parsebin->factories_lock);
+      gst_playback_utils_filter_factories (GST_PLAYBACK_FACTORIES_AUTOPLUG,
+      caps, gst_caps_is_fixed (caps));
 
   result = g_value_array_new (g_list_length (list));
   for (tmp = list; tmp; tmp = tmp->next) {
@@ -162,3 +162,182 @@ gst_playback_utils_compare_factories_func (gconstpointer p1, gconstpointer p2)
    * and then by factory name */
   return gst_plugin_feature_rank_compare_func (p1, p2);
 }
+
+/* Process-wide cache of the autoplug factory lists and of the result of
+ * filtering them against caps. Starting many decodebins otherwise rebuilds
+ * and re-filters the same lists for every bin and every new pad. Everything
+ * is dropped when the registry feature list cookie changes. */
+
+/* maximum number of filter results that are kept */
+#define FACTORY_CACHE_MAX_ENTRIES 128
+#define N_FACTORY_LISTS (GST_PLAYBACK_FACTORIES_DECODABLES + 1)
+
+typedef struct
+{
+  GstPlaybackFactoryList list;
+  GstCaps *caps;
+  gboolean subsetonly;
+  GList *factories;
+} FactoryCacheEntry;
+
+static GMutex factory_cache_lock;
+static gboolean factory_cache_valid = FALSE;
+static guint32 factory_cache_cookie;
+static GList *factory_lists[N_FACTORY_LISTS];
+/* most recently used entries first */
+static GQueue factory_cache = G_QUEUE_INIT;
+static guint64 factory_cache_hits = 0;
+static guint64 factory_cache_misses = 0;
+/* number of times the factory lists were built from the registry */
+static guint64 factory_cache_rebuilds = 0;
+
+static void
+factory_cache_entry_free (FactoryCacheEntry * entry)
+{
+  gst_caps_unref (entry->caps);
+  gst_plugin_feature_list_free (entry->factories);
+  g_slice_free (FactoryCacheEntry, entry);
+}
+
+/* Must be called with the factory cache lock */
+static void
+factory_cache_update (void)
+{
+  GList *factories, *tmp;
+  guint32 cookie;
+  gint i;
+
+  cookie = gst_registry_get_feature_list_cookie (gst_registry_get ());
+  if (factory_cache_valid && factory_cache_cookie == cookie)
+    return;
+
+  GST_DEBUG ("Registry changed, rebuilding autoplug factory lists "
+      "(hits %" G_GUINT64_FORMAT ", misses %" G_GUINT64_FORMAT ")",
+      factory_cache_hits, factory_cache_misses);
+
+  for (i = 0; i < N_FACTORY_LISTS; i++) {
+    gst_plugin_feature_list_free (factory_lists[i]);
+    factory_lists[i] = NULL;
+  }
+  g_queue_free_full (&factory_cache, (GDestroyNotify) factory_cache_entry_free);
+  g_queue_init (&factory_cache);
+
+  factories =
+      gst_element_factory_list_get_elements (GST_ELEMENT_FACTORY_TYPE_DECODABLE,
+      GST_RANK_MARGINAL);
+
+  factories = g_list_sort (factories, gst_plugin_feature_rank_compare_func);
+  for (tmp = g_list_last (factories); tmp; tmp = tmp->prev) {
+    GstElementFactory *fact = (GstElementFactory *) tmp->data;
+
+    if (gst_element_factory_list_is_type (fact,
+            GST_ELEMENT_FACTORY_TYPE_DECODER))
+      factory_lists[GST_PLAYBACK_FACTORIES_DECODERS] =
+          g_list_prepend (factory_lists[GST_PLAYBACK_FACTORIES_DECODERS],
+          gst_object_ref (fact));
+    else
+      factory_lists[GST_PLAYBACK_FACTORIES_DECODABLES] =
+          g_list_prepend (factory_lists[GST_PLAYBACK_FACTORIES_DECODABLES],
+          gst_object_ref (fact));
+  }
+
+  factory_lists[GST_PLAYBACK_FACTORIES_AUTOPLUG] =
+      g_list_sort (factories, gst_playback_utils_compare_factories_func);
+
+  factory_cache_cookie = cookie;
+  factory_cache_valid = TRUE;
+  factory_cache_rebuilds++;
+}
+
+/* returns a copy of the shared factory list @list, and optionally the
+ * registry cookie it was built for */
+GList *
+gst_playback_utils_get_factories (GstPlaybackFactoryList list, guint32 * cookie)
+{
+  GList *ret;
+
+  g_return_val_if_fail (list < N_FACTORY_LISTS, NULL);
+
+  g_mutex_lock (&factory_cache_lock);
+  factory_cache_update ();
+  ret = gst_plugin_feature_list_copy (factory_lists[list]);
+  if (cookie)
+    *cookie = factory_cache_cookie;
+  g_mutex_unlock (&factory_cache_lock);
+
+  return ret;
+}
+
+/* same as gst_element_factory_list_filter() on the shared list @list for
+ * sink pads, the result is cached for later calls with equal caps */
+GList *
+gst_playback_utils_filter_factories (GstPlaybackFactoryList list,
+    GstCaps * caps, gboolean subsetonly)
+{
+  FactoryCacheEntry *entry = NULL;
+  GList *tmp, *ret;
+
+  g_return_val_if_fail (list < N_FACTORY_LISTS, NULL);
+  g_return_val_if_fail (GST_IS_CAPS (caps), NULL);
+
+  g_mutex_lock (&factory_cache_lock);
+  factory_cache_update ();
+
+  for (tmp = factory_cache.head; tmp; tmp = tmp->next) {
+    FactoryCacheEntry *e = tmp->data;
+
+    if (e->list == list && e->subsetonly == subsetonly &&
+        (e->caps == caps || gst_caps_is_strictly_equal (e->caps, caps))) {
+      entry = e;
+      /* move it to the front */
+      if (tmp != factory_cache.head) {
+        g_queue_unlink (&factory_cache, tmp);
+        g_queue_push_head_link (&factory_cache, tmp);
+      }
+      break;
+    }
+  }
+
+  if (entry) {
+    factory_cache_hits++;
+  } else {
+    factory_cache_misses++;
+
+    entry = g_slice_new (FactoryCacheEntry);
+    entry->list = list;
+    entry->caps = gst_caps_copy (caps);
+    entry->subsetonly = subsetonly;
+    entry->factories = gst_element_factory_list_filter (factory_lists[list],
+        caps, GST_PAD_SINK, subsetonly);
+
+    g_queue_push_head (&factory_cache, entry);
+    if (factory_cache.length > FACTORY_CACHE_MAX_ENTRIES)
+      factory_cache_entry_free (g_queue_pop_tail (&factory_cache));
+
+    GST_LOG ("Filtered factories for caps %" GST_PTR_FORMAT " (hits %"
+        G_GUINT64_FORMAT ", misses %" G_GUINT64_FORMAT ")", caps,
+        factory_cache_hits, factory_cache_misses);
+  }
+
+  ret = gst_plugin_feature_list_copy (entry->factories);
+  g_mutex_unlock (&factory_cache_lock);
+
+  return ret;
+}
+
+/* returns the process-wide counters of the factory cache */
+GstStructure *
+gst_playback_utils_get_factory_cache_stats (void)
+{
+  GstStructure *s;
+
+  g_mutex_lock (&factory_cache_lock);
+  s = gst_structure_new ("application/x-factory-cache-stats",
+      "hits", G_TYPE_UINT64, factory_cache_hits,
+      "misses", G_TYPE_UINT64, factory_cache_misses,
+      "rebuilds", G_TYPE_UINT64, factory_cache_rebuilds,
+      "entries", G_TYPE_UINT, factory_cache.length, NULL);
+  g_mutex_unlock (&factory_cache_lock);
+
+  return s;
+}
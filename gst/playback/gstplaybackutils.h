@@ -36,6 +36,29 @@ gst_playback_utils_get_n_common_capsfeatures (GstElementFactory * fact1,
 G_GNUC_INTERNAL
 gint
 gst_playback_utils_compare_factories_func (gconstpointer p1, gconstpointer p2);
+
+/* The factory lists shared by all autoplugging bins of the process */
+typedef enum {
+  /* all decodable factories, parsers first (decodebin2, parsebin...) */
+  GST_PLAYBACK_FACTORIES_AUTOPLUG,
+  /* the decoders only, sorted by rank (decodebin3) */
+  GST_PLAYBACK_FACTORIES_DECODERS,
+  /* the decodable factories that are not decoders, sorted by rank */
+  GST_PLAYBACK_FACTORIES_DECODABLES
+} GstPlaybackFactoryList;
+
+G_GNUC_INTERNAL
+GList *
+gst_playback_utils_get_factories (GstPlaybackFactoryList list,
+                                  guint32 * cookie);
+G_GNUC_INTERNAL
+GList *
+gst_playback_utils_filter_factories (GstPlaybackFactoryList list,
+                                     GstCaps * caps,
+                                     gboolean subsetonly);
+G_GNUC_INTERNAL
+GstStructure *
+gst_playback_utils_get_factory_cache_stats (void);
 G_END_DECLS
 
 #endif /* __GST_PLAYBACK_UTILS_H__ */
@@ -388,6 +388,14 @@ struct _GstSourceGroup
   GstMessage *pending_buffering_msg;
 };
 
+/* An idle uridecodebin3 configured for an uri that is likely to be played
+ * next, kept in READY so that switching to it skips creating it */
+typedef struct
+{
+  gchar *uri;
+  GstElement *uridecodebin;
+} GstStandbyEntry;
+
 #define GST_PLAY_BIN3_GET_LOCK(bin) (&((GstPlayBin3*)(bin))->lock)
 #define GST_PLAY_BIN3_LOCK(bin) (g_rec_mutex_lock (GST_PLAY_BIN3_GET_LOCK(bin)))
 #define GST_PLAY_BIN3_UNLOCK(bin) (g_rec_mutex_unlock (GST_PLAY_BIN3_GET_LOCK(bin)))
@@ -503,6 +511,14 @@ struct _GstPlayBin3
   GSequence *velements;         /* a list of GstAVElements for video stream */
 
   guint64 ring_buffer_max_size; /* 0 means disabled */
+
+  /* uris to keep a standby uridecodebin3 for and the list of
+   * GstStandbyEntry, protected by the PLAY_BIN_LOCK */
+  gchar **standby_uris;
+  GList *standby;
+  /* number of standby uridecodebin3 prepared and used by a group */
+  guint64 standby_prepared;
+  guint64 standby_used;
 };
 
 struct _GstPlayBin3Class
@@ -515,6 +531,9 @@ struct _GstPlayBin3Class
 
   /* get the last video sample and convert it to the given caps */
   GstSample *(*convert_sample) (GstPlayBin3 * playbin, GstCaps * caps);
+
+  /* switch to a new uri without a state change of the sinks */
+  gboolean (*switch_uri) (GstPlayBin3 * playbin, const gchar * uri);
 };
 
 /* props */
@@ -570,7 +589,9 @@ enum
   PROP_AUDIO_FILTER,
   PROP_VIDEO_FILTER,
   PROP_MULTIVIEW_MODE,
-  PROP_MULTIVIEW_FLAGS
+  PROP_MULTIVIEW_FLAGS,
+  PROP_STANDBY_URIS,
+  PROP_STANDBY_STATS
 };
 
 /* signals */
@@ -580,6 +601,7 @@ enum
   SIGNAL_CONVERT_SAMPLE,
   SIGNAL_SOURCE_SETUP,
   SIGNAL_ELEMENT_SETUP,
+  SIGNAL_SWITCH_URI,
   LAST_SIGNAL
 };
 
@@ -610,6 +632,10 @@ static GstSample *gst_play_bin3_convert_sample (GstPlayBin3 * playbin,
     GstCaps * caps);
 
 static GstStateChangeReturn setup_next_source (GstPlayBin3 * playbin);
+static gboolean gst_play_bin3_switch_uri (GstPlayBin3 * playbin,
+    const gchar * uri);
+static void standby_refill (GstPlayBin3 * playbin);
+static void standby_clear (GstPlayBin3 * playbin);
 
 static void gst_play_bin3_check_group_status (GstPlayBin3 * playbin);
 static void emit_about_to_finish (GstPlayBin3 * playbin);
@@ -973,6 +999,34 @@ gst_play_bin3_class_init (GstPlayBin3Class * klass)
           GST_TYPE_VIDEO_MULTIVIEW_FLAGS, GST_VIDEO_MULTIVIEW_FLAGS_NONE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstPlayBin3:standby-uris:
+   *
+   * URIs that are likely to be played next. For each of them playbin keeps
+   * an idle source and decoder bin in the READY state so that
+   * #GstPlayBin3::switch-uri to one of them does not need to create it.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_klass, PROP_STANDBY_URIS,
+      g_param_spec_boxed ("standby-uris", "Standby URIs",
+          "URIs to keep ready for switching to them",
+          G_TYPE_STRV, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstPlayBin3:standby-stats:
+   *
+   * The number of idle source and decoder bins that were prepared for
+   * #GstPlayBin3:standby-uris ("prepared") and the number of them that were
+   * used to play their uri ("used").
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_klass, PROP_STANDBY_STATS,
+      g_param_spec_boxed ("standby-stats", "Standby statistics",
+          "Statistics about the bins kept ready for the standby URIs",
+          GST_TYPE_STRUCTURE, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstPlayBin3::about-to-finish
    * @playbin: a #GstPlayBin3
@@ -1050,7 +1104,32 @@ gst_play_bin3_class_init (GstPlayBin3Class * klass)
       G_STRUCT_OFFSET (GstPlayBin3Class, convert_sample), NULL, NULL,
       g_cclosure_marshal_generic, GST_TYPE_SAMPLE, 1, GST_TYPE_CAPS);
 
+  /**
+   * GstPlayBin3::switch-uri
+   * @playbin: a #GstPlayBin3
+   * @uri: the uri to switch to
+   *
+   * Action signal to replace the currently playing uri with @uri right away.
+   * The current source and decoder bins are shut down and the sinks are
+   * flushed, but the sinks stay in their current state, which makes this a
+   * lot faster than going through the READY state. A bin kept ready for
+   * @uri because of #GstPlayBin3:standby-uris is used if there is one.
+   *
+   * If playbin is not PAUSED or PLAYING this is the same as setting the
+   * #GstPlayBin3:uri property.
+   *
+   * Returns: %TRUE if playback of @uri was started
+   *
+   * Since: 1.18
+   */
+  gst_play_bin3_signals[SIGNAL_SWITCH_URI] =
+      g_signal_new ("switch-uri", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION,
+      G_STRUCT_OFFSET (GstPlayBin3Class, switch_uri), NULL, NULL,
+      g_cclosure_marshal_generic, G_TYPE_BOOLEAN, 1, G_TYPE_STRING);
+
   klass->convert_sample = gst_play_bin3_convert_sample;
+  klass->switch_uri = gst_play_bin3_switch_uri;
 
   gst_element_class_set_static_metadata (gstelement_klass,
       "Player Bin 3", "Generic/Bin/Player",
@@ -1434,6 +1513,9 @@ gst_play_bin3_finalize (GObject * object)
   if (playbin->velements)
     g_sequence_free (playbin->velements);
 
+  standby_clear (playbin);
+  g_strfreev (playbin->standby_uris);
+
   g_rec_mutex_clear (&playbin->activation_lock);
   g_rec_mutex_clear (&playbin->lock);
   g_mutex_clear (&playbin->dyn_lock);
@@ -1864,6 +1946,13 @@ gst_play_bin3_set_property (GObject * object, guint prop_id,
       playbin->multiview_flags = g_value_get_flags (value);
       GST_PLAY_BIN3_UNLOCK (playbin);
       break;
+    case PROP_STANDBY_URIS:
+      GST_PLAY_BIN3_LOCK (playbin);
+      g_strfreev (playbin->standby_uris);
+      playbin->standby_uris = g_value_dup_boxed (value);
+      standby_refill (playbin);
+      GST_PLAY_BIN3_UNLOCK (playbin);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2066,6 +2155,19 @@ gst_play_bin3_get_property (GObject * object, guint prop_id, GValue * value,
       g_value_set_flags (value, playbin->multiview_flags);
       GST_OBJECT_UNLOCK (playbin);
       break;
+    case PROP_STANDBY_URIS:
+      GST_PLAY_BIN3_LOCK (playbin);
+      g_value_set_boxed (value, playbin->standby_uris);
+      GST_PLAY_BIN3_UNLOCK (playbin);
+      break;
+    case PROP_STANDBY_STATS:
+      GST_PLAY_BIN3_LOCK (playbin);
+      g_value_take_boxed (value,
+          gst_structure_new ("application/x-standby-stats",
+              "prepared", G_TYPE_UINT64, playbin->standby_prepared,
+              "used", G_TYPE_UINT64, playbin->standby_used, NULL));
+      GST_PLAY_BIN3_UNLOCK (playbin);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -4419,6 +4521,208 @@ source_setup_cb (GstElement * element, GstElement * source,
       source);
 }
 
+static void
+standby_entry_free (GstStandbyEntry * entry)
+{
+  gst_element_set_state (entry->uridecodebin, GST_STATE_NULL);
+  gst_object_unref (entry->uridecodebin);
+  g_free (entry->uri);
+  g_slice_free (GstStandbyEntry, entry);
+}
+
+/* must be called with PLAY_BIN_LOCK */
+static void
+standby_clear (GstPlayBin3 * playbin)
+{
+  g_list_free_full (playbin->standby, (GDestroyNotify) standby_entry_free);
+  playbin->standby = NULL;
+}
+
+/* must be called with PLAY_BIN_LOCK. Returns the standby uridecodebin3 for
+ * @uri and removes it from the pool */
+static GstElement *
+standby_take (GstPlayBin3 * playbin, const gchar * uri)
+{
+  GstElement *uridecodebin = NULL;
+  GList *l;
+
+  if (uri == NULL)
+    return NULL;
+
+  for (l = playbin->standby; l; l = l->next) {
+    GstStandbyEntry *entry = l->data;
+
+    if (strcmp (entry->uri, uri) == 0) {
+      GST_DEBUG_OBJECT (playbin, "using standby uridecodebin3 for %s", uri);
+      playbin->standby_used++;
+      uridecodebin = entry->uridecodebin;
+      g_free (entry->uri);
+      g_slice_free (GstStandbyEntry, entry);
+      playbin->standby = g_list_delete_link (playbin->standby, l);
+      break;
+    }
+  }
+
+  return uridecodebin;
+}
+
+/* must be called with PLAY_BIN_LOCK. Makes the pool match the standby-uris,
+ * the uris of the active groups don't need a standby bin */
+static void
+standby_refill (GstPlayBin3 * playbin)
+{
+  const gchar *curr_uri = NULL, *next_uri = NULL;
+  GList *l, *next;
+  guint i;
+
+  if (playbin->curr_group && playbin->curr_group->active)
+    curr_uri = playbin->curr_group->uri;
+  if (playbin->next_group && playbin->next_group->active)
+    next_uri = playbin->next_group->uri;
+
+  /* drop the ones we don't need anymore */
+  for (l = playbin->standby; l; l = next) {
+    GstStandbyEntry *entry = l->data;
+
+    next = l->next;
+    if (playbin->standby_uris == NULL
+        || !g_strv_contains ((const gchar * const *) playbin->standby_uris,
+            entry->uri) || g_strcmp0 (entry->uri, curr_uri) == 0
+        || g_strcmp0 (entry->uri, next_uri) == 0) {
+      standby_entry_free (entry);
+      playbin->standby = g_list_delete_link (playbin->standby, l);
+    }
+  }
+
+  /* playbin is not used yet or not anymore */
+  if (GST_STATE_TARGET (playbin) == GST_STATE_NULL)
+    return;
+
+  for (i = 0; playbin->standby_uris && playbin->standby_uris[i]; i++) {
+    const gchar *uri = playbin->standby_uris[i];
+    GstStandbyEntry *entry;
+    GstElement *uridecodebin;
+
+    if (g_strcmp0 (uri, curr_uri) == 0 || g_strcmp0 (uri, next_uri) == 0)
+      continue;
+    for (l = playbin->standby; l; l = l->next) {
+      if (strcmp (((GstStandbyEntry *) l->data)->uri, uri) == 0)
+        break;
+    }
+    if (l)
+      continue;
+
+    uridecodebin = gst_element_factory_make ("uridecodebin3", NULL);
+    if (!uridecodebin)
+      return;
+
+    GST_DEBUG_OBJECT (playbin, "preparing standby uridecodebin3 for %s", uri);
+    gst_object_ref_sink (uridecodebin);
+    g_object_set (uridecodebin, "uri", uri, NULL);
+    if (gst_element_set_state (uridecodebin,
+            GST_STATE_READY) == GST_STATE_CHANGE_FAILURE) {
+      GST_WARNING_OBJECT (playbin, "standby uridecodebin3 for %s failed", uri);
+      gst_element_set_state (uridecodebin, GST_STATE_NULL);
+      gst_object_unref (uridecodebin);
+      continue;
+    }
+
+    entry = g_slice_new (GstStandbyEntry);
+    entry->uri = g_strdup (uri);
+    entry->uridecodebin = uridecodebin;
+    playbin->standby = g_list_append (playbin->standby, entry);
+    playbin->standby_prepared++;
+  }
+}
+
+static void
+flush_playsink_pad (const GValue * item, gpointer user_data)
+{
+  GstPad *pad = g_value_get_object (item);
+  GstEvent *event = user_data;
+
+  gst_pad_send_event (pad, gst_event_ref (event));
+}
+
+/* sends @event to all inputs of playsink */
+static void
+flush_playsink (GstPlayBin3 * playbin, GstEvent * event)
+{
+  GstIterator *it;
+
+  it = gst_element_iterate_sink_pads (GST_ELEMENT_CAST (playbin->playsink));
+  while (gst_iterator_foreach (it, flush_playsink_pad,
+          event) == GST_ITERATOR_RESYNC)
+    gst_iterator_resync (it);
+  gst_iterator_free (it);
+  gst_event_unref (event);
+}
+
+static GstStateChangeReturn activate_group (GstPlayBin3 * playbin,
+    GstSourceGroup * group);
+static gboolean deactivate_group (GstPlayBin3 * playbin,
+    GstSourceGroup * group);
+
+static gboolean
+gst_play_bin3_switch_uri (GstPlayBin3 * playbin, const gchar * uri)
+{
+  GstSourceGroup *old_group, *new_group;
+
+  if (uri == NULL) {
+    g_warning ("cannot switch to NULL uri");
+    return FALSE;
+  }
+
+  GST_STATE_LOCK (playbin);
+  if (GST_STATE (playbin) < GST_STATE_PAUSED) {
+    /* nothing is playing, the uri will be used on the next start */
+    gst_play_bin3_set_uri (playbin, uri);
+    GST_STATE_UNLOCK (playbin);
+    return TRUE;
+  }
+
+  GST_DEBUG_OBJECT (playbin, "switching to %s", uri);
+
+  GST_PLAY_BIN3_LOCK (playbin);
+  old_group = playbin->curr_group;
+  new_group = playbin->next_group;
+
+  /* replace what was prepared for gapless playback */
+  if (new_group->active)
+    deactivate_group (playbin, new_group);
+  gst_play_bin3_set_uri (playbin, uri);
+
+  /* unblock the sinks and shut down the current source, then reset the
+   * running time as the new stream starts from zero again */
+  flush_playsink (playbin, gst_event_new_flush_start ());
+  if (old_group->active && old_group->valid)
+    deactivate_group (playbin, old_group);
+  flush_playsink (playbin, gst_event_new_flush_stop (TRUE));
+
+  /* the new group becomes the current one on its stream-start, the same way
+   * as for gapless playback */
+  if (activate_group (playbin, new_group) == GST_STATE_CHANGE_FAILURE)
+    goto activate_failed;
+  gst_element_sync_state_with_parent (new_group->uridecodebin);
+
+  /* the previous uri might be a standby one */
+  standby_refill (playbin);
+
+  GST_PLAY_BIN3_UNLOCK (playbin);
+  GST_STATE_UNLOCK (playbin);
+
+  return TRUE;
+
+activate_failed:
+  {
+    GST_DEBUG_OBJECT (playbin, "activating %s failed", uri);
+    new_group->valid = FALSE;
+    GST_PLAY_BIN3_UNLOCK (playbin);
+    GST_STATE_UNLOCK (playbin);
+    return FALSE;
+  }
+}
+
 /* must be called with PLAY_BIN_LOCK */
 static GstStateChangeReturn
 activate_group (GstPlayBin3 * playbin, GstSourceGroup * group)
@@ -4490,6 +4794,16 @@ activate_group (GstPlayBin3 * playbin, GstSourceGroup * group)
   }
 
 
+  /* use the idle uridecodebin3 kept ready for this uri if there is one */
+  if ((uridecodebin = standby_take (playbin, group->uri))) {
+    if (group->uridecodebin) {
+      gst_element_set_state (group->uridecodebin, GST_STATE_NULL);
+      gst_object_unref (group->uridecodebin);
+    }
+    group->uridecodebin = uridecodebin;
+    uridecodebin = NULL;
+  }
+
   if (!make_or_reuse_element (playbin, "uridecodebin3", &group->uridecodebin))
     goto no_uridecodebin;
   uridecodebin = group->uridecodebin;
@@ -4914,6 +5228,11 @@ gst_play_bin3_change_state (GstElement * element, GstStateChange transition)
   playbin = GST_PLAY_BIN3 (element);
 
   switch (transition) {
+    case GST_STATE_CHANGE_NULL_TO_READY:
+      GST_PLAY_BIN3_LOCK (playbin);
+      standby_refill (playbin);
+      GST_PLAY_BIN3_UNLOCK (playbin);
+      break;
     case GST_STATE_CHANGE_READY_TO_PAUSED:
       if (!gst_play_bin3_start (playbin))
         return GST_STATE_CHANGE_FAILURE;
@@ -5000,6 +5319,10 @@ gst_play_bin3_change_state (GstElement * element, GstStateChange transition)
       /* make sure the groups don't perform a state change anymore until we
        * enable them again */
       groups_set_locked_state (playbin, TRUE);
+
+      GST_PLAY_BIN3_LOCK (playbin);
+      standby_clear (playbin);
+      GST_PLAY_BIN3_UNLOCK (playbin);
       break;
     }
     default:
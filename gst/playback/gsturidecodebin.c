@@ -79,10 +79,6 @@ struct _GstURIDecodeBin
 
   GMutex lock;                  /* lock for constructing */
 
-  GMutex factories_lock;
-  guint32 factories_cookie;
-  GList *factories;             /* factories we can use for selecting elements */
-
   gchar *uri;
   guint64 connection_speed;
   GstCaps *caps;
@@ -306,42 +302,20 @@ gst_uri_decode_bin_autoplug_continue (GstElement * element, GstPad * pad,
   return TRUE;
 }
 
-/* Must be called with factories lock! */
-static void
-gst_uri_decode_bin_update_factories_list (GstURIDecodeBin * dec)
-{
-  guint32 cookie;
-
-  cookie = gst_registry_get_feature_list_cookie (gst_registry_get ());
-  if (!dec->factories || dec->factories_cookie != cookie) {
-    if (dec->factories)
-      gst_plugin_feature_list_free (dec->factories);
-    dec->factories =
-        gst_element_factory_list_get_elements
-        (GST_ELEMENT_FACTORY_TYPE_DECODABLE, GST_RANK_MARGINAL);
-    dec->factories =
-        g_list_sort (dec->factories, gst_playback_utils_compare_factories_func);
-    dec->factories_cookie = cookie;
-  }
-}
-
 static GValueArray *
 gst_uri_decode_bin_autoplug_factories (GstElement * element, GstPad * pad,
     GstCaps * caps)
 {
   GList *list, *tmp;
   GValueArray *result;
-  GstURIDecodeBin *dec = GST_URI_DECODE_BIN_CAST (element);
 
   GST_DEBUG_OBJECT (element, "finding factories");
 
-  /* return all compatible factories for caps */
-  g_mutex_lock (&dec->factories_lock);
-  gst_uri_decode_bin_update_factories_list (dec);
+  /* return all compatible factories for caps, the lists and the filter
+   * results are shared with all other autoplugging bins */
   list =
-      gst_element_factory_list_filter (dec->factories, caps, GST_PAD_SINK,
-      gst_caps_is_fixed (caps));
-  g_mutex_unlock (&dec->factories_lock);
+      gst_playback_utils_filter_factories (GST_PLAYBACK_FACTORIES_AUTOPLUG,
+      caps, gst_caps_is_fixed (caps));
 
   result = g_value_array_new (g_list_length (list));
   for (tmp = list; tmp; tmp = tmp->next) {
@@ -705,9 +679,6 @@ gst_uri_decode_bin_class_init (GstURIDecodeBinClass * klass)
 static void
 gst_uri_decode_bin_init (GstURIDecodeBin * dec)
 {
-  /* first filter out the interesting element factories */
-  g_mutex_init (&dec->factories_lock);
-
   g_mutex_init (&dec->lock);
 
   dec->uri = g_strdup (DEFAULT_PROP_URI);
@@ -734,11 +705,8 @@ gst_uri_decode_bin_finalize (GObject * obj)
 
   remove_decoders (dec, TRUE);
   g_mutex_clear (&dec->lock);
-  g_mutex_clear (&dec->factories_lock);
   g_free (dec->uri);
   g_free (dec->encoding);
-  if (dec->factories)
-    gst_plugin_feature_list_free (dec->factories);
   if (dec->caps)
     gst_caps_unref (dec->caps);
 
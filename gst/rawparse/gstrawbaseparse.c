@@ -414,38 +414,44 @@ static GstBuffer *
 gst_raw_base_parse_align_buffer (GstRawBaseParse * raw_base_parse,
     gsize alignment, GstBuffer * buffer, gsize out_size)
 {
+  GstBuffer *new_buffer;
+  GstAllocationParams params = { 0, alignment - 1, 0, 0, };
   GstMapInfo map;
+  guint idx, length;
+  gsize skip;
 
-  gst_buffer_map (buffer, &map, GST_MAP_READ);
-
-  if (map.size < sizeof (guintptr)) {
-    gst_buffer_unmap (buffer, &map);
+  if (gst_buffer_get_size (buffer) < sizeof (guintptr))
     return NULL;
-  }
-
-  if (((guintptr) map.data) & (alignment - 1)) {
-    GstBuffer *new_buffer;
-    GstAllocationParams params = { 0, alignment - 1, 0, 0, };
 
-    new_buffer = gst_buffer_new_allocate (NULL, out_size, &params);
+  /* Only look at the memory the output data is in. Mapping the whole
+   * buffer would merge its memory blocks, which is a copy by itself. */
+  if (gst_buffer_find_memory (buffer, 0, out_size, &idx, &length, &skip)
+      && length == 1) {
+    GstMemory *mem = gst_buffer_peek_memory (buffer, idx);
+    gboolean aligned;
 
-    /* Copy data "by hand", so ensure alignment is kept: */
-    gst_buffer_fill (new_buffer, 0, map.data, out_size);
+    if (!gst_memory_map (mem, &map, GST_MAP_READ))
+      return NULL;
+    aligned = (((guintptr) (map.data + skip)) & (alignment - 1)) == 0;
+    gst_memory_unmap (mem, &map);
 
-    gst_buffer_copy_into (new_buffer, buffer, GST_BUFFER_COPY_METADATA, 0,
-        out_size);
-    GST_DEBUG_OBJECT (raw_base_parse,
-        "We want output aligned on %" G_GSIZE_FORMAT ", reallocated",
-        alignment);
+    if (aligned)
+      return NULL;
+  }
 
-    gst_buffer_unmap (buffer, &map);
+  new_buffer = gst_buffer_new_allocate (NULL, out_size, &params);
 
-    return new_buffer;
-  }
+  /* Copy data "by hand", so ensure alignment is kept: */
+  gst_buffer_map (new_buffer, &map, GST_MAP_WRITE);
+  gst_buffer_extract (buffer, 0, map.data, out_size);
+  gst_buffer_unmap (new_buffer, &map);
 
-  gst_buffer_unmap (buffer, &map);
+  gst_buffer_copy_into (new_buffer, buffer, GST_BUFFER_COPY_METADATA, 0,
+      out_size);
+  GST_DEBUG_OBJECT (raw_base_parse,
+      "We want output aligned on %" G_GSIZE_FORMAT ", reallocated", alignment);
 
-  return NULL;
+  return new_buffer;
 }
 
 static GstFlowReturn
@@ -53,6 +53,14 @@
  * no duration set. The first output buffer will have a PTS 0, all subsequent ones
  * an unset PTS.
  *
+ * Frames with custom plane strides or offsets are output as they are, with a
+ * #GstVideoMeta describing their layout. Elements that do not handle such
+ * layouts then have to fall back to slower code paths. If the repack property
+ * is set to TRUE, these frames are instead copied into buffers from an internal
+ * pool that use the default strides and offsets of the video format. Frames
+ * that already use the default layout, and that start on a sufficiently
+ * aligned address in the input buffer, are output without copying.
+ *
  * ## Example pipelines
  * |[
  * gst-launch-1.0 filesrc location=video.raw ! rawvideoparse use-sink-caps=false \
@@ -93,7 +101,8 @@ enum
   PROP_TOP_FIELD_FIRST,
   PROP_PLANE_STRIDES,
   PROP_PLANE_OFFSETS,
-  PROP_FRAME_SIZE
+  PROP_FRAME_SIZE,
+  PROP_REPACK
 };
 
 #define DEFAULT_WIDTH                 320
@@ -106,6 +115,10 @@ enum
 #define DEFAULT_INTERLACED            FALSE
 #define DEFAULT_TOP_FIELD_FIRST       FALSE
 #define DEFAULT_FRAME_STRIDE          0
+#define DEFAULT_REPACK                FALSE
+
+/* Alignment of the frames output by the parser, minus one */
+#define OUTPUT_ALIGN_MASK             31
 
 #define GST_RAW_VIDEO_PARSE_CAPS \
         GST_VIDEO_CAPS_MAKE(GST_VIDEO_FORMATS_ALL) "; "
@@ -168,6 +181,8 @@ static GstRawVideoParseConfig
 
 static void gst_raw_video_parse_init_config (GstRawVideoParseConfig * config);
 static void gst_raw_video_parse_update_info (GstRawVideoParseConfig * config);
+static void gst_raw_video_parse_get_default_info (GstRawVideoParseConfig *
+    config, GstVideoInfo * info);
 
 static void
 gst_raw_video_parse_class_init (GstRawVideoParseClass * klass)
@@ -309,6 +324,22 @@ gst_raw_video_parse_class_init (GstRawVideoParseClass * klass)
           0, G_MAXUINT,
           DEFAULT_FRAME_STRIDE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
       );
+  /**
+   * GstRawVideoParse:repack:
+   *
+   * Copy frames with custom plane strides or offsets into buffers with the
+   * default layout of the video format, instead of describing their layout
+   * with a #GstVideoMeta.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (object_class,
+      PROP_REPACK,
+      g_param_spec_boolean ("repack",
+          "Repack",
+          "Copy frames with custom plane strides or offsets into buffers with the default layout",
+          DEFAULT_REPACK, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+      );
 
   gst_element_class_set_static_metadata (element_class,
       "rawvideoparse",
@@ -332,6 +363,9 @@ gst_raw_video_parse_init (GstRawVideoParse * raw_video_parse)
   raw_video_parse->properties_config.ready = TRUE;
   raw_video_parse->properties_config.top_field_first = DEFAULT_TOP_FIELD_FIRST;
   raw_video_parse->properties_config.frame_size = DEFAULT_FRAME_STRIDE;
+
+  raw_video_parse->repack = DEFAULT_REPACK;
+  raw_video_parse->pool = NULL;
 }
 
 static void
@@ -611,6 +645,17 @@ gst_raw_video_parse_set_property (GObject * object, guint prop_id,
       break;
     }
 
+    case PROP_REPACK:
+    {
+      /* Repacking does not change the caps nor the input frame size,
+       * it only affects how the frames are output in process() */
+
+      GST_RAW_BASE_PARSE_CONFIG_MUTEX_LOCK (object);
+      raw_video_parse->repack = g_value_get_boolean (value);
+      GST_RAW_BASE_PARSE_CONFIG_MUTEX_UNLOCK (object);
+      break;
+    }
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -722,6 +767,12 @@ gst_raw_video_parse_get_property (GObject * object, guint prop_id,
       GST_RAW_BASE_PARSE_CONFIG_MUTEX_UNLOCK (object);
       break;
 
+    case PROP_REPACK:
+      GST_RAW_BASE_PARSE_CONFIG_MUTEX_LOCK (object);
+      g_value_set_boolean (value, raw_video_parse->repack);
+      GST_RAW_BASE_PARSE_CONFIG_MUTEX_UNLOCK (object);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -740,6 +791,12 @@ gst_raw_video_parse_stop (GstBaseParse * parse)
    * its ready status is always TRUE.) */
   raw_video_parse->sink_caps_config.ready = FALSE;
 
+  if (raw_video_parse->pool) {
+    gst_buffer_pool_set_active (raw_video_parse->pool, FALSE);
+    gst_object_unref (raw_video_parse->pool);
+    raw_video_parse->pool = NULL;
+  }
+
   return GST_BASE_PARSE_CLASS (parent_class)->stop (parse);
 }
 
@@ -879,37 +936,216 @@ gst_raw_video_parse_is_config_ready (GstRawBaseParse * raw_base_parse,
   return gst_raw_video_parse_get_config_ptr (raw_video_parse, config)->ready;
 }
 
+static gboolean
+gst_raw_video_parse_needs_repack (GstRawVideoParse * raw_video_parse,
+    GstRawVideoParseConfig * config_ptr, GstVideoInfo * default_info)
+{
+  guint i;
+
+  if (!raw_video_parse->repack)
+    return FALSE;
+
+  gst_raw_video_parse_get_default_info (config_ptr, default_info);
+
+  for (i = 0; i < GST_VIDEO_INFO_N_PLANES (default_info); ++i) {
+    if (GST_VIDEO_INFO_PLANE_OFFSET (default_info, i) !=
+        config_ptr->plane_offsets[i]
+        || GST_VIDEO_INFO_PLANE_STRIDE (default_info, i) !=
+        config_ptr->plane_strides[i])
+      return TRUE;
+  }
+
+  return FALSE;
+}
+
+static GstBuffer *
+gst_raw_video_parse_acquire_buffer (GstRawVideoParse * raw_video_parse,
+    GstVideoInfo * info)
+{
+  GstBuffer *buffer = NULL;
+
+  if (raw_video_parse->pool
+      && !gst_video_info_is_equal (&(raw_video_parse->pool_info), info)) {
+    gst_buffer_pool_set_active (raw_video_parse->pool, FALSE);
+    gst_object_unref (raw_video_parse->pool);
+    raw_video_parse->pool = NULL;
+  }
+
+  if (raw_video_parse->pool == NULL) {
+    GstAllocationParams alloc_params = { 0, OUTPUT_ALIGN_MASK, 0, 0 };
+    GstBufferPool *pool;
+    GstStructure *config;
+    GstCaps *caps;
+
+    GST_DEBUG_OBJECT (raw_video_parse, "creating pool for repacked frames");
+
+    pool = gst_video_buffer_pool_new ();
+    config = gst_buffer_pool_get_config (pool);
+    caps = gst_video_info_to_caps (info);
+    gst_buffer_pool_config_set_params (config, caps,
+        GST_VIDEO_INFO_SIZE (info), 0, 0);
+    gst_buffer_pool_config_set_allocator (config, NULL, &alloc_params);
+    gst_caps_unref (caps);
+
+    if (!gst_buffer_pool_set_config (pool, config)
+        || !gst_buffer_pool_set_active (pool, TRUE)) {
+      GST_WARNING_OBJECT (raw_video_parse, "could not configure buffer pool");
+      gst_object_unref (pool);
+      return NULL;
+    }
+
+    raw_video_parse->pool = pool;
+    raw_video_parse->pool_info = *info;
+  }
+
+  if (gst_buffer_pool_acquire_buffer (raw_video_parse->pool, &buffer,
+          NULL) != GST_FLOW_OK)
+    return NULL;
+
+  return buffer;
+}
+
+/* Copies the planes of src into dest, which has the same format and size
+ * but possibly different strides and offsets. Planes with equal strides are
+ * copied in one go instead of line by line. */
+static void
+gst_raw_video_parse_copy_planes (GstVideoFrame * dest, GstVideoFrame * src)
+{
+  const GstVideoFormatInfo *finfo = src->info.finfo;
+  guint i;
+
+  for (i = 0; i < GST_VIDEO_FRAME_N_PLANES (src); ++i) {
+    gint stride = GST_VIDEO_FRAME_PLANE_STRIDE (src, i);
+
+    if (!GST_VIDEO_FORMAT_INFO_IS_TILED (finfo)
+        && stride == GST_VIDEO_FRAME_PLANE_STRIDE (dest, i)) {
+      memcpy (GST_VIDEO_FRAME_PLANE_DATA (dest, i),
+          GST_VIDEO_FRAME_PLANE_DATA (src, i),
+          (gsize) stride * GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (finfo, i,
+              GST_VIDEO_FRAME_HEIGHT (src)));
+    } else {
+      gst_video_frame_copy_plane (dest, src, i);
+    }
+  }
+}
+
+static GstBuffer *
+gst_raw_video_parse_repack (GstRawVideoParse * raw_video_parse,
+    GstRawVideoParseConfig * config_ptr, GstVideoInfo * default_info,
+    GstBuffer * in_data)
+{
+  GstVideoFrame in_frame, out_frame;
+  GstBuffer *out_data;
+
+  out_data = gst_raw_video_parse_acquire_buffer (raw_video_parse,
+      default_info);
+  if (out_data == NULL)
+    return NULL;
+
+  if (!gst_video_frame_map (&in_frame, &(config_ptr->info), in_data,
+          GST_MAP_READ)) {
+    GST_WARNING_OBJECT (raw_video_parse, "Failed to map input frame");
+    gst_buffer_unref (out_data);
+    return NULL;
+  }
+
+  if (!gst_video_frame_map (&out_frame, default_info, out_data,
+          GST_MAP_WRITE)) {
+    GST_WARNING_OBJECT (raw_video_parse, "Failed to map output frame");
+    gst_video_frame_unmap (&in_frame);
+    gst_buffer_unref (out_data);
+    return NULL;
+  }
+
+  gst_raw_video_parse_copy_planes (&out_frame, &in_frame);
+
+  gst_video_frame_unmap (&out_frame);
+  gst_video_frame_unmap (&in_frame);
+
+  return out_data;
+}
+
+/* Returns TRUE if the first size bytes of buffer are in one memory block,
+ * and start on an address aligned to OUTPUT_ALIGN_MASK + 1 */
+static gboolean
+gst_raw_video_parse_is_aligned (GstBuffer * buffer, gsize size)
+{
+  GstMemory *mem;
+  GstMapInfo map;
+  guint idx, length;
+  gsize skip;
+  gboolean aligned;
+
+  if (!gst_buffer_find_memory (buffer, 0, size, &idx, &length, &skip)
+      || length != 1)
+    return FALSE;
+
+  mem = gst_buffer_peek_memory (buffer, idx);
+  if (!gst_memory_map (mem, &map, GST_MAP_READ))
+    return FALSE;
+
+  aligned = (((guintptr) (map.data + skip)) & OUTPUT_ALIGN_MASK) == 0;
+  gst_memory_unmap (mem, &map);
+
+  return aligned;
+}
+
 static gboolean
 gst_raw_video_parse_process (GstRawBaseParse * raw_base_parse,
     GstRawBaseParseConfig config, GstBuffer * in_data,
     G_GNUC_UNUSED gsize total_num_in_bytes,
     G_GNUC_UNUSED gsize num_valid_in_bytes, GstBuffer ** processed_data)
 {
-  GstAllocationParams alloc_params = { 0, 31, 0, 0 };
-  GstMapInfo map_info;
   GstRawVideoParse *raw_video_parse = GST_RAW_VIDEO_PARSE (raw_base_parse);
   GstRawVideoParseConfig *config_ptr =
       gst_raw_video_parse_get_config_ptr (raw_video_parse, config);
   guint frame_flags = 0;
   GstVideoInfo *video_info = &(config_ptr->info);
+  GstVideoInfo default_info;
+  gsize size = GST_VIDEO_INFO_SIZE (video_info);
+  gboolean repacked = FALSE;
   GstBuffer *out_data;
 
-  if (!gst_buffer_map (in_data, &map_info, GST_MAP_READ)) {
-    GST_WARNING_OBJECT (raw_video_parse, "Failed to map input data");
-    return FALSE;
-  }
+  if (gst_raw_video_parse_needs_repack (raw_video_parse, config_ptr,
+          &default_info)) {
+    /* Copy the planes into a buffer with the default layout */
+    out_data = gst_raw_video_parse_repack (raw_video_parse, config_ptr,
+        &default_info, in_data);
+    if (out_data == NULL)
+      return FALSE;
 
-  /* Allocate the output memory our required alignment */
-  *processed_data = out_data = gst_buffer_new_allocate (NULL,
-      GST_VIDEO_INFO_SIZE (video_info), &alloc_params);
-  gst_buffer_fill (*processed_data, 0, map_info.data,
-      GST_VIDEO_INFO_SIZE (video_info));
-  gst_buffer_unmap (in_data, &map_info);
+    gst_buffer_copy_into (out_data, in_data,
+        GST_BUFFER_COPY_FLAGS | GST_BUFFER_COPY_TIMESTAMPS, 0, size);
+    repacked = TRUE;
+  } else if (gst_raw_video_parse_is_aligned (in_data, size)) {
+    /* The frame is contiguous and suitably aligned already, so output
+     * it without copying */
+    GST_LOG_OBJECT (raw_video_parse, "frame is aligned, not copying");
+    out_data = gst_buffer_copy_region (in_data,
+        GST_BUFFER_COPY_FLAGS | GST_BUFFER_COPY_TIMESTAMPS |
+        GST_BUFFER_COPY_MEMORY, 0, size);
+  } else {
+    GstAllocationParams alloc_params = { 0, OUTPUT_ALIGN_MASK, 0, 0 };
+    GstMapInfo map_info;
+
+    /* Allocate the output memory our required alignment */
+    out_data = gst_buffer_new_allocate (NULL, size, &alloc_params);
+    if (!gst_buffer_map (out_data, &map_info, GST_MAP_WRITE)) {
+      GST_WARNING_OBJECT (raw_video_parse, "Failed to map output data");
+      gst_buffer_unref (out_data);
+      return FALSE;
+    }
+    /* Extract instead of mapping the input, which would merge its
+     * memory blocks first if the frame is spread over several */
+    gst_buffer_extract (in_data, 0, map_info.data, size);
+    gst_buffer_unmap (out_data, &map_info);
+
+    /* And copy the metadata */
+    gst_buffer_copy_into (out_data, in_data,
+        GST_BUFFER_COPY_FLAGS | GST_BUFFER_COPY_TIMESTAMPS, 0, size);
+  }
 
-  /* And copy the metadata */
-  gst_buffer_copy_into (*processed_data, in_data,
-      GST_BUFFER_COPY_FLAGS | GST_BUFFER_COPY_TIMESTAMPS, 0,
-      GST_VIDEO_INFO_SIZE (video_info));
+  *processed_data = out_data;
 
   if (config_ptr->interlaced) {
     GST_BUFFER_FLAG_SET (out_data, GST_VIDEO_BUFFER_FLAG_INTERLACED);
@@ -922,14 +1158,17 @@ gst_raw_video_parse_process (GstRawBaseParse * raw_base_parse,
       GST_BUFFER_FLAG_UNSET (out_data, GST_VIDEO_BUFFER_FLAG_TFF);
   }
 
-  gst_buffer_add_video_meta_full (out_data,
-      frame_flags,
-      config_ptr->format,
-      config_ptr->width,
-      config_ptr->height,
-      GST_VIDEO_INFO_N_PLANES (video_info),
-      config_ptr->plane_offsets, config_ptr->plane_strides);
-
+  /* Repacked frames use the default layout, which downstream can
+   * derive from the caps */
+  if (!repacked) {
+    gst_buffer_add_video_meta_full (out_data,
+        frame_flags,
+        config_ptr->format,
+        config_ptr->width,
+        config_ptr->height,
+        GST_VIDEO_INFO_N_PLANES (video_info),
+        config_ptr->plane_offsets, config_ptr->plane_strides);
+  }
 
   return TRUE;
 }
@@ -1134,3 +1373,20 @@ gst_raw_video_parse_update_info (GstRawVideoParseConfig * config)
       last_plane, last_plane_offset, last_plane_size,
       GST_VIDEO_INFO_SIZE (info));
 }
+
+static void
+gst_raw_video_parse_get_default_info (GstRawVideoParseConfig * config,
+    GstVideoInfo * info)
+{
+  /* Same as the config's video info, but with the plane strides and
+   * offsets computed by gst_video_info_set_format() */
+  gst_video_info_set_format (info, config->format, config->width,
+      config->height);
+
+  GST_VIDEO_INFO_PAR_N (info) = GST_VIDEO_INFO_PAR_N (&(config->info));
+  GST_VIDEO_INFO_PAR_D (info) = GST_VIDEO_INFO_PAR_D (&(config->info));
+  GST_VIDEO_INFO_FPS_N (info) = GST_VIDEO_INFO_FPS_N (&(config->info));
+  GST_VIDEO_INFO_FPS_D (info) = GST_VIDEO_INFO_FPS_D (&(config->info));
+  GST_VIDEO_INFO_INTERLACE_MODE (info) =
+      GST_VIDEO_INFO_INTERLACE_MODE (&(config->info));
+}
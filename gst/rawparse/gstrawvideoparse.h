@@ -98,6 +98,14 @@ struct _GstRawVideoParse
   /* Currently active configuration. Points either to properties_config
    * or to sink_caps_config. This is never NULL. */
   GstRawVideoParseConfig *current_config;
+
+  /* If TRUE, frames with custom plane strides or offsets are copied
+   * into buffers with the default layout */
+  gboolean repack;
+  /* Pool the repacked frames are allocated from, and the default
+   * layout it was configured for */
+  GstBufferPool *pool;
+  GstVideoInfo pool_info;
 };
 
 struct _GstRawVideoParseClass
@@ -41,11 +41,16 @@
 GST_DEBUG_CATEGORY (sub_parse_debug);
 
 #define DEFAULT_ENCODING   NULL
-#define ATTRIBUTE_REGEX "\\s?[a-zA-Z0-9\\. \t\\(\\)]*"
 static const gchar *allowed_srt_tags[] = { "i", "b", "u", NULL };
 static const gchar *allowed_vtt_tags[] =
     { "i", "b", "c", "u", "v", "ruby", "rt", NULL };
 
+typedef struct
+{
+  guint64 offset;
+  GstClockTime max_end;
+} GstSubParseIndexEntry;
+
 enum
 {
   PROP_0,
@@ -90,6 +95,10 @@ static GstStateChangeReturn gst_sub_parse_change_state (GstElement * element,
 static GstFlowReturn gst_sub_parse_chain (GstPad * sinkpad, GstObject * parent,
     GstBuffer * buf);
 
+static gboolean gst_sub_parse_format_has_index (GstSubParseFormat format);
+static guint64 gst_sub_parse_index_lookup (GstSubParse * self,
+    GstClockTime position);
+
 #define gst_sub_parse_parent_class parent_class
 G_DEFINE_TYPE (GstSubParse, gst_sub_parse, GST_TYPE_ELEMENT);
 
@@ -120,6 +129,11 @@ gst_sub_parse_dispose (GObject * object)
     subparse->textbuf = NULL;
   }
 
+  if (subparse->index) {
+    g_array_free (subparse->index, TRUE);
+    subparse->index = NULL;
+  }
+
   GST_CALL_PARENT (G_OBJECT_CLASS, dispose, (object));
 }
 
@@ -178,6 +192,7 @@ gst_sub_parse_init (GstSubParse * subparse)
   gst_element_add_pad (GST_ELEMENT (subparse), subparse->srcpad);
 
   subparse->textbuf = g_string_new (NULL);
+  subparse->index = g_array_new (FALSE, FALSE, sizeof (GstSubParseIndexEntry));
   subparse->parser_type = GST_SUB_PARSE_FORMAT_UNKNOWN;
   subparse->flushing = FALSE;
   gst_segment_init (&subparse->segment, GST_FORMAT_TIME);
@@ -260,6 +275,7 @@ gst_sub_parse_src_event (GstPad * pad, GstObject * parent, GstEvent * event)
       gint64 start, stop;
       gdouble rate;
       gboolean update;
+      guint64 offset = 0;
 
       gst_event_parse_seek (event, &rate, &format, &flags,
           &start_type, &start, &stop_type, &stop);
@@ -270,11 +286,20 @@ gst_sub_parse_src_event (GstPad * pad, GstObject * parent, GstEvent * event)
         goto beach;
       }
 
-      /* Convert that seek to a seeking in bytes at position 0,
-         FIXME: could use an index */
+      /* Convert that seek to a seeking in bytes, either at position 0 or
+       * at the last indexed cue boundary before the requested position */
+      GST_OBJECT_LOCK (self);
+      if (start_type == GST_SEEK_TYPE_SET && start >= 0 && rate > 0.0 &&
+          self->index_valid &&
+          gst_sub_parse_format_has_index (self->parser_type))
+        offset = gst_sub_parse_index_lookup (self, start);
+      GST_OBJECT_UNLOCK (self);
+
+      GST_DEBUG_OBJECT (self, "seeking to %" G_GUINT64_FORMAT " bytes", offset);
+
       ret = gst_pad_push_event (self->sinkpad,
           gst_event_new_seek (rate, GST_FORMAT_BYTES, flags,
-              GST_SEEK_TYPE_SET, 0, GST_SEEK_TYPE_NONE, 0));
+              GST_SEEK_TYPE_SET, offset, GST_SEEK_TYPE_NONE, 0));
 
       if (ret) {
         /* Apply the seek to our segment */
@@ -288,7 +313,8 @@ gst_sub_parse_src_event (GstPad * pad, GstObject * parent, GstEvent * event)
          * after FLUSH and all that has happened,
          * rather than racing with chain */
       } else {
-        GST_WARNING_OBJECT (self, "seek to 0 bytes failed");
+        GST_WARNING_OBJECT (self, "seek to %" G_GUINT64_FORMAT " bytes failed",
+            offset);
       }
 
       gst_event_unref (event);
@@ -505,34 +531,122 @@ convert_encoding (GstSubParse * self, const gchar * str, gsize len,
   return ret;
 }
 
+/* returns the next complete line from textbuf, NUL-terminated in place. The
+ * line stays valid until textbuf is compacted or appended to */
 static gchar *
 get_next_line (GstSubParse * self)
 {
-  char *line = NULL;
-  const char *line_end;
-  int line_len;
-  gboolean have_r = FALSE;
+  gchar *line, *line_end;
 
-  line_end = strchr (self->textbuf->str, '\n');
+  line = self->textbuf->str + self->textbuf_pos;
+  line_end = strchr (line, '\n');
 
   if (!line_end) {
     /* end-of-line not found; return for more data */
     return NULL;
   }
 
+  self->textbuf_pos += line_end - line + 1;
+
   /* get rid of '\r' */
-  if (line_end != self->textbuf->str && *(line_end - 1) == '\r') {
+  if (line_end != line && *(line_end - 1) == '\r')
     line_end--;
-    have_r = TRUE;
-  }
 
-  line_len = line_end - self->textbuf->str;
-  line = g_strndup (self->textbuf->str, line_len);
-  self->textbuf = g_string_erase (self->textbuf, 0,
-      line_len + (have_r ? 2 : 1));
+  *line_end = '\0';
   return line;
 }
 
+/* drops the lines that were already parsed from textbuf */
+static void
+compact_textbuf (GstSubParse * self)
+{
+  if (self->textbuf_pos == 0)
+    return;
+
+  g_string_erase (self->textbuf, 0, self->textbuf_pos);
+  self->textbuf_offset += self->textbuf_pos;
+  self->textbuf_pos = 0;
+}
+
+static gboolean
+gst_sub_parse_format_has_index (GstSubParseFormat format)
+{
+  return format == GST_SUB_PARSE_FORMAT_SUBRIP ||
+      format == GST_SUB_PARSE_FORMAT_VTT ||
+      format == GST_SUB_PARSE_FORMAT_SUBVIEWER;
+}
+
+/* Remember that parsing can restart at input @offset, with all cues before
+ * it ending at or before @max_end. Must be called with increasing offsets
+ * and the object lock taken. */
+static void
+gst_sub_parse_index_add (GstSubParse * self, guint64 offset,
+    GstClockTime max_end)
+{
+  GstSubParseIndexEntry entry = { offset, max_end };
+  GstSubParseIndexEntry *last;
+
+  if (self->index->len > 0) {
+    last = &g_array_index (self->index, GstSubParseIndexEntry,
+        self->index->len - 1);
+    if (offset <= last->offset)
+      return;
+
+    /* no cue ended in between, the later offset is the better one */
+    if (max_end == last->max_end) {
+      last->offset = offset;
+      return;
+    }
+  }
+
+  g_array_append_val (self->index, entry);
+}
+
+/* Finds the offset to restart parsing at for showing all cues from
+ * @position on. Must be called with the object lock taken. */
+static guint64
+gst_sub_parse_index_lookup (GstSubParse * self, GstClockTime position)
+{
+  GstSubParseIndexEntry *entries = (GstSubParseIndexEntry *) self->index->data;
+  guint lo = 0, hi = self->index->len;
+
+  /* the max_end values are sorted too, find the last one <= position */
+  while (lo < hi) {
+    guint mid = lo + (hi - lo) / 2;
+
+    if (entries[mid].max_end <= position)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  return lo > 0 ? entries[lo - 1].offset : 0;
+}
+
+/* Returns the highest end time of the cues before input @offset, if known */
+static GstClockTime
+gst_sub_parse_index_get_max_end (GstSubParse * self, guint64 offset)
+{
+  GstSubParseIndexEntry *entries = (GstSubParseIndexEntry *) self->index->data;
+  guint lo = 0, hi = self->index->len;
+
+  if (offset == 0)
+    return 0;
+
+  while (lo < hi) {
+    guint mid = lo + (hi - lo) / 2;
+
+    if (entries[mid].offset == offset)
+      return entries[mid].max_end;
+    else if (entries[mid].offset < offset)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  return GST_CLOCK_TIME_NONE;
+}
+
 static gchar *
 parse_mdvdsub (ParserState * state, const gchar * line)
 {
@@ -667,6 +781,40 @@ strip_trailing_newlines (gchar * txt)
   }
 }
 
+/* checks if @str starts with one of @allowed_tags, followed by optional
+ * attributes and @end_marker. Returns the matching tag and the length of
+ * its attributes, or NULL if there is no match */
+static const gchar *
+subrip_match_tag (const gchar * str, const gchar ** allowed_tags,
+    const gchar * end_marker, gsize * attr_len)
+{
+  gsize end_len = strlen (end_marker);
+
+  for (; *allowed_tags != NULL; allowed_tags++) {
+    const gchar *tag = *allowed_tags;
+    gsize tag_len = strlen (tag);
+    const gchar *p;
+
+    if (strncmp (str, tag, tag_len) != 0)
+      continue;
+
+    /* an optional whitespace, then attributes like classes or voice names */
+    p = str + tag_len;
+    if (g_ascii_isspace (*p))
+      ++p;
+    while (g_ascii_isalnum (*p) || *p == '.' || *p == ' ' || *p == '\t'
+        || *p == '(' || *p == ')')
+      ++p;
+
+    if (strncmp (p, end_marker, end_len) == 0) {
+      *attr_len = p - (str + tag_len);
+      return tag;
+    }
+  }
+
+  return NULL;
+}
+
 /* we want to escape text in general, but retain basic markup like
  * <i></i>, <u></u>, and <b></b>. The easiest and safest way is to
  * just unescape a white list of allowed markups again after
@@ -676,41 +824,55 @@ static void
 subrip_unescape_formatting (gchar * txt, gconstpointer allowed_tags_ptr,
     gboolean allows_tag_attributes)
 {
-  gchar *res;
-  GRegex *tag_regex;
-  gchar *allowed_tags_pattern, *search_pattern;
-  const gchar *replace_pattern;
+  const gchar **allowed_tags = (const gchar **) allowed_tags_ptr;
+  gchar *read, *write;
 
   /* No processing needed if no escaped tag marker found in the string. */
-  if (strstr (txt, "&lt;") == NULL)
+  if ((read = strstr (txt, "&lt;")) == NULL)
     return;
 
-  /* Build a list of alternates for our regexp.
-   * FIXME: Could be built once and stored */
-  allowed_tags_pattern = g_strjoinv ("|", (gchar **) allowed_tags_ptr);
-  /* Look for starting/ending escaped tags with optional attributes. */
-  search_pattern = g_strdup_printf ("&lt;(/)?\\ *(%s)(%s)&gt;",
-      allowed_tags_pattern, ATTRIBUTE_REGEX);
-  /* And unescape appropriately */
-  if (allows_tag_attributes) {
-    replace_pattern = "<\\1\\2\\3>";
-  } else {
-    replace_pattern = "<\\1\\2>";
-  }
+  /* the unescaped tags are always shorter than the escaped ones, so
+   * this can be done in place */
+  write = read;
+  while (*read != '\0') {
+    const gchar *tag;
+    gchar *p;
+    gboolean closing = FALSE;
+    gsize tag_len, copy_len, attr_len = 0;
+
+    if (strncmp (read, "&lt;", 4) != 0) {
+      *write++ = *read++;
+      continue;
+    }
 
-  tag_regex = g_regex_new (search_pattern, 0, 0, NULL);
-  res = g_regex_replace (tag_regex, txt, strlen (txt), 0,
-      replace_pattern, 0, NULL);
+    /* Look for starting/ending escaped tags with optional attributes. */
+    p = read + 4;
+    if (*p == '/') {
+      closing = TRUE;
+      ++p;
+    }
+    while (*p == ' ')
+      ++p;
 
-  /* res will always be shorter than the input or identical, so this
-   * copy is OK */
-  strcpy (txt, res);
+    tag = subrip_match_tag (p, allowed_tags, "&gt;", &attr_len);
+    if (tag == NULL) {
+      *write++ = *read++;
+      continue;
+    }
 
-  g_free (res);
-  g_free (search_pattern);
-  g_free (allowed_tags_pattern);
+    /* And unescape appropriately */
+    tag_len = strlen (tag);
+    copy_len = allows_tag_attributes ? tag_len + attr_len : tag_len;
+    *write++ = '<';
+    if (closing)
+      *write++ = '/';
+    memmove (write, p, copy_len);
+    write += copy_len;
+    *write++ = '>';
 
-  g_regex_unref (tag_regex);
+    read = p + tag_len + attr_len + strlen ("&gt;");
+  }
+  *write = '\0';
 }
 
 
@@ -761,55 +923,27 @@ subrip_fix_up_markup (gchar ** p_txt, gconstpointer allowed_tags_ptr)
   GPtrArray *open_tags = NULL;
   guint num_open_tags = 0;
   const gchar *iter_tag;
-  guint offset = 0;
-  guint index;
-  gchar *cur_tag;
+  gsize attr_len = 0;
   gchar *end_tag;
-  GRegex *tag_regex;
-  GMatchInfo *match_info;
-  gchar **allowed_tags = (gchar **) allowed_tags_ptr;
+  const gchar **allowed_tags = (const gchar **) allowed_tags_ptr;
 
   g_assert (*p_txt != NULL);
 
-  open_tags = g_ptr_array_new_with_free_func (g_free);
+  /* contains pointers to the static allowed tags */
+  open_tags = g_ptr_array_new ();
   cur = *p_txt;
   while (*cur != '\0') {
     next_tag = strchr (cur, '<');
     if (next_tag == NULL)
       break;
-    offset = 0;
-    index = 0;
-    while (index < g_strv_length (allowed_tags)) {
-      iter_tag = allowed_tags[index];
-      /* Look for a white listed tag */
-      cur_tag = g_strconcat ("<", iter_tag, ATTRIBUTE_REGEX, ">", NULL);
-      tag_regex = g_regex_new (cur_tag, 0, 0, NULL);
-      (void) g_regex_match (tag_regex, next_tag, 0, &match_info);
-
-      if (g_match_info_matches (match_info)) {
-        gint start_pos, end_pos;
-        gchar *word = g_match_info_fetch (match_info, 0);
-        g_match_info_fetch_pos (match_info, 0, &start_pos, &end_pos);
-        if (start_pos == 0) {
-          offset = strlen (word);
-        }
-        g_free (word);
-      }
-      g_match_info_free (match_info);
-      g_regex_unref (tag_regex);
-      g_free (cur_tag);
-      index++;
-      if (offset) {
-        /* OK we found a tag, let's keep track of it */
-        g_ptr_array_add (open_tags, g_ascii_strdown (iter_tag, -1));
-        ++num_open_tags;
-        break;
-      }
-    }
 
-    if (offset) {
-      next_tag += offset;
-      cur = next_tag;
+    /* Look for a white listed tag */
+    iter_tag = subrip_match_tag (next_tag + 1, allowed_tags, ">", &attr_len);
+    if (iter_tag) {
+      /* OK we found a tag, let's keep track of it */
+      g_ptr_array_add (open_tags, (gpointer) iter_tag);
+      ++num_open_tags;
+      cur = next_tag + 1 + strlen (iter_tag) + attr_len + 1;
       continue;
     }
 
@@ -853,20 +987,92 @@ subrip_fix_up_markup (gchar ** p_txt, gconstpointer allowed_tags_ptr)
   g_ptr_array_free (open_tags, TRUE);
 }
 
+/* Small scanners for the timestamps and settings of the line based formats,
+ * they advance *p_str past whatever they consumed */
+
+/* like sscanf's %u: skips leading whitespace and reads a decimal number */
+static gboolean
+scan_uint (const gchar ** p_str, guint * val)
+{
+  const gchar *p = *p_str;
+  guint v = 0;
+
+  while (g_ascii_isspace (*p))
+    ++p;
+
+  if (!g_ascii_isdigit (*p))
+    return FALSE;
+
+  while (g_ascii_isdigit (*p))
+    v = v * 10 + (*p++ - '0');
+
+  *val = v;
+  *p_str = p;
+  return TRUE;
+}
+
+/* a decimal number with an optional sign */
+static gboolean
+scan_int (const gchar ** p_str, gint * val)
+{
+  const gchar *p = *p_str;
+  gboolean negative = FALSE;
+  guint v;
+
+  if (*p == '-' || *p == '+')
+    negative = (*p++ == '-');
+
+  if (!scan_uint (&p, &v))
+    return FALSE;
+
+  *val = negative ? -(gint) v : (gint) v;
+  *p_str = p;
+  return TRUE;
+}
+
+static gboolean
+scan_char (const gchar ** p_str, gchar c)
+{
+  if (**p_str != c)
+    return FALSE;
+
+  ++(*p_str);
+  return TRUE;
+}
+
+/* a number in which spaces are taken as zeroes, up to @end */
+static gboolean
+scan_padded_uint (const gchar ** p_str, const gchar * end, guint * val)
+{
+  const gchar *p = *p_str;
+  guint v = 0;
+
+  while (p < end && (g_ascii_isdigit (*p) || *p == ' ')) {
+    v = v * 10 + (*p == ' ' ? 0 : *p - '0');
+    ++p;
+  }
+
+  if (p == *p_str)
+    return FALSE;
+
+  *val = v;
+  *p_str = p;
+  return TRUE;
+}
+
 static gboolean
 parse_subrip_time (const gchar * ts_string, GstClockTime * t)
 {
-  gchar s[128] = { '\0', };
-  gchar *end, *p;
-  guint hour, min, sec, msec, len;
+  const gchar *p, *end;
+  guint hour, min, sec, msec = 0, n_digits = 0;
 
   while (*ts_string == ' ')
     ++ts_string;
 
-  g_strlcpy (s, ts_string, sizeof (s));
-  if ((end = strstr (s, "-->")))
-    *end = '\0';
-  g_strchomp (s);
+  if (!(end = strstr (ts_string, "-->")))
+    end = ts_string + strlen (ts_string);
+  while (end > ts_string && g_ascii_isspace (end[-1]))
+    --end;
 
   /* ms may be in these formats:
    * hh:mm:ss,500 = 500ms
@@ -875,40 +1081,36 @@ parse_subrip_time (const gchar * ts_string, GstClockTime * t)
    * hh:mm:ss, 50 =  50ms
    * hh:mm:ss,5   = 500ms
    * and the same with . instead of ,.
-   * sscanf() doesn't differentiate between '  5' and '5' so munge
-   * the white spaces within the timestamp to '0' (I'm sure there's a
-   * way to make sscanf() do this for us, but how?)
+   * Spaces within the timestamp count as '0', and only the first three
+   * digits after the comma are used.
    */
-  g_strdelimit (s, " ", '0');
-  g_strdelimit (s, ".", ',');
-
-  /* make sure we have exactly three digits after he comma */
-  p = strchr (s, ',');
-  if (p == NULL) {
-    /* If there isn't a ',' the timestamp is broken */
-    /* https://gitlab.freedesktop.org/gstreamer/gst-plugins-base/issues/532#note_100179 */
-    GST_WARNING ("failed to parse subrip timestamp string '%s'", s);
-    return FALSE;
-  }
-
+  p = ts_string;
+  if (!scan_padded_uint (&p, end, &hour) || !scan_char (&p, ':') ||
+      !scan_padded_uint (&p, end, &min) || !scan_char (&p, ':') ||
+      !scan_padded_uint (&p, end, &sec))
+    goto failed;
+
+  /* If there isn't a ',' the timestamp is broken */
+  /* https://gitlab.freedesktop.org/gstreamer/gst-plugins-base/issues/532#note_100179 */
+  if (p == end || (*p != ',' && *p != '.'))
+    goto failed;
   ++p;
-  len = strlen (p);
-  if (len > 3) {
-    p[3] = '\0';
-  } else
-    while (len < 3) {
-      g_strlcat (&p[len], "0", 2);
-      ++len;
-    }
 
-  GST_LOG ("parsing timestamp '%s'", s);
-  if (sscanf (s, "%u:%u:%u,%u", &hour, &min, &sec, &msec) != 4) {
-    GST_WARNING ("failed to parse subrip timestamp string '%s'", s);
-    return FALSE;
+  while (n_digits < 3 && p < end && (g_ascii_isdigit (*p) || *p == ' ')) {
+    msec = msec * 10 + (*p == ' ' ? 0 : *p - '0');
+    ++n_digits;
+    ++p;
   }
+  for (; n_digits < 3; ++n_digits)
+    msec *= 10;
 
   *t = ((hour * 3600) + (min * 60) + sec) * GST_SECOND + msec * GST_MSECOND;
   return TRUE;
+
+failed:
+  GST_WARNING ("failed to parse subrip timestamp string '%.*s'",
+      (gint) (end - ts_string), ts_string);
+  return FALSE;
 }
 
 /* cue settings are part of the WebVTT specification. They are
@@ -919,57 +1121,56 @@ parse_subrip_time (const gchar * ts_string, GstClockTime * t)
 static void
 parse_webvtt_cue_settings (ParserState * state, const gchar * settings)
 {
-  gchar **splitted_settings = g_strsplit_set (settings, " \t", -1);
-  gint i = 0;
-  gint16 text_position, text_size;
-  gint16 line_position;
+  const gchar *token = settings;
   gboolean vertical_found = FALSE;
   gboolean alignment_found = FALSE;
 
-  while (i < g_strv_length (splitted_settings)) {
+  while (*token != '\0') {
     gboolean valid_tag = FALSE;
-    switch (splitted_settings[i][0]) {
+    const gchar *value = token + 2;
+    gsize len;
+    gint v;
+
+    len = strcspn (token, " \t");
+    if (len == 0) {
+      ++token;
+      continue;
+    }
+
+    switch (token[0]) {
       case 'T':
-        if (sscanf (splitted_settings[i], "T:%" G_GINT16_FORMAT "%%",
-                &text_position) > 0) {
-          state->text_position = (guint8) text_position;
+        if (token[1] == ':' && scan_int (&value, &v)) {
+          state->text_position = (guint8) v;
           valid_tag = TRUE;
         }
         break;
       case 'D':
-        if (strlen (splitted_settings[i]) > 2) {
+        if (len > 2) {
           vertical_found = TRUE;
           g_free (state->vertical);
-          state->vertical = g_strdup (splitted_settings[i] + 2);
+          state->vertical = g_strndup (token + 2, len - 2);
           valid_tag = TRUE;
         }
         break;
       case 'L':
-        if (g_str_has_suffix (splitted_settings[i], "%")) {
-          if (sscanf (splitted_settings[i], "L:%" G_GINT16_FORMAT "%%",
-                  &line_position) > 0) {
-            state->line_position = line_position;
-            valid_tag = TRUE;
-          }
-        } else {
-          if (sscanf (splitted_settings[i], "L:%" G_GINT16_FORMAT,
-                  &line_position) > 0) {
-            state->line_number = line_position;
-            valid_tag = TRUE;
-          }
+        if (token[1] == ':' && scan_int (&value, &v)) {
+          if (token[len - 1] == '%')
+            state->line_position = v;
+          else
+            state->line_number = v;
+          valid_tag = TRUE;
         }
         break;
       case 'S':
-        if (sscanf (splitted_settings[i], "S:%" G_GINT16_FORMAT "%%",
-                &text_size) > 0) {
-          state->text_size = (guint8) text_size;
+        if (token[1] == ':' && scan_int (&value, &v)) {
+          state->text_size = (guint8) v;
           valid_tag = TRUE;
         }
         break;
       case 'A':
-        if (strlen (splitted_settings[i]) > 2) {
+        if (len > 2) {
           g_free (state->alignment);
-          state->alignment = g_strdup (splitted_settings[i] + 2);
+          state->alignment = g_strndup (token + 2, len - 2);
           alignment_found = TRUE;
           valid_tag = TRUE;
         }
@@ -978,12 +1179,11 @@ parse_webvtt_cue_settings (ParserState * state, const gchar * settings)
         break;
     }
     if (!valid_tag) {
-      GST_LOG ("Invalid or unrecognised setting found: %s",
-          splitted_settings[i]);
+      GST_LOG ("Invalid or unrecognised setting found: %.*s", (gint) len,
+          token);
     }
-    i++;
+    token += len;
   }
-  g_strfreev (splitted_settings);
   if (!vertical_found) {
     g_free (state->vertical);
     state->vertical = g_strdup ("");
@@ -1192,8 +1392,14 @@ parse_subviewer (ParserState * state, const gchar * line)
   switch (state->state) {
     case 0:
       /* looking for start_time,end_time */
-      if (sscanf (line, "%u:%u:%u.%u,%u:%u:%u.%u",
-              &h1, &m1, &s1, &ms1, &h2, &m2, &s2, &ms2) == 8) {
+      if (scan_uint (&line, &h1) && scan_char (&line, ':') &&
+          scan_uint (&line, &m1) && scan_char (&line, ':') &&
+          scan_uint (&line, &s1) && scan_char (&line, '.') &&
+          scan_uint (&line, &ms1) && scan_char (&line, ',') &&
+          scan_uint (&line, &h2) && scan_char (&line, ':') &&
+          scan_uint (&line, &m2) && scan_char (&line, ':') &&
+          scan_uint (&line, &s2) && scan_char (&line, '.') &&
+          scan_uint (&line, &ms2)) {
         state->state = 1;
         state->start_time =
             (((guint64) h1) * 3600 + m1 * 60 + s1) * GST_SECOND +
@@ -1687,7 +1893,16 @@ feed_textbuf (GstSubParse * self, GstBuffer * buf)
     /* flush the parser state */
     parser_state_init (&self->state);
     g_string_truncate (self->textbuf, 0);
+    self->textbuf_pos = 0;
+    self->textbuf_offset = self->offset;
     gst_adapter_clear (self->adapter);
+    /* we can only keep indexing if we restart at a known cue boundary */
+    GST_OBJECT_LOCK (self);
+    if (GST_BUFFER_OFFSET_IS_VALID (buf))
+      self->max_end = gst_sub_parse_index_get_max_end (self, self->offset);
+    else
+      self->max_end = GST_CLOCK_TIME_NONE;
+    GST_OBJECT_UNLOCK (self);
     if (self->parser_type == GST_SUB_PARSE_FORMAT_SAMI)
       sami_context_reset (&self->state);
     /* we could set a flag to make sure that the next buffer we push out also
@@ -1704,7 +1919,21 @@ feed_textbuf (GstSubParse * self, GstBuffer * buf)
   input = convert_encoding (self, (const gchar *) data, avail, &consumed);
 
   if (input && consumed > 0) {
-    self->textbuf = g_string_append (self->textbuf, input);
+    gsize len = strlen (input);
+
+    /* the index stores input byte offsets, which only match the text if
+     * no conversion happened, apart from dropping a UTF-8 BOM */
+    if (len + 3 == consumed && self->textbuf->len == 0 && avail >= 3 &&
+        data[0] == 0xEF && data[1] == 0xBB && data[2] == 0xBF) {
+      self->textbuf_offset += 3;
+    } else if (len != consumed && self->index_valid) {
+      GST_DEBUG_OBJECT (self, "input was converted, not indexing cues");
+      GST_OBJECT_LOCK (self);
+      self->index_valid = FALSE;
+      GST_OBJECT_UNLOCK (self);
+    }
+
+    self->textbuf = g_string_append_len (self->textbuf, input, len);
     gst_adapter_unmap (self->adapter);
     gst_adapter_flush (self->adapter, consumed);
   } else {
@@ -1721,6 +1950,7 @@ handle_buffer (GstSubParse * self, GstBuffer * buf)
   GstCaps *caps = NULL;
   gchar *line, *subtitle;
   gboolean need_tags = FALSE;
+  gboolean use_index;
 
   if (self->first_buffer) {
     GstMapInfo map;
@@ -1768,25 +1998,45 @@ handle_buffer (GstSubParse * self, GstBuffer * buf)
     }
   }
 
+  use_index = self->index_valid &&
+      gst_sub_parse_format_has_index (self->parser_type);
+
   while (!self->flushing && (line = get_next_line (self))) {
     guint offset = 0;
+    GstClockTime start_time, duration;
+
+    /* Between two cues, remember where we could restart parsing */
+    if (use_index && self->state.state == 0 && self->state.buf->len == 0 &&
+        GST_CLOCK_TIME_IS_VALID (self->max_end)) {
+      GST_OBJECT_LOCK (self);
+      gst_sub_parse_index_add (self,
+          self->textbuf_offset + (line - self->textbuf->str), self->max_end);
+      GST_OBJECT_UNLOCK (self);
+    }
 
     /* Set segment on our parser state machine */
     self->state.segment = &self->segment;
+    start_time = self->state.start_time;
+    duration = self->state.duration;
     /* Now parse the line, out of segment lines will just return NULL */
     GST_LOG_OBJECT (self, "State %d. Parsing line '%s'", self->state.state,
         line + offset);
     subtitle = self->parse_line (&self->state, line + offset);
-    g_free (line);
+
+    /* a new cue timing was parsed */
+    if (use_index && GST_CLOCK_TIME_IS_VALID (self->max_end) &&
+        GST_CLOCK_TIME_IS_VALID (self->state.duration) &&
+        (self->state.start_time != start_time ||
+            self->state.duration != duration)) {
+      self->max_end = MAX (self->max_end,
+          self->state.start_time + self->state.duration);
+    }
 
     if (subtitle) {
       guint subtitle_len = strlen (subtitle);
 
-      /* +1 for terminating NUL character */
-      buf = gst_buffer_new_and_alloc (subtitle_len + 1);
-
-      /* copy terminating NUL character as well */
-      gst_buffer_fill (buf, 0, subtitle, subtitle_len + 1);
+      /* keep the terminating NUL character behind the declared data */
+      buf = gst_buffer_new_wrapped (subtitle, subtitle_len + 1);
       gst_buffer_set_size (buf, subtitle_len);
 
       GST_BUFFER_TIMESTAMP (buf) = self->state.start_time;
@@ -1819,7 +2069,6 @@ handle_buffer (GstSubParse * self, GstBuffer * buf)
       if (self->state.duration != GST_CLOCK_TIME_NONE)
         self->state.start_time += self->state.duration;
 
-      g_free (subtitle);
       subtitle = NULL;
 
       if (ret != GST_FLOW_OK) {
@@ -1829,6 +2078,8 @@ handle_buffer (GstSubParse * self, GstBuffer * buf)
     }
   }
 
+  compact_textbuf (self);
+
   return ret;
 }
 
@@ -1890,8 +2141,9 @@ gst_sub_parse_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
       /* if not time format, we'll either start with a 0 timestamp anyway or
        * it's following a seek in which case we'll have saved the requested
        * seek segment and don't want to overwrite it (remember that on a seek
-       * we always just seek back to the start in BYTES format and just throw
-       * away all text that's before the requested position; if the subtitles
+       * we always just seek back to the start or the last indexed cue before
+       * the requested position in BYTES format and just throw away all text
+       * that's before the requested position; if the subtitles
        * come from an upstream demuxer, it won't be able to handle our BYTES
        * seek request and instead send us a newsegment from the seek request
        * it received via its video pads instead, so all is fine then too) */
@@ -1942,7 +2194,14 @@ gst_sub_parse_change_state (GstElement * element, GstStateChange transition)
       g_free (self->detected_encoding);
       self->detected_encoding = NULL;
       g_string_truncate (self->textbuf, 0);
+      self->textbuf_pos = 0;
+      self->textbuf_offset = 0;
       gst_adapter_clear (self->adapter);
+      GST_OBJECT_LOCK (self);
+      g_array_set_size (self->index, 0);
+      self->index_valid = TRUE;
+      GST_OBJECT_UNLOCK (self);
+      self->max_end = 0;
       break;
     default:
       break;
@@ -91,6 +91,10 @@ struct _GstSubParse {
   GstAdapter *adapter;
   /* contains the UTF-8 decoded input */
   GString *textbuf;
+  /* read position of the next line in textbuf */
+  gsize textbuf_pos;
+  /* input byte offset of the start of textbuf */
+  guint64 textbuf_offset;
 
   GstSubParseFormat parser_type;
   gboolean parser_detected;
@@ -101,6 +105,14 @@ struct _GstSubParse {
 
   /* seek */
   guint64 offset;
+
+  /* cue index: byte offsets of cue boundaries along with the highest end
+   * time of all cues before them, sorted by offset */
+  GArray  *index;
+  /* FALSE if the decoded text doesn't map 1:1 to input bytes */
+  gboolean index_valid;
+  /* highest cue end time seen so far, NONE if unknown */
+  GstClockTime max_end;
   
   /* Segment */
   GstSegment    segment;
@@ -24,8 +24,13 @@
  * This element takes an incoming stream of timestamped video frames.
  * It will produce a perfect stream that matches the source pad's framerate.
  *
- * The correction is performed by dropping and duplicating frames, no fancy
- * algorithm is used to interpolate frames (yet).
+ * The correction is performed by dropping and duplicating frames. When the
+ * #GstVideoRate:blend property is set, frames that fall between two input
+ * frames are instead interpolated by blending both.
+ *
+ * Duplicated frames share the memory of the original frame and are marked
+ * with the %GST_VIDEO_BUFFER_FLAG_DUPLICATE flag, so that encoders can
+ * encode them as skipped frames.
  *
  * By default the element will simply negotiate the same framerate on its
  * source and sink pad.
@@ -100,6 +105,7 @@ enum
 #define DEFAULT_MAX_RATE        G_MAXINT
 #define DEFAULT_RATE            1.0
 #define DEFAULT_MAX_DUPLICATION_TIME      0
+#define DEFAULT_BLEND           FALSE
 
 enum
 {
@@ -115,7 +121,8 @@ enum
   PROP_AVERAGE_PERIOD,
   PROP_MAX_RATE,
   PROP_RATE,
-  PROP_MAX_DUPLICATION_TIME
+  PROP_MAX_DUPLICATION_TIME,
+  PROP_BLEND
 };
 
 static GstStaticPadTemplate gst_video_rate_src_template =
@@ -134,6 +141,8 @@ static GstStaticPadTemplate gst_video_rate_sink_template =
         "image/jpeg(ANY);" "image/png(ANY)")
     );
 
+static gboolean gst_video_rate_check_blend (GstVideoRate * videorate,
+    GstCaps * caps);
 static void gst_video_rate_swap_prev (GstVideoRate * videorate,
     GstBuffer * buffer, gint64 time);
 static gboolean gst_video_rate_sink_event (GstBaseTransform * trans,
@@ -293,6 +302,23 @@ gst_video_rate_class_init (GstVideoRateClass * klass)
           0, G_MAXUINT64, DEFAULT_MAX_DUPLICATION_TIME,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstVideoRate:blend:
+   *
+   * Interpolate output frames that fall between two input frames by blending
+   * both, weighted by their distance to the output frame, instead of
+   * repeating the previous frame. This is only done for raw video in system
+   * memory with 8 bits per component and a fixed output framerate, other
+   * streams are handled as if this property was not set.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (object_class, PROP_BLEND,
+      g_param_spec_boolean ("blend", "Blend",
+          "Blend the surrounding input frames for output frames in between "
+          "instead of duplicating the previous one", DEFAULT_BLEND,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_set_static_metadata (element_class,
       "Video rate adjuster", "Filter/Effect/Video",
       "Drops/duplicates/adjusts timestamps on video frames to make a perfect stream",
@@ -583,6 +609,8 @@ gst_video_rate_setcaps (GstBaseTransform * trans, GstCaps * in_caps,
   else
     videorate->wanted_diff = 0;
 
+  videorate->can_blend = gst_video_rate_check_blend (videorate, in_caps);
+
 done:
   /* After a setcaps, our caps may have changed. In that case, we can't use
    * the old buffer, if there was one (it might have different dimensions) */
@@ -634,6 +662,8 @@ gst_video_rate_init (GstVideoRate * videorate)
   videorate->max_rate = DEFAULT_MAX_RATE;
   videorate->rate = DEFAULT_RATE;
   videorate->max_duplication_time = DEFAULT_MAX_DUPLICATION_TIME;
+  videorate->blend = DEFAULT_BLEND;
+  videorate->can_blend = FALSE;
 
   videorate->from_rate_numerator = 0;
   videorate->from_rate_denominator = 0;
@@ -660,10 +690,13 @@ gst_video_rate_push_buffer (GstVideoRate * videorate, GstBuffer * outbuf,
   } else
     GST_BUFFER_FLAG_UNSET (outbuf, GST_BUFFER_FLAG_DISCONT);
 
-  if (duplicate)
+  if (duplicate) {
     GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_GAP);
-  else
+    GST_BUFFER_FLAG_SET (outbuf, GST_VIDEO_BUFFER_FLAG_DUPLICATE);
+  } else {
     GST_BUFFER_FLAG_UNSET (outbuf, GST_BUFFER_FLAG_GAP);
+    GST_BUFFER_FLAG_UNSET (outbuf, GST_VIDEO_BUFFER_FLAG_DUPLICATE);
+  }
 
   /* this is the timestamp we put on the buffer */
   push_ts = videorate->next_ts;
@@ -732,7 +765,8 @@ gst_video_rate_flush_prev (GstVideoRate * videorate, gboolean duplicate,
     goto eos_before_buffers;
 
   outbuf = gst_buffer_ref (videorate->prevbuf);
-  /* make sure we can write to the metadata */
+  /* make sure we can write to the metadata, this only copies the buffer
+   * metadata and shares the memory of prevbuf */
   outbuf = gst_buffer_make_writable (outbuf);
 
   return gst_video_rate_push_buffer (videorate, outbuf, duplicate, next_intime);
@@ -745,6 +779,140 @@ eos_before_buffers:
   }
 }
 
+static gboolean
+gst_video_rate_check_blend (GstVideoRate * videorate, GstCaps * caps)
+{
+  GstCapsFeatures *features = gst_caps_get_features (caps, 0);
+  const GstVideoFormatInfo *finfo;
+  guint i;
+
+  if (!gst_caps_features_is_equal (features,
+          GST_CAPS_FEATURES_MEMORY_SYSTEM_MEMORY))
+    return FALSE;
+
+  if (!gst_video_info_from_caps (&videorate->vinfo, caps))
+    return FALSE;
+
+  /* frames are blended byte by byte */
+  finfo = videorate->vinfo.finfo;
+  if (GST_VIDEO_FORMAT_INFO_BITS (finfo) != 8 ||
+      GST_VIDEO_FORMAT_INFO_HAS_PALETTE (finfo) ||
+      GST_VIDEO_FORMAT_INFO_IS_TILED (finfo))
+    return FALSE;
+
+  for (i = 0; i < GST_VIDEO_FORMAT_INFO_N_COMPONENTS (finfo); i++) {
+    if (GST_VIDEO_FORMAT_INFO_PSTRIDE (finfo, i) == 0)
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
+/* out = (prev * (256 - weight) + next * weight) / 256, for every byte of
+ * the frame */
+static void
+gst_video_rate_blend_frames (GstVideoFrame * out, GstVideoFrame * prev,
+    GstVideoFrame * next, guint weight)
+{
+  gboolean done[GST_VIDEO_MAX_PLANES] = { FALSE, };
+  guint c, i, j;
+
+  for (c = 0; c < GST_VIDEO_FRAME_N_COMPONENTS (out); c++) {
+    guint plane = GST_VIDEO_FRAME_COMP_PLANE (out, c);
+    guint width, height;
+
+    if (done[plane])
+      continue;
+    done[plane] = TRUE;
+
+    width = GST_VIDEO_FRAME_COMP_WIDTH (out, c) *
+        GST_VIDEO_FRAME_COMP_PSTRIDE (out, c);
+    height = GST_VIDEO_FRAME_COMP_HEIGHT (out, c);
+
+    for (j = 0; j < height; j++) {
+      const guint8 *a = (const guint8 *) GST_VIDEO_FRAME_PLANE_DATA (prev,
+          plane) + j * GST_VIDEO_FRAME_PLANE_STRIDE (prev, plane);
+      const guint8 *b = (const guint8 *) GST_VIDEO_FRAME_PLANE_DATA (next,
+          plane) + j * GST_VIDEO_FRAME_PLANE_STRIDE (next, plane);
+      guint8 *o = (guint8 *) GST_VIDEO_FRAME_PLANE_DATA (out, plane) +
+          j * GST_VIDEO_FRAME_PLANE_STRIDE (out, plane);
+
+      for (i = 0; i < width; i++)
+        o[i] = (a[i] * (256 - weight) + b[i] * weight + 128) >> 8;
+    }
+  }
+}
+
+/* output a frame at @time between the oldest buffer and @nextbuf, @blended
+ * is set to FALSE when the oldest buffer was output as is instead */
+static GstFlowReturn
+gst_video_rate_blend_prev (GstVideoRate * videorate, GstBuffer * nextbuf,
+    GstClockTime time, GstClockTime next_intime, gboolean duplicate,
+    gboolean * blended)
+{
+  GstClockTime prevtime = videorate->prev_ts;
+  GstVideoFrame prev, next, out;
+  GstVideoMeta *vmeta;
+  GstBuffer *outbuf;
+  guint weight;
+
+  *blended = FALSE;
+
+  if (time <= prevtime || next_intime <= prevtime)
+    goto flush_prev;
+
+  weight = gst_util_uint64_scale (time - prevtime, 256,
+      next_intime - prevtime);
+  if (weight == 0)
+    goto flush_prev;
+
+  outbuf = gst_buffer_new_allocate (NULL,
+      GST_VIDEO_INFO_SIZE (&videorate->vinfo), NULL);
+  gst_buffer_copy_into (outbuf, videorate->prevbuf,
+      GST_BUFFER_COPY_FLAGS | GST_BUFFER_COPY_TIMESTAMPS |
+      GST_BUFFER_COPY_META, 0, -1);
+  /* the video meta describes the memory layout of prevbuf, the new buffer
+   * uses the default layout of the negotiated caps */
+  vmeta = gst_buffer_get_video_meta (outbuf);
+  if (vmeta)
+    gst_buffer_remove_meta (outbuf, (GstMeta *) vmeta);
+
+  if (!gst_video_frame_map (&out, &videorate->vinfo, outbuf, GST_MAP_WRITE))
+    goto map_failed;
+  if (!gst_video_frame_map (&prev, &videorate->vinfo, videorate->prevbuf,
+          GST_MAP_READ)) {
+    gst_video_frame_unmap (&out);
+    goto map_failed;
+  }
+  if (!gst_video_frame_map (&next, &videorate->vinfo, nextbuf, GST_MAP_READ)) {
+    gst_video_frame_unmap (&prev);
+    gst_video_frame_unmap (&out);
+    goto map_failed;
+  }
+
+  GST_LOG_OBJECT (videorate, "blending frame at %" GST_TIME_FORMAT
+      " with weight %u/256", GST_TIME_ARGS (time), weight);
+  gst_video_rate_blend_frames (&out, &prev, &next, weight);
+
+  gst_video_frame_unmap (&next);
+  gst_video_frame_unmap (&prev);
+  gst_video_frame_unmap (&out);
+
+  *blended = TRUE;
+
+  return gst_video_rate_push_buffer (videorate, outbuf, FALSE, next_intime);
+
+flush_prev:
+  return gst_video_rate_flush_prev (videorate, duplicate, next_intime);
+
+map_failed:
+  {
+    GST_DEBUG_OBJECT (videorate, "could not map frames, duplicating instead");
+    gst_buffer_unref (outbuf);
+    goto flush_prev;
+  }
+}
+
 static void
 gst_video_rate_swap_prev (GstVideoRate * videorate, GstBuffer * buffer,
     gint64 time)
@@ -1439,11 +1607,17 @@ gst_video_rate_transform_ip (GstBaseTransform * trans, GstBuffer * buffer)
     }
   } else {
     GstClockTime prevtime;
-    gint count = 0;
+    gint count = 0, dups = 0;
     gint64 diff1, diff2;
+    gboolean blend;
 
     prevtime = videorate->prev_ts;
 
+    GST_OBJECT_LOCK (videorate);
+    blend = videorate->blend && videorate->can_blend &&
+        videorate->segment.rate > 0.0 && videorate->to_rate_numerator != 0;
+    GST_OBJECT_UNLOCK (videorate);
+
     GST_LOG_OBJECT (videorate,
         "BEGINNING prev buf %" GST_TIME_FORMAT " new buf %" GST_TIME_FORMAT
         " outgoing ts %" GST_TIME_FORMAT, GST_TIME_ARGS (prevtime),
@@ -1543,6 +1717,13 @@ gst_video_rate_transform_ip (GstBaseTransform * trans, GstBuffer * buffer)
         diff1 = ABSDIFF (prevtime, next_ts);
         diff2 = ABSDIFF (intime, next_ts);
 
+        /* when blending, every frame before the new buffer is interpolated
+         * from both buffers, whichever is closer */
+        if (blend) {
+          diff1 = next_ts < intime ? 0 : 1;
+          diff2 = !diff1;
+        }
+
         GST_LOG_OBJECT (videorate,
             "diff with prev %" GST_TIME_FORMAT " diff with new %"
             GST_TIME_FORMAT " outgoing ts %" GST_TIME_FORMAT,
@@ -1553,11 +1734,21 @@ gst_video_rate_transform_ip (GstBaseTransform * trans, GstBuffer * buffer)
       /* output first one when its the best */
       if (diff1 <= diff2) {
         GstFlowReturn r;
+        gboolean blended = FALSE;
         count++;
 
         /* on error the _flush function posted a warning already */
-        if ((r = gst_video_rate_flush_prev (videorate,
-                    count > 1, intime)) != GST_FLOW_OK) {
+        if (blend)
+          r = gst_video_rate_blend_prev (videorate, buffer, next_ts, intime,
+              count > 1, &blended);
+        else
+          r = gst_video_rate_flush_prev (videorate, count > 1, intime);
+
+        /* interpolated frames are new frames, not duplicates */
+        if (count > 1 && !blended)
+          dups++;
+
+        if (r != GST_FLOW_OK) {
           res = r;
           goto done;
         }
@@ -1569,8 +1760,8 @@ gst_video_rate_transform_ip (GstBaseTransform * trans, GstBuffer * buffer)
     while (diff1 < diff2);
 
     /* if we outputed the first buffer more then once, we have dups */
-    if (count > 1) {
-      videorate->dup += count - 1;
+    if (dups > 0) {
+      videorate->dup += dups;
       if (!videorate->silent)
         gst_video_rate_notify_duplicate (videorate);
     }
@@ -1680,6 +1871,9 @@ gst_video_rate_set_property (GObject * object,
     case PROP_MAX_DUPLICATION_TIME:
       videorate->max_duplication_time = g_value_get_uint64 (value);
       break;
+    case PROP_BLEND:
+      videorate->blend = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1742,6 +1936,9 @@ gst_video_rate_get_property (GObject * object,
     case PROP_MAX_DUPLICATION_TIME:
       g_value_set_uint64 (value, videorate->max_duplication_time);
       break;
+    case PROP_BLEND:
+      g_value_set_boolean (value, videorate->blend);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -22,6 +22,7 @@
 
 #include <gst/gst.h>
 #include <gst/base/gstbasetransform.h>
+#include <gst/video/video.h>
 
 G_BEGIN_DECLS
 #define GST_TYPE_VIDEO_RATE \
@@ -59,6 +60,8 @@ struct _GstVideoRate
                                  * frame rate caps change */
   gboolean discont;
   guint64 last_ts;              /* Timestamp of last input buffer */
+  GstVideoInfo vinfo;           /* only valid if can_blend is set */
+  gboolean can_blend;
 
   guint64 average_period;
   GstClockTimeDiff wanted_diff; /* target average diff */
@@ -77,6 +80,7 @@ struct _GstVideoRate
   gboolean skip_to_first;
   gboolean drop_only;
   guint64 average_period_set;
+  gboolean blend;
 
   volatile int max_rate;
   gdouble rate;
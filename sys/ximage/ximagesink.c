@@ -155,9 +155,20 @@ enum
   PROP_HANDLE_EVENTS,
   PROP_HANDLE_EXPOSE,
   PROP_WINDOW_WIDTH,
-  PROP_WINDOW_HEIGHT
+  PROP_WINDOW_HEIGHT,
+  PROP_MAX_PENDING_FRAMES,
+  PROP_DROP_FRAMES,
+  PROP_PRESENT_STATS
 };
 
+#define DEFAULT_MAX_PENDING_FRAMES 2
+#define DEFAULT_DROP_FRAMES FALSE
+
+/* how long we wait for XShm completion events before syncing with the X
+ * server, in milliseconds */
+#define COMPLETION_POLL_TIMEOUT 5
+#define COMPLETION_POLL_COUNT 10
+
 /* ============================================================= */
 /*                                                               */
 /*                       Public Methods                          */
@@ -306,7 +317,10 @@ gst_x_image_sink_ximage_put (GstXImageSink * ximagesink, GstBuffer * ximage)
         ximagesink->xwindow->width, ximagesink->xwindow->height);
     XShmPutImage (ximagesink->xcontext->disp, ximagesink->xwindow->win,
         ximagesink->xwindow->gc, mem->ximage, src.x, src.y, result.x, result.y,
-        result.w, result.h, FALSE);
+        result.w, result.h, TRUE);
+    /* the X server reads from the segment until it sends the completion
+     * event, keep the image around until then */
+    g_queue_push_tail (&ximagesink->pending, gst_buffer_ref (ximage));
   } else
 #endif /* HAVE_XSHM */
   {
@@ -319,7 +333,7 @@ gst_x_image_sink_ximage_put (GstXImageSink * ximagesink, GstBuffer * ximage)
         result.w, result.h);
   }
 
-  XSync (ximagesink->xcontext->disp, FALSE);
+  XFlush (ximagesink->xcontext->disp);
 
   g_mutex_unlock (&ximagesink->x_lock);
 
@@ -328,6 +342,196 @@ gst_x_image_sink_ximage_put (GstXImageSink * ximagesink, GstBuffer * ximage)
   return TRUE;
 }
 
+/* Releases the images whose XShm completion event was received and returns
+ * the number of images the X server may still be reading from */
+static guint
+gst_x_image_sink_process_completions (GstXImageSink * ximagesink)
+{
+  GSList *done = NULL;
+  guint n_pending;
+
+  g_mutex_lock (&ximagesink->x_lock);
+#ifdef HAVE_XSHM
+  if (ximagesink->xcontext->use_xshm) {
+    XEvent e;
+
+    while (XCheckTypedEvent (ximagesink->xcontext->disp,
+            ximagesink->xcontext->shm_completion, &e)) {
+      GstBuffer *buffer = g_queue_pop_head (&ximagesink->pending);
+
+      if (buffer)
+        done = g_slist_prepend (done, buffer);
+    }
+  }
+#endif /* HAVE_XSHM */
+  n_pending = ximagesink->pending.length;
+  g_mutex_unlock (&ximagesink->x_lock);
+
+  /* releasing an image can free it, which takes the x_lock */
+  g_slist_free_full (done, (GDestroyNotify) gst_buffer_unref);
+
+  return n_pending;
+}
+
+/* Releases all the images put so far, once the X server is done with them */
+static void
+gst_x_image_sink_release_pending (GstXImageSink * ximagesink)
+{
+  GQueue pending = G_QUEUE_INIT;
+  GstBuffer *buffer;
+
+  g_mutex_lock (&ximagesink->x_lock);
+  /* all requests are processed once XSync returns, completion events that
+   * did not arrive by then never will, e.g. when the window was destroyed */
+  XSync (ximagesink->xcontext->disp, FALSE);
+  g_mutex_unlock (&ximagesink->x_lock);
+
+  gst_x_image_sink_process_completions (ximagesink);
+
+  g_mutex_lock (&ximagesink->x_lock);
+  pending = ximagesink->pending;
+  g_queue_init (&ximagesink->pending);
+  g_mutex_unlock (&ximagesink->x_lock);
+
+  while ((buffer = g_queue_pop_head (&pending)))
+    gst_buffer_unref (buffer);
+}
+
+/* Waits until the X server is reading from at most @max images */
+static void
+gst_x_image_sink_wait_completions (GstXImageSink * ximagesink, guint max)
+{
+  GPollFD pfd = { ConnectionNumber (ximagesink->xcontext->disp), G_IO_IN, 0 };
+  guint i;
+
+  for (i = 0; i < COMPLETION_POLL_COUNT; i++) {
+    if (gst_x_image_sink_process_completions (ximagesink) <= max)
+      return;
+
+    /* the event thread may read our events from the connection, so only
+     * wait a little for it to become readable */
+    g_poll (&pfd, 1, COMPLETION_POLL_TIMEOUT);
+  }
+
+  GST_DEBUG_OBJECT (ximagesink, "no completion events, syncing");
+  gst_x_image_sink_release_pending (ximagesink);
+}
+
+static gpointer
+gst_x_image_sink_present_thread (GstXImageSink * ximagesink)
+{
+  GstBuffer *buffer;
+  guint max_pending;
+
+  g_mutex_lock (&ximagesink->present_lock);
+  /* the last frame is still put when shutting down */
+  while (ximagesink->present_running || ximagesink->present_next) {
+    if (ximagesink->present_next == NULL) {
+      g_cond_wait (&ximagesink->present_cond, &ximagesink->present_lock);
+      continue;
+    }
+
+    buffer = ximagesink->present_next;
+    ximagesink->present_next = NULL;
+    /* wake up show_frame() or a state change waiting for a free slot */
+    g_cond_broadcast (&ximagesink->present_cond);
+    g_mutex_unlock (&ximagesink->present_lock);
+
+    GST_OBJECT_LOCK (ximagesink);
+    max_pending = ximagesink->max_pending;
+    GST_OBJECT_UNLOCK (ximagesink);
+
+    /* make room for the image we are about to put */
+    gst_x_image_sink_wait_completions (ximagesink, max_pending - 1);
+
+    if (gst_x_image_sink_ximage_put (ximagesink, buffer)) {
+      g_mutex_lock (&ximagesink->present_lock);
+      ximagesink->presented++;
+      g_mutex_unlock (&ximagesink->present_lock);
+    } else {
+      GST_WARNING_OBJECT (ximagesink, "could not output image - no window");
+    }
+    gst_buffer_unref (buffer);
+
+    g_mutex_lock (&ximagesink->present_lock);
+  }
+  g_mutex_unlock (&ximagesink->present_lock);
+
+  return NULL;
+}
+
+/* Waits until the presentation thread took the frame waiting to be put */
+static void
+gst_x_image_sink_present_wait (GstXImageSink * ximagesink)
+{
+  while (ximagesink->present_next && ximagesink->present_running)
+    g_cond_wait (&ximagesink->present_cond, &ximagesink->present_lock);
+}
+
+/* Hands @buffer over to the presentation thread. If the frame before it was
+ * not put yet, waits for it or, with drop-frames, replaces it */
+static void
+gst_x_image_sink_present (GstXImageSink * ximagesink, GstBuffer * buffer)
+{
+  GstBuffer *dropped;
+  gboolean drop_frames;
+
+  GST_OBJECT_LOCK (ximagesink);
+  drop_frames = ximagesink->drop_frames;
+  GST_OBJECT_UNLOCK (ximagesink);
+
+  g_mutex_lock (&ximagesink->present_lock);
+  if (!drop_frames)
+    gst_x_image_sink_present_wait (ximagesink);
+  dropped = ximagesink->present_next;
+  ximagesink->present_next = gst_buffer_ref (buffer);
+  if (dropped) {
+    GST_DEBUG_OBJECT (ximagesink, "dropping frame %p, not put yet", dropped);
+    ximagesink->dropped++;
+  }
+  g_cond_signal (&ximagesink->present_cond);
+  g_mutex_unlock (&ximagesink->present_lock);
+
+  if (dropped)
+    gst_buffer_unref (dropped);
+}
+
+static void
+gst_x_image_sink_start_present_thread (GstXImageSink * ximagesink)
+{
+  g_mutex_lock (&ximagesink->present_lock);
+  if (!ximagesink->present_thread) {
+    ximagesink->presented = 0;
+    ximagesink->dropped = 0;
+    ximagesink->present_running = TRUE;
+    ximagesink->present_thread = g_thread_try_new ("ximagesink-present",
+        (GThreadFunc) gst_x_image_sink_present_thread, ximagesink, NULL);
+  }
+  g_mutex_unlock (&ximagesink->present_lock);
+}
+
+/* Stops the presentation thread once it put the frame waiting to be put */
+static void
+gst_x_image_sink_stop_present_thread (GstXImageSink * ximagesink)
+{
+  GThread *thread;
+
+  g_mutex_lock (&ximagesink->present_lock);
+  ximagesink->present_running = FALSE;
+  thread = ximagesink->present_thread;
+  ximagesink->present_thread = NULL;
+  g_cond_broadcast (&ximagesink->present_cond);
+  g_mutex_unlock (&ximagesink->present_lock);
+
+  if (thread)
+    g_thread_join (thread);
+
+  /* without a thread nothing puts it */
+  g_mutex_lock (&ximagesink->present_lock);
+  gst_buffer_replace (&ximagesink->present_next, NULL);
+  g_mutex_unlock (&ximagesink->present_lock);
+}
+
 static gboolean
 gst_x_image_sink_xwindow_decorate (GstXImageSink * ximagesink,
     GstXWindow * window)
@@ -724,6 +928,8 @@ gst_x_image_sink_event_thread (GstXImageSink * ximagesink)
     if (ximagesink->xwindow) {
       gst_x_image_sink_handle_xevents (ximagesink);
     }
+    /* release the images that were put while no new frames arrive */
+    gst_x_image_sink_process_completions (ximagesink);
     /* FIXME: do we want to align this with the framerate or anything else? */
     g_usleep (G_USEC_PER_SEC / 20);
 
@@ -908,6 +1114,8 @@ gst_x_image_sink_xcontext_get (GstXImageSink * ximagesink)
   if (XShmQueryExtension (xcontext->disp) &&
       gst_x_image_sink_check_xshm_calls (ximagesink, xcontext)) {
     xcontext->use_xshm = TRUE;
+    xcontext->shm_completion =
+        XShmGetEventBase (xcontext->disp) + ShmCompletion;
     GST_DEBUG ("ximagesink is using XShm extension");
   } else
 #endif /* HAVE_XSHM */
@@ -1193,8 +1401,11 @@ gst_x_image_sink_setcaps (GstBaseSink * bsink, GstCaps * caps)
   /* Remember to draw borders for next frame */
   ximagesink->draw_border = TRUE;
 
-  /* create a new internal pool for the new configuration */
-  newpool = gst_x_image_sink_create_pool (ximagesink, caps, info.size, 2);
+  /* create a new internal pool for the new configuration, deep enough for
+   * the frames the X server is reading from, the one waiting to be put and
+   * the one being copied */
+  newpool = gst_x_image_sink_create_pool (ximagesink, caps, info.size,
+      ximagesink->max_pending + 2);
 
   /* we don't activate the internal pool yet as it may not be needed */
   oldpool = ximagesink->pool;
@@ -1264,6 +1475,7 @@ gst_x_image_sink_change_state (GstElement * element, GstStateChange transition)
       XSynchronize (ximagesink->xcontext->disp, ximagesink->synchronous);
       g_mutex_unlock (&ximagesink->x_lock);
       gst_x_image_sink_manage_event_thread (ximagesink);
+      gst_x_image_sink_start_present_thread (ximagesink);
       break;
     case GST_STATE_CHANGE_READY_TO_PAUSED:
       g_mutex_lock (&ximagesink->flow_lock);
@@ -1283,6 +1495,10 @@ gst_x_image_sink_change_state (GstElement * element, GstStateChange transition)
     case GST_STATE_CHANGE_PLAYING_TO_PAUSED:
       break;
     case GST_STATE_CHANGE_PAUSED_TO_READY:
+      /* the last frame is put before the pool is deactivated */
+      g_mutex_lock (&ximagesink->present_lock);
+      gst_x_image_sink_present_wait (ximagesink);
+      g_mutex_unlock (&ximagesink->present_lock);
       ximagesink->fps_n = 0;
       ximagesink->fps_d = 1;
       GST_VIDEO_SINK_WIDTH (ximagesink) = 0;
@@ -1384,8 +1600,16 @@ gst_x_image_sink_show_frame (GstVideoSink * vsink, GstBuffer * buf)
     gst_video_frame_unmap (&src);
   }
 
-  if (!gst_x_image_sink_ximage_put (ximagesink, to_put))
+  /* the frame is put by the presentation thread, we only check that there
+   * is a window to put it into */
+  g_mutex_lock (&ximagesink->flow_lock);
+  if (G_UNLIKELY (ximagesink->xwindow == NULL)) {
+    g_mutex_unlock (&ximagesink->flow_lock);
     goto no_window;
+  }
+  g_mutex_unlock (&ximagesink->flow_lock);
+
+  gst_x_image_sink_present (ximagesink, to_put);
 
 done:
   if (to_put != buf)
@@ -1485,8 +1709,10 @@ gst_x_image_sink_propose_allocation (GstBaseSink * bsink, GstQuery * query)
       goto no_pool;
   }
 
-  /* we need at least 2 buffer because we hold on to the last one */
-  gst_query_add_allocation_pool (query, pool, size, 2, 0);
+  /* we need at least 2 buffer because we hold on to the last one, and one
+   * more for each frame the X server may still be reading from */
+  gst_query_add_allocation_pool (query, pool, size,
+      ximagesink->max_pending + 2, 0);
   if (pool)
     gst_object_unref (pool);
 
@@ -1757,6 +1983,16 @@ gst_x_image_sink_set_property (GObject * object, guint prop_id,
       ximagesink->handle_expose = g_value_get_boolean (value);
       gst_x_image_sink_manage_event_thread (ximagesink);
       break;
+    case PROP_MAX_PENDING_FRAMES:
+      GST_OBJECT_LOCK (ximagesink);
+      ximagesink->max_pending = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (ximagesink);
+      break;
+    case PROP_DROP_FRAMES:
+      GST_OBJECT_LOCK (ximagesink);
+      ximagesink->drop_frames = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (ximagesink);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1805,6 +2041,32 @@ gst_x_image_sink_get_property (GObject * object, guint prop_id,
       else
         g_value_set_uint64 (value, 0);
       break;
+    case PROP_MAX_PENDING_FRAMES:
+      GST_OBJECT_LOCK (ximagesink);
+      g_value_set_uint (value, ximagesink->max_pending);
+      GST_OBJECT_UNLOCK (ximagesink);
+      break;
+    case PROP_DROP_FRAMES:
+      GST_OBJECT_LOCK (ximagesink);
+      g_value_set_boolean (value, ximagesink->drop_frames);
+      GST_OBJECT_UNLOCK (ximagesink);
+      break;
+    case PROP_PRESENT_STATS:{
+      guint n_pending;
+
+      g_mutex_lock (&ximagesink->x_lock);
+      n_pending = ximagesink->pending.length;
+      g_mutex_unlock (&ximagesink->x_lock);
+
+      g_mutex_lock (&ximagesink->present_lock);
+      g_value_take_boxed (value,
+          gst_structure_new ("application/x-present-stats",
+              "presented", G_TYPE_UINT64, ximagesink->presented,
+              "dropped", G_TYPE_UINT64, ximagesink->dropped,
+              "pending", G_TYPE_UINT, n_pending, NULL));
+      g_mutex_unlock (&ximagesink->present_lock);
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1827,6 +2089,10 @@ gst_x_image_sink_reset (GstXImageSink * ximagesink)
   if (thread)
     g_thread_join (thread);
 
+  gst_x_image_sink_stop_present_thread (ximagesink);
+  if (ximagesink->xcontext)
+    gst_x_image_sink_release_pending (ximagesink);
+
   if (ximagesink->cur_image) {
     gst_buffer_unref (ximagesink->cur_image);
     ximagesink->cur_image = NULL;
@@ -1868,6 +2134,8 @@ gst_x_image_sink_finalize (GObject * object)
   }
   g_mutex_clear (&ximagesink->x_lock);
   g_mutex_clear (&ximagesink->flow_lock);
+  g_mutex_clear (&ximagesink->present_lock);
+  g_cond_clear (&ximagesink->present_cond);
 
   g_free (ximagesink->media_title);
 
@@ -1899,6 +2167,17 @@ gst_x_image_sink_init (GstXImageSink * ximagesink)
   ximagesink->keep_aspect = TRUE;
   ximagesink->handle_events = TRUE;
   ximagesink->handle_expose = TRUE;
+
+  ximagesink->present_thread = NULL;
+  g_mutex_init (&ximagesink->present_lock);
+  g_cond_init (&ximagesink->present_cond);
+  ximagesink->present_next = NULL;
+  ximagesink->present_running = FALSE;
+  g_queue_init (&ximagesink->pending);
+  ximagesink->max_pending = DEFAULT_MAX_PENDING_FRAMES;
+  ximagesink->drop_frames = DEFAULT_DROP_FRAMES;
+  ximagesink->presented = 0;
+  ximagesink->dropped = 0;
 }
 
 static void
@@ -1965,6 +2244,51 @@ gst_x_image_sink_class_init (GstXImageSinkClass * klass)
           "Height of the window", 0, G_MAXUINT64, 0,
           G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstXImageSink:max-pending-frames:
+   *
+   * Frames are put by a separate thread without waiting for the X server.
+   * With XShm, this is the maximum number of frames the X server may still
+   * be reading from before that thread waits for their completion events.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_PENDING_FRAMES,
+      g_param_spec_uint ("max-pending-frames", "Max pending frames",
+          "Maximum number of frames the X server may be reading from at "
+          "the same time", 1, 16, DEFAULT_MAX_PENDING_FRAMES,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
+  /**
+   * GstXImageSink:drop-frames:
+   *
+   * When a frame arrives while the previous one was not put yet, replace and
+   * drop the previous one instead of waiting for it to be put.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_DROP_FRAMES,
+      g_param_spec_boolean ("drop-frames", "Drop frames",
+          "Drop a frame that was not put yet when the next one arrives "
+          "instead of waiting", DEFAULT_DROP_FRAMES,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstXImageSink:present-stats:
+   *
+   * Statistics about the frame presentation: the number of frames put on the
+   * window ("presented"), the number of frames dropped with
+   * #GstXImageSink:drop-frames because they were not put yet ("dropped") and
+   * the number of frames the X server may still be reading from ("pending").
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_PRESENT_STATS,
+      g_param_spec_boxed ("present-stats", "Presentation statistics",
+          "Statistics about the frame presentation", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_set_static_metadata (gstelement_class,
       "Video sink", "Sink/Video",
       "A standard X based videosink", "Julien Moutte <julien@moutte.net>");
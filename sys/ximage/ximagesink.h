@@ -81,6 +81,8 @@ typedef struct _GstXImageSinkClass GstXImageSinkClass;
  * @heightmm ratio
  * @use_xshm: used to known wether of not XShm extension is usable or not even
  * if the Extension is present
+ * @shm_completion: the type of the XShm completion events when @use_xshm is
+ * set
  * @caps: the #GstCaps that Display @disp can accept
  *
  * Structure used to store various informations collected/calculated for a
@@ -107,6 +109,7 @@ struct _GstXContext
   GValue *par;                  /* calculated pixel aspect ratio */
 
   gboolean use_xshm;
+  gint shm_completion;
 
   GstCaps *caps;
   GstCaps *last_caps;
@@ -157,6 +160,17 @@ struct _GstXWindow
  * @keep_aspect: used to remember if reverse negotiation scaling should respect
  * aspect ratio
  * @handle_events: used to know if we should handle select XEvents or not
+ * @present_thread: a thread putting the frames queued by the streaming thread
+ * @present_lock: used to protect @present_next and the presentation statistics
+ * @present_cond: signalled when a frame is queued or @present_running is unset
+ * @present_next: the next frame to put. If the previous one was not put yet,
+ * the streaming thread waits for it or, with @drop_frames, replaces it
+ * @present_running: used to inform @present_thread if it should run/shutdown
+ * @pending: the frames put with XShm that the X server may still be reading
+ * from, until their completion event is received. Protected by @x_lock
+ * @max_pending: the maximum number of frames in @pending
+ * @drop_frames: used to know if a frame that was not put yet is dropped when
+ * the next one arrives
  *
  * The #GstXImageSink data structure.
  */
@@ -197,6 +211,19 @@ struct _GstXImageSink
 
   /* stream metadata */
   gchar *media_title;
+
+  /* asynchronous presentation */
+  GThread *present_thread;
+  GMutex present_lock;
+  GCond present_cond;
+  GstBuffer *present_next;
+  gboolean present_running;
+  GQueue pending;
+  guint max_pending;
+  gboolean drop_frames;
+
+  guint64 presented;
+  guint64 dropped;
 };
 
 struct _GstXImageSinkClass
@@ -648,6 +648,7 @@ gst_xvcontext_new (GstXvContextConfig * config, GError ** error)
       (GstMiniObjectFreeFunction) gst_xvcontext_free);
 
   g_mutex_init (&context->lock);
+  g_queue_init (&context->pending);
   context->im_format = 0;
   context->adaptor_nr = -1;
 
@@ -711,6 +712,7 @@ gst_xvcontext_new (GstXvContextConfig * config, GError ** error)
   if (XShmQueryExtension (context->disp) &&
       gst_xvcontext_check_xshm_calls (context)) {
     context->use_xshm = TRUE;
+    context->shm_completion = XShmGetEventBase (context->disp) + ShmCompletion;
     GST_DEBUG ("xvimagesink is using XShm extension");
   } else
 #endif /* HAVE_XSHM */
@@ -807,6 +809,87 @@ gst_xvcontext_set_synchronous (GstXvContext * context, gboolean synchronous)
   g_mutex_unlock (&context->lock);
 }
 
+/* how long we wait for XShm completion events before syncing with the X
+ * server, in milliseconds */
+#define COMPLETION_POLL_TIMEOUT 5
+#define COMPLETION_POLL_COUNT 10
+
+/* Releases the buffers whose XShm completion event was received and returns
+ * the number of buffers the X server may still be reading from */
+guint
+gst_xvcontext_process_completions (GstXvContext * context)
+{
+  GSList *done = NULL;
+  guint n_pending;
+
+  g_mutex_lock (&context->lock);
+#ifdef HAVE_XSHM
+  if (context->use_xshm) {
+    XEvent e;
+
+    while (XCheckTypedEvent (context->disp, context->shm_completion, &e)) {
+      GstBuffer *buffer = g_queue_pop_head (&context->pending);
+
+      if (buffer)
+        done = g_slist_prepend (done, buffer);
+    }
+  }
+#endif /* HAVE_XSHM */
+  n_pending = context->pending.length;
+  g_mutex_unlock (&context->lock);
+
+  /* releasing a buffer can free its memory, which takes the lock */
+  g_slist_free_full (done, (GDestroyNotify) gst_buffer_unref);
+
+  return n_pending;
+}
+
+/* Releases all the buffers put so far, once the X server is done with them.
+ * The pending buffers keep the context alive, this must be called before
+ * dropping the last external reference to it */
+void
+gst_xvcontext_release_pending (GstXvContext * context)
+{
+  GQueue pending = G_QUEUE_INIT;
+  GstBuffer *buffer;
+
+  g_mutex_lock (&context->lock);
+  /* all requests are processed once XSync returns, completion events that
+   * did not arrive by then never will, e.g. when the window was destroyed */
+  XSync (context->disp, FALSE);
+  g_mutex_unlock (&context->lock);
+
+  gst_xvcontext_process_completions (context);
+
+  g_mutex_lock (&context->lock);
+  pending = context->pending;
+  g_queue_init (&context->pending);
+  g_mutex_unlock (&context->lock);
+
+  while ((buffer = g_queue_pop_head (&pending)))
+    gst_buffer_unref (buffer);
+}
+
+/* Waits until the X server is reading from at most @max buffers */
+void
+gst_xvcontext_wait_completions (GstXvContext * context, guint max)
+{
+  GPollFD pfd = { ConnectionNumber (context->disp), G_IO_IN, 0 };
+  guint i;
+
+  for (i = 0; i < COMPLETION_POLL_COUNT; i++) {
+    if (gst_xvcontext_process_completions (context) <= max)
+      return;
+
+    /* the event thread may read our events from the connection, so only
+     * wait a little for it to become readable */
+    g_poll (&pfd, 1, COMPLETION_POLL_TIMEOUT);
+  }
+
+  GST_DEBUG ("no completion events, syncing");
+  gst_xvcontext_release_pending (context);
+}
+
 void
 gst_xvcontext_update_colorbalance (GstXvContext * context,
     GstXvContextConfig * config)
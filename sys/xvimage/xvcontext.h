@@ -110,6 +110,10 @@ struct _GstXvImageFormat
  * @heightmm ratio
  * @use_xshm: used to known wether of not XShm extension is usable or not even
  * if the Extension is present
+ * @shm_completion: the type of the XShm completion events when @use_xshm is
+ * set
+ * @pending: the buffers put with XShm that the X server may still be reading
+ * from, until their completion event is received. Protected by @lock
  * @xv_port_id: the XVideo port ID
  * @im_format: used to store at least a valid format for XShm calls checks
  * @formats_list: list of supported image formats on @xv_port_id
@@ -145,6 +149,8 @@ struct _GstXvContext
   GValue *par;                  /* calculated pixel aspect ratio */
 
   gboolean use_xshm;
+  gint shm_completion;
+  GQueue pending;
 
   XvPortID xv_port_id;
   guint nb_adaptors;
@@ -202,6 +208,11 @@ void            gst_xvcontext_update_colorbalance       (GstXvContext * xvcontex
 void            gst_xvcontext_set_colorimetry           (GstXvContext * xvcontext,
                                                          GstVideoColorimetry *colorimetry);
 
+guint           gst_xvcontext_process_completions       (GstXvContext * xvcontext);
+void            gst_xvcontext_wait_completions          (GstXvContext * xvcontext,
+                                                         guint max);
+void            gst_xvcontext_release_pending           (GstXvContext * xvcontext);
+
 
 typedef struct _GstXWindow GstXWindow;
 
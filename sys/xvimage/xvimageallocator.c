@@ -626,9 +626,12 @@ gst_xwindow_draw_borders (GstXWindow * window, GstVideoRectangle * rect)
   }
 }
 
+/* @buffer is the buffer holding @mem, it is kept alive until the X server is
+ * done reading from @mem */
 void
-gst_xvimage_memory_render (GstXvImageMemory * mem, GstVideoRectangle * src_crop,
-    GstXWindow * window, GstVideoRectangle * dst_crop, gboolean draw_border)
+gst_xvimage_memory_render (GstXvImageMemory * mem, GstBuffer * buffer,
+    GstVideoRectangle * src_crop, GstXWindow * window,
+    GstVideoRectangle * dst_crop, gboolean draw_border)
 {
   GstXvContext *context;
   XvImage *xvimage;
@@ -652,7 +655,8 @@ gst_xvimage_memory_render (GstXvImageMemory * mem, GstVideoRectangle * src_crop,
         window->win,
         window->gc, xvimage,
         src_crop->x, src_crop->y, src_crop->w, src_crop->h,
-        dst_crop->x, dst_crop->y, dst_crop->w, dst_crop->h, FALSE);
+        dst_crop->x, dst_crop->y, dst_crop->w, dst_crop->h, TRUE);
+    g_queue_push_tail (&context->pending, gst_buffer_ref (buffer));
   } else
 #endif /* HAVE_XSHM */
   {
@@ -663,7 +667,7 @@ gst_xvimage_memory_render (GstXvImageMemory * mem, GstVideoRectangle * src_crop,
         src_crop->x, src_crop->y, src_crop->w, src_crop->h,
         dst_crop->x, dst_crop->y, dst_crop->w, dst_crop->h);
   }
-  XSync (context->disp, FALSE);
+  XFlush (context->disp);
 
   g_mutex_unlock (&context->lock);
 }
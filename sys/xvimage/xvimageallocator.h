@@ -60,6 +60,7 @@ gboolean              gst_xvimage_memory_get_crop       (GstXvImageMemory *mem,
                                                          GstVideoRectangle *crop);
 
 void                  gst_xvimage_memory_render         (GstXvImageMemory *mem,
+                                                         GstBuffer *buffer,
                                                          GstVideoRectangle *src_crop,
                                                          GstXWindow *window,
                                                          GstVideoRectangle *dst_crop,
@@ -186,9 +186,15 @@ enum
   PROP_DRAW_BORDERS,
   PROP_WINDOW_WIDTH,
   PROP_WINDOW_HEIGHT,
+  PROP_MAX_PENDING_FRAMES,
+  PROP_DROP_FRAMES,
+  PROP_PRESENT_STATS,
   PROP_LAST
 };
 
+#define DEFAULT_MAX_PENDING_FRAMES 2
+#define DEFAULT_DROP_FRAMES FALSE
+
 /* ============================================================= */
 /*                                                               */
 /*                       Public Methods                          */
@@ -308,13 +314,129 @@ gst_xv_image_sink_xvimage_put (GstXvImageSink * xvimagesink,
     memcpy (&result, &xwindow->render_rect, sizeof (GstVideoRectangle));
   }
 
-  gst_xvimage_memory_render (mem, &src, xwindow, &result, draw_border);
+  gst_xvimage_memory_render (mem, xvimage, &src, xwindow, &result,
+      draw_border);
 
   g_mutex_unlock (&xvimagesink->flow_lock);
 
   return TRUE;
 }
 
+static gpointer
+gst_xv_image_sink_present_thread (GstXvImageSink * xvimagesink)
+{
+  GstBuffer *buffer;
+  guint max_pending;
+
+  g_mutex_lock (&xvimagesink->present_lock);
+  /* the last frame is still put when shutting down */
+  while (xvimagesink->present_running || xvimagesink->present_next) {
+    if (xvimagesink->present_next == NULL) {
+      g_cond_wait (&xvimagesink->present_cond, &xvimagesink->present_lock);
+      continue;
+    }
+
+    buffer = xvimagesink->present_next;
+    xvimagesink->present_next = NULL;
+    /* wake up show_frame() or a state change waiting for a free slot */
+    g_cond_broadcast (&xvimagesink->present_cond);
+    g_mutex_unlock (&xvimagesink->present_lock);
+
+    GST_OBJECT_LOCK (xvimagesink);
+    max_pending = xvimagesink->max_pending;
+    GST_OBJECT_UNLOCK (xvimagesink);
+
+    /* make room for the image we are about to put */
+    gst_xvcontext_wait_completions (xvimagesink->context, max_pending - 1);
+
+    if (gst_xv_image_sink_xvimage_put (xvimagesink, buffer)) {
+      g_mutex_lock (&xvimagesink->present_lock);
+      xvimagesink->presented++;
+      g_mutex_unlock (&xvimagesink->present_lock);
+    } else {
+      GST_WARNING_OBJECT (xvimagesink, "could not output image - no window");
+    }
+    gst_buffer_unref (buffer);
+
+    g_mutex_lock (&xvimagesink->present_lock);
+  }
+  g_mutex_unlock (&xvimagesink->present_lock);
+
+  return NULL;
+}
+
+/* Waits until the presentation thread took the frame waiting to be put */
+static void
+gst_xv_image_sink_present_wait (GstXvImageSink * xvimagesink)
+{
+  while (xvimagesink->present_next && xvimagesink->present_running)
+    g_cond_wait (&xvimagesink->present_cond, &xvimagesink->present_lock);
+}
+
+/* Hands @buffer over to the presentation thread. If the frame before it was
+ * not put yet, waits for it or, with drop-frames, replaces it */
+static void
+gst_xv_image_sink_present (GstXvImageSink * xvimagesink, GstBuffer * buffer)
+{
+  GstBuffer *dropped;
+  gboolean drop_frames;
+
+  GST_OBJECT_LOCK (xvimagesink);
+  drop_frames = xvimagesink->drop_frames;
+  GST_OBJECT_UNLOCK (xvimagesink);
+
+  g_mutex_lock (&xvimagesink->present_lock);
+  if (!drop_frames)
+    gst_xv_image_sink_present_wait (xvimagesink);
+  dropped = xvimagesink->present_next;
+  xvimagesink->present_next = gst_buffer_ref (buffer);
+  if (dropped) {
+    GST_DEBUG_OBJECT (xvimagesink, "dropping frame %p, not put yet", dropped);
+    xvimagesink->dropped++;
+  }
+  g_cond_signal (&xvimagesink->present_cond);
+  g_mutex_unlock (&xvimagesink->present_lock);
+
+  if (dropped)
+    gst_buffer_unref (dropped);
+}
+
+static void
+gst_xv_image_sink_start_present_thread (GstXvImageSink * xvimagesink)
+{
+  g_mutex_lock (&xvimagesink->present_lock);
+  if (!xvimagesink->present_thread) {
+    xvimagesink->presented = 0;
+    xvimagesink->dropped = 0;
+    xvimagesink->present_running = TRUE;
+    xvimagesink->present_thread = g_thread_try_new ("xvimagesink-present",
+        (GThreadFunc) gst_xv_image_sink_present_thread, xvimagesink, NULL);
+  }
+  g_mutex_unlock (&xvimagesink->present_lock);
+}
+
+/* Stops the presentation thread once it put the frame waiting to be put */
+static void
+gst_xv_image_sink_stop_present_thread (GstXvImageSink * xvimagesink)
+{
+  GThread *thread;
+
+  g_mutex_lock (&xvimagesink->present_lock);
+  xvimagesink->present_running = FALSE;
+  thread = xvimagesink->present_thread;
+  xvimagesink->present_thread = NULL;
+  g_cond_broadcast (&xvimagesink->present_cond);
+  g_mutex_unlock (&xvimagesink->present_lock);
+
+  if (thread)
+    g_thread_join (thread);
+
+  /* without a thread nothing puts it */
+  g_mutex_lock (&xvimagesink->present_lock);
+  gst_buffer_replace (&xvimagesink->present_next, NULL);
+  g_mutex_unlock (&xvimagesink->present_lock);
+}
+
 static void
 gst_xv_image_sink_xwindow_set_title (GstXvImageSink * xvimagesink,
     GstXWindow * xwindow, const gchar * media_title)
@@ -582,6 +704,8 @@ gst_xv_image_sink_event_thread (GstXvImageSink * xvimagesink)
     if (xvimagesink->xwindow) {
       gst_xv_image_sink_handle_xevents (xvimagesink);
     }
+    /* release the images that were put while no new frames arrive */
+    gst_xvcontext_process_completions (xvimagesink->context);
     /* FIXME: do we want to align this with the framerate or anything else? */
     g_usleep (G_USEC_PER_SEC / 20);
 
@@ -807,7 +931,10 @@ gst_xv_image_sink_setcaps (GstBaseSink * bsink, GstCaps * caps)
   xvimagesink->redraw_border = TRUE;
 
   /* create a new pool for the new configuration */
-  newpool = gst_xv_image_sink_create_pool (xvimagesink, caps, info.size, 2);
+  /* deep enough for the frames the X server is reading from, the one waiting
+   * to be put and the one being copied */
+  newpool = gst_xv_image_sink_create_pool (xvimagesink, caps, info.size,
+      xvimagesink->max_pending + 2);
 
   /* we don't activate the internal pool yet as it may not be needed */
   oldpool = xvimagesink->pool;
@@ -877,6 +1004,10 @@ gst_xv_image_sink_change_state (GstElement * element, GstStateChange transition)
     case GST_STATE_CHANGE_PLAYING_TO_PAUSED:
       break;
     case GST_STATE_CHANGE_PAUSED_TO_READY:
+      /* the last frame is put before the pool is deactivated */
+      g_mutex_lock (&xvimagesink->present_lock);
+      gst_xv_image_sink_present_wait (xvimagesink);
+      g_mutex_unlock (&xvimagesink->present_lock);
       xvimagesink->fps_n = 0;
       xvimagesink->fps_d = 1;
       GST_VIDEO_SINK_WIDTH (xvimagesink) = 0;
@@ -980,8 +1111,16 @@ gst_xv_image_sink_show_frame (GstVideoSink * vsink, GstBuffer * buf)
     gst_video_frame_unmap (&src);
   }
 
-  if (!gst_xv_image_sink_xvimage_put (xvimagesink, to_put))
+  /* the frame is put by the presentation thread, we only check that there
+   * is a window to put it into */
+  g_mutex_lock (&xvimagesink->flow_lock);
+  if (G_UNLIKELY (xvimagesink->xwindow == NULL)) {
+    g_mutex_unlock (&xvimagesink->flow_lock);
     goto no_window;
+  }
+  g_mutex_unlock (&xvimagesink->flow_lock);
+
+  gst_xv_image_sink_present (xvimagesink, to_put);
 
 done:
   if (to_put != buf)
@@ -1083,7 +1222,8 @@ gst_xv_image_sink_propose_allocation (GstBaseSink * bsink, GstQuery * query)
   }
 
   /* we need at least 2 buffer because we hold on to the last one */
-  gst_query_add_allocation_pool (query, pool, size, 2, 0);
+  gst_query_add_allocation_pool (query, pool, size,
+      xvimagesink->max_pending + 2, 0);
   if (pool)
     gst_object_unref (pool);
 
@@ -1637,6 +1777,16 @@ gst_xv_image_sink_set_property (GObject * object, guint prop_id,
     case PROP_DRAW_BORDERS:
       xvimagesink->draw_borders = g_value_get_boolean (value);
       break;
+    case PROP_MAX_PENDING_FRAMES:
+      GST_OBJECT_LOCK (xvimagesink);
+      xvimagesink->max_pending = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (xvimagesink);
+      break;
+    case PROP_DROP_FRAMES:
+      GST_OBJECT_LOCK (xvimagesink);
+      xvimagesink->drop_frames = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (xvimagesink);
+      break;
     default:
       if (!gst_video_overlay_set_property (object, PROP_LAST, prop_id, value))
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -1727,6 +1877,34 @@ gst_xv_image_sink_get_property (GObject * object, guint prop_id,
       else
         g_value_set_uint64 (value, 0);
       break;
+    case PROP_MAX_PENDING_FRAMES:
+      GST_OBJECT_LOCK (xvimagesink);
+      g_value_set_uint (value, xvimagesink->max_pending);
+      GST_OBJECT_UNLOCK (xvimagesink);
+      break;
+    case PROP_DROP_FRAMES:
+      GST_OBJECT_LOCK (xvimagesink);
+      g_value_set_boolean (value, xvimagesink->drop_frames);
+      GST_OBJECT_UNLOCK (xvimagesink);
+      break;
+    case PROP_PRESENT_STATS:{
+      guint n_pending = 0;
+
+      if (xvimagesink->context) {
+        g_mutex_lock (&xvimagesink->context->lock);
+        n_pending = xvimagesink->context->pending.length;
+        g_mutex_unlock (&xvimagesink->context->lock);
+      }
+
+      g_mutex_lock (&xvimagesink->present_lock);
+      g_value_take_boxed (value,
+          gst_structure_new ("application/x-present-stats",
+              "presented", G_TYPE_UINT64, xvimagesink->presented,
+              "dropped", G_TYPE_UINT64, xvimagesink->dropped,
+              "pending", G_TYPE_UINT, n_pending, NULL));
+      g_mutex_unlock (&xvimagesink->present_lock);
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1763,6 +1941,7 @@ gst_xv_image_sink_open (GstXvImageSink * xvimagesink)
       xvimagesink->synchronous);
   gst_xv_image_sink_update_colorbalance (xvimagesink);
   gst_xv_image_sink_manage_event_thread (xvimagesink);
+  gst_xv_image_sink_start_present_thread (xvimagesink);
 
   return TRUE;
 
@@ -1793,6 +1972,10 @@ gst_xv_image_sink_close (GstXvImageSink * xvimagesink)
   if (thread)
     g_thread_join (thread);
 
+  gst_xv_image_sink_stop_present_thread (xvimagesink);
+  if (xvimagesink->context)
+    gst_xvcontext_release_pending (xvimagesink->context);
+
   if (xvimagesink->cur_image) {
     gst_buffer_unref (xvimagesink->cur_image);
     xvimagesink->cur_image = NULL;
@@ -1846,6 +2029,8 @@ gst_xv_image_sink_finalize (GObject * object)
     xvimagesink->par = NULL;
   }
   g_mutex_clear (&xvimagesink->flow_lock);
+  g_mutex_clear (&xvimagesink->present_lock);
+  g_cond_clear (&xvimagesink->present_cond);
   g_free (xvimagesink->media_title);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
@@ -1887,6 +2072,16 @@ gst_xv_image_sink_init (GstXvImageSink * xvimagesink)
   xvimagesink->handle_expose = TRUE;
 
   xvimagesink->draw_borders = TRUE;
+
+  xvimagesink->present_thread = NULL;
+  g_mutex_init (&xvimagesink->present_lock);
+  g_cond_init (&xvimagesink->present_cond);
+  xvimagesink->present_next = NULL;
+  xvimagesink->present_running = FALSE;
+  xvimagesink->max_pending = DEFAULT_MAX_PENDING_FRAMES;
+  xvimagesink->drop_frames = DEFAULT_DROP_FRAMES;
+  xvimagesink->presented = 0;
+  xvimagesink->dropped = 0;
 }
 
 static void
@@ -2023,6 +2218,51 @@ gst_xv_image_sink_class_init (GstXvImageSinkClass * klass)
           "Height of the window", 0, G_MAXUINT64, 0,
           G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstXvImageSink:max-pending-frames:
+   *
+   * Frames are put by a separate thread without waiting for the X server.
+   * With XShm, this is the maximum number of frames the X server may still
+   * be reading from before that thread waits for their completion events.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_PENDING_FRAMES,
+      g_param_spec_uint ("max-pending-frames", "Max pending frames",
+          "Maximum number of frames the X server may be reading from at "
+          "the same time", 1, 16, DEFAULT_MAX_PENDING_FRAMES,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
+  /**
+   * GstXvImageSink:drop-frames:
+   *
+   * When a frame arrives while the previous one was not put yet, replace and
+   * drop the previous one instead of waiting for it to be put.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_DROP_FRAMES,
+      g_param_spec_boolean ("drop-frames", "Drop frames",
+          "Drop a frame that was not put yet when the next one arrives "
+          "instead of waiting", DEFAULT_DROP_FRAMES,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstXvImageSink:present-stats:
+   *
+   * Statistics about the frame presentation: the number of frames put on the
+   * window ("presented"), the number of frames dropped with
+   * #GstXvImageSink:drop-frames because they were not put yet ("dropped") and
+   * the number of frames the X server may still be reading from ("pending").
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_PRESENT_STATS,
+      g_param_spec_boxed ("present-stats", "Presentation statistics",
+          "Statistics about the frame presentation", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   gobject_class->finalize = gst_xv_image_sink_finalize;
 
   gst_element_class_set_static_metadata (gstelement_class,
@@ -75,6 +75,15 @@ typedef struct _GstXvImageSinkClass GstXvImageSinkClass;
  * @cb_changed: used to store if the color balance settings where changed
  * @video_width: the width of incoming video frames in pixels
  * @video_height: the height of incoming video frames in pixels
+ * @present_thread: a thread putting the frames queued by the streaming thread
+ * @present_lock: used to protect @present_next and the presentation statistics
+ * @present_cond: signalled when a frame is queued or @present_running is unset
+ * @present_next: the next frame to put. If the previous one was not put yet,
+ * the streaming thread waits for it or, with @drop_frames, replaces it
+ * @present_running: used to inform @present_thread if it should run/shutdown
+ * @max_pending: the maximum number of frames the X server may be reading from
+ * @drop_frames: used to know if a frame that was not put yet is dropped when
+ * the next one arrives
  *
  * The #GstXvImageSink data structure.
  */
@@ -124,6 +133,18 @@ struct _GstXvImageSink
   /* saved render rectangle until we have a window */
   gboolean pending_render_rect;
   GstVideoRectangle render_rect;
+
+  /* asynchronous presentation */
+  GThread *present_thread;
+  GMutex present_lock;
+  GCond present_cond;
+  GstBuffer *present_next;
+  gboolean present_running;
+  guint max_pending;
+  gboolean drop_frames;
+
+  guint64 presented;
+  guint64 dropped;
 };
 
 struct _GstXvImageSinkClass
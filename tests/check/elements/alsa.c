@@ -0,0 +1,132 @@
+/* GStreamer
+ *
+ * unit test for the alsasink and alsasrc statistics
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+
+#define NUM_BUFFERS 20
+
+#define CAPS "audio/x-raw,format=S16LE,layout=interleaved,rate=44100,channels=2"
+
+static void
+check_alsa_stats (GstElement * element)
+{
+  GstStructure *stats = NULL;
+  guint64 xruns;
+
+  g_object_get (element, "alsa-stats", &stats, NULL);
+  fail_unless (stats != NULL);
+  GST_INFO_OBJECT (element, "%" GST_PTR_FORMAT, stats);
+  fail_unless (gst_structure_get_uint64 (stats, "xruns", &xruns));
+  fail_unless (gst_structure_has_field_typed (stats, "suspends",
+          G_TYPE_UINT64));
+  fail_unless (gst_structure_has_field_typed (stats, "delay", G_TYPE_UINT64));
+  gst_structure_free (stats);
+}
+
+/* Runs @desc, which has an ALSA element named "alsa" using the null device,
+ * until EOS and checks its statistics. */
+static void
+run_alsa_pipeline (const gchar * desc)
+{
+  GstElement *pipeline, *alsa;
+  GError *error = NULL;
+  GstMessage *msg;
+
+  pipeline = gst_parse_launch (desc, &error);
+  if (error != NULL) {
+    g_printerr ("Skipping ALSA test: %s\n", error->message);
+    g_clear_error (&error);
+    if (pipeline)
+      gst_object_unref (pipeline);
+    return;
+  }
+
+  alsa = gst_bin_get_by_name (GST_BIN (pipeline), "alsa");
+  g_object_set (alsa, "device", "null", NULL);
+
+  /* available before the device is opened */
+  check_alsa_stats (alsa);
+
+  if (gst_element_set_state (alsa, GST_STATE_READY) ==
+      GST_STATE_CHANGE_FAILURE) {
+    g_printerr ("Skipping ALSA test, can't open the null device\n");
+    gst_element_set_state (pipeline, GST_STATE_NULL);
+    gst_object_unref (alsa);
+    gst_object_unref (pipeline);
+    return;
+  }
+
+  fail_if (gst_element_set_state (pipeline,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE);
+  msg = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipeline),
+      GST_CLOCK_TIME_NONE, GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (msg), GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+
+  check_alsa_stats (alsa);
+
+  fail_unless_equals_int (gst_element_set_state (pipeline, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+
+  gst_object_unref (alsa);
+  gst_object_unref (pipeline);
+}
+
+GST_START_TEST (test_alsasink_stats)
+{
+  gchar *desc;
+
+  desc = g_strdup_printf ("audiotestsrc num-buffers=%d ! " CAPS
+      " ! alsasink name=alsa sync=false", NUM_BUFFERS);
+  run_alsa_pipeline (desc);
+  g_free (desc);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_alsasrc_stats)
+{
+  gchar *desc;
+
+  desc = g_strdup_printf ("alsasrc name=alsa num-buffers=%d ! " CAPS
+      " ! fakesink", NUM_BUFFERS);
+  run_alsa_pipeline (desc);
+  g_free (desc);
+}
+
+GST_END_TEST;
+
+static Suite *
+alsa_suite (void)
+{
+  Suite *s = suite_create ("alsa");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_alsasink_stats);
+  tcase_add_test (tc_chain, test_alsasrc_stats);
+
+  return s;
+}
+
+GST_CHECK_MAIN (alsa)
@@ -1985,6 +1985,164 @@ GST_START_TEST (test_change_output_caps_mid_output_buffer)
 }
 
 GST_END_TEST;
+
+static GstBuffer *
+new_s16_buffer (gint num_samples, gint16 value, GstClockTime ts,
+    GstClockTime dur)
+{
+  GstMapInfo map;
+  GstBuffer *buffer = gst_buffer_new_and_alloc (num_samples * 2);
+  gint16 *data;
+  gint i;
+
+  gst_buffer_map (buffer, &map, GST_MAP_WRITE);
+  data = (gint16 *) map.data;
+  for (i = 0; i < num_samples; i++)
+    data[i] = value;
+  gst_buffer_unmap (buffer, &map);
+  GST_BUFFER_TIMESTAMP (buffer) = ts;
+  GST_BUFFER_DURATION (buffer) = dur;
+  return buffer;
+}
+
+static void
+check_s16_buffers (GList * buffers, gint16 value)
+{
+  GstMapInfo map;
+  GList *l;
+  gint i;
+
+  fail_unless_equals_int (g_list_length (buffers), 2);
+  for (l = buffers; l; l = l->next) {
+    gst_buffer_map (l->data, &map, GST_MAP_READ);
+    fail_unless_equals_int (map.size, 1000);
+    for (i = 0; i < map.size / 2; i++)
+      fail_unless_equals_int (((gint16 *) map.data)[i], value);
+    gst_buffer_unmap (l->data, &map);
+  }
+}
+
+static void
+add_collecting_sink (GstElement * bin, GstElement * audiomixer,
+    const gchar * padname, GList ** buffers)
+{
+  GstElement *sink;
+  GstPad *srcpad, *sinkpad;
+
+  sink = gst_element_factory_make ("fakesink", NULL);
+  g_object_set (sink, "signal-handoffs", TRUE, NULL);
+  g_signal_connect (sink, "handoff", (GCallback) handoff_buffer_collect_cb,
+      buffers);
+  gst_bin_add (GST_BIN (bin), sink);
+  gst_element_sync_state_with_parent (sink);
+
+  srcpad = gst_element_get_request_pad (audiomixer, padname);
+  fail_unless (srcpad != NULL);
+  sinkpad = gst_element_get_static_pad (sink, "sink");
+  fail_unless (gst_pad_link (srcpad, sinkpad) == GST_PAD_LINK_OK);
+  gst_object_unref (sinkpad);
+  gst_object_unref (srcpad);
+}
+
+/* the mix-minus pads get everything but their own sink pad, and clamping is
+ * only done at the end so the minus outputs are not affected by the sum
+ * being clamped */
+GST_START_TEST (test_mix_minus)
+{
+  GstSegment segment;
+  GstElement *bin, *audiomixer, *sink;
+  GstBus *bus;
+  GstPad *sinkpad1, *sinkpad2;
+  GstCaps *caps;
+  GstEvent *event;
+  gchar *name;
+  GList *received_buffers = NULL;
+  GList *minus1_buffers = NULL;
+  GList *minus2_buffers = NULL;
+
+  bin = gst_pipeline_new ("pipeline");
+  bus = gst_element_get_bus (bin);
+  gst_bus_add_signal_watch_full (bus, G_PRIORITY_HIGH);
+
+  g_signal_connect (bus, "message::error", (GCallback) message_received, bin);
+  g_signal_connect (bus, "message::warning", (GCallback) message_received, bin);
+  g_signal_connect (bus, "message::eos", (GCallback) message_received, bin);
+
+  audiomixer = gst_element_factory_make ("audiomixer", "audiomixer");
+  g_object_set (audiomixer, "output-buffer-duration", 500 * GST_MSECOND, NULL);
+  sink = gst_element_factory_make ("fakesink", "sink");
+  g_object_set (sink, "signal-handoffs", TRUE, NULL);
+  g_signal_connect (sink, "handoff", (GCallback) handoff_buffer_collect_cb,
+      &received_buffers);
+  gst_bin_add_many (GST_BIN (bin), audiomixer, sink, NULL);
+  fail_unless (gst_element_link (audiomixer, sink));
+
+  ck_assert_int_ne (gst_element_set_state (bin, GST_STATE_PAUSED),
+      GST_STATE_CHANGE_FAILURE);
+
+  /* mix-minus pads need their sink pad */
+  fail_unless (gst_element_get_request_pad (audiomixer, "minus_0") == NULL);
+
+  sinkpad1 = gst_element_get_request_pad (audiomixer, "sink_%u");
+  sinkpad2 = gst_element_get_request_pad (audiomixer, "sink_%u");
+
+  name = g_strdup_printf ("minus_%s", GST_PAD_NAME (sinkpad1) + 5);
+  add_collecting_sink (bin, audiomixer, name, &minus1_buffers);
+  g_free (name);
+  name = g_strdup_printf ("minus_%s", GST_PAD_NAME (sinkpad2) + 5);
+  add_collecting_sink (bin, audiomixer, name, &minus2_buffers);
+  g_free (name);
+
+  gst_pad_send_event (sinkpad1, gst_event_new_stream_start ("test1"));
+  gst_pad_send_event (sinkpad2, gst_event_new_stream_start ("test2"));
+
+  caps = gst_caps_new_simple ("audio/x-raw",
+      "format", G_TYPE_STRING, GST_AUDIO_NE (S16),
+      "layout", G_TYPE_STRING, "interleaved",
+      "rate", G_TYPE_INT, 1000, "channels", G_TYPE_INT, 1, NULL);
+  gst_pad_send_event (sinkpad1, gst_event_new_caps (caps));
+  gst_pad_send_event (sinkpad2, gst_event_new_caps (caps));
+  gst_caps_unref (caps);
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  event = gst_event_new_segment (&segment);
+  gst_pad_send_event (sinkpad1, gst_event_ref (event));
+  gst_pad_send_event (sinkpad2, event);
+
+  g_idle_add ((GSourceFunc) set_playing, bin);
+
+  fail_unless_equals_int (gst_pad_chain (sinkpad1, new_s16_buffer (1000,
+              30000, 0, GST_SECOND)), GST_FLOW_OK);
+  gst_pad_send_event (sinkpad1, gst_event_new_eos ());
+  fail_unless_equals_int (gst_pad_chain (sinkpad2, new_s16_buffer (1000,
+              10000, 0, GST_SECOND)), GST_FLOW_OK);
+  gst_pad_send_event (sinkpad2, gst_event_new_eos ());
+
+  g_main_loop_run (main_loop);
+
+  check_s16_buffers (received_buffers, G_MAXINT16);
+  check_s16_buffers (minus1_buffers, 10000);
+  check_s16_buffers (minus2_buffers, 30000);
+
+  g_list_free_full (received_buffers, (GDestroyNotify) gst_buffer_unref);
+  g_list_free_full (minus1_buffers, (GDestroyNotify) gst_buffer_unref);
+  g_list_free_full (minus2_buffers, (GDestroyNotify) gst_buffer_unref);
+
+  /* releasing a sink pad also removes its mix-minus pad */
+  gst_element_set_state (bin, GST_STATE_NULL);
+  gst_element_release_request_pad (audiomixer, sinkpad1);
+  gst_object_unref (sinkpad1);
+  gst_element_release_request_pad (audiomixer, sinkpad2);
+  gst_object_unref (sinkpad2);
+  fail_unless_equals_int (GST_ELEMENT (audiomixer)->numsrcpads, 1);
+
+  gst_bus_remove_signal_watch (bus);
+  gst_object_unref (bus);
+  gst_object_unref (bin);
+}
+
+GST_END_TEST;
+
 static Suite *
 audiomixer_suite (void)
 {
@@ -2013,6 +2171,7 @@ audiomixer_suite (void)
   tcase_add_checked_fixture (tc_chain, test_setup, test_teardown);
   tcase_add_test (tc_chain, test_change_output_caps);
   tcase_add_test (tc_chain, test_change_output_caps_mid_output_buffer);
+  tcase_add_test (tc_chain, test_mix_minus);
 
   /* Use a longer timeout */
 #ifdef HAVE_VALGRIND
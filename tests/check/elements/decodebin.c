@@ -19,10 +19,16 @@
  * Boston, MA 02110-1301, USA.
  */
 
+/* FIXME 0.11: suppress warnings for deprecated API such as GValueArray
+ * with newer GLib versions (>= 2.31.0) */
+#define GLIB_DISABLE_DEPRECATION_WARNINGS
+
 #ifdef HAVE_CONFIG_H
 # include <config.h>
 #endif
 
+#include <string.h>
+
 #include <gst/check/gstcheck.h>
 #include <gst/base/gstbaseparse.h>
 
@@ -709,6 +715,121 @@ GST_START_TEST (test_buffering_aggregation)
 
 GST_END_TEST;
 
+static gboolean
+factories_contain (GValueArray * factories, const gchar * name)
+{
+  guint i;
+
+  for (i = 0; i < factories->n_values; i++) {
+    GstPluginFeature *feature =
+        g_value_get_object (g_value_array_get_nth (factories, i));
+
+    if (strcmp (gst_plugin_feature_get_name (feature), name) == 0)
+      return TRUE;
+  }
+  return FALSE;
+}
+
+static void
+get_factory_cache_stats (GstElement * dec, guint64 * hits, guint64 * misses,
+    guint64 * rebuilds)
+{
+  GstStructure *stats = NULL;
+
+  g_object_get (dec, "factory-cache-stats", &stats, NULL);
+  fail_unless (stats != NULL);
+  fail_unless (gst_structure_get_uint64 (stats, "hits", hits));
+  fail_unless (gst_structure_get_uint64 (stats, "misses", misses));
+  fail_unless (gst_structure_get_uint64 (stats, "rebuilds", rebuilds));
+  gst_structure_free (stats);
+}
+
+GST_START_TEST (test_autoplug_factories_cache)
+{
+  GstElement *dec1, *dec2;
+  GValueArray *factories1, *factories2;
+  guint64 hits, misses, rebuilds;
+  guint64 hits2, misses2, rebuilds2;
+  GstCaps *caps;
+  GTimer *timer;
+  gdouble elapsed;
+  guint i, n = 0;
+
+/* set to something larger to do benchmarks */
+#define TIME 0.01
+
+  dec1 = gst_element_factory_make ("decodebin", NULL);
+  fail_unless (dec1 != NULL);
+  dec2 = gst_element_factory_make ("decodebin", NULL);
+  fail_unless (dec2 != NULL);
+
+  caps = gst_caps_from_string ("video/x-h264, stream-format=byte-stream, "
+      "alignment=au");
+
+  /* the results are shared between instances, the second lookup neither
+   * walks the registry nor filters the factories again */
+  g_signal_emit_by_name (dec1, "autoplug-factories", NULL, caps, &factories1);
+  get_factory_cache_stats (dec1, &hits, &misses, &rebuilds);
+  fail_unless (rebuilds >= 1);
+  g_signal_emit_by_name (dec2, "autoplug-factories", NULL, caps, &factories2);
+  get_factory_cache_stats (dec2, &hits2, &misses2, &rebuilds2);
+  fail_unless_equals_uint64 (hits2, hits + 1);
+  fail_unless_equals_uint64 (misses2, misses);
+  fail_unless_equals_uint64 (rebuilds2, rebuilds);
+  fail_unless_equals_int (factories1->n_values, factories2->n_values);
+  for (i = 0; i < factories1->n_values; i++) {
+    fail_unless (g_value_get_object (g_value_array_get_nth (factories1, i)) ==
+        g_value_get_object (g_value_array_get_nth (factories2, i)));
+  }
+  g_value_array_free (factories1);
+  g_value_array_free (factories2);
+
+  /* registering new features changes the registry cookie, which invalidates
+   * the lists and the cached results */
+  gst_element_register (NULL, "fakeh264parse", GST_RANK_PRIMARY + 101,
+      gst_fake_h264_parser_get_type ());
+  gst_element_register (NULL, "fakeh264dec", GST_RANK_PRIMARY + 100,
+      gst_fake_h264_decoder_get_type ());
+  /* a name no other test registered, so the cookie changes in any case */
+  gst_element_register (NULL, "factorycachetestdec", GST_RANK_PRIMARY + 99,
+      gst_fake_h264_decoder_get_type ());
+  get_factory_cache_stats (dec2, &hits, &misses, &rebuilds);
+  g_signal_emit_by_name (dec2, "autoplug-factories", NULL, caps, &factories2);
+  get_factory_cache_stats (dec2, &hits2, &misses2, &rebuilds2);
+  fail_unless_equals_uint64 (rebuilds2, rebuilds + 1);
+  fail_unless_equals_uint64 (misses2, misses + 1);
+  fail_unless_equals_uint64 (hits2, hits);
+  fail_unless (factories_contain (factories2, "fakeh264parse"));
+  fail_unless (factories_contain (factories2, "fakeh264dec"));
+  fail_unless (factories_contain (factories2, "factorycachetestdec"));
+  g_value_array_free (factories2);
+
+  gst_object_unref (dec1);
+  gst_object_unref (dec2);
+
+  /* what every new decodebin does when it gets a stream */
+  timer = g_timer_new ();
+  do {
+    GstElement *dec = gst_element_factory_make ("decodebin", NULL);
+
+    g_signal_emit_by_name (dec, "autoplug-factories", NULL, caps, &factories1);
+    fail_unless (factories1->n_values > 0);
+    g_value_array_free (factories1);
+    gst_object_unref (dec);
+    n++;
+    elapsed = g_timer_elapsed (timer, NULL);
+  } while (elapsed < TIME);
+
+  GST_DEBUG ("%f decodebin instances/sec", n / elapsed);
+
+  g_timer_destroy (timer);
+  gst_caps_unref (caps);
+
+#undef TIME
+}
+
+GST_END_TEST;
+
 static Suite *
 decodebin_suite (void)
 {
@@ -721,6 +842,7 @@ decodebin_suite (void)
   tcase_add_test (tc_chain, test_mp3_parser_loop);
   tcase_add_test (tc_chain, test_parser_negotiation);
   tcase_add_test (tc_chain, test_buffering_aggregation);
+  tcase_add_test (tc_chain, test_autoplug_factories_cache);
 
   return s;
 }
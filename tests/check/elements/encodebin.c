@@ -24,7 +24,9 @@
 
 #include <gst/pbutils/encoding-profile.h>
 #include <gst/pbutils/missing-plugins.h>
+#include <gst/base/gstbasetransform.h>
 #include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
 
 /* Helper functions to create profiles */
 
@@ -1114,6 +1116,391 @@ GST_START_TEST (test_encodebin_fallback_profiles_on_failure)
 
 GST_END_TEST;
 
+static GstEncodingProfile *
+create_ogg_theora_renditions_profile (void)
+{
+  static const gint heights[] = { 120, 240, 60 };
+  GstEncodingContainerProfile *prof;
+  GstCaps *ogg, *theora;
+  guint i;
+
+  ogg = gst_caps_new_empty_simple ("application/ogg");
+  prof =
+      gst_encoding_container_profile_new ((gchar *) "renditions", NULL, ogg,
+      NULL);
+  gst_caps_unref (ogg);
+
+  theora = gst_caps_new_empty_simple ("video/x-theora");
+  for (i = 0; i < G_N_ELEMENTS (heights); i++) {
+    GstCaps *restriction;
+
+    restriction = gst_caps_new_simple ("video/x-raw", "width", G_TYPE_INT,
+        heights[i] * 4 / 3, "height", G_TYPE_INT, heights[i], NULL);
+    fail_unless (gst_encoding_container_profile_add_profile (prof,
+            (GstEncodingProfile *) gst_encoding_video_profile_new (theora,
+                NULL, restriction, 1)));
+    gst_caps_unref (restriction);
+  }
+  gst_caps_unref (theora);
+
+  return (GstEncodingProfile *) prof;
+}
+
+static gint
+_get_pad_height (GstElement * element, const gchar * pad_name)
+{
+  GstPad *pad = gst_element_get_static_pad (element, pad_name);
+  GstCaps *caps = gst_pad_get_current_caps (pad);
+  gint height = 0;
+
+  fail_unless (caps != NULL);
+  fail_unless (gst_structure_get_int (gst_caps_get_structure (caps, 0),
+          "height", &height));
+  gst_caps_unref (caps);
+  gst_object_unref (pad);
+
+  return height;
+}
+
+GST_START_TEST (test_encodebin_render_video_renditions)
+{
+  GstElement *ebin, *pipeline, *videotestsrc, *fakesink;
+  GstIterator *it;
+  GValue item = G_VALUE_INIT;
+  GstBus *bus;
+  gboolean done = FALSE;
+  gboolean seen_60 = FALSE, seen_120 = FALSE, seen_240 = FALSE;
+  guint scaled_240_to_120 = 0, scaled_120_to_60 = 0;
+  GstCaps *caps;
+
+  /* Render three theora renditions from a single input */
+
+  pipeline = gst_pipeline_new ("encodebin-pipeline");
+  bus = gst_pipeline_get_bus ((GstPipeline *) pipeline);
+  videotestsrc = gst_element_factory_make ("videotestsrc", NULL);
+  g_object_set (videotestsrc, "num-buffers", 5, NULL);
+  fakesink = gst_element_factory_make ("fakesink", NULL);
+
+  ebin = gst_element_factory_make ("encodebin", NULL);
+  gst_util_set_object_arg (G_OBJECT (ebin), "flags", "video-renditions");
+  set_profile (ebin, create_ogg_theora_renditions_profile ());
+
+  /* one video input for all the renditions */
+  fail_unless_equals_int (GST_ELEMENT (ebin)->numsinkpads, 1);
+
+  gst_bin_add_many ((GstBin *) pipeline, videotestsrc, ebin, fakesink, NULL);
+
+  /* the input has the size of the biggest rendition */
+  caps = gst_caps_from_string ("video/x-raw, width=320, height=240");
+  fail_unless (gst_element_link_filtered (videotestsrc, ebin, caps));
+  gst_caps_unref (caps);
+  fail_unless (gst_element_link (ebin, fakesink));
+
+  fail_unless_equals_int (gst_element_set_state (pipeline, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_ASYNC);
+
+  while (!done) {
+    GstMessage *msg;
+
+    /* poll the bus until we get EOS without any errors */
+    msg = gst_bus_timed_pop (bus, GST_SECOND / 10);
+    if (msg) {
+      switch (GST_MESSAGE_TYPE (msg)) {
+        case GST_MESSAGE_ERROR:
+          fail ("GST_MESSAGE_ERROR");
+          break;
+        case GST_MESSAGE_EOS:
+          done = TRUE;
+          break;
+        default:
+          break;
+      }
+      gst_message_unref (msg);
+    }
+  }
+
+  /* every encoder got its own size, and each rendition was scaled down from
+   * the next bigger one by its cascade branch: the 240 lines input is only
+   * scaled to 120 and 60 lines once each, all the other scalers pass the
+   * frames through */
+  it = gst_bin_iterate_elements (GST_BIN (ebin));
+  while (gst_iterator_next (it, &item) == GST_ITERATOR_OK) {
+    GstElement *elt = g_value_get_object (&item);
+    GstElementFactory *factory = gst_element_get_factory (elt);
+
+    if (factory && !strcmp (GST_OBJECT_NAME (factory), "theoraenc")) {
+      gint height = _get_pad_height (elt, "sink");
+
+      seen_60 |= height == 60;
+      seen_120 |= height == 120;
+      seen_240 |= height == 240;
+    } else if (factory && !strcmp (GST_OBJECT_NAME (factory), "videoscale")) {
+      gint in_height = _get_pad_height (elt, "sink");
+      gint out_height = _get_pad_height (elt, "src");
+
+      if (in_height == 240 && out_height == 120)
+        scaled_240_to_120++;
+      else if (in_height == 120 && out_height == 60)
+        scaled_120_to_60++;
+      else
+        fail_unless_equals_int (in_height, out_height);
+    }
+    g_value_reset (&item);
+  }
+  g_value_unset (&item);
+  gst_iterator_free (it);
+  fail_unless (seen_60 && seen_120 && seen_240);
+  fail_unless_equals_int (scaled_240_to_120, 1);
+  fail_unless_equals_int (scaled_120_to_60, 1);
+
+  /* Set back to NULL */
+  fail_unless_equals_int (gst_element_set_state (pipeline, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+
+  gst_object_unref (bus);
+
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
+/* Fake H.263 decoder and encoder for the smart encoder. They pass buffers
+ * through, the encoder starts its output with a keyframe after a flush and
+ * counts the frames it recoded */
+#define TEST_H263_CAPS "video/x-h263, variant = (string) itu, " \
+    "width = (int) 64, height = (int) 48, framerate = (fraction) 10/1"
+#define TEST_RAW_CAPS "video/x-raw, format = (string) I420, " \
+    "width = (int) 64, height = (int) 48, framerate = (fraction) 10/1"
+
+typedef GstBaseTransform TestH263Dec;
+typedef GstBaseTransformClass TestH263DecClass;
+
+typedef struct
+{
+  GstBaseTransform parent;
+  gboolean need_keyframe;
+} TestH263Enc;
+typedef GstBaseTransformClass TestH263EncClass;
+
+static GType test_h263_dec_get_type (void);
+static GType test_h263_enc_get_type (void);
+
+G_DEFINE_TYPE (TestH263Dec, test_h263_dec, GST_TYPE_BASE_TRANSFORM);
+G_DEFINE_TYPE (TestH263Enc, test_h263_enc, GST_TYPE_BASE_TRANSFORM);
+
+static gint recoded_frames;
+
+static GstCaps *
+test_h263_transform_caps (GstPadDirection direction, const gchar * in_caps,
+    const gchar * out_caps, GstCaps * filter)
+{
+  GstCaps *caps, *res;
+
+  caps = gst_caps_from_string (direction == GST_PAD_SINK ? out_caps : in_caps);
+  if (filter) {
+    res = gst_caps_intersect_full (filter, caps, GST_CAPS_INTERSECT_FIRST);
+    gst_caps_unref (caps);
+  } else {
+    res = caps;
+  }
+  return res;
+}
+
+static GstCaps *
+test_h263_dec_transform_caps (GstBaseTransform * trans,
+    GstPadDirection direction, GstCaps * caps, GstCaps * filter)
+{
+  return test_h263_transform_caps (direction, TEST_H263_CAPS, TEST_RAW_CAPS,
+      filter);
+}
+
+static GstFlowReturn
+test_h263_dec_transform_ip (GstBaseTransform * trans, GstBuffer * buf)
+{
+  return GST_FLOW_OK;
+}
+
+static void
+test_h263_dec_class_init (TestH263DecClass * klass)
+{
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+
+  gst_element_class_add_pad_template (element_class,
+      gst_pad_template_new ("sink", GST_PAD_SINK, GST_PAD_ALWAYS,
+          gst_caps_from_string (TEST_H263_CAPS)));
+  gst_element_class_add_pad_template (element_class,
+      gst_pad_template_new ("src", GST_PAD_SRC, GST_PAD_ALWAYS,
+          gst_caps_from_string (TEST_RAW_CAPS)));
+  gst_element_class_set_static_metadata (element_class, "Test H.263 decoder",
+      "Codec/Decoder/Video", "Fake H.263 decoder", "Test <test@example.com>");
+
+  klass->transform_caps = test_h263_dec_transform_caps;
+  klass->transform_ip = test_h263_dec_transform_ip;
+}
+
+static void
+test_h263_dec_init (TestH263Dec * dec)
+{
+}
+
+static GstCaps *
+test_h263_enc_transform_caps (GstBaseTransform * trans,
+    GstPadDirection direction, GstCaps * caps, GstCaps * filter)
+{
+  return test_h263_transform_caps (direction, TEST_RAW_CAPS, TEST_H263_CAPS,
+      filter);
+}
+
+static gboolean
+test_h263_enc_sink_event (GstBaseTransform * trans, GstEvent * event)
+{
+  if (GST_EVENT_TYPE (event) == GST_EVENT_FLUSH_STOP)
+    ((TestH263Enc *) trans)->need_keyframe = TRUE;
+
+  return GST_BASE_TRANSFORM_CLASS (test_h263_enc_parent_class)->sink_event
+      (trans, event);
+}
+
+static GstFlowReturn
+test_h263_enc_transform_ip (GstBaseTransform * trans, GstBuffer * buf)
+{
+  TestH263Enc *enc = (TestH263Enc *) trans;
+
+  if (enc->need_keyframe)
+    GST_BUFFER_FLAG_UNSET (buf, GST_BUFFER_FLAG_DELTA_UNIT);
+  else
+    GST_BUFFER_FLAG_SET (buf, GST_BUFFER_FLAG_DELTA_UNIT);
+  enc->need_keyframe = FALSE;
+  g_atomic_int_inc (&recoded_frames);
+
+  return GST_FLOW_OK;
+}
+
+static void
+test_h263_enc_class_init (TestH263EncClass * klass)
+{
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+
+  gst_element_class_add_pad_template (element_class,
+      gst_pad_template_new ("sink", GST_PAD_SINK, GST_PAD_ALWAYS,
+          gst_caps_from_string (TEST_RAW_CAPS)));
+  gst_element_class_add_pad_template (element_class,
+      gst_pad_template_new ("src", GST_PAD_SRC, GST_PAD_ALWAYS,
+          gst_caps_from_string (TEST_H263_CAPS)));
+  gst_element_class_set_static_metadata (element_class, "Test H.263 encoder",
+      "Codec/Encoder/Video", "Fake H.263 encoder", "Test <test@example.com>");
+
+  klass->transform_caps = test_h263_enc_transform_caps;
+  klass->sink_event = test_h263_enc_sink_event;
+  klass->transform_ip = test_h263_enc_transform_ip;
+}
+
+static void
+test_h263_enc_init (TestH263Enc * enc)
+{
+  enc->need_keyframe = TRUE;
+}
+
+#define N_CUTS 20
+#define GOP_SIZE 10
+#define GOPS_PER_CUT 6
+#define FRAME_DURATION (GST_SECOND / 10)
+
+GST_START_TEST (test_encodebin_smart_encoder_many_cuts)
+{
+  GstElement *ebin;
+  GstEncodingProfile *profile;
+  GstHarness *h;
+  GstCaps *caps;
+  GstSegment segment;
+  GstEvent *event;
+  GstBuffer *buf;
+  GTimer *timer;
+  guint cut, i, n;
+
+  fail_unless (gst_element_register (NULL, "testh263dec", GST_RANK_PRIMARY,
+          test_h263_dec_get_type ()));
+  fail_unless (gst_element_register (NULL, "testh263enc", GST_RANK_PRIMARY,
+          test_h263_enc_get_type ()));
+  g_atomic_int_set (&recoded_frames, 0);
+
+  caps = gst_caps_from_string (TEST_H263_CAPS);
+  profile =
+      (GstEncodingProfile *) gst_encoding_video_profile_new (caps, NULL, NULL,
+      0);
+  gst_caps_unref (caps);
+
+  ebin = gst_element_factory_make ("encodebin", NULL);
+  g_object_set (ebin, "profile", profile, "avoid-reencoding", TRUE, NULL);
+  gst_encoding_profile_unref (profile);
+
+  h = gst_harness_new_with_element (ebin, "video_%u", "src");
+  gst_harness_set_src_caps_str (h, TEST_H263_CAPS);
+
+  /* Every cut is a segment starting and ending in the middle of a GOP, so
+   * the first and the last GOP of each need to be recoded */
+  timer = g_timer_new ();
+  for (cut = 0; cut < N_CUTS; cut++) {
+    GstClockTime base = cut * 10 * GST_SECOND;
+
+    gst_segment_init (&segment, GST_FORMAT_TIME);
+    segment.start = base + GST_SECOND / 2;
+    segment.stop = base + (GOPS_PER_CUT - 1) * GST_SECOND + GST_SECOND / 2;
+    segment.time = segment.start;
+    segment.position = segment.start;
+    segment.base = cut * (GOPS_PER_CUT - 1) * GST_SECOND;
+    fail_unless (gst_harness_push_event (h, gst_event_new_segment (&segment)));
+
+    for (i = 0; i < GOPS_PER_CUT * GOP_SIZE; i++) {
+      buf = gst_harness_create_buffer (h, 16);
+      GST_BUFFER_PTS (buf) = GST_BUFFER_DTS (buf) = base + i * FRAME_DURATION;
+      GST_BUFFER_DURATION (buf) = FRAME_DURATION;
+      if (i % GOP_SIZE != 0)
+        GST_BUFFER_FLAG_SET (buf, GST_BUFFER_FLAG_DELTA_UNIT);
+      fail_unless_equals_int (gst_harness_push (h, buf), GST_FLOW_OK);
+    }
+  }
+  fail_unless (gst_harness_push_event (h, gst_event_new_eos ()));
+
+  while ((event = gst_harness_pull_event (h))) {
+    gboolean eos = GST_EVENT_TYPE (event) == GST_EVENT_EOS;
+
+    gst_event_unref (event);
+    if (eos)
+      break;
+  }
+  GST_DEBUG ("rendered %u cuts in %f s", N_CUTS, g_timer_elapsed (timer,
+          NULL));
+  g_timer_destroy (timer);
+
+  fail_unless_equals_int (gst_harness_buffers_received (h),
+      N_CUTS * GOPS_PER_CUT * GOP_SIZE);
+  fail_unless_equals_int (g_atomic_int_get (&recoded_frames),
+      N_CUTS * 2 * GOP_SIZE);
+
+  /* recoded and untouched GOPs are merged back in order */
+  for (n = 0; (buf = gst_harness_try_pull (h)); n++) {
+    cut = n / (GOPS_PER_CUT * GOP_SIZE);
+    i = n % (GOPS_PER_CUT * GOP_SIZE);
+    fail_unless_equals_uint64 (GST_BUFFER_PTS (buf),
+        cut * 10 * GST_SECOND + i * FRAME_DURATION);
+    if (i % GOP_SIZE == 0)
+      fail_if (GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_DELTA_UNIT));
+    gst_buffer_unref (buf);
+  }
+  fail_unless_equals_int (n, N_CUTS * GOPS_PER_CUT * GOP_SIZE);
+
+  gst_harness_teardown (h);
+  gst_object_unref (ebin);
+}
+
+GST_END_TEST;
+
+#undef N_CUTS
+#undef GOP_SIZE
+#undef GOPS_PER_CUT
+#undef FRAME_DURATION
+
 static Suite *
 encodebin_suite (void)
 {
@@ -1141,6 +1528,8 @@ encodebin_suite (void)
   tcase_add_test (tc_chain, test_encodebin_named_requests);
   tcase_add_test (tc_chain, test_encodebin_missing_plugin_messages);
   tcase_add_test (tc_chain, test_encodebin_fallback_profiles_on_failure);
+  tcase_add_test (tc_chain, test_encodebin_smart_encoder_many_cuts);
+  tcase_add_test (tc_chain, test_encodebin_render_video_renditions);
 
   return s;
 }
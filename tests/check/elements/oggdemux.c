@@ -0,0 +1,191 @@
+/* GStreamer unit tests for oggdemux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <gst/check/gstcheck.h>
+
+static void
+pad_added_cb (GstElement * demux, GstPad * pad, GstBin * pipeline)
+{
+  GstElement *sink;
+  GstPad *sinkpad;
+
+  sink = gst_element_factory_make ("fakesink", NULL);
+  g_object_set (sink, "sync", FALSE, NULL);
+  gst_bin_add (pipeline, sink);
+  gst_element_sync_state_with_parent (sink);
+
+  sinkpad = gst_element_get_static_pad (sink, "sink");
+  fail_unless_equals_int (gst_pad_link (pad, sinkpad), GST_PAD_LINK_OK);
+  gst_object_unref (sinkpad);
+}
+
+static GstElement *
+setup_pipeline (GstElement ** demux)
+{
+  GstElement *pipeline, *src;
+  gchar *path;
+
+  pipeline = gst_pipeline_new (NULL);
+  src = gst_element_factory_make ("filesrc", NULL);
+  *demux = gst_element_factory_make ("oggdemux", NULL);
+  fail_unless (src != NULL && *demux != NULL);
+
+  path = g_build_filename (GST_TEST_FILES_PATH, "theora-vorbis.ogg", NULL);
+  g_object_set (src, "location", path, NULL);
+  g_free (path);
+
+  gst_bin_add_many (GST_BIN (pipeline), src, *demux, NULL);
+  fail_unless (gst_element_link (src, *demux));
+  g_signal_connect (*demux, "pad-added", G_CALLBACK (pad_added_cb), pipeline);
+
+  return pipeline;
+}
+
+static const GValue *
+query_seek_index (GstElement * demux, GstStructure ** s)
+{
+  GstQuery *query;
+  GstPad *srcpad;
+  const GValue *times, *offsets;
+  GstIterator *it;
+  GValue item = G_VALUE_INIT;
+
+  it = gst_element_iterate_src_pads (demux);
+  fail_unless_equals_int (gst_iterator_next (it, &item), GST_ITERATOR_OK);
+  srcpad = g_value_get_object (&item);
+
+  query = gst_query_new_custom (GST_QUERY_CUSTOM,
+      gst_structure_new_empty ("GstOggDemuxSeekIndex"));
+  fail_unless (gst_pad_query (srcpad, query));
+  g_value_unset (&item);
+  gst_iterator_free (it);
+
+  *s = gst_structure_copy (gst_query_get_structure (query));
+  gst_query_unref (query);
+
+  times = gst_structure_get_value (*s, "times");
+  offsets = gst_structure_get_value (*s, "offsets");
+  fail_unless (times != NULL && offsets != NULL);
+  fail_unless_equals_int (gst_value_array_get_size (times),
+      gst_value_array_get_size (offsets));
+
+  return times;
+}
+
+static void
+get_seek_stats (GstElement * demux, guint64 * narrowed, guint64 * reads)
+{
+  GstStructure *s;
+
+  query_seek_index (demux, &s);
+  fail_unless (gst_structure_get_uint64 (s, "narrowed-seeks", narrowed));
+  fail_unless (gst_structure_get_uint64 (s, "bisection-reads", reads));
+  gst_structure_free (s);
+}
+
+static void
+seek_and_wait (GstElement * pipeline, GstClockTime position)
+{
+  fail_unless (gst_element_seek_simple (pipeline, GST_FORMAT_TIME,
+          GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_ACCURATE, position));
+  fail_unless_equals_int (gst_element_get_state (pipeline, NULL, NULL,
+          GST_CLOCK_TIME_NONE), GST_STATE_CHANGE_SUCCESS);
+}
+
+GST_START_TEST (test_seek_index)
+{
+  GstElement *pipeline, *demux;
+  GstStructure *s;
+  const GValue *times;
+  gint64 duration;
+  guint i, n_entries;
+  guint64 narrowed, reads, first_reads, prev_narrowed, prev_reads;
+
+  pipeline = setup_pipeline (&demux);
+
+  fail_unless_equals_int (gst_element_set_state (pipeline, GST_STATE_PAUSED),
+      GST_STATE_CHANGE_ASYNC);
+  fail_unless_equals_int (gst_element_get_state (pipeline, NULL, NULL,
+          GST_CLOCK_TIME_NONE), GST_STATE_CHANGE_SUCCESS);
+
+  fail_unless (gst_element_query_duration (pipeline, GST_FORMAT_TIME,
+          &duration));
+  fail_unless (duration > 0);
+
+  get_seek_stats (demux, &prev_narrowed, &prev_reads);
+  seek_and_wait (pipeline, duration / 2);
+  get_seek_stats (demux, &narrowed, &reads);
+  first_reads = reads - prev_reads;
+  fail_unless (first_reads > 0);
+
+  /* the pages read while bisecting are now indexed, sorted by time */
+  times = query_seek_index (demux, &s);
+  n_entries = gst_value_array_get_size (times);
+  fail_unless (n_entries > 0);
+  for (i = 1; i < n_entries; i++) {
+    guint64 prev = g_value_get_uint64 (gst_value_array_get_value (times,
+            i - 1));
+    guint64 cur = g_value_get_uint64 (gst_value_array_get_value (times, i));
+
+    fail_unless (prev <= cur);
+  }
+  gst_structure_free (s);
+
+  /* seeking to the same position again starts from the indexed pages around
+   * it, so the bisection is narrowed and reads fewer pages */
+  prev_narrowed = narrowed;
+  prev_reads = reads;
+  seek_and_wait (pipeline, duration / 2);
+  get_seek_stats (demux, &narrowed, &reads);
+  fail_unless (narrowed > prev_narrowed);
+  fail_unless (reads - prev_reads < first_reads,
+      "%" G_GUINT64_FORMAT " pages read with the index, %" G_GUINT64_FORMAT
+      " without", reads - prev_reads, first_reads);
+
+  /* seeking around the same area does not lose any entry */
+  seek_and_wait (pipeline, duration / 4);
+  seek_and_wait (pipeline, duration / 2);
+
+  times = query_seek_index (demux, &s);
+  fail_unless (gst_value_array_get_size (times) >= n_entries);
+  gst_structure_free (s);
+
+  fail_unless_equals_int (gst_element_set_state (pipeline, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
+static Suite *
+oggdemux_suite (void)
+{
+  Suite *s = suite_create ("oggdemux");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_seek_index);
+
+  return s;
+}
+
+GST_CHECK_MAIN (oggdemux);
@@ -488,6 +488,212 @@ GST_START_TEST (test_opus_decode_plc_timestamps_with_fec)
 
 GST_END_TEST;
 
+static GstPadProbeReturn
+count_lists_probe (GstPad * pad, GstPadProbeInfo * info, guint * n_lists)
+{
+  (*n_lists)++;
+
+  return GST_PAD_PROBE_OK;
+}
+
+static guint *
+add_list_counter (GstElement * element)
+{
+  GstPad *srcpad;
+  guint *n_lists = g_new0 (guint, 1);
+
+  srcpad = gst_element_get_static_pad (element, "src");
+  gst_pad_add_probe (srcpad, GST_PAD_PROBE_TYPE_BUFFER_LIST,
+      (GstPadProbeCallback) count_lists_probe, n_lists, g_free);
+  gst_object_unref (srcpad);
+
+  return n_lists;
+}
+
+static GstBuffer *
+create_silence_buffer (guint n_samples, GstClockTime pts)
+{
+  GstBuffer *buf;
+
+  buf = gst_buffer_new_and_alloc (n_samples * 2);
+  gst_buffer_memset (buf, 0, 0, n_samples * 2);
+  GST_BUFFER_PTS (buf) = pts;
+  GST_BUFFER_DURATION (buf) = gst_util_uint64_scale_int (n_samples,
+      GST_SECOND, 48000);
+
+  return buf;
+}
+
+static GstBufferList *
+pull_all_as_list (GstHarness * h)
+{
+  GstBufferList *list = gst_buffer_list_new ();
+  GstBuffer *buf;
+
+  while ((buf = gst_harness_try_pull (h)))
+    gst_buffer_list_add (list, buf);
+
+  return list;
+}
+
+static void
+check_contiguous_timestamps (GstBufferList * list, GstClockTime start)
+{
+  GstClockTime next = start;
+  guint i;
+
+  for (i = 0; i < gst_buffer_list_length (list); i++) {
+    GstBuffer *buf = gst_buffer_list_get (list, i);
+
+    fail_unless_equals_uint64 (GST_BUFFER_PTS (buf), next);
+    fail_unless (GST_BUFFER_DURATION_IS_VALID (buf));
+    next += GST_BUFFER_DURATION (buf);
+  }
+}
+
+GST_START_TEST (test_opus_encode_batched)
+{
+  GstHarness *h = gst_harness_new_parse ("opusenc frame-size=10 "
+      "batch-frames=4");
+  GstBufferList *list;
+  guint *n_lists;
+
+  n_lists = add_list_counter (h->element);
+  gst_harness_set_src_caps_str (h, AUDIO_CAPS_STRING);
+
+  /* 40 ms of input make one list of 4 packets */
+  fail_unless_equals_int (gst_harness_push (h, create_silence_buffer (1920,
+              0)), GST_FLOW_OK);
+  fail_unless_equals_int (*n_lists, 1);
+
+  list = pull_all_as_list (h);
+  fail_unless_equals_int (gst_buffer_list_length (list), 4);
+  check_contiguous_timestamps (list, 0);
+  gst_buffer_list_unref (list);
+
+  /* batching does not add any latency */
+  fail_unless_equals_uint64 (gst_harness_query_latency (h), 10 * GST_MSECOND);
+
+  /* less than a batch is encoded right away as well */
+  fail_unless_equals_int (gst_harness_push (h, create_silence_buffer (960,
+              40 * GST_MSECOND)), GST_FLOW_OK);
+  fail_unless_equals_int (*n_lists, 2);
+  fail_unless_equals_int (gst_harness_buffers_in_queue (h), 2);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_opus_decode_batched)
+{
+  GstHarness *enc, *dec;
+  GstBufferList *list;
+  guint *n_lists;
+  guint n_packets;
+
+  enc = gst_harness_new_parse ("opusenc frame-size=10 batch-frames=8");
+  gst_harness_set_src_caps_str (enc, AUDIO_CAPS_STRING);
+  fail_unless_equals_int (gst_harness_push (enc, create_silence_buffer (3840,
+              0)), GST_FLOW_OK);
+  list = pull_all_as_list (enc);
+  n_packets = gst_buffer_list_length (list);
+  fail_unless_equals_int (n_packets, 8);
+
+  dec = gst_harness_new ("opusdec");
+  n_lists = add_list_counter (dec->element);
+  gst_harness_set_src_caps (dec, gst_pad_get_current_caps (enc->sinkpad));
+
+  /* all packets are decoded in one go and pushed as one list */
+  fail_unless_equals_int (gst_pad_push_list (dec->srcpad, list), GST_FLOW_OK);
+  fail_unless_equals_int (*n_lists, 1);
+
+  list = pull_all_as_list (dec);
+  fail_unless_equals_int (gst_buffer_list_length (list), n_packets);
+  check_contiguous_timestamps (list, 0);
+  gst_buffer_list_unref (list);
+
+  gst_harness_teardown (dec);
+  gst_harness_teardown (enc);
+}
+
+GST_END_TEST;
+
+static gdouble
+run_batched_benchmark (guint batch_frames, gdouble time)
+{
+  GstHarness *enc, *dec = NULL;
+  GTimer *timer;
+  guint64 n_frames = 0;
+  gdouble elapsed;
+  gchar *launch;
+
+  launch = g_strdup_printf ("opusenc frame-size=2 complexity=0 "
+      "batch-frames=%u", batch_frames);
+  enc = gst_harness_new_parse (launch);
+  g_free (launch);
+  gst_harness_set_src_caps_str (enc, AUDIO_CAPS_STRING);
+
+  timer = g_timer_new ();
+  do {
+    GstBufferList *list;
+    GstClockTime pts;
+
+    /* 2.5 ms frames are 120 samples at 48 kHz */
+    pts = gst_util_uint64_scale_int (n_frames, GST_SECOND, 400);
+    fail_unless_equals_int (gst_harness_push (enc,
+            create_silence_buffer (120 * batch_frames, pts)), GST_FLOW_OK);
+    list = pull_all_as_list (enc);
+
+    if (!dec) {
+      dec = gst_harness_new ("opusdec");
+      gst_harness_set_src_caps (dec, gst_pad_get_current_caps (enc->sinkpad));
+    }
+
+    if (batch_frames > 1) {
+      fail_unless_equals_int (gst_pad_push_list (dec->srcpad, list),
+          GST_FLOW_OK);
+    } else {
+      guint i;
+
+      for (i = 0; i < gst_buffer_list_length (list); i++)
+        fail_unless_equals_int (gst_harness_push (dec,
+                gst_buffer_ref (gst_buffer_list_get (list, i))), GST_FLOW_OK);
+      gst_buffer_list_unref (list);
+    }
+    gst_buffer_list_unref (pull_all_as_list (dec));
+
+    n_frames += batch_frames;
+    elapsed = g_timer_elapsed (timer, NULL);
+  } while (elapsed < time);
+  g_timer_destroy (timer);
+
+  gst_harness_teardown (dec);
+  gst_harness_teardown (enc);
+
+  return n_frames / elapsed;
+}
+
+GST_START_TEST (test_opus_batched_performance)
+{
+  static const guint batches[] = { 1, 4, 16 };
+  guint i;
+
+/* set to something larger to do benchmarks */
+#define TIME 0.01
+
+  for (i = 0; i < G_N_ELEMENTS (batches); i++) {
+    gdouble frames_sec = run_batched_benchmark (batches[i], TIME);
+
+    GST_DEBUG ("%f frames/sec encoded and decoded in batches of %u",
+        frames_sec, batches[i]);
+  }
+
+#undef TIME
+}
+
+GST_END_TEST;
+
 static Suite *
 opus_suite (void)
 {
@@ -502,6 +708,9 @@ opus_suite (void)
   tcase_add_test (tc_chain, test_opus_encode_properties);
   tcase_add_test (tc_chain, test_opusdec_getcaps);
   tcase_add_test (tc_chain, test_opus_decode_plc_timestamps_with_fec);
+  tcase_add_test (tc_chain, test_opus_encode_batched);
+  tcase_add_test (tc_chain, test_opus_decode_batched);
+  tcase_add_test (tc_chain, test_opus_batched_performance);
 
   return s;
 }
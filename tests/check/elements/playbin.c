@@ -605,6 +605,126 @@ GST_START_TEST (test_element_setup)
 
 GST_END_TEST;
 
+static void
+sink_handoff (GstElement * sink, GstBuffer * buf, GstPad * pad, gint * frames)
+{
+  g_atomic_int_inc (frames);
+}
+
+static GstClockTime
+wait_for_first_frame (GstElement * playbin, gint * frames)
+{
+  GstClockTime start = gst_util_get_timestamp ();
+  GstBus *bus = gst_element_get_bus (playbin);
+  GstMessage *msg;
+
+  /* the stream-start of the new stream reaches the sinks right before its
+   * first frame */
+  msg = gst_bus_timed_pop_filtered (bus, 10 * GST_SECOND,
+      GST_MESSAGE_STREAM_START | GST_MESSAGE_ERROR);
+  fail_unless (msg != NULL);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (msg), GST_MESSAGE_STREAM_START);
+  gst_message_unref (msg);
+  gst_object_unref (bus);
+
+  g_atomic_int_set (frames, 0);
+  while (g_atomic_int_get (frames) == 0)
+    g_usleep (G_USEC_PER_SEC / 1000);
+
+  return gst_util_get_timestamp () - start;
+}
+
+static void
+get_standby_stats (GstElement * playbin, guint64 * prepared, guint64 * used)
+{
+  GstStructure *stats = NULL;
+
+  g_object_get (playbin, "standby-stats", &stats, NULL);
+  fail_unless (stats != NULL);
+  fail_unless (gst_structure_get_uint64 (stats, "prepared", prepared));
+  fail_unless (gst_structure_get_uint64 (stats, "used", used));
+  gst_structure_free (stats);
+}
+
+GST_START_TEST (test_playbin3_switch_uri)
+{
+  const gchar *standby[] = { "redvideo://b", NULL };
+  GstElement *playbin, *videosink, *audiosink;
+  guint64 prepared, used;
+  GstClockTime start, cycle, ttff;
+  gint frames = 0;
+  gboolean ret = FALSE;
+  gchar *uri;
+
+  if (!gst_registry_check_feature_version (gst_registry_get (), "redvideosrc",
+          GST_VERSION_MAJOR, GST_VERSION_MINOR, 0)) {
+    fail_unless (gst_element_register (NULL, "redvideosrc", GST_RANK_PRIMARY,
+            gst_red_video_src_get_type ()));
+  }
+
+  playbin = gst_element_factory_make ("playbin3", NULL);
+  fail_unless (playbin != NULL, "Failed to create playbin3 element");
+
+  videosink = gst_element_factory_make ("fakesink", "myvideosink");
+  audiosink = gst_element_factory_make ("fakesink", "myaudiosink");
+  g_object_set (videosink, "signal-handoffs", TRUE, NULL);
+  g_signal_connect (videosink, "handoff", G_CALLBACK (sink_handoff), &frames);
+  g_object_set (playbin, "video-sink", videosink, "audio-sink", audiosink,
+      "uri", "redvideo://a", "standby-uris", standby, NULL);
+
+  /* time to the first frame from a cold start */
+  start = gst_util_get_timestamp ();
+  fail_unless (gst_element_set_state (playbin, GST_STATE_PLAYING) !=
+      GST_STATE_CHANGE_FAILURE);
+  wait_for_first_frame (playbin, &frames);
+  cycle = gst_util_get_timestamp () - start;
+
+  /* a bin was prepared for the standby uri, but not used yet */
+  get_standby_stats (playbin, &prepared, &used);
+  fail_unless_equals_uint64 (prepared, 1);
+  fail_unless_equals_uint64 (used, 0);
+
+  /* switch to the standby uri, the sinks keep playing */
+  start = gst_util_get_timestamp ();
+  g_signal_emit_by_name (playbin, "switch-uri", "redvideo://b", &ret);
+  fail_unless (ret);
+  wait_for_first_frame (playbin, &frames);
+  ttff = gst_util_get_timestamp () - start;
+
+  g_object_get (playbin, "current-uri", &uri, NULL);
+  fail_unless_equals_string (uri, "redvideo://b");
+  g_free (uri);
+
+  /* the prepared bin was used for it */
+  get_standby_stats (playbin, &prepared, &used);
+  fail_unless_equals_uint64 (used, 1);
+
+  /* the one we switched away from is not a standby uri */
+  g_signal_emit_by_name (playbin, "switch-uri", "redvideo://a", &ret);
+  fail_unless (ret);
+  wait_for_first_frame (playbin, &frames);
+  g_object_get (playbin, "current-uri", &uri, NULL);
+  fail_unless_equals_string (uri, "redvideo://a");
+  g_free (uri);
+
+  /* nothing was kept ready for it, and the standby uri we switched away from
+   * gets a new bin */
+  get_standby_stats (playbin, &prepared, &used);
+  fail_unless_equals_uint64 (used, 1);
+  fail_unless_equals_uint64 (prepared, 2);
+
+  GST_DEBUG ("first frame after start: %" GST_TIME_FORMAT
+      ", after switch-uri: %" GST_TIME_FORMAT, GST_TIME_ARGS (cycle),
+      GST_TIME_ARGS (ttff));
+
+  fail_unless_equals_int (gst_element_set_state (playbin, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+
+  gst_object_unref (playbin);
+}
+
+GST_END_TEST;
+
 /*** redvideo:// source ***/
 
 static GstURIType
@@ -902,6 +1022,7 @@ playbin_suite (void)
   tcase_add_test (tc_chain, test_refcount);
   tcase_add_test (tc_chain, test_source_setup);
   tcase_add_test (tc_chain, test_element_setup);
+  tcase_add_test (tc_chain, test_playbin3_switch_uri);
 
 #if 0
   {
@@ -654,6 +654,77 @@ GST_START_TEST (test_incomplete_last_buffer)
 
 GST_END_TEST;
 
+GST_START_TEST (test_repack)
+{
+  GstBuffer *inbuf, *outbuf;
+
+  /* With repacking enabled, frames from the properties config (which has
+   * custom strides and offsets) are output with the default layout, which
+   * for 8x8 Y444 is the one of the sink caps config (192 bytes) */
+
+  setup_rawvideoparse (FALSE, TRUE, NULL, GST_FORMAT_BYTES);
+  g_object_set (G_OBJECT (rawvideoparse), "repack", TRUE, NULL);
+
+  inbuf = gst_adapter_take_buffer (properties_ctx.data, 1000);
+  fail_unless (gst_pad_push (mysrcpad, inbuf) == GST_FLOW_OK);
+  fail_unless_equals_int (g_list_length (buffers), 2);
+
+  outbuf = g_list_nth_data (buffers, 0);
+  fail_unless_equals_uint64 (gst_buffer_get_size (outbuf), 192);
+  fail_unless_equals_uint64 (GST_BUFFER_PTS (outbuf), 0);
+  fail_unless_equals_uint64 (GST_BUFFER_DURATION (outbuf), GST_MSECOND * 40);
+  fail_unless (gst_buffer_get_video_meta (outbuf) == NULL);
+  check_test_pattern (&sinkcaps_ctx, outbuf, 0, 0);
+
+  outbuf = g_list_nth_data (buffers, 1);
+  fail_unless_equals_uint64 (gst_buffer_get_size (outbuf), 192);
+  fail_unless_equals_uint64 (GST_BUFFER_PTS (outbuf), GST_MSECOND * 40);
+  check_test_pattern (&sinkcaps_ctx, outbuf, 1, 0);
+
+  cleanup_rawvideoparse ();
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_aligned_frame_not_copied)
+{
+  GstAllocationParams params = { 0, 31, 0, 0 };
+  GstVideoInfo vinfo;
+  GstCaps *caps;
+  GstBuffer *inbuf, *outbuf;
+  GstMapInfo in_map, out_map;
+
+  /* Whole frames in suitably aligned input buffers are output without
+   * copying the frame data */
+
+  gst_video_info_set_format (&vinfo, TEST_FRAME_FORMAT, TEST_WIDTH,
+      TEST_HEIGHT);
+  GST_VIDEO_INFO_FPS_N (&vinfo) = 25;
+  GST_VIDEO_INFO_FPS_D (&vinfo) = 1;
+  caps = gst_video_info_to_caps (&vinfo);
+
+  setup_rawvideoparse (TRUE, FALSE, caps, GST_FORMAT_BYTES);
+
+  inbuf = gst_buffer_new_allocate (NULL, sinkcaps_ctx.plane_size * 3, &params);
+  fill_test_pattern (&sinkcaps_ctx, inbuf, 0, 0);
+  fail_unless (gst_buffer_map (inbuf, &in_map, GST_MAP_READ));
+  gst_buffer_unmap (inbuf, &in_map);
+
+  fail_unless (gst_pad_push (mysrcpad, inbuf) == GST_FLOW_OK);
+  fail_unless_equals_int (g_list_length (buffers), 1);
+
+  outbuf = g_list_nth_data (buffers, 0);
+  fail_unless_equals_uint64 (gst_buffer_get_size (outbuf), 192);
+  fail_unless (gst_buffer_map (outbuf, &out_map, GST_MAP_READ));
+  fail_unless (out_map.data == in_map.data);
+  gst_buffer_unmap (outbuf, &out_map);
+  check_test_pattern (&sinkcaps_ctx, outbuf, 0, 0);
+
+  cleanup_rawvideoparse ();
+}
+
+GST_END_TEST;
+
 static Suite *
 rawvideoparse_suite (void)
 {
@@ -668,6 +739,8 @@ rawvideoparse_suite (void)
   tcase_add_test (tc_chain, test_computed_plane_strides);
   tcase_add_test (tc_chain, test_change_caps);
   tcase_add_test (tc_chain, test_incomplete_last_buffer);
+  tcase_add_test (tc_chain, test_repack);
+  tcase_add_test (tc_chain, test_aligned_frame_not_copied);
 
   return s;
 }
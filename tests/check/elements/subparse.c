@@ -1036,6 +1036,126 @@ GST_START_TEST (test_lrc)
 
 GST_END_TEST;
 
+/* generates an SRT file with one cue per second, each shown for 500ms */
+static gchar *
+generate_srt (guint n_cues, gsize * cue_offsets)
+{
+  GString *s = g_string_new (NULL);
+  guint i;
+
+  for (i = 0; i < n_cues; i++) {
+    if (cue_offsets)
+      cue_offsets[i] = s->len;
+    g_string_append_printf (s, "%u\n%02u:%02u:%02u,000 --> %02u:%02u:%02u,500\n"
+        "<i>Cue</i> number %u & <b>some</b> text\nSecond line\n\n", i + 1,
+        i / 3600, i / 60 % 60, i % 60, i / 3600, i / 60 % 60, i % 60, i);
+  }
+
+  return g_string_free (s, FALSE);
+}
+
+static gint64 seek_offset;
+
+static gboolean
+seek_offset_event_func (GstPad * pad, GstObject * parent, GstEvent * event)
+{
+  if (GST_EVENT_TYPE (event) == GST_EVENT_SEEK) {
+    GstFormat format;
+
+    gst_event_parse_seek (event, NULL, &format, NULL, NULL, &seek_offset,
+        NULL, NULL);
+    fail_unless_equals_int (format, GST_FORMAT_BYTES);
+  }
+  gst_event_unref (event);
+
+  return TRUE;
+}
+
+static gint64
+do_time_seek (GstClockTime position)
+{
+  seek_offset = -1;
+  fail_unless (gst_element_send_event (subparse,
+          gst_event_new_seek (1.0, GST_FORMAT_TIME, 0, GST_SEEK_TYPE_SET,
+              position, GST_SEEK_TYPE_NONE, -1)));
+
+  return seek_offset;
+}
+
+GST_START_TEST (test_srt_seek_index)
+{
+  gsize cue_offsets[100];
+  gchar *data;
+
+  data = generate_srt (G_N_ELEMENTS (cue_offsets), cue_offsets);
+
+  setup_subparse ();
+  gst_pad_set_event_function (mysrcpad, seek_offset_event_func);
+
+  fail_unless_equals_int (gst_pad_push (mysrcpad,
+          buffer_from_static_string (data)), GST_FLOW_OK);
+  fail_unless_equals_int (g_list_length (buffers),
+      G_N_ELEMENTS (cue_offsets));
+
+  /* seeks restart at the first cue that is still shown at the requested
+   * position instead of at the start of the file */
+  fail_unless_equals_int64 (do_time_seek (0), 0);
+  fail_unless_equals_int64 (do_time_seek (50 * GST_SECOND + 200 * GST_MSECOND),
+      cue_offsets[50]);
+  fail_unless_equals_int64 (do_time_seek (50 * GST_SECOND + 700 * GST_MSECOND),
+      cue_offsets[51]);
+  fail_unless_equals_int64 (do_time_seek (1000 * GST_SECOND), cue_offsets[99]);
+
+  teardown_subparse ();
+  g_free (data);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_srt_performance)
+{
+  GTimer *timer;
+  gchar *data;
+  gsize len, pos;
+  guint n_cues = 1000, n_files = 0;
+  gdouble elapsed;
+
+/* set to something larger to do benchmarks */
+#define TIME 0.01
+
+  data = generate_srt (n_cues, NULL);
+  len = strlen (data);
+
+  timer = g_timer_new ();
+  do {
+    setup_subparse ();
+
+    /* push in chunks that don't match line boundaries */
+    for (pos = 0; pos < len; pos += 4093) {
+      GstBuffer *buf;
+
+      buf = gst_buffer_new_wrapped_full (GST_MEMORY_FLAG_READONLY, data, len,
+          pos, MIN (4093, len - pos), NULL, NULL);
+      fail_unless_equals_int (gst_pad_push (mysrcpad, buf), GST_FLOW_OK);
+    }
+    fail_unless_equals_int (g_list_length (buffers), n_cues);
+
+    teardown_subparse ();
+    n_files++;
+    elapsed = g_timer_elapsed (timer, NULL);
+  } while (elapsed < TIME);
+
+  GST_DEBUG ("%f cues/sec, %f MB/sec", n_files * n_cues / elapsed,
+      n_files * len / elapsed / (1024 * 1024));
+
+  g_timer_destroy (timer);
+  g_free (data);
+
+#undef TIME
+}
+
+GST_END_TEST;
+
 /* TODO:
  *  - add/modify tests so that lines aren't dogfed to the parsers in complete
  *    lines or sets of complete lines, but rather in random chunks
@@ -1071,6 +1191,8 @@ subparse_suite (void)
   tcase_add_test (tc_chain, test_sami_bad_entities);
   tcase_add_test (tc_chain, test_sami_comment);
   tcase_add_test (tc_chain, test_lrc);
+  tcase_add_test (tc_chain, test_srt_seek_index);
+  tcase_add_test (tc_chain, test_srt_performance);
   return s;
 }
 
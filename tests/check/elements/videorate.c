@@ -24,6 +24,7 @@
 #endif
 
 #include <gst/check/gstcheck.h>
+#include <gst/video/video.h>
 
 /* For ease of programming we use globals to keep refs for our floating
  * src and sink pads we create; otherwise we always have to do get_pad,
@@ -65,6 +66,20 @@ static GstPad *mysrcpad, *mysinkpad;
     "framerate = (fraction) 999/7 , "	\
     "format = (string) I420"
 
+#define VIDEO_CAPS_GRAY8_STRING         \
+    "video/x-raw, "                 \
+    "width = (int) 4, "                 \
+    "height = (int) 2, "                \
+    "framerate = (fraction) 25/1 , "    \
+    "format = (string) GRAY8"
+
+#define VIDEO_CAPS_GRAY8_100FPS_STRING  \
+    "video/x-raw, "                 \
+    "width = (int) 4, "                 \
+    "height = (int) 2, "                \
+    "framerate = (fraction) 100/1 , "   \
+    "format = (string) GRAY8"
+
 static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
     GST_PAD_ALWAYS,
@@ -82,6 +97,13 @@ static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
     GST_STATIC_CAPS (VIDEO_CAPS_TEMPLATE_STRING)
     );
 
+static GstStaticPadTemplate gray8_100fps_template =
+GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (VIDEO_CAPS_GRAY8_100FPS_STRING)
+    );
+
 static GstStaticPadTemplate force_variable_rate_template =
 GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
@@ -503,6 +525,92 @@ GST_START_TEST (test_max_duplication_time)
 
 GST_END_TEST;
 
+static GstBuffer *
+new_gray8_buffer (GstClockTime pts, guint8 value)
+{
+  GstBuffer *buffer = gst_buffer_new_and_alloc (8);
+
+  GST_BUFFER_TIMESTAMP (buffer) = pts;
+  gst_buffer_memset (buffer, 0, value, 8);
+
+  return buffer;
+}
+
+static void
+check_gray8_buffer (GstBuffer * buffer, GstClockTime pts, guint8 value,
+    gboolean duplicate)
+{
+  gint i;
+
+  fail_unless_equals_uint64 (GST_BUFFER_TIMESTAMP (buffer), pts);
+  for (i = 0; i < 8; i++)
+    fail_unless_equals_int (buffer_get_byte (buffer, i), value);
+  fail_unless_equals_int (GST_BUFFER_FLAG_IS_SET (buffer,
+          GST_VIDEO_BUFFER_FLAG_DUPLICATE), duplicate);
+}
+
+/* 25 fps to 100 fps, interpolating and then duplicating frames */
+GST_START_TEST (test_blend)
+{
+  GstElement *videorate;
+  GstCaps *caps, *ref_caps;
+  GstBuffer *first;
+  gint i;
+
+  videorate = setup_videorate_full (&srctemplate, &gray8_100fps_template);
+  g_object_set (videorate, "blend", TRUE, NULL);
+  fail_unless (gst_element_set_state (videorate,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  caps = gst_caps_from_string (VIDEO_CAPS_GRAY8_STRING);
+  gst_check_setup_events (mysrcpad, videorate, caps, GST_FORMAT_TIME);
+  gst_caps_unref (caps);
+
+  /* metas of the first frame must be kept on the blended frames */
+  first = new_gray8_buffer (0, 0);
+  ref_caps = gst_caps_new_empty_simple ("timestamp/x-test");
+  gst_buffer_add_reference_timestamp_meta (first, ref_caps, 0,
+      GST_CLOCK_TIME_NONE);
+  gst_caps_unref (ref_caps);
+  fail_unless (gst_pad_push (mysrcpad, first) == GST_FLOW_OK);
+  fail_unless_equals_int (g_list_length (buffers), 0);
+
+  /* the first frame is output as is, the following ones are blended */
+  fail_unless (gst_pad_push (mysrcpad,
+          new_gray8_buffer (40 * GST_MSECOND, 200)) == GST_FLOW_OK);
+  fail_unless_equals_int (g_list_length (buffers), 4);
+  check_gray8_buffer (g_list_nth_data (buffers, 0), 0, 0, FALSE);
+  check_gray8_buffer (g_list_nth_data (buffers, 1), 10 * GST_MSECOND, 50,
+      FALSE);
+  check_gray8_buffer (g_list_nth_data (buffers, 2), 20 * GST_MSECOND, 100,
+      FALSE);
+  check_gray8_buffer (g_list_nth_data (buffers, 3), 30 * GST_MSECOND, 150,
+      FALSE);
+  for (i = 0; i < 4; i++)
+    fail_unless (gst_buffer_get_reference_timestamp_meta (g_list_nth_data
+            (buffers, i), NULL) != NULL);
+  /* interpolated frames are not counted as duplicates */
+  assert_videorate_stats (videorate, "blended", 2, 4, 0, 0);
+
+  /* without blending, the frames in between are flagged duplicates */
+  g_object_set (videorate, "blend", FALSE, NULL);
+  fail_unless (gst_pad_push (mysrcpad,
+          new_gray8_buffer (80 * GST_MSECOND, 100)) == GST_FLOW_OK);
+  fail_unless_equals_int (g_list_length (buffers), 7);
+  check_gray8_buffer (g_list_nth_data (buffers, 4), 40 * GST_MSECOND, 200,
+      FALSE);
+  check_gray8_buffer (g_list_nth_data (buffers, 5), 50 * GST_MSECOND, 200,
+      TRUE);
+  check_gray8_buffer (g_list_nth_data (buffers, 6), 60 * GST_MSECOND, 200,
+      TRUE);
+  assert_videorate_stats (videorate, "duplicated", 3, 7, 0, 2);
+
+  cleanup_videorate (videorate);
+}
+
+GST_END_TEST;
+
 /* send frames with 0, 1, 2, 0 seconds */
 GST_START_TEST (test_wrong_order)
 {
@@ -1521,6 +1629,7 @@ videorate_suite (void)
   tcase_add_loop_test (tc_chain, test_rate, 0, G_N_ELEMENTS (rate_tests));
   tcase_add_test (tc_chain, test_query_duration);
   tcase_add_test (tc_chain, test_max_duplication_time);
+  tcase_add_test (tc_chain, test_blend);
   tcase_add_loop_test (tc_chain, test_query_position, 0,
       G_N_ELEMENTS (position_tests));
 
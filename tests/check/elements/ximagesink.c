@@ -0,0 +1,207 @@
+/* GStreamer
+ *
+ * unit test for ximagesink and xvimagesink frame presentation
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+
+#define NUM_FRAMES 30
+
+static guint max_seen_pending;
+
+static void
+get_present_stats (GstElement * sink, guint64 * presented, guint64 * dropped,
+    guint * pending)
+{
+  GstStructure *stats = NULL;
+
+  g_object_get (sink, "present-stats", &stats, NULL);
+  fail_unless (stats != NULL);
+  fail_unless (gst_structure_get_uint64 (stats, "presented", presented));
+  fail_unless (gst_structure_get_uint64 (stats, "dropped", dropped));
+  fail_unless (gst_structure_get_uint (stats, "pending", pending));
+  gst_structure_free (stats);
+}
+
+/* the number of images the X server may be reading from while frames are
+ * rendered */
+static GstPadProbeReturn
+pending_probe (GstPad * pad, GstPadProbeInfo * info, GstElement * sink)
+{
+  guint64 presented, dropped;
+  guint pending;
+
+  get_present_stats (sink, &presented, &dropped, &pending);
+  max_seen_pending = MAX (max_seen_pending, pending);
+
+  return GST_PAD_PROBE_OK;
+}
+
+/* Runs NUM_FRAMES frames into the sink named @factory, returns FALSE if the
+ * sink can't be used on this display */
+static gboolean
+run_present_pipeline (const gchar * factory, gboolean drop_frames,
+    guint max_pending, guint64 * presented, guint64 * dropped,
+    guint * pending)
+{
+  GstElement *pipeline, *sink;
+  GError *error = NULL;
+  GstMessage *msg;
+  GstPad *pad;
+  gchar *desc;
+
+  if (g_getenv ("DISPLAY") == NULL) {
+    g_printerr ("Skipping %s test, no DISPLAY\n", factory);
+    return FALSE;
+  }
+
+  desc = g_strdup_printf ("videotestsrc num-buffers=%d ! "
+      "video/x-raw,width=320,height=240 ! videoconvert ! %s name=sink "
+      "sync=false drop-frames=%d max-pending-frames=%u", NUM_FRAMES, factory,
+      drop_frames, max_pending);
+  pipeline = gst_parse_launch (desc, &error);
+  g_free (desc);
+  if (error != NULL) {
+    g_printerr ("Skipping %s test: %s\n", factory, error->message);
+    g_clear_error (&error);
+    if (pipeline)
+      gst_object_unref (pipeline);
+    return FALSE;
+  }
+
+  sink = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+  if (gst_element_set_state (sink, GST_STATE_READY) ==
+      GST_STATE_CHANGE_FAILURE) {
+    g_printerr ("Skipping %s test, can't open the display\n", factory);
+    gst_element_set_state (pipeline, GST_STATE_NULL);
+    gst_object_unref (sink);
+    gst_object_unref (pipeline);
+    return FALSE;
+  }
+
+  max_seen_pending = 0;
+  pad = gst_element_get_static_pad (sink, "sink");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER,
+      (GstPadProbeCallback) pending_probe, sink, NULL);
+  gst_object_unref (pad);
+
+  fail_if (gst_element_set_state (pipeline,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE);
+  msg = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipeline),
+      GST_CLOCK_TIME_NONE, GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (msg), GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+
+  /* shutting down puts the frame that may still be waiting to be put */
+  fail_unless_equals_int (gst_element_set_state (pipeline, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+
+  get_present_stats (sink, presented, dropped, pending);
+  GST_INFO ("%s: presented %" G_GUINT64_FORMAT ", dropped %" G_GUINT64_FORMAT
+      ", max pending %u", factory, *presented, *dropped, max_seen_pending);
+
+  gst_object_unref (sink);
+  gst_object_unref (pipeline);
+
+  return TRUE;
+}
+
+static void
+check_present_no_drop (const gchar * factory)
+{
+  guint64 presented, dropped;
+  guint pending;
+
+  if (!run_present_pipeline (factory, FALSE, 1, &presented, &dropped,
+          &pending))
+    return;
+
+  /* every frame is put, even the last one */
+  fail_unless (presented >= NUM_FRAMES, "only %" G_GUINT64_FORMAT
+      " frames presented", presented);
+  fail_unless_equals_uint64 (dropped, 0);
+  /* all images were released by the X server when stopping */
+  fail_unless_equals_int (pending, 0);
+  fail_unless (max_seen_pending <= 1);
+}
+
+static void
+check_present_drop (const gchar * factory)
+{
+  guint64 presented, dropped;
+  guint pending;
+
+  if (!run_present_pipeline (factory, TRUE, 2, &presented, &dropped,
+          &pending))
+    return;
+
+  /* frames can be replaced, but none is lost without being counted and the
+   * last one is always put */
+  fail_unless (presented + dropped >= NUM_FRAMES);
+  fail_unless (presented >= 1);
+  fail_unless_equals_int (pending, 0);
+  fail_unless (max_seen_pending <= 2);
+}
+
+GST_START_TEST (test_ximagesink_present)
+{
+  check_present_no_drop ("ximagesink");
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_ximagesink_present_drop_frames)
+{
+  check_present_drop ("ximagesink");
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_xvimagesink_present)
+{
+  check_present_no_drop ("xvimagesink");
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_xvimagesink_present_drop_frames)
+{
+  check_present_drop ("xvimagesink");
+}
+
+GST_END_TEST;
+
+static Suite *
+ximagesink_suite (void)
+{
+  Suite *s = suite_create ("ximagesink");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_ximagesink_present);
+  tcase_add_test (tc_chain, test_ximagesink_present_drop_frames);
+  tcase_add_test (tc_chain, test_xvimagesink_present);
+  tcase_add_test (tc_chain, test_xvimagesink_present_drop_frames);
+
+  return s;
+}
+
+GST_CHECK_MAIN (ximagesink)
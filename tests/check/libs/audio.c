@@ -937,6 +937,204 @@ GST_START_TEST (test_fill_silence)
 
 GST_END_TEST;
 
+GST_START_TEST (test_interleave_deinterleave)
+{
+  static const GstAudioFormat formats[] = {
+    GST_AUDIO_FORMAT_S8, GST_AUDIO_FORMAT_S16, GST_AUDIO_FORMAT_S24,
+    GST_AUDIO_FORMAT_S32, GST_AUDIO_FORMAT_F64
+  };
+  /* not a multiple of the channel group nor of the block size */
+  const gint channels = 13, skipped = 5;
+  const gsize frames = 150;
+  guint f;
+  gint c;
+  gsize i, k;
+
+  for (f = 0; f < G_N_ELEMENTS (formats); f++) {
+    const GstAudioFormatInfo *finfo = gst_audio_format_get_info (formats[f]);
+    gsize width = finfo->width / 8;
+    guint8 *planes[13], *out_planes[13];
+    gpointer src[13], dest[13];
+    guint8 *interleaved;
+
+    for (c = 0; c < channels; c++) {
+      planes[c] = g_malloc (frames * width);
+      out_planes[c] = g_malloc (frames * width);
+      for (i = 0; i < frames * width; i++)
+        planes[c][i] = (c * 37 + i * 11) & 0xff;
+      memset (out_planes[c], 0xaa, frames * width);
+      src[c] = c == skipped ? NULL : planes[c];
+      dest[c] = c == skipped ? NULL : out_planes[c];
+    }
+    interleaved = g_malloc (frames * width * channels);
+    memset (interleaved, 0xaa, frames * width * channels);
+
+    /* missing input channels are left untouched */
+    gst_audio_format_interleave (finfo, interleaved, src, channels, frames);
+    for (i = 0; i < frames; i++) {
+      for (c = 0; c < channels; c++) {
+        for (k = 0; k < width; k++) {
+          guint8 v = interleaved[(i * channels + c) * width + k];
+
+          if (c == skipped)
+            fail_unless_equals_int (v, 0xaa);
+          else
+            fail_unless_equals_int (v, planes[c][i * width + k]);
+        }
+      }
+    }
+
+    /* and missing output channels are not written */
+    gst_audio_format_deinterleave (finfo, dest, interleaved, channels, frames);
+    for (c = 0; c < channels; c++) {
+      if (c == skipped) {
+        for (i = 0; i < frames * width; i++)
+          fail_unless_equals_int (out_planes[c][i], 0xaa);
+      } else {
+        fail_unless (memcmp (out_planes[c], planes[c], frames * width) == 0);
+      }
+    }
+
+    for (c = 0; c < channels; c++) {
+      g_free (planes[c]);
+      g_free (out_planes[c]);
+    }
+    g_free (interleaved);
+  }
+}
+
+GST_END_TEST;
+
+/* one strided pass per channel, what the kernels replaced */
+static void
+interleave_s16_strided (gint16 * dest, gint16 ** src, gint channels,
+    gsize frames)
+{
+  gsize i;
+  gint c;
+
+  for (c = 0; c < channels; c++)
+    for (i = 0; i < frames; i++)
+      dest[i * channels + c] = src[c][i];
+}
+
+static void
+deinterleave_s16_strided (gint16 ** dest, const gint16 * src, gint channels,
+    gsize frames)
+{
+  gsize i;
+  gint c;
+
+  for (c = 0; c < channels; c++)
+    for (i = 0; i < frames; i++)
+      dest[c][i] = src[i * channels + c];
+}
+
+GST_START_TEST (test_interleave_deinterleave_speed)
+{
+  static const gint channels_list[] = { 2, 6, 8, 16 };
+  const GstAudioFormatInfo *finfo;
+  GTimer *timer;
+  guint n;
+
+#define FRAMES 4096
+/* set to something larger to do benchmarks */
+#define TIME 0.01
+
+  finfo = gst_audio_format_get_info (GST_AUDIO_FORMAT_S16);
+  timer = g_timer_new ();
+
+  GST_DEBUG ("channels\tinterleave/sec\tstrided/sec\tdeinterleave/sec"
+      "\tstrided/sec");
+
+  for (n = 0; n < G_N_ELEMENTS (channels_list); n++) {
+    gint channels = channels_list[n];
+    gint16 *planes[16], *out_planes[16];
+    gint16 *interleaved, *ref;
+    gdouble elapsed, il_sec, il_ref_sec, dil_sec, dil_ref_sec;
+    gint count, c;
+    gsize i;
+
+    for (c = 0; c < channels; c++) {
+      planes[c] = g_new (gint16, FRAMES);
+      out_planes[c] = g_new0 (gint16, FRAMES);
+      for (i = 0; i < FRAMES; i++)
+        planes[c][i] = c * FRAMES + i;
+    }
+    interleaved = g_new0 (gint16, FRAMES * channels);
+    ref = g_new0 (gint16, FRAMES * channels);
+
+    count = 0;
+    g_timer_start (timer);
+    while (TRUE) {
+      gst_audio_format_interleave (finfo, interleaved, (gpointer *) planes,
+          channels, FRAMES);
+      count++;
+      elapsed = g_timer_elapsed (timer, NULL);
+      if (elapsed >= TIME)
+        break;
+    }
+    il_sec = count / elapsed;
+
+    count = 0;
+    g_timer_start (timer);
+    while (TRUE) {
+      interleave_s16_strided (ref, planes, channels, FRAMES);
+      count++;
+      elapsed = g_timer_elapsed (timer, NULL);
+      if (elapsed >= TIME)
+        break;
+    }
+    il_ref_sec = count / elapsed;
+
+    fail_unless (memcmp (interleaved, ref,
+            FRAMES * channels * sizeof (gint16)) == 0);
+
+    count = 0;
+    g_timer_start (timer);
+    while (TRUE) {
+      gst_audio_format_deinterleave (finfo, (gpointer *) out_planes,
+          interleaved, channels, FRAMES);
+      count++;
+      elapsed = g_timer_elapsed (timer, NULL);
+      if (elapsed >= TIME)
+        break;
+    }
+    dil_sec = count / elapsed;
+
+    for (c = 0; c < channels; c++)
+      fail_unless (memcmp (out_planes[c], planes[c],
+              FRAMES * sizeof (gint16)) == 0);
+
+    count = 0;
+    g_timer_start (timer);
+    while (TRUE) {
+      deinterleave_s16_strided (out_planes, ref, channels, FRAMES);
+      count++;
+      elapsed = g_timer_elapsed (timer, NULL);
+      if (elapsed >= TIME)
+        break;
+    }
+    dil_ref_sec = count / elapsed;
+
+    GST_DEBUG ("%d\t%f\t%f\t%f\t%f", channels, il_sec, il_ref_sec, dil_sec,
+        dil_ref_sec);
+
+    for (c = 0; c < channels; c++) {
+      g_free (planes[c]);
+      g_free (out_planes[c]);
+    }
+    g_free (interleaved);
+    g_free (ref);
+  }
+
+  g_timer_destroy (timer);
+}
+
+GST_END_TEST;
+#undef FRAMES
+#undef TIME
+
 GST_START_TEST (test_stream_align)
 {
   GstAudioStreamAlign *align;
@@ -1402,6 +1600,154 @@ GST_START_TEST (test_audio_buffer_and_audio_meta)
 
 GST_END_TEST;
 
+typedef GstAudioRingBuffer TestRingBuffer;
+typedef GstAudioRingBufferClass TestRingBufferClass;
+
+static GType test_ring_buffer_get_type (void);
+
+G_DEFINE_TYPE (TestRingBuffer, test_ring_buffer, GST_TYPE_AUDIO_RING_BUFFER);
+
+static gboolean
+test_ring_buffer_open_device (GstAudioRingBuffer * buf)
+{
+  return TRUE;
+}
+
+static gboolean
+test_ring_buffer_acquire (GstAudioRingBuffer * buf,
+    GstAudioRingBufferSpec * spec)
+{
+  buf->size = spec->segtotal * spec->segsize;
+  buf->memory = g_malloc0 (buf->size);
+  return TRUE;
+}
+
+static gboolean
+test_ring_buffer_release (GstAudioRingBuffer * buf)
+{
+  g_free (buf->memory);
+  buf->memory = NULL;
+  return TRUE;
+}
+
+static gboolean
+test_ring_buffer_noop (GstAudioRingBuffer * buf)
+{
+  return TRUE;
+}
+
+static void
+test_ring_buffer_class_init (TestRingBufferClass * klass)
+{
+  klass->open_device = test_ring_buffer_open_device;
+  klass->close_device = test_ring_buffer_noop;
+  klass->acquire = test_ring_buffer_acquire;
+  klass->release = test_ring_buffer_release;
+  klass->start = test_ring_buffer_noop;
+  klass->pause = test_ring_buffer_noop;
+  klass->resume = test_ring_buffer_noop;
+  klass->stop = test_ring_buffer_noop;
+}
+
+static void
+test_ring_buffer_init (TestRingBuffer * buf)
+{
+}
+
+static gint reader_running;
+
+/* plays the role of the device, consuming one segment per latency_time */
+static gpointer
+test_ring_buffer_reader (GstAudioRingBuffer * buf)
+{
+  guint8 *readptr;
+  gint segment, len;
+
+  while (g_atomic_int_get (&reader_running)) {
+    if (gst_audio_ring_buffer_prepare_read (buf, &segment, &readptr, &len)) {
+      g_usleep (buf->spec.latency_time);
+      gst_audio_ring_buffer_clear (buf, segment);
+      gst_audio_ring_buffer_advance (buf, 1);
+    } else {
+      g_usleep (100);
+    }
+  }
+  return NULL;
+}
+
+GST_START_TEST (test_ring_buffer_wait_stats)
+{
+  GstAudioRingBuffer *buf;
+  GstStructure *stats;
+  const GValue *histogram;
+  GstCaps *caps;
+  GThread *reader;
+  guint8 *data;
+  guint64 sample = 0;
+  guint waits, spun_waits, sum;
+  gint i, total, written, accum = 0;
+
+  buf = g_object_new (test_ring_buffer_get_type (), NULL);
+  fail_unless (gst_audio_ring_buffer_open_device (buf));
+
+  /* 1ms segments, short enough to poll before waiting */
+  caps = gst_caps_from_string ("audio/x-raw, format=" GST_AUDIO_NE (S16)
+      ", rate=48000, channels=2, layout=interleaved");
+  buf->spec.latency_time = 1000;
+  buf->spec.buffer_time = 4000;
+  fail_unless (gst_audio_ring_buffer_parse_caps (&buf->spec, caps));
+  gst_caps_unref (caps);
+  fail_unless (gst_audio_ring_buffer_acquire (buf, &buf->spec));
+  fail_unless_equals_int (buf->spec.segtotal, 4);
+
+  stats = NULL;
+  g_object_get (buf, "wait-stats", &stats, NULL);
+  fail_unless (stats != NULL);
+  fail_unless (gst_structure_get_uint (stats, "waits", &waits));
+  fail_unless_equals_int (waits, 0);
+  gst_structure_free (stats);
+
+  gst_audio_ring_buffer_set_flushing (buf, FALSE);
+  gst_audio_ring_buffer_may_start (buf, TRUE);
+
+  g_atomic_int_set (&reader_running, 1);
+  reader = g_thread_new ("reader", (GThreadFunc) test_ring_buffer_reader, buf);
+
+  /* 50 segments, the writer has to wait for the reader for most of them */
+  total = 50 * buf->samples_per_seg;
+  data = g_malloc0 (total * buf->spec.info.bpf);
+  written = gst_audio_ring_buffer_commit (buf, &sample, data, total, total,
+      &accum);
+  fail_unless_equals_int (written, total);
+  g_free (data);
+
+  g_atomic_int_set (&reader_running, 0);
+  g_thread_join (reader);
+
+  g_object_get (buf, "wait-stats", &stats, NULL);
+  GST_DEBUG ("wait stats %" GST_PTR_FORMAT, stats);
+  fail_unless (gst_structure_get_uint (stats, "waits", &waits));
+  fail_unless (gst_structure_get_uint (stats, "spun-waits", &spun_waits));
+  fail_unless (waits > 0);
+  fail_unless (spun_waits <= waits);
+
+  histogram = gst_structure_get_value (stats, "histogram");
+  fail_unless (GST_VALUE_HOLDS_ARRAY (histogram));
+  fail_unless_equals_int (gst_value_array_get_size (histogram), 16);
+  sum = 0;
+  for (i = 0; i < gst_value_array_get_size (histogram); i++)
+    sum += g_value_get_uint (gst_value_array_get_value (histogram, i));
+  fail_unless_equals_int (sum, waits);
+  gst_structure_free (stats);
+
+  gst_audio_ring_buffer_set_flushing (buf, TRUE);
+  fail_unless (gst_audio_ring_buffer_release (buf));
+  fail_unless (gst_audio_ring_buffer_close_device (buf));
+  gst_object_unref (buf);
+}
+
+GST_END_TEST;
+
 static Suite *
 audio_suite (void)
 {
@@ -1433,9 +1779,12 @@ audio_suite (void)
   tcase_add_test (tc_chain, test_audio_format_s8);
   tcase_add_test (tc_chain, test_audio_format_u8);
   tcase_add_test (tc_chain, test_fill_silence);
+  tcase_add_test (tc_chain, test_interleave_deinterleave);
+  tcase_add_test (tc_chain, test_interleave_deinterleave_speed);
   tcase_add_test (tc_chain, test_stream_align);
   tcase_add_test (tc_chain, test_stream_align_reverse);
   tcase_add_test (tc_chain, test_audio_buffer_and_audio_meta);
+  tcase_add_test (tc_chain, test_ring_buffer_wait_stats);
 
   return s;
 }
@@ -0,0 +1,238 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+
+#include <gst/gl/gl.h>
+#include <gst/gl/gstglfuncs.h>
+
+#define WIDTH 64
+#define HEIGHT 64
+#define RECT_SIZE 8
+#define RECTS_PER_ROW 4
+
+static GstGLDisplay *display;
+static GstGLContext *context;
+static GstGLFramebuffer *fbo;
+static GstGLOverlayCompositor *compositor;
+
+static void
+setup (void)
+{
+  GError *error = NULL;
+
+  display = gst_gl_display_new ();
+  context = gst_gl_context_new (display);
+
+  gst_gl_context_create (context, NULL, &error);
+
+  fail_if (error != NULL, "Error creating context: %s\n",
+      error ? error->message : "Unknown Error");
+
+  compositor = gst_gl_overlay_compositor_new (context);
+  /* draw the same way up as the video frames are read back */
+  g_object_set (compositor, "yinvert", TRUE, NULL);
+}
+
+static void
+teardown (void)
+{
+  gst_object_unref (compositor);
+  gst_object_unref (display);
+  gst_object_unref (context);
+}
+
+static guint32
+_rect_color (guint i)
+{
+  return 0xff000000 | ((i * 16) << 16) | ((255 - i * 16) << 8) | 0x80;
+}
+
+static GstVideoOverlayRectangle *
+_create_rectangle (guint i)
+{
+  GstVideoOverlayRectangle *rect;
+  GstBuffer *pixels;
+  GstMapInfo map;
+  guint32 *data;
+  guint j;
+
+  pixels = gst_buffer_new_and_alloc (RECT_SIZE * RECT_SIZE * 4);
+  gst_buffer_map (pixels, &map, GST_MAP_WRITE);
+  data = (guint32 *) map.data;
+  for (j = 0; j < RECT_SIZE * RECT_SIZE; j++)
+    data[j] = _rect_color (i);
+  gst_buffer_unmap (pixels, &map);
+
+  gst_buffer_add_video_meta (pixels, GST_VIDEO_FRAME_FLAG_NONE,
+      GST_VIDEO_OVERLAY_COMPOSITION_FORMAT_RGB, RECT_SIZE, RECT_SIZE);
+
+  rect = gst_video_overlay_rectangle_new_raw (pixels,
+      (i % RECTS_PER_ROW) * 2 * RECT_SIZE, (i / RECTS_PER_ROW) * 2 * RECT_SIZE,
+      RECT_SIZE, RECT_SIZE, GST_VIDEO_OVERLAY_FORMAT_FLAG_NONE);
+  gst_buffer_unref (pixels);
+
+  return rect;
+}
+
+static GstBuffer *
+_create_video_buffer (GstVideoOverlayRectangle ** rects, guint n_rects)
+{
+  GstVideoOverlayComposition *comp;
+  GstBuffer *buf;
+  guint i;
+
+  buf = gst_buffer_new ();
+  gst_buffer_add_video_meta (buf, GST_VIDEO_FRAME_FLAG_NONE,
+      GST_VIDEO_FORMAT_RGBA, WIDTH, HEIGHT);
+
+  comp = gst_video_overlay_composition_new (rects[0]);
+  for (i = 1; i < n_rects; i++)
+    gst_video_overlay_composition_add_rectangle (comp, rects[i]);
+  gst_buffer_add_video_overlay_composition_meta (buf, comp);
+  gst_video_overlay_composition_unref (comp);
+
+  return buf;
+}
+
+static gboolean
+_draw_overlays (gpointer data)
+{
+  const GstGLFuncs *gl = context->gl_vtable;
+
+  gl->ClearColor (0.0, 0.0, 0.0, 0.0);
+  gl->Clear (GL_COLOR_BUFFER_BIT);
+
+  gst_gl_overlay_compositor_draw_overlays (compositor);
+
+  return TRUE;
+}
+
+static void
+_draw_gl (GstGLContext * context, GstGLMemory * mem)
+{
+  fbo = gst_gl_framebuffer_new_with_default_depth (context, WIDTH, HEIGHT);
+  gst_gl_framebuffer_draw_to_texture (fbo, mem, _draw_overlays, NULL);
+  gst_object_unref (fbo);
+  fbo = NULL;
+}
+
+static void
+_render_and_check (GstVideoOverlayRectangle ** rects, guint n_rects)
+{
+  GstGLBaseMemoryAllocator *allocator;
+  GstGLVideoAllocationParams *params;
+  GstVideoFrame frame;
+  GstVideoInfo info;
+  GstGLMemory *mem;
+  GstBuffer *outbuf;
+  guint i;
+
+  gst_video_info_set_format (&info, GST_VIDEO_FORMAT_RGBA, WIDTH, HEIGHT);
+  allocator = (GstGLBaseMemoryAllocator *)
+      gst_gl_memory_allocator_get_default (context);
+  params = gst_gl_video_allocation_params_new (context, NULL, &info, 0, NULL,
+      GST_GL_TEXTURE_TARGET_2D, GST_GL_RGBA);
+  mem = (GstGLMemory *) gst_gl_base_memory_alloc (allocator,
+      (GstGLAllocationParams *) params);
+  gst_gl_allocation_params_free ((GstGLAllocationParams *) params);
+  gst_object_unref (allocator);
+
+  outbuf = gst_buffer_new ();
+  gst_buffer_append_memory (outbuf, (GstMemory *) mem);
+
+  fail_unless (gst_video_frame_map (&frame, &info, outbuf,
+          GST_MAP_WRITE | GST_MAP_GL));
+  gst_gl_context_thread_add (context, (GstGLContextThreadFunc) _draw_gl, mem);
+  gst_video_frame_unmap (&frame);
+
+  fail_unless (gst_video_frame_map (&frame, &info, outbuf, GST_MAP_READ));
+  for (i = 0; i < n_rects; i++) {
+    gint x, y;
+    guint w, h;
+    guint8 *pixel;
+    guint32 color;
+
+    gst_video_overlay_rectangle_get_render_rectangle (rects[i], &x, &y, &w,
+        &h);
+    pixel = (guint8 *) GST_VIDEO_FRAME_PLANE_DATA (&frame, 0)
+        + (y + h / 2) * GST_VIDEO_FRAME_PLANE_STRIDE (&frame, 0)
+        + (x + w / 2) * 4;
+    color = _rect_color (i);
+
+    /* the overlays are all opaque */
+    fail_unless_equals_int (pixel[0], (color >> 16) & 0xff);
+    fail_unless_equals_int (pixel[1], (color >> 8) & 0xff);
+    fail_unless_equals_int (pixel[2], color & 0xff);
+    fail_unless_equals_int (pixel[3], 0xff);
+  }
+  gst_video_frame_unmap (&frame);
+
+  gst_buffer_unref (outbuf);
+}
+
+GST_START_TEST (test_many_rectangles)
+{
+  GstVideoOverlayRectangle *rects[RECTS_PER_ROW * RECTS_PER_ROW];
+  GstBuffer *buf;
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (rects); i++)
+    rects[i] = _create_rectangle (i);
+
+  buf = _create_video_buffer (rects, G_N_ELEMENTS (rects));
+  gst_gl_overlay_compositor_upload_overlays (compositor, buf);
+  gst_buffer_unref (buf);
+  _render_and_check (rects, G_N_ELEMENTS (rects));
+
+  /* drop half of the rectangles and upload the others again, the remaining
+   * ones have to stay where they were in the atlas */
+  buf = _create_video_buffer (rects, G_N_ELEMENTS (rects) / 2);
+  gst_gl_overlay_compositor_upload_overlays (compositor, buf);
+  gst_buffer_unref (buf);
+  _render_and_check (rects, G_N_ELEMENTS (rects) / 2);
+
+  buf = _create_video_buffer (rects, G_N_ELEMENTS (rects));
+  gst_gl_overlay_compositor_upload_overlays (compositor, buf);
+  gst_buffer_unref (buf);
+  _render_and_check (rects, G_N_ELEMENTS (rects));
+
+  for (i = 0; i < G_N_ELEMENTS (rects); i++)
+    gst_video_overlay_rectangle_unref (rects[i]);
+}
+
+GST_END_TEST;
+
+static Suite *
+gst_gl_overlay_compositor_suite (void)
+{
+  Suite *s = suite_create ("GstGLOverlayCompositor");
+  TCase *tc_chain = tcase_create ("gloverlaycompositor");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_checked_fixture (tc_chain, setup, teardown);
+  tcase_add_test (tc_chain, test_many_rectangles);
+
+  return s;
+}
+
+GST_CHECK_MAIN (gst_gl_overlay_compositor);
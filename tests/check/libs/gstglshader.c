@@ -204,6 +204,85 @@ GST_START_TEST (test_get_attribute_location)
 
 GST_END_TEST;
 
+static GstGLShader *
+_new_default_shader (GstGLContext * context, gboolean use_cache)
+{
+  GstGLShader *shader;
+  GstGLSLStage *vert, *frag;
+  GError *error = NULL;
+
+  shader = gst_gl_shader_new (context);
+  gst_gl_shader_set_use_program_cache (shader, use_cache);
+
+  /* the stages are compiled and attached right away, cache or not */
+  vert = gst_glsl_stage_new_default_vertex (context);
+  fail_unless (gst_gl_shader_compile_attach_stage (shader, vert, &error));
+  fail_unless (gst_glsl_stage_get_handle (vert) != 0);
+  frag = gst_glsl_stage_new_default_fragment (context);
+  fail_unless (gst_gl_shader_compile_attach_stage (shader, frag, &error));
+  fail_unless (gst_glsl_stage_get_handle (frag) != 0);
+
+  fail_unless (gst_gl_shader_link (shader, &error));
+  fail_unless (error == NULL);
+
+  gst_gl_shader_use (shader);
+  fail_unless (gst_gl_shader_get_attribute_location (shader,
+          "a_position") != -1);
+  gst_gl_context_clear_shader (context);
+
+  return shader;
+}
+
+static void
+_test_program_cache_gl (GstGLContext * context, gpointer data)
+{
+  GstGLShader *shader;
+  GstGLSLStage *frag;
+  GError *error = NULL;
+  guint64 hits, misses;
+  gint i;
+
+  /* the cache is opt-in */
+  for (i = 0; i < 2; i++)
+    gst_object_unref (_new_default_shader (context, FALSE));
+  gst_gl_display_get_program_cache_stats (display, &hits, &misses);
+  fail_unless_equals_uint64 (hits, 0);
+  fail_unless_equals_uint64 (misses, 0);
+
+  for (i = 0; i < 2; i++)
+    gst_object_unref (_new_default_shader (context, TRUE));
+
+  gst_gl_display_get_program_cache_stats (display, &hits, &misses);
+  GST_INFO ("program cache hits %" G_GUINT64_FORMAT " misses %"
+      G_GUINT64_FORMAT, hits, misses);
+
+  /* nothing is cached without support for program binaries */
+  if (hits + misses > 0) {
+    fail_unless_equals_uint64 (misses, 1);
+    fail_unless_equals_uint64 (hits, 1);
+  }
+
+  /* compilation errors are still reported when attaching */
+  shader = gst_gl_shader_new (context);
+  gst_gl_shader_set_use_program_cache (shader, TRUE);
+  frag = gst_glsl_stage_new_with_string (context, GL_FRAGMENT_SHADER,
+      GST_GLSL_VERSION_NONE,
+      GST_GLSL_PROFILE_ES | GST_GLSL_PROFILE_COMPATIBILITY,
+      "void main () { this is not glsl; }");
+  fail_if (gst_gl_shader_compile_attach_stage (shader, frag, &error));
+  fail_unless (error != NULL);
+  g_clear_error (&error);
+  gst_object_unref (shader);
+}
+
+GST_START_TEST (test_program_cache)
+{
+  gst_gl_context_thread_add (context,
+      (GstGLContextThreadFunc) _test_program_cache_gl, NULL);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_gl_shader_suite (void)
 {
@@ -218,6 +297,7 @@ gst_gl_shader_suite (void)
   tcase_add_test (tc_chain, test_link);
   tcase_add_test (tc_chain, test_default_shader);
   tcase_add_test (tc_chain, test_get_attribute_location);
+  tcase_add_test (tc_chain, test_program_cache);
 
   return s;
 }
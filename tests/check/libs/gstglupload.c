@@ -415,6 +415,244 @@ GST_START_TEST (test_upload_gl_memory)
 
 GST_END_TEST;
 
+static GstBuffer *
+_upload_repeated_frame (GstBuffer * frame)
+{
+  GstBuffer *inbuf, *outbuf = NULL;
+  gint res;
+
+  /* a repeated frame is a new buffer sharing the memories of the original */
+  inbuf = gst_buffer_copy (frame);
+  res = gst_gl_upload_perform_with_buffer (upload, inbuf, &outbuf);
+  fail_unless (res == GST_GL_UPLOAD_DONE, "Failed to upload buffer");
+  fail_unless (GST_IS_BUFFER (outbuf));
+  gst_buffer_unref (inbuf);
+
+  return outbuf;
+}
+
+static void
+_check_data (GstBuffer * buffer, const gchar * data)
+{
+  GstMapInfo map_info;
+
+  fail_unless (gst_buffer_map (buffer, &map_info, GST_MAP_READ));
+  fail_unless_equals_int (map_info.size, WIDTH * HEIGHT * 4);
+  fail_unless (memcmp (map_info.data, data, WIDTH * HEIGHT * 4) == 0);
+  gst_buffer_unmap (buffer, &map_info);
+}
+
+static void
+_check_rgba_data (GstBuffer * buffer)
+{
+  _check_data (buffer, rgba_data);
+}
+
+GST_START_TEST (test_upload_reuse_textures)
+{
+  GstCaps *in_caps, *out_caps;
+  GstBuffer *frame, *outbuf1, *outbuf2, *outbuf3;
+
+  in_caps = gst_caps_from_string ("video/x-raw,format=RGBA,"
+      "width=10,height=10");
+  out_caps = gst_caps_from_string ("video/x-raw(memory:GLMemory),"
+      "format=RGBA,width=10,height=10");
+
+  gst_gl_upload_set_caps (upload, in_caps, out_caps);
+  gst_gl_upload_set_reuse_textures (upload, TRUE);
+
+  frame = gst_buffer_new_wrapped_full (0, rgba_data, WIDTH * HEIGHT * 4,
+      0, WIDTH * HEIGHT * 4, NULL, NULL);
+
+  /* the first upload wraps the input and caches a copy of the texture */
+  outbuf1 = _upload_repeated_frame (frame);
+  fail_unless_equals_int (gst_buffer_n_memory (outbuf1), 1);
+
+  /* the next ones output the cached copy without uploading again */
+  outbuf2 = _upload_repeated_frame (frame);
+  outbuf3 = _upload_repeated_frame (frame);
+  fail_unless_equals_int (gst_buffer_n_memory (outbuf2), 1);
+  fail_unless_equals_int (gst_buffer_n_memory (outbuf3), 1);
+  fail_if (gst_buffer_peek_memory (outbuf1, 0) ==
+      gst_buffer_peek_memory (outbuf2, 0));
+  fail_unless (gst_buffer_peek_memory (outbuf2, 0) ==
+      gst_buffer_peek_memory (outbuf3, 0));
+  _check_rgba_data (outbuf3);
+
+  /* the cached texture can't be modified in place by downstream */
+  fail_if (gst_memory_is_writable (gst_buffer_peek_memory (outbuf2, 0)));
+
+  /* a frame with different memories is uploaded again, and replaces the
+   * cache for its own repetitions */
+  {
+    GstBuffer *other = gst_buffer_copy_deep (frame);
+    GstBuffer *outbuf4 = _upload_repeated_frame (other);
+    GstBuffer *outbuf5 = _upload_repeated_frame (other);
+    GstBuffer *outbuf6 = _upload_repeated_frame (other);
+
+    fail_if (gst_buffer_peek_memory (outbuf4, 0) ==
+        gst_buffer_peek_memory (outbuf3, 0));
+    fail_if (gst_buffer_peek_memory (outbuf5, 0) ==
+        gst_buffer_peek_memory (outbuf3, 0));
+    fail_if (gst_buffer_peek_memory (outbuf4, 0) ==
+        gst_buffer_peek_memory (outbuf5, 0));
+    fail_unless (gst_buffer_peek_memory (outbuf5, 0) ==
+        gst_buffer_peek_memory (outbuf6, 0));
+    _check_rgba_data (outbuf6);
+
+    gst_buffer_unref (outbuf4);
+    gst_buffer_unref (outbuf5);
+    gst_buffer_unref (outbuf6);
+    gst_buffer_unref (other);
+  }
+
+  gst_buffer_unref (outbuf1);
+  gst_buffer_unref (outbuf2);
+  gst_buffer_unref (outbuf3);
+
+  gst_caps_unref (in_caps);
+  gst_caps_unref (out_caps);
+  gst_buffer_unref (frame);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_upload_reuse_textures_releases_input)
+{
+  GstCaps *in_caps, *out_caps;
+  GstBuffer *frame, *inbuf, *outbuf;
+  gint res;
+
+  in_caps = gst_caps_from_string ("video/x-raw,format=RGBA,"
+      "width=10,height=10");
+  out_caps = gst_caps_from_string ("video/x-raw(memory:GLMemory),"
+      "format=RGBA,width=10,height=10");
+
+  gst_gl_upload_set_caps (upload, in_caps, out_caps);
+  gst_gl_upload_set_reuse_textures (upload, TRUE);
+
+  frame = gst_buffer_new_wrapped_full (0, rgba_data, WIDTH * HEIGHT * 4,
+      0, WIDTH * HEIGHT * 4, NULL, NULL);
+  inbuf = gst_buffer_copy (frame);
+
+  res = gst_gl_upload_perform_with_buffer (upload, inbuf, &outbuf);
+  fail_unless (res == GST_GL_UPLOAD_DONE, "Failed to upload buffer");
+
+  /* the wrapped texture keeps the input mapped until it is released... */
+  fail_unless (GST_MINI_OBJECT_REFCOUNT_VALUE (inbuf) > 1);
+  gst_buffer_unref (outbuf);
+
+  /* ...but the cache must not keep the input buffer alive */
+  ASSERT_BUFFER_REFCOUNT (inbuf, "inbuf", 1);
+
+  /* the cache is still used for the next repeated frame */
+  outbuf = _upload_repeated_frame (frame);
+  _check_rgba_data (outbuf);
+  ASSERT_BUFFER_REFCOUNT (inbuf, "inbuf", 1);
+  gst_buffer_unref (outbuf);
+
+  gst_caps_unref (in_caps);
+  gst_caps_unref (out_caps);
+  gst_buffer_unref (inbuf);
+  gst_buffer_unref (frame);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_upload_reuse_textures_recycled_pool_buffer)
+{
+  GstCaps *in_caps, *out_caps;
+  GstBufferPool *pool;
+  GstStructure *config;
+  GstBuffer *buf, *outbuf;
+  GstMemory *mem;
+  GstMapInfo map_info;
+  gchar grey_data[WIDTH * HEIGHT * 4];
+
+  in_caps = gst_caps_from_string ("video/x-raw,format=RGBA,"
+      "width=10,height=10");
+  out_caps = gst_caps_from_string ("video/x-raw(memory:GLMemory),"
+      "format=RGBA,width=10,height=10");
+
+  gst_gl_upload_set_caps (upload, in_caps, out_caps);
+  gst_gl_upload_set_reuse_textures (upload, TRUE);
+
+  pool = gst_buffer_pool_new ();
+  config = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_set_params (config, in_caps, WIDTH * HEIGHT * 4, 1,
+      1);
+  fail_unless (gst_buffer_pool_set_config (pool, config));
+  fail_unless (gst_buffer_pool_set_active (pool, TRUE));
+
+  fail_unless_equals_int (gst_buffer_pool_acquire_buffer (pool, &buf, NULL),
+      GST_FLOW_OK);
+  gst_buffer_fill (buf, 0, rgba_data, WIDTH * HEIGHT * 4);
+
+  outbuf = _upload_repeated_frame (buf);
+  _check_rgba_data (outbuf);
+  gst_buffer_unref (outbuf);
+
+  /* the cache keeps the pooled memory read-only, so upstream can't write the
+   * next frame into it behind our back */
+  mem = gst_buffer_peek_memory (buf, 0);
+  fail_if (gst_memory_is_writable (mem));
+  fail_if (gst_memory_map (mem, &map_info, GST_MAP_WRITE));
+
+  /* recycle the buffer and write a new frame into what the pool hands out */
+  gst_buffer_unref (buf);
+  fail_unless_equals_int (gst_buffer_pool_acquire_buffer (pool, &buf, NULL),
+      GST_FLOW_OK);
+  memset (grey_data, 0x40, sizeof (grey_data));
+  fail_unless (gst_buffer_map (buf, &map_info, GST_MAP_WRITE));
+  memcpy (map_info.data, grey_data, sizeof (grey_data));
+  gst_buffer_unmap (buf, &map_info);
+
+  /* the new frame is uploaded, not the cached texture of the old one */
+  outbuf = _upload_repeated_frame (buf);
+  _check_data (outbuf, grey_data);
+  gst_buffer_unref (outbuf);
+  gst_buffer_unref (buf);
+
+  fail_unless (gst_buffer_pool_set_active (pool, FALSE));
+  gst_object_unref (pool);
+  gst_caps_unref (in_caps);
+  gst_caps_unref (out_caps);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_upload_reuse_textures_disabled)
+{
+  GstCaps *in_caps, *out_caps;
+  GstBuffer *frame, *outbuf1, *outbuf2;
+
+  in_caps = gst_caps_from_string ("video/x-raw,format=RGBA,"
+      "width=10,height=10");
+  out_caps = gst_caps_from_string ("video/x-raw(memory:GLMemory),"
+      "format=RGBA,width=10,height=10");
+
+  gst_gl_upload_set_caps (upload, in_caps, out_caps);
+
+  frame = gst_buffer_new_wrapped_full (0, rgba_data, WIDTH * HEIGHT * 4,
+      0, WIDTH * HEIGHT * 4, NULL, NULL);
+
+  /* off by default: every frame gets its own texture */
+  outbuf1 = _upload_repeated_frame (frame);
+  outbuf2 = _upload_repeated_frame (frame);
+  fail_if (gst_buffer_peek_memory (outbuf1, 0) ==
+      gst_buffer_peek_memory (outbuf2, 0));
+  gst_buffer_unref (outbuf1);
+
+  /* and only the outputs reference the input memory */
+  gst_buffer_unref (outbuf2);
+  fail_unless (gst_memory_is_writable (gst_buffer_peek_memory (frame, 0)));
+
+  gst_caps_unref (in_caps);
+  gst_caps_unref (out_caps);
+  gst_buffer_unref (frame);
+}
+
+GST_END_TEST;
 
 static Suite *
 gst_gl_upload_suite (void)
@@ -426,6 +664,10 @@ gst_gl_upload_suite (void)
   tcase_add_checked_fixture (tc_chain, setup, teardown);
   tcase_add_test (tc_chain, test_upload_data);
   tcase_add_test (tc_chain, test_upload_gl_memory);
+  tcase_add_test (tc_chain, test_upload_reuse_textures);
+  tcase_add_test (tc_chain, test_upload_reuse_textures_releases_input);
+  tcase_add_test (tc_chain, test_upload_reuse_textures_recycled_pool_buffer);
+  tcase_add_test (tc_chain, test_upload_reuse_textures_disabled);
 
   return s;
 }
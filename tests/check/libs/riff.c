@@ -0,0 +1,276 @@
+/* GStreamer unit tests for the RIFF support library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+#include <gst/riff/riff.h>
+
+static void
+check_video_caps (guint32 fourcc, const gchar * expected_caps,
+    const gchar * expected_name)
+{
+  GstCaps *caps, *expected;
+  gchar *codec_name = NULL;
+
+  caps = gst_riff_create_video_caps (fourcc, NULL, NULL, NULL, NULL,
+      &codec_name);
+  fail_unless (caps != NULL);
+  fail_unless_equals_string (codec_name, expected_name);
+
+  expected = gst_caps_from_string (expected_caps);
+  GST_LOG ("caps: %" GST_PTR_FORMAT, caps);
+  fail_unless (gst_caps_is_equal (caps, expected));
+  fail_unless (gst_caps_is_writable (caps));
+
+  gst_caps_unref (expected);
+  gst_caps_unref (caps);
+  g_free (codec_name);
+}
+
+GST_START_TEST (test_video_caps)
+{
+  gst_riff_strh strh = { 0, };
+  gst_riff_strf_vids strf = { 0, };
+  GstStructure *s;
+  GstCaps *caps;
+  gint w, h, fps_n, fps_d;
+
+  check_video_caps (GST_MAKE_FOURCC ('X', 'V', 'I', 'D'),
+      "video/mpeg, mpegversion = (int) 4, systemstream = (boolean) false, "
+      "framerate = (fraction) [ 0/1, 2147483647/1 ], "
+      "width = (int) [ 1, 2147483647 ], height = (int) [ 1, 2147483647 ]",
+      "MPEG-4");
+  check_video_caps (GST_RIFF_H263,
+      "video/x-h263, variant = (string) itu, "
+      "framerate = (fraction) [ 0/1, 2147483647/1 ], "
+      "width = (int) [ 1, 2147483647 ], height = (int) [ 1, 2147483647 ]",
+      "ITU H.26n");
+  check_video_caps (GST_MAKE_FOURCC (0x01, 0x00, 0x00, 0x10),
+      "video/mpeg, systemstream = (boolean) false, mpegversion = (int) 1, "
+      "framerate = (fraction) [ 0/1, 2147483647/1 ], "
+      "width = (int) [ 1, 2147483647 ], height = (int) [ 1, 2147483647 ]",
+      "MPEG-1 video");
+  /* handled by the switch, not the table */
+  check_video_caps (GST_MAKE_FOURCC ('L', '2', '6', '4'),
+      "video/x-h264, variant = (string) lead, "
+      "framerate = (fraction) [ 0/1, 2147483647/1 ], "
+      "width = (int) [ 1, 2147483647 ], height = (int) [ 1, 2147483647 ]",
+      "Lead H.264");
+
+  /* the cached caps must not be modified by callers */
+  strh.rate = 25;
+  strh.scale = 1;
+  strf.width = 320;
+  strf.height = 240;
+  caps = gst_riff_create_video_caps (GST_MAKE_FOURCC ('X', 'V', 'I', 'D'),
+      &strh, &strf, NULL, NULL, NULL);
+  fail_unless (caps != NULL);
+  s = gst_caps_get_structure (caps, 0);
+  fail_unless (gst_structure_get_int (s, "width", &w));
+  fail_unless (gst_structure_get_int (s, "height", &h));
+  fail_unless (gst_structure_get_fraction (s, "framerate", &fps_n, &fps_d));
+  fail_unless_equals_int (w, 320);
+  fail_unless_equals_int (h, 240);
+  fail_unless_equals_int (fps_n, 25);
+  fail_unless_equals_int (fps_d, 1);
+  gst_caps_unref (caps);
+
+  check_video_caps (GST_MAKE_FOURCC ('X', 'V', 'I', 'D'),
+      "video/mpeg, mpegversion = (int) 4, systemstream = (boolean) false, "
+      "framerate = (fraction) [ 0/1, 2147483647/1 ], "
+      "width = (int) [ 1, 2147483647 ], height = (int) [ 1, 2147483647 ]",
+      "MPEG-4");
+
+  fail_unless (gst_riff_create_video_caps (GST_MAKE_FOURCC ('?', '?', '?',
+              '?'), NULL, NULL, NULL, NULL, NULL) == NULL);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_audio_caps)
+{
+  gst_riff_strf_auds strf = { 0, };
+  GstStructure *s;
+  GstCaps *caps;
+  gchar *codec_name = NULL;
+  gint rate, channels, mpegversion, layer;
+
+  strf.format = GST_RIFF_WAVE_FORMAT_MPEGL3;
+  strf.rate = 44100;
+  strf.channels = 2;
+  caps = gst_riff_create_audio_caps (GST_RIFF_WAVE_FORMAT_MPEGL3, NULL, &strf,
+      NULL, NULL, &codec_name, NULL);
+  fail_unless (caps != NULL);
+  fail_unless_equals_string (codec_name, "MPEG-1 layer 3");
+  g_free (codec_name);
+
+  s = gst_caps_get_structure (caps, 0);
+  fail_unless (gst_structure_has_name (s, "audio/mpeg"));
+  fail_unless (gst_structure_get_int (s, "mpegversion", &mpegversion));
+  fail_unless (gst_structure_get_int (s, "layer", &layer));
+  fail_unless (gst_structure_get_int (s, "rate", &rate));
+  fail_unless (gst_structure_get_int (s, "channels", &channels));
+  fail_unless_equals_int (mpegversion, 1);
+  fail_unless_equals_int (layer, 3);
+  fail_unless_equals_int (rate, 44100);
+  fail_unless_equals_int (channels, 2);
+  gst_caps_unref (caps);
+
+  /* DTS doesn't get rate and channels from the header */
+  strf.format = GST_RIFF_WAVE_FORMAT_DTS;
+  caps = gst_riff_create_audio_caps (GST_RIFF_WAVE_FORMAT_DTS, NULL, &strf,
+      NULL, NULL, NULL, NULL);
+  fail_unless (caps != NULL);
+  s = gst_caps_get_structure (caps, 0);
+  fail_unless (gst_structure_has_name (s, "audio/x-dts"));
+  fail_if (gst_structure_has_field (s, "rate"));
+  fail_if (gst_structure_has_field (s, "channels"));
+  gst_caps_unref (caps);
+
+  fail_unless (gst_riff_create_audio_caps (0x7777, NULL, NULL, NULL, NULL, NULL,
+          NULL) == NULL);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_template_caps)
+{
+  GstCaps *caps1, *caps2;
+
+  caps1 = gst_riff_create_video_template_caps ();
+  caps2 = gst_riff_create_video_template_caps ();
+  fail_unless (caps1 != caps2);
+  fail_unless (gst_caps_is_writable (caps1));
+  fail_unless (gst_caps_is_equal (caps1, caps2));
+  fail_unless (gst_caps_get_size (caps1) > 50);
+  gst_caps_append (caps1, gst_caps_new_empty_simple ("video/x-test"));
+  fail_if (gst_caps_is_equal (caps1, caps2));
+  gst_caps_unref (caps1);
+  gst_caps_unref (caps2);
+
+  caps1 = gst_riff_create_audio_template_caps ();
+  caps2 = gst_riff_create_audio_template_caps ();
+  fail_unless (gst_caps_is_writable (caps1));
+  fail_unless (gst_caps_is_equal (caps1, caps2));
+  gst_caps_unref (caps1);
+  gst_caps_unref (caps2);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_caps_performance)
+{
+  static const guint32 fourccs[] = {
+    GST_MAKE_FOURCC ('X', 'V', 'I', 'D'),
+    GST_MAKE_FOURCC ('H', '2', '6', '4'),
+    GST_MAKE_FOURCC ('D', 'I', 'V', 'X'),
+    GST_MAKE_FOURCC ('M', 'J', 'P', 'G'),
+    GST_MAKE_FOURCC ('W', 'M', 'V', '3'),
+    GST_MAKE_FOURCC ('c', 'v', 'i', 'd'),
+  };
+  static const guint16 codec_ids[] = {
+    GST_RIFF_WAVE_FORMAT_MPEGL3,
+    GST_RIFF_WAVE_FORMAT_A52,
+    GST_RIFF_WAVE_FORMAT_AAC,
+    GST_RIFF_WAVE_FORMAT_VORBIS1,
+  };
+  gst_riff_strf_auds strf_auds = { 0, };
+  gst_riff_strf_vids strf_vids = { 0, };
+  gst_riff_strh strh = { 0, };
+  GTimer *timer;
+  gdouble elapsed;
+  guint i, n = 0;
+
+/* set to something larger to do benchmarks */
+#define TIME 0.01
+
+  strh.rate = 25;
+  strh.scale = 1;
+  strf_vids.width = 640;
+  strf_vids.height = 480;
+  strf_auds.rate = 48000;
+  strf_auds.channels = 2;
+
+  timer = g_timer_new ();
+  do {
+    for (i = 0; i < G_N_ELEMENTS (fourccs); i++) {
+      GstCaps *caps;
+      gchar *codec_name = NULL;
+
+      caps = gst_riff_create_video_caps (fourccs[i], &strh, &strf_vids, NULL,
+          NULL, &codec_name);
+      fail_unless (caps != NULL);
+      gst_caps_unref (caps);
+      g_free (codec_name);
+      n++;
+    }
+    for (i = 0; i < G_N_ELEMENTS (codec_ids); i++) {
+      GstCaps *caps;
+      gchar *codec_name = NULL;
+
+      caps = gst_riff_create_audio_caps (codec_ids[i], NULL, &strf_auds, NULL,
+          NULL, &codec_name, NULL);
+      fail_unless (caps != NULL);
+      gst_caps_unref (caps);
+      g_free (codec_name);
+      n++;
+    }
+    elapsed = g_timer_elapsed (timer, NULL);
+  } while (elapsed < TIME);
+
+  GST_DEBUG ("%f caps/sec", n / elapsed);
+
+  n = 0;
+  g_timer_start (timer);
+  do {
+    gst_caps_unref (gst_riff_create_video_template_caps ());
+    gst_caps_unref (gst_riff_create_audio_template_caps ());
+    n++;
+    elapsed = g_timer_elapsed (timer, NULL);
+  } while (elapsed < TIME);
+
+  GST_DEBUG ("%f template caps/sec", n / elapsed);
+
+  g_timer_destroy (timer);
+
+#undef TIME
+}
+
+GST_END_TEST;
+
+static Suite *
+riff_suite (void)
+{
+  Suite *s = suite_create ("riff");
+  TCase *tc_chain = tcase_create ("general");
+
+  gst_riff_init ();
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_video_caps);
+  tcase_add_test (tc_chain, test_audio_caps);
+  tcase_add_test (tc_chain, test_template_caps);
+  tcase_add_test (tc_chain, test_caps_performance);
+
+  return s;
+}
+
+GST_CHECK_MAIN (riff);
@@ -125,6 +125,23 @@ static const gchar caps_video_rtcp_fb_all_pt_102[] =
     "clock-rate=(int)90000, encoding-name=(string)H264, "
     "rtcp-fb-nack=(boolean)true, rtcp-fb-nack-pli=(boolean)true";
 
+static const gchar *sdp_multicast = "v=0\r\n"
+    "o=alice 2890844526 2890844526 IN IP4 host.example.com\r\n"
+    "s=Multicast\r\n"
+    "c=IN IP4 224.2.36.42/127/3\r\n"
+    "b=AS:4096\r\n"
+    "t=2873397496 2873404696\r\n"
+    "r=604800 3600 0 90000\r\n"
+    "z=2882844526 -1h 2898848070 0\r\n"
+    "k=clear:secret\r\n"
+    "a=recvonly\r\n"
+    "m=audio 49170/2 RTP/AVP 0 8\r\n"
+    "b=RR:0\r\n"
+    "a=rtpmap:0 PCMU/8000\r\n"
+    "m=video 51372 RTP/AVP 99\r\n"
+    "c=IN IP6 FF15::101/3\r\n"
+    "a=rtpmap:99 h263-1998/90000\r\n";
+
 /* *INDENT-ON* */
 
 GST_START_TEST (boxed)
@@ -568,6 +585,47 @@ GST_START_TEST (caps_from_media_really_const)
   gst_sdp_message_free (message);
 }
 
+GST_END_TEST
+GST_START_TEST (parse_reuse)
+{
+  GstSDPMessage *message;
+  gchar *serialized;
+  guint i;
+
+  gst_sdp_message_new (&message);
+
+  /* parsing into a message that was reset with gst_sdp_message_init() must
+   * give the same result as parsing into a fresh one */
+  for (i = 0; i < 3; i++) {
+    gst_sdp_message_init (message);
+    fail_unless_equals_int (gst_sdp_message_parse_buffer ((guint8 *)
+            sdp_multicast, strlen (sdp_multicast), message), GST_SDP_OK);
+
+    fail_unless_equals_int (gst_sdp_message_medias_len (message), 2);
+    fail_unless_equals_int (message->connection.ttl, 127);
+    fail_unless_equals_int (message->connection.addr_number, 3);
+    fail_unless_equals_int (gst_sdp_message_get_bandwidth (message,
+            0)->bandwidth, 4096);
+    fail_unless_equals_string (message->key.data, "secret");
+    fail_unless_equals_int (gst_sdp_media_formats_len
+        (gst_sdp_message_get_media (message, 0)), 2);
+    fail_unless_equals_int (gst_sdp_message_get_media (message, 0)->num_ports,
+        2);
+
+    serialized = gst_sdp_message_as_text (message);
+    /* t= and r= and z= are not parsed */
+    fail_unless (strstr (serialized, "c=IN IP4 224.2.36.42/127/3\r\n"));
+    fail_unless (strstr (serialized, "b=AS:4096\r\n"));
+    fail_unless (strstr (serialized, "k=clear:secret\r\n"));
+    fail_unless (strstr (serialized, "m=audio 49170/2 RTP/AVP 0 8\r\n"));
+    fail_unless (strstr (serialized, "b=RR:0\r\n"));
+    fail_unless (strstr (serialized, "c=IN IP6 FF15::101/3\r\n"));
+    g_free (serialized);
+  }
+
+  gst_sdp_message_free (message);
+}
+
 GST_END_TEST
 /*
  * End of test cases
@@ -590,6 +648,7 @@ sdp_suite (void)
   tcase_add_test (tc_chain, caps_from_media_rtcp_fb_all);
   tcase_add_test (tc_chain, media_from_caps_rtcp_fb_pt_100);
   tcase_add_test (tc_chain, media_from_caps_rtcp_fb_pt_101);
+  tcase_add_test (tc_chain, parse_reuse);
 
   return s;
 }
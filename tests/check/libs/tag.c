@@ -756,6 +756,153 @@ GST_START_TEST (test_id3v2_priv_tag)
 
 GST_END_TEST;
 
+GST_START_TEST (test_id3v2_skip_frames)
+{
+  const guint8 id3v2[] = {
+    0x49, 0x44, 0x33, 0x04, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x21, 0x54, 0x49, 0x54, 0x32, 0x00, 0x00,
+    0x00, 0x05, 0x00, 0x00, 0x03, 0x54, 0x65, 0x73,
+    0x74, 0x50, 0x52, 0x49, 0x56, 0x00, 0x00, 0x00,
+    0x08, 0x00, 0x00, 0x6f, 0x77, 0x6e, 0x00, 0x01,
+    0x02, 0x03, 0x04
+  };
+  const gchar *skip_frames[] = { "PRIV", NULL };
+  GstTagList *tags;
+  GstBuffer *buf;
+  gchar *title = NULL;
+
+  buf = gst_buffer_new_allocate (NULL, sizeof (id3v2), NULL);
+  gst_buffer_fill (buf, 0, id3v2, sizeof (id3v2));
+
+  tags = gst_tag_list_from_id3v2_tag_filtered (buf, NULL);
+  fail_if (tags == NULL, "Failed to parse ID3 tag");
+  fail_unless (gst_tag_list_get_tag_size (tags, GST_TAG_PRIVATE_DATA) == 1);
+  gst_tag_list_unref (tags);
+
+  tags = gst_tag_list_from_id3v2_tag_filtered (buf, skip_frames);
+  gst_buffer_unref (buf);
+  fail_if (tags == NULL, "Failed to parse ID3 tag");
+
+  GST_LOG ("tags: %" GST_PTR_FORMAT, tags);
+
+  fail_unless (gst_tag_list_get_tag_size (tags, GST_TAG_PRIVATE_DATA) == 0);
+  fail_unless (gst_tag_list_get_string (tags, GST_TAG_TITLE, &title));
+  fail_unless_equals_string (title, "Test");
+  g_free (title);
+
+  gst_tag_list_unref (tags);
+}
+
+GST_END_TEST;
+
+static void
+append_syncsafe (GByteArray * arr, guint32 size)
+{
+  guint8 b[4];
+
+  b[0] = (size >> 21) & 0x7f;
+  b[1] = (size >> 14) & 0x7f;
+  b[2] = (size >> 7) & 0x7f;
+  b[3] = size & 0x7f;
+  g_byte_array_append (arr, b, 4);
+}
+
+static void
+append_id3v24_frame (GByteArray * arr, const gchar * id, const guint8 * hdr,
+    guint hdr_size, guint8 fill, guint fill_size)
+{
+  const guint8 flags[2] = { 0, 0 };
+  guint i;
+
+  g_byte_array_append (arr, (const guint8 *) id, 4);
+  append_syncsafe (arr, hdr_size + fill_size);
+  g_byte_array_append (arr, flags, 2);
+  g_byte_array_append (arr, hdr, hdr_size);
+  for (i = 0; i < fill_size; i++)
+    g_byte_array_append (arr, &fill, 1);
+}
+
+/* checks that the data of @buf points into the data of @tag_map */
+static void
+check_shares_tag_memory (GstBuffer * buf, GstMapInfo * tag_map)
+{
+  GstMapInfo map;
+
+  fail_unless_equals_int (gst_buffer_n_memory (buf), 1);
+  fail_unless (gst_buffer_map (buf, &map, GST_MAP_READ));
+  fail_unless (map.data >= tag_map->data);
+  fail_unless (map.data + map.size <= tag_map->data + tag_map->size);
+  gst_buffer_unmap (buf, &map);
+}
+
+GST_START_TEST (test_id3v2_large_frames_shared)
+{
+  const guint8 priv_hdr[] = { 'o', 'w', 'n', 0 };
+  const guint8 apic_hdr[] = {
+    0x00, 'i', 'm', 'a', 'g', 'e', '/', 'p', 'n', 'g', 0x00, 0x03, 0x00,
+    /* PNG signature and IHDR chunk */
+    0x89, 'P', 'N', 'G', 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d,
+    'I', 'H', 'D', 'R', 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10,
+    0x08, 0x02, 0x00, 0x00, 0x00
+  };
+  /* larger than ID3V2_SHARE_MIN_SIZE, 4096 */
+  const guint large = 4096 + 100;
+  const guint8 id3_hdr[] = { 'I', 'D', '3', 0x04, 0x00, 0x00 };
+  GByteArray *frames, *tag;
+  GstTagList *tags;
+  GstSample *sample = NULL;
+  GstBuffer *buf, *data;
+  GstMapInfo tag_map;
+  gsize size;
+
+  frames = g_byte_array_new ();
+  append_id3v24_frame (frames, "PRIV", priv_hdr, sizeof (priv_hdr), 0x42,
+      large);
+  append_id3v24_frame (frames, "APIC", apic_hdr, sizeof (apic_hdr), 0x00,
+      large);
+
+  tag = g_byte_array_new ();
+  g_byte_array_append (tag, id3_hdr, sizeof (id3_hdr));
+  append_syncsafe (tag, frames->len);
+  g_byte_array_append (tag, frames->data, frames->len);
+  g_byte_array_free (frames, TRUE);
+
+  buf = gst_buffer_new_allocate (NULL, tag->len, NULL);
+  gst_buffer_fill (buf, 0, tag->data, tag->len);
+  g_byte_array_free (tag, TRUE);
+
+  tags = gst_tag_list_from_id3v2_tag (buf);
+  fail_if (tags == NULL, "Failed to parse ID3 tag");
+  GST_LOG ("tags: %" GST_PTR_FORMAT, tags);
+
+  fail_unless (gst_buffer_map (buf, &tag_map, GST_MAP_READ));
+
+  /* the private data is not copied out of the tag buffer */
+  fail_unless (gst_tag_list_get_sample (tags, GST_TAG_PRIVATE_DATA, &sample));
+  data = gst_sample_get_buffer (sample);
+  fail_unless_equals_int (gst_buffer_get_size (data), large);
+  check_shares_tag_memory (data, &tag_map);
+  gst_sample_unref (sample);
+  sample = NULL;
+
+  /* neither is the picture, if the PNG typefinder is available */
+  if (gst_tag_list_get_sample (tags, GST_TAG_IMAGE, &sample)) {
+    data = gst_sample_get_buffer (sample);
+    size = large + sizeof (apic_hdr) - 13;
+    fail_unless_equals_int (gst_buffer_get_size (data), size);
+    check_shares_tag_memory (data, &tag_map);
+    gst_sample_unref (sample);
+  } else {
+    GST_INFO ("no image typefinder, image not checked");
+  }
+
+  gst_buffer_unmap (buf, &tag_map);
+  gst_tag_list_unref (tags);
+  gst_buffer_unref (buf);
+}
+
+GST_END_TEST;
+
 static GstTagList *
 parse_id3v2_tag_from_data (const guint8 * id3v2, gsize id3v2_size)
 {
@@ -1588,6 +1735,85 @@ GST_START_TEST (test_exif_multiple_tags)
 
 GST_END_TEST;
 
+GST_START_TEST (test_xmp_exif_performance)
+{
+  GstTagList *taglist, *result;
+  GstBuffer *buf;
+  GstMapInfo map;
+  GTimer *timer;
+  gdouble elapsed;
+  gchar *str = NULL;
+  guint n = 0;
+
+/* set to something larger to do benchmarks */
+#define TIME 0.01
+
+  taglist = gst_tag_list_new (GST_TAG_ARTIST, "artist & <friends>",
+      GST_TAG_TITLE, "it's a \"title\"", GST_TAG_COPYRIGHT, "copyright",
+      GST_TAG_DEVICE_MANUFACTURER, "make", GST_TAG_DEVICE_MODEL, "model",
+      GST_TAG_GEO_LOCATION_LATITUDE, 45.5,
+      GST_TAG_GEO_LOCATION_LONGITUDE, -10.25,
+      GST_TAG_GEO_LOCATION_ELEVATION, 120.0,
+      GST_TAG_IMAGE_HORIZONTAL_PPI, 300.0, NULL);
+  gst_tag_list_add (taglist, GST_TAG_MERGE_APPEND, GST_TAG_KEYWORDS, "k1",
+      GST_TAG_KEYWORDS, "k2\x01", GST_TAG_KEYWORDS, "k3", NULL);
+
+  /* values must be written escaped */
+  buf = gst_tag_list_to_xmp_buffer (taglist, TRUE, NULL);
+  fail_unless (gst_buffer_map (buf, &map, GST_MAP_READ));
+  fail_unless (g_strstr_len ((gchar *) map.data, map.size,
+          "artist &amp; &lt;friends&gt;") != NULL);
+  fail_unless (g_strstr_len ((gchar *) map.data, map.size,
+          "it&apos;s a &quot;title&quot;") != NULL);
+  fail_unless (g_strstr_len ((gchar *) map.data, map.size,
+          "k2&#x1;") != NULL);
+  gst_buffer_unmap (buf, &map);
+
+  result = gst_tag_list_from_xmp_buffer (buf);
+  fail_unless (result != NULL);
+  fail_unless (gst_tag_list_get_string (result, GST_TAG_COPYRIGHT, &str));
+  fail_unless_equals_string (str, "copyright");
+  g_free (str);
+  fail_unless_equals_int (gst_tag_list_get_tag_size (result, GST_TAG_KEYWORDS),
+      3);
+  gst_tag_list_unref (result);
+  gst_buffer_unref (buf);
+
+  timer = g_timer_new ();
+  do {
+    buf = gst_tag_list_to_xmp_buffer (taglist, TRUE, NULL);
+    result = gst_tag_list_from_xmp_buffer (buf);
+    fail_unless (result != NULL);
+    gst_tag_list_unref (result);
+    gst_buffer_unref (buf);
+    n += gst_tag_list_n_tags (taglist);
+    elapsed = g_timer_elapsed (timer, NULL);
+  } while (elapsed < TIME);
+
+  GST_DEBUG ("%f xmp tags/sec", n / elapsed);
+
+  n = 0;
+  g_timer_start (timer);
+  do {
+    buf = gst_tag_list_to_exif_buffer_with_tiff_header (taglist);
+    result = gst_tag_list_from_exif_buffer_with_tiff_header (buf);
+    fail_unless (result != NULL);
+    gst_tag_list_unref (result);
+    gst_buffer_unref (buf);
+    n += gst_tag_list_n_tags (taglist);
+    elapsed = g_timer_elapsed (timer, NULL);
+  } while (elapsed < TIME);
+
+  GST_DEBUG ("%f exif tags/sec", n / elapsed);
+
+  g_timer_destroy (timer);
+  gst_tag_list_unref (taglist);
+
+#undef TIME
+}
+
+GST_END_TEST;
+
 
 GST_START_TEST (test_exif_tags_serialization_deserialization)
 {
@@ -1977,6 +2203,8 @@ tag_suite (void)
   tcase_add_test (tc_chain, test_id3_tags);
   tcase_add_test (tc_chain, test_id3v1_utf8_tag);
   tcase_add_test (tc_chain, test_id3v2_priv_tag);
+  tcase_add_test (tc_chain, test_id3v2_skip_frames);
+  tcase_add_test (tc_chain, test_id3v2_large_frames_shared);
   tcase_add_test (tc_chain, test_id3v2_extended_header);
   tcase_add_test (tc_chain, test_id3v2_string_list_utf16);
   tcase_add_test (tc_chain, test_language_utils);
@@ -1988,6 +2216,7 @@ tag_suite (void)
   tcase_add_test (tc_chain, test_exif_parsing);
   tcase_add_test (tc_chain, test_exif_tags_serialization_deserialization);
   tcase_add_test (tc_chain, test_exif_multiple_tags);
+  tcase_add_test (tc_chain, test_xmp_exif_performance);
   return s;
 }
 
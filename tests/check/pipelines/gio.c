@@ -25,7 +25,9 @@
 
 #include <gst/check/gstcheck.h>
 #include <gst/check/gstbufferstraw.h>
+#include <gst/check/gstharness.h>
 #include <gio/gio.h>
+#include <glib/gstdio.h>
 
 static gboolean got_eos = FALSE;
 
@@ -153,6 +155,451 @@ GST_START_TEST (test_memory_stream)
 
 GST_END_TEST;
 
+/* output stream whose writes can be blocked or made to fail */
+typedef struct
+{
+  GOutputStream parent;
+
+  GMutex lock;
+  GCond cond;
+  gboolean block;
+  gboolean fail;
+  guint writes;
+  gboolean cancelled;
+  GByteArray *data;
+} TestOutputStream;
+
+typedef GOutputStreamClass TestOutputStreamClass;
+
+GType test_output_stream_get_type (void);
+G_DEFINE_TYPE (TestOutputStream, test_output_stream, G_TYPE_OUTPUT_STREAM);
+
+static gssize
+test_output_stream_write (GOutputStream * stream, const void *buffer,
+    gsize count, GCancellable * cancellable, GError ** error)
+{
+  TestOutputStream *self = (TestOutputStream *) stream;
+  gssize ret = count;
+
+  g_mutex_lock (&self->lock);
+  self->writes++;
+  g_cond_broadcast (&self->cond);
+
+  while (self->block && !g_cancellable_is_cancelled (cancellable))
+    g_cond_wait_until (&self->cond, &self->lock,
+        g_get_monotonic_time () + 10 * G_TIME_SPAN_MILLISECOND);
+
+  if (g_cancellable_set_error_if_cancelled (cancellable, error)) {
+    self->cancelled = TRUE;
+    ret = -1;
+  } else if (self->fail) {
+    g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_FAILED, "test error");
+    ret = -1;
+  } else {
+    g_byte_array_append (self->data, buffer, count);
+  }
+  g_mutex_unlock (&self->lock);
+
+  return ret;
+}
+
+static void
+test_output_stream_finalize (GObject * object)
+{
+  TestOutputStream *self = (TestOutputStream *) object;
+
+  g_byte_array_unref (self->data);
+  g_mutex_clear (&self->lock);
+  g_cond_clear (&self->cond);
+
+  G_OBJECT_CLASS (test_output_stream_parent_class)->finalize (object);
+}
+
+static void
+test_output_stream_class_init (TestOutputStreamClass * klass)
+{
+  G_OBJECT_CLASS (klass)->finalize = test_output_stream_finalize;
+  klass->write_fn = test_output_stream_write;
+}
+
+static void
+test_output_stream_init (TestOutputStream * self)
+{
+  g_mutex_init (&self->lock);
+  g_cond_init (&self->cond);
+  self->data = g_byte_array_new ();
+}
+
+static void
+test_output_stream_set_block (TestOutputStream * stream, gboolean block)
+{
+  g_mutex_lock (&stream->lock);
+  stream->block = block;
+  g_cond_broadcast (&stream->cond);
+  g_mutex_unlock (&stream->lock);
+}
+
+static void
+test_output_stream_wait_writes (TestOutputStream * stream, guint writes)
+{
+  g_mutex_lock (&stream->lock);
+  while (stream->writes < writes)
+    g_cond_wait (&stream->cond, &stream->lock);
+  g_mutex_unlock (&stream->lock);
+}
+
+static GstHarness *
+setup_write_behind_sink (TestOutputStream * stream, guint64 max_pending_bytes)
+{
+  GstElement *sink;
+  GstHarness *h;
+
+  sink = gst_element_factory_make ("giostreamsink", NULL);
+  fail_unless (sink != NULL);
+  g_object_set (sink, "stream", stream, "write-behind", TRUE,
+      "max-pending-bytes", max_pending_bytes, NULL);
+
+  h = gst_harness_new_with_element (sink, "sink", NULL);
+  gst_harness_set_src_caps_str (h, "application/x-test");
+  gst_object_unref (sink);
+
+  return h;
+}
+
+static GstBuffer *
+create_data_buffer (guint8 value, gsize size)
+{
+  GstBuffer *buf = gst_buffer_new_allocate (NULL, size, NULL);
+
+  gst_buffer_memset (buf, 0, value, size);
+
+  return buf;
+}
+
+static guint64
+get_pending_stat (GstHarness * h, const gchar * field)
+{
+  GstStructure *stats;
+  guint64 value = 0;
+
+  g_object_get (h->element, "write-stats", &stats, NULL);
+  fail_unless (gst_structure_get_uint64 (stats, field, &value));
+  gst_structure_free (stats);
+
+  return value;
+}
+
+typedef struct
+{
+  GstHarness *h;
+  GstBuffer *buf;
+  GstFlowReturn ret;
+  gboolean done;
+} PushData;
+
+static gpointer
+push_thread (PushData * data)
+{
+  data->ret = gst_harness_push (data->h, data->buf);
+  g_atomic_int_set (&data->done, TRUE);
+
+  return NULL;
+}
+
+GST_START_TEST (test_write_behind_queue_bound)
+{
+  TestOutputStream *stream;
+  PushData data = { NULL, };
+  GThread *thread;
+  GstHarness *h;
+
+  stream = g_object_new (test_output_stream_get_type (), NULL);
+  h = setup_write_behind_sink (stream, 100);
+
+  /* the writer blocks on the first buffer, the next one is queued */
+  test_output_stream_set_block (stream, TRUE);
+  fail_unless_equals_int (gst_harness_push (h, create_data_buffer (1, 40)),
+      GST_FLOW_OK);
+  test_output_stream_wait_writes (stream, 1);
+  fail_unless_equals_int (gst_harness_push (h, create_data_buffer (2, 40)),
+      GST_FLOW_OK);
+
+  /* the third buffer does not fit in the queue, the push blocks */
+  data.h = h;
+  data.buf = create_data_buffer (3, 40);
+  thread = g_thread_new ("push", (GThreadFunc) push_thread, &data);
+  g_usleep (100 * G_TIME_SPAN_MILLISECOND);
+  fail_if (g_atomic_int_get (&data.done));
+  fail_unless_equals_uint64 (get_pending_stat (h, "pending-bytes"), 80);
+
+  /* and completes once the writer makes room */
+  test_output_stream_set_block (stream, FALSE);
+  g_thread_join (thread);
+  fail_unless_equals_int (data.ret, GST_FLOW_OK);
+  fail_unless (gst_harness_push_event (h, gst_event_new_eos ()));
+
+  fail_unless (get_pending_stat (h, "max-pending-bytes") <= 100);
+  fail_unless_equals_uint64 (get_pending_stat (h, "pending-bytes"), 0);
+  fail_unless_equals_int (stream->data->len, 120);
+  fail_unless_equals_int (stream->data->data[0], 1);
+  fail_unless_equals_int (stream->data->data[40], 2);
+  fail_unless_equals_int (stream->data->data[80], 3);
+
+  gst_harness_teardown (h);
+  g_object_unref (stream);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_write_behind_error)
+{
+  TestOutputStream *stream;
+  GstHarness *h;
+
+  stream = g_object_new (test_output_stream_get_type (), NULL);
+  h = setup_write_behind_sink (stream, 1024);
+
+  /* the write fails after render returned */
+  stream->fail = TRUE;
+  fail_unless_equals_int (gst_harness_push (h, create_data_buffer (1, 40)),
+      GST_FLOW_OK);
+  test_output_stream_wait_writes (stream, 1);
+  while (get_pending_stat (h, "pending-bytes") > 0)
+    g_usleep (G_TIME_SPAN_MILLISECOND);
+
+  /* the error is returned by the next render, and by EOS */
+  fail_unless_equals_int (gst_harness_push (h, create_data_buffer (2, 40)),
+      GST_FLOW_ERROR);
+  fail_if (gst_harness_push_event (h, gst_event_new_eos ()));
+  fail_unless_equals_int (stream->data->len, 0);
+
+  gst_harness_teardown (h);
+  g_object_unref (stream);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_write_behind_unlock)
+{
+  TestOutputStream *stream;
+  PushData data = { NULL, };
+  GThread *thread;
+  GstHarness *h;
+
+  stream = g_object_new (test_output_stream_get_type (), NULL);
+  h = setup_write_behind_sink (stream, 50);
+
+  /* block the writer and the streaming thread on a full queue */
+  test_output_stream_set_block (stream, TRUE);
+  fail_unless_equals_int (gst_harness_push (h, create_data_buffer (1, 40)),
+      GST_FLOW_OK);
+  test_output_stream_wait_writes (stream, 1);
+  data.h = h;
+  data.buf = create_data_buffer (2, 40);
+  thread = g_thread_new ("push", (GThreadFunc) push_thread, &data);
+  g_usleep (50 * G_TIME_SPAN_MILLISECOND);
+  fail_if (g_atomic_int_get (&data.done));
+
+  /* flushing unblocks both and cancels the blocked write, the buffer that
+   * render accepted stays queued */
+  fail_unless (gst_harness_push_event (h, gst_event_new_flush_start ()));
+  g_thread_join (thread);
+  fail_unless_equals_int (data.ret, GST_FLOW_FLUSHING);
+  g_mutex_lock (&stream->lock);
+  while (!stream->cancelled)
+    g_cond_wait_until (&stream->cond, &stream->lock,
+        g_get_monotonic_time () + 10 * G_TIME_SPAN_MILLISECOND);
+  g_mutex_unlock (&stream->lock);
+
+  fail_unless_equals_uint64 (get_pending_stat (h, "pending-bytes"), 40);
+  fail_unless_equals_int (stream->data->len, 0);
+
+  /* the sink keeps working after the flush and writes the cancelled buffer
+   * before the new one */
+  fail_unless (gst_harness_push_event (h, gst_event_new_flush_stop (TRUE)));
+  test_output_stream_set_block (stream, FALSE);
+  gst_harness_set_src_caps_str (h, "application/x-test");
+  fail_unless_equals_int (gst_harness_push (h, create_data_buffer (3, 40)),
+      GST_FLOW_OK);
+  fail_unless (gst_harness_push_event (h, gst_event_new_eos ()));
+  fail_unless_equals_int (stream->data->len, 80);
+  fail_unless_equals_int (stream->data->data[0], 1);
+  fail_unless_equals_int (stream->data->data[40], 3);
+
+  gst_harness_teardown (h);
+  g_object_unref (stream);
+}
+
+GST_END_TEST;
+
+static gpointer
+set_null_thread (GstHarness * h)
+{
+  GstStateChangeReturn ret;
+
+  ret = gst_element_set_state (h->element, GST_STATE_NULL);
+
+  return GINT_TO_POINTER (ret);
+}
+
+GST_START_TEST (test_write_behind_stop_blocked)
+{
+  TestOutputStream *stream;
+  GThread *thread;
+  GstHarness *h;
+
+  stream = g_object_new (test_output_stream_get_type (), NULL);
+  h = setup_write_behind_sink (stream, 1024);
+
+  test_output_stream_set_block (stream, TRUE);
+  fail_unless_equals_int (gst_harness_push (h, create_data_buffer (1, 40)),
+      GST_FLOW_OK);
+  fail_unless_equals_int (gst_harness_push (h, create_data_buffer (2, 40)),
+      GST_FLOW_OK);
+  test_output_stream_wait_writes (stream, 1);
+
+  /* shutting down cancels the blocked write, but still writes out what
+   * render accepted before it returns */
+  thread = g_thread_new ("stop", (GThreadFunc) set_null_thread, h);
+  g_mutex_lock (&stream->lock);
+  while (!stream->cancelled)
+    g_cond_wait_until (&stream->cond, &stream->lock,
+        g_get_monotonic_time () + 10 * G_TIME_SPAN_MILLISECOND);
+  g_mutex_unlock (&stream->lock);
+  test_output_stream_wait_writes (stream, 2);
+  fail_unless_equals_int (stream->data->len, 0);
+
+  test_output_stream_set_block (stream, FALSE);
+  fail_unless_equals_int (GPOINTER_TO_INT (g_thread_join (thread)),
+      GST_STATE_CHANGE_SUCCESS);
+  fail_unless_equals_int (stream->data->len, 80);
+  fail_unless_equals_int (stream->data->data[0], 1);
+  fail_unless_equals_int (stream->data->data[40], 2);
+
+  gst_harness_teardown (h);
+  g_object_unref (stream);
+}
+
+GST_END_TEST;
+
+#define MMAP_FILE_SIZE (256 * 1024 + 123)
+
+/* returns a giosrc reading @uri with its src @pad activated in pull mode */
+static GstElement *
+start_giosrc (const gchar * uri, gboolean use_mmap, GstPad ** pad)
+{
+  GstElement *src;
+
+  src = gst_element_factory_make ("giosrc", NULL);
+  fail_unless (src != NULL);
+  g_object_set (src, "location", uri, "use-mmap", use_mmap, NULL);
+  fail_unless_equals_int (gst_element_set_state (src, GST_STATE_READY),
+      GST_STATE_CHANGE_SUCCESS);
+  *pad = gst_element_get_static_pad (src, "src");
+  fail_unless (gst_pad_activate_mode (*pad, GST_PAD_MODE_PULL, TRUE));
+
+  return src;
+}
+
+static void
+stop_giosrc (GstElement * src, GstPad * pad)
+{
+  fail_unless (gst_pad_activate_mode (pad, GST_PAD_MODE_PULL, FALSE));
+  gst_object_unref (pad);
+  fail_unless_equals_int (gst_element_set_state (src, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+  gst_object_unref (src);
+}
+
+GST_START_TEST (test_mmap_read)
+{
+  /* offset and size of the reads, the last ones cross and start at EOF */
+  static const struct
+  {
+    guint64 offset;
+    guint size;
+  } reads[] = {
+    {0, 4096}, {100000, 65536}, {4096, 1}, {200000, 30000},
+    {MMAP_FILE_SIZE - 1000, 4096}, {MMAP_FILE_SIZE - 1, 1}
+  };
+  GstElement *mmap_src, *read_src;
+  GstPad *mmap_pad, *read_pad;
+  GstBuffer *mmap_buf, *read_buf;
+  GError *err = NULL;
+  guint8 *data;
+  gchar *path, *uri;
+  gint fd;
+  guint i;
+
+  fd = g_file_open_tmp ("giosrc-mmap-XXXXXX", &path, &err);
+  fail_unless (fd != -1, "could not create temporary file");
+  g_close (fd, NULL);
+
+  data = g_malloc (MMAP_FILE_SIZE);
+  for (i = 0; i < MMAP_FILE_SIZE; i++)
+    data[i] = (i * 7 + (i >> 12)) & 0xff;
+  fail_unless (g_file_set_contents (path, (const gchar *) data,
+          MMAP_FILE_SIZE, &err));
+  uri = g_filename_to_uri (path, NULL, &err);
+  fail_unless (uri != NULL);
+
+  mmap_src = start_giosrc (uri, TRUE, &mmap_pad);
+  read_src = start_giosrc (uri, FALSE, &read_pad);
+
+  for (i = 0; i < G_N_ELEMENTS (reads); i++) {
+    guint64 offset = reads[i].offset;
+    guint expected = MIN (reads[i].size, MMAP_FILE_SIZE - offset);
+
+    mmap_buf = read_buf = NULL;
+    fail_unless_equals_int (gst_pad_get_range (mmap_pad, offset,
+            reads[i].size, &mmap_buf), GST_FLOW_OK);
+    fail_unless_equals_int (gst_pad_get_range (read_pad, offset,
+            reads[i].size, &read_buf), GST_FLOW_OK);
+
+    /* reads crossing EOF are short in both modes */
+    fail_unless_equals_int (gst_buffer_get_size (mmap_buf), expected);
+    fail_unless_equals_int (gst_buffer_get_size (read_buf), expected);
+    fail_unless_equals_uint64 (GST_BUFFER_OFFSET (mmap_buf), offset);
+    fail_unless (gst_buffer_memcmp (mmap_buf, 0, data + offset,
+            expected) == 0);
+    fail_unless (gst_buffer_memcmp (read_buf, 0, data + offset,
+            expected) == 0);
+
+    /* the mmap buffers wrap the read-only mapping */
+    fail_unless_equals_int (gst_buffer_n_memory (mmap_buf), 1);
+    fail_unless (GST_MEMORY_FLAG_IS_SET (gst_buffer_peek_memory (mmap_buf,
+                0), GST_MEMORY_FLAG_READONLY));
+
+    gst_buffer_unref (mmap_buf);
+    gst_buffer_unref (read_buf);
+  }
+
+  /* reading at EOF */
+  mmap_buf = NULL;
+  fail_unless_equals_int (gst_pad_get_range (mmap_pad, MMAP_FILE_SIZE, 4096,
+          &mmap_buf), GST_FLOW_EOS);
+  fail_unless (mmap_buf == NULL);
+  read_buf = NULL;
+  fail_unless_equals_int (gst_pad_get_range (read_pad, MMAP_FILE_SIZE, 4096,
+          &read_buf), GST_FLOW_EOS);
+  fail_unless (read_buf == NULL);
+
+  /* a buffer outliving the element keeps the mapping valid */
+  fail_unless_equals_int (gst_pad_get_range (mmap_pad, 1000, 1000,
+          &mmap_buf), GST_FLOW_OK);
+  stop_giosrc (mmap_src, mmap_pad);
+  stop_giosrc (read_src, read_pad);
+  fail_unless (gst_buffer_memcmp (mmap_buf, 0, data + 1000, 1000) == 0);
+  gst_buffer_unref (mmap_buf);
+
+  g_unlink (path);
+  g_free (path);
+  g_free (uri);
+  g_free (data);
+}
+
+GST_END_TEST;
+
 static Suite *
 gio_suite (void)
 {
@@ -161,6 +608,11 @@ gio_suite (void)
 
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_memory_stream);
+  tcase_add_test (tc_chain, test_write_behind_queue_bound);
+  tcase_add_test (tc_chain, test_write_behind_error);
+  tcase_add_test (tc_chain, test_write_behind_unlock);
+  tcase_add_test (tc_chain, test_write_behind_stop_blocked);
+  tcase_add_test (tc_chain, test_mmap_read);
 
   return s;
 }
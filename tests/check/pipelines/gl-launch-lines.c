@@ -238,6 +238,144 @@ GST_START_TEST (test_gltestsrc)
 
 GST_END_TEST
 #undef N_SRCS
+/* Runs @descr, which has a gldownload named "dl", until EOS and checks the
+ * statistics of its download ring */
+static void
+check_pbo_ring (const gchar * descr, guint64 downloads, guint max_pending,
+    guint64 drained)
+{
+  GstElement *pipe, *dl;
+  GstStructure *stats = NULL;
+  GstMessage *msg;
+  guint64 val;
+  guint uval;
+
+  pipe = setup_pipeline (descr);
+  dl = gst_bin_get_by_name (GST_BIN (pipe), "dl");
+  fail_unless (dl != NULL);
+
+  fail_if (gst_element_set_state (pipe, GST_STATE_PLAYING) ==
+      GST_STATE_CHANGE_FAILURE, "Could not set pipeline %s to playing", descr);
+  msg = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipe), 10 * GST_SECOND,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless (msg != NULL, "Timeout waiting for EOS: %s", descr);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (msg), GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+
+  g_object_get (dl, "pbo-stats", &stats, NULL);
+  fail_unless (stats != NULL);
+  GST_INFO ("%s: %" GST_PTR_FORMAT, descr, stats);
+
+  /* every frame went through the ring */
+  fail_unless (gst_structure_get_uint64 (stats, "downloads", &val));
+  fail_unless_equals_uint64 (val, downloads);
+  /* the ring never holds more frames than its size, the slots of the pushed
+   * frames are taken by the following ones */
+  fail_unless (gst_structure_get_uint (stats, "max-pending", &uval));
+  fail_unless_equals_int (uval, max_pending);
+  /* only the frames still in flight at EOS are drained */
+  fail_unless (gst_structure_get_uint64 (stats, "drained", &val));
+  fail_unless_equals_uint64 (val, drained);
+  /* whether waiting for a download stalls depends on the GL implementation
+   * and the load of the machine, but a frame is waited for only once */
+  fail_unless (gst_structure_get_uint64 (stats, "stalls", &val));
+  fail_unless (val <= downloads);
+  gst_structure_free (stats);
+
+  fail_if (gst_element_set_state (pipe, GST_STATE_NULL) ==
+      GST_STATE_CHANGE_FAILURE, "Could not set pipeline %s to NULL", descr);
+  gst_object_unref (dl);
+  gst_object_unref (pipe);
+}
+
+GST_START_TEST (test_gldownload_pbo_ring)
+{
+  check_pbo_ring ("gltestsrc num-buffers=10 ! gldownload name=dl "
+      "pbo-ring-size=3 ! video/x-raw ! fakesink", 10, 3, 2);
+
+  check_pbo_ring ("videotestsrc num-buffers=10 ! glupload ! gldownload "
+      "name=dl pbo-ring-size=16 ! video/x-raw ! fakesink", 10, 10, 10);
+
+  /* synchronous downloads don't use the ring */
+  check_pbo_ring ("gltestsrc num-buffers=10 ! gldownload name=dl ! "
+      "video/x-raw ! fakesink", 0, 0, 0);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_glvideomixer_render_timing)
+{
+  const gchar *s;
+  GstState target_state = GST_STATE_PLAYING;
+
+  /* all the pads are drawn from the shared vertex buffer */
+  s = "glvideomixer name=m render-timing=true ! fakesink "
+      "videotestsrc num-buffers=10 ! m. "
+      "videotestsrc num-buffers=10 pattern=ball ! "
+      "video/x-raw,width=160,height=120 ! m. "
+      "gltestsrc num-buffers=10 ! m.";
+  run_pipeline (setup_pipeline (s), s,
+      GST_MESSAGE_ANY & ~(GST_MESSAGE_ERROR | GST_MESSAGE_WARNING),
+      GST_MESSAGE_EOS, target_state);
+}
+
+GST_END_TEST
+GST_START_TEST (test_glvideomixer_reuse_textures)
+{
+  GstElement *pipe, *mixer;
+  GstPad *pad, *target;
+  GstElement *upload;
+  GstMessage *msg;
+  GstBus *bus;
+  gboolean reuse;
+  const gchar *s;
+
+  /* videorate repeats each frame as new buffers sharing its memories */
+  s = "glvideomixer name=m sink_1::reuse-textures=true ! fakesink "
+      "videotestsrc num-buffers=10 ! m. "
+      "videotestsrc num-buffers=2 ! video/x-raw,framerate=5/1 ! videorate ! "
+      "video/x-raw,framerate=30/1 ! m.";
+  pipe = setup_pipeline (s);
+  mixer = gst_bin_get_by_name (GST_BIN (pipe), "m");
+  fail_unless (mixer != NULL);
+
+  bus = gst_element_get_bus (pipe);
+  fail_if (gst_element_set_state (pipe, GST_STATE_PLAYING) ==
+      GST_STATE_CHANGE_FAILURE);
+  msg = gst_bus_timed_pop_filtered (bus, 10 * GST_SECOND,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless (msg != NULL, "timeout waiting for EOS");
+  fail_unless_equals_int (GST_MESSAGE_TYPE (msg), GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+
+  /* the pad property is stored on the upload element of its input */
+  pad = gst_element_get_static_pad (mixer, "sink_1");
+  fail_unless (pad != NULL);
+  g_object_get (pad, "reuse-textures", &reuse, NULL);
+  fail_unless (reuse);
+  target = gst_ghost_pad_get_target (GST_GHOST_PAD (pad));
+  upload = gst_pad_get_parent_element (target);
+  g_object_get (upload, "reuse-textures", &reuse, NULL);
+  fail_unless (reuse);
+  gst_object_unref (upload);
+  gst_object_unref (target);
+  gst_object_unref (pad);
+
+  /* and stays off for the other pads */
+  pad = gst_element_get_static_pad (mixer, "sink_0");
+  fail_unless (pad != NULL);
+  g_object_get (pad, "reuse-textures", &reuse, NULL);
+  fail_if (reuse);
+  gst_object_unref (pad);
+
+  fail_if (gst_element_set_state (pipe, GST_STATE_NULL) ==
+      GST_STATE_CHANGE_FAILURE);
+  gst_object_unref (mixer);
+  gst_object_unref (bus);
+  gst_object_unref (pipe);
+}
+
+GST_END_TEST
 #if GST_GL_HAVE_OPENGL
 GST_START_TEST (test_glfilterglass)
 {
@@ -337,6 +475,9 @@ gl_launch_lines_suite (void)
 #endif
 #endif
   tcase_add_test (tc_chain, test_gltestsrc);
+  tcase_add_test (tc_chain, test_gldownload_pbo_ring);
+  tcase_add_test (tc_chain, test_glvideomixer_render_timing);
+  tcase_add_test (tc_chain, test_glvideomixer_reuse_textures);
 #if GST_GL_HAVE_OPENGL
   tcase_add_test (tc_chain, test_glfilterglass);
 /*  tcase_add_test (tc_chain, test_glfilterreflectedscreen);*/
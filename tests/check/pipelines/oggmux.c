@@ -343,6 +343,224 @@ GST_START_TEST (test_vorbis_oggmux_unlinked)
   gst_object_unref (pipe);
 }
 
+GST_END_TEST;
+
+static GstClockTime max_page_lateness;
+
+/* how long after its timestamp a page was pushed out, in running time */
+static GstPadProbeReturn
+page_lateness_probe (GstPad * pad, GstPadProbeInfo * info, GstElement * mux)
+{
+  GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+  GstClockTime now;
+  GstClock *clock;
+
+  if (!GST_BUFFER_PTS_IS_VALID (buffer) ||
+      GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_HEADER))
+    return GST_PAD_PROBE_OK;
+
+  clock = gst_element_get_clock (mux);
+  if (clock == NULL)
+    return GST_PAD_PROBE_OK;
+  now = gst_clock_get_time (clock) - gst_element_get_base_time (mux);
+  gst_object_unref (clock);
+
+  if (now > GST_BUFFER_PTS (buffer))
+    max_page_lateness = MAX (max_page_lateness, now - GST_BUFFER_PTS (buffer));
+
+  return GST_PAD_PROBE_OK;
+}
+
+GST_START_TEST (test_vorbis_live_latency)
+{
+  GstElement *bin, *mux;
+  GstPad *pad;
+  GstQuery *query;
+  GstMessage *msg;
+  gboolean live;
+  GstClockTime min_latency, max_latency;
+  gulong lateness_probe_id;
+
+  /* two live streams producing packets of different sizes, pages have to go
+   * out within max-page-delay even while the other stream has nothing */
+  bin = gst_parse_launch ("audiotestsrc is-live=true num-buffers=100 "
+      "samplesperbuffer=441 ! audioconvert ! vorbisenc ! queue ! "
+      ".audio_%u oggmux name=mux max-page-delay=100000000 ! "
+      "fakesink sync=true "
+      "audiotestsrc is-live=true num-buffers=25 samplesperbuffer=1764 ! "
+      "audioconvert ! vorbisenc ! queue ! mux.audio_%u", NULL);
+  fail_unless (bin != NULL);
+
+  mux = gst_bin_get_by_name (GST_BIN (bin), "mux");
+  pad = gst_element_get_static_pad (mux, "src");
+  max_page_lateness = 0;
+  lateness_probe_id = gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER,
+      (GstPadProbeCallback) page_lateness_probe, mux, NULL);
+
+  start_pipeline (bin, pad);
+
+  /* the muxer adds max-page-delay to the upstream latency */
+  query = gst_query_new_latency ();
+  fail_unless (gst_element_query (mux, query));
+  gst_query_parse_latency (query, &live, &min_latency, &max_latency);
+  fail_unless (live);
+  fail_unless (min_latency >= 100 * GST_MSECOND);
+  gst_query_unref (query);
+
+  msg = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (bin),
+      GST_CLOCK_TIME_NONE, GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (msg), GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+
+  gst_pad_remove_probe (pad, lateness_probe_id);
+  /* also checks that both chains were terminated with an EOS page */
+  stop_pipeline (bin, pad);
+
+  GST_INFO ("maximum page lateness %" GST_TIME_FORMAT,
+      GST_TIME_ARGS (max_page_lateness));
+  fail_unless (max_page_lateness > 0);
+  fail_unless (max_page_lateness < 400 * GST_MSECOND,
+      "page pushed %" GST_TIME_FORMAT " late", GST_TIME_ARGS (max_page_lateness));
+
+  gst_object_unref (pad);
+  gst_object_unref (mux);
+  gst_object_unref (bin);
+}
+
+GST_END_TEST;
+
+static GMutex sparse_lock;
+static GCond sparse_cond;
+static guint sparse_data_pages;
+
+static GstPadProbeReturn
+count_data_pages_probe (GstPad * pad, GstPadProbeInfo * info, gpointer data)
+{
+  GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+
+  if (!GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_HEADER)) {
+    g_mutex_lock (&sparse_lock);
+    sparse_data_pages++;
+    g_cond_signal (&sparse_cond);
+    g_mutex_unlock (&sparse_lock);
+  }
+
+  return GST_PAD_PROBE_OK;
+}
+
+/* minimal kate identification header for a subtitle stream */
+static GstBuffer *
+create_kate_id_header (void)
+{
+  guint8 *data = g_malloc0 (64);
+
+  memcpy (data, "\x80kate\0\0\0", 8);
+  GST_WRITE_UINT8 (data + 11, 1);
+  GST_WRITE_UINT8 (data + 15, 32);
+  GST_WRITE_UINT32_LE (data + 24, 1000);
+  GST_WRITE_UINT32_LE (data + 28, 1);
+  memcpy (data + 48, "SUB", 4);
+
+  return gst_buffer_new_wrapped (data, 64);
+}
+
+GST_START_TEST (test_vorbis_sparse_not_live)
+{
+  GstElement *bin, *mux;
+  GstPad *srcpad, *sinkpad, *pad;
+  GstSegment segment;
+  GstBuffer *header;
+  GstCaps *caps;
+  GstQuery *query;
+  GstMessage *msg;
+  GValue array = G_VALUE_INIT;
+  GValue value = G_VALUE_INIT;
+  gint64 end_time;
+  guint i;
+
+  bin = gst_parse_launch ("audiotestsrc num-buffers=50 ! audioconvert ! "
+      "vorbisenc ! .audio_%u oggmux name=mux ! fakesink", NULL);
+  fail_unless (bin != NULL);
+  mux = gst_bin_get_by_name (GST_BIN (bin), "mux");
+
+  /* a subtitle stream that has its headers in the caps but never any data,
+   * only GAP events */
+  sinkpad = gst_element_get_request_pad (mux, "subtitle_%u");
+  fail_unless (sinkpad != NULL);
+  srcpad = gst_pad_new ("src", GST_PAD_SRC);
+  fail_unless_equals_int (gst_pad_link (srcpad, sinkpad), GST_PAD_LINK_OK);
+  gst_pad_set_active (srcpad, TRUE);
+
+  header = create_kate_id_header ();
+  GST_BUFFER_FLAG_SET (header, GST_BUFFER_FLAG_HEADER);
+  g_value_init (&array, GST_TYPE_ARRAY);
+  g_value_init (&value, GST_TYPE_BUFFER);
+  gst_value_set_buffer (&value, header);
+  gst_value_array_append_value (&array, &value);
+  g_value_unset (&value);
+  gst_buffer_unref (header);
+  caps = gst_caps_new_empty_simple ("subtitle/x-kate");
+  gst_caps_set_value (caps, "streamheader", &array);
+  g_value_unset (&array);
+
+  pad = gst_element_get_static_pad (mux, "src");
+  sparse_data_pages = 0;
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER,
+      count_data_pages_probe, NULL, NULL);
+
+  fail_unless_equals_int (gst_element_set_state (mux, GST_STATE_PAUSED),
+      GST_STATE_CHANGE_SUCCESS);
+  fail_unless (gst_pad_push_event (srcpad,
+          gst_event_new_stream_start ("subtitles")));
+  fail_unless (gst_pad_push_event (srcpad, gst_event_new_caps (caps)));
+  gst_caps_unref (caps);
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (srcpad, gst_event_new_segment (&segment)));
+  /* serialized, returns once the muxer handled the events before it */
+  query = gst_query_new_drain ();
+  gst_pad_peer_query (srcpad, query);
+  gst_query_unref (query);
+
+  fail_if (gst_element_set_state (bin,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE);
+
+  /* the subtitle stream only sends GAP events for longer than the audio
+   * lasts, the audio pages are pushed without waiting for subtitle pages */
+  for (i = 0; i < 20; i++) {
+    fail_unless (gst_pad_push_event (srcpad,
+            gst_event_new_gap (i * 100 * GST_MSECOND, 100 * GST_MSECOND)));
+  }
+
+  end_time = g_get_monotonic_time () + 10 * G_TIME_SPAN_SECOND;
+  g_mutex_lock (&sparse_lock);
+  while (sparse_data_pages < 2) {
+    if (!g_cond_wait_until (&sparse_cond, &sparse_lock, end_time))
+      break;
+  }
+  fail_unless (sparse_data_pages >= 2, "no pages while sparse stream idle");
+  g_mutex_unlock (&sparse_lock);
+
+  fail_unless (gst_pad_push_event (srcpad, gst_event_new_eos ()));
+
+  msg = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (bin),
+      10 * GST_SECOND, GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless (msg != NULL, "timeout waiting for EOS");
+  fail_unless_equals_int (GST_MESSAGE_TYPE (msg), GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+
+  fail_unless_equals_int (gst_element_set_state (bin, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+
+  gst_pad_set_active (srcpad, FALSE);
+  gst_pad_unlink (srcpad, sinkpad);
+  gst_element_release_request_pad (mux, sinkpad);
+  gst_object_unref (sinkpad);
+  gst_object_unref (srcpad);
+  gst_object_unref (pad);
+  gst_object_unref (mux);
+  gst_object_unref (bin);
+}
+
 GST_END_TEST;
 #endif
 
@@ -413,6 +631,8 @@ oggmux_suite (void)
 #ifdef HAVE_VORBIS
   tcase_add_test (tc_chain, test_vorbis);
   tcase_add_test (tc_chain, test_vorbis_oggmux_unlinked);
+  tcase_add_test (tc_chain, test_vorbis_live_latency);
+  tcase_add_test (tc_chain, test_vorbis_sparse_not_live);
 #endif
 
 #ifdef HAVE_THEORA